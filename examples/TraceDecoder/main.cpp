@@ -0,0 +1,44 @@
+#include "fst/file_view.h"
+#include "fst/stream.h"
+#include "fst/trace.h"
+#include <stdio.h>
+
+// Renders a binary trace written by fst_trace in the text format.
+// Usage: TraceDecoder trace_HH_MM_SS_MMM.fsttrace [output.log]
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        fst::print("usage: TraceDecoder <trace file> [output file]");
+        return 1;
+    }
+
+    fst::file_view view;
+    if (fst::status st = view.open(argv[1]); !st)
+    {
+        fst::print("could not open", argv[1], st.message());
+        return 1;
+    }
+
+    FILE* file = argc > 2 ? ::fopen(argv[2], "w") : nullptr;
+    if (argc > 2 && !file)
+    {
+        fst::print("could not create", argv[2]);
+        return 1;
+    }
+
+    fst::output_stream<char> file_stream(file,
+        [](void* data, const char* str, size_t size, fst::stream_modifier) noexcept -> size_t { return ::fwrite(str, 1, size, (FILE*) data); });
+
+    const bool valid = fst::decode_trace(view.data(), view.size(), file ? file_stream : fst::cout);
+
+    if (file) { ::fclose(file); }
+
+    if (!valid)
+    {
+        fst::print("invalid trace file", argv[1]);
+        return 1;
+    }
+
+    return 0;
+}
@@ -133,6 +133,13 @@ FST_BEGIN_NAMESPACE
 
         inline void deallocate(T* const ptr, const size_t) noexcept { _zone.aligned_deallocate(ptr, _MemoryCategory::id()); }
 
+        /// Moves ptr to a block of new_count elements, the first count elements are copied as by memcpy.
+        FST_NODISCARD inline T* reallocate(T* const ptr, const size_t count, const size_t new_count) noexcept
+        {
+            fst_assert(new_count < max_count, "wrong allocation size");
+            return static_cast<T*>(__fst::memory_zone_reallocate(_zone, ptr, sizeof(T) * count, sizeof(T) * new_count, alignment, _MemoryCategory::id()));
+        }
+
         FST_NODISCARD inline allocator_proxy proxy() noexcept { return make_allocator_proxy(this); }
 
         template <class U>
@@ -210,6 +217,14 @@ FST_BEGIN_NAMESPACE
 
         inline void deallocate(T* const ptr, const size_t) noexcept { _MemoryZone::aligned_deallocate(ptr, _MemoryCategory::id()); }
 
+        /// Moves ptr to a block of new_count elements, the first count elements are copied as by memcpy.
+        FST_NODISCARD inline T* reallocate(T* const ptr, const size_t count, const size_t new_count) noexcept
+        {
+            fst_assert(new_count < max_count, "wrong allocation size");
+            return static_cast<T*>(
+                __fst::memory_zone_reallocate(_MemoryZone{}, ptr, sizeof(T) * count, sizeof(T) * new_count, alignment, _MemoryCategory::id()));
+        }
+
         FST_NODISCARD inline allocator_proxy proxy() noexcept { return make_allocator_proxy(this); }
 
         template <class U>
@@ -305,6 +320,18 @@ FST_BEGIN_NAMESPACE
         __fst::memory_zone_proxy _zone;
     };*/
 
+    namespace detail
+    {
+        template <typename _Allocator>
+        using allocator_reallocate_t = decltype(__fst::declval<_Allocator&>().reallocate(
+            __fst::declval<typename _Allocator::value_type*>(), __fst::declval<size_t>(), __fst::declval<size_t>()));
+    } // namespace detail.
+
+    /// Whether the allocator has reallocate(ptr, count, new_count).
+    template <class _Allocator>
+    struct allocator_has_reallocate : __fst::bool_t<__fst::is_detected_v<detail::allocator_reallocate_t, _Allocator>>
+    {};
+
     template <class T, class _MemoryCategory = __fst::default_memory_category, class _MemoryZone = __fst::default_memory_zone>
     using allocator = __fst::memory_zone_allocator<T, _MemoryCategory, _MemoryZone>;
 
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "fst/common.h"
+#include "fst/async/common.h"
+#include "fst/atomic.h"
+
+FST_BEGIN_SUB_NAMESPACE(async)
+
+    /// Lightweight event built on fst::atomic wait/notify (futex on linux).
+    ///
+    /// An auto-reset event wakes up a single waiter and goes back to the unsignaled
+    /// state as soon as that waiter returns. A manual-reset event wakes up every
+    /// waiter and stays signaled until reset() is called.
+    ///
+    /// Setting an event that nobody waits on never makes a syscall.
+    class event
+    {
+      public:
+        enum class reset_mode : uint8_t {
+            automatic,
+            manual
+        };
+
+        inline explicit event(reset_mode mode = reset_mode::automatic, bool initial_state = false) noexcept
+            : _state(initial_state ? signaled : unsignaled)
+            , _mode(mode)
+        {}
+
+        event(const event&) = delete;
+        event(event&&) = delete;
+
+        event& operator=(const event&) = delete;
+        event& operator=(event&&) = delete;
+
+        /// Signals the event.
+        /// The event isn't accessed once a waiter can see the signal, it can be destroyed as soon as wait() returns.
+        void set() noexcept;
+
+        /// Puts the event back in the unsignaled state.
+        inline void reset() noexcept { _state.store(unsignaled); }
+
+        /// Blocks until the event is signaled.
+        void wait() noexcept;
+
+        /// Blocks until the event is signaled or timeout_us microseconds have passed.
+        /// @returns false on timeout.
+        /// @note With an auto-reset event, this can return false early if another waiter took the signal.
+        bool wait_for_us(uint64_t timeout_us) noexcept;
+
+        /// Returns true if the event was signaled, without blocking.
+        /// An auto-reset event is reset when this returns true.
+        inline bool try_wait() noexcept
+        {
+            if (_mode == reset_mode::manual) { return _state.load() == signaled; }
+
+            uint32_t expected = signaled;
+            return _state.compare_exchange_strong(expected, unsignaled);
+        }
+
+        FST_NODISCARD inline bool is_set() const noexcept { return _state.load() == signaled; }
+
+        FST_NODISCARD inline reset_mode mode() const noexcept { return _mode; }
+
+      private:
+        static constexpr uint32_t unsignaled = 0;
+        static constexpr uint32_t signaled = 1;
+
+        __fst::atomic<uint32_t> _state;
+        reset_mode _mode;
+    };
+
+FST_END_SUB_NAMESPACE
@@ -0,0 +1,120 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Alexandre Arsenault
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#pragma once
+
+///
+/// @file fst/async/io_reactor.h
+///
+/// Readiness notifications for coroutines.
+///
+/// A dedicated thread polls every handle a coroutine is waiting on (file descriptors
+/// with poll on posix, sockets with WSAPoll on windows) and resumes the coroutine
+/// once the handle is ready. Coroutines are resumed on the reactor thread, use
+/// co_await schedule_on(pool) right after to move heavy work to a thread_pool.
+///
+/// @code
+///     fst::async::task<size_t> read_some(fst::async::io_reactor& reactor, int fd, char* buffer, size_t size)
+///     {
+///         co_await reactor.readable(fd);
+///         co_return (size_t) ::read(fd, buffer, size);
+///     }
+/// @endcode
+///
+
+#include "fst/common.h"
+#include "fst/async/common.h"
+#include "fst/pointer.h"
+#include <coroutine>
+
+FST_BEGIN_SUB_NAMESPACE(async)
+
+    class io_reactor
+    {
+      public:
+        /// File descriptor on posix, SOCKET on windows.
+        using native_handle_type = intptr_t;
+
+        enum class io_event : uint8_t {
+            readable,
+            writable
+        };
+
+        class awaiter
+        {
+          public:
+            inline awaiter(io_reactor& reactor, native_handle_type handle, io_event event) noexcept
+                : _reactor(reactor)
+                , _handle(handle)
+                , _event(event)
+            {}
+
+            /// Doesn't suspend when the handle is already ready.
+            FST_NODISCARD inline bool await_ready() const noexcept { return io_reactor::is_ready(_handle, _event); }
+
+            inline void await_suspend(std::coroutine_handle<> coroutine) const noexcept { _reactor.add(_handle, _event, coroutine); }
+
+            FST_ALWAYS_INLINE void await_resume() const noexcept {}
+
+          private:
+            io_reactor& _reactor;
+            native_handle_type _handle;
+            io_event _event;
+        };
+
+        /// Starts the reactor thread.
+        io_reactor() noexcept;
+
+        io_reactor(const io_reactor&) = delete;
+        io_reactor(io_reactor&&) = delete;
+
+        /// Stops and joins the reactor thread, no coroutine may still be waiting.
+        ~io_reactor() noexcept;
+
+        io_reactor& operator=(const io_reactor&) = delete;
+        io_reactor& operator=(io_reactor&&) = delete;
+
+        /// co_await reactor.readable(handle) suspends until handle can be read without blocking.
+        /// A closed or failing handle also counts as ready.
+        FST_NODISCARD inline awaiter readable(native_handle_type handle) noexcept { return awaiter(*this, handle, io_event::readable); }
+
+        /// co_await reactor.writable(handle) suspends until handle can be written without blocking.
+        FST_NODISCARD inline awaiter writable(native_handle_type handle) noexcept { return awaiter(*this, handle, io_event::writable); }
+
+        /// Number of coroutines waiting on a handle.
+        FST_NODISCARD size_t pending() const noexcept;
+
+        /// Checks readiness without blocking.
+        FST_NODISCARD static bool is_ready(native_handle_type handle, io_event event) noexcept;
+
+      private:
+        void add(native_handle_type handle, io_event event, std::coroutine_handle<> coroutine) noexcept;
+
+        struct native;
+        using native_pointer = __fst::unique_ptr<native, __fst::async_memory_category, __fst::default_memory_zone>;
+        native_pointer _native;
+    };
+
+FST_END_SUB_NAMESPACE
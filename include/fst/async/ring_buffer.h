@@ -0,0 +1,450 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Alexandre Arsenault
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#pragma once
+
+///
+/// @file fst/async/ring_buffer.h
+///
+/// Bounded lock-free queues to move data between threads.
+///
+/// spsc_ring_buffer is wait-free and meant for a single producer and a single consumer
+/// (e.g. an audio callback and a worker). mpmc_ring_buffer is the bounded queue from
+/// Dmitry Vyukov where each slot carries a sequence number, any number of threads can
+/// push and pop.
+///
+/// Both use a power of two capacity allocated in the async_memory_category, the
+/// indices written by each side live on their own cache line. push_n and pop_n move
+/// a batch with a single index update. Queue a view like audio_bus to hand over a block
+/// without copying the samples.
+///
+
+#include "fst/common.h"
+#include "fst/async/common.h"
+#include "fst/atomic.h"
+#include "fst/math.h"
+#include "fst/memory.h"
+#include "fst/traits.h"
+
+FST_BEGIN_SUB_NAMESPACE(async)
+
+    namespace detail
+    {
+        template <class _T>
+        FST_NODISCARD inline _T* ring_buffer_allocate(size_t count) noexcept
+        {
+            const size_t alignment = __fst::maximum(alignof(_T), __fst::cache_line_size);
+            const size_t size = ((count * sizeof(_T) + alignment - 1) / alignment) * alignment;
+            _T* data = (_T*) __fst::aligned_allocate<__fst::async_memory_category>(size, alignment);
+            fst_assert(data, "allocation failed");
+            return data;
+        }
+
+        FST_NODISCARD inline size_t ring_buffer_capacity(size_t capacity) noexcept
+        {
+            fst_assert(capacity > 0, "ring buffer capacity can't be zero");
+            return __fst::round_to_power_of_two(__fst::maximum(capacity, (size_t) 2));
+        }
+    } // namespace detail
+
+    /// Wait-free single producer single consumer ring buffer.
+    ///
+    /// Only one thread may call the push functions and only one thread may call the pop
+    /// functions. Each side keeps a cached copy of the other side's index and only reads
+    /// the shared one when the cached value says the buffer is full (or empty).
+    template <class _T>
+    class spsc_ring_buffer
+    {
+      public:
+        using value_type = _T;
+        using size_type = size_t;
+
+        static_assert(__fst::is_move_constructible_v<_T>, "value_type must be move constructible");
+
+        /// The capacity is rounded up to a power of two.
+        inline explicit spsc_ring_buffer(size_type capacity) noexcept
+            : _mask(detail::ring_buffer_capacity(capacity) - 1)
+            , _data(detail::ring_buffer_allocate<_T>(_mask + 1))
+        {}
+
+        spsc_ring_buffer(const spsc_ring_buffer&) = delete;
+        spsc_ring_buffer& operator=(const spsc_ring_buffer&) = delete;
+
+        inline ~spsc_ring_buffer() noexcept
+        {
+            if constexpr (!__fst::is_trivially_destructible_v<_T>)
+            {
+                const size_t tail = _tail.load_relaxed();
+                for (size_t i = _head.load_relaxed(); i != tail; i++)
+                {
+                    _data[i & _mask].~_T();
+                }
+            }
+
+            __fst::aligned_deallocate<__fst::async_memory_category>(_data);
+        }
+
+        FST_NODISCARD FST_ALWAYS_INLINE size_type capacity() const noexcept { return _mask + 1; }
+
+        /// Only exact when called from the producer or the consumer thread while the other side is idle.
+        FST_NODISCARD FST_ALWAYS_INLINE size_type size() const noexcept { return _tail.load_acquire() - _head.load_acquire(); }
+
+        FST_NODISCARD FST_ALWAYS_INLINE bool empty() const noexcept { return size() == 0; }
+
+        //
+        // Producer.
+        //
+
+        template <class... _Args>
+        FST_ALWAYS_INLINE bool emplace(_Args&&... args) noexcept
+        {
+            const size_t tail = _tail.load_relaxed();
+            if (tail - _cached_head > _mask)
+            {
+                _cached_head = _head.load_acquire();
+                if (tail - _cached_head > _mask) { return false; }
+            }
+
+            fst_placement_new(_data + (tail & _mask)) _T(__fst::forward<_Args>(args)...);
+            _tail.store_release(tail + 1);
+            return true;
+        }
+
+        /// @returns false when the buffer is full.
+        FST_ALWAYS_INLINE bool push(const _T& value) noexcept { return emplace(value); }
+        FST_ALWAYS_INLINE bool push(_T&& value) noexcept { return emplace(__fst::move(value)); }
+
+        /// Copies up to count values and publishes them all at once.
+        /// @returns the number of values pushed, less than count when the buffer is full.
+        inline size_type push_n(const _T* values, size_type count) noexcept
+        {
+            const size_t tail = _tail.load_relaxed();
+            if (_mask + 1 - (tail - _cached_head) < count) { _cached_head = _head.load_acquire(); }
+
+            count = __fst::minimum(count, _mask + 1 - (tail - _cached_head));
+            if (count == 0) { return 0; }
+
+            const size_t index = tail & _mask;
+            const size_t first = __fst::minimum(count, _mask + 1 - index);
+
+            if constexpr (__fst::is_trivially_copyable_v<_T>)
+            {
+                __fst::memcpy(_data + index, values, first * sizeof(_T));
+                __fst::memcpy(_data, values + first, (count - first) * sizeof(_T));
+            }
+            else
+            {
+                for (size_t i = 0; i < count; i++)
+                {
+                    fst_placement_new(_data + ((tail + i) & _mask)) _T(values[i]);
+                }
+            }
+
+            _tail.store_release(tail + count);
+            return count;
+        }
+
+        //
+        // Consumer.
+        //
+
+        /// @returns a pointer to the oldest value or nullptr when the buffer is empty.
+        /// The value stays valid until the next pop.
+        FST_NODISCARD FST_ALWAYS_INLINE _T* front() noexcept
+        {
+            const size_t head = _head.load_relaxed();
+            if (head == _cached_tail)
+            {
+                _cached_tail = _tail.load_acquire();
+                if (head == _cached_tail) { return nullptr; }
+            }
+
+            return _data + (head & _mask);
+        }
+
+        /// Destroys the oldest value, the buffer must not be empty.
+        FST_ALWAYS_INLINE void pop() noexcept
+        {
+            const size_t head = _head.load_relaxed();
+            fst_assert(head != _tail.load_acquire(), "pop on an empty ring buffer");
+            _data[head & _mask].~_T();
+            _head.store_release(head + 1);
+        }
+
+        /// @returns false when the buffer is empty.
+        FST_ALWAYS_INLINE bool pop(_T& value) noexcept
+        {
+            _T* ptr = front();
+            if (!ptr) { return false; }
+
+            value = __fst::move(*ptr);
+            ptr->~_T();
+            _head.store_release(_head.load_relaxed() + 1);
+            return true;
+        }
+
+        /// Moves up to count values into values and releases their slots all at once.
+        /// @returns the number of values popped.
+        inline size_type pop_n(_T* values, size_type count) noexcept
+        {
+            const size_t head = _head.load_relaxed();
+            if (_cached_tail - head < count) { _cached_tail = _tail.load_acquire(); }
+
+            count = __fst::minimum(count, _cached_tail - head);
+            if (count == 0) { return 0; }
+
+            const size_t index = head & _mask;
+            const size_t first = __fst::minimum(count, _mask + 1 - index);
+
+            if constexpr (__fst::is_trivially_copyable_v<_T>)
+            {
+                __fst::memcpy(values, _data + index, first * sizeof(_T));
+                __fst::memcpy(values + first, _data, (count - first) * sizeof(_T));
+            }
+            else
+            {
+                for (size_t i = 0; i < count; i++)
+                {
+                    _T& v = _data[(head + i) & _mask];
+                    values[i] = __fst::move(v);
+                    v.~_T();
+                }
+            }
+
+            _head.store_release(head + count);
+            return count;
+        }
+
+      private:
+        // Written by the consumer.
+        alignas(__fst::cache_line_size) __fst::atomic<size_t> _head = 0;
+        size_t _cached_tail = 0;
+
+        // Written by the producer.
+        alignas(__fst::cache_line_size) __fst::atomic<size_t> _tail = 0;
+        size_t _cached_head = 0;
+
+        // Read only.
+        alignas(__fst::cache_line_size) const size_t _mask;
+        _T* const _data;
+    };
+
+    /// Bounded multi producer multi consumer queue.
+    ///
+    /// Every slot has a sequence number telling which lap of the ring it's ready for,
+    /// a thread claims slots with a single compare and swap on the shared index and
+    /// never waits on another thread to finish its copy (lock-free, not wait-free).
+    template <class _T>
+    class mpmc_ring_buffer
+    {
+      public:
+        using value_type = _T;
+        using size_type = size_t;
+
+        static_assert(__fst::is_move_constructible_v<_T>, "value_type must be move constructible");
+
+        /// The capacity is rounded up to a power of two.
+        inline explicit mpmc_ring_buffer(size_type capacity) noexcept
+            : _mask(detail::ring_buffer_capacity(capacity) - 1)
+            , _cells(detail::ring_buffer_allocate<cell>(_mask + 1))
+        {
+            for (size_t i = 0; i <= _mask; i++)
+            {
+                fst_placement_new(&_cells[i].sequence) __fst::atomic<size_t>(i);
+            }
+        }
+
+        mpmc_ring_buffer(const mpmc_ring_buffer&) = delete;
+        mpmc_ring_buffer& operator=(const mpmc_ring_buffer&) = delete;
+
+        inline ~mpmc_ring_buffer() noexcept
+        {
+            if constexpr (!__fst::is_trivially_destructible_v<_T>)
+            {
+                const size_t tail = _tail.load_relaxed();
+                for (size_t i = _head.load_relaxed(); i != tail; i++)
+                {
+                    _cells[i & _mask].value()->~_T();
+                }
+            }
+
+            __fst::aligned_deallocate<__fst::async_memory_category>(_cells);
+        }
+
+        FST_NODISCARD FST_ALWAYS_INLINE size_type capacity() const noexcept { return _mask + 1; }
+
+        /// Approximation while other threads are pushing or popping.
+        FST_NODISCARD FST_ALWAYS_INLINE size_type size() const noexcept
+        {
+            const size_t head = _head.load_acquire();
+            const size_t tail = _tail.load_acquire();
+            return tail > head ? tail - head : 0;
+        }
+
+        FST_NODISCARD FST_ALWAYS_INLINE bool empty() const noexcept { return size() == 0; }
+
+        /// @returns false when the queue is full.
+        template <class... _Args>
+        inline bool emplace(_Args&&... args) noexcept
+        {
+            size_t pos = _tail.load_relaxed();
+            cell* c;
+
+            for (;;)
+            {
+                c = _cells + (pos & _mask);
+                const intptr_t diff = (intptr_t) c->sequence.load_acquire() - (intptr_t) pos;
+
+                if (diff == 0)
+                {
+                    if (_tail.compare_exchange(pos, pos + 1)) { break; }
+                }
+                else if (diff < 0) { return false; }
+                else { pos = _tail.load_relaxed(); }
+            }
+
+            fst_placement_new(c->value()) _T(__fst::forward<_Args>(args)...);
+            c->sequence.store_release(pos + 1);
+            return true;
+        }
+
+        FST_ALWAYS_INLINE bool push(const _T& value) noexcept { return emplace(value); }
+        FST_ALWAYS_INLINE bool push(_T&& value) noexcept { return emplace(__fst::move(value)); }
+
+        /// @returns false when the queue is empty.
+        inline bool pop(_T& value) noexcept
+        {
+            size_t pos = _head.load_relaxed();
+            cell* c;
+
+            for (;;)
+            {
+                c = _cells + (pos & _mask);
+                const intptr_t diff = (intptr_t) c->sequence.load_acquire() - (intptr_t) (pos + 1);
+
+                if (diff == 0)
+                {
+                    if (_head.compare_exchange(pos, pos + 1)) { break; }
+                }
+                else if (diff < 0) { return false; }
+                else { pos = _head.load_relaxed(); }
+            }
+
+            value = __fst::move(*c->value());
+            c->value()->~_T();
+            c->sequence.store_release(pos + _mask + 1);
+            return true;
+        }
+
+        /// Claims up to count consecutive slots with one compare and swap and copies values into them.
+        /// @returns the number of values pushed, less than count when the queue is full.
+        inline size_type push_n(const _T* values, size_type count) noexcept
+        {
+            size_t pos = _tail.load_relaxed();
+            size_t n;
+
+            for (;;)
+            {
+                // A free slot at pos + i can only be claimed through _tail, it stays free until our swap succeeds.
+                n = 0;
+                for (; n < count; n++)
+                {
+                    if (_cells[(pos + n) & _mask].sequence.load_acquire() != pos + n) { break; }
+                }
+
+                if (n == 0)
+                {
+                    const size_t current = _tail.load_relaxed();
+                    if (current == pos) { return 0; }
+                    pos = current;
+                    continue;
+                }
+
+                if (_tail.compare_exchange(pos, pos + n)) { break; }
+            }
+
+            for (size_t i = 0; i < n; i++)
+            {
+                cell& c = _cells[(pos + i) & _mask];
+                fst_placement_new(c.value()) _T(values[i]);
+                c.sequence.store_release(pos + i + 1);
+            }
+
+            return n;
+        }
+
+        /// Claims up to count consecutive values with one compare and swap and moves them into values.
+        /// @returns the number of values popped.
+        inline size_type pop_n(_T* values, size_type count) noexcept
+        {
+            size_t pos = _head.load_relaxed();
+            size_t n;
+
+            for (;;)
+            {
+                n = 0;
+                for (; n < count; n++)
+                {
+                    if (_cells[(pos + n) & _mask].sequence.load_acquire() != pos + n + 1) { break; }
+                }
+
+                if (n == 0)
+                {
+                    const size_t current = _head.load_relaxed();
+                    if (current == pos) { return 0; }
+                    pos = current;
+                    continue;
+                }
+
+                if (_head.compare_exchange(pos, pos + n)) { break; }
+            }
+
+            for (size_t i = 0; i < n; i++)
+            {
+                cell& c = _cells[(pos + i) & _mask];
+                values[i] = __fst::move(*c.value());
+                c.value()->~_T();
+                c.sequence.store_release(pos + i + _mask + 1);
+            }
+
+            return n;
+        }
+
+      private:
+        struct cell
+        {
+            __fst::atomic<size_t> sequence;
+            alignas(_T) __fst::byte storage[sizeof(_T)];
+
+            FST_ALWAYS_INLINE _T* value() noexcept { return (_T*) storage; }
+        };
+
+        alignas(__fst::cache_line_size) __fst::atomic<size_t> _tail = 0;
+        alignas(__fst::cache_line_size) __fst::atomic<size_t> _head = 0;
+        alignas(__fst::cache_line_size) const size_t _mask;
+        cell* const _cells;
+    };
+
+FST_END_SUB_NAMESPACE
@@ -0,0 +1,502 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Alexandre Arsenault
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#pragma once
+
+///
+/// @file fst/async/task.h
+///
+/// C++20 coroutine types.
+///
+/// task<T> is a lazy coroutine, it starts when awaited and resumes its awaiter with
+/// symmetric transfer when it completes. generator<T> produces a sequence of values
+/// with co_yield.
+///
+/// Frames are allocated in the async_memory_category unless the coroutine takes
+/// frame_allocator_arg followed by a memory pool as its first parameters, the frame
+/// then comes from that pool (forward_memory_pool, small_memory_pool, scoped_arena, ...):
+///
+/// @code
+///     fst::async::task<size_t> decode(fst::async::frame_allocator_arg_t, fst::forward_memory_pool<>& pool, const char* path);
+///
+///     fst::forward_memory_pool<> pool;
+///     size_t size = fst::async::sync_wait(decode(fst::async::frame_allocator_arg, pool, "a.wav"));
+/// @endcode
+///
+/// co_await schedule_on(pool) moves the rest of a coroutine to a thread_pool worker.
+///
+
+#include "fst/common.h"
+#include "fst/async/common.h"
+#include "fst/async/event.h"
+#include "fst/async/thread_pool.h"
+#include "fst/memory.h"
+#include "fst/traits.h"
+#include "fst/iterator.h"
+#include <coroutine>
+
+FST_BEGIN_SUB_NAMESPACE(async)
+
+    /// Tag that makes the following memory pool parameter the allocator of the coroutine frame.
+    struct frame_allocator_arg_t
+    {
+        explicit frame_allocator_arg_t() = default;
+    };
+
+    FST_INLINE_VAR constexpr frame_allocator_arg_t frame_allocator_arg{};
+
+    template <class _T = void>
+    class task;
+
+    template <class _T>
+    class generator;
+
+    namespace detail
+    {
+        // Stored in front of every frame to release it where it came from.
+        struct frame_header
+        {
+            using deallocate_callback = void (*)(void* pool, void* ptr);
+            deallocate_callback deallocate;
+            void* pool;
+        };
+
+        FST_INLINE_VAR constexpr size_t frame_alignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+        FST_INLINE_VAR constexpr size_t frame_header_size = (sizeof(frame_header) + frame_alignment - 1) & ~(frame_alignment - 1);
+
+        FST_NODISCARD inline void* init_frame(void* ptr, frame_header::deallocate_callback dealloc, void* pool) noexcept
+        {
+            if (!ptr) { return nullptr; }
+            fst_placement_new(ptr) frame_header{ dealloc, pool };
+            return (__fst::byte*) ptr + frame_header_size;
+        }
+
+        FST_NODISCARD inline void* allocate_frame(size_t size) noexcept
+        {
+            return init_frame(__fst::aligned_allocate<__fst::async_memory_category>(size + frame_header_size, frame_alignment),
+                [](void*, void* ptr) { __fst::aligned_deallocate<__fst::async_memory_category>(ptr); }, nullptr);
+        }
+
+        template <class _Pool>
+        FST_NODISCARD inline void* allocate_frame(_Pool& pool, size_t size) noexcept
+        {
+            return init_frame(pool.aligned_allocate(size + frame_header_size, frame_alignment),
+                [](void* p, void* ptr) { ((_Pool*) p)->aligned_deallocate(ptr); }, (void*) __fst::addressof(pool));
+        }
+
+        inline void deallocate_frame(void* ptr) noexcept
+        {
+            frame_header* header = (frame_header*) ((__fst::byte*) ptr - frame_header_size);
+            header->deallocate(header->pool, header);
+        }
+
+        /// Frame allocation shared by every promise type.
+        /// The allocation failure path returns an invalid task or generator instead of throwing.
+        struct frame_allocation
+        {
+            FST_NODISCARD static void* operator new(size_t size) noexcept { return allocate_frame(size); }
+            static void operator delete(void* ptr) noexcept { deallocate_frame(ptr); }
+        };
+
+        /// Promise of a coroutine taking frame_allocator_arg, selected by the coroutine_traits
+        /// specializations at the end of this file.
+        ///
+        /// A templated placement operator new would do the same on frame_allocation but GCC
+        /// then reports every coroutine call as -Wmismatched-new-delete, here both operators
+        /// are plain members of the same class. The promise stays at the start of the frame,
+        /// _Promise::get_return_object is unaffected.
+        template <class _Promise, class _Pool, class... _Args>
+        struct pool_promise : _Promise
+        {
+            FST_NODISCARD static void* operator new(size_t size, frame_allocator_arg_t, _Pool& pool, _Args&...) noexcept
+            {
+                return allocate_frame(pool, size);
+            }
+
+            static void operator delete(void* ptr) noexcept { deallocate_frame(ptr); }
+        };
+
+        /// Same as pool_promise for member function coroutines, they get the object first.
+        template <class _Promise, class _This, class _Pool, class... _Args>
+        struct member_pool_promise : _Promise
+        {
+            FST_NODISCARD static void* operator new(size_t size, _This&, frame_allocator_arg_t, _Pool& pool, _Args&...) noexcept
+            {
+                return allocate_frame(pool, size);
+            }
+
+            static void operator delete(void* ptr) noexcept { deallocate_frame(ptr); }
+        };
+
+        struct task_promise_base : frame_allocation
+        {
+            struct final_awaiter
+            {
+                FST_NODISCARD FST_ALWAYS_INLINE bool await_ready() const noexcept { return false; }
+
+                template <class _Promise>
+                FST_NODISCARD inline std::coroutine_handle<> await_suspend(std::coroutine_handle<_Promise> handle) noexcept
+                {
+                    task_promise_base& promise = handle.promise();
+                    if (promise._continuation) { return promise._continuation; }
+
+                    // The frame can be destroyed as soon as the event is set.
+                    if (__fst::async::event* done = promise._done) { done->set(); }
+                    return std::noop_coroutine();
+                }
+
+                FST_ALWAYS_INLINE void await_resume() const noexcept {}
+            };
+
+            FST_NODISCARD FST_ALWAYS_INLINE std::suspend_always initial_suspend() const noexcept { return {}; }
+            FST_NODISCARD FST_ALWAYS_INLINE final_awaiter final_suspend() const noexcept { return {}; }
+
+            inline void unhandled_exception() const noexcept { fst_error("unhandled exception in a coroutine"); }
+
+            std::coroutine_handle<> _continuation;
+            __fst::async::event* _done = nullptr;
+        };
+
+        template <class _T>
+        struct task_promise : task_promise_base
+        {
+            static_assert(!__fst::is_reference_v<_T>, "task<T&> is not supported");
+
+            inline ~task_promise() noexcept
+            {
+                if (_has_value) { value().~_T(); }
+            }
+
+            FST_NODISCARD inline __fst::async::task<_T> get_return_object() noexcept;
+            FST_NODISCARD static inline __fst::async::task<_T> get_return_object_on_allocation_failure() noexcept { return {}; }
+
+            template <class _U>
+            inline void return_value(_U&& v) noexcept
+            {
+                fst_placement_new(_storage) _T(__fst::forward<_U>(v));
+                _has_value = true;
+            }
+
+            FST_NODISCARD FST_ALWAYS_INLINE _T& value() noexcept
+            {
+                fst_assert(_has_value, "task has no value");
+                return *(_T*) _storage;
+            }
+
+            alignas(_T) __fst::byte _storage[sizeof(_T)];
+            bool _has_value = false;
+        };
+
+        template <>
+        struct task_promise<void> : task_promise_base
+        {
+            FST_NODISCARD inline __fst::async::task<void> get_return_object() noexcept;
+            FST_NODISCARD static inline __fst::async::task<void> get_return_object_on_allocation_failure() noexcept;
+
+            FST_ALWAYS_INLINE void return_void() const noexcept {}
+            FST_ALWAYS_INLINE void value() const noexcept {}
+        };
+    } // namespace detail
+
+    /// Lazy coroutine returning a _T.
+    ///
+    /// Nothing runs until the task is awaited (or given to sync_wait), the frame is
+    /// destroyed with the task. A task is move only and can only be awaited once.
+    template <class _T>
+    class task
+    {
+      public:
+        using value_type = _T;
+        using promise_type = detail::task_promise<_T>;
+        using handle_type = std::coroutine_handle<promise_type>;
+
+        task() noexcept = default;
+
+        inline task(task&& other) noexcept
+            : _handle(__fst::exchange(other._handle, nullptr))
+        {}
+
+        task(const task&) = delete;
+        task& operator=(const task&) = delete;
+
+        inline ~task() noexcept
+        {
+            if (_handle) { _handle.destroy(); }
+        }
+
+        inline task& operator=(task&& other) noexcept
+        {
+            if (this != &other)
+            {
+                if (_handle) { _handle.destroy(); }
+                _handle = __fst::exchange(other._handle, nullptr);
+            }
+
+            return *this;
+        }
+
+        /// False when the frame allocation failed.
+        FST_NODISCARD FST_ALWAYS_INLINE bool is_valid() const noexcept { return (bool) _handle; }
+
+        FST_NODISCARD FST_ALWAYS_INLINE bool is_done() const noexcept { return _handle && _handle.done(); }
+
+        FST_NODISCARD FST_ALWAYS_INLINE explicit operator bool() const noexcept { return is_valid(); }
+
+        struct awaiter
+        {
+            handle_type handle;
+
+            FST_NODISCARD FST_ALWAYS_INLINE bool await_ready() const noexcept { return handle.done(); }
+
+            FST_NODISCARD FST_ALWAYS_INLINE std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) const noexcept
+            {
+                handle.promise()._continuation = awaiting;
+                return handle;
+            }
+
+            FST_ALWAYS_INLINE _T await_resume() const noexcept
+            {
+                if constexpr (!__fst::is_void_v<_T>) { return __fst::move(handle.promise().value()); }
+            }
+        };
+
+        FST_NODISCARD inline awaiter operator co_await() && noexcept
+        {
+            fst_assert(_handle, "awaiting an invalid task");
+            return awaiter{ _handle };
+        }
+
+        FST_NODISCARD FST_ALWAYS_INLINE handle_type handle() const noexcept { return _handle; }
+
+      private:
+        friend promise_type;
+
+        inline explicit task(handle_type h) noexcept
+            : _handle(h)
+        {}
+
+        handle_type _handle = nullptr;
+    };
+
+    namespace detail
+    {
+        template <class _T>
+        inline __fst::async::task<_T> task_promise<_T>::get_return_object() noexcept
+        {
+            return __fst::async::task<_T>(std::coroutine_handle<task_promise>::from_promise(*this));
+        }
+
+        inline __fst::async::task<void> task_promise<void>::get_return_object() noexcept
+        {
+            return __fst::async::task<void>(std::coroutine_handle<task_promise>::from_promise(*this));
+        }
+
+        inline __fst::async::task<void> task_promise<void>::get_return_object_on_allocation_failure() noexcept { return {}; }
+    } // namespace detail
+
+    /// Runs the task and blocks the calling thread until it completes.
+    template <class _T>
+    inline _T sync_wait(task<_T>&& t) noexcept
+    {
+        fst_assert(t.is_valid(), "sync_wait on an invalid task");
+
+        __fst::async::event done;
+        typename task<_T>::handle_type handle = t.handle();
+        handle.promise()._done = &done;
+        handle.resume();
+        done.wait();
+
+        if constexpr (!__fst::is_void_v<_T>) { return __fst::move(handle.promise().value()); }
+    }
+
+    /// Awaiter that resumes the coroutine on a worker of a thread_pool.
+    class schedule_awaiter
+    {
+      public:
+        inline explicit schedule_awaiter(__fst::async::thread_pool& pool) noexcept
+            : _pool(pool)
+        {}
+
+        FST_NODISCARD FST_ALWAYS_INLINE bool await_ready() const noexcept { return false; }
+
+        inline void await_suspend(std::coroutine_handle<> handle) const noexcept
+        {
+            // The handle is the task data, no callback data to allocate.
+            _pool.submit(__fst::async::thread_pool::task_data{
+                [](void* data) { std::coroutine_handle<>::from_address(data).resume(); }, [](void*) {}, handle.address() });
+        }
+
+        FST_ALWAYS_INLINE void await_resume() const noexcept {}
+
+      private:
+        __fst::async::thread_pool& _pool;
+    };
+
+    /// co_await schedule_on(pool) continues the coroutine on a worker of pool.
+    FST_NODISCARD inline schedule_awaiter schedule_on(__fst::async::thread_pool& pool) noexcept { return schedule_awaiter(pool); }
+
+    /// Synchronous coroutine producing a sequence of values with co_yield.
+    ///
+    /// Values are read in place through the iterator, co_yield of a temporary is fine
+    /// since the coroutine stays suspended until the iterator moves on.
+    template <class _T>
+    class generator
+    {
+      public:
+        using value_type = __fst::remove_cvref_t<_T>;
+        using reference = const value_type&;
+        using pointer = const value_type*;
+
+        struct promise_type : detail::frame_allocation
+        {
+            FST_NODISCARD inline generator get_return_object() noexcept { return generator(handle_type::from_promise(*this)); }
+            FST_NODISCARD static inline generator get_return_object_on_allocation_failure() noexcept { return {}; }
+
+            FST_NODISCARD FST_ALWAYS_INLINE std::suspend_always initial_suspend() const noexcept { return {}; }
+            FST_NODISCARD FST_ALWAYS_INLINE std::suspend_always final_suspend() const noexcept { return {}; }
+
+            FST_NODISCARD FST_ALWAYS_INLINE std::suspend_always yield_value(const value_type& v) noexcept
+            {
+                _value = __fst::addressof(v);
+                return {};
+            }
+
+            FST_ALWAYS_INLINE void return_void() const noexcept {}
+
+            inline void unhandled_exception() const noexcept { fst_error("unhandled exception in a coroutine"); }
+
+            pointer _value = nullptr;
+        };
+
+        using handle_type = std::coroutine_handle<promise_type>;
+
+        struct sentinel
+        {};
+
+        class iterator
+        {
+          public:
+            using iterator_category = __fst::input_iterator_tag;
+            using value_type = typename generator::value_type;
+            using difference_type = ptrdiff_t;
+            using pointer = typename generator::pointer;
+            using reference = typename generator::reference;
+
+            inline explicit iterator(handle_type h) noexcept
+                : _handle(h)
+            {}
+
+            FST_NODISCARD FST_ALWAYS_INLINE reference operator*() const noexcept { return *_handle.promise()._value; }
+            FST_NODISCARD FST_ALWAYS_INLINE pointer operator->() const noexcept { return _handle.promise()._value; }
+
+            FST_ALWAYS_INLINE iterator& operator++() noexcept
+            {
+                _handle.resume();
+                return *this;
+            }
+
+            FST_ALWAYS_INLINE void operator++(int) noexcept { ++*this; }
+
+            FST_NODISCARD FST_ALWAYS_INLINE bool operator==(sentinel) const noexcept { return !_handle || _handle.done(); }
+            FST_NODISCARD FST_ALWAYS_INLINE bool operator!=(sentinel) const noexcept { return _handle && !_handle.done(); }
+
+          private:
+            handle_type _handle;
+        };
+
+        generator() noexcept = default;
+
+        inline generator(generator&& other) noexcept
+            : _handle(__fst::exchange(other._handle, nullptr))
+        {}
+
+        generator(const generator&) = delete;
+        generator& operator=(const generator&) = delete;
+
+        inline ~generator() noexcept
+        {
+            if (_handle) { _handle.destroy(); }
+        }
+
+        inline generator& operator=(generator&& other) noexcept
+        {
+            if (this != &other)
+            {
+                if (_handle) { _handle.destroy(); }
+                _handle = __fst::exchange(other._handle, nullptr);
+            }
+
+            return *this;
+        }
+
+        /// False when the frame allocation failed.
+        FST_NODISCARD FST_ALWAYS_INLINE bool is_valid() const noexcept { return (bool) _handle; }
+
+        /// Runs the coroutine up to its first co_yield, begin() can only be called once.
+        FST_NODISCARD inline iterator begin() noexcept
+        {
+            if (_handle) { _handle.resume(); }
+            return iterator(_handle);
+        }
+
+        FST_NODISCARD FST_ALWAYS_INLINE sentinel end() const noexcept { return {}; }
+
+      private:
+        inline explicit generator(handle_type h) noexcept
+            : _handle(h)
+        {}
+
+        handle_type _handle = nullptr;
+    };
+
+FST_END_SUB_NAMESPACE
+
+namespace std
+{
+    template <class _T, class _Pool, class... _Args>
+    struct coroutine_traits<__fst::async::task<_T>, __fst::async::frame_allocator_arg_t, _Pool&, _Args...>
+    {
+        using promise_type = __fst::async::detail::pool_promise<typename __fst::async::task<_T>::promise_type, _Pool, _Args...>;
+    };
+
+    template <class _T, class _This, class _Pool, class... _Args>
+    struct coroutine_traits<__fst::async::task<_T>, _This&, __fst::async::frame_allocator_arg_t, _Pool&, _Args...>
+    {
+        using promise_type = __fst::async::detail::member_pool_promise<typename __fst::async::task<_T>::promise_type, _This, _Pool, _Args...>;
+    };
+
+    template <class _T, class _Pool, class... _Args>
+    struct coroutine_traits<__fst::async::generator<_T>, __fst::async::frame_allocator_arg_t, _Pool&, _Args...>
+    {
+        using promise_type = __fst::async::detail::pool_promise<typename __fst::async::generator<_T>::promise_type, _Pool, _Args...>;
+    };
+
+    template <class _T, class _This, class _Pool, class... _Args>
+    struct coroutine_traits<__fst::async::generator<_T>, _This&, __fst::async::frame_allocator_arg_t, _Pool&, _Args...>
+    {
+        using promise_type
+            = __fst::async::detail::member_pool_promise<typename __fst::async::generator<_T>::promise_type, _This, _Pool, _Args...>;
+    };
+} // namespace std
@@ -36,6 +36,7 @@ FST_BEGIN_SUB_NAMESPACE(async)
         //using data_type = void*;
         using process_callback = int (*)(thread*, void*);
         using release_callback = void (*)(thread*, void*);
+        using native_handle_type = void*;
 
         struct thread_data
         {
@@ -46,60 +47,111 @@ FST_BEGIN_SUB_NAMESPACE(async)
 
         struct native;
 
+        ///
+        class id
+        {
+          public:
+            constexpr id() noexcept = default;
+
+            inline constexpr explicit id(uint64_t value) noexcept
+                : _value(value)
+            {}
+
+            FST_NODISCARD inline constexpr uint64_t value() const noexcept { return _value; }
+
+            FST_NODISCARD inline constexpr bool operator==(id other) const noexcept { return _value == other._value; }
+            FST_NODISCARD inline constexpr bool operator!=(id other) const noexcept { return _value != other._value; }
+            FST_NODISCARD inline constexpr bool operator<(id other) const noexcept { return _value < other._value; }
+
+          private:
+            uint64_t _value = 0;
+        };
+
         thread() noexcept;
         thread(const thread&) = delete;
+        thread(thread&& other) noexcept;
 
         thread(thread_data tdata) noexcept;
 
-        template <class _Fct>
+        template <class _Fct, class _FctType = __fst::remove_cvref_t<_Fct>,
+            __fst::enable_if_t<!__fst::is_same_v<_FctType, thread> && !__fst::is_same_v<_FctType, thread_data>, int> = 0>
         inline thread(_Fct&& fct) noexcept
             : thread(thread_data{ [](thread*, void* data)
                 {
-                    _Fct& f = *(_Fct*) (data);
+                    _FctType& f = *(_FctType*) (data);
                     f();
                     return 0;
                 },
                 [](thread*, void* data)
                 {
-                    _Fct& f = *(_Fct*) (data);
-                    f.~_Fct();
-                    __fst::aligned_deallocate(data);
+                    _FctType& f = *(_FctType*) (data);
+                    f.~_FctType();
+                    __fst::aligned_deallocate<__fst::async_memory_category>(data);
                 },
-                fst_placement_new((_Fct*) __fst::aligned_allocate(sizeof(_Fct), alignof(_Fct))) _Fct(__fst::forward<_Fct>(fct)) })
+                fst_placement_new((_FctType*) __fst::aligned_allocate<__fst::async_memory_category>(sizeof(_FctType), alignof(_FctType)))
+                    _FctType(__fst::forward<_Fct>(fct)) })
         {}
 
+        /// Joins the thread if it's still joinable.
         ~thread() noexcept;
 
-        // types
-        //class id;
-        ////using native_handle_type = /* implementation-defined */;
+        thread& operator=(const thread&) = delete;
 
-        //// construct/copy/destroy
-        //thread() noexcept;
+        /// Joins the current thread if it's still joinable before taking ownership of other.
+        thread& operator=(thread&& other) noexcept;
 
-        //template <class F, class... Args>
-        //explicit thread(F&& f, Args&&... args);
+        void swap(thread& other) noexcept;
 
-        //~thread();
-        //thread(const thread&) = delete;
-        //thread(thread&&) noexcept;
-        thread& operator=(const thread&) = delete;
-        thread& operator=(thread&&) noexcept;
+        /// Returns true if the thread is running or finished but not yet joined or detached.
+        FST_NODISCARD bool joinable() const noexcept;
+
+        /// Blocks until the thread has finished executing.
+        void join() noexcept;
 
-        //// members
-        //void swap(thread&) noexcept;
-        //bool joinable() const noexcept;
-        //void join();
-        //void detach();
+        /// Lets the thread run independently, its thread_data is released when it finishes.
+        /// @warning The thread pointer given to the process callback is dangling once the thread object is gone.
+        void detach() noexcept;
 
-        //id get_id() const noexcept;
-        //native_handle_type native_handle();
+        /// Returns a default constructed id when the thread isn't joinable.
+        FST_NODISCARD id get_id() const noexcept;
 
-        // static members
-        //static unsigned int hardware_concurrency() noexcept;
+        FST_NODISCARD native_handle_type native_handle() const noexcept;
+
+        /// Sets the name shown in debuggers and profilers.
+        /// Names are truncated to 15 characters on linux.
+        /// @returns false if not supported by the platform (e.g. naming another thread on macOS).
+        bool set_name(const char* name) noexcept;
+
+        /// Restricts the thread to the cpus in cpu_mask (bit i is cpu i).
+        /// @returns false if not supported by the platform.
+        bool set_affinity(uint64_t cpu_mask) noexcept;
+
+        /// Pins the thread to a single cpu, cpu_index isn't limited to the 64 cpus of set_affinity.
+        /// @returns false if cpu_index doesn't exist or if not supported by the platform.
+        bool pin_to_cpu(size_t cpu_index) noexcept;
+
+        /// Number of concurrent threads supported by the hardware (at least 1).
+        FST_NODISCARD static unsigned int hardware_concurrency() noexcept;
 
         using native_pointer = __fst::unique_ptr<native, __fst::async_memory_category, __fst::default_memory_zone>;
         native_pointer _native;
         thread_data _thread_data;
     };
+
+    namespace this_thread
+    {
+        FST_NODISCARD __fst::async::thread::id get_id() noexcept;
+
+        /// Gives up the rest of the calling thread time slice.
+        void yield() noexcept;
+
+        /// Suspends the calling thread for at least the given number of microseconds.
+        void sleep_for_us(uint64_t microseconds) noexcept;
+
+        /// @see thread::set_name
+        bool set_name(const char* name) noexcept;
+
+        /// @see thread::set_affinity
+        bool set_affinity(uint64_t cpu_mask) noexcept;
+    } // namespace this_thread
 FST_END_SUB_NAMESPACE
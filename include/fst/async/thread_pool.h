@@ -0,0 +1,161 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Alexandre Arsenault
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+///
+/// @file fst/async/thread_pool.h
+/// @author Alexandre Arsenault (alx.arsenault@gmail.com)
+/// @date 2023
+///
+/// Work-stealing thread pool.
+///
+/// Every worker owns a Chase-Lev deque. Tasks submitted from a worker are pushed
+/// and popped at the bottom of its own deque (LIFO) while idle workers steal from
+/// the top of the other deques (FIFO). Tasks submitted from outside the pool go
+/// through a shared injection queue.
+///
+/// Tasks and their callback data are allocated in the async_memory_category.
+///
+
+#include "fst/common.h"
+#include "fst/async/common.h"
+#include "fst/async/thread.h"
+#include "fst/pointer.h"
+
+FST_BEGIN_SUB_NAMESPACE(async)
+
+    class thread_pool
+    {
+      public:
+        using process_callback = void (*)(void*);
+        using release_callback = void (*)(void*);
+
+        struct task_data
+        {
+            process_callback process;
+            release_callback release;
+            void* data;
+        };
+
+        struct task;
+
+        static constexpr size_t npos = (__fst::numeric_limits<size_t>::max)();
+
+        /// Reference to a submitted task.
+        /// The task memory is released once it has completed and every handle is gone.
+        class task_handle
+        {
+          public:
+            task_handle() noexcept = default;
+            task_handle(const task_handle& other) noexcept;
+            task_handle(task_handle&& other) noexcept;
+
+            ~task_handle() noexcept;
+
+            task_handle& operator=(const task_handle& other) noexcept;
+            task_handle& operator=(task_handle&& other) noexcept;
+
+            FST_NODISCARD inline bool is_valid() const noexcept { return _task != nullptr; }
+
+            /// Returns true once the task callback has returned.
+            FST_NODISCARD bool is_done() const noexcept;
+
+          private:
+            friend class thread_pool;
+
+            inline explicit task_handle(task* t) noexcept
+                : _task(t)
+            {}
+
+            task* _task = nullptr;
+        };
+
+        /// Creates one worker per hardware thread.
+        thread_pool() noexcept;
+
+        explicit thread_pool(size_t thread_count) noexcept;
+
+        /// When pin_workers is true, worker i is pinned to cpu (i % hardware_concurrency).
+        thread_pool(size_t thread_count, bool pin_workers) noexcept;
+
+        thread_pool(const thread_pool&) = delete;
+        thread_pool(thread_pool&&) = delete;
+
+        /// Waits for all pending tasks and joins the workers.
+        ~thread_pool() noexcept;
+
+        thread_pool& operator=(const thread_pool&) = delete;
+        thread_pool& operator=(thread_pool&&) = delete;
+
+        /// Submits a task.
+        /// From a worker of this pool, the task goes to the worker's own deque.
+        task_handle submit(task_data tdata) noexcept;
+
+        template <class _Fct>
+        inline task_handle submit(_Fct&& fct) noexcept
+        {
+            using fct_type = __fst::remove_cvref_t<_Fct>;
+
+            return submit(task_data{ [](void* data)
+                {
+                    fct_type& f = *(fct_type*) (data);
+                    f();
+                },
+                [](void* data)
+                {
+                    fct_type& f = *(fct_type*) (data);
+                    f.~fct_type();
+                    __fst::aligned_deallocate<__fst::async_memory_category>(data);
+                },
+                fst_placement_new((fct_type*) __fst::aligned_allocate<__fst::async_memory_category>(sizeof(fct_type), alignof(fct_type)))
+                    fct_type(__fst::forward<_Fct>(fct)) });
+        }
+
+        /// Blocks until every submitted task has completed.
+        /// The calling thread executes pending tasks while waiting.
+        /// @warning Must not be called from a task running in this pool, use wait(task_handle) instead.
+        void wait() noexcept;
+
+        /// Blocks until the given task has completed.
+        /// The calling thread executes pending tasks while waiting.
+        void wait(const task_handle& handle) noexcept;
+
+        /// Waits for all pending tasks and stops the workers.
+        /// No task can be submitted after the pool was joined.
+        void join() noexcept;
+
+        /// Number of worker threads.
+        FST_NODISCARD size_t size() const noexcept;
+
+        /// Index of the calling thread in this pool or npos if it's not one of its workers.
+        FST_NODISCARD size_t current_worker_index() const noexcept;
+
+      private:
+        struct native;
+        using native_pointer = __fst::unique_ptr<native, __fst::async_memory_category, __fst::default_memory_zone>;
+        native_pointer _native;
+    };
+
+FST_END_SUB_NAMESPACE
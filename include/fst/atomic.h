@@ -235,6 +235,22 @@ FST_END_NAMESPACE
 #endif
 
 FST_BEGIN_NAMESPACE
+    namespace detail
+    {
+        /// Blocks the calling thread until notified if the size bytes at address are equal to expected.
+        /// Can return spuriously, the caller is responsible for checking the value again.
+        /// Uses a futex on linux and WaitOnAddress on windows.
+        /// @see https://developers.redhat.com/articles/2022/12/06/implementing-c20-atomic-waiting-libstdc
+        void atomic_wait(const volatile void* address, const void* expected, size_t size) noexcept;
+
+        /// Same as atomic_wait but gives up after timeout_us microseconds.
+        /// @returns false if the value was still equal to expected when the timeout expired.
+        bool atomic_wait_for_us(const volatile void* address, const void* expected, size_t size, uint64_t timeout_us) noexcept;
+
+        void atomic_notify_one(const volatile void* address, size_t size) noexcept;
+        void atomic_notify_all(const volatile void* address, size_t size) noexcept;
+    } // namespace detail
+
     template <typename T>
     class atomic
     {
@@ -302,8 +318,7 @@ FST_BEGIN_NAMESPACE
         FST_ALWAYS_INLINE bool compare_exchange(T& expected_val, T new_val) noexcept
         {
 #if __FST_ATOMIC_GCC_INTRINSICS__
-            T e = expected_val;
-            return __atomic_compare_exchange_n(&_value, &e, new_val, true, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+            return __atomic_compare_exchange_n(&_value, &expected_val, new_val, true, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
 #elif __FST_ATOMIC_MSVC_INTRINSICS__
             const T old_val = msvc::interlocked<T>::compare_exchange(&_value, new_val, expected_val);
             if (old_val == expected_val) { return true; }
@@ -313,8 +328,57 @@ FST_BEGIN_NAMESPACE
                 return false;
             }
 #else
-            T e = expected_val;
-            return _value.compare_exchange_weak(e, new_val);
+            return _value.compare_exchange_weak(expected_val, new_val);
+#endif
+        }
+
+        /// @brief Performs an atomic compare-and-swap (CAS) operation that never fails spuriously.
+        ///
+        /// Same as compare_exchange but only returns false when the value of the atomic object
+        /// is actually different from @c expected_val, in which case @c expected_val is updated.
+        ///
+        /// @param expected_val The expected value of the atomic object.
+        /// @param new_val The new value to write to the atomic object.
+        /// @returns True if new_value was written to the atomic object.
+        FST_ALWAYS_INLINE bool compare_exchange_strong(T& expected_val, T new_val) noexcept
+        {
+#if __FST_ATOMIC_GCC_INTRINSICS__
+            return __atomic_compare_exchange_n(&_value, &expected_val, new_val, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#elif __FST_ATOMIC_MSVC_INTRINSICS__
+            // The interlocked functions never fail spuriously.
+            return compare_exchange(expected_val, new_val);
+#else
+            return _value.compare_exchange_strong(expected_val, new_val);
+#endif
+        }
+
+        /// @brief Performs an atomic addition.
+        /// @returns The value of the atomic object before the addition.
+        FST_ALWAYS_INLINE T fetch_add(T value) noexcept
+        {
+#if __FST_ATOMIC_GCC_INTRINSICS__
+            return __atomic_fetch_add(&_value, value, __ATOMIC_SEQ_CST);
+#elif __FST_ATOMIC_MSVC_INTRINSICS__
+            T old_val = _value;
+            while (!compare_exchange(old_val, static_cast<T>(old_val + value))) {}
+            return old_val;
+#else
+            return _value.fetch_add(value);
+#endif
+        }
+
+        /// @brief Performs an atomic subtraction.
+        /// @returns The value of the atomic object before the subtraction.
+        FST_ALWAYS_INLINE T fetch_sub(T value) noexcept
+        {
+#if __FST_ATOMIC_GCC_INTRINSICS__
+            return __atomic_fetch_sub(&_value, value, __ATOMIC_SEQ_CST);
+#elif __FST_ATOMIC_MSVC_INTRINSICS__
+            T old_val = _value;
+            while (!compare_exchange(old_val, static_cast<T>(old_val - value))) {}
+            return old_val;
+#else
+            return _value.fetch_sub(value);
 #endif
         }
 
@@ -350,6 +414,63 @@ FST_BEGIN_NAMESPACE
 #endif
         }
 
+        /// @brief Atomic store without any ordering guarantee.
+        ///
+        /// Meant for values that only one thread writes and others read from time to time
+        /// (e.g. statistics), it compiles to a plain store on x86 and arm.
+        FST_ALWAYS_INLINE void store_relaxed(T new_val) noexcept
+        {
+#if __FST_ATOMIC_GCC_INTRINSICS__
+            __atomic_store_n(&_value, new_val, __ATOMIC_RELAXED);
+#elif __FST_ATOMIC_MSVC_INTRINSICS__
+            *(T volatile*) &_value = new_val;
+#else
+            _value.store(new_val, std::memory_order_relaxed);
+#endif
+        }
+
+        /// @brief Atomic load without any ordering guarantee.
+        /// @see store_relaxed
+        FST_NODISCARD FST_ALWAYS_INLINE T load_relaxed() const noexcept
+        {
+#if __FST_ATOMIC_GCC_INTRINSICS__
+            return __atomic_load_n(&_value, __ATOMIC_RELAXED);
+#elif __FST_ATOMIC_MSVC_INTRINSICS__
+            return *(const T volatile*) &_value;
+#else
+            return _value.load(std::memory_order_relaxed);
+#endif
+        }
+
+        /// @brief Atomic store with release ordering.
+        ///
+        /// Writes made before the store are visible to a thread that reads the value with load_acquire.
+        FST_ALWAYS_INLINE void store_release(T new_val) noexcept
+        {
+#if __FST_ATOMIC_GCC_INTRINSICS__
+            __atomic_store_n(&_value, new_val, __ATOMIC_RELEASE);
+#elif __FST_ATOMIC_MSVC_INTRINSICS__
+            // Volatile stores have release semantics with msvc (/volatile:ms).
+            *(T volatile*) &_value = new_val;
+#else
+            _value.store(new_val, std::memory_order_release);
+#endif
+        }
+
+        /// @brief Atomic load with acquire ordering.
+        /// @see store_release
+        FST_NODISCARD FST_ALWAYS_INLINE T load_acquire() const noexcept
+        {
+#if __FST_ATOMIC_GCC_INTRINSICS__
+            return __atomic_load_n(&_value, __ATOMIC_ACQUIRE);
+#elif __FST_ATOMIC_MSVC_INTRINSICS__
+            // Volatile loads have acquire semantics with msvc (/volatile:ms).
+            return *(const T volatile*) &_value;
+#else
+            return _value.load(std::memory_order_acquire);
+#endif
+        }
+
         /// @brief Performs an atomic exchange operation.
         ///
         /// The value of the atomic object is unconditionally updated to the new
@@ -368,6 +489,37 @@ FST_BEGIN_NAMESPACE
 #endif
         }
 
+        /// @brief Blocks until notified and the value of the atomic object is different from @c old_val.
+        ///
+        /// Spins for a short while before putting the thread to sleep.
+        /// A store is only visible to a sleeping thread after notify_one or notify_all.
+        FST_ALWAYS_INLINE void wait(T old_val) const noexcept
+        {
+            for (int i = 0; i < 64; i++)
+            {
+                if (load() != old_val) { return; }
+                FST_NOP();
+            }
+
+            while (load() == old_val)
+            {
+                detail::atomic_wait(&_value, &old_val, sizeof(T));
+            }
+        }
+
+        /// @brief Same as wait but gives up after timeout_us microseconds.
+        /// @returns false on timeout.
+        FST_ALWAYS_INLINE bool wait_for_us(T old_val, uint64_t timeout_us) const noexcept
+        {
+            return load() != old_val || detail::atomic_wait_for_us(&_value, &old_val, sizeof(T), timeout_us);
+        }
+
+        /// @brief Wakes up at least one thread blocked in wait.
+        FST_ALWAYS_INLINE void notify_one() noexcept { detail::atomic_notify_one(&_value, sizeof(T)); }
+
+        /// @brief Wakes up all the threads blocked in wait.
+        FST_ALWAYS_INLINE void notify_all() noexcept { detail::atomic_notify_all(&_value, sizeof(T)); }
+
         FST_ALWAYS_INLINE T operator=(T new_value) noexcept
         {
             store(new_value);
@@ -75,26 +75,61 @@
 
 #if FST_PLATFORM_HAS_IMMINTRIN_H
 
+#if defined(FST_SIMD_DISPATCH_TARGET)
+// The runtime dispatch kernels (src/simd/dispatch_*.cpp) are compiled for a single
+// width, its instruction set is enabled with a target pragma (src/simd/dispatch_kernels.h).
+#define FST_SIMD_128 (FST_SIMD_DISPATCH_TARGET == 128)
+#define FST_SIMD_256 (FST_SIMD_DISPATCH_TARGET == 256)
+#define FST_SIMD_512 (FST_SIMD_DISPATCH_TARGET == 512)
+
+#else
+
 #if FST_PLATFORM_HAS_SSE2 && FST_USE_SIMD_128
 #define FST_SIMD_128 1
 #else
 #define FST_SIMD_128 0
 #endif
 
-#if FST_PLATFORM_HAS_AVX && FST_USE_SIMD_256
+#if FST_PLATFORM_HAS_AVX2 && FST_USE_SIMD_256
 #define FST_SIMD_256 1
 #else
 #define FST_SIMD_256 0
 #endif
 
-#if FST_PLATFORM_HAS_AVX2 && FST_USE_SIMD_512
+#if FST_PLATFORM_HAS_AVX_512 && FST_USE_SIMD_512
 #define FST_SIMD_512 1
 #else
 #define FST_SIMD_512 0
 #endif
 
+#endif // FST_SIMD_DISPATCH_TARGET
+
 #endif //
 
+#if FST_PLATFORM_HAS_IMMINTRIN_H && FST_PLATFORM_HAS_AVX_512 && FST_USE_SIMD_DISPATCH
+#define FST_SIMD_DISPATCH 1
+#else
+#define FST_SIMD_DISPATCH 0
+#endif
+
+/// Namespace of the simd containers and vector operations (fst/simd.h).
+/// The runtime dispatch kernels wrap it in an inline namespace per instruction set
+/// to keep their instantiations apart from the ones of the rest of the program.
+#if defined(FST_SIMD_DISPATCH_TARGET)
+#define FST_BEGIN_SIMD_NAMESPACE                                        \
+    FST_BEGIN_SUB_NAMESPACE(simd)                                       \
+        inline namespace FST_CONCAT(dispatch_, FST_SIMD_DISPATCH_TARGET) \
+        {
+
+#define FST_END_SIMD_NAMESPACE \
+    }                          \
+    FST_END_SUB_NAMESPACE
+
+#else
+#define FST_BEGIN_SIMD_NAMESPACE FST_BEGIN_SUB_NAMESPACE(simd)
+#define FST_END_SIMD_NAMESPACE FST_END_SUB_NAMESPACE
+#endif
+
 // #if defined(FST_SIMD_128) && FST_IS_MACRO_EMPTY(FST_SIMD_128)
 
 //
@@ -199,6 +234,9 @@ FST_END_NAMESPACE
 //
 #include "fst/detail/__alignment.h"
 
+// Needed by fst/hash.h, which can't include fst/memory_utils.h.
+#include "fst/detail/__memcpy.h"
+
 FST_BEGIN_NAMESPACE
 
     FST_INLINE_VAR constexpr size_t dynamic_size = (__fst::numeric_limits<size_t>::max)();
@@ -19,6 +19,9 @@ FST_BEGIN_NAMESPACE
     FST_INLINE_VAR constexpr size_t default_vectorized_size_threshold = 4096;
     using default_vectorized_alignment_t = __fst::size_constant<default_vectorized_alignment>;
 
+    /// Size of a cache line, used to pad data shared between threads and avoid false sharing.
+    FST_INLINE_VAR constexpr size_t cache_line_size = 64;
+
     ///
     template <class _T>
     FST_INLINE_VAR constexpr size_t default_alignof = alignof(_T) < __fst::default_alignment ? __fst::default_alignment : alignof(_T);
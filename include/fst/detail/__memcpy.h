@@ -0,0 +1,37 @@
+///
+///
+///
+
+#include <string.h>
+
+FST_BEGIN_NAMESPACE
+
+    /// Copies `size` bytes from the object pointed to by `src` to the object pointed to by `dst`.
+    /// Both objects are reinterpreted as arrays of `unsigned char`.
+    ///
+    /// @param dst pointer to the memory location to copy to
+    /// @param src pointer to the memory location to copy from
+    /// @param size number of bytes to copy
+    ///
+    /// @note If the objects overlap, the behavior is undefined.
+    ///.@note If either dest or src is an invalid or null pointer, the behavior is undefined, even if count is zero.
+    FST_ALWAYS_INLINE void memcpy(void* dst, const void* src, size_t size) noexcept
+    {
+#if __FST_CLANG__
+        __builtin_memcpy(dst, src, size);
+#else
+
+#if __FST_MSVC__ && __FST_INTEL__
+#pragma intrinsic(memcpy)
+#endif
+
+        ::memcpy(dst, src, size);
+
+#if __FST_MSVC__ && __FST_INTEL__
+#pragma function(memcpy)
+#endif
+
+#endif
+    }
+
+FST_END_NAMESPACE
@@ -0,0 +1,383 @@
+#pragma once
+
+#include "fst/common.h"
+#include "fst/math.h"
+#include "fst/detail/simd/sse.h"
+
+#if FST_SIMD_256 || FST_SIMD_512
+
+FST_BEGIN_SIMD_NAMESPACE
+
+    union m256
+    {
+        __m256 v; // AVX 8 x float vector
+        float a[8]; // scalar array of 8 floats
+
+        inline m256(__m256 vv) noexcept
+            : v(vv)
+        {}
+
+        inline float& operator[](size_t index) noexcept { return a[index]; }
+        inline float operator[](size_t index) const noexcept { return a[index]; }
+    };
+
+    union m256d
+    {
+        __m256d v; // AVX 4 x double vector
+        double a[4]; // scalar array of 4 doubles
+
+        inline m256d(__m256d vv) noexcept
+            : v(vv)
+        {}
+
+        inline double& operator[](size_t index) noexcept { return a[index]; }
+        inline double operator[](size_t index) const noexcept { return a[index]; }
+    };
+
+    namespace detail
+    {
+        /// Applies a scalar function on every lane of a m128/m256/m512 union.
+        /// Used for the functions that don't have a vectorized implementation.
+        template <class _Union, class _Fct>
+        FST_ALWAYS_INLINE auto map_lanes(_Union x, _Fct fct) noexcept
+        {
+            for (auto& value : x.a)
+            {
+                value = fct(value);
+            }
+            return x.v;
+        }
+
+        template <class _Union, class _Fct>
+        FST_ALWAYS_INLINE auto map_lanes(_Union x, _Union y, _Fct fct) noexcept
+        {
+            for (size_t i = 0; i < sizeof(x.a) / sizeof(x.a[0]); i++)
+            {
+                x.a[i] = fct(x.a[i], y.a[i]);
+            }
+            return x.v;
+        }
+    } // namespace detail
+
+    //
+    // Masked load/store for the last incomplete vector.
+    //
+    inline __m256 _mm256_load_partial_ps(const float* ptr, size_t count) noexcept
+    {
+        const __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32((int) count), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        return _mm256_maskload_ps(ptr, mask);
+    }
+
+    inline void _mm256_store_partial_ps(float* dst, __m256 src, size_t count) noexcept
+    {
+        const __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32((int) count), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        _mm256_maskstore_ps(dst, mask, src);
+    }
+
+    inline __m256d _mm256_load_partial_pd(const double* ptr, size_t count) noexcept
+    {
+        const __m256i mask = _mm256_cmpgt_epi64(_mm256_set1_epi64x((long long) count), _mm256_setr_epi64x(0, 1, 2, 3));
+        return _mm256_maskload_pd(ptr, mask);
+    }
+
+    inline void _mm256_store_partial_pd(double* dst, __m256d src, size_t count) noexcept
+    {
+        const __m256i mask = _mm256_cmpgt_epi64(_mm256_set1_epi64x((long long) count), _mm256_setr_epi64x(0, 1, 2, 3));
+        _mm256_maskstore_pd(dst, mask, src);
+    }
+
+    //
+    // Horizontal sum.
+    //
+    inline float _mm256_hsum_ps(__m256 x) noexcept { return _mm_hsum_ps(_mm_add_ps(_mm256_castps256_ps128(x), _mm256_extractf128_ps(x, 1))); }
+
+    inline double _mm256_hsum_pd(__m256d x) noexcept { return _mm_hsum_pd(_mm_add_pd(_mm256_castpd256_pd128(x), _mm256_extractf128_pd(x, 1))); }
+
+    // a * b + c, fused when fma is enabled (always the case with the flags set by cmake).
+#if defined(__FMA__) || __FST_MSVC__
+    FST_INLINE_VAR constexpr bool _mm256_fused_mul_add = true;
+#else
+    FST_INLINE_VAR constexpr bool _mm256_fused_mul_add = false;
+#endif
+
+    inline __m256 _mm256_mul_add_ps(__m256 a, __m256 b, __m256 c) noexcept
+    {
+#if defined(__FMA__) || __FST_MSVC__
+        return _mm256_fmadd_ps(a, b, c);
+#else
+        return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+    }
+
+    inline __m256d _mm256_mul_add_pd(__m256d a, __m256d b, __m256d c) noexcept
+    {
+#if defined(__FMA__) || __FST_MSVC__
+        return _mm256_fmadd_pd(a, b, c);
+#else
+        return _mm256_add_pd(_mm256_mul_pd(a, b), c);
+#endif
+    }
+
+    //
+    // Building blocks of the fst/simd_math.h kernels, see sse.h.
+    //
+
+    inline __m256 _mm256_nearest_ps(__m256 x) noexcept { return _mm256_round_ps(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+
+    inline __m256d _mm256_nearest_pd(__m256d x) noexcept { return _mm256_round_pd(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+
+    inline __m256 _mm256_abs_ps(__m256 x) noexcept { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), x); }
+
+    inline __m256d _mm256_abs_pd(__m256d x) noexcept { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), x); }
+
+    inline __m256 _mm256_copysign_ps(__m256 x, __m256 s) noexcept
+    {
+        const __m256 sign_mask = _mm256_set1_ps(-0.0f);
+        return _mm256_or_ps(_mm256_andnot_ps(sign_mask, x), _mm256_and_ps(sign_mask, s));
+    }
+
+    inline __m256d _mm256_copysign_pd(__m256d x, __m256d s) noexcept
+    {
+        const __m256d sign_mask = _mm256_set1_pd(-0.0);
+        return _mm256_or_pd(_mm256_andnot_pd(sign_mask, x), _mm256_and_pd(sign_mask, s));
+    }
+
+    inline __m256 _mm256_pow2i_ps(__m256 n) noexcept
+    {
+        return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127)), 23));
+    }
+
+    inline __m256d _mm256_pow2i_pd(__m256d n) noexcept
+    {
+        const __m256i e = _mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(n));
+        return _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_add_epi64(e, _mm256_set1_epi64x(1023)), 52));
+    }
+
+    inline __m256 _mm256_exponent_ps(__m256 x) noexcept
+    {
+        return _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(_mm256_castps_si256(x), 23), _mm256_set1_epi32(127)));
+    }
+
+    inline __m256d _mm256_exponent_pd(__m256d x) noexcept
+    {
+        const __m256d two52 = _mm256_set1_pd(4503599627370496.0);
+        const __m256i e = _mm256_or_si256(_mm256_srli_epi64(_mm256_castpd_si256(x), 52), _mm256_castpd_si256(two52));
+        return _mm256_sub_pd(_mm256_sub_pd(_mm256_castsi256_pd(e), two52), _mm256_set1_pd(1023.0));
+    }
+
+    inline __m256 _mm256_mantissa_ps(__m256 x) noexcept
+    {
+        const __m256i m = _mm256_and_si256(_mm256_castps_si256(x), _mm256_set1_epi32(0x007FFFFF));
+        return _mm256_castsi256_ps(_mm256_or_si256(m, _mm256_set1_epi32(0x3F800000)));
+    }
+
+    inline __m256d _mm256_mantissa_pd(__m256d x) noexcept
+    {
+        const __m256i m = _mm256_and_si256(_mm256_castpd_si256(x), _mm256_set1_epi64x(0x000FFFFFFFFFFFFFLL));
+        return _mm256_castsi256_pd(_mm256_or_si256(m, _mm256_set1_epi64x(0x3FF0000000000000LL)));
+    }
+
+    inline __m256 _mm256_less_ps(__m256 a, __m256 b) noexcept { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+
+    inline __m256d _mm256_less_pd(__m256d a, __m256d b) noexcept { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+
+    inline __m256 _mm256_less_equal_ps(__m256 a, __m256 b) noexcept { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+
+    inline __m256d _mm256_less_equal_pd(__m256d a, __m256d b) noexcept { return _mm256_cmp_pd(a, b, _CMP_LE_OQ); }
+
+    inline __m256 _mm256_equal_ps(__m256 a, __m256 b) noexcept { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+
+    inline __m256d _mm256_equal_pd(__m256d a, __m256d b) noexcept { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+
+    inline __m256 _mm256_is_nan_ps(__m256 a) noexcept { return _mm256_cmp_ps(a, a, _CMP_UNORD_Q); }
+
+    inline __m256d _mm256_is_nan_pd(__m256d a) noexcept { return _mm256_cmp_pd(a, a, _CMP_UNORD_Q); }
+
+    inline __m256 _mm256_select_ps(__m256 mask, __m256 a, __m256 b) noexcept { return _mm256_blendv_ps(b, a, mask); }
+
+    inline __m256d _mm256_select_pd(__m256d mask, __m256d a, __m256d b) noexcept { return _mm256_blendv_pd(b, a, mask); }
+
+    inline __m256 _mm256_or_mask_ps(__m256 a, __m256 b) noexcept { return _mm256_or_ps(a, b); }
+
+    inline __m256d _mm256_or_mask_pd(__m256d a, __m256d b) noexcept { return _mm256_or_pd(a, b); }
+
+    inline __m256 _mm256_and_mask_ps(__m256 a, __m256 b) noexcept { return _mm256_and_ps(a, b); }
+
+    inline __m256d _mm256_and_mask_pd(__m256d a, __m256d b) noexcept { return _mm256_and_pd(a, b); }
+
+    inline __m256 _mm256_fmod_ps(__m256 x, __m256 y) noexcept
+    {
+        return detail::map_lanes(m256(x), m256(y), [](float a, float b) { return __fst::fmod(a, b); });
+    }
+
+    inline __m256d _mm256_fmod_pd(__m256d x, __m256d y) noexcept
+    {
+        return detail::map_lanes(m256d(x), m256d(y), [](double a, double b) { return __fst::fmod(a, b); });
+    }
+
+#if !FST_PLATFORM_HAS_SVML
+    /*
+     * Same Cephes range reduction and polynomials as _mm_sincos_ps in sse.h,
+     * on 8 lanes. Sine and cosine share all the work up to the final selection,
+     * sin and cos only keep the part they need once inlined.
+     */
+    inline __m256 _mm256_sincos_ps(__m256 * c, __m256 x) noexcept
+    {
+        const __m256 sign_mask = _mm256_castsi256_ps(_mm256_set1_epi32(to_int(0x80000000)));
+
+        // Extract the sign bit and work with absolute values
+        __m256 sin_signbit = _mm256_and_ps(x, sign_mask);
+        x = _mm256_andnot_ps(sign_mask, x);
+
+        // Cephes method for scaling between 0 et pi/4
+        __m256 y = _mm256_mul_ps(x, _mm256_set1_ps(1.27323954473516f));
+        __m256i yi = _mm256_cvttps_epi32(y);
+        yi = _mm256_add_epi32(yi, _mm256_set1_epi32(1));
+        yi = _mm256_and_si256(yi, _mm256_set1_epi32(~1));
+        y = _mm256_cvtepi32_ps(yi);
+
+        // Cosine sign flag
+        __m256i yi_cos = _mm256_sub_epi32(yi, _mm256_set1_epi32(2));
+        yi_cos = _mm256_andnot_si256(yi_cos, _mm256_set1_epi32(4));
+        const __m256 cos_signbit = _mm256_castsi256_ps(_mm256_slli_epi32(yi_cos, 29));
+
+        // Sine swap sign flag
+        const __m256i flag = _mm256_slli_epi32(_mm256_and_si256(yi, _mm256_set1_epi32(4)), 29);
+        sin_signbit = _mm256_xor_ps(sin_signbit, _mm256_castsi256_ps(flag));
+
+        // Polynom selection mask
+        const __m256 polymask = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(yi, _mm256_set1_epi32(2)), _mm256_setzero_si256()));
+
+        // Extended precision modular arithmetic (Cody and Waite)
+        x = _mm256_sub_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(0.78515625f)));
+        x = _mm256_sub_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(2.4187564849853515625e-4f)));
+        x = _mm256_sub_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(3.77489497744594108e-8f)));
+
+        // First polynom x \in [0, pi/4]
+        const __m256 z = _mm256_mul_ps(x, x);
+        y = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(2.443315711809948e-5f), z), _mm256_set1_ps(-1.388731625493765e-3f));
+        y = _mm256_add_ps(_mm256_mul_ps(y, z), _mm256_set1_ps(4.166664568298827e-2f));
+        y = _mm256_mul_ps(_mm256_mul_ps(y, z), z);
+        y = _mm256_sub_ps(y, _mm256_mul_ps(z, _mm256_set1_ps(0.5f)));
+        y = _mm256_add_ps(y, _mm256_set1_ps(1.0f));
+
+        // Second polynom
+        __m256 y2 = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(-1.9515295891e-4f), z), _mm256_set1_ps(8.3321608736e-3f));
+        y2 = _mm256_add_ps(_mm256_mul_ps(y2, z), _mm256_set1_ps(-1.6666654611e-1f));
+        y2 = _mm256_mul_ps(_mm256_mul_ps(y2, z), x);
+        y2 = _mm256_add_ps(y2, x);
+
+        // Select the correct result
+        const __m256 ysin2 = _mm256_and_ps(polymask, y2);
+        const __m256 ysin1 = _mm256_andnot_ps(polymask, y);
+        const __m256 ycos2 = _mm256_sub_ps(y2, ysin2);
+        const __m256 ycos1 = _mm256_sub_ps(y, ysin1);
+
+        // Update the sign
+        *c = _mm256_xor_ps(_mm256_add_ps(ycos1, ycos2), cos_signbit);
+        return _mm256_xor_ps(_mm256_add_ps(ysin1, ysin2), sin_signbit);
+    }
+
+    inline __m256 _mm256_sin_ps(__m256 x) noexcept
+    {
+        __m256 c;
+        return _mm256_sincos_ps(&c, x);
+    }
+
+    inline __m256 _mm256_cos_ps(__m256 x) noexcept
+    {
+        __m256 c;
+        _mm256_sincos_ps(&c, x);
+        return c;
+    }
+
+    inline __m256 _mm256_tan_ps(__m256 x) noexcept
+    {
+        __m256 c;
+        const __m256 s = _mm256_sincos_ps(&c, x);
+        return _mm256_div_ps(s, c);
+    }
+
+    inline __m256 _mm256_invsqrt_ps(__m256 x) noexcept { return _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(x)); }
+
+    inline __m256 _mm256_log_ps(__m256 x) noexcept
+    {
+        return detail::map_lanes(m256(x), [](float v) { return __fst::log(v); });
+    }
+
+    inline __m256 _mm256_log10_ps(__m256 x) noexcept
+    {
+        return detail::map_lanes(m256(x), [](float v) { return __fst::log10(v); });
+    }
+
+    inline __m256 _mm256_log2_ps(__m256 x) noexcept
+    {
+        return detail::map_lanes(m256(x), [](float v) { return __fst::log2(v); });
+    }
+
+    inline __m256 _mm256_exp10_ps(__m256 x) noexcept
+    {
+        return detail::map_lanes(m256(x), [](float v) { return __fst::exp10(v); });
+    }
+
+    inline __m256 _mm256_exp2_ps(__m256 x) noexcept
+    {
+        return detail::map_lanes(m256(x), [](float v) { return __fst::exp2(v); });
+    }
+
+    inline __m256 _mm256_pow_ps(__m256 x, __m256 y) noexcept
+    {
+        return detail::map_lanes(m256(x), m256(y), [](float a, float b) { return __fst::pow(a, b); });
+    }
+
+    inline __m256d _mm256_sin_pd(__m256d x) noexcept
+    {
+        return detail::map_lanes(m256d(x), [](double v) { return __fst::sin(v); });
+    }
+
+    inline __m256d _mm256_cos_pd(__m256d x) noexcept
+    {
+        return detail::map_lanes(m256d(x), [](double v) { return __fst::cos(v); });
+    }
+
+    inline __m256d _mm256_tan_pd(__m256d x) noexcept
+    {
+        return detail::map_lanes(m256d(x), [](double v) { return __fst::tan(v); });
+    }
+
+    inline __m256d _mm256_invsqrt_pd(__m256d x) noexcept { return _mm256_div_pd(_mm256_set1_pd(1.0), _mm256_sqrt_pd(x)); }
+
+    inline __m256d _mm256_log_pd(__m256d x) noexcept
+    {
+        return detail::map_lanes(m256d(x), [](double v) { return __fst::log(v); });
+    }
+
+    inline __m256d _mm256_log10_pd(__m256d x) noexcept
+    {
+        return detail::map_lanes(m256d(x), [](double v) { return __fst::log10(v); });
+    }
+
+    inline __m256d _mm256_log2_pd(__m256d x) noexcept
+    {
+        return detail::map_lanes(m256d(x), [](double v) { return __fst::log2(v); });
+    }
+
+    inline __m256d _mm256_exp10_pd(__m256d x) noexcept
+    {
+        return detail::map_lanes(m256d(x), [](double v) { return __fst::exp10(v); });
+    }
+
+    inline __m256d _mm256_exp2_pd(__m256d x) noexcept
+    {
+        return detail::map_lanes(m256d(x), [](double v) { return __fst::exp2(v); });
+    }
+
+    inline __m256d _mm256_pow_pd(__m256d x, __m256d y) noexcept
+    {
+        return detail::map_lanes(m256d(x), m256d(y), [](double a, double b) { return __fst::pow(a, b); });
+    }
+#endif // !FST_PLATFORM_HAS_SVML
+
+FST_END_SIMD_NAMESPACE
+
+#endif // FST_SIMD_256 || FST_SIMD_512
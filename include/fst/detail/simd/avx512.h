@@ -0,0 +1,303 @@
+#pragma once
+
+#include "fst/common.h"
+#include "fst/math.h"
+#include "fst/detail/simd/avx.h"
+
+#if FST_SIMD_512
+
+FST_BEGIN_SIMD_NAMESPACE
+
+    union m512
+    {
+        __m512 v; // AVX-512 16 x float vector
+        float a[16]; // scalar array of 16 floats
+
+        inline m512(__m512 vv) noexcept
+            : v(vv)
+        {}
+
+        inline float& operator[](size_t index) noexcept { return a[index]; }
+        inline float operator[](size_t index) const noexcept { return a[index]; }
+    };
+
+    union m512d
+    {
+        __m512d v; // AVX-512 8 x double vector
+        double a[8]; // scalar array of 8 doubles
+
+        inline m512d(__m512d vv) noexcept
+            : v(vv)
+        {}
+
+        inline double& operator[](size_t index) noexcept { return a[index]; }
+        inline double operator[](size_t index) const noexcept { return a[index]; }
+    };
+
+    //
+    // Masked load/store for the last incomplete vector.
+    //
+    inline __m512 _mm512_load_partial_ps(const float* ptr, size_t count) noexcept { return _mm512_maskz_loadu_ps((__mmask16) ((1u << count) - 1), ptr); }
+
+    inline void _mm512_store_partial_ps(float* dst, __m512 src, size_t count) noexcept { _mm512_mask_storeu_ps(dst, (__mmask16) ((1u << count) - 1), src); }
+
+    inline __m512d _mm512_load_partial_pd(const double* ptr, size_t count) noexcept { return _mm512_maskz_loadu_pd((__mmask8) ((1u << count) - 1), ptr); }
+
+    inline void _mm512_store_partial_pd(double* dst, __m512d src, size_t count) noexcept { _mm512_mask_storeu_pd(dst, (__mmask8) ((1u << count) - 1), src); }
+
+    //
+    // Horizontal operations.
+    //
+    inline float _mm512_hsum_ps(__m512 x) noexcept { return _mm512_reduce_add_ps(x); }
+
+    inline double _mm512_hsum_pd(__m512d x) noexcept { return _mm512_reduce_add_pd(x); }
+
+    FST_INLINE_VAR constexpr bool _mm512_fused_mul_add = true;
+
+    inline __m512 _mm512_mul_add_ps(__m512 a, __m512 b, __m512 c) noexcept { return _mm512_fmadd_ps(a, b, c); }
+
+    inline __m512d _mm512_mul_add_pd(__m512d a, __m512d b, __m512d c) noexcept { return _mm512_fmadd_pd(a, b, c); }
+
+    //
+    // Building blocks of the fst/simd_math.h kernels, see sse.h.
+    // _mm512_abs_ps and _mm512_abs_pd are native, comparisons return a __mmask.
+    //
+
+    inline __m512 _mm512_nearest_ps(__m512 x) noexcept { return _mm512_roundscale_ps(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+
+    inline __m512d _mm512_nearest_pd(__m512d x) noexcept { return _mm512_roundscale_pd(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+
+    inline __m512 _mm512_copysign_ps(__m512 x, __m512 s) noexcept
+    {
+        const __m512i sign_mask = _mm512_set1_epi32((int) 0x80000000);
+        return _mm512_castsi512_ps(
+            _mm512_or_si512(_mm512_andnot_si512(sign_mask, _mm512_castps_si512(x)), _mm512_and_si512(sign_mask, _mm512_castps_si512(s))));
+    }
+
+    inline __m512d _mm512_copysign_pd(__m512d x, __m512d s) noexcept
+    {
+        const __m512i sign_mask = _mm512_set1_epi64((long long) 0x8000000000000000ULL);
+        return _mm512_castsi512_pd(
+            _mm512_or_si512(_mm512_andnot_si512(sign_mask, _mm512_castpd_si512(x)), _mm512_and_si512(sign_mask, _mm512_castpd_si512(s))));
+    }
+
+    inline __m512 _mm512_pow2i_ps(__m512 n) noexcept { return _mm512_scalef_ps(_mm512_set1_ps(1.0f), n); }
+
+    inline __m512d _mm512_pow2i_pd(__m512d n) noexcept { return _mm512_scalef_pd(_mm512_set1_pd(1.0), n); }
+
+    inline __m512 _mm512_exponent_ps(__m512 x) noexcept { return _mm512_getexp_ps(x); }
+
+    inline __m512d _mm512_exponent_pd(__m512d x) noexcept { return _mm512_getexp_pd(x); }
+
+    inline __m512 _mm512_mantissa_ps(__m512 x) noexcept { return _mm512_getmant_ps(x, _MM_MANT_NORM_1_2, _MM_MANT_SIGN_zero); }
+
+    inline __m512d _mm512_mantissa_pd(__m512d x) noexcept { return _mm512_getmant_pd(x, _MM_MANT_NORM_1_2, _MM_MANT_SIGN_zero); }
+
+    inline __mmask16 _mm512_less_ps(__m512 a, __m512 b) noexcept { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+
+    inline __mmask8 _mm512_less_pd(__m512d a, __m512d b) noexcept { return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ); }
+
+    inline __mmask16 _mm512_less_equal_ps(__m512 a, __m512 b) noexcept { return _mm512_cmp_ps_mask(a, b, _CMP_LE_OQ); }
+
+    inline __mmask8 _mm512_less_equal_pd(__m512d a, __m512d b) noexcept { return _mm512_cmp_pd_mask(a, b, _CMP_LE_OQ); }
+
+    inline __mmask16 _mm512_equal_ps(__m512 a, __m512 b) noexcept { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+
+    inline __mmask8 _mm512_equal_pd(__m512d a, __m512d b) noexcept { return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ); }
+
+    inline __mmask16 _mm512_is_nan_ps(__m512 a) noexcept { return _mm512_cmp_ps_mask(a, a, _CMP_UNORD_Q); }
+
+    inline __mmask8 _mm512_is_nan_pd(__m512d a) noexcept { return _mm512_cmp_pd_mask(a, a, _CMP_UNORD_Q); }
+
+    inline __m512 _mm512_select_ps(__mmask16 mask, __m512 a, __m512 b) noexcept { return _mm512_mask_blend_ps(mask, b, a); }
+
+    inline __m512d _mm512_select_pd(__mmask8 mask, __m512d a, __m512d b) noexcept { return _mm512_mask_blend_pd(mask, b, a); }
+
+    inline __mmask16 _mm512_or_mask_ps(__mmask16 a, __mmask16 b) noexcept { return (__mmask16) (a | b); }
+
+    inline __mmask8 _mm512_or_mask_pd(__mmask8 a, __mmask8 b) noexcept { return (__mmask8) (a | b); }
+
+    inline __mmask16 _mm512_and_mask_ps(__mmask16 a, __mmask16 b) noexcept { return (__mmask16) (a & b); }
+
+    inline __mmask8 _mm512_and_mask_pd(__mmask8 a, __mmask8 b) noexcept { return (__mmask8) (a & b); }
+
+    // Same layout as _mm256_hadd_ps, [a0 + a1, a2 + a3, b0 + b1, b2 + b3] for each 128 bits lane.
+    inline __m512 _mm512_hadd_ps(__m512 a, __m512 b) noexcept
+    {
+        return _mm512_add_ps(_mm512_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)), _mm512_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+
+    // Same layout as _mm256_hadd_pd, [a0 + a1, b0 + b1] for each 128 bits lane.
+    inline __m512d _mm512_hadd_pd(__m512d a, __m512d b) noexcept { return _mm512_add_pd(_mm512_unpacklo_pd(a, b), _mm512_unpackhi_pd(a, b)); }
+
+    inline __m512 _mm512_fmod_ps(__m512 x, __m512 y) noexcept
+    {
+        return detail::map_lanes(m512(x), m512(y), [](float a, float b) { return __fst::fmod(a, b); });
+    }
+
+    inline __m512d _mm512_fmod_pd(__m512d x, __m512d y) noexcept
+    {
+        return detail::map_lanes(m512d(x), m512d(y), [](double a, double b) { return __fst::fmod(a, b); });
+    }
+
+#if !FST_PLATFORM_HAS_SVML
+    /*
+     * Same Cephes range reduction and polynomials as _mm256_sincos_ps in avx.h.
+     * Bitwise float operations go through the integer domain to only require AVX512F.
+     */
+    inline __m512 _mm512_sincos_ps(__m512 * c, __m512 x) noexcept
+    {
+        const __m512i sign_mask = _mm512_set1_epi32(to_int(0x80000000));
+
+        // Extract the sign bit and work with absolute values
+        __m512i xi = _mm512_castps_si512(x);
+        __m512i sin_signbit = _mm512_and_si512(xi, sign_mask);
+        x = _mm512_castsi512_ps(_mm512_andnot_si512(sign_mask, xi));
+
+        // Cephes method for scaling between 0 et pi/4
+        __m512 y = _mm512_mul_ps(x, _mm512_set1_ps(1.27323954473516f));
+        __m512i yi = _mm512_cvttps_epi32(y);
+        yi = _mm512_add_epi32(yi, _mm512_set1_epi32(1));
+        yi = _mm512_and_si512(yi, _mm512_set1_epi32(~1));
+        y = _mm512_cvtepi32_ps(yi);
+
+        // Cosine sign flag
+        __m512i cos_signbit = _mm512_sub_epi32(yi, _mm512_set1_epi32(2));
+        cos_signbit = _mm512_slli_epi32(_mm512_andnot_si512(cos_signbit, _mm512_set1_epi32(4)), 29);
+
+        // Sine swap sign flag
+        sin_signbit = _mm512_xor_si512(sin_signbit, _mm512_slli_epi32(_mm512_and_si512(yi, _mm512_set1_epi32(4)), 29));
+
+        // Polynom selection mask
+        const __mmask16 polymask = _mm512_cmpeq_epi32_mask(_mm512_and_si512(yi, _mm512_set1_epi32(2)), _mm512_setzero_si512());
+
+        // Extended precision modular arithmetic (Cody and Waite)
+        x = _mm512_sub_ps(x, _mm512_mul_ps(y, _mm512_set1_ps(0.78515625f)));
+        x = _mm512_sub_ps(x, _mm512_mul_ps(y, _mm512_set1_ps(2.4187564849853515625e-4f)));
+        x = _mm512_sub_ps(x, _mm512_mul_ps(y, _mm512_set1_ps(3.77489497744594108e-8f)));
+
+        // First polynom x \in [0, pi/4]
+        const __m512 z = _mm512_mul_ps(x, x);
+        y = _mm512_add_ps(_mm512_mul_ps(_mm512_set1_ps(2.443315711809948e-5f), z), _mm512_set1_ps(-1.388731625493765e-3f));
+        y = _mm512_add_ps(_mm512_mul_ps(y, z), _mm512_set1_ps(4.166664568298827e-2f));
+        y = _mm512_mul_ps(_mm512_mul_ps(y, z), z);
+        y = _mm512_sub_ps(y, _mm512_mul_ps(z, _mm512_set1_ps(0.5f)));
+        y = _mm512_add_ps(y, _mm512_set1_ps(1.0f));
+
+        // Second polynom
+        __m512 y2 = _mm512_add_ps(_mm512_mul_ps(_mm512_set1_ps(-1.9515295891e-4f), z), _mm512_set1_ps(8.3321608736e-3f));
+        y2 = _mm512_add_ps(_mm512_mul_ps(y2, z), _mm512_set1_ps(-1.6666654611e-1f));
+        y2 = _mm512_mul_ps(_mm512_mul_ps(y2, z), x);
+        y2 = _mm512_add_ps(y2, x);
+
+        // Select the correct result and update the sign
+        const __m512i ysin = _mm512_castps_si512(_mm512_mask_blend_ps(polymask, y, y2));
+        const __m512i ycos = _mm512_castps_si512(_mm512_mask_blend_ps(polymask, y2, y));
+
+        *c = _mm512_castsi512_ps(_mm512_xor_si512(ycos, cos_signbit));
+        return _mm512_castsi512_ps(_mm512_xor_si512(ysin, sin_signbit));
+    }
+
+    inline __m512 _mm512_sin_ps(__m512 x) noexcept
+    {
+        __m512 c;
+        return _mm512_sincos_ps(&c, x);
+    }
+
+    inline __m512 _mm512_cos_ps(__m512 x) noexcept
+    {
+        __m512 c;
+        _mm512_sincos_ps(&c, x);
+        return c;
+    }
+
+    inline __m512 _mm512_tan_ps(__m512 x) noexcept
+    {
+        __m512 c;
+        const __m512 s = _mm512_sincos_ps(&c, x);
+        return _mm512_div_ps(s, c);
+    }
+
+    inline __m512 _mm512_invsqrt_ps(__m512 x) noexcept { return _mm512_div_ps(_mm512_set1_ps(1.0f), _mm512_sqrt_ps(x)); }
+
+    inline __m512 _mm512_log_ps(__m512 x) noexcept
+    {
+        return detail::map_lanes(m512(x), [](float v) { return __fst::log(v); });
+    }
+
+    inline __m512 _mm512_log10_ps(__m512 x) noexcept
+    {
+        return detail::map_lanes(m512(x), [](float v) { return __fst::log10(v); });
+    }
+
+    inline __m512 _mm512_log2_ps(__m512 x) noexcept
+    {
+        return detail::map_lanes(m512(x), [](float v) { return __fst::log2(v); });
+    }
+
+    inline __m512 _mm512_exp10_ps(__m512 x) noexcept
+    {
+        return detail::map_lanes(m512(x), [](float v) { return __fst::exp10(v); });
+    }
+
+    inline __m512 _mm512_exp2_ps(__m512 x) noexcept
+    {
+        return detail::map_lanes(m512(x), [](float v) { return __fst::exp2(v); });
+    }
+
+    inline __m512 _mm512_pow_ps(__m512 x, __m512 y) noexcept
+    {
+        return detail::map_lanes(m512(x), m512(y), [](float a, float b) { return __fst::pow(a, b); });
+    }
+
+    inline __m512d _mm512_sin_pd(__m512d x) noexcept
+    {
+        return detail::map_lanes(m512d(x), [](double v) { return __fst::sin(v); });
+    }
+
+    inline __m512d _mm512_cos_pd(__m512d x) noexcept
+    {
+        return detail::map_lanes(m512d(x), [](double v) { return __fst::cos(v); });
+    }
+
+    inline __m512d _mm512_tan_pd(__m512d x) noexcept
+    {
+        return detail::map_lanes(m512d(x), [](double v) { return __fst::tan(v); });
+    }
+
+    inline __m512d _mm512_invsqrt_pd(__m512d x) noexcept { return _mm512_div_pd(_mm512_set1_pd(1.0), _mm512_sqrt_pd(x)); }
+
+    inline __m512d _mm512_log_pd(__m512d x) noexcept
+    {
+        return detail::map_lanes(m512d(x), [](double v) { return __fst::log(v); });
+    }
+
+    inline __m512d _mm512_log10_pd(__m512d x) noexcept
+    {
+        return detail::map_lanes(m512d(x), [](double v) { return __fst::log10(v); });
+    }
+
+    inline __m512d _mm512_log2_pd(__m512d x) noexcept
+    {
+        return detail::map_lanes(m512d(x), [](double v) { return __fst::log2(v); });
+    }
+
+    inline __m512d _mm512_exp10_pd(__m512d x) noexcept
+    {
+        return detail::map_lanes(m512d(x), [](double v) { return __fst::exp10(v); });
+    }
+
+    inline __m512d _mm512_exp2_pd(__m512d x) noexcept
+    {
+        return detail::map_lanes(m512d(x), [](double v) { return __fst::exp2(v); });
+    }
+
+    inline __m512d _mm512_pow_pd(__m512d x, __m512d y) noexcept
+    {
+        return detail::map_lanes(m512d(x), m512d(y), [](double a, double b) { return __fst::pow(a, b); });
+    }
+#endif // !FST_PLATFORM_HAS_SVML
+
+FST_END_SIMD_NAMESPACE
+
+#endif // FST_SIMD_512
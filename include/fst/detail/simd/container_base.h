@@ -18,7 +18,7 @@ namespace detail
         using const_iterator = typename data_base_type::const_iterator;
 
         using vector_type = __fst::simd::vector_type_t<value_type>;
-        using vector_op = __fst::simd::vector_op<vector_type, value_type>;
+        using vector_op = __fst::simd::vector_op<vector_type, __fst::remove_const_t<value_type>>;
 
         static constexpr size_t vector_alignment = alignof(vector_type);
         static constexpr size_t vector_size = sizeof(vector_type) / sizeof(value_type);
@@ -27,6 +27,7 @@ namespace detail
 
       private:
         using op = vector_op;
+        using scalar_type = __fst::remove_const_t<value_type>;
 
         template <class _TT, size_t _TSize, size_t _TAlign, class _TBase, class _TDerived, class _SBase, class _SDerived>
         static constexpr bool is_valid_range = __fst::is_convertible_v<_TT*, _T*> && !__fst::is_constructible_v<_SBase, _TBase>
@@ -328,21 +329,47 @@ namespace detail
         }
 
 //
-//
-//
-#define FST_SIMD_LOOP(...)                                                       \
-    if constexpr (_Size == __fst::dynamic_size)                                  \
-    {                                                                            \
-        for (size_type I = 0; I < size(); I += vector_size)                      \
-        {                                                                        \
-            __VA_ARGS__;                                                         \
-        }                                                                        \
-    }                                                                            \
-    else                                                                         \
-    {                                                                            \
-        static constexpr size_t loop_size = size() / vector_size;                \
-        __fst::unroll<loop_size, vector_size>([&]<size_t I>() { __VA_ARGS__; }); \
-    }                                                                            \
+// Runs the vector expression over every full vector, then once more with a
+// partial_vector_op for the remaining elements when the size isn't a multiple
+// of vector_size. Expressions must go through the `op` object.
+#define FST_SIMD_LOOP(...)                                                                      \
+    if constexpr (_Size == __fst::dynamic_size)                                                 \
+    {                                                                                           \
+        const size_type vsize = size() - (size() % vector_size);                                \
+        {                                                                                       \
+            constexpr vector_op op = {};                                                        \
+            for (size_type I = 0; I < vsize; I += vector_size)                                  \
+            {                                                                                   \
+                __VA_ARGS__;                                                                    \
+            }                                                                                   \
+        }                                                                                       \
+        if (const size_type I = vsize; I < size())                                              \
+        {                                                                                       \
+            const __fst::simd::partial_vector_op<vector_op> op = { {}, size() - I };            \
+            __VA_ARGS__;                                                                        \
+        }                                                                                       \
+    }                                                                                           \
+    else                                                                                        \
+    {                                                                                           \
+        static constexpr size_t loop_size = size() / vector_size;                               \
+        constexpr vector_op op = {};                                                            \
+        if constexpr (loop_size > 0 && loop_size <= 256 && __fst::is_power_of_two(loop_size))   \
+        {                                                                                       \
+            __fst::unroll<loop_size, vector_size>([&]<size_t I>() { __VA_ARGS__; });            \
+        }                                                                                       \
+        else                                                                                    \
+        {                                                                                       \
+            for (size_type I = 0; I < loop_size * vector_size; I += vector_size)                \
+            {                                                                                   \
+                __VA_ARGS__;                                                                    \
+            }                                                                                   \
+        }                                                                                       \
+        if constexpr (constexpr size_type I = loop_size * vector_size; I < size())              \
+        {                                                                                       \
+            const __fst::simd::partial_vector_op<vector_op> op = { {}, size() - I };            \
+            __VA_ARGS__;                                                                        \
+        }                                                                                       \
+    }                                                                                           \
     (void) 0
 
 #define FST_SIMD_SEQ_LOOP(__InSize, __InAlign, __InDerived, __InName, OP)                                               \
@@ -373,7 +400,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& clear() noexcept FST_UNIT_TESTED
         {
             const vector_type v = op::load_zero();
-            FST_SIMD_LOOP(op::store(data(I), v));
+            FST_SIMD_LOOP(op.store(data(I), v));
             return (derived_type&) *this;
         }
 
@@ -381,7 +408,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& fill(value_type value) noexcept FST_UNIT_TESTED
         {
             const vector_type v = op::load(value);
-            FST_SIMD_LOOP(op::store(data(I), v));
+            FST_SIMD_LOOP(op.store(data(I), v));
             return (derived_type&) *this;
         }
 
@@ -406,7 +433,7 @@ namespace detail
             static_assert(_AAlign >= vector_alignment, "wrong alignment");
             validate_size(a);
 
-            FST_SIMD_LOOP(op::store(data(I), op::load(a.data(I))));
+            FST_SIMD_LOOP(op.store(data(I), op.load(a.data(I))));
             return (derived_type&) *this;
         }
 
@@ -417,6 +444,55 @@ namespace detail
             return (derived_type&) *this;
         }
 
+        //
+        // Expressions, see fst/detail/simd/expression.h.
+        //
+
+        // data[i] = e[i]
+        template <class _Expr, __fst::enable_if_t<__fst::simd::is_expression<_Expr>::value, int> = 0>
+        FST_ALWAYS_INLINE derived_type& assign(const _Expr& e) noexcept FST_UNIT_TESTED
+        {
+            validate_expression(e);
+            FST_SIMD_LOOP(op.store(data(I), e.eval(op, I)));
+            return (derived_type&) *this;
+        }
+
+        // data[i] += e[i]
+        template <class _Expr, __fst::enable_if_t<__fst::simd::is_expression<_Expr>::value, int> = 0>
+        FST_ALWAYS_INLINE derived_type& operator+=(const _Expr& e) noexcept FST_UNIT_TESTED
+        {
+            validate_expression(e);
+            FST_SIMD_LOOP(op.store(data(I), op.add(op.load(data(I)), e.eval(op, I))));
+            return (derived_type&) *this;
+        }
+
+        // data[i] -= e[i]
+        template <class _Expr, __fst::enable_if_t<__fst::simd::is_expression<_Expr>::value, int> = 0>
+        FST_ALWAYS_INLINE derived_type& operator-=(const _Expr& e) noexcept FST_UNIT_TESTED
+        {
+            validate_expression(e);
+            FST_SIMD_LOOP(op.store(data(I), op.sub(op.load(data(I)), e.eval(op, I))));
+            return (derived_type&) *this;
+        }
+
+        // data[i] *= e[i]
+        template <class _Expr, __fst::enable_if_t<__fst::simd::is_expression<_Expr>::value, int> = 0>
+        FST_ALWAYS_INLINE derived_type& operator*=(const _Expr& e) noexcept FST_UNIT_TESTED
+        {
+            validate_expression(e);
+            FST_SIMD_LOOP(op.store(data(I), op.mul(op.load(data(I)), e.eval(op, I))));
+            return (derived_type&) *this;
+        }
+
+        // data[i] /= e[i]
+        template <class _Expr, __fst::enable_if_t<__fst::simd::is_expression<_Expr>::value, int> = 0>
+        FST_ALWAYS_INLINE derived_type& operator/=(const _Expr& e) noexcept FST_UNIT_TESTED
+        {
+            validate_expression(e);
+            FST_SIMD_LOOP(op.store(data(I), op.div(op.load(data(I)), e.eval(op, I))));
+            return (derived_type&) *this;
+        }
+
         //
         //
         //
@@ -425,7 +501,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& operator+=(value_type value) noexcept FST_UNIT_TESTED
         {
             const vector_type v = op::load(value);
-            FST_SIMD_LOOP(op::store(data(I), op::add(op::load(data(I)), v)));
+            FST_SIMD_LOOP(op.store(data(I), op.add(op.load(data(I)), v)));
             return (derived_type&) *this;
         }
 
@@ -433,7 +509,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& operator-=(value_type value) noexcept FST_UNIT_TESTED
         {
             const vector_type v = op::load(value);
-            FST_SIMD_LOOP(op::store(data(I), op::sub(op::load(data(I)), v)));
+            FST_SIMD_LOOP(op.store(data(I), op.sub(op.load(data(I)), v)));
             return (derived_type&) *this;
         }
 
@@ -441,7 +517,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& operator*=(value_type value) noexcept FST_UNIT_TESTED
         {
             const vector_type v = op::load(value);
-            FST_SIMD_LOOP(op::store(data(I), op::mul(op::load(data(I)), v)));
+            FST_SIMD_LOOP(op.store(data(I), op.mul(op.load(data(I)), v)));
             return (derived_type&) *this;
         }
 
@@ -449,7 +525,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& operator/=(value_type value) noexcept FST_UNIT_TESTED
         {
             const vector_type v = op::load(value);
-            FST_SIMD_LOOP(op::store(data(I), op::div(op::load(data(I)), v)));
+            FST_SIMD_LOOP(op.store(data(I), op.div(op.load(data(I)), v)));
             return (derived_type&) *this;
         }
 
@@ -464,7 +540,7 @@ namespace detail
             static_assert(_AAlign >= vector_alignment, "wrong alignment");
             validate_size(a);
 
-            FST_SIMD_LOOP(op::store(data(I), op::add(op::load(data(I)), op::load(a.data(I)))));
+            FST_SIMD_LOOP(op.store(data(I), op.add(op.load(data(I)), op.load(a.data(I)))));
             return (derived_type&) *this;
         }
 
@@ -475,7 +551,7 @@ namespace detail
             static_assert(_AAlign >= vector_alignment, "wrong alignment");
             validate_size(a);
 
-            FST_SIMD_LOOP(op::store(data(I), op::sub(op::load(data(I)), op::load(a.data(I)))));
+            FST_SIMD_LOOP(op.store(data(I), op.sub(op.load(data(I)), op.load(a.data(I)))));
             return (derived_type&) *this;
         }
 
@@ -486,7 +562,7 @@ namespace detail
             static_assert(_AAlign >= vector_alignment, "wrong alignment");
             validate_size(a);
 
-            FST_SIMD_LOOP(op::store(data(I), op::mul(op::load(data(I)), op::load(a.data(I)))));
+            FST_SIMD_LOOP(op.store(data(I), op.mul(op.load(data(I)), op.load(a.data(I)))));
             return (derived_type&) *this;
         }
 
@@ -497,7 +573,7 @@ namespace detail
             static_assert(_AAlign >= vector_alignment, "wrong alignment");
             validate_size(a);
 
-            FST_SIMD_LOOP(op::store(data(I), op::div(op::load(data(I)), op::load(a.data(I)))));
+            FST_SIMD_LOOP(op.store(data(I), op.div(op.load(data(I)), op.load(a.data(I)))));
             return (derived_type&) *this;
         }
 
@@ -532,7 +608,7 @@ namespace detail
             static_assert(_AAlign >= vector_alignment, "wrong alignment");
             validate_size(a);
 
-            FST_SIMD_LOOP(op::store(data(I), op::sub(op::load(a.data(I)), op::load(data(I)))));
+            FST_SIMD_LOOP(op.store(data(I), op.sub(op.load(a.data(I)), op.load(data(I)))));
             return (derived_type&) *this;
         }
 
@@ -540,7 +616,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& rsub(value_type a) noexcept FST_UNIT_TESTED
         {
             const vector_type avec = op::load(a);
-            FST_SIMD_LOOP(op::store(data(I), op::sub(avec, op::load(data(I)))));
+            FST_SIMD_LOOP(op.store(data(I), op.sub(avec, op.load(data(I)))));
             return (derived_type&) *this;
         }
 
@@ -571,7 +647,7 @@ namespace detail
             static_assert(_AAlign >= vector_alignment, "wrong alignment");
             validate_size(a);
 
-            FST_SIMD_LOOP(op::store(data(I), op::div(op::load(a.data(I)), op::load(data(I)))));
+            FST_SIMD_LOOP(op.store(data(I), op.div(op.load(a.data(I)), op.load(data(I)))));
             return (derived_type&) *this;
         }
 
@@ -579,7 +655,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& rdiv(value_type a) noexcept FST_UNIT_TESTED
         {
             const vector_type avec = op::load(a);
-            FST_SIMD_LOOP(op::store(data(I), op::div(avec, op::load(data(I)))));
+            FST_SIMD_LOOP(op.store(data(I), op.div(avec, op.load(data(I)))));
             return (derived_type&) *this;
         }
 
@@ -640,7 +716,7 @@ namespace detail
             static_assert(_BAlign >= vector_alignment, "wrong alignment");
             validate_size(b);
 
-            FST_SIMD_LOOP(op::store(data(I), op::add(op::load(data(I)), op::add(op::load(a.data(I)), op::load(b.data(I))))));
+            FST_SIMD_LOOP(op.store(data(I), op.add(op.load(data(I)), op.add(op.load(a.data(I)), op.load(b.data(I))))));
             return (derived_type&) *this;
         }
 
@@ -652,7 +728,7 @@ namespace detail
             validate_size(a);
 
             const vector_type bvec = op::load(b);
-            FST_SIMD_LOOP(op::store(data(I), op::add(op::load(data(I)), op::add(op::load(a.data(I)), bvec))));
+            FST_SIMD_LOOP(op.store(data(I), op.add(op.load(data(I)), op.add(op.load(a.data(I)), bvec))));
             return (derived_type&) *this;
         }
 
@@ -664,7 +740,7 @@ namespace detail
             validate_size(b);
 
             const vector_type avec = op::load(a);
-            FST_SIMD_LOOP(op::store(data(I), op::add(op::load(data(I)), op::add(avec, op::load(b.data(I))))));
+            FST_SIMD_LOOP(op.store(data(I), op.add(op.load(data(I)), op.add(avec, op.load(b.data(I))))));
             return (derived_type&) *this;
         }
 
@@ -679,7 +755,7 @@ namespace detail
             static_assert(_BAlign >= vector_alignment, "wrong alignment");
             validate_size(b);
 
-            FST_SIMD_LOOP(op::store(data(I), op::sub(op::load(data(I)), op::add(op::load(a.data(I)), op::load(b.data(I))))));
+            FST_SIMD_LOOP(op.store(data(I), op.sub(op.load(data(I)), op.add(op.load(a.data(I)), op.load(b.data(I))))));
             return (derived_type&) *this;
         }
 
@@ -691,7 +767,7 @@ namespace detail
             validate_size(a);
 
             const vector_type bvec = op::load(b);
-            FST_SIMD_LOOP(op::store(data(I), op::sub(op::load(data(I)), op::add(op::load(a.data(I)), bvec))));
+            FST_SIMD_LOOP(op.store(data(I), op.sub(op.load(data(I)), op.add(op.load(a.data(I)), bvec))));
             return (derived_type&) *this;
         }
 
@@ -706,7 +782,7 @@ namespace detail
             static_assert(_BAlign >= vector_alignment, "wrong alignment");
             validate_size(b);
 
-            FST_SIMD_LOOP(op::store(data(I), op::sub(op::add(op::load(a.data(I)), op::load(b.data(I))), op::load(data(I)))));
+            FST_SIMD_LOOP(op.store(data(I), op.sub(op.add(op.load(a.data(I)), op.load(b.data(I))), op.load(data(I)))));
             return (derived_type&) *this;
         }
 
@@ -718,7 +794,7 @@ namespace detail
             validate_size(a);
 
             const vector_type bvec = op::load(b);
-            FST_SIMD_LOOP(op::store(data(I), op::sub(op::add(op::load(a.data(I)), bvec), op::load(data(I)))));
+            FST_SIMD_LOOP(op.store(data(I), op.sub(op.add(op.load(a.data(I)), bvec), op.load(data(I)))));
             return (derived_type&) *this;
         }
 
@@ -730,7 +806,7 @@ namespace detail
             validate_size(b);
 
             const vector_type avec = op::load(a);
-            FST_SIMD_LOOP(op::store(data(I), op::sub(op::add(avec, op::load(b.data(I))), op::load(data(I)))));
+            FST_SIMD_LOOP(op.store(data(I), op.sub(op.add(avec, op.load(b.data(I))), op.load(data(I)))));
             return (derived_type&) *this;
         }
 
@@ -745,7 +821,7 @@ namespace detail
             static_assert(_BAlign >= vector_alignment, "wrong alignment");
             validate_size(b);
 
-            FST_SIMD_LOOP(op::store(data(I), op::mul(op::load(data(I)), op::add(op::load(a.data(I)), op::load(b.data(I))))));
+            FST_SIMD_LOOP(op.store(data(I), op.mul(op.load(data(I)), op.add(op.load(a.data(I)), op.load(b.data(I))))));
             return (derived_type&) *this;
         }
 
@@ -757,7 +833,7 @@ namespace detail
             validate_size(a);
 
             const vector_type bvec = op::load(b);
-            FST_SIMD_LOOP(op::store(data(I), op::mul(op::load(data(I)), op::add(op::load(a.data(I)), bvec))));
+            FST_SIMD_LOOP(op.store(data(I), op.mul(op.load(data(I)), op.add(op.load(a.data(I)), bvec))));
             return (derived_type&) *this;
         }
 
@@ -772,7 +848,7 @@ namespace detail
             static_assert(_BAlign >= vector_alignment, "wrong alignment");
             validate_size(b);
 
-            FST_SIMD_LOOP(op::store(data(I), op::div(op::load(data(I)), op::add(op::load(a.data(I)), op::load(b.data(I))))));
+            FST_SIMD_LOOP(op.store(data(I), op.div(op.load(data(I)), op.add(op.load(a.data(I)), op.load(b.data(I))))));
             return (derived_type&) *this;
         }
 
@@ -784,7 +860,7 @@ namespace detail
             validate_size(a);
 
             const vector_type bvec = op::load(b);
-            FST_SIMD_LOOP(op::store(data(I), op::div(op::load(data(I)), op::add(op::load(a.data(I)), bvec))));
+            FST_SIMD_LOOP(op.store(data(I), op.div(op.load(data(I)), op.add(op.load(a.data(I)), bvec))));
             return (derived_type&) *this;
         }
 
@@ -803,7 +879,7 @@ namespace detail
             static_assert(_BAlign >= vector_alignment, "wrong alignment");
             validate_size(b);
 
-            FST_SIMD_LOOP(op::store(data(I), op::add(op::load(data(I)), op::sub(op::load(a.data(I)), op::load(b.data(I))))));
+            FST_SIMD_LOOP(op.store(data(I), op.add(op.load(data(I)), op.sub(op.load(a.data(I)), op.load(b.data(I))))));
             return (derived_type&) *this;
         }
 
@@ -815,7 +891,7 @@ namespace detail
             validate_size(a);
 
             const vector_type bvec = op::load(b);
-            FST_SIMD_LOOP(op::store(data(I), op::add(op::load(data(I)), op::sub(op::load(a.data(I)), bvec))));
+            FST_SIMD_LOOP(op.store(data(I), op.add(op.load(data(I)), op.sub(op.load(a.data(I)), bvec))));
             return (derived_type&) *this;
         }
 
@@ -830,7 +906,7 @@ namespace detail
             static_assert(_BAlign >= vector_alignment, "wrong alignment");
             validate_size(b);
 
-            FST_SIMD_LOOP(op::store(data(I), op::sub(op::load(data(I)), op::sub(op::load(a.data(I)), op::load(b.data(I))))));
+            FST_SIMD_LOOP(op.store(data(I), op.sub(op.load(data(I)), op.sub(op.load(a.data(I)), op.load(b.data(I))))));
             return (derived_type&) *this;
         }
 
@@ -842,7 +918,7 @@ namespace detail
             validate_size(a);
 
             const vector_type bvec = op::load(b);
-            FST_SIMD_LOOP(op::store(data(I), op::sub(op::load(data(I)), op::sub(op::load(a.data(I)), bvec))));
+            FST_SIMD_LOOP(op.store(data(I), op.sub(op.load(data(I)), op.sub(op.load(a.data(I)), bvec))));
             return (derived_type&) *this;
         }
 
@@ -854,7 +930,7 @@ namespace detail
             static_assert(_AAlign >= vector_alignment, "wrong alignment");
             validate_size(a);
 
-            FST_SIMD_LOOP(op::store(data(I), op::mul(op::load(data(I)), op::sub(op::load(a.data(I)), op::load(b.data(I))))));
+            FST_SIMD_LOOP(op.store(data(I), op.mul(op.load(data(I)), op.sub(op.load(a.data(I)), op.load(b.data(I))))));
             return (derived_type&) *this;
         }
 
@@ -866,7 +942,7 @@ namespace detail
             validate_size(a);
 
             const vector_type bvec = op::load(b);
-            FST_SIMD_LOOP(op::store(data(I), op::mul(op::load(data(I)), op::sub(op::load(a.data(I)), bvec))));
+            FST_SIMD_LOOP(op.store(data(I), op.mul(op.load(data(I)), op.sub(op.load(a.data(I)), bvec))));
             return (derived_type&) *this;
         }
 
@@ -875,7 +951,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& div_sub(
             const container_base<_AT, _ASize, _AAlign, _ABase, _ADerived>& a, const container_base<_BT, _BSize, _BAlign, _BBase, _BDerived>& b) noexcept
         {
-            FST_SIMD_LOOP(op::store(data(I), op::div(op::load(data(I)), op::sub(op::load(a.data(I)), op::load(b.data(I))))));
+            FST_SIMD_LOOP(op.store(data(I), op.div(op.load(data(I)), op.sub(op.load(a.data(I)), op.load(b.data(I))))));
             return (derived_type&) *this;
         }
 
@@ -884,7 +960,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& div_sub(const container_base<_AT, _ASize, _AAlign, _ABase, _ADerived>& a, value_type b) noexcept
         {
             const vector_type bvec = op::load(b);
-            FST_SIMD_LOOP(op::store(data(I), op::div(op::load(data(I)), op::sub(op::load(a.data(I)), bvec))));
+            FST_SIMD_LOOP(op.store(data(I), op.div(op.load(data(I)), op.sub(op.load(a.data(I)), bvec))));
             return (derived_type&) *this;
         }
 
@@ -897,7 +973,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& add_mul(
             const container_base<_AT, _ASize, _AAlign, _ABase, _ADerived>& a, const container_base<_BT, _BSize, _BAlign, _BBase, _BDerived>& b) noexcept
         {
-            FST_SIMD_LOOP(op::store(data(I), op::add(op::load(data(I)), op::mul(op::load(a.data(I)), op::load(b.data(I))))));
+            FST_SIMD_LOOP(op.store(data(I), op.mul_add(op.load(a.data(I)), op.load(b.data(I)), op.load(data(I)))));
             return (derived_type&) *this;
         }
 
@@ -906,7 +982,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& add_mul(const container_base<_AT, _ASize, _AAlign, _ABase, _ADerived>& a, value_type b) noexcept
         {
             const vector_type bvec = op::load(b);
-            FST_SIMD_LOOP(op::store(data(I), op::add(op::load(data(I)), op::mul(op::load(a.data(I)), bvec))));
+            FST_SIMD_LOOP(op.store(data(I), op.mul_add(op.load(a.data(I)), bvec, op.load(data(I)))));
             return (derived_type&) *this;
         }
 
@@ -915,7 +991,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& sub_mul(
             const container_base<_AT, _ASize, _AAlign, _ABase, _ADerived>& a, const container_base<_BT, _BSize, _BAlign, _BBase, _BDerived>& b) noexcept
         {
-            FST_SIMD_LOOP(op::store(data(I), op::sub(op::load(data(I)), op::mul(op::load(a.data(I)), op::load(b.data(I))))));
+            FST_SIMD_LOOP(op.store(data(I), op.sub(op.load(data(I)), op.mul(op.load(a.data(I)), op.load(b.data(I))))));
             return (derived_type&) *this;
         }
 
@@ -924,7 +1000,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& sub_mul(const container_base<_AT, _ASize, _AAlign, _ABase, _ADerived>& a, value_type b) noexcept
         {
             const vector_type bvec = op::load(b);
-            FST_SIMD_LOOP(op::store(data(I), op::sub(op::load(data(I)), op::mul(op::load(a.data(I)), bvec))));
+            FST_SIMD_LOOP(op.store(data(I), op.sub(op.load(data(I)), op.mul(op.load(a.data(I)), bvec))));
             return (derived_type&) *this;
         }
 
@@ -933,7 +1009,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& mul_mul(
             const container_base<_AT, _ASize, _AAlign, _ABase, _ADerived>& a, const container_base<_BT, _BSize, _BAlign, _BBase, _BDerived>& b) noexcept
         {
-            FST_SIMD_LOOP(op::store(data(I), op::mul(op::load(data(I)), op::mul(op::load(a.data(I)), op::load(b.data(I))))));
+            FST_SIMD_LOOP(op.store(data(I), op.mul(op.load(data(I)), op.mul(op.load(a.data(I)), op.load(b.data(I))))));
             return (derived_type&) *this;
         }
 
@@ -942,7 +1018,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& mul_mul(const container_base<_AT, _ASize, _AAlign, _ABase, _ADerived>& a, value_type b) noexcept
         {
             const vector_type bvec = op::load(b);
-            FST_SIMD_LOOP(op::store(data(I), op::mul(op::load(data(I)), op::mul(op::load(a.data(I)), bvec))));
+            FST_SIMD_LOOP(op.store(data(I), op.mul(op.load(data(I)), op.mul(op.load(a.data(I)), bvec))));
             return (derived_type&) *this;
         }
 
@@ -951,7 +1027,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& div_mul(
             const container_base<_AT, _ASize, _AAlign, _ABase, _ADerived>& a, const container_base<_BT, _BSize, _BAlign, _BBase, _BDerived>& b) noexcept
         {
-            FST_SIMD_LOOP(op::store(data(I), op::div(op::load(data(I)), op::mul(op::load(a.data(I)), op::load(b.data(I))))));
+            FST_SIMD_LOOP(op.store(data(I), op.div(op.load(data(I)), op.mul(op.load(a.data(I)), op.load(b.data(I))))));
             return (derived_type&) *this;
         }
 
@@ -960,7 +1036,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& div_mul(const container_base<_AT, _ASize, _AAlign, _ABase, _ADerived>& a, value_type b) noexcept
         {
             const vector_type bvec = op::load(b);
-            FST_SIMD_LOOP(op::store(data(I), op::div(op::load(data(I)), op::mul(op::load(a.data(I)), bvec))));
+            FST_SIMD_LOOP(op.store(data(I), op.div(op.load(data(I)), op.mul(op.load(a.data(I)), bvec))));
             return (derived_type&) *this;
         }
 
@@ -973,7 +1049,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& add_div(
             const container_base<_AT, _ASize, _AAlign, _ABase, _ADerived>& a, const container_base<_BT, _BSize, _BAlign, _BBase, _BDerived>& b) noexcept
         {
-            FST_SIMD_LOOP(op::store(data(I), op::add(op::load(data(I)), op::div(op::load(a.data(I)), op::load(b.data(I))))));
+            FST_SIMD_LOOP(op.store(data(I), op.add(op.load(data(I)), op.div(op.load(a.data(I)), op.load(b.data(I))))));
             return (derived_type&) *this;
         }
 
@@ -982,7 +1058,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& add_div(const container_base<_AT, _ASize, _AAlign, _ABase, _ADerived>& a, value_type b) noexcept
         {
             const vector_type bvec = op::load(b);
-            FST_SIMD_LOOP(op::store(data(I), op::add(op::load(data(I)), op::div(op::load(a.data(I)), bvec))));
+            FST_SIMD_LOOP(op.store(data(I), op.add(op.load(data(I)), op.div(op.load(a.data(I)), bvec))));
             return (derived_type&) *this;
         }
 
@@ -991,7 +1067,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& sub_div(
             const container_base<_AT, _ASize, _AAlign, _ABase, _ADerived>& a, const container_base<_BT, _BSize, _BAlign, _BBase, _BDerived>& b) noexcept
         {
-            FST_SIMD_LOOP(op::store(data(I), op::sub(op::load(data(I)), op::div(op::load(a.data(I)), op::load(b.data(I))))));
+            FST_SIMD_LOOP(op.store(data(I), op.sub(op.load(data(I)), op.div(op.load(a.data(I)), op.load(b.data(I))))));
             return (derived_type&) *this;
         }
 
@@ -1000,7 +1076,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& sub_div(const container_base<_AT, _ASize, _AAlign, _ABase, _ADerived>& a, value_type b) noexcept
         {
             const vector_type bvec = op::load(b);
-            FST_SIMD_LOOP(op::store(data(I), op::sub(op::load(data(I)), op::div(op::load(a.data(I)), bvec))));
+            FST_SIMD_LOOP(op.store(data(I), op.sub(op.load(data(I)), op.div(op.load(a.data(I)), bvec))));
             return (derived_type&) *this;
         }
 
@@ -1009,7 +1085,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& mul_div(
             const container_base<_AT, _ASize, _AAlign, _ABase, _ADerived>& a, const container_base<_BT, _BSize, _BAlign, _BBase, _BDerived>& b) noexcept
         {
-            FST_SIMD_LOOP(op::store(data(I), op::mul(op::load(data(I)), op::div(op::load(a.data(I)), op::load(b.data(I))))));
+            FST_SIMD_LOOP(op.store(data(I), op.mul(op.load(data(I)), op.div(op.load(a.data(I)), op.load(b.data(I))))));
             return (derived_type&) *this;
         }
 
@@ -1018,7 +1094,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& mul_div(const container_base<_AT, _ASize, _AAlign, _ABase, _ADerived>& a, value_type b) noexcept
         {
             const vector_type bvec = op::load(b);
-            FST_SIMD_LOOP(op::store(data(I), op::mul(op::load(data(I)), op::div(op::load(a.data(I)), bvec))));
+            FST_SIMD_LOOP(op.store(data(I), op.mul(op.load(data(I)), op.div(op.load(a.data(I)), bvec))));
             return (derived_type&) *this;
         }
 
@@ -1027,7 +1103,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& div_div(
             const container_base<_AT, _ASize, _AAlign, _ABase, _ADerived>& a, const container_base<_BT, _BSize, _BAlign, _BBase, _BDerived>& b) noexcept
         {
-            FST_SIMD_LOOP(op::store(data(I), op::div(op::load(data(I)), op::div(op::load(a.data(I)), op::load(b.data(I))))));
+            FST_SIMD_LOOP(op.store(data(I), op.div(op.load(data(I)), op.div(op.load(a.data(I)), op.load(b.data(I))))));
             return (derived_type&) *this;
         }
 
@@ -1036,7 +1112,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& div_div(const container_base<_AT, _ASize, _AAlign, _ABase, _ADerived>& a, value_type b) noexcept
         {
             const vector_type bvec = op::load(b);
-            FST_SIMD_LOOP(op::store(data(I), op::div(op::load(data(I)), op::div(op::load(a.data(I)), bvec))));
+            FST_SIMD_LOOP(op.store(data(I), op.div(op.load(data(I)), op.div(op.load(a.data(I)), bvec))));
             return (derived_type&) *this;
         }
 
@@ -1049,7 +1125,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& assign_sum(
             const container_base<_AT, _ASize, _AAlign, _ABase, _ADerived>& a, const container_base<_BT, _BSize, _BAlign, _BBase, _BDerived>& b) noexcept
         {
-            FST_SIMD_LOOP(op::store(data(I), op::add(op::load(a.data(I)), op::load(b.data(I)))));
+            FST_SIMD_LOOP(op.store(data(I), op.add(op.load(a.data(I)), op.load(b.data(I)))));
             return (derived_type&) *this;
         }
 
@@ -1058,7 +1134,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& assign_sum(const container_base<_AT, _ASize, _AAlign, _ABase, _ADerived>& a, value_type b) noexcept
         {
             const vector_type bvec = op::load(b);
-            FST_SIMD_LOOP(op::store(data(I), op::add(op::load(a.data(I)), bvec)));
+            FST_SIMD_LOOP(op.store(data(I), op.add(op.load(a.data(I)), bvec)));
             return (derived_type&) *this;
         }
 
@@ -1067,7 +1143,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& assign_sub(
             const container_base<_AT, _ASize, _AAlign, _ABase, _ADerived>& a, const container_base<_BT, _BSize, _BAlign, _BBase, _BDerived>& b) noexcept
         {
-            FST_SIMD_LOOP(op::store(data(I), op::sub(op::load(a.data(I)), op::load(b.data(I)))));
+            FST_SIMD_LOOP(op.store(data(I), op.sub(op.load(a.data(I)), op.load(b.data(I)))));
             return (derived_type&) *this;
         }
 
@@ -1076,7 +1152,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& assign_sub(const container_base<_AT, _ASize, _AAlign, _ABase, _ADerived>& a, value_type b) noexcept
         {
             const vector_type bvec = op::load(b);
-            FST_SIMD_LOOP(op::store(data(I), op::sub(op::load(a.data(I)), bvec)));
+            FST_SIMD_LOOP(op.store(data(I), op.sub(op.load(a.data(I)), bvec)));
             return (derived_type&) *this;
         }
 
@@ -1085,7 +1161,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& assign_mul(
             const container_base<_AT, _ASize, _AAlign, _ABase, _ADerived>& a, const container_base<_BT, _BSize, _BAlign, _BBase, _BDerived>& b) noexcept
         {
-            FST_SIMD_LOOP(op::store(data(I), op::mul(op::load(a.data(I)), op::load(b.data(I)))));
+            FST_SIMD_LOOP(op.store(data(I), op.mul(op.load(a.data(I)), op.load(b.data(I)))));
             return (derived_type&) *this;
         }
 
@@ -1094,7 +1170,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& assign_mul(const container_base<_AT, _ASize, _AAlign, _ABase, _ADerived>& a, value_type b) noexcept
         {
             const vector_type bvec = op::load(b);
-            FST_SIMD_LOOP(op::store(data(I), op::mul(op::load(a.data(I)), bvec)));
+            FST_SIMD_LOOP(op.store(data(I), op.mul(op.load(a.data(I)), bvec)));
             return (derived_type&) *this;
         }
 
@@ -1103,7 +1179,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& assign_div(
             const container_base<_AT, _ASize, _AAlign, _ABase, _ADerived>& a, const container_base<_BT, _BSize, _BAlign, _BBase, _BDerived>& b) noexcept
         {
-            FST_SIMD_LOOP(op::store(data(I), op::div(op::load(a.data(I)), op::load(b.data(I)))));
+            FST_SIMD_LOOP(op.store(data(I), op.div(op.load(a.data(I)), op.load(b.data(I)))));
             return (derived_type&) *this;
         }
 
@@ -1112,7 +1188,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& assign_div(const container_base<_AT, _ASize, _AAlign, _ABase, _ADerived>& a, value_type b) noexcept
         {
             const vector_type bvec = op::load(b);
-            FST_SIMD_LOOP(op::store(data(I), op::div(op::load(a.data(I)), bvec)));
+            FST_SIMD_LOOP(op.store(data(I), op.div(op.load(a.data(I)), bvec)));
             return (derived_type&) *this;
         }
 
@@ -1123,7 +1199,7 @@ namespace detail
         // data[i] = sin(data[i])
         FST_ALWAYS_INLINE derived_type& sin() noexcept
         {
-            FST_SIMD_LOOP(op::store(data(I), op::sin(op::load(data(I)))));
+            FST_SIMD_LOOP(op.store(data(I), op.sin(op.load(data(I)))));
             return (derived_type&) *this;
         }
 
@@ -1131,21 +1207,21 @@ namespace detail
         template <class _AT, size_t _ASize, size_t _AAlign, class _ABase, class _ADerived>
         FST_ALWAYS_INLINE derived_type& sin(const container_base<_AT, _ASize, _AAlign, _ABase, _ADerived>& a) noexcept
         {
-            FST_SIMD_LOOP(op::store(data(I), op::sin(op::load(a.data(I)))));
+            FST_SIMD_LOOP(op.store(data(I), op.sin(op.load(a.data(I)))));
             return (derived_type&) *this;
         }
 
         // data[i] = cos(data[i])
         FST_ALWAYS_INLINE derived_type& cos() noexcept
         {
-            FST_SIMD_LOOP(op::store(data(I), op::cos(op::load(data(I)))));
+            FST_SIMD_LOOP(op.store(data(I), op.cos(op.load(data(I)))));
             return (derived_type&) *this;
         }
 
         // data[i] = tan(data[i])
         FST_ALWAYS_INLINE derived_type& tan() noexcept
         {
-            FST_SIMD_LOOP(op::store(data(I), op::tan(op::load(data(I)))));
+            FST_SIMD_LOOP(op.store(data(I), op.tan(op.load(data(I)))));
             return (derived_type&) *this;
         }
 
@@ -1158,7 +1234,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& add_then_mul(
             const container_base<_AT, _ASize, _AAlign, _ABase, _ADerived>& a, const container_base<_BT, _BSize, _BAlign, _BBase, _BDerived>& b) noexcept
         {
-            FST_SIMD_LOOP(op::store(data(I), op::mul(op::load(b.data(I)), op::add(op::load(a.data(I)), op::load(data(I))))));
+            FST_SIMD_LOOP(op.store(data(I), op.mul(op.load(b.data(I)), op.add(op.load(a.data(I)), op.load(data(I))))));
             return (derived_type&) *this;
         }
 
@@ -1167,7 +1243,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& add_then_mul(const container_base<_AT, _ASize, _AAlign, _ABase, _ADerived>& a, value_type b) noexcept
         {
             const vector_type bvec = op::load(b);
-            FST_SIMD_LOOP(op::store(data(I), op::mul(bvec, op::add(op::load(a.data(I)), op::load(data(I))))));
+            FST_SIMD_LOOP(op.store(data(I), op.mul(bvec, op.add(op.load(a.data(I)), op.load(data(I))))));
             return (derived_type&) *this;
         }
 
@@ -1176,7 +1252,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& add_then_mul(value_type a, const container_base<_BT, _BSize, _BAlign, _BBase, _BDerived>& b) noexcept
         {
             const vector_type avec = op::load(a);
-            FST_SIMD_LOOP(op::store(data(I), op::mul(op::load(b.data(I)), op::add(avec, op::load(data(I))))));
+            FST_SIMD_LOOP(op.store(data(I), op.mul(op.load(b.data(I)), op.add(avec, op.load(data(I))))));
             return (derived_type&) *this;
         }
 
@@ -1185,7 +1261,7 @@ namespace detail
         {
             const vector_type avec = op::load(a);
             const vector_type bvec = op::load(b);
-            FST_SIMD_LOOP(op::store(data(I), op::mul(bvec, op::add(avec, op::load(data(I))))));
+            FST_SIMD_LOOP(op.store(data(I), op.mul(bvec, op.add(avec, op.load(data(I))))));
             return (derived_type&) *this;
         }
 
@@ -1198,7 +1274,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& sub_then_mul(
             const container_base<_AT, _ASize, _AAlign, _ABase, _ADerived>& a, const container_base<_BT, _BSize, _BAlign, _BBase, _BDerived>& b) noexcept
         {
-            FST_SIMD_LOOP(op::store(data(I), op::mul(op::load(b.data(I)), op::sub(op::load(data(I)), op::load(a.data(I))))));
+            FST_SIMD_LOOP(op.store(data(I), op.mul(op.load(b.data(I)), op.sub(op.load(data(I)), op.load(a.data(I))))));
             return (derived_type&) *this;
         }
 
@@ -1207,7 +1283,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& sub_then_mul(const container_base<_AT, _ASize, _AAlign, _ABase, _ADerived>& a, value_type b) noexcept
         {
             const vector_type bvec = op::load(b);
-            FST_SIMD_LOOP(op::store(data(I), op::mul(bvec, op::sub(op::load(data(I)), op::load(a.data(I))))));
+            FST_SIMD_LOOP(op.store(data(I), op.mul(bvec, op.sub(op.load(data(I)), op.load(a.data(I))))));
             return (derived_type&) *this;
         }
 
@@ -1216,7 +1292,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& sub_then_mul(value_type a, const container_base<_BT, _BSize, _BAlign, _BBase, _BDerived>& b) noexcept
         {
             const vector_type avec = op::load(a);
-            FST_SIMD_LOOP(op::store(data(I), op::mul(op::load(b.data(I)), op::sub(op::load(data(I)), avec))));
+            FST_SIMD_LOOP(op.store(data(I), op.mul(op.load(b.data(I)), op.sub(op.load(data(I)), avec))));
             return (derived_type&) *this;
         }
 
@@ -1225,7 +1301,7 @@ namespace detail
         {
             const vector_type avec = op::load(a);
             const vector_type bvec = op::load(b);
-            FST_SIMD_LOOP(op::store(data(I), op::mul(bvec, op::sub(op::load(data(I)), avec))));
+            FST_SIMD_LOOP(op.store(data(I), op.mul(bvec, op.sub(op.load(data(I)), avec))));
             return (derived_type&) *this;
         }
 
@@ -1238,7 +1314,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& rsub_then_mul(
             const container_base<_AT, _ASize, _AAlign, _ABase, _ADerived>& a, const container_base<_BT, _BSize, _BAlign, _BBase, _BDerived>& b) noexcept
         {
-            FST_SIMD_LOOP(op::store(data(I), op::mul(op::load(b.data(I)), op::sub(op::load(a.data(I)), op::load(data(I))))));
+            FST_SIMD_LOOP(op.store(data(I), op.mul(op.load(b.data(I)), op.sub(op.load(a.data(I)), op.load(data(I))))));
             return (derived_type&) *this;
         }
 
@@ -1247,7 +1323,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& rsub_then_mul(const container_base<_AT, _ASize, _AAlign, _ABase, _ADerived>& a, value_type b) noexcept
         {
             const vector_type bvec = op::load(b);
-            FST_SIMD_LOOP(op::store(data(I), op::mul(bvec, op::sub(op::load(a.data(I)), op::load(data(I))))));
+            FST_SIMD_LOOP(op.store(data(I), op.mul(bvec, op.sub(op.load(a.data(I)), op.load(data(I))))));
             return (derived_type&) *this;
         }
 
@@ -1256,7 +1332,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& rsub_then_mul(value_type a, const container_base<_BT, _BSize, _BAlign, _BBase, _BDerived>& b) noexcept
         {
             const vector_type avec = op::load(a);
-            FST_SIMD_LOOP(op::store(data(I), op::mul(op::load(b.data(I)), op::sub(avec, op::load(data(I))))));
+            FST_SIMD_LOOP(op.store(data(I), op.mul(op.load(b.data(I)), op.sub(avec, op.load(data(I))))));
             return (derived_type&) *this;
         }
 
@@ -1265,7 +1341,7 @@ namespace detail
         {
             const vector_type avec = op::load(a);
             const vector_type bvec = op::load(b);
-            FST_SIMD_LOOP(op::store(data(I), op::mul(bvec, op::sub(avec, op::load(data(I))))));
+            FST_SIMD_LOOP(op.store(data(I), op.mul(bvec, op.sub(avec, op.load(data(I))))));
             return (derived_type&) *this;
         }
 
@@ -1278,7 +1354,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& mul_then_sum(
             const container_base<_AT, _ASize, _AAlign, _ABase, _ADerived>& a, const container_base<_BT, _BSize, _BAlign, _BBase, _BDerived>& b) noexcept
         {
-            FST_SIMD_LOOP(op::store(data(I), op::add(op::load(b.data(I)), op::mul(op::load(data(I)), op::load(a.data(I))))));
+            FST_SIMD_LOOP(op.store(data(I), op.mul_add(op.load(data(I)), op.load(a.data(I)), op.load(b.data(I)))));
             return (derived_type&) *this;
         }
 
@@ -1287,7 +1363,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& mul_then_sum(const container_base<_AT, _ASize, _AAlign, _ABase, _ADerived>& a, value_type b) noexcept
         {
             const vector_type bvec = op::load(b);
-            FST_SIMD_LOOP(op::store(data(I), op::add(bvec, op::mul(op::load(data(I)), op::load(a.data(I))))));
+            FST_SIMD_LOOP(op.store(data(I), op.mul_add(op.load(data(I)), op.load(a.data(I)), bvec)));
             return (derived_type&) *this;
         }
 
@@ -1296,7 +1372,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& mul_then_sum(value_type a, const container_base<_BT, _BSize, _BAlign, _BBase, _BDerived>& b) noexcept
         {
             const vector_type avec = op::load(a);
-            FST_SIMD_LOOP(op::store(data(I), op::add(op::load(b.data(I)), op::mul(op::load(data(I)), avec))));
+            FST_SIMD_LOOP(op.store(data(I), op.mul_add(op.load(data(I)), avec, op.load(b.data(I)))));
             return (derived_type&) *this;
         }
 
@@ -1305,7 +1381,7 @@ namespace detail
         {
             const vector_type avec = op::load(a);
             const vector_type bvec = op::load(b);
-            FST_SIMD_LOOP(op::store(data(I), op::add(bvec, op::mul(op::load(data(I)), avec))));
+            FST_SIMD_LOOP(op.store(data(I), op.mul_add(op.load(data(I)), avec, bvec)));
             return (derived_type&) *this;
         }
 
@@ -1318,7 +1394,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& mul_then_sub(
             const container_base<_AT, _ASize, _AAlign, _ABase, _ADerived>& a, const container_base<_BT, _BSize, _BAlign, _BBase, _BDerived>& b) noexcept
         {
-            FST_SIMD_LOOP(op::store(data(I), op::sub(op::mul(op::load(data(I)), op::load(a.data(I))), op::load(b.data(I)))));
+            FST_SIMD_LOOP(op.store(data(I), op.sub(op.mul(op.load(data(I)), op.load(a.data(I))), op.load(b.data(I)))));
             return (derived_type&) *this;
         }
 
@@ -1327,7 +1403,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& mul_then_sub(const container_base<_AT, _ASize, _AAlign, _ABase, _ADerived>& a, value_type b) noexcept
         {
             const vector_type bvec = op::load(b);
-            FST_SIMD_LOOP(op::store(data(I), op::sub(op::mul(op::load(data(I)), op::load(a.data(I))), bvec)));
+            FST_SIMD_LOOP(op.store(data(I), op.sub(op.mul(op.load(data(I)), op.load(a.data(I))), bvec)));
             return (derived_type&) *this;
         }
 
@@ -1336,7 +1412,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& mul_then_sub(value_type a, const container_base<_BT, _BSize, _BAlign, _BBase, _BDerived>& b) noexcept
         {
             const vector_type avec = op::load(a);
-            FST_SIMD_LOOP(op::store(data(I), op::sub(op::mul(op::load(data(I)), avec), op::load(b.data(I)))));
+            FST_SIMD_LOOP(op.store(data(I), op.sub(op.mul(op.load(data(I)), avec), op.load(b.data(I)))));
             return (derived_type&) *this;
         }
 
@@ -1345,7 +1421,7 @@ namespace detail
         {
             const vector_type avec = op::load(a);
             const vector_type bvec = op::load(b);
-            FST_SIMD_LOOP(op::store(data(I), op::sub(op::mul(op::load(data(I)), avec), bvec)));
+            FST_SIMD_LOOP(op.store(data(I), op.sub(op.mul(op.load(data(I)), avec), bvec)));
             return (derived_type&) *this;
         }
 
@@ -1358,7 +1434,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& add_then_div(
             const container_base<_AT, _ASize, _AAlign, _ABase, _ADerived>& a, const container_base<_BT, _BSize, _BAlign, _BBase, _BDerived>& b) noexcept
         {
-            FST_SIMD_LOOP(op::store(data(I), op::div(op::add(op::load(data(I)), op::load(a.data(I))), op::load(b.data(I)))));
+            FST_SIMD_LOOP(op.store(data(I), op.div(op.add(op.load(data(I)), op.load(a.data(I))), op.load(b.data(I)))));
             return (derived_type&) *this;
         }
 
@@ -1367,7 +1443,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& add_then_div(const container_base<_AT, _ASize, _AAlign, _ABase, _ADerived>& a, value_type b) noexcept
         {
             const vector_type bvec = op::load(b);
-            FST_SIMD_LOOP(op::store(data(I), op::div(op::add(op::load(a.data(I)), op::load(data(I)), bvec))));
+            FST_SIMD_LOOP(op.store(data(I), op.div(op.add(op.load(a.data(I)), op.load(data(I)), bvec))));
             return (derived_type&) *this;
         }
 
@@ -1376,7 +1452,7 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& add_then_div(value_type a, const container_base<_BT, _BSize, _BAlign, _BBase, _BDerived>& b) noexcept
         {
             const vector_type avec = op::load(a);
-            FST_SIMD_LOOP(op::store(data(I), op::div(op::add(op::load(data(I)), avec), op::load(b.data(I)))));
+            FST_SIMD_LOOP(op.store(data(I), op.div(op.add(op.load(data(I)), avec), op.load(b.data(I)))));
             return (derived_type&) *this;
         }
 
@@ -1385,7 +1461,7 @@ namespace detail
         {
             const vector_type avec = op::load(a);
             const vector_type bvec = op::load(b);
-            FST_SIMD_LOOP(op::store(data(I), op::div(op::add(avec, op::load(data(I)), bvec))));
+            FST_SIMD_LOOP(op.store(data(I), op.div(op.add(avec, op.load(data(I)), bvec))));
             return (derived_type&) *this;
         }
 
@@ -1396,28 +1472,28 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& min(value_type v) noexcept
         {
             const vector_type value = op::load(v);
-            FST_SIMD_LOOP(op::store(data(I), op::min(op::load(data(I)), value)));
+            FST_SIMD_LOOP(op.store(data(I), op.min(op.load(data(I)), value)));
             return (derived_type&) *this;
         }
 
         template <class _AT, size_t _ASize, size_t _AAlign, class _ABase, class _ADerived>
         FST_ALWAYS_INLINE derived_type& min(const container_base<_AT, _ASize, _AAlign, _ABase, _ADerived>& a) noexcept
         {
-            FST_SIMD_LOOP(op::store(data(I), op::min(op::load(data(I)), op::load(a.data(I)))));
+            FST_SIMD_LOOP(op.store(data(I), op.min(op.load(data(I)), op.load(a.data(I)))));
             return (derived_type&) *this;
         }
 
         FST_ALWAYS_INLINE derived_type& max(value_type v) noexcept
         {
             const vector_type value = op::load(v);
-            FST_SIMD_LOOP(op::store(data(I), op::max(op::load(data(I)), value)));
+            FST_SIMD_LOOP(op.store(data(I), op.max(op.load(data(I)), value)));
             return (derived_type&) *this;
         }
 
         template <class _AT, size_t _ASize, size_t _AAlign, class _ABase, class _ADerived>
         FST_ALWAYS_INLINE derived_type& max(const container_base<_AT, _ASize, _AAlign, _ABase, _ADerived>& a) noexcept
         {
-            FST_SIMD_LOOP(op::store(data(I), op::max(op::load(data(I)), op::load(a.data(I)))));
+            FST_SIMD_LOOP(op.store(data(I), op.max(op.load(data(I)), op.load(a.data(I)))));
             return (derived_type&) *this;
         }
 
@@ -1425,27 +1501,157 @@ namespace detail
         //
         //
 
-        FST_NODISCARD FST_ALWAYS_INLINE value_type horizontal_sum() const noexcept
+        //
+        // Reductions.
+        //
+
+        // sum(data[i])
+        FST_NODISCARD FST_ALWAYS_INLINE scalar_type horizontal_sum() const noexcept FST_UNIT_TESTED { return sum(); }
+
+        // sum(data[i])
+        FST_NODISCARD FST_ALWAYS_INLINE scalar_type sum() const noexcept FST_UNIT_TESTED
         {
-            // hadd [a0 + a1, a2 + a3, b0 + b1, b2 + b3]
-            vector_type value = op::load_zero();
-            if constexpr (__fst::simd::has_fixed_size<container_base>::value)
-            {
-                static constexpr size_t loop_size = data_base_type::size() / vector_size;
-                __fst::unroll<loop_size / 2, vector_size * 2>([&]<size_t I>() { value = op::add(value, op::hadd(op::load(data(I)), op::load(data(I + vector_size)))); });
-            }
-            else
+            return op::hsum(accumulate([&](vector_type acc, const auto& op, size_type I) { return op.add(acc, op.load(data(I))); }));
+        }
+
+        // sum(data[i] * a[i])
+        template <class _AT, size_t _ASize, size_t _AAlign, class _ABase, class _ADerived>
+        FST_NODISCARD FST_ALWAYS_INLINE scalar_type dot(const container_base<_AT, _ASize, _AAlign, _ABase, _ADerived>& a) const noexcept FST_UNIT_TESTED
+        {
+            static_assert(_AAlign >= vector_alignment, "wrong alignment");
+            fst_assert(size() == a.size(), "range size mismatch");
+            return op::hsum(accumulate([&](vector_type acc, const auto& op, size_type I) { return op.mul_add(op.load(data(I)), op.load(a.data(I)), acc); }));
+        }
+
+        // sum(data[i] * data[i])
+        FST_NODISCARD FST_ALWAYS_INLINE scalar_type sum_of_squares() const noexcept FST_UNIT_TESTED
+        {
+            return op::hsum(accumulate([&](vector_type acc, const auto& op, size_type I) {
+                const vector_type x = op.load(data(I));
+                return op.mul_add(x, x, acc);
+            }));
+        }
+
+        // sqrt(sum(data[i] * data[i]))
+        FST_NODISCARD FST_ALWAYS_INLINE scalar_type norm() const noexcept FST_UNIT_TESTED { return __fst::sqrt(sum_of_squares()); }
+
+        // sqrt(sum(data[i] * data[i]) / size)
+        FST_NODISCARD FST_ALWAYS_INLINE scalar_type rms() const noexcept FST_UNIT_TESTED
+        {
+            fst_assert(size() > 0, "empty range");
+            return __fst::sqrt(sum_of_squares() / (scalar_type) size());
+        }
+
+        // sum(data[i]) / size
+        FST_NODISCARD FST_ALWAYS_INLINE scalar_type mean() const noexcept FST_UNIT_TESTED
+        {
+            fst_assert(size() > 0, "empty range");
+            return sum() / (scalar_type) size();
+        }
+
+        // min(data[i])
+        FST_NODISCARD FST_ALWAYS_INLINE scalar_type minimum() const noexcept FST_UNIT_TESTED
+        {
+            return reduce([](vector_type v) { return v; }, [](vector_type a, vector_type b) { return op::min(a, b); }, //
+                [](scalar_type v) { return v; }, [](scalar_type a, scalar_type b) { return __fst::minimum(a, b); });
+        }
+
+        // max(data[i])
+        FST_NODISCARD FST_ALWAYS_INLINE scalar_type maximum() const noexcept FST_UNIT_TESTED
+        {
+            return reduce([](vector_type v) { return v; }, [](vector_type a, vector_type b) { return op::max(a, b); }, //
+                [](scalar_type v) { return v; }, [](scalar_type a, scalar_type b) { return __fst::maximum(a, b); });
+        }
+
+        // max(abs(data[i]))
+        FST_NODISCARD FST_ALWAYS_INLINE scalar_type peak() const noexcept FST_UNIT_TESTED
+        {
+            return reduce([](vector_type v) { return op::max(v, op::sub(op::load_zero(), v)); }, [](vector_type a, vector_type b) { return op::max(a, b); }, //
+                [](scalar_type v) { return __fst::fabs(v); }, [](scalar_type a, scalar_type b) { return __fst::maximum(a, b); });
+        }
+
+        // Index of the first minimum value.
+        // NaN values are skipped, returns 0 when every value is NaN.
+        FST_NODISCARD FST_ALWAYS_INLINE size_type argmin() const noexcept FST_UNIT_TESTED { return arg_reduce<false>(); }
+
+        // Index of the first maximum value.
+        // NaN values are skipped, returns 0 when every value is NaN.
+        FST_NODISCARD FST_ALWAYS_INLINE size_type argmax() const noexcept FST_UNIT_TESTED { return arg_reduce<true>(); }
+
+        // Mean and population variance in a single pass.
+        // Each lane runs its own Welford update, two sets of lanes are interleaved to
+        // keep two independent dependency chains. The lanes are merged at the end
+        // (Chan et al.) and the remaining elements go through the scalar update.
+        FST_NODISCARD FST_ALWAYS_INLINE __fst::simd::mean_variance_result<scalar_type> mean_variance() const noexcept FST_UNIT_TESTED
+        {
+            fst_assert(size() > 0, "empty range");
+
+            scalar_type count = 0;
+            scalar_type mean_value = 0;
+            scalar_type m2 = 0;
+
+            const size_type pair_count = size() / (2 * vector_size);
+            size_type I = 0;
+
+            if (pair_count > 0)
             {
-                constexpr size_type delta = 2 * vector_size;
-                for (size_type I = 0; I < size() - vector_size; I += delta)
+                vector_type mean0 = op::load_zero();
+                vector_type mean1 = op::load_zero();
+                vector_type m2_0 = op::load_zero();
+                vector_type m2_1 = op::load_zero();
+
+                for (size_type k = 0; k < pair_count; k++, I += 2 * vector_size)
                 {
-                    value = op::add(value, op::hadd(op::load(data(I)), op::load(data(I + vector_size))));
+                    const vector_type inv_count = op::load((scalar_type) 1 / (scalar_type) (k + 1));
+                    const vector_type x0 = op::load(data(I));
+                    const vector_type x1 = op::load(data(I + vector_size));
+
+                    const vector_type delta0 = op::sub(x0, mean0);
+                    const vector_type delta1 = op::sub(x1, mean1);
+                    mean0 = op::mul_add(delta0, inv_count, mean0);
+                    mean1 = op::mul_add(delta1, inv_count, mean1);
+                    m2_0 = op::mul_add(delta0, op::sub(x0, mean0), m2_0);
+                    m2_1 = op::mul_add(delta1, op::sub(x1, mean1), m2_1);
+                }
+
+                alignas(vector_alignment) scalar_type lane_means[2 * vector_size];
+                alignas(vector_alignment) scalar_type lane_m2[2 * vector_size];
+                op::store(lane_means, mean0);
+                op::store(lane_means + vector_size, mean1);
+                op::store(lane_m2, m2_0);
+                op::store(lane_m2 + vector_size, m2_1);
+
+                // Every lane saw pair_count elements.
+                const scalar_type lane_count = (scalar_type) pair_count;
+                count = lane_count;
+                mean_value = lane_means[0];
+                m2 = lane_m2[0];
+
+                for (size_t i = 1; i < 2 * vector_size; i++)
+                {
+                    const scalar_type total = count + lane_count;
+                    const scalar_type delta = lane_means[i] - mean_value;
+                    mean_value += delta * lane_count / total;
+                    m2 += lane_m2[i] + delta * delta * count * lane_count / total;
+                    count = total;
                 }
             }
 
-            return op::hsum(value);
+            for (; I < size(); I++)
+            {
+                const scalar_type x = *data(I);
+                count += 1;
+                const scalar_type delta = x - mean_value;
+                mean_value += delta / count;
+                m2 += delta * (x - mean_value);
+            }
+
+            return { mean_value, m2 / count };
         }
 
+        // sum((data[i] - mean)^2) / size
+        FST_NODISCARD FST_ALWAYS_INLINE scalar_type variance() const noexcept FST_UNIT_TESTED { return mean_variance().variance; }
+
         //
         //
         //
@@ -1455,11 +1661,165 @@ namespace detail
         FST_ALWAYS_INLINE derived_type& sin_of_mul_ab(const container_base<_AT, _ASize, _AAlign, _ABase, _ADerived>& a, value_type b) noexcept
         {
             const vector_type b_value = op::load(b);
-            FST_SIMD_LOOP(op::store(data(I), op::sin(op::mul(op::load(a.data(I)), b_value))));
+            FST_SIMD_LOOP(op.store(data(I), op.sin(op.mul(op.load(a.data(I)), b_value))));
             return (derived_type&) *this;
         }
 
       private:
+        static constexpr size_t accumulator_count = 4;
+
+        // Folds every vector of the container with fct(acc, op, index) into accumulator_count
+        // independent accumulators, the latency of the add/fma chain is hidden behind the
+        // other accumulators. The last incomplete vector goes through a partial_vector_op,
+        // its missing lanes are loaded as zero so fct must leave acc unchanged for them.
+        template <class _Fct>
+        FST_NODISCARD FST_ALWAYS_INLINE vector_type accumulate(_Fct&& fct) const noexcept
+        {
+            const vector_op vop = {};
+            constexpr size_type block_size = accumulator_count * vector_size;
+            const size_type vsize = size() - (size() % vector_size);
+
+            vector_type acc[accumulator_count];
+            for (size_t i = 0; i < accumulator_count; i++)
+            {
+                acc[i] = op::load_zero();
+            }
+
+            size_type I = 0;
+            for (; I + block_size <= vsize; I += block_size)
+            {
+                for (size_t i = 0; i < accumulator_count; i++)
+                {
+                    acc[i] = fct(acc[i], vop, I + i * vector_size);
+                }
+            }
+
+            for (; I < vsize; I += vector_size)
+            {
+                acc[0] = fct(acc[0], vop, I);
+            }
+
+            if (I < size())
+            {
+                const __fst::simd::partial_vector_op<vector_op> pop = { {}, size() - I };
+                acc[0] = fct(acc[0], pop, I);
+            }
+
+            return op::add(op::add(acc[0], acc[1]), op::add(acc[2], acc[3]));
+        }
+
+        // fold(map(data[0]), map(data[1]), ...) with two vector accumulators for the
+        // full vectors and a scalar loop for the remaining elements, for the reductions
+        // where zero padded lanes would change the result (min, max, ...).
+        template <class _VMap, class _VFold, class _SMap, class _SFold>
+        FST_NODISCARD FST_ALWAYS_INLINE scalar_type reduce(_VMap vmap, _VFold vfold, _SMap smap, _SFold sfold) const noexcept
+        {
+            fst_assert(size() > 0, "empty range");
+
+            const size_type vsize = size() - (size() % vector_size);
+            scalar_type result;
+            size_type I;
+
+            if (vsize == 0)
+            {
+                result = smap(*data(0));
+                I = 1;
+            }
+            else
+            {
+                vector_type acc0 = vmap(op::load(data(0)));
+                vector_type acc1 = acc0;
+
+                for (I = vector_size; I + 2 * vector_size <= vsize; I += 2 * vector_size)
+                {
+                    acc0 = vfold(acc0, vmap(op::load(data(I))));
+                    acc1 = vfold(acc1, vmap(op::load(data(I + vector_size))));
+                }
+
+                for (; I < vsize; I += vector_size)
+                {
+                    acc0 = vfold(acc0, vmap(op::load(data(I))));
+                }
+
+                alignas(vector_alignment) scalar_type lanes[vector_size];
+                op::store(lanes, vfold(acc0, acc1));
+                result = lanes[0];
+                for (size_t i = 1; i < vector_size; i++)
+                {
+                    result = sfold(result, lanes[i]);
+                }
+            }
+
+            for (; I < size(); I++)
+            {
+                result = sfold(result, smap(*data(I)));
+            }
+
+            return result;
+        }
+
+        // argmin (or argmax with _Max) in a single pass.
+        // Every lane keeps its best value and the block it came from, the lanes are merged
+        // at the end and the remaining elements go through the scalar loop. The block
+        // numbers are stored as scalar_type, segments keep them exact on long ranges.
+        template <bool _Max>
+        FST_NODISCARD FST_ALWAYS_INLINE size_type arg_reduce() const noexcept
+        {
+            fst_assert(size() > 0, "empty range");
+
+            // a replaces b when it's strictly better or when b is NaN and a isn't.
+            const auto better = [](scalar_type a, scalar_type b) { return (_Max ? b < a : a < b) || (b != b && a == a); };
+
+            constexpr size_type segment_size = vector_size << 20;
+            const size_type vsize = size() - (size() % vector_size);
+            scalar_type result = *data(0);
+            size_type index = 0;
+
+            for (size_type first = 0; first < vsize; first += segment_size)
+            {
+                const size_type last = __fst::minimum(first + segment_size, vsize);
+                const vector_type one = op::load((scalar_type) 1);
+                vector_type best = op::load(data(first));
+                vector_type best_block = op::load_zero();
+                vector_type block = op::load_zero();
+
+                for (size_type I = first + vector_size; I < last; I += vector_size)
+                {
+                    const vector_type x = op::load(data(I));
+                    const auto mask = op::or_mask(_Max ? op::less(best, x) : op::less(x, best), op::and_mask(op::is_nan(best), op::equal(x, x)));
+                    block = op::add(block, one);
+                    best = op::select(mask, x, best);
+                    best_block = op::select(mask, block, best_block);
+                }
+
+                alignas(vector_alignment) scalar_type values[vector_size];
+                alignas(vector_alignment) scalar_type blocks[vector_size];
+                op::store(values, best);
+                op::store(blocks, best_block);
+
+                for (size_t i = 0; i < vector_size; i++)
+                {
+                    const size_type k = first + (size_type) blocks[i] * vector_size + i;
+                    if (better(values[i], result) || (k < index && !better(result, values[i])))
+                    {
+                        result = values[i];
+                        index = k;
+                    }
+                }
+            }
+
+            for (size_type I = vsize; I < size(); I++)
+            {
+                if (better(*data(I), result))
+                {
+                    result = *data(I);
+                    index = I;
+                }
+            }
+
+            return index;
+        }
+
         template <class _TT, class _TBase, class _TDerived, size_t _TSize, size_t _TAlign, class _SDerived = _Derived,
             __fst::enable_if_t<__fst::simd::has_fixed_size<_SDerived>::value && __fst::simd::has_fixed_size<_TDerived>::value, int> = 0>
         FST_ALWAYS_INLINE constexpr void validate_size(const container_base<_TT, _TSize, _TAlign, _TBase, _TDerived>& rb) noexcept
@@ -1475,6 +1835,17 @@ namespace detail
             fst_assert(size() == rb.size(), "range size mismatch");
 #else
             __fst::unused(rb);
+#endif // FST_HAS_ASSERT
+        }
+
+        template <class _Expr>
+        FST_ALWAYS_INLINE constexpr void validate_expression(const _Expr& e) noexcept
+        {
+            static_assert(__fst::is_same_v<typename _Expr::value_type, scalar_type>, "value type mismatch");
+#if FST_HAS_ASSERT
+            fst_assert(e.matches_size(size()), "range size mismatch");
+#else
+            __fst::unused(e);
 #endif // FST_HAS_ASSERT
         }
     };
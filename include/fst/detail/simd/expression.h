@@ -0,0 +1,312 @@
+///
+/// Lazy element-wise expressions.
+///
+/// Not a normal header, included by fst/simd.h inside the simd namespace.
+///
+/// @code
+///   // One pass over memory, a[i] * b[i] + c[i] * gain is fused to an fma.
+///   dst = fst::simd::expr(a) * b + fst::simd::expr(c) * gain;
+///   dst += fst::simd::sin(fst::simd::expr(a) * 0.5f);
+/// @endcode
+///
+/// The container operators (a + b, a * 2, ...) are eager and return a new
+/// container, fst::simd::expr(a) is the entry point of the lazy evaluation.
+/// An expression only keeps a pointer to its containers and must not outlive them.
+/// Nothing is computed until the expression is assigned to a container, every
+/// element being loaded, computed and stored once. A container can appear on
+/// both sides of the assignment since each vector is read before being written.
+
+namespace detail
+{
+    template <class _T, size_t _Size, size_t _Alignment, class _DataBase, class _Derived>
+    __fst::true_t is_container_test(const container_base<_T, _Size, _Alignment, _DataBase, _Derived>*) noexcept;
+
+    __fst::false_t is_container_test(...) noexcept;
+} // namespace detail
+
+///
+template <class T>
+struct is_container : decltype(detail::is_container_test(static_cast<const T*>(nullptr)))
+{};
+
+///
+template <class T>
+struct is_expression : __fst::false_t
+{};
+
+namespace expression
+{
+    /// Leaf referencing the elements of a container.
+    template <class _T, size_t _Size, size_t _Alignment, class _DataBase, class _Derived>
+    struct container_node
+    {
+        using value_type = __fst::remove_const_t<_T>;
+        using container_type = __fst::simd::detail::container_base<_T, _Size, _Alignment, _DataBase, _Derived>;
+
+        static_assert(_Alignment >= __fst::simd::vector_type_alignment_v<value_type>, "wrong alignment");
+
+        const container_type* container;
+
+        template <class _Op>
+        FST_NODISCARD FST_ALWAYS_INLINE typename _Op::vec_type eval(const _Op& op, size_t index) const noexcept
+        {
+            return op.load(container->data(index));
+        }
+
+        FST_NODISCARD FST_ALWAYS_INLINE bool matches_size(size_t size) const noexcept { return container->size() == size; }
+    };
+
+    /// Leaf broadcasting the same value to every element.
+    template <class _T>
+    struct scalar_node
+    {
+        using value_type = _T;
+
+        value_type value;
+
+        template <class _Op>
+        FST_NODISCARD FST_ALWAYS_INLINE typename _Op::vec_type eval(const _Op& op, size_t) const noexcept
+        {
+            return op.load(value);
+        }
+
+        FST_NODISCARD FST_ALWAYS_INLINE bool matches_size(size_t) const noexcept { return true; }
+    };
+
+    /// _Fct::apply(op, a[i])
+    template <class _Fct, class _A>
+    struct unary_node
+    {
+        using value_type = typename _A::value_type;
+
+        _A a;
+
+        template <class _Op>
+        FST_NODISCARD FST_ALWAYS_INLINE typename _Op::vec_type eval(const _Op& op, size_t index) const noexcept
+        {
+            return _Fct::apply(op, a.eval(op, index));
+        }
+
+        FST_NODISCARD FST_ALWAYS_INLINE bool matches_size(size_t size) const noexcept { return a.matches_size(size); }
+    };
+
+    /// _Fct::apply(op, a[i], b[i])
+    template <class _Fct, class _A, class _B>
+    struct binary_node
+    {
+        using value_type = typename _A::value_type;
+        static_assert(__fst::is_same_v<value_type, typename _B::value_type>, "value type mismatch");
+
+        _A a;
+        _B b;
+
+        template <class _Op>
+        FST_NODISCARD FST_ALWAYS_INLINE typename _Op::vec_type eval(const _Op& op, size_t index) const noexcept
+        {
+            return _Fct::apply(op, a.eval(op, index), b.eval(op, index));
+        }
+
+        FST_NODISCARD FST_ALWAYS_INLINE bool matches_size(size_t size) const noexcept { return a.matches_size(size) && b.matches_size(size); }
+    };
+
+    /// a[i] * b[i] + c[i], evaluated with vector_op::mul_add.
+    template <class _A, class _B, class _C>
+    struct mul_add_node
+    {
+        using value_type = typename _A::value_type;
+        static_assert(__fst::is_same_v<value_type, typename _B::value_type>, "value type mismatch");
+        static_assert(__fst::is_same_v<value_type, typename _C::value_type>, "value type mismatch");
+
+        _A a;
+        _B b;
+        _C c;
+
+        template <class _Op>
+        FST_NODISCARD FST_ALWAYS_INLINE typename _Op::vec_type eval(const _Op& op, size_t index) const noexcept
+        {
+            return op.mul_add(a.eval(op, index), b.eval(op, index), c.eval(op, index));
+        }
+
+        FST_NODISCARD FST_ALWAYS_INLINE bool matches_size(size_t size) const noexcept
+        {
+            return a.matches_size(size) && b.matches_size(size) && c.matches_size(size);
+        }
+    };
+
+    // clang-format off
+    struct add_fct { template <class _Op, class _V> FST_ALWAYS_INLINE static _V apply(const _Op& op, _V a, _V b) noexcept { return op.add(a, b); } };
+    struct sub_fct { template <class _Op, class _V> FST_ALWAYS_INLINE static _V apply(const _Op& op, _V a, _V b) noexcept { return op.sub(a, b); } };
+    struct mul_fct { template <class _Op, class _V> FST_ALWAYS_INLINE static _V apply(const _Op& op, _V a, _V b) noexcept { return op.mul(a, b); } };
+    struct div_fct { template <class _Op, class _V> FST_ALWAYS_INLINE static _V apply(const _Op& op, _V a, _V b) noexcept { return op.div(a, b); } };
+    struct min_fct { template <class _Op, class _V> FST_ALWAYS_INLINE static _V apply(const _Op& op, _V a, _V b) noexcept { return op.min(a, b); } };
+    struct max_fct { template <class _Op, class _V> FST_ALWAYS_INLINE static _V apply(const _Op& op, _V a, _V b) noexcept { return op.max(a, b); } };
+    struct pow_fct { template <class _Op, class _V> FST_ALWAYS_INLINE static _V apply(const _Op& op, _V a, _V b) noexcept { return op.pow(a, b); } };
+    struct neg_fct { template <class _Op, class _V> FST_ALWAYS_INLINE static _V apply(const _Op& op, _V a) noexcept { return op.sub(op.load_zero(), a); } };
+    struct abs_fct { template <class _Op, class _V> FST_ALWAYS_INLINE static _V apply(const _Op& op, _V a) noexcept { return op.max(a, op.sub(op.load_zero(), a)); } };
+    struct sqrt_fct { template <class _Op, class _V> FST_ALWAYS_INLINE static _V apply(const _Op& op, _V a) noexcept { return op.sqrt(a); } };
+    struct sin_fct { template <class _Op, class _V> FST_ALWAYS_INLINE static _V apply(const _Op& op, _V a) noexcept { return op.sin(a); } };
+    struct cos_fct { template <class _Op, class _V> FST_ALWAYS_INLINE static _V apply(const _Op& op, _V a) noexcept { return op.cos(a); } };
+    struct tan_fct { template <class _Op, class _V> FST_ALWAYS_INLINE static _V apply(const _Op& op, _V a) noexcept { return op.tan(a); } };
+    struct log_fct { template <class _Op, class _V> FST_ALWAYS_INLINE static _V apply(const _Op& op, _V a) noexcept { return op.log(a); } };
+    struct exp2_fct { template <class _Op, class _V> FST_ALWAYS_INLINE static _V apply(const _Op& op, _V a) noexcept { return op.exp2(a); } };
+    struct exp10_fct { template <class _Op, class _V> FST_ALWAYS_INLINE static _V apply(const _Op& op, _V a) noexcept { return op.exp10(a); } };
+    // clang-format on
+
+    template <class T>
+    struct is_mul_node : __fst::false_t
+    {};
+
+    template <class _A, class _B>
+    struct is_mul_node<binary_node<mul_fct, _A, _B>> : __fst::true_t
+    {};
+} // namespace expression
+
+template <class _T, size_t _Size, size_t _Alignment, class _DataBase, class _Derived>
+struct is_expression<expression::container_node<_T, _Size, _Alignment, _DataBase, _Derived>> : __fst::true_t
+{};
+
+template <class _T>
+struct is_expression<expression::scalar_node<_T>> : __fst::true_t
+{};
+
+template <class _Fct, class _A>
+struct is_expression<expression::unary_node<_Fct, _A>> : __fst::true_t
+{};
+
+template <class _Fct, class _A, class _B>
+struct is_expression<expression::binary_node<_Fct, _A, _B>> : __fst::true_t
+{};
+
+template <class _A, class _B, class _C>
+struct is_expression<expression::mul_add_node<_A, _B, _C>> : __fst::true_t
+{};
+
+namespace expression
+{
+    template <class _T, size_t _Size, size_t _Alignment, class _DataBase, class _Derived>
+    FST_NODISCARD FST_ALWAYS_INLINE container_node<_T, _Size, _Alignment, _DataBase, _Derived> make_node(
+        const __fst::simd::detail::container_base<_T, _Size, _Alignment, _DataBase, _Derived>& c, __fst::false_t) noexcept
+    {
+        return { &c };
+    }
+
+    template <class _Expr>
+    FST_NODISCARD FST_ALWAYS_INLINE const _Expr& make_node(const _Expr& e, __fst::true_t) noexcept
+    {
+        return e;
+    }
+
+    // Expressions are kept as is, containers are wrapped into a container_node.
+    template <class T>
+    FST_NODISCARD FST_ALWAYS_INLINE decltype(auto) make_node(const T& t) noexcept
+    {
+        return make_node(t, __fst::bool_t<__fst::simd::is_expression<T>::value>{});
+    }
+
+    template <class T>
+    using node_t = __fst::remove_cvref_t<decltype(make_node(__fst::declval<const T&>()))>;
+
+    // Scalars take the value type of the other operand.
+    template <class _T, class _Other, bool = __fst::is_arithmetic_v<_T>>
+    struct operand
+    {
+        using type = node_t<_T>;
+    };
+
+    template <class _T, class _Other>
+    struct operand<_T, _Other, true>
+    {
+        using type = scalar_node<typename node_t<_Other>::value_type>;
+    };
+
+    template <class _T, class _Other>
+    using operand_t = typename operand<_T, _Other>::type;
+
+    template <class _T, class _Other>
+    FST_NODISCARD FST_ALWAYS_INLINE operand_t<_T, _Other> make_operand(const _T& t) noexcept
+    {
+        if constexpr (__fst::is_arithmetic_v<_T>) { return { (typename node_t<_Other>::value_type) t }; }
+        else { return make_node(t); }
+    }
+
+    template <class T>
+    FST_INLINE_VAR constexpr bool is_operand_v = __fst::simd::is_expression<T>::value || __fst::simd::is_container<T>::value;
+
+    // At least one side must be an expression, the other one can be an expression, a container or a scalar.
+    template <class _A, class _B>
+    FST_INLINE_VAR constexpr bool is_binary_operand_v
+        = (__fst::simd::is_expression<_A>::value && (is_operand_v<_B> || __fst::is_arithmetic_v<_B>))
+          || (__fst::simd::is_expression<_B>::value && (is_operand_v<_A> || __fst::is_arithmetic_v<_A>));
+
+    template <class _Fct, class _A, class _B>
+    FST_NODISCARD FST_ALWAYS_INLINE auto make_binary(const _A& a, const _B& b) noexcept
+    {
+        using a_type = operand_t<_A, _B>;
+        using b_type = operand_t<_B, _A>;
+
+        // (a * b) + c and c + (a * b) become mul_add(a, b, c).
+        if constexpr (__fst::is_same_v<_Fct, add_fct> && is_mul_node<a_type>::value)
+        {
+            const a_type m = make_operand<_A, _B>(a);
+            return mul_add_node<decltype(m.a), decltype(m.b), b_type>{ m.a, m.b, make_operand<_B, _A>(b) };
+        }
+        else if constexpr (__fst::is_same_v<_Fct, add_fct> && is_mul_node<b_type>::value)
+        {
+            const b_type m = make_operand<_B, _A>(b);
+            return mul_add_node<decltype(m.a), decltype(m.b), a_type>{ m.a, m.b, make_operand<_A, _B>(a) };
+        }
+        else
+        {
+            return binary_node<_Fct, a_type, b_type>{ make_operand<_A, _B>(a), make_operand<_B, _A>(b) };
+        }
+    }
+
+    template <class _Fct, class _A>
+    FST_NODISCARD FST_ALWAYS_INLINE unary_node<_Fct, node_t<_A>> make_unary(const _A& a) noexcept
+    {
+        return { make_node(a) };
+    }
+} // namespace expression
+
+/// Lazy expression of a container, see fst/detail/simd/expression.h.
+template <class _T, size_t _Size, size_t _Alignment, class _DataBase, class _Derived>
+FST_NODISCARD FST_ALWAYS_INLINE expression::container_node<_T, _Size, _Alignment, _DataBase, _Derived> expr(
+    const __fst::simd::detail::container_base<_T, _Size, _Alignment, _DataBase, _Derived>& c) noexcept
+{
+    return { &c };
+}
+
+// clang-format off
+#define FST_SIMD_EXPRESSION_BINARY_OPERATOR(NAME, FCT)                                                                                       \
+    template <class _A, class _B, __fst::enable_if_t<__fst::simd::expression::is_binary_operand_v<_A, _B>, int> = 0>                       \
+    FST_NODISCARD FST_ALWAYS_INLINE auto NAME(const _A& a, const _B& b) noexcept { return __fst::simd::expression::make_binary<FCT>(a, b); }
+
+#define FST_SIMD_EXPRESSION_UNARY_FUNCTION(NAME, FCT)                                                                                        \
+    template <class _A, __fst::enable_if_t<__fst::simd::is_expression<_A>::value, int> = 0>                                                  \
+    FST_NODISCARD FST_ALWAYS_INLINE auto NAME(const _A& a) noexcept { return __fst::simd::expression::make_unary<FCT>(a); }
+// clang-format on
+
+namespace expression
+{
+    // Found by argument dependent lookup, at least one operand is an expression.
+    FST_SIMD_EXPRESSION_BINARY_OPERATOR(operator+, add_fct)
+    FST_SIMD_EXPRESSION_BINARY_OPERATOR(operator-, sub_fct)
+    FST_SIMD_EXPRESSION_BINARY_OPERATOR(operator*, mul_fct)
+    FST_SIMD_EXPRESSION_BINARY_OPERATOR(operator/, div_fct)
+    FST_SIMD_EXPRESSION_UNARY_FUNCTION(operator-, neg_fct)
+} // namespace expression
+
+FST_SIMD_EXPRESSION_BINARY_OPERATOR(min, __fst::simd::expression::min_fct)
+FST_SIMD_EXPRESSION_BINARY_OPERATOR(max, __fst::simd::expression::max_fct)
+FST_SIMD_EXPRESSION_BINARY_OPERATOR(pow, __fst::simd::expression::pow_fct)
+FST_SIMD_EXPRESSION_UNARY_FUNCTION(abs, __fst::simd::expression::abs_fct)
+FST_SIMD_EXPRESSION_UNARY_FUNCTION(sqrt, __fst::simd::expression::sqrt_fct)
+FST_SIMD_EXPRESSION_UNARY_FUNCTION(sin, __fst::simd::expression::sin_fct)
+FST_SIMD_EXPRESSION_UNARY_FUNCTION(cos, __fst::simd::expression::cos_fct)
+FST_SIMD_EXPRESSION_UNARY_FUNCTION(tan, __fst::simd::expression::tan_fct)
+FST_SIMD_EXPRESSION_UNARY_FUNCTION(log, __fst::simd::expression::log_fct)
+FST_SIMD_EXPRESSION_UNARY_FUNCTION(exp2, __fst::simd::expression::exp2_fct)
+FST_SIMD_EXPRESSION_UNARY_FUNCTION(exp10, __fst::simd::expression::exp10_fct)
+
+#undef FST_SIMD_EXPRESSION_BINARY_OPERATOR
+#undef FST_SIMD_EXPRESSION_UNARY_FUNCTION
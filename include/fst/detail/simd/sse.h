@@ -7,7 +7,10 @@
 #if FST_SIMD_128 || FST_SIMD_256 || FST_SIMD_512
 #define FST_HAS_SIMD 1
 
+#if __FST_MSVC__
 #include <intrin.h>
+#endif
+
 #include <immintrin.h>
 
 #if FST_PLATFORM_HAS_EMMINTRIN_H
@@ -18,7 +21,7 @@
 #include <xmmintrin.h>
 #endif
 //https://github.com/raedwulf/gmath/tree/master/include/cephes
-FST_BEGIN_SUB_NAMESPACE(simd)
+FST_BEGIN_SIMD_NAMESPACE
 
     template <class T>
     inline constexpr int to_int(T v) noexcept
@@ -856,7 +859,7 @@ FST_BEGIN_SUB_NAMESPACE(simd)
     {
         m128 v1(x);
         m128 v2(y);
-        return _mm_set_ps(v1[0] + v2[0], v1[1] + v2[1], v1[2] + v2[2], v1[3] + v2[3]);
+        return _mm_setr_ps(v1[0] + v2[0], v1[1] + v2[1], v1[2] + v2[2], v1[3] + v2[3]);
     }
 #endif
 
@@ -865,7 +868,7 @@ FST_BEGIN_SUB_NAMESPACE(simd)
     {
         m128 v1(x);
         m128 v2(y);
-        return _mm_set_ps(v1[0] - v2[0], v1[1] - v2[1], v1[2] - v2[2], v1[3] - v2[3]);
+        return _mm_setr_ps(v1[0] - v2[0], v1[1] - v2[1], v1[2] - v2[2], v1[3] - v2[3]);
     }
 #endif
 
@@ -874,7 +877,7 @@ FST_BEGIN_SUB_NAMESPACE(simd)
     {
         m128 v1(x);
         m128 v2(y);
-        return _mm_set_ps(v1[0] * v2[0], v1[1] * v2[1], v1[2] * v2[2], v1[3] * v2[3]);
+        return _mm_setr_ps(v1[0] * v2[0], v1[1] * v2[1], v1[2] * v2[2], v1[3] * v2[3]);
     }
 #endif
 
@@ -883,7 +886,7 @@ FST_BEGIN_SUB_NAMESPACE(simd)
     {
         m128 v1(x);
         m128 v2(y);
-        return _mm_set_ps(v1[0] / v2[0], v1[1] / v2[1], v1[2] / v2[2], v1[3] / v2[3]);
+        return _mm_setr_ps(v1[0] / v2[0], v1[1] / v2[1], v1[2] / v2[2], v1[3] / v2[3]);
     }
 #endif
 
@@ -892,7 +895,7 @@ FST_BEGIN_SUB_NAMESPACE(simd)
     {
         m128 v1(x);
         m128 v2(y);
-        return _mm_set_ps(__fst::pow(v1[0], v2[0]), __fst::pow(v1[1], v2[1]), __fst::pow(v1[2], v2[2]), __fst::pow(v1[3], v2[3]));
+        return _mm_setr_ps(__fst::pow(v1[0], v2[0]), __fst::pow(v1[1], v2[1]), __fst::pow(v1[2], v2[2]), __fst::pow(v1[3], v2[3]));
     }
 #endif
 
@@ -901,7 +904,7 @@ FST_BEGIN_SUB_NAMESPACE(simd)
     {
         m128 v1(x);
         m128 v2(y);
-        return _mm_set_ps(__fst::fmod(v1[0], v2[0]), __fst::fmod(v1[1], v2[1]), __fst::fmod(v1[2], v2[2]), __fst::fmod(v1[3], v2[3]));
+        return _mm_setr_ps(__fst::fmod(v1[0], v2[0]), __fst::fmod(v1[1], v2[1]), __fst::fmod(v1[2], v2[2]), __fst::fmod(v1[3], v2[3]));
     }
 #endif
 
@@ -910,7 +913,7 @@ FST_BEGIN_SUB_NAMESPACE(simd)
     {
         m128 v1(x);
         m128 v2(y);
-        return _mm_set_ps(__fst::fmin(v1[0], v2[0]), __fst::fmin(v1[1], v2[1]), __fst::fmin(v1[2], v2[2]), __fst::fmin(v1[3], v2[3]));
+        return _mm_setr_ps(__fst::fmin(v1[0], v2[0]), __fst::fmin(v1[1], v2[1]), __fst::fmin(v1[2], v2[2]), __fst::fmin(v1[3], v2[3]));
     }
 #endif
 
@@ -919,7 +922,7 @@ FST_BEGIN_SUB_NAMESPACE(simd)
     {
         m128 v1(x);
         m128 v2(y);
-        return _mm_set_ps(__fst::fmax(v1[0], v2[0]), __fst::fmax(v1[1], v2[1]), __fst::fmax(v1[2], v2[2]), __fst::fmax(v1[3], v2[3]));
+        return _mm_setr_ps(__fst::fmax(v1[0], v2[0]), __fst::fmax(v1[1], v2[1]), __fst::fmax(v1[2], v2[2]), __fst::fmax(v1[3], v2[3]));
     }
 #endif
 
@@ -931,7 +934,7 @@ FST_BEGIN_SUB_NAMESPACE(simd)
     /*inline __m128 _mm_sqrt_ps(__m128 x) noexcept
     {
         m128 v1(x);
-        return _mm_set_ps(__fst::sqrt(v1[0]), __fst::sqrt(v1[1]), __fst::sqrt(v1[2]), __fst::sqrt(v1[3]));
+        return _mm_setr_ps(__fst::sqrt(v1[0]), __fst::sqrt(v1[1]), __fst::sqrt(v1[2]), __fst::sqrt(v1[3]));
     }*/
     static inline __m128 _mm_sqrt_ps(__m128 x)
     {
@@ -952,7 +955,7 @@ FST_BEGIN_SUB_NAMESPACE(simd)
     inline __m128 _mm_tan_ps(__m128 x) noexcept
     {
         m128 v1(x);
-        return _mm_set_ps(__fst::tan(v1[0]), __fst::tan(v1[1]), __fst::tan(v1[2]), __fst::tan(v1[3]));
+        return _mm_setr_ps(__fst::tan(v1[0]), __fst::tan(v1[1]), __fst::tan(v1[2]), __fst::tan(v1[3]));
     }
 #endif
 
@@ -960,7 +963,7 @@ FST_BEGIN_SUB_NAMESPACE(simd)
     inline __m128 _mm_log_ps(__m128 x) noexcept
     {
         m128 v1(x);
-        return _mm_set_ps(__fst::log(v1[0]), __fst::log(v1[1]), __fst::log(v1[2]), __fst::log(v1[3]));
+        return _mm_setr_ps(__fst::log(v1[0]), __fst::log(v1[1]), __fst::log(v1[2]), __fst::log(v1[3]));
     }
 #endif
 
@@ -968,7 +971,7 @@ FST_BEGIN_SUB_NAMESPACE(simd)
     inline __m128 _mm_log10_ps(__m128 x) noexcept
     {
         m128 v1(x);
-        return _mm_set_ps(__fst::log10(v1[0]), __fst::log10(v1[1]), __fst::log10(v1[2]), __fst::log10(v1[3]));
+        return _mm_setr_ps(__fst::log10(v1[0]), __fst::log10(v1[1]), __fst::log10(v1[2]), __fst::log10(v1[3]));
     }
 #endif
 
@@ -976,7 +979,7 @@ FST_BEGIN_SUB_NAMESPACE(simd)
     inline __m128 _mm_log2_ps(__m128 x) noexcept
     {
         m128 v1(x);
-        return _mm_set_ps(__fst::log2(v1[0]), __fst::log2(v1[1]), __fst::log2(v1[2]), __fst::log2(v1[3]));
+        return _mm_setr_ps(__fst::log2(v1[0]), __fst::log2(v1[1]), __fst::log2(v1[2]), __fst::log2(v1[3]));
     }
 #endif
 
@@ -984,7 +987,7 @@ FST_BEGIN_SUB_NAMESPACE(simd)
     inline __m128 _mm_exp10_ps(__m128 x) noexcept
     {
         m128 v1(x);
-        return _mm_set_ps(__fst::exp10(v1[0]), __fst::log2(v1[1]), __fst::log2(v1[2]), __fst::log2(v1[3]));
+        return _mm_setr_ps(__fst::exp10(v1[0]), __fst::exp10(v1[1]), __fst::exp10(v1[2]), __fst::exp10(v1[3]));
     }
 #endif
 
@@ -992,7 +995,7 @@ FST_BEGIN_SUB_NAMESPACE(simd)
     inline __m128 _mm_exp2_ps(__m128 x) noexcept
     {
         m128 v1(x);
-        return _mm_set_ps(__fst::exp2(v1[0]), __fst::exp2(v1[1]), __fst::exp2(v1[2]), __fst::exp2(v1[3]));
+        return _mm_setr_ps(__fst::exp2(v1[0]), __fst::exp2(v1[1]), __fst::exp2(v1[2]), __fst::exp2(v1[3]));
     }
 #endif
 
@@ -1000,7 +1003,7 @@ FST_BEGIN_SUB_NAMESPACE(simd)
     inline __m128 _mm_invsqrt_ps(__m128 x) noexcept
     {
         m128 v1(x);
-        return _mm_set_ps(1.0f / __fst::sqrt(v1[0]), 1.0f / __fst::sqrt(v1[1]), 1.0f / __fst::sqrt(v1[2]), 1.0f / __fst::sqrt(v1[3]));
+        return _mm_setr_ps(1.0f / __fst::sqrt(v1[0]), 1.0f / __fst::sqrt(v1[1]), 1.0f / __fst::sqrt(v1[2]), 1.0f / __fst::sqrt(v1[3]));
     }
 #endif
 
@@ -1009,7 +1012,7 @@ FST_BEGIN_SUB_NAMESPACE(simd)
     {
         m128d v1(x);
         m128d v2(y);
-        return _mm_set_pd(v1[0] + v2[0], v1[1] + v2[1]);
+        return _mm_setr_pd(v1[0] + v2[0], v1[1] + v2[1]);
     }
 #endif
 
@@ -1018,7 +1021,7 @@ FST_BEGIN_SUB_NAMESPACE(simd)
     {
         m128d v1(x);
         m128d v2(y);
-        return _mm_set_pd(v1[0] - v2[0], v1[1] - v2[1]);
+        return _mm_setr_pd(v1[0] - v2[0], v1[1] - v2[1]);
     }
 #endif
 
@@ -1027,7 +1030,7 @@ FST_BEGIN_SUB_NAMESPACE(simd)
     {
         m128d v1(x);
         m128d v2(y);
-        return _mm_set_pd(v1[0] * v2[0], v1[1] * v2[1]);
+        return _mm_setr_pd(v1[0] * v2[0], v1[1] * v2[1]);
     }
 #endif
 
@@ -1036,7 +1039,7 @@ FST_BEGIN_SUB_NAMESPACE(simd)
     {
         m128d v1(x);
         m128d v2(y);
-        return _mm_set_pd(v1[0] / v2[0], v1[1] / v2[1]);
+        return _mm_setr_pd(v1[0] / v2[0], v1[1] / v2[1]);
     }
 #endif
 
@@ -1045,7 +1048,7 @@ FST_BEGIN_SUB_NAMESPACE(simd)
     {
         m128d v1(x);
         m128d v2(y);
-        return _mm_set_pd(__fst::pow(v1[0], v2[0]), __fst::pow(v1[1], v2[1]));
+        return _mm_setr_pd(__fst::pow(v1[0], v2[0]), __fst::pow(v1[1], v2[1]));
     }
 #endif
 
@@ -1054,7 +1057,7 @@ FST_BEGIN_SUB_NAMESPACE(simd)
     {
         m128d v1(x);
         m128d v2(y);
-        return _mm_set_pd(__fst::fmod(v1[0], v2[0]), __fst::fmod(v1[1], v2[1]));
+        return _mm_setr_pd(__fst::fmod(v1[0], v2[0]), __fst::fmod(v1[1], v2[1]));
     }
 #endif
 
@@ -1063,7 +1066,7 @@ FST_BEGIN_SUB_NAMESPACE(simd)
     {
         m128d v1(x);
         m128d v2(y);
-        return _mm_set_pd(__fst::fmin(v1[0], v2[0]), __fst::fmin(v1[1], v2[1]));
+        return _mm_setr_pd(__fst::fmin(v1[0], v2[0]), __fst::fmin(v1[1], v2[1]));
     }
 #endif
 
@@ -1072,7 +1075,7 @@ FST_BEGIN_SUB_NAMESPACE(simd)
     {
         m128d v1(x);
         m128d v2(y);
-        return _mm_set_pd(__fst::fmax(v1[0], v2[0]), __fst::fmax(v1[1], v2[1]));
+        return _mm_setr_pd(__fst::fmax(v1[0], v2[0]), __fst::fmax(v1[1], v2[1]));
     }
 #endif
 
@@ -1083,7 +1086,7 @@ FST_BEGIN_SUB_NAMESPACE(simd)
     inline __m128d _mm_sqrt_pd(__m128d x) noexcept
     {
         m128d v1(x);
-        return _mm_set_pd(__fst::sqrt(v1[0]), __fst::sqrt(v1[1]));
+        return _mm_setr_pd(__fst::sqrt(v1[0]), __fst::sqrt(v1[1]));
     }
 
 #endif
@@ -1092,7 +1095,7 @@ FST_BEGIN_SUB_NAMESPACE(simd)
     inline __m128d _mm_sin_pd(__m128d x) noexcept
     {
         m128d v1(x);
-        return _mm_set_pd(__fst::sin(v1[0]), __fst::sin(v1[1]));
+        return _mm_setr_pd(__fst::sin(v1[0]), __fst::sin(v1[1]));
     }
 #endif
 
@@ -1100,7 +1103,7 @@ FST_BEGIN_SUB_NAMESPACE(simd)
     inline __m128d _mm_cos_pd(__m128d x) noexcept
     {
         m128d v1(x);
-        return _mm_set_pd(__fst::cos(v1[0]), __fst::cos(v1[1]));
+        return _mm_setr_pd(__fst::cos(v1[0]), __fst::cos(v1[1]));
     }
 #endif
 
@@ -1108,7 +1111,7 @@ FST_BEGIN_SUB_NAMESPACE(simd)
     inline __m128d _mm_tan_pd(__m128d x) noexcept
     {
         m128d v1(x);
-        return _mm_set_pd(__fst::tan(v1[0]), __fst::tan(v1[1]));
+        return _mm_setr_pd(__fst::tan(v1[0]), __fst::tan(v1[1]));
     }
 #endif
 
@@ -1116,7 +1119,7 @@ FST_BEGIN_SUB_NAMESPACE(simd)
     inline __m128d _mm_log_pd(__m128d x) noexcept
     {
         m128d v1(x);
-        return _mm_set_pd(__fst::log(v1[0]), __fst::log(v1[1]));
+        return _mm_setr_pd(__fst::log(v1[0]), __fst::log(v1[1]));
     }
 #endif
 
@@ -1124,7 +1127,7 @@ FST_BEGIN_SUB_NAMESPACE(simd)
     inline __m128d _mm_log10_pd(__m128d x) noexcept
     {
         m128d v1(x);
-        return _mm_set_pd(__fst::log10(v1[0]), __fst::log10(v1[1]));
+        return _mm_setr_pd(__fst::log10(v1[0]), __fst::log10(v1[1]));
     }
 #endif
 
@@ -1132,7 +1135,7 @@ FST_BEGIN_SUB_NAMESPACE(simd)
     inline __m128d _mm_log2_pd(__m128d x) noexcept
     {
         m128d v1(x);
-        return _mm_set_pd(__fst::log2(v1[0]), __fst::log2(v1[1]));
+        return _mm_setr_pd(__fst::log2(v1[0]), __fst::log2(v1[1]));
     }
 #endif
 
@@ -1140,7 +1143,7 @@ FST_BEGIN_SUB_NAMESPACE(simd)
     inline __m128d _mm_exp10_pd(__m128d x) noexcept
     {
         m128d v1(x);
-        return _mm_set_pd(__fst::exp10(v1[0]), __fst::log2(v1[1]));
+        return _mm_setr_pd(__fst::exp10(v1[0]), __fst::exp10(v1[1]));
     }
 #endif
 
@@ -1148,7 +1151,7 @@ FST_BEGIN_SUB_NAMESPACE(simd)
     inline __m128d _mm_exp2_pd(__m128d x) noexcept
     {
         m128d v1(x);
-        return _mm_set_pd(__fst::exp2(v1[0]), __fst::exp2(v1[1]));
+        return _mm_setr_pd(__fst::exp2(v1[0]), __fst::exp2(v1[1]));
     }
 #endif
 
@@ -1156,10 +1159,165 @@ FST_BEGIN_SUB_NAMESPACE(simd)
     inline __m128d _mm_invsqrt_pd(__m128d x) noexcept
     {
         m128d v1(x);
-        return _mm_set_pd(1.0f / __fst::sqrt(v1[0]), 1.0f / __fst::sqrt(v1[1]));
+        return _mm_setr_pd(1.0f / __fst::sqrt(v1[0]), 1.0f / __fst::sqrt(v1[1]));
+    }
+#endif
+
+    inline __m128 _mm_load_partial_ps(const float* ptr, size_t count) noexcept
+    {
+        m128 v(_mm_setzero_ps());
+        for (size_t i = 0; i < count; i++)
+        {
+            v[i] = ptr[i];
+        }
+        return v.v;
+    }
+
+    inline void _mm_store_partial_ps(float* dst, __m128 src, size_t count) noexcept
+    {
+        const m128 v(src);
+        for (size_t i = 0; i < count; i++)
+        {
+            dst[i] = v[i];
+        }
     }
+
+    // A partial __m128d always holds a single element.
+    inline __m128d _mm_load_partial_pd(const double* ptr, size_t) noexcept { return _mm_load_sd(ptr); }
+
+    inline void _mm_store_partial_pd(double* dst, __m128d src, size_t) noexcept { _mm_store_sd(dst, src); }
+
+    inline float _mm_hsum_ps(__m128 x) noexcept
+    {
+        __m128 shuf = _mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 3, 0, 1));
+        __m128 sums = _mm_add_ps(x, shuf);
+        shuf = _mm_movehl_ps(shuf, sums);
+        return _mm_cvtss_f32(_mm_add_ss(sums, shuf));
+    }
+
+    inline double _mm_hsum_pd(__m128d x) noexcept { return _mm_cvtsd_f64(_mm_add_sd(x, _mm_unpackhi_pd(x, x))); }
+
+    // a * b + c, fused when fma is enabled.
+#if defined(__FMA__) || (__FST_MSVC__ && defined(__AVX2__))
+    FST_INLINE_VAR constexpr bool _mm_fused_mul_add = true;
+#else
+    FST_INLINE_VAR constexpr bool _mm_fused_mul_add = false;
 #endif
-FST_END_SUB_NAMESPACE
+
+    inline __m128 _mm_mul_add_ps(__m128 a, __m128 b, __m128 c) noexcept
+    {
+#if defined(__FMA__) || (__FST_MSVC__ && defined(__AVX2__))
+        return _mm_fmadd_ps(a, b, c);
+#else
+        return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+    }
+
+    inline __m128d _mm_mul_add_pd(__m128d a, __m128d b, __m128d c) noexcept
+    {
+#if defined(__FMA__) || (__FST_MSVC__ && defined(__AVX2__))
+        return _mm_fmadd_pd(a, b, c);
+#else
+        return _mm_add_pd(_mm_mul_pd(a, b), c);
+#endif
+    }
+
+    //
+    // Building blocks of the fst/simd_math.h kernels.
+    //
+
+    // Rounds to the nearest integer, ties to even.
+    inline __m128 _mm_nearest_ps(__m128 x) noexcept { return _mm_round_ps(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+
+    inline __m128d _mm_nearest_pd(__m128d x) noexcept { return _mm_round_pd(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+
+    inline __m128 _mm_abs_ps(__m128 x) noexcept { return _mm_andnot_ps(_mm_set1_ps(-0.0f), x); }
+
+    inline __m128d _mm_abs_pd(__m128d x) noexcept { return _mm_andnot_pd(_mm_set1_pd(-0.0), x); }
+
+    // Magnitude of x with the sign of s.
+    inline __m128 _mm_copysign_ps(__m128 x, __m128 s) noexcept
+    {
+        const __m128 sign_mask = _mm_set1_ps(-0.0f);
+        return _mm_or_ps(_mm_andnot_ps(sign_mask, x), _mm_and_ps(sign_mask, s));
+    }
+
+    inline __m128d _mm_copysign_pd(__m128d x, __m128d s) noexcept
+    {
+        const __m128d sign_mask = _mm_set1_pd(-0.0);
+        return _mm_or_pd(_mm_andnot_pd(sign_mask, x), _mm_and_pd(sign_mask, s));
+    }
+
+    // 2^n for an integral n in [-126, 127].
+    inline __m128 _mm_pow2i_ps(__m128 n) noexcept
+    {
+        return _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(_mm_cvtps_epi32(n), _mm_set1_epi32(127)), 23));
+    }
+
+    // 2^n for an integral n in [-1022, 1023].
+    inline __m128d _mm_pow2i_pd(__m128d n) noexcept
+    {
+        const __m128i e = _mm_cvtepi32_epi64(_mm_cvtpd_epi32(n));
+        return _mm_castsi128_pd(_mm_slli_epi64(_mm_add_epi64(e, _mm_set1_epi64x(1023)), 52));
+    }
+
+    // floor(log2(x)) for a positive normal x.
+    inline __m128 _mm_exponent_ps(__m128 x) noexcept
+    {
+        return _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(_mm_castps_si128(x), 23), _mm_set1_epi32(127)));
+    }
+
+    inline __m128d _mm_exponent_pd(__m128d x) noexcept
+    {
+        // The biased exponent is moved into the mantissa of 2^52, no 64 bits integer conversion needed.
+        const __m128d two52 = _mm_set1_pd(4503599627370496.0);
+        const __m128i e = _mm_or_si128(_mm_srli_epi64(_mm_castpd_si128(x), 52), _mm_castpd_si128(two52));
+        return _mm_sub_pd(_mm_sub_pd(_mm_castsi128_pd(e), two52), _mm_set1_pd(1023.0));
+    }
+
+    // x / 2^floor(log2(x)), in [1, 2) for a positive normal x.
+    inline __m128 _mm_mantissa_ps(__m128 x) noexcept
+    {
+        const __m128i m = _mm_and_si128(_mm_castps_si128(x), _mm_set1_epi32(0x007FFFFF));
+        return _mm_castsi128_ps(_mm_or_si128(m, _mm_set1_epi32(0x3F800000)));
+    }
+
+    inline __m128d _mm_mantissa_pd(__m128d x) noexcept
+    {
+        const __m128i m = _mm_and_si128(_mm_castpd_si128(x), _mm_set1_epi64x(0x000FFFFFFFFFFFFFLL));
+        return _mm_castsi128_pd(_mm_or_si128(m, _mm_set1_epi64x(0x3FF0000000000000LL)));
+    }
+
+    // Comparisons return a lane mask, all bits set where true.
+    inline __m128 _mm_less_ps(__m128 a, __m128 b) noexcept { return _mm_cmplt_ps(a, b); }
+
+    inline __m128d _mm_less_pd(__m128d a, __m128d b) noexcept { return _mm_cmplt_pd(a, b); }
+
+    inline __m128 _mm_less_equal_ps(__m128 a, __m128 b) noexcept { return _mm_cmple_ps(a, b); }
+
+    inline __m128d _mm_less_equal_pd(__m128d a, __m128d b) noexcept { return _mm_cmple_pd(a, b); }
+
+    inline __m128 _mm_equal_ps(__m128 a, __m128 b) noexcept { return _mm_cmpeq_ps(a, b); }
+
+    inline __m128d _mm_equal_pd(__m128d a, __m128d b) noexcept { return _mm_cmpeq_pd(a, b); }
+
+    inline __m128 _mm_is_nan_ps(__m128 a) noexcept { return _mm_cmpunord_ps(a, a); }
+
+    inline __m128d _mm_is_nan_pd(__m128d a) noexcept { return _mm_cmpunord_pd(a, a); }
+
+    // a where the mask is set, b elsewhere.
+    inline __m128 _mm_select_ps(__m128 mask, __m128 a, __m128 b) noexcept { return _mm_blendv_ps(b, a, mask); }
+
+    inline __m128d _mm_select_pd(__m128d mask, __m128d a, __m128d b) noexcept { return _mm_blendv_pd(b, a, mask); }
+
+    inline __m128 _mm_or_mask_ps(__m128 a, __m128 b) noexcept { return _mm_or_ps(a, b); }
+
+    inline __m128d _mm_or_mask_pd(__m128d a, __m128d b) noexcept { return _mm_or_pd(a, b); }
+
+    inline __m128 _mm_and_mask_ps(__m128 a, __m128 b) noexcept { return _mm_and_ps(a, b); }
+
+    inline __m128d _mm_and_mask_pd(__m128d a, __m128d b) noexcept { return _mm_and_pd(a, b); }
+FST_END_SIMD_NAMESPACE
 
 #else
 #define FST_HAS_SIMD 0
@@ -12,7 +12,7 @@
 ///   #define FST_SIMD_VEC_VALUE_TYPE float
 ///   #define FST_SIMD_VEC_OP_PREFIX _mm_
 ///   #define FST_SIMD_VEC_SUFFIX _ps
-///   #include "fst/simd//detail/vector_op.h"
+///   #include "fst/detail/simd/vector_op.h"
 ///   #undef FST_SIMD_VEC_VECTOR_TYPE
 ///   #undef FST_SIMD_VEC_VALUE_TYPE
 ///   #undef FST_SIMD_VEC_OP_PREFIX
@@ -36,6 +36,12 @@ struct vector_op<FST_SIMD_VEC_VECTOR_TYPE, FST_SIMD_VEC_VALUE_TYPE>
 
     FST_ALWAYS_INLINE static void store(value_type* dst, vec_type src) noexcept { FST_SIMD_VEC_OP(store)(dst, src); }
 
+    // Loads the first count elements, the remaining lanes are set to zero.
+    FST_NODISCARD FST_ALWAYS_INLINE static vec_type load_partial(const value_type* ptr, size_t count) noexcept { return FST_SIMD_VEC_OP(load_partial)(ptr, count); }
+
+    // Stores the first count elements.
+    FST_ALWAYS_INLINE static void store_partial(value_type* dst, vec_type src, size_t count) noexcept { FST_SIMD_VEC_OP(store_partial)(dst, src, count); }
+
     FST_NODISCARD FST_ALWAYS_INLINE static vec_type add(vec_type a, vec_type b) noexcept { return FST_SIMD_VEC_OP(add)(a, b); }
 
     FST_NODISCARD FST_ALWAYS_INLINE static vec_type sub(vec_type a, vec_type b) noexcept { return FST_SIMD_VEC_OP(sub)(a, b); }
@@ -44,6 +50,11 @@ struct vector_op<FST_SIMD_VEC_VECTOR_TYPE, FST_SIMD_VEC_VALUE_TYPE>
 
     FST_NODISCARD FST_ALWAYS_INLINE static vec_type div(vec_type a, vec_type b) noexcept { return FST_SIMD_VEC_OP(div)(a, b); }
 
+    // a * b + c, a single fma instruction when available.
+    static constexpr bool fused_mul_add = FST_CONCAT(FST_SIMD_VEC_OP_PREFIX, fused_mul_add);
+
+    FST_NODISCARD FST_ALWAYS_INLINE static vec_type mul_add(vec_type a, vec_type b, vec_type c) noexcept { return FST_SIMD_VEC_OP(mul_add)(a, b, c); }
+
     FST_NODISCARD FST_ALWAYS_INLINE static vec_type sqrt(vec_type a) noexcept { return FST_SIMD_VEC_OP(sqrt)(a); }
 
     FST_NODISCARD FST_ALWAYS_INLINE static vec_type invsqrt(vec_type a) noexcept { return FST_SIMD_VEC_OP(invsqrt)(a); }
@@ -74,13 +85,39 @@ struct vector_op<FST_SIMD_VEC_VECTOR_TYPE, FST_SIMD_VEC_VALUE_TYPE>
 
     FST_NODISCARD FST_ALWAYS_INLINE static vec_type hadd(vec_type a, vec_type b) noexcept { return FST_SIMD_VEC_OP(hadd)(a, b); }
 
-    FST_NODISCARD FST_ALWAYS_INLINE static value_type hsum(vec_type a) noexcept
-    {
-        value_type out = 0;
-        for (size_t i = 0; i < size; i++)
-        {
-            out += ((const value_type*) &a)[i];
-        }
-        return out;
-    }
+    FST_NODISCARD FST_ALWAYS_INLINE static value_type hsum(vec_type a) noexcept { return FST_SIMD_VEC_OP(hsum)(a); }
+
+    // Building blocks of the fst/simd_math.h kernels.
+    FST_NODISCARD FST_ALWAYS_INLINE static vec_type nearest(vec_type a) noexcept { return FST_SIMD_VEC_OP(nearest)(a); }
+
+    FST_NODISCARD FST_ALWAYS_INLINE static vec_type floor(vec_type a) noexcept { return FST_SIMD_VEC_OP(floor)(a); }
+
+    FST_NODISCARD FST_ALWAYS_INLINE static vec_type abs(vec_type a) noexcept { return FST_SIMD_VEC_OP(abs)(a); }
+
+    FST_NODISCARD FST_ALWAYS_INLINE static vec_type copysign(vec_type a, vec_type b) noexcept { return FST_SIMD_VEC_OP(copysign)(a, b); }
+
+    FST_NODISCARD FST_ALWAYS_INLINE static vec_type pow2i(vec_type n) noexcept { return FST_SIMD_VEC_OP(pow2i)(n); }
+
+    FST_NODISCARD FST_ALWAYS_INLINE static vec_type exponent(vec_type a) noexcept { return FST_SIMD_VEC_OP(exponent)(a); }
+
+    FST_NODISCARD FST_ALWAYS_INLINE static vec_type mantissa(vec_type a) noexcept { return FST_SIMD_VEC_OP(mantissa)(a); }
+
+    using mask_type = decltype(FST_SIMD_VEC_OP(less)(__fst::declval<vec_type>(), __fst::declval<vec_type>()));
+
+    FST_NODISCARD FST_ALWAYS_INLINE static mask_type less(vec_type a, vec_type b) noexcept { return FST_SIMD_VEC_OP(less)(a, b); }
+
+    FST_NODISCARD FST_ALWAYS_INLINE static mask_type less_equal(vec_type a, vec_type b) noexcept { return FST_SIMD_VEC_OP(less_equal)(a, b); }
+
+    FST_NODISCARD FST_ALWAYS_INLINE static mask_type equal(vec_type a, vec_type b) noexcept { return FST_SIMD_VEC_OP(equal)(a, b); }
+
+    FST_NODISCARD FST_ALWAYS_INLINE static mask_type is_nan(vec_type a) noexcept { return FST_SIMD_VEC_OP(is_nan)(a); }
+
+    FST_NODISCARD FST_ALWAYS_INLINE static mask_type or_mask(mask_type a, mask_type b) noexcept { return FST_SIMD_VEC_OP(or_mask)(a, b); }
+
+    FST_NODISCARD FST_ALWAYS_INLINE static mask_type and_mask(mask_type a, mask_type b) noexcept { return FST_SIMD_VEC_OP(and_mask)(a, b); }
+
+    // a where mask is set, b elsewhere.
+    FST_NODISCARD FST_ALWAYS_INLINE static vec_type select(mask_type mask, vec_type a, vec_type b) noexcept { return FST_SIMD_VEC_OP(select)(mask, a, b); }
+
+#undef FST_SIMD_VEC_OP
 };
@@ -0,0 +1,413 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Alexandre Arsenault
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#pragma once
+
+#include "fst/common.h"
+#include "fst/memory.h"
+#include "fst/traits.h"
+#include "fst/utility.h"
+#include "fst/vector.h"
+
+#if __FST_MSVC__
+#include <intrin.h>
+#endif
+
+FST_BEGIN_NAMESPACE
+
+    namespace detail
+    {
+        template <class _Compare>
+        using compare_is_transparent_t = typename _Compare::is_transparent;
+
+        /// Both halves of the next step are fetched while the current comparison is resolved,
+        /// without it the branchless search waits on one cache miss per level on large tables.
+        FST_ALWAYS_INLINE void flat_prefetch(const void* ptr) noexcept
+        {
+#if __FST_MSVC__ && __FST_ARCH_INTEL__
+            _mm_prefetch((const char*) ptr, _MM_HINT_T0);
+#elif __FST_MSVC__
+            (void) ptr;
+#else
+            __builtin_prefetch(ptr);
+#endif
+        }
+
+        /// Index of the first key that is not less than key.
+        /// Branchless binary search, the comparison only selects the next base (cmov) so the loop
+        /// runs log2(size) times with no mispredicted jump.
+        template <class _Key, class K, class _Compare>
+        FST_NODISCARD FST_ALWAYS_INLINE size_t flat_lower_bound(const _Key* keys, size_t size, const K& key, const _Compare& comp) noexcept
+        {
+            if (!size) { return 0; }
+
+            const _Key* base = keys;
+            while (size > 1)
+            {
+                const size_t half = size / 2;
+                __fst::detail::flat_prefetch(base + half / 2);
+                __fst::detail::flat_prefetch(base + half + half / 2);
+                base = comp(base[half], key) ? base + half : base;
+                size -= half;
+            }
+
+            return (size_t) (base - keys) + (size_t) comp(*base, key);
+        }
+
+        /// Index of the first key that is greater than key.
+        template <class _Key, class K, class _Compare>
+        FST_NODISCARD FST_ALWAYS_INLINE size_t flat_upper_bound(const _Key* keys, size_t size, const K& key, const _Compare& comp) noexcept
+        {
+            if (!size) { return 0; }
+
+            const _Key* base = keys;
+            while (size > 1)
+            {
+                const size_t half = size / 2;
+                base = comp(key, base[half]) ? base : base + half;
+                size -= half;
+            }
+
+            return (size_t) (base - keys) + (size_t) !comp(key, *base);
+        }
+
+        /// Stable sort of indices by keys[index], insertion sorted runs followed by bottom-up merges.
+        /// tmp must hold at least count indices.
+        template <class _Key, class _Compare>
+        inline void flat_sort_indices(const _Key* keys, uint32_t* indices, uint32_t* tmp, size_t count, const _Compare& comp) noexcept
+        {
+            constexpr size_t run_size = 16;
+
+            for (size_t first = 0; first < count; first += run_size)
+            {
+                const size_t last = __fst::minimum(first + run_size, count);
+                for (size_t i = first + 1; i < last; i++)
+                {
+                    const uint32_t index = indices[i];
+                    size_t j = i;
+                    for (; j > first && comp(keys[index], keys[indices[j - 1]]); j--)
+                    {
+                        indices[j] = indices[j - 1];
+                    }
+                    indices[j] = index;
+                }
+            }
+
+            uint32_t* src = indices;
+            uint32_t* dst = tmp;
+
+            for (size_t width = run_size; width < count; width *= 2)
+            {
+                for (size_t first = 0; first < count; first += 2 * width)
+                {
+                    const size_t mid = __fst::minimum(first + width, count);
+                    const size_t last = __fst::minimum(first + 2 * width, count);
+
+                    size_t i = first;
+                    size_t j = mid;
+                    size_t k = first;
+
+                    while (i < mid && j < last)
+                    {
+                        dst[k++] = comp(keys[src[j]], keys[src[i]]) ? src[j++] : src[i++];
+                    }
+
+                    while (i < mid)
+                    {
+                        dst[k++] = src[i++];
+                    }
+
+                    while (j < last)
+                    {
+                        dst[k++] = src[j++];
+                    }
+                }
+
+                __fst::mem_swap(src, dst);
+            }
+
+            if (src != indices) { __fst::memcpy(indices, src, count * sizeof(uint32_t)); }
+        }
+    } // namespace detail
+
+    /// Ordered map stored as two sorted arrays (keys and values, like unordered_map).
+    /// Lookups are a binary search over the keys only, iteration is a plain walk over
+    /// the values in key order. Single inserts and erases shift the arrays, build large
+    /// tables with insert_range() which sorts the new entries and merges them in one pass.
+    template <class _Key, class _T, size_t _Alignment = alignof(_T), class _MemoryZone = __fst::default_memory_zone,
+        class _MemoryCategory = __fst::default_memory_category, class _Compare = __fst::less<_Key>>
+    class flat_map
+    {
+      public:
+        static_assert(__fst::is_power_of_two(_Alignment), "_Alignment must be a power of two");
+
+        using key_type = _Key;
+        using value_type = _T;
+        using key_compare = _Compare;
+
+        using size_type = size_t;
+        using difference_type = ptrdiff_t;
+
+        using pointer = value_type*;
+        using const_pointer = const value_type*;
+        using reference = value_type&;
+        using const_reference = __fst::cref_t<value_type>;
+
+        using iterator = pointer;
+        using const_iterator = const_pointer;
+
+        using key_const_reference = __fst::cref_t<key_type>;
+
+        using key_vector = __fst::vector<_Key, alignof(_Key), _MemoryCategory, _MemoryZone>;
+        using value_vector = __fst::vector<_T, _Alignment, _MemoryCategory, _MemoryZone>;
+
+        /// Heterogeneous lookup is enabled when the comparator defines is_transparent.
+        static constexpr bool is_transparent = __fst::is_detected_v<__fst::detail::compare_is_transparent_t, key_compare>;
+
+        template <class K>
+        using enable_if_lookup_key_t = __fst::enable_if_t<is_transparent && !__fst::is_same_v<__fst::remove_cvref_t<K>, key_type>, int>;
+
+        FST_NODISCARD FST_ALWAYS_INLINE constexpr size_type size() const noexcept { return _values.size(); }
+        FST_NODISCARD FST_ALWAYS_INLINE constexpr bool empty() const noexcept { return _values.empty(); }
+
+        FST_NODISCARD inline constexpr iterator begin() noexcept { return _values.begin(); }
+        FST_NODISCARD inline constexpr const_iterator begin() const noexcept { return _values.begin(); }
+
+        FST_NODISCARD inline constexpr iterator end() noexcept { return _values.end(); }
+        FST_NODISCARD inline constexpr const_iterator end() const noexcept { return _values.end(); }
+
+        FST_NODISCARD inline constexpr const_iterator cbegin() const noexcept { return begin(); }
+        FST_NODISCARD inline constexpr const_iterator cend() const noexcept { return end(); }
+
+        FST_NODISCARD constexpr reference front() noexcept { return _values.front(); }
+        FST_NODISCARD constexpr const_reference front() const noexcept { return _values.front(); }
+
+        FST_NODISCARD constexpr reference back() noexcept { return _values.back(); }
+        FST_NODISCARD constexpr const_reference back() const noexcept { return _values.back(); }
+
+        /// Key of the entry pointed to by it.
+        FST_NODISCARD FST_ALWAYS_INLINE key_const_reference key(const_iterator it) const noexcept { return _keys[(size_type) (it - begin())]; }
+
+        FST_NODISCARD inline iterator find(key_const_reference key) noexcept { return begin() + find_index(key); }
+        FST_NODISCARD inline const_iterator find(key_const_reference key) const noexcept { return begin() + find_index(key); }
+
+        template <class K, enable_if_lookup_key_t<K> = 0>
+        FST_NODISCARD inline iterator find(const K& key) noexcept
+        {
+            return begin() + find_index(key);
+        }
+
+        template <class K, enable_if_lookup_key_t<K> = 0>
+        FST_NODISCARD inline const_iterator find(const K& key) const noexcept
+        {
+            return begin() + find_index(key);
+        }
+
+        FST_NODISCARD FST_ALWAYS_INLINE bool contains(key_const_reference key) const noexcept { return find_index(key) != size(); }
+
+        template <class K, enable_if_lookup_key_t<K> = 0>
+        FST_NODISCARD FST_ALWAYS_INLINE bool contains(const K& key) const noexcept
+        {
+            return find_index(key) != size();
+        }
+
+        /// First entry whose key is not less than key.
+        FST_NODISCARD inline iterator lower_bound(key_const_reference key) noexcept { return begin() + lower_bound_index(key); }
+        FST_NODISCARD inline const_iterator lower_bound(key_const_reference key) const noexcept { return begin() + lower_bound_index(key); }
+
+        /// First entry whose key is greater than key.
+        FST_NODISCARD inline iterator upper_bound(key_const_reference key) noexcept
+        {
+            return begin() + __fst::detail::flat_upper_bound(_keys.data(), size(), key, key_compare{});
+        }
+
+        FST_NODISCARD inline const_iterator upper_bound(key_const_reference key) const noexcept
+        {
+            return begin() + __fst::detail::flat_upper_bound(_keys.data(), size(), key, key_compare{});
+        }
+
+        inline reference operator[](key_const_reference key) noexcept
+        {
+            const size_type index = lower_bound_index(key);
+            if (!is_match(index, key)) { insert_at(index, key, value_type{}); }
+            return _values[index];
+        }
+
+        template <class K = key_type, __fst::enable_if_t<!__fst::is_trivial_cref_v<K>, int> = 0>
+        inline reference operator[](key_type&& key) noexcept
+        {
+            const size_type index = lower_bound_index(key);
+            if (!is_match(index, key)) { insert_at(index, __fst::move(key), value_type{}); }
+            return _values[index];
+        }
+
+        inline void clear() noexcept
+        {
+            _keys.clear();
+            _values.clear();
+        }
+
+        inline void reserve(size_type count) noexcept
+        {
+            _keys.reserve(count);
+            _values.reserve(count);
+        }
+
+        /// Returns false if the key was already in the map, the value is not replaced.
+        template <class K, class V>
+        inline bool insert(K&& key, V&& value) noexcept
+        {
+            const size_type index = lower_bound_index(key);
+            if (is_match(index, key)) { return false; }
+
+            insert_at(index, __fst::forward<K>(key), value_type(__fst::forward<V>(value)));
+            return true;
+        }
+
+        template <class K, class... _Args>
+        inline bool emplace(K&& key, _Args&&... args) noexcept
+        {
+            const size_type index = lower_bound_index(key);
+            if (is_match(index, key)) { return false; }
+
+            insert_at(index, __fst::forward<K>(key), value_type(__fst::forward<_Args>(args)...));
+            return true;
+        }
+
+        /// Inserts count entries, keys that are already in the map or repeated in the range are
+        /// skipped (the first one wins). The new entries are sorted once and merged with the
+        /// current ones, O((size + count) + count log count) instead of count shifts.
+        inline void insert_range(const key_type* keys, const value_type* values, size_type count) noexcept
+        {
+            if (!count) { return; }
+
+            fst_assert(count <= (size_type) 0xFFFFFFFF, "flat_map::insert_range too many entries");
+
+            index_vector indices;
+            index_vector tmp;
+            indices.resize(count);
+            tmp.resize(count);
+
+            for (size_type i = 0; i < count; i++)
+            {
+                indices[i] = (uint32_t) i;
+            }
+
+            const key_compare comp{};
+            __fst::detail::flat_sort_indices(keys, indices.data(), tmp.data(), count, comp);
+
+            key_vector nkeys;
+            value_vector nvalues;
+            nkeys.reserve(size() + count);
+            nvalues.reserve(size() + count);
+
+            const size_type n = size();
+            size_type i = 0;
+
+            for (size_type j = 0; j < count; j++)
+            {
+                const key_type& key = keys[indices[j]];
+
+                for (; i < n && comp(_keys[i], key); i++)
+                {
+                    nkeys.push_back(__fst::move(_keys[i]));
+                    nvalues.push_back(__fst::move(_values[i]));
+                }
+
+                // Already in the map, or a repeated key of the range.
+                if ((i < n && !comp(key, _keys[i])) || (!nkeys.empty() && !comp(nkeys.back(), key))) { continue; }
+
+                nkeys.push_back(key);
+                nvalues.push_back(values[indices[j]]);
+            }
+
+            for (; i < n; i++)
+            {
+                nkeys.push_back(__fst::move(_keys[i]));
+                nvalues.push_back(__fst::move(_values[i]));
+            }
+
+            _keys = __fst::move(nkeys);
+            _values = __fst::move(nvalues);
+        }
+
+        inline size_type erase(key_const_reference key) noexcept { return erase_index(find_index(key)); }
+
+        template <class K, enable_if_lookup_key_t<K> = 0>
+        inline size_type erase(const K& key) noexcept
+        {
+            return erase_index(find_index(key));
+        }
+
+        inline size_type erase(const_iterator it) noexcept { return erase_index((size_type) (it - cbegin())); }
+
+        /// Sorted keys, keys()[i] is the key of values()[i].
+        FST_NODISCARD inline const key_vector& keys() const noexcept { return _keys; }
+        FST_NODISCARD inline const value_vector& values() const noexcept { return _values; }
+
+      private:
+        using index_vector = __fst::vector<uint32_t, alignof(uint32_t), _MemoryCategory, _MemoryZone>;
+
+        key_vector _keys;
+        value_vector _values;
+
+        template <class K>
+        FST_NODISCARD FST_ALWAYS_INLINE size_type lower_bound_index(const K& key) const noexcept
+        {
+            return __fst::detail::flat_lower_bound(_keys.data(), size(), key, key_compare{});
+        }
+
+        template <class K>
+        FST_NODISCARD FST_ALWAYS_INLINE bool is_match(size_type index, const K& key) const noexcept
+        {
+            return index < size() && !key_compare{}(key, _keys[index]);
+        }
+
+        /// Index of key or size() when it is not in the map.
+        template <class K>
+        FST_NODISCARD FST_ALWAYS_INLINE size_type find_index(const K& key) const noexcept
+        {
+            const size_type index = lower_bound_index(key);
+            return is_match(index, key) ? index : size();
+        }
+
+        template <class K>
+        inline void insert_at(size_type index, K&& key, value_type&& value) noexcept
+        {
+            _keys.insert(_keys.begin() + index, __fst::forward<K>(key));
+            _values.insert(_values.begin() + index, __fst::move(value));
+        }
+
+        inline size_type erase_index(size_type index) noexcept
+        {
+            if (index >= size()) { return 0; }
+
+            _keys.erase_at(index);
+            _values.erase_at(index);
+            return 1;
+        }
+    };
+
+FST_END_NAMESPACE
@@ -0,0 +1,218 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Alexandre Arsenault
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#pragma once
+
+#include "fst/common.h"
+#include "fst/flat_map.h"
+#include "fst/memory.h"
+#include "fst/traits.h"
+#include "fst/utility.h"
+#include "fst/vector.h"
+
+FST_BEGIN_NAMESPACE
+
+    /// Ordered set stored as a sorted array, see flat_map.
+    template <class _Key, size_t _Alignment = alignof(_Key), class _MemoryZone = __fst::default_memory_zone,
+        class _MemoryCategory = __fst::default_memory_category, class _Compare = __fst::less<_Key>>
+    class flat_set
+    {
+      public:
+        static_assert(__fst::is_power_of_two(_Alignment), "_Alignment must be a power of two");
+
+        using key_type = _Key;
+        using value_type = _Key;
+        using key_compare = _Compare;
+
+        using size_type = size_t;
+        using difference_type = ptrdiff_t;
+
+        using pointer = const value_type*;
+        using const_pointer = const value_type*;
+        using reference = const value_type&;
+        using const_reference = __fst::cref_t<value_type>;
+
+        /// Keys can't be modified in place, they would break the order.
+        using iterator = const_pointer;
+        using const_iterator = const_pointer;
+
+        using key_const_reference = __fst::cref_t<key_type>;
+        using key_vector = __fst::vector<_Key, _Alignment, _MemoryCategory, _MemoryZone>;
+
+        /// Heterogeneous lookup is enabled when the comparator defines is_transparent.
+        static constexpr bool is_transparent = __fst::is_detected_v<__fst::detail::compare_is_transparent_t, key_compare>;
+
+        template <class K>
+        using enable_if_lookup_key_t = __fst::enable_if_t<is_transparent && !__fst::is_same_v<__fst::remove_cvref_t<K>, key_type>, int>;
+
+        FST_NODISCARD FST_ALWAYS_INLINE constexpr size_type size() const noexcept { return _keys.size(); }
+        FST_NODISCARD FST_ALWAYS_INLINE constexpr bool empty() const noexcept { return _keys.empty(); }
+
+        FST_NODISCARD FST_ALWAYS_INLINE constexpr const_pointer data() const noexcept { return _keys.data(); }
+
+        FST_NODISCARD inline constexpr const_iterator begin() const noexcept { return _keys.begin(); }
+        FST_NODISCARD inline constexpr const_iterator end() const noexcept { return _keys.end(); }
+
+        FST_NODISCARD inline constexpr const_iterator cbegin() const noexcept { return begin(); }
+        FST_NODISCARD inline constexpr const_iterator cend() const noexcept { return end(); }
+
+        FST_NODISCARD constexpr const_reference front() const noexcept { return _keys.front(); }
+        FST_NODISCARD constexpr const_reference back() const noexcept { return _keys.back(); }
+
+        FST_NODISCARD FST_ALWAYS_INLINE const_reference operator[](size_type index) const noexcept { return _keys[index]; }
+
+        FST_NODISCARD inline const_iterator find(key_const_reference key) const noexcept { return begin() + find_index(key); }
+
+        template <class K, enable_if_lookup_key_t<K> = 0>
+        FST_NODISCARD inline const_iterator find(const K& key) const noexcept
+        {
+            return begin() + find_index(key);
+        }
+
+        FST_NODISCARD FST_ALWAYS_INLINE bool contains(key_const_reference key) const noexcept { return find_index(key) != size(); }
+
+        template <class K, enable_if_lookup_key_t<K> = 0>
+        FST_NODISCARD FST_ALWAYS_INLINE bool contains(const K& key) const noexcept
+        {
+            return find_index(key) != size();
+        }
+
+        /// First key that is not less than key.
+        FST_NODISCARD inline const_iterator lower_bound(key_const_reference key) const noexcept { return begin() + lower_bound_index(key); }
+
+        /// First key that is greater than key.
+        FST_NODISCARD inline const_iterator upper_bound(key_const_reference key) const noexcept
+        {
+            return begin() + __fst::detail::flat_upper_bound(_keys.data(), size(), key, key_compare{});
+        }
+
+        inline void clear() noexcept { _keys.clear(); }
+        inline void reserve(size_type count) noexcept { _keys.reserve(count); }
+
+        /// Returns false if the key was already in the set.
+        template <class K>
+        inline bool insert(K&& key) noexcept
+        {
+            const size_type index = lower_bound_index(key);
+            if (is_match(index, key)) { return false; }
+
+            _keys.insert(_keys.begin() + index, __fst::forward<K>(key));
+            return true;
+        }
+
+        /// Inserts count keys, sorted once and merged with the current ones (see flat_map::insert_range).
+        inline void insert_range(const key_type* keys, size_type count) noexcept
+        {
+            if (!count) { return; }
+
+            fst_assert(count <= (size_type) 0xFFFFFFFF, "flat_set::insert_range too many keys");
+
+            index_vector indices;
+            index_vector tmp;
+            indices.resize(count);
+            tmp.resize(count);
+
+            for (size_type i = 0; i < count; i++)
+            {
+                indices[i] = (uint32_t) i;
+            }
+
+            const key_compare comp{};
+            __fst::detail::flat_sort_indices(keys, indices.data(), tmp.data(), count, comp);
+
+            key_vector nkeys;
+            nkeys.reserve(size() + count);
+
+            const size_type n = size();
+            size_type i = 0;
+
+            for (size_type j = 0; j < count; j++)
+            {
+                const key_type& key = keys[indices[j]];
+
+                for (; i < n && comp(_keys[i], key); i++)
+                {
+                    nkeys.push_back(__fst::move(_keys[i]));
+                }
+
+                if ((i < n && !comp(key, _keys[i])) || (!nkeys.empty() && !comp(nkeys.back(), key))) { continue; }
+
+                nkeys.push_back(key);
+            }
+
+            for (; i < n; i++)
+            {
+                nkeys.push_back(__fst::move(_keys[i]));
+            }
+
+            _keys = __fst::move(nkeys);
+        }
+
+        inline size_type erase(key_const_reference key) noexcept { return erase_index(find_index(key)); }
+
+        template <class K, enable_if_lookup_key_t<K> = 0>
+        inline size_type erase(const K& key) noexcept
+        {
+            return erase_index(find_index(key));
+        }
+
+        inline size_type erase(const_iterator it) noexcept { return erase_index((size_type) (it - cbegin())); }
+
+        FST_NODISCARD inline const key_vector& keys() const noexcept { return _keys; }
+
+      private:
+        using index_vector = __fst::vector<uint32_t, alignof(uint32_t), _MemoryCategory, _MemoryZone>;
+
+        key_vector _keys;
+
+        template <class K>
+        FST_NODISCARD FST_ALWAYS_INLINE size_type lower_bound_index(const K& key) const noexcept
+        {
+            return __fst::detail::flat_lower_bound(_keys.data(), size(), key, key_compare{});
+        }
+
+        template <class K>
+        FST_NODISCARD FST_ALWAYS_INLINE bool is_match(size_type index, const K& key) const noexcept
+        {
+            return index < size() && !key_compare{}(key, _keys[index]);
+        }
+
+        template <class K>
+        FST_NODISCARD FST_ALWAYS_INLINE size_type find_index(const K& key) const noexcept
+        {
+            const size_type index = lower_bound_index(key);
+            return is_match(index, key) ? index : size();
+        }
+
+        inline size_type erase_index(size_type index) noexcept
+        {
+            if (index >= size()) { return 0; }
+
+            _keys.erase_at(index);
+            return 1;
+        }
+    };
+
+FST_END_NAMESPACE
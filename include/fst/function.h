@@ -364,4 +364,170 @@ FST_BEGIN_NAMESPACE
         }
     };
 
+    template <class _Sig, size_t _Size = 32, size_t _Alignment = alignof(__fst::max_align_t)>
+    class inplace_function;
+
+    /// Move-only function whose callable is always stored inline.
+    ///
+    /// Calls go through a single function pointer (no type switch, no virtual call) and a
+    /// callable bigger than _Size bytes doesn't compile: inplace_function never allocates.
+    /// Moving and destroying go through a second pointer that is null for trivially
+    /// copyable callables (function pointers, lambdas capturing pointers or scalars).
+    template <class R, class... _Args, size_t _Size, size_t _Alignment>
+    class inplace_function<R(_Args...), _Size, _Alignment>
+    {
+      public:
+        static_assert(__fst::is_power_of_two(_Alignment), "_Alignment must be a power of two");
+
+        static constexpr size_t capacity = _Size;
+        static constexpr size_t alignment = _Alignment;
+
+        inline inplace_function() noexcept = default;
+        inline inplace_function(__fst::nullptr_t) noexcept {}
+
+        template <class _Fct, class _Decayed = __fst::decay_t<_Fct>,
+            __fst::enable_if_t<!__fst::is_same_v<_Decayed, inplace_function> && __fst::is_invocable_r_v<R, _Decayed&, _Args...>, int> = 0>
+        inline inplace_function(_Fct&& fct) noexcept
+        {
+            static_assert(sizeof(_Decayed) <= _Size, "Callable too big for inplace_function, increase _Size.");
+            static_assert(_Alignment % alignof(_Decayed) == 0, "Callable alignment not supported by inplace_function, increase _Alignment.");
+
+            fst_placement_new(_data) _Decayed(__fst::forward<_Fct>(fct));
+            _invoke = &invoke_impl<_Decayed>;
+
+            if constexpr (!__fst::is_trivially_copyable_v<_Decayed> || !__fst::is_trivially_destructible_v<_Decayed>) { _manage = &manage_impl<_Decayed>; }
+        }
+
+        inplace_function(const inplace_function&) = delete;
+        inplace_function& operator=(const inplace_function&) = delete;
+
+        inline inplace_function(inplace_function&& other) noexcept { move_from(other); }
+
+        inline ~inplace_function() noexcept { reset(); }
+
+        inline inplace_function& operator=(inplace_function&& other) noexcept
+        {
+            if (this != &other)
+            {
+                reset();
+                move_from(other);
+            }
+
+            return *this;
+        }
+
+        inline inplace_function& operator=(__fst::nullptr_t) noexcept
+        {
+            reset();
+            return *this;
+        }
+
+        FST_ALWAYS_INLINE R operator()(_Args... args) const noexcept { return _invoke((void*) _data, __fst::forward<_Args>(args)...); }
+
+        FST_NODISCARD FST_ALWAYS_INLINE explicit operator bool() const noexcept { return _invoke != &invoke_empty; }
+
+        inline void reset() noexcept
+        {
+            if (_manage) { _manage(nullptr, _data); }
+
+            _invoke = &invoke_empty;
+            _manage = nullptr;
+        }
+
+      private:
+        using invoke_type = R (*)(void*, _Args...);
+
+        /// Moves src into dst and destroys src, or only destroys src when dst is null.
+        using manage_type = void (*)(void*, void*);
+
+        alignas(_Alignment) __fst::byte _data[_Size];
+        invoke_type _invoke = &invoke_empty;
+        manage_type _manage = nullptr;
+
+        static R invoke_empty(void*, _Args...) noexcept
+        {
+            // There's no R to return, it can be a reference or have no default constructor.
+            fst_error("call to an empty inplace_function");
+            FST_ABORT();
+        }
+
+        template <class _Fct>
+        static R invoke_impl(void* data, _Args... args) noexcept
+        {
+            // A void signature accepts any callable and drops its result.
+            if constexpr (__fst::is_void_v<R>) { (void) (*(_Fct*) data)(__fst::forward<_Args>(args)...); }
+            else { return (*(_Fct*) data)(__fst::forward<_Args>(args)...); }
+        }
+
+        template <class _Fct>
+        static void manage_impl(void* dst, void* src) noexcept
+        {
+            if (dst) { fst_placement_new(dst) _Fct(__fst::move(*(_Fct*) src)); }
+            ((_Fct*) src)->~_Fct();
+        }
+
+        inline void move_from(inplace_function& other) noexcept
+        {
+            if (other._manage) { other._manage(_data, other._data); }
+            else { __fst::memcpy(_data, other._data, _Size); }
+
+            _invoke = __fst::exchange(other._invoke, &invoke_empty);
+            _manage = __fst::exchange(other._manage, nullptr);
+        }
+    };
+
+    template <class _Sig>
+    class function_ref;
+
+    /// Non-owning reference to a callable, two pointers and never any allocation.
+    /// The referenced callable must outlive the function_ref, only use it for parameters
+    /// and never keep one that was built from a temporary.
+    template <class R, class... _Args>
+    class function_ref<R(_Args...)>
+    {
+      public:
+        using function_pointer = R (*)(_Args...);
+
+        template <class _Fct, class _Decayed = __fst::remove_cvref_t<_Fct>,
+            __fst::enable_if_t<!__fst::is_same_v<_Decayed, function_ref> && !__fst::is_pointer_v<_Decayed> && !__fst::is_function_v<_Decayed> && __fst::is_invocable_r_v<R, _Fct&, _Args...>, int> = 0>
+        FST_ALWAYS_INLINE function_ref(_Fct&& fct) noexcept
+            : _invoke(&invoke_object<__fst::remove_reference_t<_Fct>>)
+        {
+            _target.object = (void*) __fst::addressof(fct);
+        }
+
+        FST_ALWAYS_INLINE function_ref(function_pointer fct) noexcept
+            : _invoke(&invoke_pointer)
+        {
+            fst_assert(fct, "function_ref to a null function pointer");
+            _target.pointer = fct;
+        }
+
+        function_ref(const function_ref&) noexcept = default;
+        function_ref& operator=(const function_ref&) noexcept = default;
+
+        FST_ALWAYS_INLINE R operator()(_Args... args) const noexcept { return _invoke(_target, __fst::forward<_Args>(args)...); }
+
+      private:
+        union target
+        {
+            void* object;
+            function_pointer pointer;
+        };
+
+        using invoke_type = R (*)(target, _Args...);
+
+        target _target;
+        invoke_type _invoke;
+
+        template <class _Fct>
+        static R invoke_object(target t, _Args... args) noexcept
+        {
+            if constexpr (__fst::is_void_v<R>) { (void) (*(_Fct*) t.object)(__fst::forward<_Args>(args)...); }
+            else { return (*(_Fct*) t.object)(__fst::forward<_Args>(args)...); }
+        }
+
+        static R invoke_pointer(target t, _Args... args) noexcept { return t.pointer(__fst::forward<_Args>(args)...); }
+    };
+
 FST_END_NAMESPACE
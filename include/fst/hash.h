@@ -0,0 +1,390 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Alexandre Arsenault
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#pragma once
+
+#include "fst/common.h"
+#include "fst/traits.h"
+
+#if __FST_ARCH_INTEL__ && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP == 2))
+#define __FST_HASH_SSE2__ 1
+#include <emmintrin.h>
+#else
+#define __FST_HASH_SSE2__ 0
+#endif
+
+#if __FST_HASH_SSE2__ && defined(__AVX2__)
+#define __FST_HASH_AVX2__ 1
+#include <immintrin.h>
+#else
+#define __FST_HASH_AVX2__ 0
+#endif
+
+#if __FST_MSVC__
+#include <intrin.h>
+#endif
+
+//
+// 64-bit non-cryptographic hashing.
+//
+// Short inputs (up to 256 bytes) follow wyhash: a few 64x64->128 bit multiplications
+// folded back to 64 bits, with three independent lanes for inputs longer than 48 bytes.
+// Longer inputs are first accumulated 64 bytes at a time into eight 64-bit lanes like
+// xxh3 does (32x32->64 bit multiplications, sse2 or avx2 when available), the lanes are
+// then folded into the seed and the tail goes through the short path.
+//
+// Every path produces the same value, hash_string() can be evaluated at compile time
+// and matches hash_bytes() on the same characters at runtime (little endian byte order).
+// The values are not stable across versions, don't store them.
+//
+// @see https://github.com/wangyi-fudan/wyhash
+// @see https://github.com/Cyan4973/xxHash
+//
+FST_BEGIN_NAMESPACE
+
+    namespace detail
+    {
+        FST_INLINE_VAR constexpr uint64_t hash_secret[4] = { 0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull };
+
+        FST_INLINE_VAR constexpr uint64_t hash_stripe_key[8] = { 0xd79903199bef16ecull, 0x5bfe073500364553ull, 0x5366a98817c3ce05ull, 0x61227e5520887b31ull,
+            0xf49205e7d12a9a47ull, 0x40bb66b1dbf0a186ull, 0x594eb98c3d4792e0ull, 0xa171f8428ac4258eull };
+
+        FST_INLINE_VAR constexpr uint64_t hash_scramble_key[8] = { 0x7ac02b0145d380ddull, 0x306aa3c8180f0746ull, 0xb92670a1129804b5ull, 0xe8bfdeae7ceaae73ull,
+            0x4d5757931ee10004ull, 0xb86ca4af90c62bb6ull, 0x6b8f5b860dee9c02ull, 0x14ba96312cd7efa5ull };
+
+        FST_INLINE_VAR constexpr uint64_t hash_scramble_prime = 0x9E3779B1ull;
+
+        /// Inputs longer than this go through the accumulator path.
+        FST_INLINE_VAR constexpr size_t hash_long_threshold = 256;
+        FST_INLINE_VAR constexpr size_t hash_stripe_size = 64;
+        FST_INLINE_VAR constexpr size_t hash_stripes_per_block = 16;
+
+        /// 64x64->128 bit multiplication, a gets the low half and b the high half.
+        FST_ALWAYS_INLINE constexpr void hash_mum(uint64_t& a, uint64_t& b) noexcept
+        {
+#if defined(__SIZEOF_INT128__)
+            // __extension__ keeps -Wpedantic quiet about __int128.
+            __extension__ using uint128 = unsigned __int128;
+            const uint128 r = (uint128) a * b;
+            a = (uint64_t) r;
+            b = (uint64_t) (r >> 64);
+#else
+#if __FST_MSVC__ && defined(_M_X64)
+            if (!__fst::is_constant_evaluated())
+            {
+                a = _umul128(a, b, &b);
+                return;
+            }
+#endif
+            const uint64_t ha = a >> 32, hb = b >> 32, la = (uint32_t) a, lb = (uint32_t) b;
+            const uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+            const uint64_t t = rl + (rm0 << 32);
+            const uint64_t lo = t + (rm1 << 32);
+            const uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + (uint64_t) (t < rl) + (uint64_t) (lo < t);
+            a = lo;
+            b = hi;
+#endif
+        }
+
+        FST_NODISCARD FST_ALWAYS_INLINE constexpr uint64_t hash_mix(uint64_t a, uint64_t b) noexcept
+        {
+            __fst::detail::hash_mum(a, b);
+            return a ^ b;
+        }
+
+        /// Reads little endian words from raw memory.
+        struct hash_memory_reader
+        {
+            const uint8_t* data;
+
+            FST_NODISCARD FST_ALWAYS_INLINE uint64_t r8(size_t offset) const noexcept
+            {
+                uint64_t v;
+                __fst::memcpy(&v, data + offset, sizeof(v));
+                return v;
+            }
+
+            FST_NODISCARD FST_ALWAYS_INLINE uint64_t r4(size_t offset) const noexcept
+            {
+                uint32_t v;
+                __fst::memcpy(&v, data + offset, sizeof(v));
+                return v;
+            }
+
+            FST_NODISCARD FST_ALWAYS_INLINE uint64_t r1(size_t offset) const noexcept { return data[offset]; }
+        };
+
+        /// Reads the bytes of a character array one at a time, usable in constant expressions.
+        template <class _CharT>
+        struct hash_constexpr_reader
+        {
+            const _CharT* data;
+
+            FST_NODISCARD FST_ALWAYS_INLINE constexpr uint64_t r1(size_t offset) const noexcept
+            {
+                return ((uint64_t) data[offset / sizeof(_CharT)] >> (8 * (offset % sizeof(_CharT)))) & 0xFF;
+            }
+
+            FST_NODISCARD FST_ALWAYS_INLINE constexpr uint64_t r4(size_t offset) const noexcept
+            {
+                return r1(offset) | (r1(offset + 1) << 8) | (r1(offset + 2) << 16) | (r1(offset + 3) << 24);
+            }
+
+            FST_NODISCARD FST_ALWAYS_INLINE constexpr uint64_t r8(size_t offset) const noexcept { return r4(offset) | (r4(offset + 4) << 32); }
+        };
+
+        template <class _Reader>
+        FST_ALWAYS_INLINE constexpr void hash_accumulate_stripe(uint64_t* acc, const _Reader& reader, size_t offset) noexcept
+        {
+            for (size_t i = 0; i < 8; i++)
+            {
+                const uint64_t d = reader.r8(offset + i * 8);
+                const uint64_t k = d ^ hash_stripe_key[i];
+                acc[i] += (k & 0xFFFFFFFFull) * (k >> 32) + reader.r8(offset + (i ^ 1) * 8);
+            }
+        }
+
+        FST_ALWAYS_INLINE constexpr void hash_scramble(uint64_t* acc) noexcept
+        {
+            for (size_t i = 0; i < 8; i++)
+            {
+                uint64_t a = acc[i];
+                a ^= a >> 47;
+                a ^= hash_scramble_key[i];
+                acc[i] = a * hash_scramble_prime;
+            }
+        }
+
+        /// Accumulates stripe_count stripes, the lanes are scrambled after every full block.
+        template <class _Reader>
+        constexpr void hash_accumulate(uint64_t* acc, const _Reader& reader, size_t stripe_count) noexcept
+        {
+            for (size_t s = 0; s < stripe_count; s++)
+            {
+                __fst::detail::hash_accumulate_stripe(acc, reader, s * hash_stripe_size);
+                if ((s + 1) % hash_stripes_per_block == 0) { __fst::detail::hash_scramble(acc); }
+            }
+        }
+
+#if __FST_HASH_AVX2__
+        inline void hash_accumulate_simd(uint64_t* acc, const uint8_t* data, size_t stripe_count) noexcept
+        {
+            __m256i a[2] = { _mm256_loadu_si256((const __m256i*) acc), _mm256_loadu_si256((const __m256i*) (acc + 4)) };
+            const __m256i key[2] = { _mm256_loadu_si256((const __m256i*) hash_stripe_key), _mm256_loadu_si256((const __m256i*) (hash_stripe_key + 4)) };
+            const __m256i skey[2] = { _mm256_loadu_si256((const __m256i*) hash_scramble_key), _mm256_loadu_si256((const __m256i*) (hash_scramble_key + 4)) };
+            const __m256i prime = _mm256_set1_epi32((int) hash_scramble_prime);
+
+            for (size_t s = 0; s < stripe_count; s++)
+            {
+                const uint8_t* p = data + s * hash_stripe_size;
+                for (size_t i = 0; i < 2; i++)
+                {
+                    const __m256i d = _mm256_loadu_si256((const __m256i*) (p + i * 32));
+                    const __m256i k = _mm256_xor_si256(d, key[i]);
+                    const __m256i product = _mm256_mul_epu32(k, _mm256_srli_epi64(k, 32));
+                    const __m256i swapped = _mm256_shuffle_epi32(d, _MM_SHUFFLE(1, 0, 3, 2));
+                    a[i] = _mm256_add_epi64(a[i], _mm256_add_epi64(product, swapped));
+                }
+
+                if ((s + 1) % hash_stripes_per_block == 0)
+                {
+                    for (size_t i = 0; i < 2; i++)
+                    {
+                        const __m256i v = _mm256_xor_si256(_mm256_xor_si256(a[i], _mm256_srli_epi64(a[i], 47)), skey[i]);
+                        const __m256i lo = _mm256_mul_epu32(v, prime);
+                        const __m256i hi = _mm256_mul_epu32(_mm256_srli_epi64(v, 32), prime);
+                        a[i] = _mm256_add_epi64(lo, _mm256_slli_epi64(hi, 32));
+                    }
+                }
+            }
+
+            _mm256_storeu_si256((__m256i*) acc, a[0]);
+            _mm256_storeu_si256((__m256i*) (acc + 4), a[1]);
+        }
+
+#elif __FST_HASH_SSE2__
+        inline void hash_accumulate_simd(uint64_t* acc, const uint8_t* data, size_t stripe_count) noexcept
+        {
+            __m128i a[4];
+            __m128i key[4];
+            __m128i skey[4];
+            for (size_t i = 0; i < 4; i++)
+            {
+                a[i] = _mm_loadu_si128((const __m128i*) (acc + i * 2));
+                key[i] = _mm_loadu_si128((const __m128i*) (hash_stripe_key + i * 2));
+                skey[i] = _mm_loadu_si128((const __m128i*) (hash_scramble_key + i * 2));
+            }
+
+            const __m128i prime = _mm_set1_epi32((int) hash_scramble_prime);
+
+            for (size_t s = 0; s < stripe_count; s++)
+            {
+                const uint8_t* p = data + s * hash_stripe_size;
+                for (size_t i = 0; i < 4; i++)
+                {
+                    const __m128i d = _mm_loadu_si128((const __m128i*) (p + i * 16));
+                    const __m128i k = _mm_xor_si128(d, key[i]);
+                    const __m128i product = _mm_mul_epu32(k, _mm_srli_epi64(k, 32));
+                    const __m128i swapped = _mm_shuffle_epi32(d, _MM_SHUFFLE(1, 0, 3, 2));
+                    a[i] = _mm_add_epi64(a[i], _mm_add_epi64(product, swapped));
+                }
+
+                if ((s + 1) % hash_stripes_per_block == 0)
+                {
+                    for (size_t i = 0; i < 4; i++)
+                    {
+                        const __m128i v = _mm_xor_si128(_mm_xor_si128(a[i], _mm_srli_epi64(a[i], 47)), skey[i]);
+                        const __m128i lo = _mm_mul_epu32(v, prime);
+                        const __m128i hi = _mm_mul_epu32(_mm_srli_epi64(v, 32), prime);
+                        a[i] = _mm_add_epi64(lo, _mm_slli_epi64(hi, 32));
+                    }
+                }
+            }
+
+            for (size_t i = 0; i < 4; i++)
+            {
+                _mm_storeu_si128((__m128i*) (acc + i * 2), a[i]);
+            }
+        }
+#endif
+
+        template <class _Reader>
+        FST_NODISCARD constexpr uint64_t hash_impl(const _Reader& reader, size_t size, uint64_t seed) noexcept
+        {
+            seed ^= __fst::detail::hash_mix(seed ^ hash_secret[0], hash_secret[1]);
+
+            uint64_t a = 0;
+            uint64_t b = 0;
+
+            if (size <= 16)
+            {
+                if (size >= 4)
+                {
+                    const size_t shift = (size >> 3) << 2;
+                    a = (reader.r4(0) << 32) | reader.r4(shift);
+                    b = (reader.r4(size - 4) << 32) | reader.r4(size - 4 - shift);
+                }
+                else if (size > 0) { a = (reader.r1(0) << 16) | (reader.r1(size >> 1) << 8) | reader.r1(size - 1); }
+            }
+            else
+            {
+                size_t offset = 0;
+                size_t left = size;
+
+                if (size > hash_long_threshold)
+                {
+                    uint64_t acc[8] = { seed, seed ^ hash_secret[0], seed ^ hash_secret[1], seed ^ hash_secret[2], seed ^ hash_secret[3], ~seed, seed + hash_secret[0],
+                        seed - hash_secret[1] };
+
+                    // Always leave a tail for the short path.
+                    const size_t stripe_count = (size - 1) / hash_stripe_size;
+
+                    if constexpr (__fst::is_same_v<_Reader, hash_memory_reader> && (__FST_HASH_SSE2__ || __FST_HASH_AVX2__))
+                    {
+#if __FST_HASH_SSE2__ || __FST_HASH_AVX2__
+                        __fst::detail::hash_accumulate_simd(acc, reader.data, stripe_count);
+#endif
+                    }
+                    else { __fst::detail::hash_accumulate(acc, reader, stripe_count); }
+
+                    for (size_t i = 0; i < 8; i += 2)
+                    {
+                        seed = __fst::detail::hash_mix(acc[i] ^ hash_secret[1], acc[i + 1] ^ seed);
+                    }
+
+                    offset = stripe_count * hash_stripe_size;
+                    left = size - offset;
+                }
+
+                if (left > 48)
+                {
+                    uint64_t see1 = seed;
+                    uint64_t see2 = seed;
+                    do
+                    {
+                        seed = __fst::detail::hash_mix(reader.r8(offset) ^ hash_secret[1], reader.r8(offset + 8) ^ seed);
+                        see1 = __fst::detail::hash_mix(reader.r8(offset + 16) ^ hash_secret[2], reader.r8(offset + 24) ^ see1);
+                        see2 = __fst::detail::hash_mix(reader.r8(offset + 32) ^ hash_secret[3], reader.r8(offset + 40) ^ see2);
+                        offset += 48;
+                        left -= 48;
+                    } while (left > 48);
+
+                    seed ^= see1 ^ see2;
+                }
+
+                while (left > 16)
+                {
+                    seed = __fst::detail::hash_mix(reader.r8(offset) ^ hash_secret[1], reader.r8(offset + 8) ^ seed);
+                    offset += 16;
+                    left -= 16;
+                }
+
+                // The last 16 bytes, they may overlap with bytes that were already mixed.
+                a = reader.r8(size - 16);
+                b = reader.r8(size - 8);
+            }
+
+            a ^= hash_secret[1];
+            b ^= seed;
+            __fst::detail::hash_mum(a, b);
+            return __fst::detail::hash_mix(a ^ hash_secret[0] ^ size, b ^ hash_secret[1]);
+        }
+    } // namespace detail.
+
+    /// Hashes size bytes.
+    FST_NODISCARD inline uint64_t hash_bytes(const void* data, size_t size, uint64_t seed = 0) noexcept
+    {
+        return __fst::detail::hash_impl(__fst::detail::hash_memory_reader{ (const uint8_t*) data }, size, seed);
+    }
+
+    /// Hashes size characters, same value as hash_bytes(str, size * sizeof(_CharT), seed)
+    /// but can also be evaluated at compile time (e.g. for switch cases on string keys).
+    template <class _CharT>
+    FST_NODISCARD inline constexpr uint64_t hash_string(const _CharT* str, size_t size, uint64_t seed = 0) noexcept
+    {
+        if (__fst::is_constant_evaluated()) { return __fst::detail::hash_impl(__fst::detail::hash_constexpr_reader<_CharT>{ str }, size * sizeof(_CharT), seed); }
+        return __fst::hash_bytes(str, size * sizeof(_CharT), seed);
+    }
+
+    /// Hashes a string literal, the null terminator is not part of the hash.
+    template <class _CharT, size_t _Size>
+    FST_NODISCARD inline constexpr uint64_t hash_string(const _CharT (&str)[_Size]) noexcept
+    {
+        return __fst::hash_string((const _CharT*) str, _Size - 1);
+    }
+
+    /// Hashes a 64-bit value.
+    FST_NODISCARD FST_ALWAYS_INLINE constexpr uint64_t hash_int(uint64_t value, uint64_t seed = 0) noexcept
+    {
+        return __fst::detail::hash_mix(value ^ __fst::detail::hash_secret[0], seed ^ __fst::detail::hash_secret[1]);
+    }
+
+    /// Combines two hashes, the order matters.
+    FST_NODISCARD FST_ALWAYS_INLINE constexpr uint64_t hash_combine(uint64_t seed, uint64_t hash) noexcept
+    {
+        return __fst::detail::hash_mix(seed ^ __fst::detail::hash_secret[2], hash ^ __fst::detail::hash_secret[3]);
+    }
+
+FST_END_NAMESPACE
@@ -140,21 +140,13 @@ FST_BEGIN_SUB_NAMESPACE(lua)
         {
             if (nsize == 0)
             {
-                if (ptr) { _data.second().deallocate(ptr, _MemoryCategory::id()); }
+                if (ptr) { _data.second().aligned_deallocate(ptr, _MemoryCategory::id()); }
                 return nullptr;
             }
             else if (ptr && osize >= nsize) { return ptr; }
 
-            void* pdata = _data.second().allocate(nsize, _MemoryCategory::id());
-            if (!pdata) { return nullptr; }
-
-            if (ptr)
-            {
-                __fst::memcpy(pdata, ptr, osize);
-                _data.second().deallocate(ptr, _MemoryCategory::id());
-            }
-
-            return pdata;
+            // When ptr is null, osize is the lua type of the new object.
+            return __fst::memory_zone_reallocate(_data.second(), ptr, ptr ? osize : 0, nsize, __fst::default_alignment, _MemoryCategory::id());
         }
 
         void internal_warn(const char* msg, FST_ATTRIBUTE_UNUSED int tocont) noexcept{ fst::print("DSLJDSKLDJLKSD", msg); }
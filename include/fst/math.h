@@ -138,15 +138,28 @@ FST_BEGIN_NAMESPACE
         else { static_assert(__fst::always_false<T>, "Unsupported type"); }                          \
     }
 
+#define FST_DELARE_MATH_OP3(NAME)                                                                          \
+    template <typename T, __fst::enable_if_t<__fst::is_floating_point_v<T>, int> = 0>                      \
+    FST_NODISCARD FST_ALWAYS_INLINE T NAME(T x, T y, T z) noexcept                                         \
+    {                                                                                                      \
+        if constexpr (__fst::is_same_v<float, T>) { return ::FST_CONCAT(NAME, f)(x, y, z); }               \
+        else if constexpr (__fst::is_same_v<double, T>) { return ::NAME(x, y, z); }                        \
+        else if constexpr (__fst::is_same_v<long double, T>) { return ::FST_CONCAT(NAME, l)(x, y, z); }    \
+        else { static_assert(__fst::always_false<T>, "Unsupported type"); }                                \
+    }
+
     FST_DELARE_MATH_OP1(fabs)
     FST_DELARE_MATH_OP1(ceil)
     FST_DELARE_MATH_OP1(floor)
     FST_DELARE_MATH_OP1(trunc)
     FST_DELARE_MATH_OP1(round)
+    FST_DELARE_MATH_OP1(nearbyint)
+    FST_DELARE_MATH_OP2(copysign)
     FST_DELARE_MATH_OP2(fmod)
     FST_DELARE_MATH_OP2(fmin)
     FST_DELARE_MATH_OP2(fmax)
     FST_DELARE_MATH_OP2(fdim)
+    FST_DELARE_MATH_OP3(fma)
     FST_DELARE_MATH_OP1(exp)
     FST_DELARE_MATH_OP1(exp2)
     FST_DELARE_MATH_OP1(expm1)
@@ -174,7 +187,23 @@ FST_BEGIN_NAMESPACE
     template <class T>
     FST_NODISCARD FST_ALWAYS_INLINE T exp10(T x) noexcept
     {
-        return __fst::pow(x, (T) 10);
+        return __fst::pow((T) 10, x);
+    }
+
+    template <typename T, __fst::enable_if_t<__fst::is_floating_point_v<T>, int> = 0>
+    FST_NODISCARD FST_ALWAYS_INLINE T ldexp(T x, int exp) noexcept
+    {
+        if constexpr (__fst::is_same_v<float, T>) { return ::ldexpf(x, exp); }
+        else if constexpr (__fst::is_same_v<double, T>) { return ::ldexp(x, exp); }
+        else { return ::ldexpl(x, exp); }
+    }
+
+    template <typename T, __fst::enable_if_t<__fst::is_floating_point_v<T>, int> = 0>
+    FST_NODISCARD FST_ALWAYS_INLINE int ilogb(T x) noexcept
+    {
+        if constexpr (__fst::is_same_v<float, T>) { return ::ilogbf(x); }
+        else if constexpr (__fst::is_same_v<double, T>) { return ::ilogb(x); }
+        else { return ::ilogbl(x); }
     }
 
     namespace cxpr
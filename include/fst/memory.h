@@ -175,13 +175,18 @@ FST_BEGIN_NAMESPACE
         using deallocate_callback = void (*)(void*, __fst::memory_category_id, data_type);
         using aligned_allocate_callback = void* (*) (size_t, size_t, __fst::memory_category_id, data_type);
         using aligned_deallocate_callback = void (*)(void*, __fst::memory_category_id, data_type);
+        using reallocate_callback = void* (*) (void*, size_t, size_t, size_t, __fst::memory_category_id, data_type);
+        using try_expand_callback = bool (*)(void*, size_t, __fst::memory_category_id, data_type);
 
         FST_ALWAYS_INLINE memory_zone_proxy(allocate_callback alloc_cb, deallocate_callback dealloc_cb, aligned_allocate_callback a_alloc_cb,
-            aligned_deallocate_callback a_dealloc_cb, data_type data, __fst::memory_zone_id zid) noexcept
+            aligned_deallocate_callback a_dealloc_cb, data_type data, __fst::memory_zone_id zid, reallocate_callback realloc_cb = nullptr,
+            try_expand_callback expand_cb = nullptr) noexcept
             : _allocate(alloc_cb)
             , _deallocate(dealloc_cb)
             , _aligned_allocate(a_alloc_cb)
             , _aligned_deallocate(a_dealloc_cb)
+            , _reallocate(realloc_cb)
+            , _try_expand(expand_cb)
             , _data(data)
             , _zone_id(zid)
         {}
@@ -197,6 +202,28 @@ FST_BEGIN_NAMESPACE
 
         FST_ALWAYS_INLINE void aligned_deallocate(void* ptr, __fst::memory_category_id mid) const noexcept { _aligned_deallocate(ptr, mid, _data); }
 
+        /// Moves ptr to a block of new_size bytes, the first size bytes are preserved.
+        /// Without a reallocate callback, this allocates, copies and deallocates.
+        FST_NODISCARD inline void* reallocate(void* ptr, size_t size, size_t new_size, size_t alignment, __fst::memory_category_id mid) const noexcept
+        {
+            if (_reallocate) { return _reallocate(ptr, size, new_size, alignment, mid, _data); }
+
+            void* new_ptr = _aligned_allocate(new_size, alignment, mid, _data);
+            if (new_ptr && ptr)
+            {
+                __fst::memcpy(new_ptr, ptr, size < new_size ? size : new_size);
+                _aligned_deallocate(ptr, mid, _data);
+            }
+
+            return new_ptr;
+        }
+
+        /// Grows the block at ptr to new_size bytes without moving it.
+        FST_NODISCARD FST_ALWAYS_INLINE bool try_expand(void* ptr, size_t new_size, __fst::memory_category_id mid) const noexcept
+        {
+            return _try_expand && _try_expand(ptr, new_size, mid, _data);
+        }
+
         FST_NODISCARD FST_ALWAYS_INLINE __fst::memory_zone_id id() const noexcept { return _zone_id; }
 
       private:
@@ -204,6 +231,8 @@ FST_BEGIN_NAMESPACE
         deallocate_callback _deallocate;
         aligned_allocate_callback _aligned_allocate;
         aligned_deallocate_callback _aligned_deallocate;
+        reallocate_callback _reallocate;
+        try_expand_callback _try_expand;
         data_type _data;
         __fst::memory_zone_id _zone_id;
     };
@@ -267,6 +296,32 @@ FST_BEGIN_NAMESPACE
 
         template <typename T>
         using has_static_aligned_deallocate = __fst::is_detected<static_aligned_deallocate_t, T>;
+
+        template <typename T>
+        using reallocate_t = decltype(__fst::declval<T>().reallocate(
+            __fst::declval<void*>(), __fst::declval<size_t>(), __fst::declval<size_t>(), __fst::declval<size_t>(), __fst::declval<__fst::memory_category_id>()));
+
+        template <typename T>
+        using static_reallocate_t = decltype(T::reallocate(
+            __fst::declval<void*>(), __fst::declval<size_t>(), __fst::declval<size_t>(), __fst::declval<size_t>(), __fst::declval<__fst::memory_category_id>()));
+
+        template <typename T>
+        using try_expand_t = decltype(__fst::declval<T>().try_expand(__fst::declval<void*>(), __fst::declval<size_t>(), __fst::declval<__fst::memory_category_id>()));
+
+        template <typename T>
+        using static_try_expand_t = decltype(T::try_expand(__fst::declval<void*>(), __fst::declval<size_t>(), __fst::declval<__fst::memory_category_id>()));
+
+        template <typename T>
+        using has_reallocate = __fst::is_detected<reallocate_t, T>;
+
+        template <typename T>
+        using has_static_reallocate = __fst::is_detected<static_reallocate_t, T>;
+
+        template <typename T>
+        using has_try_expand = __fst::is_detected<try_expand_t, T>;
+
+        template <typename T>
+        using has_static_try_expand = __fst::is_detected<static_try_expand_t, T>;
     } // namespace detail.
 
     ///
@@ -289,6 +344,62 @@ FST_BEGIN_NAMESPACE
                             detail::static_aligned_deallocate_t>::value>
     {};
 
+    /// Optional zone entry points, in addition to the allocate/deallocate functions:
+    ///
+    /// void* reallocate(void* ptr, size_t size, size_t new_size, size_t alignment, memory_category_id)
+    ///     Moves (or grows in place) an aligned block to new_size bytes, preserving its first size bytes.
+    ///     On failure, nullptr is returned and ptr is left untouched.
+    ///
+    /// bool try_expand(void* ptr, size_t new_size, memory_category_id)
+    ///     Grows an aligned block to new_size bytes without moving it, returns false if it can't.
+    template <class T>
+    struct memory_zone_has_reallocate : __fst::bool_t<detail::has_reallocate<T>::value>
+    {};
+
+    ///
+    template <class T>
+    struct memory_zone_has_try_expand : __fst::bool_t<detail::has_try_expand<T>::value>
+    {};
+
+    /// Calls zone.reallocate() when available, otherwise tries to expand the block in place
+    /// before falling back to allocate, copy and deallocate.
+    template <class _MemoryZone>
+    FST_NODISCARD inline void* memory_zone_reallocate(
+        _MemoryZone && zone, void* ptr, size_t size, size_t new_size, size_t alignment, __fst::memory_category_id mid) noexcept
+    {
+        using zone_type = __fst::remove_cvref_t<_MemoryZone>;
+
+        if constexpr (__fst::memory_zone_has_reallocate<zone_type>::value) { return zone.reallocate(ptr, size, new_size, alignment, mid); }
+        else
+        {
+            if constexpr (__fst::memory_zone_has_try_expand<zone_type>::value)
+            {
+                if (ptr && zone.try_expand(ptr, new_size, mid)) { return ptr; }
+            }
+
+            void* new_ptr = zone.aligned_allocate(new_size, alignment, mid);
+            if (new_ptr && ptr)
+            {
+                __fst::memcpy(new_ptr, ptr, size < new_size ? size : new_size);
+                zone.aligned_deallocate(ptr, mid);
+            }
+
+            return new_ptr;
+        }
+    }
+
+    /// Calls zone.try_expand() when available, returns false otherwise.
+    template <class _MemoryZone>
+    FST_NODISCARD FST_ALWAYS_INLINE bool memory_zone_try_expand(_MemoryZone && zone, void* ptr, size_t new_size, __fst::memory_category_id mid) noexcept
+    {
+        if constexpr (__fst::memory_zone_has_try_expand<__fst::remove_cvref_t<_MemoryZone>>::value) { return zone.try_expand(ptr, new_size, mid); }
+        else
+        {
+            __fst::unused(zone, ptr, new_size, mid);
+            return false;
+        }
+    }
+
     ///
     template <class T>
     struct memory_zone : memory::zone_base::restricted_base
@@ -390,7 +501,10 @@ FST_BEGIN_NAMESPACE
                 return __fst::memory_zone_proxy{ [](size_t size, __fst::memory_category_id mid, void*) { return _MemoryZone::allocate(size, mid); },
                     [](void* ptr, __fst::memory_category_id mid, void*) { _MemoryZone::deallocate(ptr, mid); },
                     [](size_t size, size_t alignment, __fst::memory_category_id mid, void*) { return _MemoryZone::aligned_allocate(size, alignment, mid); },
-                    [](void* ptr, __fst::memory_category_id mid, void*) { _MemoryZone::aligned_deallocate(ptr, mid); }, nullptr, _MemoryZone::id() };
+                    [](void* ptr, __fst::memory_category_id mid, void*) { _MemoryZone::aligned_deallocate(ptr, mid); }, nullptr, _MemoryZone::id(),
+                    [](void* ptr, size_t size, size_t new_size, size_t alignment, __fst::memory_category_id mid, void*)
+                    { return __fst::memory_zone_reallocate(_MemoryZone{}, ptr, size, new_size, alignment, mid); },
+                    [](void* ptr, size_t new_size, __fst::memory_category_id mid, void*) { return __fst::memory_zone_try_expand(_MemoryZone{}, ptr, new_size, mid); } };
             }
             else
             {
@@ -399,7 +513,11 @@ FST_BEGIN_NAMESPACE
                     [](void* ptr, __fst::memory_category_id mid, void* data) { ((_MemoryZone*) data)->deallocate(ptr, mid); },
                     [](size_t size, size_t alignment, __fst::memory_category_id mid, void* data)
                     { return ((_MemoryZone*) data)->aligned_allocate(size, alignment, mid); },
-                    [](void* ptr, __fst::memory_category_id mid, void* data) { ((_MemoryZone*) data)->aligned_deallocate(ptr, mid); }, (void*) z, _MemoryZone::id() };
+                    [](void* ptr, __fst::memory_category_id mid, void* data) { ((_MemoryZone*) data)->aligned_deallocate(ptr, mid); }, (void*) z, _MemoryZone::id(),
+                    [](void* ptr, size_t size, size_t new_size, size_t alignment, __fst::memory_category_id mid, void* data)
+                    { return __fst::memory_zone_reallocate(*(_MemoryZone*) data, ptr, size, new_size, alignment, mid); },
+                    [](void* ptr, size_t new_size, __fst::memory_category_id mid, void* data)
+                    { return __fst::memory_zone_try_expand(*(_MemoryZone*) data, ptr, new_size, mid); } };
             }
         }
     };
@@ -449,6 +567,12 @@ FST_BEGIN_NAMESPACE
 
         FST_NODISCARD static void* aligned_allocate(size_t size, size_t alignment, __fst::memory_category_id mid) noexcept;
         static void aligned_deallocate(void* ptr, __fst::memory_category_id mid) noexcept;
+
+        /// Uses realloc, which can grow large blocks in place or with mremap.
+        FST_NODISCARD static void* reallocate(void* ptr, size_t size, size_t new_size, size_t alignment, __fst::memory_category_id mid) noexcept;
+
+        /// Succeeds when the block already has new_size usable bytes.
+        FST_NODISCARD static bool try_expand(void* ptr, size_t new_size, __fst::memory_category_id mid) noexcept;
     };
 
     ///
@@ -502,6 +626,76 @@ FST_BEGIN_NAMESPACE
         pool* _pool;
     };
 
+    /// General purpose zone with geometric size classes.
+    ///
+    /// Sizes from 16 B to 64 KiB are rounded up to one of 44 size classes (four per
+    /// power of two) and served from 1 MiB slabs mapped from the os. A slab goes back
+    /// to the os as soon as it's empty, except for one cached empty slab per size class.
+    /// Bigger allocations and alignments above 4 KiB are mapped directly from the os.
+    ///
+    /// Every size class has its own lock, threads only contend when using the same class.
+    struct size_class_memory_zone : __fst::memory_zone<size_class_memory_zone>
+    {
+        static constexpr const char* name = "size_class";
+
+        static constexpr size_t minimum_size = 16;
+        static constexpr size_t maximum_size = 64 * 1024;
+        static constexpr size_t size_class_count = 44;
+        static constexpr size_t slab_size = 1024 * 1024;
+
+        FST_NODISCARD static void* allocate(size_t size, __fst::memory_category_id mid) noexcept;
+        static void deallocate(void* ptr, __fst::memory_category_id mid) noexcept;
+
+        FST_NODISCARD static void* aligned_allocate(size_t size, size_t alignment, __fst::memory_category_id mid) noexcept;
+        static void aligned_deallocate(void* ptr, __fst::memory_category_id mid) noexcept;
+
+        /// Stays in place when the new size fits in the same size class, large blocks are grown with mremap when possible.
+        FST_NODISCARD static void* reallocate(void* ptr, size_t size, size_t new_size, size_t alignment, __fst::memory_category_id mid) noexcept;
+        FST_NODISCARD static bool try_expand(void* ptr, size_t new_size, __fst::memory_category_id mid) noexcept;
+
+        /// Number of bytes actually reserved for an allocation of the given size.
+        FST_NODISCARD static size_t allocation_size(size_t size) noexcept;
+
+        /// Number of slabs currently mapped from the os.
+        FST_NODISCARD static size_t slab_count() noexcept;
+    };
+
+    /// Simd zone backed by 2 MiB pages for big allocations.
+    ///
+    /// Allocations of at least large_allocation_threshold bytes are mapped from the os,
+    /// on explicit huge pages when some are reserved, otherwise on transparent huge pages
+    /// (madvise). Large pages are used on windows when the process has the lock memory privilege.
+    /// A large allocation starts on a large page boundary and its mapping is size rounded up to
+    /// large_page_size, a 2 MiB buffer takes exactly one large page.
+    /// Smaller allocations go to the simd_memory_zone.
+    ///
+    /// Large allocations are bound to the numa node set with set_thread_numa_node() on the
+    /// allocating thread. Binding is silently skipped when numa isn't available.
+    struct large_page_memory_zone : __fst::memory_zone<large_page_memory_zone>
+    {
+        static constexpr const char* name = "large_page";
+
+        static constexpr size_t large_page_size = 2 * 1024 * 1024;
+        static constexpr size_t large_allocation_threshold = large_page_size;
+
+        FST_NODISCARD static void* allocate(size_t size, __fst::memory_category_id mid) noexcept;
+        static void deallocate(void* ptr, __fst::memory_category_id mid) noexcept;
+
+        /// alignment can't be above large_page_size.
+        FST_NODISCARD static void* aligned_allocate(size_t size, size_t alignment, __fst::memory_category_id mid) noexcept;
+        static void aligned_deallocate(void* ptr, __fst::memory_category_id mid) noexcept;
+
+        /// Returns true if ptr was mapped on its own by this zone (size above the threshold).
+        FST_NODISCARD static bool is_large_allocation(const void* ptr) noexcept;
+
+        /// Numa node for the large allocations made by the calling thread, -1 for no binding.
+        static void set_thread_numa_node(int node) noexcept;
+        FST_NODISCARD static int thread_numa_node() noexcept;
+
+        /// Numa node of the cpu the calling thread runs on, 0 when unknown.
+        FST_NODISCARD static int current_numa_node() noexcept;
+    };
+
     ///
     template <class _MemoryCategory = __fst::default_memory_category, __fst::enable_if_t<__fst::is_memory_category<_MemoryCategory>::value, int> = 0>
     FST_NODISCARD inline void* allocate(size_t size) noexcept
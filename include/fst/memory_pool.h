@@ -116,6 +116,61 @@ FST_BEGIN_NAMESPACE
                 return p;
             }
 
+            /// Pops up to count elements with a single CAS.
+            /// @returns the number of elements written to nodes.
+            FST_NODISCARD inline size_t allocate_batch(void** nodes, size_t count) noexcept
+            {
+                tagged_index head_value;
+                head_value.u = _head.load();
+
+                while (true)
+                {
+                    if (head_value.u == tagged_index::invalid) { return 0; }
+
+                    // Walk the list from the head. Another thread can pop and reuse these
+                    // nodes while we read them, in which case the offsets can be garbage
+                    // but the head tag changed and the CAS below fails.
+                    tagged_index next_value = head_value;
+                    size_t n = 0;
+                    bool valid = true;
+
+                    while (n < count && next_value.u != tagged_index::invalid)
+                    {
+                        if (next_value.p.offset > _buffer.size() - sizeof(tagged_index))
+                        {
+                            valid = false;
+                            break;
+                        }
+
+                        uint8_t* p = _buffer.data() + next_value.p.offset;
+                        nodes[n++] = p;
+                        next_value = *((tagged_index*) p);
+                    }
+
+                    if (valid && _head.compare_exchange(head_value.u, next_value.u)) { return n; }
+
+                    if (!valid) { head_value.u = _head.load(); }
+                }
+            }
+
+            /// Links the nodes together and pushes them with a single CAS.
+            inline void deallocate_batch(void* const* nodes, size_t count) noexcept
+            {
+                fst_assert(count, "empty batch");
+
+                // Every link gets its own tag to keep the ABA protection.
+                uint32_t tag = _global_tag.fetch_add((uint32_t) count);
+                for (size_t i = 0; i + 1 < count; i++)
+                {
+                    tagged_index next_value;
+                    next_value.p.tag = tag++;
+                    next_value.p.offset = (uint32_t) ((uint8_t*) nodes[i + 1] - _buffer.data());
+                    *((tagged_index*) nodes[i]) = next_value;
+                }
+
+                deallocate_interval(nodes[0], nodes[count - 1]);
+            }
+
             inline void deallocate_interval(void* _pHead, void* _pTail) noexcept
             {
                 uint8_t* pHead = (uint8_t*) _pHead;
@@ -178,6 +233,100 @@ FST_BEGIN_NAMESPACE
 
         using buffer_pointer = __fst::optional_ptr<uint8_t, _MemoryCategory, _MemoryZone>;
 
+        /// Per-thread magazines of free slots.
+        ///
+        /// While a thread_cache exists, aligned_allocate and aligned_deallocate called from
+        /// its thread go through a small stack of free slots per bucket. Empty magazines
+        /// are refilled and full ones are flushed in batches of magazine_batch with a single
+        /// CAS on the shared bucket head instead of one CAS per call.
+        ///
+        /// Only one thread_cache per thread is active for a given pool type, creating another
+        /// one temporarily replaces it. Slots are given back to the pool on destruction.
+        ///
+        /// @code
+        /// // In each worker thread.
+        /// small_memory_pool<>::thread_cache cache(pool);
+        /// void* p = pool.aligned_allocate(32, 16);
+        /// @endcode
+        ///
+        /// @warning Must be destroyed on the thread that created it and before the pool.
+        class thread_cache
+        {
+          public:
+            static constexpr size_t magazine_capacity = 32;
+            static constexpr size_t magazine_batch = magazine_capacity / 2;
+
+            inline explicit thread_cache(small_memory_pool& pool) noexcept
+                : _pool(&pool)
+                , _previous(__fst::exchange(_current, this))
+            {}
+
+            thread_cache(const thread_cache&) = delete;
+            thread_cache(thread_cache&&) = delete;
+
+            inline ~thread_cache() noexcept
+            {
+                fst_assert(_current == this, "thread_cache destroyed out of order or on another thread");
+
+                flush();
+                _current = _previous;
+            }
+
+            thread_cache& operator=(const thread_cache&) = delete;
+            thread_cache& operator=(thread_cache&&) = delete;
+
+            /// Gives all the cached slots back to the pool.
+            inline void flush() noexcept
+            {
+                for (size_t i = 0; i < _pool->_buckets_count; i++)
+                {
+                    magazine& m = _magazines[i];
+                    if (m.count) { _pool->_buckets[i].deallocate_batch(m.slots, __fst::exchange(m.count, (size_t) 0)); }
+                }
+            }
+
+          private:
+            friend class small_memory_pool;
+
+            struct magazine
+            {
+                void* slots[magazine_capacity];
+                size_t count = 0;
+            };
+
+            small_memory_pool* _pool;
+            thread_cache* _previous;
+            magazine _magazines[maximum_bucket_count];
+
+            FST_NODISCARD FST_ALWAYS_INLINE void* allocate(size_t bucket_index) noexcept
+            {
+                magazine& m = _magazines[bucket_index];
+                if (FST_UNLIKELY(m.count == 0))
+                {
+                    m.count = _pool->_buckets[bucket_index].allocate_batch(m.slots, magazine_batch);
+                    if (m.count == 0) { return nullptr; }
+                }
+
+                return m.slots[--m.count];
+            }
+
+            FST_ALWAYS_INLINE void deallocate(size_t bucket_index, void* ptr) noexcept
+            {
+                magazine& m = _magazines[bucket_index];
+                if (FST_UNLIKELY(m.count == magazine_capacity))
+                {
+                    // Flush the oldest half, the most recently freed slots are still hot.
+                    _pool->_buckets[bucket_index].deallocate_batch(m.slots, magazine_batch);
+                    __fst::memmove(m.slots, m.slots + magazine_batch, (magazine_capacity - magazine_batch) * sizeof(void*));
+                    m.count -= magazine_batch;
+                }
+
+                m.slots[m.count++] = ptr;
+            }
+
+            static inline thread_local thread_cache* _current = nullptr;
+        };
+
         inline small_memory_pool(size_t buckets_count, size_t bucket_size, __fst::byte_range buffer = __fst::byte_range()) noexcept
             : _buckets_count(buckets_count)
             , _bucket_size(bucket_size)
@@ -225,6 +374,12 @@ FST_BEGIN_NAMESPACE
             if (FST_UNLIKELY(size == 0)) { return nullptr; }
 
             size_t bucket_index = (__fst::maximum(size, alignment) - 1) >> minimum_alignment_bit_index;
+
+            if (thread_cache* cache = current_cache(); cache && bucket_index < _buckets_count)
+            {
+                if (void* ptr = cache->allocate(bucket_index)) { return ptr; }
+            }
+
             while (bucket_index < _buckets_count)
             {
                 if (void* ptr = _buckets[bucket_index++].allocate()) { return ptr; }
@@ -238,12 +393,19 @@ FST_BEGIN_NAMESPACE
         {
             fst_assert(ptr);
 
-            if (size_t bucket_index = find_bucket(ptr); bucket_index < _buckets_count) { return _buckets[bucket_index].deallocate_interval(ptr, ptr); }
+            if (size_t bucket_index = find_bucket(ptr); bucket_index < _buckets_count)
+            {
+                if (thread_cache* cache = current_cache()) { return cache->deallocate(bucket_index, ptr); }
+                return _buckets[bucket_index].deallocate_interval(ptr, ptr);
+            }
 
             // fallback to generic allocator
             _MemoryZone::aligned_deallocate(ptr, _MemoryCategory::id());
         }
 
+        /// Returns true if ptr was allocated from one of the buckets.
+        FST_NODISCARD FST_ALWAYS_INLINE bool owns(const void* ptr) const noexcept { return find_bucket(ptr) < _buckets_count; }
+
       private:
         size_t _buckets_count;
         size_t _bucket_size;
@@ -251,6 +413,12 @@ FST_BEGIN_NAMESPACE
         buffer_pointer _buffer;
 
         FST_NODISCARD FST_ALWAYS_INLINE size_t find_bucket(const void* p) const noexcept { return ((uintptr_t) p - (uintptr_t) _buckets[0].data()) / _bucket_size; }
+
+        FST_NODISCARD FST_ALWAYS_INLINE thread_cache* current_cache() noexcept
+        {
+            thread_cache* cache = thread_cache::_current;
+            return cache && cache->_pool == this ? cache : nullptr;
+        }
     };
 
     /// This allocator allocate memory blocks from pre-allocated memory chunks.
@@ -289,6 +457,9 @@ FST_BEGIN_NAMESPACE
             __fst::packed_pointer data;
             size_type refcount;
 
+            // Chunks released by rewind(), reused by add_chunk() before allocating new ones.
+            chunk_header* spare;
+
             // Head of the chunk linked-list. Only the head chunk serves allocation.
             inline chunk_header* head() const noexcept { return data.get_pointer<chunk_header*>(); }
             inline void set_head(chunk_header* h) noexcept { data.set_pointer(h); }
@@ -304,6 +475,13 @@ FST_BEGIN_NAMESPACE
         static constexpr size_type total_reserved_size = shared_data_size + chunk_header_size;
         static constexpr size_type chunk_alignment = __fst::default_alignment;
 
+        /// Position in the pool returned by mark().
+        struct marker
+        {
+            void* chunk;
+            chunk_size_type size;
+        };
+
         /// @param chunk_size The size of memory chunk, default is default_chunk_capacity.
         /// @param allocate_chunk Whether or not the chunk_size should be pre allocated.
         inline explicit forward_memory_pool(size_type chunk_size = default_chunk_capacity, bool allocate_chunk = false) noexcept
@@ -328,6 +506,7 @@ FST_BEGIN_NAMESPACE
             head->next = nullptr;
             _shared->set_owned(true);
             _shared->refcount = 1;
+            _shared->spare = nullptr;
         }
 
         /// The user buffer will be used firstly. When it is full, memory pool allocates new chunk with chunk size.
@@ -357,6 +536,7 @@ FST_BEGIN_NAMESPACE
             head->next = nullptr;
             _shared->set_owned(false);
             _shared->refcount = 1;
+            _shared->spare = nullptr;
         }
 
         inline forward_memory_pool(const forward_memory_pool& rhs) noexcept
@@ -415,9 +595,58 @@ FST_BEGIN_NAMESPACE
                 memory_zone_type::aligned_deallocate(c, memory_category_type::id());
             }
 
+            release_spare_chunks();
             _shared->head()->size = 0;
         }
 
+        /// Returns the current position of the pool.
+        /// Everything allocated after this call can be released at once with rewind().
+        FST_NODISCARD inline marker mark() const noexcept
+        {
+            fst_assert(_shared);
+            fst_assert(_shared->refcount > 0);
+            chunk_header* head = _shared->head();
+            return marker{ head, head->size };
+        }
+
+        /// Releases every memory block allocated since m was returned by mark().
+        ///
+        /// Markers must be rewound in reverse order (LIFO) and a marker becomes invalid
+        /// once an older one was rewound or the pool was cleared.
+        /// The chunks added after the marker are kept and reused by the next allocations.
+        /// @note This affects every copy of a shared pool.
+        inline void rewind(const marker& m) noexcept
+        {
+            fst_assert(_shared);
+            fst_assert(_shared->refcount > 0);
+
+            chunk_header* head = _shared->head();
+            while (head != m.chunk)
+            {
+                fst_assert(head->next, "invalid memory pool marker");
+                _shared->set_head(head->next);
+
+                head->size = 0;
+                head->next = _shared->spare;
+                _shared->spare = head;
+                head = _shared->head();
+            }
+
+            fst_assert(m.size <= head->size, "invalid memory pool marker");
+            head->size = m.size;
+        }
+
+        /// Deallocates the chunks kept by rewind().
+        inline void release_spare_chunks() noexcept
+        {
+            fst_assert(_shared);
+            while (chunk_header* c = _shared->spare)
+            {
+                _shared->spare = c->next;
+                memory_zone_type::aligned_deallocate(c, memory_category_type::id());
+            }
+        }
+
         /// Computes the total capacity of allocated memory chunks.
         /// @return total capacity in bytes.
         FST_NODISCARD inline size_type capacity() const noexcept
@@ -528,6 +757,19 @@ FST_BEGIN_NAMESPACE
 
         bool add_chunk(size_type capacity) noexcept
         {
+            // First spare chunk large enough.
+            for (chunk_header** it = &_shared->spare; *it; it = &(*it)->next)
+            {
+                if ((*it)->capacity >= capacity)
+                {
+                    chunk_header* chunk = *it;
+                    *it = chunk->next;
+                    chunk->next = _shared->head();
+                    _shared->set_head(chunk);
+                    return true;
+                }
+            }
+
             chunk_header* chunk = (chunk_header*) memory_zone_type::aligned_allocate(chunk_header_size + capacity, chunk_alignment, memory_category_type::id());
             if (!chunk) { return false; }
 
@@ -542,4 +784,111 @@ FST_BEGIN_NAMESPACE
         shared_data* _shared;
     };
 
+    /// RAII scope over a forward_memory_pool.
+    ///
+    /// Everything allocated from the pool while the scope is alive is released in O(1)
+    /// when it is destroyed, without giving the chunks back to the memory zone.
+    ///
+    /// @code
+    ///     fst::forward_memory_pool<> pool;
+    ///
+    ///     for (const request& r : requests)
+    ///     {
+    ///         fst::scoped_arena arena(pool);
+    ///         process(r, arena.aligned_allocate(r.size()));
+    ///     }
+    /// @endcode
+    template <class _ForwardMemoryPool>
+    class scoped_arena
+    {
+      public:
+        using memory_pool_type = _ForwardMemoryPool;
+        using size_type = typename memory_pool_type::size_type;
+        using marker = typename memory_pool_type::marker;
+
+        inline explicit scoped_arena(memory_pool_type& pool) noexcept
+            : _pool(pool)
+            , _marker(pool.mark())
+        {}
+
+        scoped_arena(const scoped_arena&) = delete;
+        scoped_arena(scoped_arena&&) = delete;
+
+        inline ~scoped_arena() noexcept { _pool.rewind(_marker); }
+
+        scoped_arena& operator=(const scoped_arena&) = delete;
+        scoped_arena& operator=(scoped_arena&&) = delete;
+
+        FST_NODISCARD inline void* aligned_allocate(size_type size, size_type alignment = __fst::default_alignment) noexcept
+        {
+            return _pool.aligned_allocate(size, alignment);
+        }
+
+        static inline void aligned_deallocate(void* ptr) noexcept { memory_pool_type::aligned_deallocate(ptr); }
+
+        /// Releases everything allocated in this scope so far.
+        inline void rewind() noexcept { _pool.rewind(_marker); }
+
+        FST_NODISCARD inline memory_pool_type& pool() const noexcept { return _pool; }
+
+      private:
+        memory_pool_type& _pool;
+        marker _marker;
+    };
+
+    /// Double-buffered forward_memory_pool for per-frame (or per-block) temporaries.
+    ///
+    /// Memory allocated during a frame stays valid during the next one, so a frame can
+    /// still read what the previous one produced. It is released in O(1) when the frame
+    /// after that begins. The chunks are kept from one frame to the other.
+    template <class _MemoryCategory = __fst::default_memory_category, class _MemoryZone = __fst::default_memory_zone>
+    class frame_memory_pool
+    {
+      public:
+        using memory_pool_type = __fst::forward_memory_pool<_MemoryCategory, _MemoryZone>;
+        using size_type = typename memory_pool_type::size_type;
+
+        inline explicit frame_memory_pool(size_type chunk_size = memory_pool_type::default_chunk_capacity, bool allocate_chunk = false) noexcept
+            : _pools{ memory_pool_type(chunk_size, allocate_chunk), memory_pool_type(chunk_size, allocate_chunk) }
+            , _origins{ _pools[0].mark(), _pools[1].mark() }
+        {}
+
+        frame_memory_pool(const frame_memory_pool&) = delete;
+        frame_memory_pool& operator=(const frame_memory_pool&) = delete;
+
+        /// Begins a new frame, the memory of the frame before the previous one is released.
+        inline void next_frame() noexcept
+        {
+            _index ^= 1;
+            _pools[_index].rewind(_origins[_index]);
+            ++_frame;
+        }
+
+        FST_NODISCARD inline void* aligned_allocate(size_type size, size_type alignment = __fst::default_alignment) noexcept
+        {
+            return _pools[_index].aligned_allocate(size, alignment);
+        }
+
+        static inline void aligned_deallocate(void* ptr) noexcept { memory_pool_type::aligned_deallocate(ptr); }
+
+        /// Pool of the current frame.
+        FST_NODISCARD inline memory_pool_type& current() noexcept { return _pools[_index]; }
+        FST_NODISCARD inline const memory_pool_type& current() const noexcept { return _pools[_index]; }
+
+        /// Pool of the previous frame, still valid until the next call to next_frame().
+        FST_NODISCARD inline memory_pool_type& previous() noexcept { return _pools[_index ^ 1]; }
+        FST_NODISCARD inline const memory_pool_type& previous() const noexcept { return _pools[_index ^ 1]; }
+
+        /// Number of next_frame() calls.
+        FST_NODISCARD inline uint64_t frame() const noexcept { return _frame; }
+
+        FST_NODISCARD inline size_type capacity() const noexcept { return _pools[0].capacity() + _pools[1].capacity(); }
+
+      private:
+        memory_pool_type _pools[2];
+        typename memory_pool_type::marker _origins[2];
+        uint64_t _frame = 0;
+        size_t _index = 0;
+    };
+
 FST_END_NAMESPACE
@@ -673,6 +673,18 @@ FST_BEGIN_NAMESPACE
         friend class memory_range;
     };
 
+    /// Hashes the bytes of the elements, padding bytes would make equal ranges hash differently.
+    template <class _Tp, size_t _Size>
+    struct hash<__fst::memory_range<_Tp, _Size>>
+    {
+        static_assert(__fst::is_trivially_copyable_v<__fst::remove_cv_t<_Tp>>, "Only ranges of trivially copyable types can be hashed.");
+
+        FST_NODISCARD inline size_t operator()(const __fst::memory_range<_Tp, _Size>& range) const noexcept
+        {
+            return (size_t) __fst::hash_bytes(range.data(), range.size_bytes());
+        }
+    };
+
     ///
     //template <class _T, size_t _Size, size_t _Alignment = 32>
     //class aligned_memory_range_base
@@ -34,6 +34,17 @@
 FST_SYSTEM_HEADER
 
 FST_BEGIN_NAMESPACE
+    /// Contention counters shared by every lock type.
+    struct lock_stats
+    {
+        /// Number of lock calls that couldn't acquire the lock right away.
+        uint64_t contentions;
+
+        /// Number of times a thread was put to sleep waiting for the lock.
+        uint64_t parks;
+    };
+
+    /// Os mutex (critical section on windows, pthread mutex elsewhere).
     class mutex
     {
       public:
@@ -56,20 +67,32 @@ FST_BEGIN_NAMESPACE
 
         handle get_handle() const noexcept;
 
+        /// Parks are handled by the os and are not counted.
+        FST_NODISCARD inline lock_stats stats() const noexcept { return lock_stats{ _contentions.load(), 0 }; }
+
+        inline void reset_stats() noexcept { _contentions.store(0); }
+
       private:
         struct native;
         __fst::aligned_storage<64, 8> _storage;
+        __fst::atomic<uint32_t> _contentions;
     };
 
     // https://rigtorp.se/spinlock/
+    /// @warning Never sleeps, only use it for very short critical sections with
+    ///          less threads than cores. See adaptive_mutex otherwise.
     class spin_lock
     {
       public:
         inline void lock() noexcept
         {
+            // Optimistically assume the lock is free on the first try.
+            if (!_lock.exchange(true)) { return; }
+
+            ++_contentions;
+
             for (;;)
             {
-                // Optimistically assume the lock is free on the first try.
                 if (!_lock.exchange(true)) { break; }
 
                 // Wait for lock to be released without generating cache misses.
@@ -91,8 +114,155 @@ FST_BEGIN_NAMESPACE
 
         inline void unlock() noexcept { _lock.store(false); }
 
+        FST_NODISCARD inline lock_stats stats() const noexcept { return lock_stats{ _contentions.load(), 0 }; }
+
+        inline void reset_stats() noexcept { _contentions.store(0); }
+
       private:
         __fst::atomic<bool> _lock = false;
+        __fst::atomic<uint32_t> _contentions;
+    };
+
+    /// Spins with a bounded exponential backoff and then parks the thread on a futex.
+    ///
+    /// Uncontended lock and unlock are a single atomic operation. Short waits are
+    /// handled by spinning, longer ones put the thread to sleep so that waiting
+    /// threads don't steal cpu time from the owner when threads outnumber cores.
+    /// @see Futexes Are Tricky (Drepper 2011)
+    class adaptive_mutex
+    {
+      public:
+        adaptive_mutex() noexcept = default;
+        adaptive_mutex(const adaptive_mutex&) = delete;
+        adaptive_mutex(adaptive_mutex&&) = delete;
+
+        adaptive_mutex& operator=(const adaptive_mutex&) = delete;
+        adaptive_mutex& operator=(adaptive_mutex&&) = delete;
+
+        inline void lock() noexcept
+        {
+            uint32_t expected = unlocked;
+            if (!_state.compare_exchange_strong(expected, locked)) { lock_contended(); }
+        }
+
+        inline bool try_lock() noexcept
+        {
+            uint32_t expected = unlocked;
+            return _state.load() == unlocked && _state.compare_exchange_strong(expected, locked);
+        }
+
+        inline void unlock() noexcept
+        {
+            // Only wake someone up if a thread went to sleep.
+            if (_state.exchange(unlocked) == locked_with_waiters) { _state.notify_one(); }
+        }
+
+        FST_NODISCARD inline lock_stats stats() const noexcept { return lock_stats{ _contentions.load(), _parks.load() }; }
+
+        inline void reset_stats() noexcept
+        {
+            _contentions.store(0);
+            _parks.store(0);
+        }
+
+      private:
+        static constexpr uint32_t unlocked = 0;
+        static constexpr uint32_t locked = 1;
+        static constexpr uint32_t locked_with_waiters = 2;
+
+        __fst::atomic<uint32_t> _state;
+        __fst::atomic<uint32_t> _contentions;
+        __fst::atomic<uint32_t> _parks;
+
+        void lock_contended() noexcept;
+    };
+
+    /// Reader/writer lock that spins and then parks like adaptive_mutex.
+    class shared_mutex
+    {
+      public:
+        enum class policy : uint8_t {
+            /// Readers get in as long as no writer holds the lock.
+            /// Best throughput for read-mostly data but writers can starve.
+            reader_biased,
+
+            /// New readers wait as soon as a writer is waiting.
+            writer_preferring
+        };
+
+        inline explicit shared_mutex(policy p = policy::writer_preferring) noexcept
+            : _policy(p)
+        {}
+
+        shared_mutex(const shared_mutex&) = delete;
+        shared_mutex(shared_mutex&&) = delete;
+
+        shared_mutex& operator=(const shared_mutex&) = delete;
+        shared_mutex& operator=(shared_mutex&&) = delete;
+
+        inline void lock() noexcept
+        {
+            uint32_t expected = 0;
+            if (!_state.compare_exchange_strong(expected, writer_bit)) { lock_contended(); }
+        }
+
+        inline bool try_lock() noexcept
+        {
+            uint32_t expected = 0;
+            return _state.load() == 0 && _state.compare_exchange_strong(expected, writer_bit);
+        }
+
+        inline void unlock() noexcept
+        {
+            _state.store(0);
+            if (_waiters.load() != 0) { _state.notify_all(); }
+        }
+
+        inline void lock_shared() noexcept
+        {
+            if (!try_lock_shared()) { lock_shared_contended(); }
+        }
+
+        inline bool try_lock_shared() noexcept
+        {
+            uint32_t state = _state.load();
+            return can_read(state) && _state.compare_exchange_strong(state, state + 1);
+        }
+
+        inline void unlock_shared() noexcept
+        {
+            // The last reader lets the writers in.
+            if (_state.fetch_sub(1) == 1 && _waiters.load() != 0) { _state.notify_all(); }
+        }
+
+        FST_NODISCARD inline policy get_policy() const noexcept { return _policy; }
+
+        FST_NODISCARD inline lock_stats stats() const noexcept { return lock_stats{ _contentions.load(), _parks.load() }; }
+
+        inline void reset_stats() noexcept
+        {
+            _contentions.store(0);
+            _parks.store(0);
+        }
+
+      private:
+        // The highest bit is set while a writer owns the lock, the others count the readers.
+        static constexpr uint32_t writer_bit = 1u << 31;
+
+        __fst::atomic<uint32_t> _state;
+        __fst::atomic<uint32_t> _waiting_writers;
+        __fst::atomic<uint32_t> _waiters;
+        __fst::atomic<uint32_t> _contentions;
+        __fst::atomic<uint32_t> _parks;
+        policy _policy;
+
+        FST_ALWAYS_INLINE bool can_read(uint32_t state) const noexcept
+        {
+            return !(state & writer_bit) && (_policy == policy::reader_biased || _waiting_writers.load() == 0);
+        }
+
+        void lock_contended() noexcept;
+        void lock_shared_contended() noexcept;
     };
 
 FST_END_NAMESPACE
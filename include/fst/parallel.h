@@ -0,0 +1,421 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Alexandre Arsenault
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#pragma once
+
+///
+/// @file fst/parallel.h
+///
+/// Data parallel loops over contiguous containers (vector, memory_range, heap_array,
+/// small_vector, simd::buffer, simd::array, ...), anything with data() and size().
+/// To run the simd kernels on each grain, use the range version of parallel_for with a
+/// grain that is a multiple of the vector size and wrap [first, last) in a simd::range.
+///
+/// The work is cut in grains of about parallel_grain_bytes so that a chunk of input
+/// and output stays in the L1/L2 cache of the core running it. Workers take the next
+/// grain from a shared counter, a slow core simply takes fewer grains. The calling
+/// thread works too and only returns once every grain is done, calling these from a
+/// task of the same pool is fine.
+///
+/// Everything runs on parallel_thread_pool() unless a pool is given as first argument.
+///
+/// @code
+///     fst::vector<float> samples = ...;
+///     fst::parallel_for_each(samples, [](float& s) { s *= 0.5f; });
+///     float peak = fst::parallel_reduce(samples, 0.0f, [](float a, float b) { return fst::maximum(a, fst::abs(b)); });
+/// @endcode
+///
+
+#include "fst/common.h"
+#include "fst/async/thread_pool.h"
+#include "fst/atomic.h"
+#include "fst/memory.h"
+#include "fst/memory_utils.h"
+#include "fst/small_vector.h"
+#include "fst/traits.h"
+#include "fst/utility.h"
+
+FST_BEGIN_NAMESPACE
+
+    /// Default amount of data per grain, half of a typical L1 data cache.
+    FST_INLINE_VAR constexpr size_t parallel_grain_bytes = 16 * 1024;
+
+    /// Thread pool shared by the parallel algorithms, one worker per hardware thread.
+    /// Created on first use.
+    FST_NODISCARD inline __fst::async::thread_pool& parallel_thread_pool() noexcept
+    {
+        static __fst::async::thread_pool pool;
+        return pool;
+    }
+
+    namespace detail
+    {
+        template <class _Fct>
+        struct parallel_state
+        {
+            __fst::atomic<size_t> next = 0;
+            size_t count;
+            size_t grain;
+            size_t chunk_count;
+            _Fct* fct;
+
+            inline void run() noexcept
+            {
+                for (size_t chunk = next.fetch_add(1); chunk < chunk_count; chunk = next.fetch_add(1))
+                {
+                    const size_t first = chunk * grain;
+                    (*fct)(first, __fst::minimum(first + grain, count));
+                }
+            }
+        };
+
+        FST_NODISCARD inline size_t parallel_chunk_count(size_t count, size_t grain) noexcept { return (count + grain - 1) / grain; }
+
+        /// Calls fct(first, last) on every grain of [0, count) and waits for all of them.
+        template <class _Fct>
+        inline void parallel_chunks(__fst::async::thread_pool& pool, size_t count, size_t grain, _Fct&& fct) noexcept
+        {
+            if (count == 0) { return; }
+
+            grain = __fst::maximum(grain, (size_t) 1);
+            const size_t chunk_count = parallel_chunk_count(count, grain);
+            const size_t helper_count = __fst::minimum(pool.size(), chunk_count - 1);
+
+            if (helper_count == 0)
+            {
+                fct((size_t) 0, count);
+                return;
+            }
+
+            using fct_type = __fst::remove_reference_t<_Fct>;
+            parallel_state<fct_type> state;
+            state.count = count;
+            state.grain = grain;
+            state.chunk_count = chunk_count;
+            state.fct = __fst::addressof(fct);
+
+            // The state outlives every task, nothing to release.
+            __fst::small_vector<__fst::async::thread_pool::task_handle, 16> handles;
+            for (size_t i = 0; i < helper_count; i++)
+            {
+                handles.push_back(pool.submit(__fst::async::thread_pool::task_data{
+                    [](void* data) { ((parallel_state<fct_type>*) data)->run(); }, [](void*) {}, &state }));
+            }
+
+            state.run();
+
+            for (const __fst::async::thread_pool::task_handle& handle : handles)
+            {
+                pool.wait(handle);
+            }
+        }
+
+        template <class _T>
+        FST_NODISCARD inline size_t parallel_grain(size_t grain) noexcept
+        {
+            return grain ? grain : __fst::maximum(parallel_grain_bytes / sizeof(_T), (size_t) 1);
+        }
+
+        template <class _Container>
+        using parallel_value_t = __fst::remove_cvref_t<decltype(*__fst::declval<_Container&>().data())>;
+
+        // Number of elements of a taken before the k-th element of the stable merge of a and b.
+        template <class _T, class _Compare>
+        FST_NODISCARD inline size_t parallel_co_rank(size_t k, const _T* a, size_t a_size, const _T* b, size_t b_size, const _Compare& comp) noexcept
+        {
+            size_t lo = k > b_size ? k - b_size : 0;
+            size_t hi = __fst::minimum(k, a_size);
+
+            while (lo < hi)
+            {
+                const size_t i = (lo + hi) / 2;
+                const size_t j = k - i;
+
+                // On ties, a comes first.
+                if (j > 0 && !comp(b[j - 1], a[i])) { lo = i + 1; }
+                else { hi = i; }
+            }
+
+            return lo;
+        }
+
+        template <class _T, class _Compare>
+        inline void parallel_merge(const _T* a, const _T* a_end, const _T* b, const _T* b_end, _T* out, const _Compare& comp) noexcept
+        {
+            while (a != a_end && b != b_end)
+            {
+                *out++ = comp(*b, *a) ? *b++ : *a++;
+            }
+
+            __fst::memcpy(out, a, (size_t) (a_end - a) * sizeof(_T));
+            __fst::memcpy(out + (a_end - a), b, (size_t) (b_end - b) * sizeof(_T));
+        }
+
+        // Stable merge sort of a grain, insertion sorted runs and bottom-up merges through tmp.
+        template <class _T, class _Compare>
+        inline void parallel_sort_grain(_T* data, _T* tmp, size_t count, const _Compare& comp) noexcept
+        {
+            constexpr size_t run_size = 16;
+
+            for (size_t first = 0; first < count; first += run_size)
+            {
+                const size_t last = __fst::minimum(first + run_size, count);
+                for (size_t i = first + 1; i < last; i++)
+                {
+                    const _T value = data[i];
+                    size_t j = i;
+                    for (; j > first && comp(value, data[j - 1]); j--)
+                    {
+                        data[j] = data[j - 1];
+                    }
+                    data[j] = value;
+                }
+            }
+
+            _T* src = data;
+            _T* dst = tmp;
+
+            for (size_t width = run_size; width < count; width *= 2)
+            {
+                for (size_t first = 0; first < count; first += 2 * width)
+                {
+                    const size_t mid = __fst::minimum(first + width, count);
+                    const size_t last = __fst::minimum(first + 2 * width, count);
+                    parallel_merge(src + first, src + mid, src + mid, src + last, dst + first, comp);
+                }
+
+                __fst::mem_swap(src, dst);
+            }
+
+            if (src != data) { __fst::memcpy(data, src, count * sizeof(_T)); }
+        }
+    } // namespace detail
+
+    /// Calls fct(i) for every i in [0, count), or fct(first, last) for every grain when fct takes two indices.
+    /// With a grain of 0, the range is cut in about 8 grains per worker.
+    template <class _Fct>
+    inline void parallel_for(__fst::async::thread_pool& pool, size_t count, _Fct&& fct, size_t grain = 0) noexcept
+    {
+        if (grain == 0) { grain = detail::parallel_chunk_count(count, (pool.size() + 1) * 8); }
+
+        if constexpr (__fst::is_invocable_v<_Fct&, size_t, size_t>) { detail::parallel_chunks(pool, count, grain, fct); }
+        else
+        {
+            detail::parallel_chunks(pool, count, grain,
+                [&fct](size_t first, size_t last)
+                {
+                    for (size_t i = first; i < last; i++)
+                    {
+                        fct(i);
+                    }
+                });
+        }
+    }
+
+    template <class _Fct>
+    inline void parallel_for(size_t count, _Fct&& fct, size_t grain = 0) noexcept
+    {
+        __fst::parallel_for(__fst::parallel_thread_pool(), count, fct, grain);
+    }
+
+    /// Calls fct(value) on every element of the container.
+    /// With a grain of 0, each grain covers about parallel_grain_bytes.
+    template <class _Container, class _Fct, __fst::enable_if_t<__fst::is_container_v<__fst::remove_cvref_t<_Container>>, int> = 0>
+    inline void parallel_for_each(__fst::async::thread_pool& pool, _Container&& c, _Fct&& fct, size_t grain = 0) noexcept
+    {
+        using value_type = detail::parallel_value_t<_Container>;
+        auto* data = c.data();
+
+        detail::parallel_chunks(pool, c.size(), detail::parallel_grain<value_type>(grain),
+            [data, &fct](size_t first, size_t last)
+            {
+                for (size_t i = first; i < last; i++)
+                {
+                    fct(data[i]);
+                }
+            });
+    }
+
+    template <class _Container, class _Fct, __fst::enable_if_t<__fst::is_container_v<__fst::remove_cvref_t<_Container>>, int> = 0>
+    inline void parallel_for_each(_Container&& c, _Fct&& fct, size_t grain = 0) noexcept
+    {
+        __fst::parallel_for_each(__fst::parallel_thread_pool(), c, fct, grain);
+    }
+
+    /// out[i] = fct(in[i]), out must be at least as big as in and can be in itself.
+    template <class _InContainer, class _OutContainer, class _Fct,
+        __fst::enable_if_t<__fst::is_container_v<__fst::remove_cvref_t<_InContainer>> && __fst::is_container_v<__fst::remove_cvref_t<_OutContainer>>, int> = 0>
+    inline void parallel_transform(__fst::async::thread_pool& pool, const _InContainer& in, _OutContainer&& out, _Fct&& fct, size_t grain = 0) noexcept
+    {
+        fst_assert(out.size() >= in.size(), "output too small");
+
+        using value_type = detail::parallel_value_t<_OutContainer>;
+        const auto* src = in.data();
+        auto* dst = out.data();
+
+        detail::parallel_chunks(pool, in.size(), detail::parallel_grain<value_type>(grain),
+            [src, dst, &fct](size_t first, size_t last)
+            {
+                for (size_t i = first; i < last; i++)
+                {
+                    dst[i] = fct(src[i]);
+                }
+            });
+    }
+
+    template <class _InContainer, class _OutContainer, class _Fct,
+        __fst::enable_if_t<__fst::is_container_v<__fst::remove_cvref_t<_InContainer>> && __fst::is_container_v<__fst::remove_cvref_t<_OutContainer>>, int> = 0>
+    inline void parallel_transform(const _InContainer& in, _OutContainer&& out, _Fct&& fct, size_t grain = 0) noexcept
+    {
+        __fst::parallel_transform(__fst::parallel_thread_pool(), in, out, fct, grain);
+    }
+
+    /// Folds the container with op, starting from init.
+    ///
+    /// op must be associative. Each grain is folded on its own and the partial results
+    /// are combined in order, the result only depends on the grain size and not on the
+    /// number of threads (floating point sums are reproducible).
+    template <class _Container, class _T, class _Op, __fst::enable_if_t<__fst::is_container_v<__fst::remove_cvref_t<_Container>>, int> = 0>
+    FST_NODISCARD inline _T parallel_reduce(__fst::async::thread_pool& pool, const _Container& c, _T init, _Op&& op, size_t grain = 0) noexcept
+    {
+        using value_type = detail::parallel_value_t<_Container>;
+
+        struct alignas(__fst::cache_line_size) partial
+        {
+            _T value;
+        };
+
+        const size_t count = c.size();
+        if (count == 0) { return init; }
+
+        grain = detail::parallel_grain<value_type>(grain);
+        const size_t chunk_count = detail::parallel_chunk_count(count, grain);
+        const auto* data = c.data();
+
+        partial* partials = (partial*) __fst::aligned_allocate<__fst::async_memory_category>(chunk_count * sizeof(partial), alignof(partial));
+        fst_assert(partials, "allocation failed");
+
+        detail::parallel_chunks(pool, count, grain,
+            [data, grain, partials, &op](size_t first, size_t last)
+            {
+                _T value = data[first];
+                for (size_t i = first + 1; i < last; i++)
+                {
+                    value = op(value, data[i]);
+                }
+
+                fst_placement_new(&partials[first / grain]) partial{ __fst::move(value) };
+            });
+
+        for (size_t i = 0; i < chunk_count; i++)
+        {
+            init = op(init, partials[i].value);
+            partials[i].~partial();
+        }
+
+        __fst::aligned_deallocate<__fst::async_memory_category>(partials);
+        return init;
+    }
+
+    template <class _Container, class _T, class _Op, __fst::enable_if_t<__fst::is_container_v<__fst::remove_cvref_t<_Container>>, int> = 0>
+    FST_NODISCARD inline _T parallel_reduce(const _Container& c, _T init, _Op&& op, size_t grain = 0) noexcept
+    {
+        return __fst::parallel_reduce(__fst::parallel_thread_pool(), c, __fst::move(init), op, grain);
+    }
+
+    /// Stable parallel merge sort.
+    ///
+    /// Grains are sorted independently, then merged two by two. Every merge is itself cut
+    /// in grains with a binary search on the merge path, all the workers stay busy up to
+    /// the last merge. Needs a temporary buffer as big as the container.
+    template <class _Container, class _Compare = __fst::less<>, __fst::enable_if_t<__fst::is_container_v<__fst::remove_cvref_t<_Container>>, int> = 0>
+    inline void parallel_sort(__fst::async::thread_pool& pool, _Container&& c, _Compare comp = _Compare{}, size_t grain = 0) noexcept
+    {
+        using value_type = detail::parallel_value_t<_Container>;
+        static_assert(__fst::is_trivially_copyable_v<value_type>, "parallel_sort only moves trivially copyable values");
+
+        const size_t count = c.size();
+        if (count < 2) { return; }
+
+        grain = detail::parallel_grain<value_type>(grain);
+
+        value_type* data = c.data();
+        value_type* tmp = (value_type*) __fst::aligned_allocate<__fst::async_memory_category>(count * sizeof(value_type), alignof(value_type));
+        fst_assert(tmp, "allocation failed");
+
+        detail::parallel_chunks(pool, count, grain,
+            [data, tmp, &comp](size_t first, size_t last) { detail::parallel_sort_grain(data + first, tmp + first, last - first, comp); });
+
+        value_type* src = data;
+        value_type* dst = tmp;
+
+        for (size_t width = grain; width < count; width *= 2)
+        {
+            const size_t segments_per_pair = detail::parallel_chunk_count(2 * width, grain);
+            const size_t pair_count = detail::parallel_chunk_count(count, 2 * width);
+
+            detail::parallel_chunks(pool, pair_count * segments_per_pair, 1,
+                [=, &comp](size_t segment_first, size_t segment_last)
+                {
+                    for (size_t segment = segment_first; segment < segment_last; segment++)
+                    {
+                        const size_t first = (segment / segments_per_pair) * 2 * width;
+                        const size_t mid = __fst::minimum(first + width, count);
+                        const size_t last = __fst::minimum(first + 2 * width, count);
+
+                        const size_t k0 = (segment % segments_per_pair) * grain;
+                        if (first + k0 >= last) { continue; }
+                        const size_t k1 = __fst::minimum(k0 + grain, last - first);
+
+                        const value_type* a = src + first;
+                        const value_type* b = src + mid;
+                        const size_t a_size = mid - first;
+                        const size_t b_size = last - mid;
+
+                        const size_t i0 = detail::parallel_co_rank(k0, a, a_size, b, b_size, comp);
+                        const size_t i1 = detail::parallel_co_rank(k1, a, a_size, b, b_size, comp);
+                        detail::parallel_merge(a + i0, a + i1, b + (k0 - i0), b + (k1 - i1), dst + first + k0, comp);
+                    }
+                });
+
+            __fst::mem_swap(src, dst);
+        }
+
+        if (src != data)
+        {
+            detail::parallel_chunks(pool, count, grain,
+                [data, src](size_t first, size_t last) { __fst::memcpy(data + first, src + first, (last - first) * sizeof(value_type)); });
+        }
+
+        __fst::aligned_deallocate<__fst::async_memory_category>(tmp);
+    }
+
+    template <class _Container, class _Compare = __fst::less<>, __fst::enable_if_t<__fst::is_container_v<__fst::remove_cvref_t<_Container>>, int> = 0>
+    inline void parallel_sort(_Container&& c, _Compare comp = _Compare{}, size_t grain = 0) noexcept
+    {
+        __fst::parallel_sort(__fst::parallel_thread_pool(), c, comp, grain);
+    }
+
+FST_END_NAMESPACE
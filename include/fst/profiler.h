@@ -48,6 +48,22 @@ FST_BEGIN_NAMESPACE
             size_t size;
         };
 
+        /// Aggregated allocation counters of a zone/category pair.
+        struct counters
+        {
+            /// Bytes currently allocated.
+            int64_t bytes;
+
+            /// Number of live allocations.
+            int64_t count;
+
+            /// Number of allocations since the start of the program.
+            uint64_t total_count;
+
+            /// Bytes allocated since the start of the program.
+            uint64_t total_bytes;
+        };
+
         static __fst::output_stream<char>& tracer(const char* section);
 
         template <typename... Ts>
@@ -67,32 +83,25 @@ FST_BEGIN_NAMESPACE
             else { stream << __fst::separator_endl; }
         }
 
+        /// Ends the timeline slice opened by strace.
         struct scoped_trace
         {
             const char* section;
+            bool recorded;
 
-            ~scoped_trace() { trace(section, "end"); }
+            inline ~scoped_trace() noexcept
+            {
+                if (recorded) { timeline_end(section); }
+            }
         };
 
+        /// Opens a slice on the calling thread timeline until the returned scope is destroyed.
+        /// The section must outlive the profiler (e.g. a string literal), the extra arguments
+        /// are not recorded.
         template <typename... Ts>
-        FST_NODISCARD static inline scoped_trace strace(const char* section, const Ts&... ts)
+        FST_NODISCARD static inline scoped_trace strace(const char* section, const Ts&...) noexcept
         {
-
-            __fst::output_stream<char>& stream = tracer("section")
-                                                 << __fst::stream_detail::sep_t{} << __fst::padded_right<32>(section) << __fst::stream_detail::sep_t{} << " begin";
-
-            if constexpr (sizeof...(ts) > 1)
-            {
-                basic_print<__fst::output_stream<char>, __fst::stream_detail::sep_t, __fst::stream_detail::sep_endl_t>(stream << __fst::stream_detail::sep_t{}, ts...);
-            }
-            else if constexpr (sizeof...(ts) == 1)
-            {
-                print_element(stream << __fst::stream_detail::sep_t{}, ts...);
-                stream << __fst::stream_detail::sep_endl_t{};
-            }
-            else { stream << __fst::stream_detail::sep_endl_t{}; }
-
-            return scoped_trace{ section };
+            return scoped_trace{ section, timeline_begin(section) };
         }
 
         using result_type = __fst::vector<result, alignof(result), __fst::profiler_memory_category, __fst::profiler_memory_zone>;
@@ -102,6 +111,46 @@ FST_BEGIN_NAMESPACE
         static result_type report();
         static void output(__fst::output_stream<char>& stream);
 
+        /// Returns the counters of a zone/category pair.
+        /// Ids past the profiler capacity share the last slot.
+        FST_NODISCARD static counters get_counters(__fst::memory_zone_id zid, __fst::memory_category_id mid) noexcept;
+
+        /// Enables the 'memory' trace of every allocation and deallocation (off by default).
+        /// Events are buffered per thread and written to the trace log by flush(),
+        /// when the buffer is full or when the thread exits.
+        static void set_memory_event_logging(bool enabled) noexcept;
+
+        FST_NODISCARD static bool is_memory_event_logging_enabled() noexcept;
+
+        /// Writes the memory events buffered by the calling thread.
+        static void flush() noexcept;
+
+        //
+        // Timeline.
+        //
+        // FST_STRACE scopes are recorded as begin/end events with a monotonic time stamp and
+        // the thread id, in a lock-free buffer per thread. write_timeline exports them as
+        // Chrome trace event JSON, which loads in chrome://tracing and ui.perfetto.dev.
+        // What's left at exit is written to FST_PROFILER_TIMELINE_PATH.
+        //
+
+        /// Records the beginning of a slice on the calling thread.
+        /// @returns false if the event was dropped because the thread buffer is full,
+        ///          the matching timeline_end must then be skipped.
+        static bool timeline_begin(const char* name) noexcept;
+
+        static void timeline_end(const char* name) noexcept;
+
+        /// Adds a point to the counter track of every zone/category pair that was used,
+        /// typically once per frame. write_timeline also takes a sample.
+        static void sample_memory_counters() noexcept;
+
+        /// Writes the recorded events and removes them from the thread buffers.
+        static void write_timeline(__fst::output_stream<char>& stream) noexcept;
+
+        /// @returns false if the file couldn't be created.
+        static bool write_timeline(const char* path) noexcept;
+
         template <class _MemoryCategory, __fst::enable_if_t<__fst::is_memory_category<_MemoryCategory>::value, int> = 0>
         static inline void register_name()
         {
@@ -147,6 +196,17 @@ FST_BEGIN_NAMESPACE
         static result_type report() { return {}; }
         FST_ALWAYS_INLINE static constexpr void output(__fst::output_stream<char>&) {}
 
+        FST_NODISCARD FST_ALWAYS_INLINE static constexpr counters get_counters(__fst::memory_zone_id, __fst::memory_category_id) noexcept { return {}; }
+        FST_ALWAYS_INLINE static constexpr void set_memory_event_logging(bool) noexcept {}
+        FST_NODISCARD FST_ALWAYS_INLINE static constexpr bool is_memory_event_logging_enabled() noexcept { return false; }
+        FST_ALWAYS_INLINE static constexpr void flush() noexcept {}
+
+        FST_ALWAYS_INLINE static constexpr bool timeline_begin(const char*) noexcept { return false; }
+        FST_ALWAYS_INLINE static constexpr void timeline_end(const char*) noexcept {}
+        FST_ALWAYS_INLINE static constexpr void sample_memory_counters() noexcept {}
+        FST_ALWAYS_INLINE static constexpr void write_timeline(__fst::output_stream<char>&) noexcept {}
+        FST_ALWAYS_INLINE static constexpr bool write_timeline(const char*) noexcept { return false; }
+
         template <class _MemoryCategory, __fst::enable_if_t<__fst::is_memory_category<_MemoryCategory>::value, int> = 0>
         FST_ALWAYS_INLINE static constexpr void register_name()
         {}
@@ -0,0 +1,410 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Alexandre Arsenault
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#pragma once
+
+#include "fst/common.h"
+#include "fst/iterator.h"
+#include "fst/math.h"
+#include "fst/memory.h"
+#include "fst/memory_range.h"
+#include "fst/memory_utils.h"
+#include "fst/traits.h"
+#include "fst/utility.h"
+#include "fst/vector.h"
+
+FST_BEGIN_NAMESPACE
+
+    namespace detail
+    {
+        /// Elements per chunk so that a chunk is about 16 KiB.
+        template <class _T>
+        FST_INLINE_VAR constexpr size_t segmented_vector_chunk_size = sizeof(_T) >= 16384 ? 1 : (size_t) __fst::round_to_power_of_two((uint32_t) (16384 / sizeof(_T)));
+    } // namespace detail
+
+    /// Vector made of fixed size chunks that are never moved once allocated.
+    ///
+    /// Growing allocates one more chunk and only appends its pointer to the chunk directory,
+    /// elements are never relocated: the cost of push_back doesn't spike when a large vector
+    /// grows and pointers to elements stay valid until they are erased.
+    /// Random access is a shift and a mask into the directory.
+    ///
+    /// Elements are only contiguous inside a chunk, use chunk() or for_each_chunk() to process
+    /// them in contiguous blocks (e.g. one chunk per task).
+    template <class _T, size_t _ChunkSize = __fst::detail::segmented_vector_chunk_size<_T>, size_t _Alignment = alignof(_T),
+        class _MemoryZone = __fst::default_memory_zone, class _MemoryCategory = __fst::default_memory_category>
+    class segmented_vector
+    {
+      public:
+        static_assert(__fst::is_power_of_two(_ChunkSize), "_ChunkSize must be a power of two");
+        static_assert(__fst::is_power_of_two(_Alignment), "_Alignment must be a power of two");
+
+        using value_type = _T;
+        using size_type = size_t;
+        using difference_type = ptrdiff_t;
+        using pointer = value_type*;
+        using const_pointer = const value_type*;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+
+        using memory_zone_type = _MemoryZone;
+        using chunk_range = __fst::memory_range<value_type>;
+        using const_chunk_range = __fst::memory_range<const value_type>;
+
+        static constexpr size_type chunk_size = _ChunkSize;
+        static constexpr size_type chunk_shift = (size_type) __fst::log2_of_power_of_two((uint32_t) _ChunkSize);
+        static constexpr size_type chunk_mask = _ChunkSize - 1;
+
+        template <bool _IsConst>
+        class basic_iterator
+        {
+          public:
+            using container_type = __fst::conditional_t<_IsConst, const segmented_vector, segmented_vector>;
+            using value_type = _T;
+            using size_type = size_t;
+            using difference_type = ptrdiff_t;
+            using pointer = __fst::conditional_t<_IsConst, const _T*, _T*>;
+            using reference = __fst::conditional_t<_IsConst, const _T&, _T&>;
+            using iterator_category = __fst::random_access_iterator_tag;
+
+            basic_iterator() noexcept = default;
+            basic_iterator(const basic_iterator&) noexcept = default;
+            basic_iterator& operator=(const basic_iterator&) noexcept = default;
+
+            FST_ALWAYS_INLINE basic_iterator(container_type* vec, size_type index) noexcept
+                : _vec(vec)
+                , _index(index)
+            {}
+
+            template <bool _C = _IsConst, __fst::enable_if_t<_C, int> = 0>
+            FST_ALWAYS_INLINE basic_iterator(const basic_iterator<false>& it) noexcept
+                : _vec(it._vec)
+                , _index(it._index)
+            {}
+
+            FST_NODISCARD FST_ALWAYS_INLINE reference operator*() const noexcept { return (*_vec)[_index]; }
+            FST_NODISCARD FST_ALWAYS_INLINE pointer operator->() const noexcept { return &(*_vec)[_index]; }
+            FST_NODISCARD FST_ALWAYS_INLINE reference operator[](difference_type n) const noexcept { return (*_vec)[_index + n]; }
+
+            FST_NODISCARD FST_ALWAYS_INLINE size_type index() const noexcept { return _index; }
+
+            FST_ALWAYS_INLINE basic_iterator& operator++() noexcept
+            {
+                ++_index;
+                return *this;
+            }
+
+            FST_ALWAYS_INLINE basic_iterator operator++(int) noexcept { return basic_iterator(_vec, _index++); }
+
+            FST_ALWAYS_INLINE basic_iterator& operator--() noexcept
+            {
+                --_index;
+                return *this;
+            }
+
+            FST_ALWAYS_INLINE basic_iterator operator--(int) noexcept { return basic_iterator(_vec, _index--); }
+
+            FST_ALWAYS_INLINE basic_iterator& operator+=(difference_type n) noexcept
+            {
+                _index += n;
+                return *this;
+            }
+
+            FST_ALWAYS_INLINE basic_iterator& operator-=(difference_type n) noexcept
+            {
+                _index -= n;
+                return *this;
+            }
+
+            FST_NODISCARD FST_ALWAYS_INLINE basic_iterator operator+(difference_type n) const noexcept { return basic_iterator(_vec, _index + n); }
+            FST_NODISCARD FST_ALWAYS_INLINE basic_iterator operator-(difference_type n) const noexcept { return basic_iterator(_vec, _index - n); }
+            FST_NODISCARD FST_ALWAYS_INLINE difference_type operator-(const basic_iterator& it) const noexcept { return (difference_type) _index - (difference_type) it._index; }
+
+            FST_NODISCARD FST_ALWAYS_INLINE bool operator==(const basic_iterator& it) const noexcept { return _index == it._index; }
+            FST_NODISCARD FST_ALWAYS_INLINE bool operator!=(const basic_iterator& it) const noexcept { return _index != it._index; }
+            FST_NODISCARD FST_ALWAYS_INLINE bool operator<(const basic_iterator& it) const noexcept { return _index < it._index; }
+            FST_NODISCARD FST_ALWAYS_INLINE bool operator<=(const basic_iterator& it) const noexcept { return _index <= it._index; }
+            FST_NODISCARD FST_ALWAYS_INLINE bool operator>(const basic_iterator& it) const noexcept { return _index > it._index; }
+            FST_NODISCARD FST_ALWAYS_INLINE bool operator>=(const basic_iterator& it) const noexcept { return _index >= it._index; }
+
+          private:
+            container_type* _vec = nullptr;
+            size_type _index = 0;
+
+            friend class basic_iterator<true>;
+        };
+
+        using iterator = basic_iterator<false>;
+        using const_iterator = basic_iterator<true>;
+
+        template <class _Zone = memory_zone_type, __fst::enable_if_t<__fst::is_default_constructible_v<_Zone>, int> = 0>
+        inline segmented_vector() noexcept
+        {}
+
+        template <class _Zone = memory_zone_type, __fst::enable_if_t<__fst::is_copy_constructible_v<_Zone>, int> = 0>
+        inline segmented_vector(const memory_zone_type& zone) noexcept
+            : _chunks(zone)
+        {}
+
+        inline segmented_vector(const segmented_vector& other) noexcept
+            : _chunks(other._chunks.get_memory_zone())
+        {
+            append(other);
+        }
+
+        inline segmented_vector(segmented_vector&& other) noexcept
+            : _chunks(__fst::move(other._chunks))
+            , _size(__fst::exchange(other._size, 0))
+        {}
+
+        inline ~segmented_vector() noexcept { reset(); }
+
+        inline segmented_vector& operator=(const segmented_vector& other) noexcept
+        {
+            if (this == &other) { return *this; }
+
+            clear();
+            append(other);
+            return *this;
+        }
+
+        inline segmented_vector& operator=(segmented_vector&& other) noexcept
+        {
+            if (this == &other) { return *this; }
+
+            reset();
+            _chunks = __fst::move(other._chunks);
+            _size = __fst::exchange(other._size, 0);
+            return *this;
+        }
+
+        FST_NODISCARD FST_ALWAYS_INLINE constexpr size_type size() const noexcept { return _size; }
+        FST_NODISCARD FST_ALWAYS_INLINE constexpr bool empty() const noexcept { return _size == 0; }
+        FST_NODISCARD FST_ALWAYS_INLINE constexpr size_type capacity() const noexcept { return _chunks.size() * chunk_size; }
+        FST_NODISCARD FST_ALWAYS_INLINE static constexpr size_t alignment() noexcept { return _Alignment; }
+
+        FST_NODISCARD FST_ALWAYS_INLINE reference operator[](size_type index) noexcept
+        {
+            fst_assert(index < _size, "segmented_vector index out of bounds");
+            return _chunks[index >> chunk_shift][index & chunk_mask];
+        }
+
+        FST_NODISCARD FST_ALWAYS_INLINE const_reference operator[](size_type index) const noexcept
+        {
+            fst_assert(index < _size, "segmented_vector index out of bounds");
+            return _chunks[index >> chunk_shift][index & chunk_mask];
+        }
+
+        FST_NODISCARD FST_ALWAYS_INLINE reference front() noexcept { return (*this)[0]; }
+        FST_NODISCARD FST_ALWAYS_INLINE const_reference front() const noexcept { return (*this)[0]; }
+        FST_NODISCARD FST_ALWAYS_INLINE reference back() noexcept { return (*this)[_size - 1]; }
+        FST_NODISCARD FST_ALWAYS_INLINE const_reference back() const noexcept { return (*this)[_size - 1]; }
+
+        FST_NODISCARD FST_ALWAYS_INLINE iterator begin() noexcept { return iterator(this, 0); }
+        FST_NODISCARD FST_ALWAYS_INLINE const_iterator begin() const noexcept { return const_iterator(this, 0); }
+        FST_NODISCARD FST_ALWAYS_INLINE iterator end() noexcept { return iterator(this, _size); }
+        FST_NODISCARD FST_ALWAYS_INLINE const_iterator end() const noexcept { return const_iterator(this, _size); }
+        FST_NODISCARD FST_ALWAYS_INLINE const_iterator cbegin() const noexcept { return begin(); }
+        FST_NODISCARD FST_ALWAYS_INLINE const_iterator cend() const noexcept { return end(); }
+
+        /// Number of chunks holding at least one element.
+        FST_NODISCARD FST_ALWAYS_INLINE size_type chunk_count() const noexcept { return (_size + chunk_mask) >> chunk_shift; }
+
+        /// Contiguous elements of a chunk, every chunk is full except the last one.
+        FST_NODISCARD inline chunk_range chunk(size_type index) noexcept
+        {
+            fst_assert(index < chunk_count(), "segmented_vector chunk index out of bounds");
+            return chunk_range(_chunks[index], chunk_length(index));
+        }
+
+        FST_NODISCARD inline const_chunk_range chunk(size_type index) const noexcept
+        {
+            fst_assert(index < chunk_count(), "segmented_vector chunk index out of bounds");
+            return const_chunk_range(_chunks[index], chunk_length(index));
+        }
+
+        /// Calls fct(range, first_index) for every chunk in order.
+        template <class _Fct>
+        inline void for_each_chunk(_Fct && fct) noexcept
+        {
+            const size_type count = chunk_count();
+            for (size_type i = 0; i < count; i++)
+            {
+                fct(chunk(i), i << chunk_shift);
+            }
+        }
+
+        template <class _Fct>
+        inline void for_each_chunk(_Fct && fct) const noexcept
+        {
+            const size_type count = chunk_count();
+            for (size_type i = 0; i < count; i++)
+            {
+                fct(chunk(i), i << chunk_shift);
+            }
+        }
+
+        inline void push_back(const_reference value) noexcept { emplace_back(value); }
+        inline void push_back(value_type&& value) noexcept { emplace_back(__fst::move(value)); }
+
+        template <class... _Args>
+        inline reference emplace_back(_Args&&... args) noexcept
+        {
+            if ((_size >> chunk_shift) == _chunks.size() && !add_chunk())
+            {
+                fst_error("segmented_vector allocation failed");
+                return back();
+            }
+
+            pointer ptr = _chunks[_size >> chunk_shift] + (_size & chunk_mask);
+            fst_placement_new(ptr) value_type(__fst::forward<_Args>(args)...);
+            _size++;
+            return *ptr;
+        }
+
+        inline void pop_back() noexcept
+        {
+            fst_assert(_size > 0, "Can't pop_back an empty segmented_vector.");
+            --_size;
+            // Not through operator[], _size is already past the element.
+            if constexpr (!__fst::is_trivially_destructible_v<value_type>) { _chunks[_size >> chunk_shift][_size & chunk_mask].~value_type(); }
+        }
+
+        /// Allocates the chunks needed to hold count elements.
+        inline void reserve(size_type count) noexcept
+        {
+            const size_type needed = (count + chunk_mask) >> chunk_shift;
+            if (needed <= _chunks.size()) { return; }
+
+            _chunks.reserve(needed);
+            while (_chunks.size() < needed)
+            {
+                if (!add_chunk())
+                {
+                    fst_error("segmented_vector allocation failed");
+                    return;
+                }
+            }
+        }
+
+        inline void resize(size_type count) noexcept
+        {
+            if (count < _size)
+            {
+                destroy_from(count);
+                return;
+            }
+
+            reserve(count);
+            while (_size < count)
+            {
+                emplace_back();
+            }
+        }
+
+        inline void resize(size_type count, const_reference value) noexcept
+        {
+            if (count < _size)
+            {
+                destroy_from(count);
+                return;
+            }
+
+            reserve(count);
+            while (_size < count)
+            {
+                emplace_back(value);
+            }
+        }
+
+        /// Destroys the elements, the chunks are kept.
+        inline void clear() noexcept { destroy_from(0); }
+
+        /// Releases the chunks that don't hold any element.
+        inline void shrink_to_fit() noexcept
+        {
+            const size_type used = chunk_count();
+            while (_chunks.size() > used)
+            {
+                release_chunk(_chunks.back());
+                _chunks.pop_back();
+            }
+        }
+
+        /// Destroys the elements and releases every chunk.
+        inline void reset() noexcept
+        {
+            clear();
+            shrink_to_fit();
+        }
+
+        template <class _Container>
+        inline void append(const _Container& other) noexcept
+        {
+            reserve(_size + other.size());
+            for (const auto& value : other)
+            {
+                emplace_back(value);
+            }
+        }
+
+        FST_NODISCARD FST_ALWAYS_INLINE const memory_zone_type& get_memory_zone() const noexcept { return _chunks.get_memory_zone(); }
+        FST_NODISCARD FST_ALWAYS_INLINE memory_zone_type& get_memory_zone() noexcept { return _chunks.get_memory_zone(); }
+
+      private:
+        __fst::vector<pointer, alignof(pointer), _MemoryCategory, _MemoryZone> _chunks;
+        size_type _size = 0;
+
+        FST_NODISCARD FST_ALWAYS_INLINE size_type chunk_length(size_type index) const noexcept
+        {
+            return __fst::minimum(_size - (index << chunk_shift), chunk_size);
+        }
+
+        inline bool add_chunk() noexcept
+        {
+            pointer ptr = (pointer) _chunks.get_memory_zone().aligned_allocate(chunk_size * sizeof(value_type), _Alignment, _MemoryCategory::id());
+            if (!ptr) { return false; }
+
+            _chunks.push_back(ptr);
+            return true;
+        }
+
+        FST_ALWAYS_INLINE void release_chunk(pointer ptr) noexcept { _chunks.get_memory_zone().aligned_deallocate((void*) ptr, _MemoryCategory::id()); }
+
+        inline void destroy_from(size_type count) noexcept
+        {
+            if constexpr (!__fst::is_trivially_destructible_v<value_type>)
+            {
+                for (size_type i = count; i < _size; i++)
+                {
+                    (*this)[i].~value_type();
+                }
+            }
+
+            _size = count;
+        }
+    };
+
+FST_END_NAMESPACE
@@ -0,0 +1,309 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Alexandre Arsenault
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#pragma once
+
+///
+/// @file fst/simd_dispatch.h
+///
+/// Runtime dispatch of the simd container kernels.
+///
+/// fst/simd.h picks its vector width at compile time (FST_USE_SIMD_128/256/512).
+/// With FST_USE_SIMD_DISPATCH, the library also builds a set of kernels for every
+/// instruction set level (src/simd/dispatch_*.cpp, each one with its own target)
+/// and the best one supported by the cpu is selected once on first use (cpuid/xgetbv).
+/// Without FST_USE_SIMD_DISPATCH, or on a non x86 platform, only the scalar kernels exist.
+///
+/// Every pointer given to a kernel must be aligned on dispatch_alignment, the widest
+/// vector alignment.
+///
+/// @code
+///     fst::simd::buffer<float, fst::simd::dispatch_alignment> a(1024);
+///     fst::simd::buffer<float, fst::simd::dispatch_alignment> b(1024);
+///     fst::simd::dispatch::mul(a.data(), b.data(), a.size());
+///     fst::simd::dispatch::add(a.data(), 0.25f, a.size());
+/// @endcode
+///
+/// force_isa_level() overrides the detected level, mostly to test every level on the
+/// same machine.
+///
+
+#include "fst/common.h"
+#include "fst/memory_utils.h"
+
+FST_BEGIN_SUB_NAMESPACE(simd)
+
+    ///
+    enum class isa_level : uint8_t {
+        scalar,
+        sse4_1, // 128 bits.
+        avx2, // 256 bits, with fma.
+        avx512 // 512 bits, AVX512F.
+    };
+
+    /// Alignment required by the kernels.
+    FST_INLINE_VAR constexpr size_t dispatch_alignment = 64;
+
+    /// Highest level supported by both the cpu and the build.
+    /// The cpu is only queried on the first call.
+    FST_NODISCARD isa_level detected_isa_level() noexcept;
+
+    /// Level used by the kernels, detected_isa_level() unless forced.
+    FST_NODISCARD isa_level current_isa_level() noexcept;
+
+    /// Use the kernels of the given level, returns false when it is higher than detected_isa_level().
+    /// Not meant to be called while other threads are using the kernels.
+    bool force_isa_level(isa_level level) noexcept;
+
+    /// Go back to detected_isa_level().
+    void reset_isa_level() noexcept;
+
+    FST_NODISCARD const char* isa_level_name(isa_level level) noexcept;
+
+    /// Function pointers of one instruction set level.
+    /// Same operations as the simd container methods with the same name.
+    template <class T>
+    struct kernel_table
+    {
+        // dst[i] = value
+        void (*fill)(T* dst, T value, size_t size) noexcept;
+
+        // dst[i] = a[i]
+        void (*assign)(T* dst, const T* a, size_t size) noexcept;
+
+        // dst[i] += a[i]
+        void (*add)(T* dst, const T* a, size_t size) noexcept;
+
+        // dst[i] += a
+        void (*add_value)(T* dst, T a, size_t size) noexcept;
+
+        // dst[i] -= a[i]
+        void (*sub)(T* dst, const T* a, size_t size) noexcept;
+
+        // dst[i] -= a
+        void (*sub_value)(T* dst, T a, size_t size) noexcept;
+
+        // dst[i] *= a[i]
+        void (*mul)(T* dst, const T* a, size_t size) noexcept;
+
+        // dst[i] *= a
+        void (*mul_value)(T* dst, T a, size_t size) noexcept;
+
+        // dst[i] /= a[i]
+        void (*div)(T* dst, const T* a, size_t size) noexcept;
+
+        // dst[i] /= a
+        void (*div_value)(T* dst, T a, size_t size) noexcept;
+
+        // dst[i] += a[i] * b[i]
+        void (*add_mul)(T* dst, const T* a, const T* b, size_t size) noexcept;
+
+        // dst[i] += a[i] * b
+        void (*add_mul_value)(T* dst, const T* a, T b, size_t size) noexcept;
+
+        // dst[i] = (dst[i] * a) + b
+        void (*mul_then_sum)(T* dst, T a, T b, size_t size) noexcept;
+
+        // dst[i] = min(dst[i], a[i])
+        void (*min)(T* dst, const T* a, size_t size) noexcept;
+
+        // dst[i] = max(dst[i], a[i])
+        void (*max)(T* dst, const T* a, size_t size) noexcept;
+
+        // dst[i] = sin(a[i])
+        void (*sin)(T* dst, const T* a, size_t size) noexcept;
+
+        // dst[i] = cos(dst[i])
+        void (*cos)(T* dst, size_t size) noexcept;
+
+        // dst[i] = tan(dst[i])
+        void (*tan)(T* dst, size_t size) noexcept;
+    };
+
+    /// Kernels of current_isa_level(), float and double only.
+    template <class T>
+    FST_NODISCARD const kernel_table<T>& get_kernels() noexcept;
+
+    template <>
+    FST_NODISCARD const kernel_table<float>& get_kernels<float>() noexcept;
+
+    template <>
+    FST_NODISCARD const kernel_table<double>& get_kernels<double>() noexcept;
+
+    /// Kernels of a given level, nullptr when it wasn't built.
+    template <class T>
+    FST_NODISCARD const kernel_table<T>* get_kernels(isa_level level) noexcept;
+
+    template <>
+    FST_NODISCARD const kernel_table<float>* get_kernels<float>(isa_level level) noexcept;
+
+    template <>
+    FST_NODISCARD const kernel_table<double>* get_kernels<double>(isa_level level) noexcept;
+
+    namespace dispatch
+    {
+#define FST_SIMD_DISPATCH_CHECK_ALIGNMENT(ptr) fst_assert(__fst::is_aligned(ptr, __fst::simd::dispatch_alignment), "Wrong alignment")
+
+        template <class T>
+        FST_ALWAYS_INLINE void fill(T* dst, T value, size_t size) noexcept
+        {
+            FST_SIMD_DISPATCH_CHECK_ALIGNMENT(dst);
+            __fst::simd::get_kernels<T>().fill(dst, value, size);
+        }
+
+        template <class T>
+        FST_ALWAYS_INLINE void assign(T* dst, const T* a, size_t size) noexcept
+        {
+            FST_SIMD_DISPATCH_CHECK_ALIGNMENT(dst);
+            FST_SIMD_DISPATCH_CHECK_ALIGNMENT(a);
+            __fst::simd::get_kernels<T>().assign(dst, a, size);
+        }
+
+        template <class T>
+        FST_ALWAYS_INLINE void add(T* dst, const T* a, size_t size) noexcept
+        {
+            FST_SIMD_DISPATCH_CHECK_ALIGNMENT(dst);
+            FST_SIMD_DISPATCH_CHECK_ALIGNMENT(a);
+            __fst::simd::get_kernels<T>().add(dst, a, size);
+        }
+
+        template <class T>
+        FST_ALWAYS_INLINE void add(T* dst, __fst::type_identity_t<T> a, size_t size) noexcept
+        {
+            FST_SIMD_DISPATCH_CHECK_ALIGNMENT(dst);
+            __fst::simd::get_kernels<T>().add_value(dst, a, size);
+        }
+
+        template <class T>
+        FST_ALWAYS_INLINE void sub(T* dst, const T* a, size_t size) noexcept
+        {
+            FST_SIMD_DISPATCH_CHECK_ALIGNMENT(dst);
+            FST_SIMD_DISPATCH_CHECK_ALIGNMENT(a);
+            __fst::simd::get_kernels<T>().sub(dst, a, size);
+        }
+
+        template <class T>
+        FST_ALWAYS_INLINE void sub(T* dst, __fst::type_identity_t<T> a, size_t size) noexcept
+        {
+            FST_SIMD_DISPATCH_CHECK_ALIGNMENT(dst);
+            __fst::simd::get_kernels<T>().sub_value(dst, a, size);
+        }
+
+        template <class T>
+        FST_ALWAYS_INLINE void mul(T* dst, const T* a, size_t size) noexcept
+        {
+            FST_SIMD_DISPATCH_CHECK_ALIGNMENT(dst);
+            FST_SIMD_DISPATCH_CHECK_ALIGNMENT(a);
+            __fst::simd::get_kernels<T>().mul(dst, a, size);
+        }
+
+        template <class T>
+        FST_ALWAYS_INLINE void mul(T* dst, __fst::type_identity_t<T> a, size_t size) noexcept
+        {
+            FST_SIMD_DISPATCH_CHECK_ALIGNMENT(dst);
+            __fst::simd::get_kernels<T>().mul_value(dst, a, size);
+        }
+
+        template <class T>
+        FST_ALWAYS_INLINE void div(T* dst, const T* a, size_t size) noexcept
+        {
+            FST_SIMD_DISPATCH_CHECK_ALIGNMENT(dst);
+            FST_SIMD_DISPATCH_CHECK_ALIGNMENT(a);
+            __fst::simd::get_kernels<T>().div(dst, a, size);
+        }
+
+        template <class T>
+        FST_ALWAYS_INLINE void div(T* dst, __fst::type_identity_t<T> a, size_t size) noexcept
+        {
+            FST_SIMD_DISPATCH_CHECK_ALIGNMENT(dst);
+            __fst::simd::get_kernels<T>().div_value(dst, a, size);
+        }
+
+        template <class T>
+        FST_ALWAYS_INLINE void add_mul(T* dst, const T* a, const T* b, size_t size) noexcept
+        {
+            FST_SIMD_DISPATCH_CHECK_ALIGNMENT(dst);
+            FST_SIMD_DISPATCH_CHECK_ALIGNMENT(a);
+            FST_SIMD_DISPATCH_CHECK_ALIGNMENT(b);
+            __fst::simd::get_kernels<T>().add_mul(dst, a, b, size);
+        }
+
+        template <class T>
+        FST_ALWAYS_INLINE void add_mul(T* dst, const T* a, __fst::type_identity_t<T> b, size_t size) noexcept
+        {
+            FST_SIMD_DISPATCH_CHECK_ALIGNMENT(dst);
+            FST_SIMD_DISPATCH_CHECK_ALIGNMENT(a);
+            __fst::simd::get_kernels<T>().add_mul_value(dst, a, b, size);
+        }
+
+        template <class T>
+        FST_ALWAYS_INLINE void mul_then_sum(T* dst, __fst::type_identity_t<T> a, __fst::type_identity_t<T> b, size_t size) noexcept
+        {
+            FST_SIMD_DISPATCH_CHECK_ALIGNMENT(dst);
+            __fst::simd::get_kernels<T>().mul_then_sum(dst, a, b, size);
+        }
+
+        template <class T>
+        FST_ALWAYS_INLINE void min(T* dst, const T* a, size_t size) noexcept
+        {
+            FST_SIMD_DISPATCH_CHECK_ALIGNMENT(dst);
+            FST_SIMD_DISPATCH_CHECK_ALIGNMENT(a);
+            __fst::simd::get_kernels<T>().min(dst, a, size);
+        }
+
+        template <class T>
+        FST_ALWAYS_INLINE void max(T* dst, const T* a, size_t size) noexcept
+        {
+            FST_SIMD_DISPATCH_CHECK_ALIGNMENT(dst);
+            FST_SIMD_DISPATCH_CHECK_ALIGNMENT(a);
+            __fst::simd::get_kernels<T>().max(dst, a, size);
+        }
+
+        template <class T>
+        FST_ALWAYS_INLINE void sin(T* dst, const T* a, size_t size) noexcept
+        {
+            FST_SIMD_DISPATCH_CHECK_ALIGNMENT(dst);
+            FST_SIMD_DISPATCH_CHECK_ALIGNMENT(a);
+            __fst::simd::get_kernels<T>().sin(dst, a, size);
+        }
+
+        template <class T>
+        FST_ALWAYS_INLINE void cos(T* dst, size_t size) noexcept
+        {
+            FST_SIMD_DISPATCH_CHECK_ALIGNMENT(dst);
+            __fst::simd::get_kernels<T>().cos(dst, size);
+        }
+
+        template <class T>
+        FST_ALWAYS_INLINE void tan(T* dst, size_t size) noexcept
+        {
+            FST_SIMD_DISPATCH_CHECK_ALIGNMENT(dst);
+            __fst::simd::get_kernels<T>().tan(dst, size);
+        }
+
+#undef FST_SIMD_DISPATCH_CHECK_ALIGNMENT
+    } // namespace dispatch
+
+FST_END_SUB_NAMESPACE
@@ -0,0 +1,759 @@
+//
+// MIT License
+//
+// Copyright (c) 2023 Alexandre Arsenault
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#pragma once
+
+///
+/// @file fst/simd_math.h
+///
+/// Vectorized exp, log, pow, sin, cos, tanh, atan2 and sqrt, for float and double.
+///
+/// The kernels are only written with vector_op, the same code runs on every
+/// vector width of fst/simd.h (scalar, SSE4.1, AVX2, AVX-512).
+///
+/// Two accuracy tiers, measured against libm in tests/unit_tests/src/simd/math_tests.cpp:
+///
+/// precision::precise
+///   Under 1 ulp. NaN, infinities, signed zeros, subnormals, overflow and
+///   underflow are handled like libm.
+///
+/// precision::fast
+///   Shorter polynomials and no special value handling, under 3 ulp.
+///   Inputs must be finite and inside the function domain (x > 0 for log and pow).
+///   exp saturates instead of overflowing and never returns a subnormal.
+///
+/// Limits
+///   * sin and cos use a four parts Cody-Waite reduction, they stay accurate while
+///     |x| < 8192 in float and |x| < 1e6 in double, the error grows past that.
+///   * The precise pow carries log(x) as a double word, it stays under 1 ulp up
+///     to overflow and down to the smallest normal result.
+///   * The fast pow is exp(y * log(x)) with a single word log(x), keep |y * log(x)|
+///     small (about 20) for the error to stay under 2 ulp.
+///   * sqrt is the correctly rounded vector instruction on both tiers.
+///
+/// @code
+///   // Kernels, on the vector type of fst/simd.h.
+///   using vmath = fst::simd::math::vector_math_t<float, fst::simd::math::precision::fast>;
+///   const auto y = vmath::exp(x);
+///
+///   // Lazy expressions, see fst/detail/simd/expression.h.
+///   dst = fst::simd::math::exp(fst::simd::expr(a) * -0.5f);
+///   dst = fst::simd::math::tanh<fst::simd::math::precision::fast>(fst::simd::expr(a) * drive);
+/// @endcode
+///
+
+#include "fst/common.h"
+#include "fst/simd.h"
+
+FST_BEGIN_SIMD_NAMESPACE
+
+    namespace math
+    {
+        ///
+        enum class precision : uint8_t {
+            fast,
+            precise
+        };
+
+        namespace detail
+        {
+            /// Minimax polynomials in z, generated with a Chebyshev fit of:
+            /// * exp   : (e^r - 1 - r) / r^2, |r| <= ln(2) / 2
+            /// * log   : (log(1 + f) - 2 * s) / (s * z) with s = f / (2 + f), z = s^2, sqrt(2) / 2 <= 1 + f <= sqrt(2)
+            /// * sin   : (sin(r) - r) / r^3, z = r^2, |r| <= pi / 4
+            /// * cos   : (cos(r) - 1 + z / 2) / z^2, z = r^2, |r| <= pi / 4
+            /// * atan  : (atan(t) - t) / t^3, z = t^2, |t| <= tan(pi / 8)
+            /// * tanh  : (tanh(x) - x) / x^3, z = x^2, |x| <= 0.625
+            template <class _T, precision _Precision>
+            struct coefficients;
+
+            template <>
+            struct coefficients<float, precision::precise>
+            {
+                static constexpr float exp[] = { 0.5f, 0.166666672f, 0.0416664667f, 0.00833331048f, 0.00139336416f, 0.000198909809f };
+                static constexpr float log[] = { 0.666666687f, 0.400001228f, 0.285508215f, 0.233304679f };
+                static constexpr float sin[] = { -0.166666672f, 0.00833333191f, -0.00019840087f, 2.72499256e-06f };
+                static constexpr float cos[] = { 0.0416666679f, -0.00138888881f, 2.48005999e-05f, -2.7300959e-07f };
+                static constexpr float atan[] = { -0.333333343f, 0.199999779f, -0.142841518f, 0.110713653f, -0.0862467587f, 0.0504813865f };
+                static constexpr float tanh[]
+                    = { -0.333333343f, 0.133333325f, -0.0539676398f, 0.0218598954f, -0.00879100431f, 0.00330624753f, -0.00086221681f };
+            };
+
+            template <>
+            struct coefficients<float, precision::fast>
+            {
+                static constexpr float exp[] = { 0.5f, 0.166665778f, 0.0416665561f, 0.00836317334f, 0.00139261759f };
+                static constexpr float log[] = { 0.666666865f, 0.3998878f, 0.295799494f };
+                static constexpr float sin[] = { -0.166666642f, 0.00833274797f, -0.000195878907f };
+                static constexpr float cos[] = { 0.0416666642f, -0.00138883025f, 2.45479423e-05f };
+                static constexpr float atan[] = { -0.333333313f, 0.199995399f, -0.142639562f, 0.107437313f, -0.0645192787f };
+                static constexpr float tanh[] = { -0.333333343f, 0.133333042f, -0.0539592579f, 0.0217689183f, -0.00834394526f, 0.00229274482f };
+            };
+
+            template <>
+            struct coefficients<double, precision::precise>
+            {
+                static constexpr double exp[] = { 0.5, 0.16666666666666671, 0.041666666666666671, 0.0083333333333261411, 0.0013888888888883752,
+                    0.00019841269874800493, 2.4801587325533363e-05, 2.7557255425746435e-06, 2.7557273661348637e-07, 2.5105206373957011e-08,
+                    2.0914679376583935e-09 };
+
+                static constexpr double log[] = { 0.66666666666666663, 0.40000000000000879, 0.28571428570803614, 0.22222222391713917,
+                    0.18181795640132906, 0.15386239702814658, 0.13268773138656886, 0.13086626147840102 };
+
+                static constexpr double sin[] = { -0.16666666666666666, 0.0083333333333333315, -0.00019841269841265065, 2.7557319219339167e-06,
+                    -2.5052106232447578e-08, 1.6058531618986147e-10, -7.5866971177069183e-13 };
+
+                static constexpr double cos[] = { 0.041666666666666664, -0.0013888888888888887, 2.4801587301584645e-05, -2.7557319221402824e-07,
+                    2.0876755791080422e-09, -1.1470460887609959e-11, 4.7458719020432915e-14 };
+
+                static constexpr double atan[] = { -0.33333333333333331, 0.19999999999999804, -0.14285714285659828, 0.11111111105155447,
+                    -0.090909087535008773, 0.076922963750321427, -0.066664248857382549, 0.058789289978347752, -0.052304542706502442,
+                    0.045515932206265493, -0.034570561981427744, 0.016285756855221028 };
+
+                static constexpr double tanh[] = { -0.33333333333333331, 0.13333333333333042, -0.053968253967896992, 0.021869488519008305,
+                    -0.0088632351032408782, 0.0035921217511549622, -0.0014557754120478055, 0.00058966065777570434, -0.0002375906496055562,
+                    9.2571161295567687e-05, -3.1201101425797402e-05, 6.485163482793113e-06 };
+            };
+
+            template <>
+            struct coefficients<double, precision::fast>
+            {
+                static constexpr double exp[] = { 0.50000000000000011, 0.16666666666666669, 0.041666666666624164, 0.008333333333330065,
+                    0.0013888888917196719, 0.00019841269863040545, 2.4801521322368692e-05, 2.7557268480310024e-06, 2.7620075879983367e-07,
+                    2.5100375832561234e-08 };
+
+                static constexpr double log[] = { 0.66666666666666696, 0.39999999999899505, 0.28571428625975487, 0.22222211134795081,
+                    0.18182889125261723, 0.15331721600556042, 0.14616449685043406 };
+
+                static constexpr double sin[] = { -0.16666666666666666, 0.008333333333330948, -0.00019841269836758574, 2.7557316102552439e-06,
+                    -2.5051131845003624e-08, 1.5918129294866608e-10 };
+
+                static constexpr double cos[] = { 0.041666666666666664, -0.0013888888888887398, 2.4801587298765689e-05, -2.7557317271729793e-07,
+                    2.0876146268403199e-09, -1.1382632425521717e-11 };
+
+                static constexpr double atan[] = { -0.33333333333333331, 0.19999999999995521, -0.14285714284666542, 0.11111111015256361,
+                    -0.090909045781239026, 0.076921831908260865, -0.066645114473819475, 0.0585814891280221, -0.050854497379402598,
+                    0.039231658295587189, -0.01917688711906226 };
+
+                static constexpr double tanh[] = { -0.3333333333333332, 0.13333333333326658, -0.053968253961395568, 0.021869488260559115,
+                    -0.0088632298309257087, 0.0035920589774734554, -0.001455309297534642, 0.00058743728600943815, -0.00023077616269519857,
+                    7.9599557352648078e-05, -1.7244874494844329e-05 };
+            };
+
+            /// Constants split in hi + lo have a hi part with enough trailing zeros
+            /// for n * hi to be exact in the argument reductions.
+            template <class _T>
+            struct constants;
+
+            template <>
+            struct constants<float>
+            {
+                static constexpr float infinity = (float) INFINITY;
+                static constexpr float nan = (float) NAN;
+                static constexpr float min_normal = 1.17549435e-38f;
+
+                // x * 2^24 moves a subnormal x into the normal range.
+                static constexpr float denormal_scale = 16777216.0f;
+                static constexpr float denormal_exponent = 24.0f;
+                static constexpr float split = 4097.0f;
+
+                static constexpr float log2e = 1.44269504f;
+                static constexpr float ln2_hi = 0.693359375f;
+                static constexpr float ln2_lo = -2.12194440e-4f;
+                static constexpr float sqrt2 = 1.41421356f;
+
+                // 2 / 3 - coefficients<float, precision::precise>::log[0].
+                static constexpr float two_thirds_lo = -1.98682149e-8f;
+
+                // e^x overflows above exp_max and is rounded to zero below exp_min.
+                static constexpr float exp_max = 88.7228394f;
+                static constexpr float exp_min = -103.972084f;
+
+                // Range of the fast exp, the result stays a normal number.
+                static constexpr float fast_exp_max = 88.37f;
+                static constexpr float fast_exp_min = -87.3365f;
+
+                static constexpr float two_over_pi = 0.636619772f;
+                static constexpr float pio2_1 = 1.5703125f;
+                static constexpr float pio2_2 = 4.837512969970703125e-4f;
+                static constexpr float pio2_3 = 7.54953362047672271729e-8f;
+                static constexpr float pio2_4 = 2.56334406825708960298e-12f;
+
+                static constexpr float tan_pi_8 = 0.414213562f;
+                static constexpr float pio4_hi = 0.785398185f;
+                static constexpr float pio4_lo = -2.18556941e-8f;
+                static constexpr float pio2_hi = 1.57079637f;
+                static constexpr float pio2_lo = -4.37113883e-8f;
+                static constexpr float pi_hi = 3.14159274f;
+                static constexpr float pi_lo = -8.74227766e-8f;
+
+                // Polynomial below tanh_threshold, tanh(x) rounds to 1 above tanh_one.
+                static constexpr float tanh_threshold = 0.625f;
+                static constexpr float tanh_one = 9.1f;
+            };
+
+            template <>
+            struct constants<double>
+            {
+                static constexpr double infinity = (double) INFINITY;
+                static constexpr double nan = (double) NAN;
+                static constexpr double min_normal = 2.2250738585072014e-308;
+
+                // x * 2^54 moves a subnormal x into the normal range.
+                static constexpr double denormal_scale = 18014398509481984.0;
+                static constexpr double denormal_exponent = 54.0;
+                static constexpr double split = 134217729.0;
+
+                static constexpr double log2e = 1.4426950408889634;
+                static constexpr double ln2_hi = 6.93147180369123816490e-01;
+                static constexpr double ln2_lo = 1.90821492927058770002e-10;
+                static constexpr double sqrt2 = 1.4142135623730951;
+                static constexpr double two_thirds_lo = 3.700743415417188e-17;
+
+                static constexpr double exp_max = 709.782712893383973096;
+                static constexpr double exp_min = -745.13321910194110842;
+                static constexpr double fast_exp_max = 709.43;
+                static constexpr double fast_exp_min = -708.3964185322641;
+
+                static constexpr double two_over_pi = 0.63661977236758134308;
+                static constexpr double pio2_1 = 1.57079632673412561417e+00;
+                static constexpr double pio2_2 = 6.07710050630396597660e-11;
+                static constexpr double pio2_3 = 2.02226624871116645580e-21;
+                static constexpr double pio2_4 = 8.47842766036889956997e-32;
+
+                static constexpr double tan_pi_8 = 0.41421356237309503;
+                static constexpr double pio4_hi = 7.8539816339744827900e-01;
+                static constexpr double pio4_lo = 3.0616169978683829430e-17;
+                static constexpr double pio2_hi = 1.5707963267948965580e+00;
+                static constexpr double pio2_lo = 6.1232339957367658860e-17;
+                static constexpr double pi_hi = 3.1415926535897931160e+00;
+                static constexpr double pi_lo = 1.2246467991473531772e-16;
+
+                static constexpr double tanh_threshold = 0.625;
+                static constexpr double tanh_one = 19.1;
+            };
+        } // namespace detail
+
+        /// Math kernels on the vectors of _Op, a vector_op.
+        template <class _Op, precision _Precision = precision::precise>
+        struct vector_math
+        {
+            using op = _Op;
+            using value_type = typename _Op::value_type;
+            using vec_type = typename _Op::vec_type;
+            using mask_type = typename _Op::mask_type;
+
+            static constexpr bool is_fast = _Precision == precision::fast;
+
+            /// e^x
+            FST_NODISCARD static inline vec_type exp(vec_type x) noexcept
+            {
+                if constexpr (is_fast)
+                {
+                    x = op::max(op::min(x, op::load(c::fast_exp_max)), op::load(c::fast_exp_min));
+                    const vec_type n = op::nearest(op::mul(x, op::load(c::log2e)));
+                    return op::mul(exp_reduced(x, n), op::pow2i(n));
+                }
+                else
+                {
+                    return exp_double_word(x, op::load_zero());
+                }
+            }
+
+            /// Natural logarithm.
+            FST_NODISCARD static inline vec_type log(vec_type x) noexcept
+            {
+                const log_parts p = log_reduce(x);
+                const vec_type hfsq = op::mul(op::mul(p.f, p.f), op::load((value_type) 0.5));
+
+                // e * ln2_hi - ((hfsq - (s * (hfsq + R) + e * ln2_lo)) - f)
+                const vec_type t = op::mul_add(p.s, op::add(hfsq, p.r), op::mul(p.e, op::load(c::ln2_lo)));
+                const vec_type r = op::mul_add(p.e, op::load(c::ln2_hi), op::sub(p.f, op::sub(hfsq, t)));
+
+                if constexpr (is_fast) { return r; }
+                else { return log_special(x, r); }
+            }
+
+            /// x^y
+            FST_NODISCARD static inline vec_type pow(vec_type x, vec_type y) noexcept
+            {
+                const vec_type one = op::load((value_type) 1);
+                const vec_type ax = op::abs(x);
+
+                // y * log(|x|) as hi + lo.
+                const double_word l = log_double_word(ax);
+                double_word t = two_prod(y, l.hi);
+                t.lo = op::mul_add(y, l.lo, t.lo);
+
+                if constexpr (is_fast)
+                {
+                    // e^(hi + lo) = e^hi + e^hi * lo.
+                    const vec_type r = exp(t.hi);
+                    return op::mul_add(r, t.lo, r);
+                }
+                else
+                {
+                    // No lo part when hi is not finite or y is too large for an exact product.
+                    const vec_type zero = op::load_zero();
+                    vec_type r = exp_double_word(t.hi, op::select(op::less(op::abs(t.lo), one), t.lo, zero));
+
+                    // A negative x needs an integral y, an odd one keeps the sign of x.
+                    const vec_type half_y = op::mul(y, op::load((value_type) 0.5));
+                    const mask_type odd = op::equal(op::sub(half_y, op::floor(half_y)), op::load((value_type) 0.5));
+                    const mask_type integral = op::equal(op::floor(y), y);
+                    const mask_type negative = op::less(op::copysign(one, x), zero);
+                    r = op::select(op::and_mask(negative, odd), op::sub(zero, r), r);
+                    r = op::select(op::less(x, zero), op::select(integral, r, op::load(c::nan)), r);
+
+                    // pow(x, 0), pow(1, y) and pow(-1, +-inf) are 1, even for a nan.
+                    const mask_type unit = op::and_mask(op::equal(ax, one), op::equal(op::abs(y), op::load(c::infinity)));
+                    return op::select(op::or_mask(op::or_mask(op::equal(y, zero), op::equal(x, one)), unit), one, r);
+                }
+            }
+
+            FST_NODISCARD static inline vec_type sin(vec_type x) noexcept { return sin_cos<true>(x); }
+
+            FST_NODISCARD static inline vec_type cos(vec_type x) noexcept { return sin_cos<false>(x); }
+
+            /// Hyperbolic tangent.
+            FST_NODISCARD static inline vec_type tanh(vec_type x) noexcept
+            {
+                const vec_type one = op::load((value_type) 1);
+                const vec_type two = op::load((value_type) 2);
+                const vec_type ax = op::abs(x);
+
+                // |x| + |x|^3 * T(x^2) close to zero, 1 - 2 / (e^2|x| + 1) elsewhere, with the sign of x (also on -0).
+                const vec_type z = op::mul(x, x);
+                const vec_type small = op::mul_add(op::mul(ax, z), polynomial(z, coefs::tanh), ax);
+                const vec_type e = exp(op::add(ax, ax));
+                vec_type large;
+
+                if constexpr (is_fast) { large = op::sub(one, op::div(two, op::add(e, one))); }
+                else
+                {
+                    // 1 - q with q = 2 / (e + 1) as hi + lo, the result is 1 past tanh_one.
+                    const double_word q = div_double_word({ two, op::load_zero() }, two_sum(e, one));
+                    const double_word r = two_sum(one, op::sub(op::load_zero(), q.hi));
+                    large = op::add(r.hi, op::sub(r.lo, q.lo));
+                    large = op::select(op::less(op::load(c::tanh_one), ax), one, large);
+                }
+
+                return op::copysign(op::select(op::less(ax, op::load(c::tanh_threshold)), small, large), x);
+            }
+
+            /// Angle of the point (x, y), in [-pi, pi].
+            FST_NODISCARD static inline vec_type atan2(vec_type y, vec_type x) noexcept
+            {
+                const vec_type zero = op::load_zero();
+                const vec_type one = op::load((value_type) 1);
+                const vec_type ax = op::abs(x);
+                const vec_type ay = op::abs(y);
+
+                // t = min / max in [0, 1], atan(t) = pi / 4 + atan((t - 1) / (t + 1)) above tan(pi / 8).
+                const mask_type swap = op::less(ax, ay);
+                const vec_type num = op::select(swap, ax, ay);
+                const vec_type den = op::select(swap, ay, ax);
+                const mask_type x_negative = op::less(op::copysign(one, x), zero);
+
+                if constexpr (is_fast)
+                {
+                    vec_type t = op::div(num, den);
+                    const mask_type reduce = op::less(op::load(c::tan_pi_8), t);
+                    t = op::select(reduce, op::div(op::sub(num, den), op::add(num, den)), t);
+
+                    const vec_type z = op::mul(t, t);
+                    vec_type a = op::mul_add(op::mul(t, z), polynomial(z, coefs::atan), t);
+                    a = op::add(op::select(reduce, op::load(c::pio4_hi), zero), a);
+                    a = op::select(swap, op::sub(op::load(c::pio2_hi), a), a);
+                    a = op::select(x_negative, op::sub(op::load(c::pi_hi), a), a);
+                    return op::copysign(a, y);
+                }
+                else
+                {
+                    const vec_type infinity = op::load(c::infinity);
+
+                    // Both quotients as hi + lo, the lo part is dropped when it can't be computed (overflow, infinities).
+                    double_word t = div_double_word({ num, zero }, { den, zero });
+                    t.hi = op::select(op::equal(den, zero), zero, t.hi);
+
+                    double_word tr = div_double_word(two_sum(num, op::sub(zero, den)), two_sum(num, den));
+                    const mask_type both_infinite = op::and_mask(op::equal(ax, infinity), op::equal(ay, infinity));
+                    t.hi = op::select(both_infinite, one, t.hi);
+                    tr.hi = op::select(both_infinite, zero, tr.hi);
+
+                    const mask_type reduce = op::less(op::load(c::tan_pi_8), t.hi);
+                    t.hi = op::select(reduce, tr.hi, t.hi);
+                    t.lo = op::select(reduce, tr.lo, t.lo);
+                    t.lo = op::select(op::less(op::abs(t.lo), one), t.lo, zero);
+
+                    // atan(hi + lo) = atan(hi) + lo / (1 + hi^2).
+                    const vec_type z = op::mul(t.hi, t.hi);
+                    const vec_type p = op::mul(op::mul(t.hi, z), polynomial(z, coefs::atan));
+                    const vec_type correction = op::div(t.lo, op::add(one, z));
+
+                    double_word a = fast_two_sum(op::select(reduce, op::load(c::pio4_hi), zero), t.hi);
+                    a.lo = op::add(a.lo, op::add(op::add(p, correction), op::select(reduce, op::load(c::pio4_lo), zero)));
+
+                    double_word b = fast_two_sum(op::load(c::pio2_hi), op::sub(zero, a.hi));
+                    b.lo = op::add(b.lo, op::sub(op::load(c::pio2_lo), a.lo));
+                    a.hi = op::select(swap, b.hi, a.hi);
+                    a.lo = op::select(swap, b.lo, a.lo);
+
+                    b = fast_two_sum(op::load(c::pi_hi), op::sub(zero, a.hi));
+                    b.lo = op::add(b.lo, op::sub(op::load(c::pi_lo), a.lo));
+                    a.hi = op::select(x_negative, b.hi, a.hi);
+                    a.lo = op::select(x_negative, b.lo, a.lo);
+
+                    const vec_type r = op::copysign(op::add(a.hi, a.lo), y);
+                    return op::select(op::or_mask(op::is_nan(x), op::is_nan(y)), op::add(x, y), r);
+                }
+            }
+
+            FST_NODISCARD FST_ALWAYS_INLINE static vec_type sqrt(vec_type x) noexcept { return op::sqrt(x); }
+
+          private:
+            using c = detail::constants<value_type>;
+            using coefs = detail::coefficients<value_type, _Precision>;
+
+            // Horner scheme, c[_First] + x * (c[_First + 1] + x * (...)).
+            template <size_t _First = 0, size_t _Size>
+            FST_NODISCARD FST_ALWAYS_INLINE static vec_type polynomial(vec_type x, const value_type (&coefficients)[_Size]) noexcept
+            {
+                vec_type r = op::load(coefficients[_Size - 1]);
+                for (size_t i = _Size - 1; i > _First; i--)
+                {
+                    r = op::mul_add(r, x, op::load(coefficients[i - 1]));
+                }
+                return r;
+            }
+
+            // Unevaluated sum hi + lo, |lo| <= ulp(hi) / 2.
+            struct double_word
+            {
+                vec_type hi;
+                vec_type lo;
+            };
+
+            // Exact a + b.
+            FST_NODISCARD FST_ALWAYS_INLINE static double_word two_sum(vec_type a, vec_type b) noexcept
+            {
+                const vec_type s = op::add(a, b);
+                const vec_type bb = op::sub(s, a);
+                return { s, op::add(op::sub(a, op::sub(s, bb)), op::sub(b, bb)) };
+            }
+
+            // Exact a + b with |a| >= |b|.
+            FST_NODISCARD FST_ALWAYS_INLINE static double_word fast_two_sum(vec_type a, vec_type b) noexcept
+            {
+                const vec_type s = op::add(a, b);
+                return { s, op::sub(b, op::sub(s, a)) };
+            }
+
+            // Exact a * b, the error is the fma residual when mul_add is fused, Dekker's product otherwise.
+            FST_NODISCARD FST_ALWAYS_INLINE static double_word two_prod(vec_type a, vec_type b) noexcept
+            {
+                if constexpr (op::fused_mul_add)
+                {
+                    // An fma rather than a mul, the compiler would otherwise contract p into the additions that use it.
+                    const vec_type p = op::mul_add(a, b, op::load_zero());
+                    return { p, op::mul_add(a, b, op::sub(op::load_zero(), p)) };
+                }
+                else
+                {
+                    return dekker_product(a, b);
+                }
+            }
+
+            FST_NODISCARD FST_ALWAYS_INLINE static double_word dekker_product(vec_type a, vec_type b) noexcept
+            {
+                const vec_type split = op::load(c::split);
+                const vec_type ca = op::mul(a, split);
+                const vec_type a_hi = op::sub(ca, op::sub(ca, a));
+                const vec_type a_lo = op::sub(a, a_hi);
+                const vec_type cb = op::mul(b, split);
+                const vec_type b_hi = op::sub(cb, op::sub(cb, b));
+                const vec_type b_lo = op::sub(b, b_hi);
+
+                const vec_type p = op::mul(a, b);
+                const vec_type err = op::add(op::add(op::add(op::sub(op::mul(a_hi, b_hi), p), op::mul(a_hi, b_lo)), op::mul(a_lo, b_hi)),
+                    op::mul(a_lo, b_lo));
+                return { p, err };
+            }
+
+            // (a.hi + a.lo) / (b.hi + b.lo) as hi + lo.
+            FST_NODISCARD FST_ALWAYS_INLINE static double_word div_double_word(double_word a, double_word b) noexcept
+            {
+                const vec_type q = op::div(a.hi, b.hi);
+                const double_word qb = two_prod(q, b.hi);
+                const vec_type r = op::sub(op::add(op::sub(op::sub(a.hi, qb.hi), qb.lo), a.lo), op::mul(q, b.lo));
+                return { q, op::div(r, b.hi) };
+            }
+
+            // e^(x - n * ln(2)), |x - n * ln(2)| <= ln(2) / 2.
+            FST_NODISCARD FST_ALWAYS_INLINE static vec_type exp_reduced(vec_type x, vec_type n) noexcept
+            {
+                vec_type r = op::mul_add(n, op::load(-c::ln2_hi), x);
+                r = op::mul_add(n, op::load(-c::ln2_lo), r);
+                return op::add(op::mul_add(op::mul(r, r), polynomial(r, coefs::exp), r), op::load((value_type) 1));
+            }
+
+            // e^(x + lo), lo being at most a few ulp of x. The reduced argument is kept as hi + lo.
+            FST_NODISCARD FST_ALWAYS_INLINE static vec_type exp_double_word(vec_type x, vec_type lo) noexcept
+            {
+                const vec_type one = op::load((value_type) 1);
+                const vec_type xc = op::max(op::min(x, op::load(c::exp_max)), op::load(c::exp_min));
+                const vec_type n = op::nearest(op::mul(xc, op::load(c::log2e)));
+
+                const double_word r2 = two_sum(op::mul_add(n, op::load(-c::ln2_hi), xc), op::mul(n, op::load(-c::ln2_lo)));
+                const double_word r = fast_two_sum(r2.hi, op::add(r2.lo, lo));
+
+                // e^(r + r_lo) = (1 + r + r^2 * Q(r)) * (1 + r_lo).
+                const double_word h = fast_two_sum(one, r.hi);
+                const vec_type q = op::mul(op::mul(r.hi, r.hi), polynomial(r.hi, coefs::exp));
+                const vec_type p = op::add(h.hi, op::add(h.lo, op::add(q, op::mul_add(r.lo, r.hi, r.lo))));
+
+                // 2^n in two steps, n goes past the normal exponent range on both ends.
+                const vec_type n1 = op::nearest(op::mul(n, op::load((value_type) 0.5)));
+                vec_type e = op::mul(op::mul(p, op::pow2i(n1)), op::pow2i(op::sub(n, n1)));
+                e = op::select(op::less(op::load(c::exp_max), x), op::load(c::infinity), e);
+                e = op::select(op::less(x, op::load(c::exp_min)), op::load_zero(), e);
+                return op::select(op::is_nan(x), x, e);
+            }
+
+            // x = 2^e * (1 + f), sqrt(2) / 2 <= 1 + f <= sqrt(2), s = f / (2 + f), r = s^2 * P(s^2).
+            struct log_parts
+            {
+                vec_type e;
+                vec_type f;
+                vec_type s;
+                vec_type r;
+            };
+
+            FST_NODISCARD FST_ALWAYS_INLINE static log_parts log_reduce(vec_type x) noexcept
+            {
+                const vec_type one = op::load((value_type) 1);
+                vec_type e_bias = op::load_zero();
+
+                if constexpr (!is_fast)
+                {
+                    const mask_type denormal = op::less(x, op::load(c::min_normal));
+                    x = op::select(denormal, op::mul(x, op::load(c::denormal_scale)), x);
+                    e_bias = op::select(denormal, op::load(c::denormal_exponent), e_bias);
+                }
+
+                vec_type e = op::sub(op::exponent(x), e_bias);
+                vec_type m = op::mantissa(x);
+                const mask_type above = op::less(op::load(c::sqrt2), m);
+                m = op::select(above, op::mul(m, op::load((value_type) 0.5)), m);
+                e = op::select(above, op::add(e, one), e);
+
+                log_parts p;
+                p.e = e;
+                p.f = op::sub(m, one);
+                p.s = op::div(p.f, op::add(p.f, op::load((value_type) 2)));
+                const vec_type z = op::mul(p.s, p.s);
+                p.r = op::mul(z, polynomial(z, coefs::log));
+                return p;
+            }
+
+            // log(0) = -inf, log(inf) = inf, nan below zero.
+            FST_NODISCARD FST_ALWAYS_INLINE static vec_type log_special(vec_type x, vec_type r) noexcept
+            {
+                const vec_type zero = op::load_zero();
+                const vec_type infinity = op::load(c::infinity);
+                r = op::select(op::equal(x, zero), op::sub(zero, infinity), r);
+                r = op::select(op::less(x, zero), op::load(c::nan), r);
+                r = op::select(op::equal(x, infinity), infinity, r);
+                return op::select(op::is_nan(x), x, r);
+            }
+
+            // log(x) as hi + lo for pow, x >= 0.
+            // log(x) = (e * ln2_hi + f) - hfsq + (s * (hfsq + R) + e * ln2_lo), the larger terms are summed exactly.
+            FST_NODISCARD FST_ALWAYS_INLINE static double_word log_double_word(vec_type x) noexcept
+            {
+                const vec_type zero = op::load_zero();
+                const log_parts p = log_reduce(x);
+                const double_word hfsq = two_prod(p.f, op::mul(p.f, op::load((value_type) 0.5)));
+                const double_word ef = two_sum(op::mul(p.e, op::load(c::ln2_hi)), p.f);
+                const double_word h = two_sum(ef.hi, op::sub(zero, hfsq.hi));
+
+                if constexpr (is_fast)
+                {
+                    const vec_type t = op::mul_add(p.s, op::add(hfsq.hi, p.r), op::mul(p.e, op::load(c::ln2_lo)));
+                    return fast_two_sum(h.hi, op::add(op::add(ef.lo, h.lo), op::sub(t, hfsq.lo)));
+                }
+                else
+                {
+                    // s, z = s^2, R and s * (hfsq + R) also as hi + lo, their rounding errors show up in large powers.
+                    // Only the leading 2 / 3 * z term of R needs the extra precision.
+                    const double_word s = div_double_word({ p.f, zero }, fast_two_sum(op::load((value_type) 2), p.f));
+                    double_word z = two_prod(s.hi, s.hi);
+                    z.lo = op::mul_add(op::add(s.hi, s.hi), s.lo, z.lo);
+
+                    const vec_type two_thirds = op::load(coefs::log[0]);
+                    const vec_type r_tail = op::mul(op::mul(z.hi, z.hi), polynomial<1>(z.hi, coefs::log));
+                    double_word r = two_prod(two_thirds, z.hi);
+                    r.lo = op::add(r.lo, op::add(op::mul_add(two_thirds, z.lo, op::mul(op::load(c::two_thirds_lo), z.hi)), r_tail));
+
+                    double_word u = two_sum(hfsq.hi, r.hi);
+                    u.lo = op::add(u.lo, op::add(hfsq.lo, r.lo));
+                    double_word v = two_prod(s.hi, u.hi);
+                    v.lo = op::add(v.lo, op::mul_add(s.hi, u.lo, op::mul(s.lo, u.hi)));
+
+                    const double_word w = two_sum(h.hi, v.hi);
+                    const vec_type lo = op::add(op::add(ef.lo, op::add(h.lo, w.lo)),
+                        op::add(op::sub(v.lo, hfsq.lo), op::mul(p.e, op::load(c::ln2_lo))));
+
+                    double_word l = fast_two_sum(w.hi, lo);
+                    l.hi = log_special(x, l.hi);
+                    return l;
+                }
+            }
+
+            template <bool _Sin>
+            FST_NODISCARD FST_ALWAYS_INLINE static vec_type sin_cos(vec_type x) noexcept
+            {
+                const vec_type zero = op::load_zero();
+                const vec_type one = op::load((value_type) 1);
+                const vec_type two = op::load((value_type) 2);
+
+                // r = x - n * pi / 2, |r| <= pi / 4, the n * pio2_i products are exact.
+                const vec_type n = op::nearest(op::mul(x, op::load(c::two_over_pi)));
+                vec_type r = op::mul_add(n, op::load(-c::pio2_1), x);
+                vec_type r_lo;
+
+                if constexpr (is_fast)
+                {
+                    r = op::mul_add(n, op::load(-c::pio2_2), r);
+                    r = op::mul_add(n, op::load(-c::pio2_3), r);
+                    r = op::mul_add(n, op::load(-c::pio2_4), r);
+                }
+                else
+                {
+                    // Keeps the rounding errors of the subtractions in r_lo.
+                    const double_word r2 = two_sum(r, op::mul(n, op::load(-c::pio2_2)));
+                    const double_word r3 = two_sum(r2.hi, op::mul(n, op::load(-c::pio2_3)));
+                    const double_word rr = fast_two_sum(r3.hi, op::add(op::add(r2.lo, r3.lo), op::mul(n, op::load(-c::pio2_4))));
+                    r = rr.hi;
+                    r_lo = rr.lo;
+                }
+
+                const vec_type z = op::mul(r, r);
+                const vec_type hz = op::mul(z, op::load((value_type) 0.5));
+                const vec_type zc = op::mul(op::mul(z, z), polynomial(z, coefs::cos));
+                vec_type s;
+                vec_type cs;
+
+                if constexpr (is_fast)
+                {
+                    s = op::mul_add(op::mul(r, z), polynomial(z, coefs::sin), r);
+                    cs = op::add(op::sub(one, hz), zc);
+                }
+                else
+                {
+                    // sin(r + r_lo) = sin(r) + r_lo * cos(r), cos(r + r_lo) = cos(r) - r_lo * sin(r).
+                    s = op::add(r, op::mul_add(op::mul(r, z), polynomial(z, coefs::sin), r_lo));
+
+                    // 1 - hz + zc, keeping the rounding error of 1 - hz.
+                    const vec_type w = op::sub(one, hz);
+                    cs = op::add(w, op::add(op::sub(op::sub(one, w), hz), op::sub(zc, op::mul(r, r_lo))));
+                }
+
+                // Quadrant, n mod 4.
+                const vec_type q = op::sub(n, op::mul(op::floor(op::mul(n, op::load((value_type) 0.25))), op::load((value_type) 4)));
+                const mask_type odd = op::or_mask(op::equal(q, one), op::equal(q, op::load((value_type) 3)));
+
+                if constexpr (_Sin)
+                {
+                    const vec_type v = op::select(odd, cs, s);
+                    const vec_type result = op::select(op::less_equal(two, q), op::sub(zero, v), v);
+
+                    if constexpr (is_fast)
+                    {
+                        return result;
+                    }
+                    else
+                    {
+                        // The reduction turns -0 into +0.
+                        return op::select(op::equal(x, zero), x, result);
+                    }
+                }
+                else
+                {
+                    const vec_type v = op::select(odd, s, cs);
+                    return op::select(op::and_mask(op::less_equal(one, q), op::less_equal(q, two)), op::sub(zero, v), v);
+                }
+            }
+        };
+
+        /// vector_math on the vector type of fst/simd.h.
+        template <class _T, precision _Precision = precision::precise>
+        using vector_math_t = vector_math<__fst::simd::vector_op<__fst::simd::vector_type_t<_T>, _T>, _Precision>;
+
+        namespace detail
+        {
+            // The expressions evaluate with a partial_vector_op on the tail, the kernels only need the vector_op.
+            template <class _Op, precision _Precision>
+            using expression_math = vector_math<__fst::simd::vector_op<typename _Op::vec_type, typename _Op::value_type>, _Precision>;
+
+            // clang-format off
+            template <precision P> struct exp_fct { template <class _Op, class _V> FST_ALWAYS_INLINE static _V apply(const _Op&, _V a) noexcept { return expression_math<_Op, P>::exp(a); } };
+            template <precision P> struct log_fct { template <class _Op, class _V> FST_ALWAYS_INLINE static _V apply(const _Op&, _V a) noexcept { return expression_math<_Op, P>::log(a); } };
+            template <precision P> struct sin_fct { template <class _Op, class _V> FST_ALWAYS_INLINE static _V apply(const _Op&, _V a) noexcept { return expression_math<_Op, P>::sin(a); } };
+            template <precision P> struct cos_fct { template <class _Op, class _V> FST_ALWAYS_INLINE static _V apply(const _Op&, _V a) noexcept { return expression_math<_Op, P>::cos(a); } };
+            template <precision P> struct tanh_fct { template <class _Op, class _V> FST_ALWAYS_INLINE static _V apply(const _Op&, _V a) noexcept { return expression_math<_Op, P>::tanh(a); } };
+            template <precision P> struct sqrt_fct { template <class _Op, class _V> FST_ALWAYS_INLINE static _V apply(const _Op&, _V a) noexcept { return expression_math<_Op, P>::sqrt(a); } };
+            template <precision P> struct pow_fct { template <class _Op, class _V> FST_ALWAYS_INLINE static _V apply(const _Op&, _V a, _V b) noexcept { return expression_math<_Op, P>::pow(a, b); } };
+            template <precision P> struct atan2_fct { template <class _Op, class _V> FST_ALWAYS_INLINE static _V apply(const _Op&, _V a, _V b) noexcept { return expression_math<_Op, P>::atan2(a, b); } };
+            // clang-format on
+        } // namespace detail
+
+        // clang-format off
+#define FST_SIMD_MATH_UNARY_FUNCTION(NAME)                                                                                                   \
+    template <precision _Precision = precision::precise, class _A, __fst::enable_if_t<__fst::simd::is_expression<_A>::value, int> = 0>     \
+    FST_NODISCARD FST_ALWAYS_INLINE auto NAME(const _A& a) noexcept { return __fst::simd::expression::make_unary<detail::NAME##_fct<_Precision>>(a); }
+
+#define FST_SIMD_MATH_BINARY_FUNCTION(NAME)                                                                                                  \
+    template <precision _Precision = precision::precise, class _A, class _B,                                                                 \
+        __fst::enable_if_t<__fst::simd::expression::is_binary_operand_v<_A, _B>, int> = 0>                                                    \
+    FST_NODISCARD FST_ALWAYS_INLINE auto NAME(const _A& a, const _B& b) noexcept                                                             \
+    { return __fst::simd::expression::make_binary<detail::NAME##_fct<_Precision>>(a, b); }
+        // clang-format on
+
+        /// Lazy expressions, at least one operand is an expression (fst::simd::expr(container)).
+        FST_SIMD_MATH_UNARY_FUNCTION(exp)
+        FST_SIMD_MATH_UNARY_FUNCTION(log)
+        FST_SIMD_MATH_UNARY_FUNCTION(sin)
+        FST_SIMD_MATH_UNARY_FUNCTION(cos)
+        FST_SIMD_MATH_UNARY_FUNCTION(tanh)
+        FST_SIMD_MATH_UNARY_FUNCTION(sqrt)
+        FST_SIMD_MATH_BINARY_FUNCTION(pow)
+        FST_SIMD_MATH_BINARY_FUNCTION(atan2)
+
+#undef FST_SIMD_MATH_UNARY_FUNCTION
+#undef FST_SIMD_MATH_BINARY_FUNCTION
+    } // namespace math
+
+FST_END_SIMD_NAMESPACE
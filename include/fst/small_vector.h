@@ -422,7 +422,7 @@ FST_BEGIN_NAMESPACE
         FST_ALWAYS_INLINE constexpr void pop_back() noexcept
         {
             fst_assert(_size > 0, "Can't pop_back an empty fixed_vector.");
-            if constexpr (!__fst::is_trivially_destructible_v<value_type>) { (*this)[_size].~value_type(); }
+            if constexpr (!__fst::is_trivially_destructible_v<value_type>) { (*this)[_size - 1].~value_type(); }
             --_size;
         }
 
@@ -436,7 +436,7 @@ FST_BEGIN_NAMESPACE
                 return;
             }
 
-            if constexpr (__fst::is_trivially_copyable_v<value_type>) { __fst::memmove(begin() + index, begin() + index + 1, (_size - index) * sizeof(value_type)); }
+            if constexpr (__fst::is_trivially_copyable_v<value_type>) { __fst::memmove(begin() + index, begin() + index + 1, (_size - index - 1) * sizeof(value_type)); }
             else
             {
                 for (size_type i = index; i < size() - 1; i++)
@@ -444,7 +444,7 @@ FST_BEGIN_NAMESPACE
                     (*this)[i] = __fst::move((*this)[i + 1]);
                 }
 
-                if constexpr (!__fst::is_trivially_destructible_v<value_type>) { (*this)[_size].~value_type(); }
+                if constexpr (!__fst::is_trivially_destructible_v<value_type>) { (*this)[_size - 1].~value_type(); }
             }
 
             _size--;
@@ -464,7 +464,7 @@ FST_BEGIN_NAMESPACE
 
             __fst::move_element((*this)[index], __fst::move(this->back()));
 
-            if constexpr (!__fst::is_trivially_destructible_v<value_type>) { (*this)[_size].~value_type(); }
+            if constexpr (!__fst::is_trivially_destructible_v<value_type>) { (*this)[_size - 1].~value_type(); }
             _size--;
         }
 
@@ -573,6 +573,25 @@ FST_BEGIN_NAMESPACE
 
         inline bool grow(size_t new_capacity) noexcept
         {
+            if (has_allocated_data())
+            {
+                if constexpr (__fst::is_trivially_copyable_v<_T>)
+                {
+                    _T* tmp_data = (_T*) __fst::memory_zone_reallocate(
+                        get_memory_zone(), (void*) _data, _size * sizeof(_T), new_capacity * sizeof(_T), _Alignment, _MemoryCategory::id());
+                    if (!tmp_data) { return false; }
+
+                    _capacity = new_capacity;
+                    _data = tmp_data;
+                    return true;
+                }
+                else if (__fst::memory_zone_try_expand(get_memory_zone(), (void*) _data, new_capacity * sizeof(_T), _MemoryCategory::id()))
+                {
+                    _capacity = new_capacity;
+                    return true;
+                }
+            }
+
             _T* tmp_data = (_T*) _MemoryZone::aligned_allocate(new_capacity * sizeof(_T), _Alignment, _MemoryCategory::id());
             if (!tmp_data) { return false; }
 
@@ -1009,7 +1028,7 @@ FST_BEGIN_NAMESPACE
         FST_ALWAYS_INLINE constexpr void pop_back() noexcept
         {
             fst_assert(_size > 0, "Can't pop_back an empty fixed_vector.");
-            if constexpr (!__fst::is_trivially_destructible_v<value_type>) { (*this)[_size].~value_type(); }
+            if constexpr (!__fst::is_trivially_destructible_v<value_type>) { (*this)[_size - 1].~value_type(); }
             --_size;
         }
 
@@ -1023,7 +1042,7 @@ FST_BEGIN_NAMESPACE
                 return;
             }
 
-            if constexpr (__fst::is_trivially_copyable_v<value_type>) { __fst::memmove(begin() + index, begin() + index + 1, (_size - index) * sizeof(value_type)); }
+            if constexpr (__fst::is_trivially_copyable_v<value_type>) { __fst::memmove(begin() + index, begin() + index + 1, (_size - index - 1) * sizeof(value_type)); }
             else
             {
                 for (size_type i = index; i < size() - 1; i++)
@@ -1031,7 +1050,7 @@ FST_BEGIN_NAMESPACE
                     (*this)[i] = __fst::move((*this)[i + 1]);
                 }
 
-                if constexpr (!__fst::is_trivially_destructible_v<value_type>) { (*this)[_size].~value_type(); }
+                if constexpr (!__fst::is_trivially_destructible_v<value_type>) { (*this)[_size - 1].~value_type(); }
             }
 
             _size--;
@@ -1051,7 +1070,7 @@ FST_BEGIN_NAMESPACE
 
             __fst::move_element((*this)[index], __fst::move(this->back()));
 
-            if constexpr (!__fst::is_trivially_destructible_v<value_type>) { (*this)[_size].~value_type(); }
+            if constexpr (!__fst::is_trivially_destructible_v<value_type>) { (*this)[_size - 1].~value_type(); }
             _size--;
         }
 
@@ -1160,6 +1179,25 @@ FST_BEGIN_NAMESPACE
 
         inline bool grow(size_t new_capacity) noexcept
         {
+            if (has_allocated_data())
+            {
+                if constexpr (__fst::is_trivially_copyable_v<_T>)
+                {
+                    _T* tmp_data = (_T*) __fst::memory_zone_reallocate(
+                        get_memory_zone(), (void*) data(), _size * sizeof(_T), new_capacity * sizeof(_T), _Alignment, _MemoryCategory::id());
+                    if (!tmp_data) { return false; }
+
+                    set_capacity(new_capacity);
+                    set_allocated_data(tmp_data);
+                    return true;
+                }
+                else if (__fst::memory_zone_try_expand(get_memory_zone(), (void*) data(), new_capacity * sizeof(_T), _MemoryCategory::id()))
+                {
+                    set_capacity(new_capacity);
+                    return true;
+                }
+            }
+
             _T* tmp_data = (_T*) _MemoryZone::aligned_allocate(new_capacity * sizeof(_T), _Alignment, _MemoryCategory::id());
             if (!tmp_data) { return false; }
 
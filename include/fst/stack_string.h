@@ -837,4 +837,16 @@ FST_BEGIN_NAMESPACE
     template <size_t N>
     using stack_string = basic_stack_string<char, N>;
 
+    /// Same value as the hash of the string_view, maps with stack_string keys can be searched with a string_view.
+    template <class _CharT, size_t _Size>
+    struct hash<__fst::basic_stack_string<_CharT, _Size>> : __fst::hash<__fst::basic_string_view<_CharT>>
+    {
+        using __fst::hash<__fst::basic_string_view<_CharT>>::operator();
+
+        FST_NODISCARD inline constexpr size_t operator()(const __fst::basic_stack_string<_CharT, _Size>& str) const noexcept
+        {
+            return __fst::hash<__fst::basic_string_view<_CharT>>{}(str.view());
+        }
+    };
+
 FST_END_NAMESPACE
@@ -452,7 +452,7 @@ FST_BEGIN_NAMESPACE
 
             new_data[new_size] = 0;
 
-            deallocate_if_big();
+            deallocate_if_big(new_data);
             big_data() = new_data;
             big_size() = new_size;
             big_capacity() = new_capacity;
@@ -486,12 +486,12 @@ FST_BEGIN_NAMESPACE
 
             const size_type new_capacity = __fst::next_power_of_two(new_size);
 
-            pointer new_data = grow_copy(new_capacity, _size, _data);
+            pointer new_data = grow_copy(new_capacity, _size, _data, str);
 
             __fst::memmove(new_data + _size, str, count * sizeof(value_type));
             new_data[new_size] = 0;
 
-            deallocate_if_big();
+            deallocate_if_big(new_data);
             big_data() = new_data;
             big_size() = new_size;
             big_capacity() = new_capacity;
@@ -575,7 +575,7 @@ FST_BEGIN_NAMESPACE
 
             pointer new_data = grow_copy(new_capacity, _size + 1);
 
-            deallocate_if_big();
+            deallocate_if_big(new_data);
             big_data() = new_data;
             big_capacity() = new_capacity;
             set_big();
@@ -608,7 +608,7 @@ FST_BEGIN_NAMESPACE
             new_data[_size] = c;
             new_data[new_size] = 0;
 
-            deallocate_if_big();
+            deallocate_if_big(new_data);
             big_data() = new_data;
             big_size() = new_size;
             big_capacity() = new_capacity;
@@ -659,7 +659,7 @@ FST_BEGIN_NAMESPACE
             __fst::mem_fill(new_data + index, c, count);
             new_data[new_size] = 0;
 
-            deallocate_if_big();
+            deallocate_if_big(new_data);
             big_data() = new_data;
             big_size() = new_size;
             big_capacity() = new_capacity;
@@ -692,12 +692,12 @@ FST_BEGIN_NAMESPACE
 
             const size_type new_capacity = __fst::next_power_of_two(new_size);
 
-            pointer new_data = grow_copy(new_capacity, _size, _data);
+            pointer new_data = grow_copy(new_capacity, _size, _data, str.data());
             __fst::memmove((void*) (new_data + index + count), (const void*) (new_data + index), delta * sizeof(value_type));
             __fst::memmove(new_data + index, str.data(), count * sizeof(value_type));
             new_data[new_size] = 0;
 
-            deallocate_if_big();
+            deallocate_if_big(new_data);
             big_data() = new_data;
             big_size() = new_size;
             big_capacity() = new_capacity;
@@ -736,12 +736,12 @@ FST_BEGIN_NAMESPACE
 
             const size_type new_capacity = __fst::next_power_of_two(new_size);
 
-            pointer new_data = grow_copy(new_capacity, _size, _data);
-            __fst::memmove((void*) (new_data + index + s_size), (const void*) (_data + index), delta * sizeof(value_type));
+            pointer new_data = grow_copy(new_capacity, _size, _data, str.data());
+            __fst::memmove((void*) (new_data + index + s_size), (const void*) (new_data + index), delta * sizeof(value_type));
             __fst::memmove(new_data + index, str.data() + index_str, s_size * sizeof(value_type));
             new_data[new_size] = 0;
 
-            deallocate_if_big();
+            deallocate_if_big(new_data);
             big_data() = new_data;
             big_size() = new_size;
             big_capacity() = new_capacity;
@@ -910,11 +910,33 @@ FST_BEGIN_NAMESPACE
             if (is_big()) { _content.second().deallocate(big_data()); }
         }
 
+        // Called after grow_copy(), the old buffer is already gone if it was reallocated.
+        FST_ALWAYS_INLINE void deallocate_if_big(pointer new_data) noexcept
+        {
+            if (is_big() && big_data() != new_data) { _content.second().deallocate(big_data()); }
+        }
+
         FST_NODISCARD FST_ALWAYS_INLINE pointer grow_copy(size_type new_size, size_type old_size) noexcept { return grow_copy(new_size, old_size, data()); }
 
-        FST_NODISCARD inline pointer grow_copy(size_type new_size, size_type old_size, pointer _data) noexcept
+        // The buffer is reallocated in place when possible, unless source points inside it.
+        FST_NODISCARD inline pointer grow_copy(size_type new_size, size_type old_size, pointer _data, const_pointer source = nullptr) noexcept
         {
             const size_type alloc_length = new_size + 1;
+
+            if constexpr (__fst::allocator_has_reallocate<allocator_type>::value)
+            {
+                if (is_big() && !(source >= _data && source <= _data + old_size))
+                {
+                    pointer new_data = _content.second().reallocate(big_data(), old_size, alloc_length);
+                    // On failure the old buffer is untouched, fall back to allocate and copy.
+                    if (new_data)
+                    {
+                        big_data() = new_data;
+                        return new_data;
+                    }
+                }
+            }
+
             pointer new_data = (pointer) _content.second().allocate(alloc_length);
             __fst::memmove(new_data, _data, old_size * sizeof(value_type));
             return new_data;
@@ -1236,7 +1258,7 @@ FST_BEGIN_NAMESPACE
 
             new_data[new_size] = 0;
 
-            if (_content.first().data) { _content.second().deallocate(_content.first().data); }
+            if (_content.first().data && _content.first().data != new_data) { _content.second().deallocate(_content.first().data); }
             _content.first().data = new_data;
             _content.first().size = new_size;
             _content.first().capacity = new_capacity;
@@ -1269,12 +1291,12 @@ FST_BEGIN_NAMESPACE
 
             const size_type new_capacity = __fst::next_power_of_two(new_size);
 
-            pointer new_data = grow_copy(new_capacity, _size, _data);
+            pointer new_data = grow_copy(new_capacity, _size, _data, str);
 
             __fst::memmove(new_data + _size, str, count * sizeof(value_type));
             new_data[new_size] = 0;
 
-            if (_content.first().data) { _content.second().deallocate(_content.first().data); }
+            if (_content.first().data && _content.first().data != new_data) { _content.second().deallocate(_content.first().data); }
             _content.first().data = new_data;
             _content.first().size = new_size;
             _content.first().capacity = new_capacity;
@@ -1347,7 +1369,7 @@ FST_BEGIN_NAMESPACE
 
             pointer new_data = grow_copy(new_capacity, _size + 1);
 
-            if (_content.first().data) { _content.second().deallocate(_content.first().data); }
+            if (_content.first().data && _content.first().data != new_data) { _content.second().deallocate(_content.first().data); }
             _content.first().data = new_data;
             _content.first().capacity = new_capacity;*/
 
@@ -1367,7 +1389,7 @@ FST_BEGIN_NAMESPACE
 
             pointer new_data = grow_copy(new_capacity, _size + 1);
 
-            if (_content.first().data) { _content.second().deallocate(_content.first().data); }
+            if (_content.first().data && _content.first().data != new_data) { _content.second().deallocate(_content.first().data); }
             _content.first().data = new_data;
             _content.first().capacity = new_capacity;
         }
@@ -1399,7 +1421,7 @@ FST_BEGIN_NAMESPACE
             new_data[_size] = c;
             new_data[new_size] = 0;
 
-            if (_content.first().data) { _content.second().deallocate(_content.first().data); }
+            if (_content.first().data && _content.first().data != new_data) { _content.second().deallocate(_content.first().data); }
             _content.first().data = new_data;
             _content.first().size = new_size;
             _content.first().capacity = new_capacity;
@@ -1444,7 +1466,7 @@ FST_BEGIN_NAMESPACE
             __fst::mem_fill(new_data + index, c, count);
             new_data[new_size] = 0;
 
-            if (_content.first().data) { _content.second().deallocate(_content.first().data); }
+            if (_content.first().data && _content.first().data != new_data) { _content.second().deallocate(_content.first().data); }
             _content.first().data = new_data;
             _content.first().size = new_size;
             _content.first().capacity = new_capacity;
@@ -1476,12 +1498,12 @@ FST_BEGIN_NAMESPACE
 
             const size_type new_capacity = __fst::next_power_of_two(new_size);
 
-            pointer new_data = grow_copy(new_capacity, _size, _data);
+            pointer new_data = grow_copy(new_capacity, _size, _data, str.data());
             __fst::memmove((void*) (new_data + index + count), (const void*) (new_data + index), delta * sizeof(value_type));
             __fst::memmove(new_data + index, str.data(), count * sizeof(value_type));
             new_data[new_size] = 0;
 
-            if (_content.first().data) { _content.second().deallocate(_content.first().data); }
+            if (_content.first().data && _content.first().data != new_data) { _content.second().deallocate(_content.first().data); }
             _content.first().data = new_data;
             _content.first().size = new_size;
             _content.first().capacity = new_capacity;
@@ -1519,12 +1541,12 @@ FST_BEGIN_NAMESPACE
 
             const size_type new_capacity = __fst::next_power_of_two(new_size);
 
-            pointer new_data = grow_copy(new_capacity, _size, _data);
-            __fst::memmove((void*) (new_data + index + s_size), (const void*) (_data + index), delta * sizeof(value_type));
+            pointer new_data = grow_copy(new_capacity, _size, _data, str.data());
+            __fst::memmove((void*) (new_data + index + s_size), (const void*) (new_data + index), delta * sizeof(value_type));
             __fst::memmove(new_data + index, str.data() + index_str, s_size * sizeof(value_type));
             new_data[new_size] = 0;
 
-            if (_content.first().data) { _content.second().deallocate(_content.first().data); }
+            if (_content.first().data && _content.first().data != new_data) { _content.second().deallocate(_content.first().data); }
             _content.first().data = new_data;
             _content.first().size = new_size;
             _content.first().capacity = new_capacity;
@@ -1654,9 +1676,25 @@ FST_BEGIN_NAMESPACE
 
         FST_NODISCARD FST_ALWAYS_INLINE pointer grow_copy(size_type new_size, size_type old_size) noexcept { return grow_copy(new_size, old_size, data()); }
 
-        FST_NODISCARD inline pointer grow_copy(size_type new_size, size_type old_size, pointer _data) noexcept
+        // The buffer is reallocated in place when possible, unless source points inside it.
+        FST_NODISCARD inline pointer grow_copy(size_type new_size, size_type old_size, pointer _data, const_pointer source = nullptr) noexcept
         {
             const size_type alloc_length = new_size + 1;
+
+            if constexpr (__fst::allocator_has_reallocate<allocator_type>::value)
+            {
+                if (_content.first().data && !(source >= _data && source <= _data + old_size))
+                {
+                    pointer new_data = _content.second().reallocate(_content.first().data, old_size, alloc_length);
+                    // On failure the old buffer is untouched, fall back to allocate and copy.
+                    if (new_data)
+                    {
+                        _content.first().data = new_data;
+                        return new_data;
+                    }
+                }
+            }
+
             pointer new_data = (pointer) _content.second().allocate(alloc_length);
             __fst::memmove(new_data, _data, old_size * sizeof(value_type));
             return new_data;
@@ -1956,6 +1994,17 @@ FST_BEGIN_NAMESPACE
             } };
     }
 
+    template <class _CharT, class _Allocator>
+    struct hash<__fst::basic_string<_CharT, _Allocator>> : __fst::hash<__fst::basic_string_view<_CharT>>
+    {
+        using __fst::hash<__fst::basic_string_view<_CharT>>::operator();
+
+        FST_NODISCARD inline size_t operator()(const __fst::basic_string<_CharT, _Allocator>& str) const noexcept
+        {
+            return __fst::hash<__fst::basic_string_view<_CharT>>{}(str.view());
+        }
+    };
+
 FST_END_NAMESPACE
 
 #if FST_USE_STL
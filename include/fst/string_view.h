@@ -314,6 +314,20 @@ FST_BEGIN_NAMESPACE
         stream.write(str.data(), str.size());
         return stream;
     }
+
+    template <class _CharT>
+    struct hash<__fst::basic_string_view<_CharT>>
+    {
+        /// Strings hash to the same value as their view, maps with string keys can be searched with a string_view.
+        using is_transparent = void;
+
+        FST_NODISCARD inline constexpr size_t operator()(__fst::basic_string_view<_CharT> str) const noexcept
+        {
+            return (size_t) __fst::hash_string(str.data(), str.size());
+        }
+
+        FST_NODISCARD inline constexpr size_t operator()(const _CharT* str) const noexcept { return operator()(__fst::basic_string_view<_CharT>(str)); }
+    };
 FST_END_NAMESPACE
 
 #if FST_USE_STL
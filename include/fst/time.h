@@ -92,6 +92,13 @@ FST_BEGIN_NAMESPACE
         FST_NODISCARD static ::time_t to_time_t(const time_point& t) noexcept { return (::time_t) t.time_since_epoch(); }
     };
 
+    /// Monotonic clock, unaffected by changes of the system time.
+    struct steady_clock
+    {
+        /// Nanoseconds since an unspecified point in the past.
+        static uint64_t now_ns() noexcept;
+    };
+
     size_t time_to_string(__fst::memory_range<char, 13> buffer, time_point now, char sep = ':') noexcept;
     size_t time_to_string2(__fst::memory_range<char, 12> buffer, time_point now, char sep) noexcept;
     ;
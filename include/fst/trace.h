@@ -24,8 +24,37 @@
 
 #pragma once
 
+///
+/// @file fst/trace.h
+///
+/// fst_trace writes fixed size binary records, the formatting happens offline.
+///
+/// Each thread pushes its records in its own ring buffer, a background thread drains
+/// them and writes them to FST_TRACE_DIRECTORY/trace_HH_MM_SS_MMM.fsttrace. The caller
+/// only reads the time stamp counter and copies its arguments.
+///
+/// Arguments are packed in the records: integers, floating points, bools, chars and
+/// strings are copied as is, anything else is formatted with its stream operator.
+/// A message can span up to trace_max_records_per_message records, what doesn't fit
+/// is truncated. When a thread fills its ring buffer faster than it is drained, the
+/// new messages are dropped and counted instead of blocking the caller.
+///
+/// decode_trace renders a trace file in the text format of trace_stream, see the
+/// TraceDecoder example.
+///
+
 #include "fst/common.h"
 #include "fst/stream.h"
+#include "fst/memory_utils.h"
+#include "fst/traits.h"
+
+#if __FST_ARCH_INTEL__
+#if __FST_MSVC__
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
 
 FST_BEGIN_NAMESPACE
 
@@ -43,33 +72,221 @@ FST_BEGIN_NAMESPACE
     struct is_trace_section : __fst::is_detected<detail::has_name_t, T>
     {};
 
+    /// Binary trace record, one cache line.
+    struct trace_record
+    {
+        static constexpr size_t payload_size = 48;
+
+        enum flags : uint8_t {
+            has_message = 1,
+
+            /// The payload continues the message of the previous record of the same thread.
+            continued = 2,
+        };
+
+        uint64_t timestamp;
+        uint32_t location_id;
+        uint16_t section_id;
+        uint8_t level;
+        uint8_t flags;
+        uint8_t payload[payload_size];
+    };
+
+    static_assert(sizeof(trace_record) == 64, "trace_record should be one cache line");
+
+    FST_INLINE_VAR constexpr size_t trace_max_records_per_message = 4;
+
+    /// Registered once per fst_trace call site.
+    struct trace_site
+    {
+        uint32_t location_id;
+        uint16_t section_id;
+    };
+
+    /// Returns the ids of a call site, registering its location and section the first time.
+    FST_NODISCARD trace_site register_trace_site(const __fst::source_location& loc, const char* section) noexcept;
+
+    /// Writes every pending record to the trace file.
+    void trace_flush() noexcept;
+
+    /// Path of the trace file, empty if it couldn't be opened.
+    FST_NODISCARD const char* trace_file_path() noexcept;
+
+    /// Renders a binary trace in the trace_stream text format, messages are sorted by time.
+    /// @returns false if data isn't a valid trace.
+    bool decode_trace(const void* data, size_t size, __fst::output_stream<char>& stream) noexcept;
+
+    namespace detail
+    {
+        uint64_t trace_fallback_timestamp() noexcept;
+
+        /// rdtsc on intel, the virtual counter on arm64, converted to time by the decoder.
+        FST_NODISCARD FST_ALWAYS_INLINE uint64_t trace_timestamp() noexcept
+        {
+#if __FST_ARCH_INTEL__
+            return (uint64_t) __rdtsc();
+#elif __FST_ARCH_ARM_64__ && !__FST_MSVC__
+            uint64_t t;
+            __asm__ volatile("mrs %0, cntvct_el0" : "=r"(t));
+            return t;
+#else
+            return trace_fallback_timestamp();
+#endif
+        }
+
+        enum class trace_arg : uint8_t {
+            end,
+            boolean,
+            character,
+            int64,
+            uint64,
+            float64,
+
+            /// uint8_t size followed by the characters, printed with a space after.
+            string,
+
+            /// Same as string without the space, used for stream modifiers.
+            raw,
+            truncated
+        };
+
+        void trace_push(trace_site site, size_t level, bool has_message, uint64_t timestamp, const uint8_t* payload, size_t size) noexcept;
+
+        class trace_encoder
+        {
+          public:
+            // The last byte is kept for the truncated tag.
+            static constexpr size_t capacity = trace_max_records_per_message * trace_record::payload_size - 1;
+            static constexpr size_t format_buffer_size = 128;
+
+            template <class _T>
+            inline void add(const _T& value) noexcept
+            {
+                if (_truncated) { return; }
+
+                if constexpr (__fst::is_same_v<_T, bool>) { add_value(trace_arg::boolean, (uint8_t) value); }
+                else if constexpr (__fst::is_same_v<_T, char>) { add_value(trace_arg::character, value); }
+                else if constexpr (__fst::is_integral_v<_T> && __fst::is_signed_v<_T>) { add_value(trace_arg::int64, (int64_t) value); }
+                else if constexpr (__fst::is_integral_v<_T>) { add_value(trace_arg::uint64, (uint64_t) value); }
+                else if constexpr (__fst::is_floating_point_v<_T>) { add_value(trace_arg::float64, (double) value); }
+                else if constexpr (__fst::is_convertible_v<const _T&, const char*>)
+                {
+                    const char* str = value;
+                    if (str) { add_string(trace_arg::string, str, __fst::strlen(str)); }
+                    else { add_string(trace_arg::string, "(null)", 6); }
+                }
+                else
+                {
+                    struct format_buffer
+                    {
+                        char data[format_buffer_size];
+                        size_t size = 0;
+                    } buffer;
+
+                    __fst::output_stream<char> stream(&buffer,
+                        [](void* data, const char* str, size_t size, __fst::stream_modifier) noexcept -> size_t
+                        {
+                            format_buffer& b = *(format_buffer*) data;
+                            size = __fst::minimum(size, format_buffer_size - b.size);
+                            __fst::memcpy(b.data + b.size, str, size);
+                            b.size += size;
+                            return size;
+                        });
+
+                    __fst::print_element(stream, value);
+                    add_string(__fst::is_stream_modifier<_T>::value ? trace_arg::raw : trace_arg::string, buffer.data, buffer.size);
+                }
+            }
+
+            inline void add_string(trace_arg type, const char* str, size_t size) noexcept
+            {
+                if (_size + 2 > capacity)
+                {
+                    _truncated = true;
+                    return;
+                }
+
+                const size_t count = __fst::minimum(__fst::minimum(size, capacity - _size - 2), (size_t) 255);
+                _data[_size] = (uint8_t) type;
+                _data[_size + 1] = (uint8_t) count;
+                __fst::memcpy(_data + _size + 2, str, count);
+                _size += count + 2;
+                _truncated = count != size;
+            }
+
+            FST_NODISCARD FST_ALWAYS_INLINE const uint8_t* data() noexcept
+            {
+                if (_truncated) { _data[_size++] = (uint8_t) trace_arg::truncated; }
+                return _data;
+            }
+
+            FST_NODISCARD FST_ALWAYS_INLINE size_t size() const noexcept { return _size; }
+
+          private:
+            uint8_t _data[capacity + 1];
+            size_t _size = 0;
+            bool _truncated = false;
+
+            template <class _T>
+            FST_ALWAYS_INLINE void add_value(trace_arg type, _T value) noexcept
+            {
+                if (_size + 1 + sizeof(_T) > capacity)
+                {
+                    _truncated = true;
+                    return;
+                }
+
+                _data[_size] = (uint8_t) type;
+                __fst::memcpy(_data + _size + 1, &value, sizeof(_T));
+                _size += 1 + sizeof(_T);
+            }
+        };
+    } // namespace detail
+
     template <size_t _Level, class _Section = default_trace_section>
     class tracer
     {
       public:
-        using stream_type = __fst::output_stream<char>;
-        using sep_type = __fst::stream_detail::stream_space_t;
-        using end_type = __fst::stream_detail::stream_endl_t;
         static constexpr size_t level = _Level;
 
         static_assert(level <= FST_TRACE_LEVEL, "trace level cannot exceed FST_TRACE_LEVEL");
 
+        /// Looks up the call site on every call, fst_trace registers it only once.
         inline tracer(const __fst::source_location& loc = __fst::source_location::current()) noexcept
-            : _loc{ loc }
+            : _site{ __fst::register_trace_site(loc, _Section::name) }
+        {}
+
+        inline tracer(trace_site site) noexcept
+            : _site{ site }
         {}
 
         template <typename... Args>
-        inline void operator()(Args&&... args) const noexcept
+        inline void operator()(const Args&... args) const noexcept
         {
-            basic_print<stream_type, sep_type, end_type>(__fst::trace_stream(level, _Section::name, _loc, sizeof...(args)), args..., __fst::endl);
+            const uint64_t timestamp = __fst::detail::trace_timestamp();
+
+            if constexpr (sizeof...(args) == 0) { __fst::detail::trace_push(_site, level, false, timestamp, nullptr, 0); }
+            else
+            {
+                __fst::detail::trace_encoder encoder;
+                (encoder.add(args), ...);
+                const uint8_t* data = encoder.data();
+                __fst::detail::trace_push(_site, level, true, timestamp, data, encoder.size());
+            }
         }
 
       private:
-        __fst::source_location _loc;
+        trace_site _site;
     };
 
 #if FST_TRACE_LEVEL > 0
-#define fst_trace(LEVEL, SECTION, ...) FST_NAMESPACE::tracer<LEVEL, SECTION>()(__VA_ARGS__)
+#define fst_trace(LEVEL, SECTION, ...)                                                                      \
+    do                                                                                                      \
+    {                                                                                                       \
+        static const FST_NAMESPACE::trace_site __fst_trace_site                                             \
+            = FST_NAMESPACE::register_trace_site(FST_NAMESPACE::source_location::current(), SECTION::name); \
+        FST_NAMESPACE::tracer<LEVEL, SECTION>{ __fst_trace_site }(__VA_ARGS__);                             \
+    } while (0)
 #else
 #define fst_trace(...) FST_UNUSED(__VA_ARGS__)
 #endif
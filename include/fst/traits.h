@@ -425,6 +425,10 @@ namespace detail {
 
     template <class R, class F, class... ArgTypes>
     struct is_invocable_r<true, R, F, ArgTypes...> : __fst::is_invoke_convertible<__fst::invoke_result_t<F, ArgTypes...>, R> { };
+
+    // Any result can be discarded.
+    template <class F, class... ArgTypes>
+    struct is_invocable_r<true, void, F, ArgTypes...> : __fst::true_t { };
 } // namespace detail
 
 // is_invocable_r
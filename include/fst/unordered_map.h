@@ -25,325 +25,652 @@
 #pragma once
 
 #include "fst/common.h"
+#include "fst/memory.h"
+#include "fst/pair.h"
 #include "fst/small_vector.h"
+#include "fst/traits.h"
+#include "fst/utility.h"
 #include "fst/vector.h"
 
+#if __FST_ARCH_INTEL__ && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP == 2))
+#define __FST_HASH_TABLE_SSE2__ 1
+#include <emmintrin.h>
+#else
+#define __FST_HASH_TABLE_SSE2__ 0
+#endif
+
+#if __FST_MSVC__
+#include <intrin.h>
+#endif
+
 FST_BEGIN_NAMESPACE
 
-    template <class _Key, class _T, size_t _Alignment = alignof(_T), class _MemoryZone = __fst::default_memory_zone, class _MemoryCategory = __fst::default_memory_category>
-    class unordered_map
+    namespace detail
     {
-      public:
-        static_assert(__fst::is_power_of_two(_Alignment), "_Alignment must be a power of two");
-
-        using key_type = _Key;
-        using value_type = _T;
+        //
+        // Swiss table index.
+        //
+        // Every slot has a control byte: empty, deleted or the 7 low bits of the key hash when full.
+        // Lookups compare a whole group of 16 control bytes at once (with sse2 when available) and
+        // only look at the keys whose 7 bits match. The first group_width control bytes are cloned
+        // after the end so that a group can always be loaded in a single instruction.
+        // The width never depends on the compile flags, translation units built for different
+        // instruction sets must agree on the layout and the probe sequence of the same map type.
+        // @see https://abseil.io/about/design/swisstables
+        //
+        using hash_table_ctrl = int8_t;
+        FST_INLINE_VAR constexpr hash_table_ctrl hash_table_empty = -128;
+        FST_INLINE_VAR constexpr hash_table_ctrl hash_table_deleted = -2;
+
+        FST_NODISCARD FST_ALWAYS_INLINE uint32_t hash_table_trailing_zeros(uint32_t mask) noexcept
+        {
+#if __FST_MSVC__
+            unsigned long index;
+            _BitScanForward(&index, mask);
+            return (uint32_t) index;
+#else
+            return (uint32_t) __builtin_ctz(mask);
+#endif
+        }
 
-        using size_type = size_t;
-        using difference_type = ptrdiff_t;
+        FST_NODISCARD FST_ALWAYS_INLINE uint32_t hash_table_highest_bit(uint32_t mask) noexcept
+        {
+#if __FST_MSVC__
+            unsigned long index;
+            _BitScanReverse(&index, mask);
+            return (uint32_t) index;
+#else
+            return 31u - (uint32_t) __builtin_clz(mask);
+#endif
+        }
 
-        using pointer = value_type*;
-        using const_pointer = const value_type*;
-        using reference = value_type&;
-        using const_reference = __fst::cref_t<value_type>;
+#if __FST_HASH_TABLE_SSE2__
+        struct hash_table_group
+        {
+            static constexpr size_t width = 16;
 
-        using iterator = pointer;
-        using const_iterator = const_pointer;
+            FST_ALWAYS_INLINE explicit hash_table_group(const hash_table_ctrl* ctrl) noexcept
+                : _ctrl(_mm_loadu_si128((const __m128i*) ctrl))
+            {}
 
-        using key_const_reference = __fst::cref_t<key_type>;
+            FST_NODISCARD FST_ALWAYS_INLINE uint32_t match(hash_table_ctrl h2) const noexcept
+            {
+                return (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(_ctrl, _mm_set1_epi8(h2)));
+            }
 
-        using key_vector = __fst::vector<key_type, alignof(key_type), _MemoryZone, _MemoryCategory>;
-        using value_vector = __fst::vector<value_type, _Alignment, _MemoryZone, _MemoryCategory>;
+            FST_NODISCARD FST_ALWAYS_INLINE uint32_t match_empty() const noexcept { return match(hash_table_empty); }
 
-        FST_NODISCARD FST_ALWAYS_INLINE constexpr size_type size() const noexcept { return _values.size(); }
-        FST_NODISCARD FST_ALWAYS_INLINE constexpr bool empty() const noexcept { return _values.empty(); }
+            // Empty and deleted are the only control values below -1.
+            FST_NODISCARD FST_ALWAYS_INLINE uint32_t match_empty_or_deleted() const noexcept
+            {
+                return (uint32_t) _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), _ctrl));
+            }
 
-        FST_NODISCARD inline constexpr iterator begin() noexcept { return _values.begin(); }
-        FST_NODISCARD inline constexpr const_iterator begin() const noexcept { return _values.begin(); }
+            __m128i _ctrl;
+        };
 
-        FST_NODISCARD inline constexpr iterator end() noexcept { return _values.end(); }
-        FST_NODISCARD inline constexpr const_iterator end() const noexcept { return _values.end(); }
+#else
+        struct hash_table_group
+        {
+            static constexpr size_t width = 16;
 
-        FST_NODISCARD inline constexpr const_iterator cbegin() const noexcept { return begin(); }
-        FST_NODISCARD inline constexpr const_iterator cend() const noexcept { return end(); }
+            FST_ALWAYS_INLINE explicit hash_table_group(const hash_table_ctrl* ctrl) noexcept { __fst::memcpy(_ctrl, ctrl, width); }
 
-        FST_NODISCARD constexpr reference front() noexcept { return _values.front(); }
-        FST_NODISCARD constexpr const_reference front() const noexcept { return _values.front(); }
+            FST_NODISCARD FST_ALWAYS_INLINE uint32_t match(hash_table_ctrl h2) const noexcept
+            {
+                uint32_t mask = 0;
+                for (size_t i = 0; i < width; i++)
+                {
+                    mask |= (uint32_t) (_ctrl[i] == h2) << i;
+                }
+                return mask;
+            }
 
-        FST_NODISCARD constexpr reference back() noexcept { return _values.back(); }
-        FST_NODISCARD constexpr const_reference back() const noexcept { return _values.back(); }
+            FST_NODISCARD FST_ALWAYS_INLINE uint32_t match_empty() const noexcept { return match(hash_table_empty); }
 
-        FST_NODISCARD constexpr iterator find(key_const_reference key) noexcept
-        {
-            for (size_type i = 0; i < size(); i++)
+            FST_NODISCARD FST_ALWAYS_INLINE uint32_t match_empty_or_deleted() const noexcept
             {
-                if (_keys[i] == key) { return iterator(_values.data() + i); }
+                uint32_t mask = 0;
+                for (size_t i = 0; i < width; i++)
+                {
+                    mask |= (uint32_t) (_ctrl[i] < -1) << i;
+                }
+                return mask;
             }
 
-            return end();
-        }
+            hash_table_ctrl _ctrl[width];
+        };
+#endif
+
+        static_assert(hash_table_group::width == 16, "the group width is part of the map layout");
 
-        FST_NODISCARD constexpr const_iterator find(key_const_reference key) const noexcept
+        /// Open addressing index that maps a hash to a uint32_t (the position of the entry in the dense arrays of the map).
+        /// It never looks at the keys, lookups take a predicate that compares the key stored at a given index.
+        template <class _MemoryZone, class _MemoryCategory>
+        class hash_table_index
         {
-            for (size_type i = 0; i < size(); i++)
+          public:
+            using group_type = __fst::detail::hash_table_group;
+            static constexpr size_t group_width = group_type::width;
+            static constexpr size_t npos = (size_t) -1;
+
+            hash_table_index() noexcept = default;
+
+            inline hash_table_index(const hash_table_index& other) noexcept
             {
-                if (_keys[i] == key) { return const_iterator(_values.data() + i); }
+                if (other._capacity && allocate(other._capacity))
+                {
+                    __fst::memcpy(_data.first(), other._data.first(), buffer_size(_capacity));
+                    _growth_left = other._growth_left;
+                }
             }
 
-            return end();
-        }
+            inline hash_table_index(hash_table_index&& other) noexcept
+                : _data(__fst::exchange(other._data.first(), nullptr), other._data.second())
+                , _slots(__fst::exchange(other._slots, nullptr))
+                , _capacity(__fst::exchange(other._capacity, 0))
+                , _growth_left(__fst::exchange(other._growth_left, 0))
+            {}
 
-        FST_ALWAYS_INLINE reference operator[](key_const_reference key) noexcept
-        {
-            for (size_type i = 0; i < size(); i++)
+            inline ~hash_table_index() noexcept { release(); }
+
+            inline hash_table_index& operator=(const hash_table_index& other) noexcept
             {
-                if (_keys[i] == key) { return _values[i]; }
-            }
+                if (this == &other) { return *this; }
 
-            _keys.push_back(key);
-            _values.push_back(value_type{});
-            return _values.back();
-        }
+                if (_capacity != other._capacity)
+                {
+                    release();
+                    if (!other._capacity || !allocate(other._capacity)) { return *this; }
+                }
 
-        template <class U = key_type, __fst::enable_if_t<!__fst::is_trivial_cref_v<U> && __fst::is_same_v<U, key_type>, int> = 0>
-        FST_NODISCARD FST_ALWAYS_INLINE reference operator[](key_type&& key) noexcept
-        {
-            for (size_type i = 0; i < size(); i++)
+                if (_capacity) { __fst::memcpy(_data.first(), other._data.first(), buffer_size(_capacity)); }
+                _growth_left = other._growth_left;
+                return *this;
+            }
+
+            inline hash_table_index& operator=(hash_table_index&& other) noexcept
             {
-                if (_keys[i] == key) { return _values[i]; }
+                if (this == &other) { return *this; }
+
+                release();
+                _data.first() = __fst::exchange(other._data.first(), nullptr);
+                _slots = __fst::exchange(other._slots, nullptr);
+                _capacity = __fst::exchange(other._capacity, 0);
+                _growth_left = __fst::exchange(other._growth_left, 0);
+                return *this;
             }
 
-            _keys.push_back(__fst::move(key));
-            _values.push_back(value_type{});
-            return _values.back();
-        }
+            FST_NODISCARD FST_ALWAYS_INLINE size_t capacity() const noexcept { return _capacity; }
 
-        FST_ALWAYS_INLINE void clear() noexcept
-        {
-            _keys.clear();
-            _values.clear();
-        }
+            /// Number of slots that can still be filled before the index has to be rebuilt.
+            FST_NODISCARD FST_ALWAYS_INLINE size_t growth_left() const noexcept { return _growth_left; }
 
-        bool insert(key_const_reference key, const_reference value) noexcept
-        {
-            for (size_type i = 0; i < size(); i++)
+            /// Smallest capacity that can hold count entries under the 7/8 max load factor.
+            FST_NODISCARD static inline size_t capacity_for(size_t count) noexcept
             {
-                if (_keys[i] == key) { return false; }
+                size_t capacity = group_width;
+                while (max_load(capacity) < count)
+                {
+                    capacity *= 2;
+                }
+                return capacity;
             }
 
-            _keys.push_back(key);
-            _values.push_back(value);
-            return true;
-        }
-
-        template <class... _Args>
-        bool emplace(key_const_reference key, _Args&&... args) noexcept
-        {
-            for (size_type i = 0; i < size(); i++)
+            /// Empties the index and makes room for capacity slots (a power of two of at least group_width).
+            inline bool reset(size_t capacity) noexcept
             {
-                if (_keys[i] == key) { return false; }
+                fst_assert(__fst::is_power_of_two(capacity) && capacity >= group_width, "Invalid hash table capacity");
+
+                if (capacity != _capacity)
+                {
+                    release();
+                    if (!allocate(capacity)) { return false; }
+                }
+
+                clear();
+                return true;
             }
 
-            _keys.push_back(key);
-            _values.emplace_back(__fst::forward<_Args>(args)...);
-            return true;
-        }
+            inline void clear() noexcept
+            {
+                if (!_capacity) { return; }
 
-        template <class K>
-        FST_NODISCARD FST_ALWAYS_INLINE bool contains(const K& key) const noexcept
-        {
-            for (size_type i = 0; i < size(); i++)
+                __fst::memset(_data.first(), (uint8_t) hash_table_empty, _capacity + group_width);
+                _growth_left = max_load(_capacity);
+            }
+
+            inline void release() noexcept
             {
-                if (_keys[i] == key) { return true; }
+                if (_data.first()) { _data.second().aligned_deallocate(_data.first(), _MemoryCategory::id()); }
+
+                _data.first() = nullptr;
+                _slots = nullptr;
+                _capacity = 0;
+                _growth_left = 0;
             }
 
-            return false;
-        }
+            FST_NODISCARD FST_ALWAYS_INLINE uint32_t& slot(size_t pos) noexcept { return _slots[pos]; }
+            FST_NODISCARD FST_ALWAYS_INLINE uint32_t slot(size_t pos) const noexcept { return _slots[pos]; }
 
-        size_type erase(key_const_reference key) noexcept
-        {
-            for (size_type i = 0; i < size(); i++)
+            /// Returns the position of the first slot for which pred(slot) is true, or npos.
+            template <class _Pred>
+            FST_NODISCARD FST_ALWAYS_INLINE size_t find(uint64_t hash, _Pred && pred) const noexcept
             {
-                if (_keys[i] == key)
+                const hash_table_ctrl* ctrl = _data.first();
+                const hash_table_ctrl h2 = (hash_table_ctrl) (hash & 0x7F);
+                const size_t mask = _capacity - 1;
+                size_t pos = (size_t) (hash >> 7) & mask;
+
+                for (size_t step = group_width;; step += group_width)
                 {
+                    const group_type group(ctrl + pos);
+                    for (uint32_t m = group.match(h2); m; m &= m - 1)
+                    {
+                        const size_t p = (pos + hash_table_trailing_zeros(m)) & mask;
+                        if (pred(_slots[p])) { return p; }
+                    }
 
-                    _keys.erase_at(i);
-                    _values.erase_at(i);
-                    return 1;
+                    if (group.match_empty()) { return npos; }
+
+                    // Triangular probing visits every group once when the capacity is a power of two.
+                    pos = (pos + step) & mask;
                 }
             }
 
-            return 0;
-        }
+            /// Adds an entry, the caller makes sure that growth_left() is not zero.
+            inline void insert(uint64_t hash, uint32_t value) noexcept
+            {
+                fst_assert(_growth_left, "hash table index is full");
+
+                const hash_table_ctrl* ctrl = _data.first();
+                const size_t mask = _capacity - 1;
+                size_t pos = (size_t) (hash >> 7) & mask;
+
+                for (size_t step = group_width;; step += group_width)
+                {
+                    if (const uint32_t m = group_type(ctrl + pos).match_empty_or_deleted())
+                    {
+                        pos = (pos + hash_table_trailing_zeros(m)) & mask;
+                        break;
+                    }
+
+                    pos = (pos + step) & mask;
+                }
 
-        inline size_type erase(const_iterator it) noexcept
+                _growth_left -= ctrl[pos] == hash_table_empty;
+                set_ctrl(pos, (hash_table_ctrl) (hash & 0x7F));
+                _slots[pos] = value;
+            }
+
+            inline void erase(size_t pos) noexcept
+            {
+                const hash_table_ctrl* ctrl = _data.first();
+                const size_t before = (pos - group_width) & (_capacity - 1);
+                const uint32_t empty_after = group_type(ctrl + pos).match_empty();
+                const uint32_t empty_before = group_type(ctrl + before).match_empty();
+
+                // If every group that contains pos also has an empty slot, no probe sequence ever
+                // went past this slot and it can go back to empty instead of becoming a tombstone.
+                const bool was_never_full = empty_before && empty_after
+                                            && hash_table_trailing_zeros(empty_after) + (group_width - 1 - hash_table_highest_bit(empty_before)) < group_width;
+
+                set_ctrl(pos, was_never_full ? hash_table_empty : hash_table_deleted);
+                _growth_left += was_never_full;
+            }
+
+          private:
+            __fst::pair<hash_table_ctrl*, _MemoryZone> _data = {};
+            uint32_t* _slots = nullptr;
+            size_t _capacity = 0;
+            size_t _growth_left = 0;
+
+            FST_NODISCARD static FST_ALWAYS_INLINE size_t max_load(size_t capacity) noexcept { return capacity - capacity / 8; }
+
+            FST_NODISCARD static FST_ALWAYS_INLINE size_t buffer_size(size_t capacity) noexcept
+            {
+                return capacity + group_width + capacity * sizeof(uint32_t);
+            }
+
+            inline bool allocate(size_t capacity) noexcept
+            {
+                hash_table_ctrl* data = (hash_table_ctrl*) _data.second().aligned_allocate(buffer_size(capacity), group_width, _MemoryCategory::id());
+                if (!data) { return false; }
+
+                _data.first() = data;
+                _slots = (uint32_t*) (data + capacity + group_width);
+                _capacity = capacity;
+                _growth_left = max_load(capacity);
+                return true;
+            }
+
+            FST_ALWAYS_INLINE void set_ctrl(size_t pos, hash_table_ctrl value) noexcept
+            {
+                hash_table_ctrl* ctrl = _data.first();
+                ctrl[pos] = value;
+                if (pos < group_width) { ctrl[_capacity + pos] = value; }
+            }
+        };
+
+        template <class _Hash>
+        using hash_is_transparent_t = typename _Hash::is_transparent;
+
+        /// Keys and values live in two dense arrays (iteration is a plain walk over the values),
+        /// lookups go through a hash_table_index once the map holds more than linear_search_size
+        /// entries. Erasing moves the last entry into the hole, the order is not preserved.
+        template <class _Key, class _T, class _KeyVector, class _ValueVector, class _Hash, class _MemoryZone, class _MemoryCategory>
+        class basic_unordered_map
         {
-            size_type index = __fst::distance(_values.cbegin(), it);
-            if (_values.size() <= index) { return 0; }
+          public:
+            using key_type = _Key;
+            using value_type = _T;
+            using hasher = _Hash;
 
-            _keys.erase_at(index);
-            _values.erase_at(index);
-            return 1;
-        }
+            using size_type = size_t;
+            using difference_type = ptrdiff_t;
 
-        FST_NODISCARD FST_ALWAYS_INLINE const key_vector& keys() const noexcept { return _keys; }
+            using pointer = value_type*;
+            using const_pointer = const value_type*;
+            using reference = value_type&;
+            using const_reference = __fst::cref_t<value_type>;
 
-        FST_NODISCARD FST_ALWAYS_INLINE const value_vector& values() const noexcept { return _values; }
+            using iterator = pointer;
+            using const_iterator = const_pointer;
 
-        key_vector _keys;
-        value_vector _values;
-    };
+            using key_const_reference = __fst::cref_t<key_type>;
 
-    template <class _Key, class _T, size_t _Size, size_t _Alignment = alignof(_T), class _MemoryZone = __fst::default_memory_zone,
-        class _MemoryCategory = __fst::default_memory_category>
-    class small_unordered_map
-    {
-      public:
-        static_assert(__fst::is_power_of_two(_Alignment), "_Alignment must be a power of two");
+            using key_vector = _KeyVector;
+            using value_vector = _ValueVector;
 
-        using key_type = _Key;
-        using value_type = _T;
+            /// Up to this size, lookups compare the keys one by one and no index is allocated.
+            static constexpr size_type linear_search_size = 8;
 
-        using size_type = size_t;
-        using difference_type = ptrdiff_t;
+            /// Heterogeneous lookup (e.g. string_view on a string map) is enabled when the hasher defines is_transparent.
+            static constexpr bool is_transparent = __fst::is_detected_v<hash_is_transparent_t, hasher>;
 
-        using pointer = value_type*;
-        using const_pointer = const value_type*;
-        using reference = value_type&;
-        using const_reference = __fst::cref_t<value_type>;
+            template <class K>
+            using enable_if_lookup_key_t = __fst::enable_if_t<is_transparent && !__fst::is_same_v<__fst::remove_cvref_t<K>, key_type>, int>;
 
-        using iterator = pointer;
-        using const_iterator = const_pointer;
+            FST_NODISCARD FST_ALWAYS_INLINE constexpr size_type size() const noexcept { return _values.size(); }
+            FST_NODISCARD FST_ALWAYS_INLINE constexpr bool empty() const noexcept { return _values.empty(); }
 
-        using key_const_reference = __fst::cref_t<key_type>;
+            FST_NODISCARD inline constexpr iterator begin() noexcept { return _values.begin(); }
+            FST_NODISCARD inline constexpr const_iterator begin() const noexcept { return _values.begin(); }
 
-        using key_vector = __fst::small_vector<key_type, _Size, alignof(key_type), _MemoryZone, _MemoryCategory>;
-        using value_vector = __fst::small_vector<value_type, _Size, _Alignment, _MemoryZone, _MemoryCategory>;
+            FST_NODISCARD inline constexpr iterator end() noexcept { return _values.end(); }
+            FST_NODISCARD inline constexpr const_iterator end() const noexcept { return _values.end(); }
 
-        FST_NODISCARD FST_ALWAYS_INLINE constexpr size_type size() const noexcept { return _values.size(); }
-        FST_NODISCARD FST_ALWAYS_INLINE constexpr bool empty() const noexcept { return _values.empty(); }
+            FST_NODISCARD inline constexpr const_iterator cbegin() const noexcept { return begin(); }
+            FST_NODISCARD inline constexpr const_iterator cend() const noexcept { return end(); }
 
-        FST_NODISCARD inline constexpr iterator begin() noexcept { return _values.begin(); }
-        FST_NODISCARD inline constexpr const_iterator begin() const noexcept { return _values.begin(); }
+            FST_NODISCARD constexpr reference front() noexcept { return _values.front(); }
+            FST_NODISCARD constexpr const_reference front() const noexcept { return _values.front(); }
 
-        FST_NODISCARD inline constexpr iterator end() noexcept { return _values.end(); }
-        FST_NODISCARD inline constexpr const_iterator end() const noexcept { return _values.end(); }
+            FST_NODISCARD constexpr reference back() noexcept { return _values.back(); }
+            FST_NODISCARD constexpr const_reference back() const noexcept { return _values.back(); }
 
-        FST_NODISCARD inline constexpr const_iterator cbegin() const noexcept { return begin(); }
-        FST_NODISCARD inline constexpr const_iterator cend() const noexcept { return end(); }
+            FST_NODISCARD inline iterator find(key_const_reference key) noexcept { return find_impl(key); }
+            FST_NODISCARD inline const_iterator find(key_const_reference key) const noexcept { return find_impl(key); }
 
-        FST_NODISCARD constexpr reference front() noexcept { return _values.front(); }
-        FST_NODISCARD constexpr const_reference front() const noexcept { return _values.front(); }
+            template <class K, enable_if_lookup_key_t<K> = 0>
+            FST_NODISCARD inline iterator find(const K& key) noexcept
+            {
+                return find_impl(key);
+            }
 
-        FST_NODISCARD constexpr reference back() noexcept { return _values.back(); }
-        FST_NODISCARD constexpr const_reference back() const noexcept { return _values.back(); }
+            template <class K, enable_if_lookup_key_t<K> = 0>
+            FST_NODISCARD inline const_iterator find(const K& key) const noexcept
+            {
+                return find_impl(key);
+            }
 
-        FST_NODISCARD constexpr iterator find(key_const_reference key) noexcept
-        {
-            for (size_type i = 0; i < size(); i++)
+            FST_NODISCARD FST_ALWAYS_INLINE bool contains(key_const_reference key) const noexcept { return lookup(key, lookup_hash(key)).index != npos; }
+
+            template <class K, enable_if_lookup_key_t<K> = 0>
+            FST_NODISCARD FST_ALWAYS_INLINE bool contains(const K& key) const noexcept
             {
-                if (_keys[i] == key) { return iterator(_values.data() + i); }
+                return lookup(key, lookup_hash(key)).index != npos;
             }
 
-            return end();
-        }
+            FST_ALWAYS_INLINE reference operator[](key_const_reference key) noexcept
+            {
+                const uint64_t hash = lookup_hash(key);
+                if (const size_type index = lookup(key, hash).index; index != npos) { return _values[index]; }
 
-        FST_NODISCARD constexpr const_iterator find(key_const_reference key) const noexcept
-        {
-            for (size_type i = 0; i < size(); i++)
+                return push_entry(hash, key);
+            }
+
+            template <class U = key_type, __fst::enable_if_t<!__fst::is_trivial_cref_v<U> && __fst::is_same_v<U, key_type>, int> = 0>
+            FST_NODISCARD FST_ALWAYS_INLINE reference operator[](key_type&& key) noexcept
             {
-                if (_keys[i] == key) { return const_iterator(_values.data() + i); }
+                const uint64_t hash = lookup_hash(key);
+                if (const size_type index = lookup(key, hash).index; index != npos) { return _values[index]; }
+
+                return push_entry(hash, __fst::move(key));
             }
 
-            return end();
-        }
+            inline void clear() noexcept
+            {
+                _keys.clear();
+                _values.clear();
+                _index.clear();
+            }
 
-        FST_ALWAYS_INLINE reference operator[](key_const_reference key) noexcept
-        {
-            for (size_type i = 0; i < size(); i++)
+            bool insert(key_const_reference key, const_reference value) noexcept
             {
-                if (_keys[i] == key) { return _values[i]; }
+                const uint64_t hash = lookup_hash(key);
+                if (lookup(key, hash).index != npos) { return false; }
+
+                push_entry(hash, key, value);
+                return true;
             }
 
-            _keys.push_back(key);
-            _values.push_back(value_type{});
-            return _values.back();
-        }
+            /// The value is only constructed when the key is missing, directly in the map storage.
+            template <class... _Args>
+            bool emplace(key_const_reference key, _Args&&... args) noexcept
+            {
+                const uint64_t hash = lookup_hash(key);
+                if (lookup(key, hash).index != npos) { return false; }
 
-        template <class U = key_type, __fst::enable_if_t<!__fst::is_trivial_cref_v<U> && __fst::is_same_v<U, key_type>, int> = 0>
-        FST_NODISCARD FST_ALWAYS_INLINE reference operator[](key_type&& key) noexcept
-        {
-            for (size_type i = 0; i < size(); i++)
+                push_entry(hash, key, __fst::forward<_Args>(args)...);
+                return true;
+            }
+
+            /// Erasing moves the last entry into the erased slot: the iteration order of the remaining
+            /// entries changes, and iterators and references to the last entry are invalidated.
+            inline size_type erase(key_const_reference key) noexcept { return erase_impl(key); }
+
+            template <class K, enable_if_lookup_key_t<K> = 0>
+            inline size_type erase(const K& key) noexcept
             {
-                if (_keys[i] == key) { return _values[i]; }
+                return erase_impl(key);
             }
 
-            _keys.push_back(__fst::move(key));
-            _values.push_back(value_type{});
-            return _values.back();
-        }
+            /// Same as erase(key), the entry after it is not the next one to visit.
+            inline size_type erase(const_iterator it) noexcept
+            {
+                const size_type index = (size_type) (it - cbegin());
+                if (size() <= index) { return 0; }
 
-        FST_ALWAYS_INLINE void clear() noexcept
-        {
-            _keys.clear();
-            _values.clear();
-        }
+                return erase_impl(_keys[index]);
+            }
 
-        bool insert(key_const_reference key, const_reference value) noexcept
-        {
-            for (size_type i = 0; i < size(); i++)
+            /// Makes room for count entries without any rehash or reallocation.
+            inline void reserve(size_type count) noexcept
             {
-                if (_keys[i] == key) { return false; }
+                _keys.reserve(count);
+                _values.reserve(count);
+
+                if (count > linear_search_size && count > max_indexed_size()) { rebuild_index(index_type::capacity_for(count)); }
             }
 
-            _keys.push_back(key);
-            _values.push_back(value);
-            return true;
-        }
+            /// Rebuilds the index with at least count slots (and never less than what the current size needs).
+            /// rehash(0) shrinks the index to fit, or releases it when the map is small enough for linear lookups.
+            inline void rehash(size_type count) noexcept
+            {
+                if (!count && size() <= linear_search_size)
+                {
+                    _index.release();
+                    return;
+                }
 
-        template <class K>
-        FST_NODISCARD FST_ALWAYS_INLINE bool contains(const K& key) const noexcept
-        {
-            for (size_type i = 0; i < size(); i++)
+                size_type capacity = index_type::capacity_for(size());
+                while (capacity < count)
+                {
+                    capacity *= 2;
+                }
+
+                rebuild_index(capacity);
+            }
+
+            /// Number of slots in the index, zero while lookups are linear.
+            FST_NODISCARD FST_ALWAYS_INLINE size_type bucket_count() const noexcept { return _index.capacity(); }
+
+            FST_NODISCARD FST_ALWAYS_INLINE float load_factor() const noexcept { return _index.capacity() ? (float) size() / (float) _index.capacity() : 0.0f; }
+
+            FST_NODISCARD FST_ALWAYS_INLINE const key_vector& keys() const noexcept { return _keys; }
+
+            FST_NODISCARD FST_ALWAYS_INLINE const value_vector& values() const noexcept { return _values; }
+
+          private:
+            using index_type = __fst::detail::hash_table_index<_MemoryZone, _MemoryCategory>;
+            static constexpr size_type npos = (size_type) -1;
+
+            struct lookup_result
             {
-                if (_keys[i] == key) { return true; }
+                size_type index;
+                size_type pos;
+            };
+
+            key_vector _keys;
+            value_vector _values;
+            index_type _index;
+
+            template <class K>
+            FST_NODISCARD FST_ALWAYS_INLINE static uint64_t hash_key(const K& key) noexcept
+            {
+                // Spreads the bits of weak hashes (e.g. identity on integers), the index needs good high and low bits.
+                const uint64_t h = (uint64_t) hasher{}(key) * 0x9E3779B97F4A7C15ull;
+                return h ^ (h >> 32);
             }
 
-            return false;
-        }
+            /// The hash is only needed once the index exists.
+            template <class K>
+            FST_NODISCARD FST_ALWAYS_INLINE uint64_t lookup_hash(const K& key) const noexcept
+            {
+                return _index.capacity() ? hash_key(key) : 0;
+            }
 
-        size_type erase(key_const_reference key) noexcept
-        {
-            for (size_type i = 0; i < size(); i++)
+            FST_NODISCARD FST_ALWAYS_INLINE size_type max_indexed_size() const noexcept { return _index.capacity() - _index.capacity() / 8; }
+
+            template <class K>
+            FST_NODISCARD FST_ALWAYS_INLINE lookup_result lookup(const K& key, uint64_t hash) const noexcept
             {
-                if (_keys[i] == key)
+                if (!_index.capacity())
                 {
+                    for (size_type i = 0; i < size(); i++)
+                    {
+                        if (_keys[i] == key) { return { i, npos }; }
+                    }
 
-                    _keys.erase_at(i);
-                    _values.erase_at(i);
-                    return 1;
+                    return { npos, npos };
                 }
+
+                const size_type pos = _index.find(hash, [&](uint32_t index) { return _keys[index] == key; });
+                return { pos == npos ? npos : (size_type) _index.slot(pos), pos };
             }
 
-            return 0;
-        }
+            template <class K>
+            FST_NODISCARD FST_ALWAYS_INLINE pointer find_impl(const K& key) const noexcept
+            {
+                const size_type index = lookup(key, lookup_hash(key)).index;
+                return (pointer) (index == npos ? _values.data() + size() : _values.data() + index);
+            }
 
-        inline size_type erase(const_iterator it) noexcept
-        {
-            difference_type index = __fst::distance(_values.cbegin(), it);
-            if (_values.size() <= (size_type) index) { return 0; }
+            /// hash comes from lookup_hash(), it is zero if the index didn't exist yet.
+            template <class K, class... _Args>
+            inline reference push_entry(uint64_t hash, K&& key, _Args&&... args) noexcept
+            {
+                const size_type index = size();
+                const bool hashed = _index.capacity() != 0;
 
-            _keys.erase_at((size_type) index);
-            _values.erase_at((size_type) index);
-            return 1;
-        }
+                if (_index.capacity() ? !_index.growth_left() : index >= linear_search_size)
+                {
+                    // Past the max load, or too many tombstones: rebuilding at the same capacity is enough
+                    // when the map is not that full, otherwise the capacity doubles.
+                    const size_type capacity = _index.capacity();
+                    rebuild_index(capacity && index < capacity * 25 / 32 ? capacity : __fst::maximum(index_type::capacity_for(index + 1), capacity * 2));
+                }
+
+                _keys.push_back(__fst::forward<K>(key));
 
-        FST_NODISCARD FST_ALWAYS_INLINE const key_vector& keys() const noexcept { return _keys; }
+                // The vectors copy trivially copyable values as a whole, a temporary of those costs nothing.
+                if constexpr (__fst::is_trivially_copyable_v<value_type>) { _values.emplace_back(value_type(__fst::forward<_Args>(args)...)); }
+                else { _values.emplace_back(__fst::forward<_Args>(args)...); }
+
+                if (_index.capacity()) { _index.insert(hashed ? hash : hash_key(_keys.back()), (uint32_t) index); }
+
+                return _values.back();
+            }
+
+            template <class K>
+            inline size_type erase_impl(const K& key) noexcept
+            {
+                const lookup_result r = lookup(key, lookup_hash(key));
+                if (r.index == npos) { return 0; }
 
-        FST_NODISCARD FST_ALWAYS_INLINE const value_vector& values() const noexcept { return _values; }
+                if (_index.capacity()) { _index.erase(r.pos); }
 
-        key_vector _keys;
-        value_vector _values;
+                const size_type last = size() - 1;
+                if (r.index != last)
+                {
+                    // The last entry fills the hole, its index slot has to follow.
+                    if (_index.capacity())
+                    {
+                        const size_type pos = _index.find(hash_key(_keys[last]), [last](uint32_t index) { return index == last; });
+                        _index.slot(pos) = (uint32_t) r.index;
+                    }
+
+                    _keys[r.index] = __fst::move(_keys[last]);
+                    _values[r.index] = __fst::move(_values[last]);
+                }
+
+                _keys.pop_back();
+                _values.pop_back();
+                return 1;
+            }
+
+            inline void rebuild_index(size_type capacity) noexcept
+            {
+                if (!_index.reset(capacity)) { return; }
+
+                for (size_type i = 0; i < size(); i++)
+                {
+                    _index.insert(hash_key(_keys[i]), (uint32_t) i);
+                }
+            }
+        };
+    } // namespace detail
+
+    template <class _Key, class _T, size_t _Alignment = alignof(_T), class _MemoryZone = __fst::default_memory_zone,
+        class _MemoryCategory = __fst::default_memory_category, class _Hash = __fst::hash<_Key>>
+    class unordered_map
+        : public __fst::detail::basic_unordered_map<_Key, _T, __fst::vector<_Key, alignof(_Key), _MemoryCategory, _MemoryZone>,
+              __fst::vector<_T, _Alignment, _MemoryCategory, _MemoryZone>, _Hash, _MemoryZone, _MemoryCategory>
+    {
+      public:
+        static_assert(__fst::is_power_of_two(_Alignment), "_Alignment must be a power of two");
+    };
+
+    /// Same as unordered_map but the first _Size keys and values are stored inline.
+    template <class _Key, class _T, size_t _Size, size_t _Alignment = alignof(_T), class _MemoryZone = __fst::default_memory_zone,
+        class _MemoryCategory = __fst::default_memory_category, class _Hash = __fst::hash<_Key>>
+    class small_unordered_map
+        : public __fst::detail::basic_unordered_map<_Key, _T, __fst::small_vector<_Key, _Size, alignof(_Key), _MemoryZone, _MemoryCategory>,
+              __fst::small_vector<_T, _Size, _Alignment, _MemoryZone, _MemoryCategory>, _Hash, _MemoryZone, _MemoryCategory>
+    {
+      public:
+        static_assert(__fst::is_power_of_two(_Alignment), "_Alignment must be a power of two");
     };
 
 FST_END_NAMESPACE
@@ -28,6 +28,7 @@
 #include "fst/traits.h"
 #include "fst/iterator.h"
 #include "fst/math.h"
+#include "fst/hash.h"
 
 FST_BEGIN_NAMESPACE
 
@@ -490,54 +491,25 @@ FST_BEGIN_NAMESPACE
     // Hash
     //
 
-// These FNV-1a utility functions are extremely performance sensitive,
-// check examples like that in VSO-653642 before making changes.
-#if defined(_WIN64)
-    FST_INLINE_VAR constexpr size_t _FNV_offset_basis = 14695981039346656037ULL;
-    FST_INLINE_VAR constexpr size_t _FNV_prime = 1099511628211ULL;
-#else // defined(_WIN64)
-    FST_INLINE_VAR constexpr size_t _FNV_offset_basis = 2166136261U;
-    FST_INLINE_VAR constexpr size_t _FNV_prime = 16777619U;
-#endif // defined(_WIN64)
-
-    FST_NODISCARD inline size_t _Fnv1a_append_bytes(size_t _Val, const unsigned char* const _First, const size_t _Count) noexcept
-    {
-        for (size_t _Idx = 0; _Idx < _Count; ++_Idx)
-        {
-            _Val ^= static_cast<size_t>(_First[_Idx]);
-            _Val *= _FNV_prime;
-        }
-
-        return _Val;
-    }
-
-    template <class _Ty>
-    FST_NODISCARD size_t _Fnv1a_append_range(const size_t _Val, const _Ty* const _First, const _Ty* const _Last) noexcept
-    {
-        static_assert(__fst::is_trivial_v<_Ty>, "Only trivial types can be directly hashed.");
-        const auto _Firstb = reinterpret_cast<const unsigned char*>(_First);
-        const auto _Lastb = reinterpret_cast<const unsigned char*>(_Last);
-        return __fst::_Fnv1a_append_bytes(_Val, _Firstb, static_cast<size_t>(_Lastb - _Firstb));
-    }
-
     template <class _Kty>
-    FST_NODISCARD size_t _Fnv1a_append_value(const size_t _Val, const _Kty& _Keyval) noexcept
+    FST_NODISCARD FST_ALWAYS_INLINE size_t _Hash_representation(const _Kty& _Keyval) noexcept
     {
         static_assert(__fst::is_trivial_v<_Kty>, "Only trivial types can be directly hashed.");
-        return __fst::_Fnv1a_append_bytes(_Val, &reinterpret_cast<const unsigned char&>(_Keyval), sizeof(_Kty));
-    }
 
-    template <class _Kty>
-    FST_NODISCARD size_t _Hash_representation(const _Kty& _Keyval) noexcept
-    {
-        return __fst::_Fnv1a_append_value(_FNV_offset_basis, _Keyval);
+        if constexpr (sizeof(_Kty) <= sizeof(uint64_t))
+        {
+            uint64_t _Bits = 0;
+            __fst::memcpy(&_Bits, &_Keyval, sizeof(_Kty));
+            return (size_t) __fst::hash_int(_Bits);
+        }
+        else { return (size_t) __fst::hash_bytes(&_Keyval, sizeof(_Kty)); }
     }
 
     template <class _Kty>
-    FST_NODISCARD size_t _Hash_array_representation(const _Kty* const _First, const size_t _Count) noexcept
+    FST_NODISCARD FST_ALWAYS_INLINE size_t _Hash_array_representation(const _Kty* const _First, const size_t _Count) noexcept
     {
         static_assert(__fst::is_trivial_v<_Kty>, "Only trivial types can be directly hashed.");
-        return _Fnv1a_append_bytes(__fst::_FNV_offset_basis, reinterpret_cast<const unsigned char*>(_First), _Count * sizeof(_Kty));
+        return (size_t) __fst::hash_bytes(_First, _Count * sizeof(_Kty));
     }
 
     template <class _Kty>
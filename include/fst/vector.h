@@ -374,7 +374,7 @@ FST_BEGIN_NAMESPACE
         FST_ALWAYS_INLINE constexpr void pop_back() noexcept
         {
             fst_assert(_size > 0, "Can't pop_back an empty fixed_vector.");
-            if constexpr (!__fst::is_trivially_destructible_v<value_type>) { (*this)[_size].~value_type(); }
+            if constexpr (!__fst::is_trivially_destructible_v<value_type>) { (*this)[_size - 1].~value_type(); }
             --_size;
         }
 
@@ -413,7 +413,7 @@ FST_BEGIN_NAMESPACE
                     this->data()[i] = __fst::move(this->data()[i + 1]);
                 }
 
-                if constexpr (!__fst::is_trivially_destructible_v<value_type>) { (*this)[_size].~value_type(); }
+                if constexpr (!__fst::is_trivially_destructible_v<value_type>) { (*this)[_size - 1].~value_type(); }
                 _size--;
                 this->insert(this->begin() + dst, __fst::move(elem));
             }
@@ -429,7 +429,7 @@ FST_BEGIN_NAMESPACE
                 return;
             }
 
-            if constexpr (__fst::is_trivially_copyable_v<value_type>) { __fst::memmove(begin() + index, begin() + index + 1, (_size - index) * sizeof(value_type)); }
+            if constexpr (__fst::is_trivially_copyable_v<value_type>) { __fst::memmove(begin() + index, begin() + index + 1, (_size - index - 1) * sizeof(value_type)); }
             else
             {
                 for (size_type i = index; i < size() - 1; i++)
@@ -437,7 +437,7 @@ FST_BEGIN_NAMESPACE
                     this->data()[i] = __fst::move(this->data()[i + 1]);
                 }
 
-                if constexpr (!__fst::is_trivially_destructible_v<value_type>) { (*this)[_size].~value_type(); }
+                if constexpr (!__fst::is_trivially_destructible_v<value_type>) { (*this)[_size - 1].~value_type(); }
             }
 
             _size--;
@@ -457,7 +457,7 @@ FST_BEGIN_NAMESPACE
 
             __fst::move_element((*this)[index], __fst::move(this->back()));
 
-            if constexpr (!__fst::is_trivially_destructible_v<value_type>) { (*this)[_size].~value_type(); }
+            if constexpr (!__fst::is_trivially_destructible_v<value_type>) { (*this)[_size - 1].~value_type(); }
             _size--;
         }
 
@@ -617,6 +617,26 @@ FST_BEGIN_NAMESPACE
 
         inline bool grow(size_t new_capacity) noexcept
         {
+            if (_data.first())
+            {
+                if constexpr (__fst::is_trivially_copyable_v<_T>)
+                {
+                    // The zone can grow the block in place or move it without going through a temporary copy.
+                    _T* tmp_data = (_T*) __fst::memory_zone_reallocate(
+                        _data.second(), (void*) _data.first(), _size * sizeof(_T), new_capacity * sizeof(_T), _Alignment, _MemoryCategory::id());
+                    if (!tmp_data) { return false; }
+
+                    _capacity = new_capacity;
+                    _data.first() = tmp_data;
+                    return true;
+                }
+                else if (__fst::memory_zone_try_expand(_data.second(), (void*) _data.first(), new_capacity * sizeof(_T), _MemoryCategory::id()))
+                {
+                    _capacity = new_capacity;
+                    return true;
+                }
+            }
+
             _T* tmp_data = (_T*) _data.second().aligned_allocate(new_capacity * sizeof(_T), _Alignment, _MemoryCategory::id());
             if (!tmp_data) { return false; }
 
@@ -1,7 +1,35 @@
-//#include "fst/common.h"
-//#include "fst/error_code.h"
-//#include <stdio.h>
+#include "fst/async/event.h"
 
-//FST_BEGIN_NAMESPACE
-//void print_version() { printf("fst version %s (C++%d)\n", __FST_LONG_VERSION_STR__, __FST_CPP_VERSION__); }
-//FST_END_NAMESPACE
+FST_BEGIN_SUB_NAMESPACE(async)
+
+    void event::set() noexcept
+    {
+        // A waiter can return and destroy the event as soon as the exchange is visible (sync_wait
+        // keeps it on the stack), nothing is read from it after that. The wake up only uses the address.
+        const reset_mode mode = _mode;
+        const volatile void* address = &_state;
+
+        // Already signaled, whoever is waiting was (or will be) woken up by the previous set.
+        if (_state.exchange(signaled) == signaled) { return; }
+
+        if (mode == reset_mode::manual) { __fst::detail::atomic_notify_all(address, sizeof(uint32_t)); }
+        else { __fst::detail::atomic_notify_one(address, sizeof(uint32_t)); }
+    }
+
+    void event::wait() noexcept
+    {
+        while (!try_wait())
+        {
+            _state.wait(unsignaled);
+        }
+    }
+
+    bool event::wait_for_us(uint64_t timeout_us) noexcept
+    {
+        if (try_wait()) { return true; }
+
+        // One retry after the wake up, another waiter may have consumed an auto-reset signal.
+        return _state.wait_for_us(unsignaled, timeout_us) && try_wait();
+    }
+
+FST_END_SUB_NAMESPACE
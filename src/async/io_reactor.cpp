@@ -0,0 +1,221 @@
+#include "fst/async/io_reactor.h"
+#include "fst/async/thread.h"
+#include "fst/atomic.h"
+#include "fst/mutex.h"
+#include "fst/vector.h"
+
+#if __FST_WINDOWS__
+#define WIN32_LEAN_AND_MEAN
+#include <winsock2.h>
+#pragma comment(lib, "Ws2_32.lib")
+#else
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif // __FST_WINDOWS__
+
+FST_BEGIN_SUB_NAMESPACE(async)
+
+    namespace
+    {
+#if __FST_WINDOWS__
+        using pollfd_type = WSAPOLLFD;
+        using native_fd_type = SOCKET;
+
+        // There's no wake up pipe for WSAPoll, new waiters are picked up after at most this delay.
+        constexpr int poll_timeout_ms = 10;
+
+        inline int poll_handles(pollfd_type* fds, size_t count, int timeout_ms) noexcept { return ::WSAPoll(fds, (ULONG) count, timeout_ms); }
+#else
+        using pollfd_type = ::pollfd;
+        using native_fd_type = int;
+
+        constexpr int poll_timeout_ms = -1;
+
+        inline int poll_handles(pollfd_type* fds, size_t count, int timeout_ms) noexcept { return ::poll(fds, (nfds_t) count, timeout_ms); }
+#endif // __FST_WINDOWS__
+
+        inline short to_poll_events(io_reactor::io_event event) noexcept { return event == io_reactor::io_event::readable ? POLLIN : POLLOUT; }
+
+        inline pollfd_type make_pollfd(io_reactor::native_handle_type handle, short events) noexcept
+        {
+            pollfd_type fd = {};
+            fd.fd = (native_fd_type) handle;
+            fd.events = events;
+            return fd;
+        }
+    } // namespace
+
+    struct io_reactor::native
+    {
+        struct waiter
+        {
+            native_handle_type handle;
+            short events;
+            std::coroutine_handle<> coroutine;
+        };
+
+        inline native() noexcept
+            : _thread(
+                  [this]()
+                  {
+                      __fst::async::this_thread::set_name("fst io_reactor");
+                      run();
+                  })
+        {}
+
+        inline ~native() noexcept
+        {
+            _stop.store(true);
+            wake();
+            _thread.join();
+
+            fst_assert(_pending_count.load() == 0, "io_reactor destroyed while coroutines are still waiting");
+        }
+
+        inline void add(native_handle_type handle, io_event event, std::coroutine_handle<> coroutine) noexcept
+        {
+            ++_pending_count;
+
+            _mutex.lock();
+            _pending.push_back(waiter{ handle, to_poll_events(event), coroutine });
+            _mutex.unlock();
+
+            wake();
+        }
+
+        inline void wake() noexcept
+        {
+#if !__FST_WINDOWS__
+            // A full pipe already has a wake up pending.
+            const char c = 0;
+            [[maybe_unused]] ssize_t res = ::write(_wake.fds[1], &c, 1);
+#endif // !__FST_WINDOWS__
+        }
+
+        inline void run() noexcept
+        {
+            __fst::vector<waiter> active;
+            __fst::vector<pollfd_type> fds;
+            __fst::vector<std::coroutine_handle<>> ready;
+
+#if __FST_WINDOWS__
+            constexpr size_t offset = 0;
+#else
+            constexpr size_t offset = 1;
+#endif // __FST_WINDOWS__
+
+            while (!_stop.load())
+            {
+                _mutex.lock();
+                for (const waiter& w : _pending)
+                {
+                    active.push_back(w);
+                }
+                _pending.clear();
+                _mutex.unlock();
+
+                fds.clear();
+#if !__FST_WINDOWS__
+                fds.push_back(make_pollfd(_wake.fds[0], POLLIN));
+#endif // !__FST_WINDOWS__
+
+                for (const waiter& w : active)
+                {
+                    fds.push_back(make_pollfd(w.handle, w.events));
+                }
+
+#if __FST_WINDOWS__
+                if (fds.empty())
+                {
+                    // WSAPoll fails without any handle.
+                    __fst::async::this_thread::sleep_for_us(poll_timeout_ms * 1000);
+                    continue;
+                }
+#endif // __FST_WINDOWS__
+
+                if (poll_handles(fds.data(), fds.size(), poll_timeout_ms) <= 0) { continue; }
+
+#if !__FST_WINDOWS__
+                if (fds[0].revents)
+                {
+                    char buffer[64];
+                    while (::read(_wake.fds[0], buffer, sizeof(buffer)) > 0) {}
+                }
+#endif // !__FST_WINDOWS__
+
+                // Errors and hang ups are reported as ready, the coroutine finds out when it reads or writes.
+                size_t count = 0;
+                for (size_t i = 0; i < active.size(); i++)
+                {
+                    if (fds[i + offset].revents) { ready.push_back(active[i].coroutine); }
+                    else { active[count++] = active[i]; }
+                }
+                active.resize(count);
+
+                // A resumed coroutine can wait again, it goes through _pending like any other.
+                for (std::coroutine_handle<> coroutine : ready)
+                {
+                    --_pending_count;
+                    coroutine.resume();
+                }
+                ready.clear();
+            }
+        }
+
+        __fst::mutex _mutex;
+        __fst::vector<waiter> _pending;
+        __fst::atomic<size_t> _pending_count = 0;
+        __fst::atomic<bool> _stop = false;
+#if !__FST_WINDOWS__
+        // Writing a byte in the pipe interrupts poll when a waiter is added or the reactor stops.
+        struct wake_pipe
+        {
+            int fds[2] = { -1, -1 };
+
+            inline wake_pipe() noexcept
+            {
+                if (::pipe(fds) != 0)
+                {
+                    fst_error("io_reactor wake up pipe creation failed");
+                    return;
+                }
+
+                ::fcntl(fds[0], F_SETFL, ::fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+                ::fcntl(fds[1], F_SETFL, ::fcntl(fds[1], F_GETFL) | O_NONBLOCK);
+            }
+
+            inline ~wake_pipe() noexcept
+            {
+                ::close(fds[0]);
+                ::close(fds[1]);
+            }
+        };
+
+        wake_pipe _wake;
+#endif // !__FST_WINDOWS__
+
+        // Started last, everything above is ready when run() begins.
+        __fst::async::thread _thread;
+    };
+
+    io_reactor::io_reactor() noexcept
+        : _native(native_pointer::make())
+    {}
+
+    io_reactor::~io_reactor() noexcept {}
+
+    size_t io_reactor::pending() const noexcept { return _native->_pending_count.load(); }
+
+    void io_reactor::add(native_handle_type handle, io_event event, std::coroutine_handle<> coroutine) noexcept
+    {
+        _native->add(handle, event, coroutine);
+    }
+
+    bool io_reactor::is_ready(native_handle_type handle, io_event event) noexcept
+    {
+        pollfd_type fd = make_pollfd(handle, to_poll_events(event));
+        return poll_handles(&fd, 1, 0) > 0;
+    }
+
+FST_END_SUB_NAMESPACE
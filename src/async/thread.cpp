@@ -1,55 +1,443 @@
+#if !defined(_GNU_SOURCE) && !defined(_WIN32)
+#define _GNU_SOURCE
+#endif
+
 #include "fst/async/thread.h"
+#include "fst/atomic.h"
 #include "fst/utility.h"
+
+#if __FST_WINDOWS__
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#include <process.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+#endif // __FST_WINDOWS__
+
 FST_BEGIN_SUB_NAMESPACE(async)
 
+    namespace
+    {
+        enum thread_state : uint32_t {
+            state_running,
+            state_finished,
+            state_detached
+        };
+
+        // Copies at most 15 characters, the maximum thread name length on linux.
+        FST_ALWAYS_INLINE void copy_thread_name(char (&buffer)[16], const char* name) noexcept
+        {
+            size_t i = 0;
+            for (; i < 15 && name[i]; i++)
+            {
+                buffer[i] = name[i];
+            }
+            buffer[i] = 0;
+        }
+
+#if __FST_WINDOWS__
+        inline bool set_native_thread_name(::HANDLE handle, const char* name) noexcept
+        {
+            wchar_t wname[64];
+            if (!::MultiByteToWideChar(CP_UTF8, 0, name, -1, wname, (int) __fst::array_size(wname))) { return false; }
+            return SUCCEEDED(::SetThreadDescription(handle, wname));
+        }
+
+        inline bool set_native_thread_affinity(::HANDLE handle, uint64_t cpu_mask) noexcept
+        {
+            return ::SetThreadAffinityMask(handle, (::DWORD_PTR) cpu_mask) != 0;
+        }
+
+        // Cpus past 64 are in other processor groups.
+        inline bool set_native_thread_cpu(::HANDLE handle, size_t cpu_index) noexcept
+        {
+            ::GROUP_AFFINITY affinity = {};
+            affinity.Group = (::WORD) (cpu_index / 64);
+            affinity.Mask = ::KAFFINITY(1) << (cpu_index % 64);
+            return affinity.Group < ::GetActiveProcessorGroupCount() && ::SetThreadGroupAffinity(handle, &affinity, nullptr) != 0;
+        }
+#else
+        inline bool set_native_thread_affinity(FST_ATTRIBUTE_UNUSED ::pthread_t handle, FST_ATTRIBUTE_UNUSED uint64_t cpu_mask) noexcept
+        {
+#if __FST_LINUX__ || __FST_ANDROID__
+            ::cpu_set_t set;
+            CPU_ZERO(&set);
+
+            for (int i = 0; i < 64; i++)
+            {
+                if (cpu_mask & (uint64_t(1) << i)) { CPU_SET(i, &set); }
+            }
+
+            return ::pthread_setaffinity_np(handle, sizeof(set), &set) == 0;
+#else
+            // macOS only has affinity tags which are hints, not pinning.
+            return false;
+#endif
+        }
+
+        inline bool set_native_thread_cpu(FST_ATTRIBUTE_UNUSED ::pthread_t handle, FST_ATTRIBUTE_UNUSED size_t cpu_index) noexcept
+        {
+#if __FST_LINUX__ || __FST_ANDROID__
+            // A dynamic set, CPU_SETSIZE (1024) isn't a limit of the kernel.
+            const int count = (int) cpu_index + 1;
+            ::cpu_set_t* set = CPU_ALLOC(count);
+            if (!set) { return false; }
+
+            const size_t size = CPU_ALLOC_SIZE(count);
+            CPU_ZERO_S(size, set);
+            CPU_SET_S(cpu_index, size, set);
+            const bool result = ::pthread_setaffinity_np(handle, size, set) == 0;
+            CPU_FREE(set);
+            return result;
+#else
+            return false;
+#endif
+        }
+#endif // __FST_WINDOWS__
+    } // namespace
+
+#if __FST_WINDOWS__
     //
     struct thread::native
     {
+        using native_type = ::HANDLE;
+
+        FST_ALWAYS_INLINE native() noexcept = default;
+
+        FST_ALWAYS_INLINE ~native() noexcept { join(); }
 
-        native()
+        inline bool start(thread* t) noexcept
         {
+            _owner.store_release(t);
+            _data = t->_thread_data;
+            _handle = (native_type)::_beginthreadex(nullptr, 0, &native::entry, this, 0, nullptr);
+            return _handle != nullptr;
+        }
+
+        inline void join() noexcept
+        {
+            if (!_handle) { return; }
 
-            //print("NATIVE");
+            ::WaitForSingleObject(_handle, INFINITE);
+            ::CloseHandle(_handle);
+            _handle = nullptr;
         }
-        ~native()
+
+        inline void detach() noexcept
+        {
+            ::CloseHandle(_handle);
+            _handle = nullptr;
+        }
+
+        FST_NODISCARD FST_ALWAYS_INLINE bool joinable() const noexcept { return _handle != nullptr; }
+
+        FST_NODISCARD FST_ALWAYS_INLINE thread::id get_id() const noexcept { return thread::id(::GetThreadId(_handle)); }
+
+        FST_NODISCARD FST_ALWAYS_INLINE void* native_handle() const noexcept { return (void*) _handle; }
+
+        inline bool set_name(const char* name) noexcept { return set_native_thread_name(_handle, name); }
+
+        inline bool set_affinity(uint64_t cpu_mask) noexcept { return set_native_thread_affinity(_handle, cpu_mask); }
+
+        inline bool pin_to_cpu(size_t cpu_index) noexcept { return set_native_thread_cpu(_handle, cpu_index); }
+
+        static unsigned __stdcall entry(void* data) noexcept
         {
-            //fst::print("~native--dsjdksjdskjdksjdksjdskdsjd");
+            native* n = (native*) data;
+            const unsigned ret = (unsigned) n->_data.process(n->_owner.load_acquire(), n->_data.data);
+            n->finish();
+            return ret;
         }
+
+        inline void finish() noexcept;
+
+        native_type _handle = nullptr;
+        // Moving the thread object updates it while the thread may be starting.
+        __fst::atomic<thread*> _owner = nullptr;
+        thread_data _data = { nullptr, nullptr, nullptr };
+        __fst::atomic<uint32_t> _state = state_running;
     };
 
+#else
     //
-    thread::thread() noexcept
-        : _native(native_pointer::make())
-        , _thread_data{ nullptr, nullptr, nullptr }
+    struct thread::native
     {
+        using native_type = ::pthread_t;
+
+        FST_ALWAYS_INLINE native() noexcept = default;
+
+        FST_ALWAYS_INLINE ~native() noexcept { join(); }
+
+        inline bool start(thread* t) noexcept
+        {
+            _owner.store_release(t);
+            _data = t->_thread_data;
+            _started = ::pthread_create(&_handle, nullptr, &native::entry, this) == 0;
+            return _started;
+        }
+
+        inline void join() noexcept
+        {
+            if (!_started) { return; }
+
+            ::pthread_join(_handle, nullptr);
+            _started = false;
+        }
+
+        inline void detach() noexcept
+        {
+            ::pthread_detach(_handle);
+            _started = false;
+        }
+
+        FST_NODISCARD FST_ALWAYS_INLINE bool joinable() const noexcept { return _started; }
+
+        FST_NODISCARD FST_ALWAYS_INLINE thread::id get_id() const noexcept { return thread::id((uint64_t) _handle); }
+
+        FST_NODISCARD FST_ALWAYS_INLINE void* native_handle() const noexcept { return (void*) _handle; }
+
+        inline bool set_name(FST_ATTRIBUTE_UNUSED const char* name) noexcept
+        {
+#if __FST_LINUX__ || __FST_ANDROID__
+            char buffer[16];
+            copy_thread_name(buffer, name);
+            return ::pthread_setname_np(_handle, buffer) == 0;
+#elif __FST_MACOS__ || __FST_IOS__
+            // Only the calling thread can be renamed.
+            return ::pthread_equal(_handle, ::pthread_self()) && ::pthread_setname_np(name) == 0;
+#else
+            return false;
+#endif
+        }
+
+        inline bool set_affinity(uint64_t cpu_mask) noexcept { return set_native_thread_affinity(_handle, cpu_mask); }
+
+        inline bool pin_to_cpu(size_t cpu_index) noexcept { return set_native_thread_cpu(_handle, cpu_index); }
 
-        //native* ptr = (native*) __fst::default_memory_zone::aligned_allocate(sizeof(native), alignof(native), __fst::async_memory_category::id());
-        //fst_assert(ptr, "allocation failed");
+        static void* entry(void* data) noexcept
+        {
+            native* n = (native*) data;
+            n->_data.process(n->_owner.load_acquire(), n->_data.data);
+            n->finish();
+            return nullptr;
+        }
 
-        //ptr = fst_placement_new(ptr) native();
+        inline void finish() noexcept;
+
+        native_type _handle = {};
+        // Moving the thread object updates it while the thread may be starting.
+        __fst::atomic<thread*> _owner = nullptr;
+        thread_data _data = { nullptr, nullptr, nullptr };
+        __fst::atomic<uint32_t> _state = state_running;
+        bool _started = false;
+    };
+#endif // __FST_WINDOWS__
+
+    // Called by the thread itself once the process callback returned.
+    // A detached thread owns its native data and releases everything.
+    inline void thread::native::finish() noexcept
+    {
+        if (_state.exchange(state_finished) != state_detached) { return; }
 
-        //fst::print("thread create");
+        if (_data.release) { _data.release(nullptr, _data.data); }
 
-        //_native.reset(ptr);
+        this->~native();
+        __fst::default_memory_zone::aligned_deallocate(this, __fst::async_memory_category::id());
     }
 
+    //
+    thread::thread() noexcept
+        : _native(native_pointer::make())
+        , _thread_data{ nullptr, nullptr, nullptr }
+    {}
+
     thread::thread(thread::thread_data tdata) noexcept
         : _native(native_pointer::make())
         , _thread_data(tdata)
     {
+        fst_assert(_thread_data.process, "thread process callback cannot be null");
+
+        if (!_native->start(this))
+        {
+            // Creating the native thread failed, run the callback on the calling thread instead.
+            fst_warning("thread creation failed");
+            _thread_data.process(this, _thread_data.data);
+        }
+    }
 
-        _thread_data.process(this, _thread_data.data);
+    thread::thread(thread && other) noexcept
+        : _native(__fst::move(other._native))
+        , _thread_data(__fst::exchange(other._thread_data, thread_data{ nullptr, nullptr, nullptr }))
+    {
+        if (_native) { _native->_owner.store_release(this); }
     }
 
     thread::~thread() noexcept
     {
+        join();
 
         if (_thread_data.release) { _thread_data.release(this, _thread_data.data); }
     }
 
-    thread& thread::operator=(thread&&) noexcept
+    thread& thread::operator=(thread&& other) noexcept
     {
+        if (this == &other) { return *this; }
+
+        join();
+        if (_thread_data.release) { _thread_data.release(this, _thread_data.data); }
+
+        _native = __fst::move(other._native);
+        _thread_data = __fst::exchange(other._thread_data, thread_data{ nullptr, nullptr, nullptr });
+
+        if (_native) { _native->_owner.store_release(this); }
         return *this;
     }
 
+    void thread::swap(thread & other) noexcept
+    {
+        if (this == &other) { return; }
+
+        native_pointer tmp_native = __fst::move(_native);
+        _native = __fst::move(other._native);
+        other._native = __fst::move(tmp_native);
+
+        const thread_data tmp_data = _thread_data;
+        _thread_data = other._thread_data;
+        other._thread_data = tmp_data;
+
+        if (_native) { _native->_owner.store_release(this); }
+        if (other._native) { other._native->_owner.store_release(&other); }
+    }
+
+    bool thread::joinable() const noexcept
+    {
+        return _native && _native->joinable();
+    }
+
+    void thread::join() noexcept
+    {
+        if (_native) { _native->join(); }
+    }
+
+    void thread::detach() noexcept
+    {
+        if (!joinable()) { return; }
+
+        _native->detach();
+
+        if (_native->_state.exchange(state_detached) == state_finished)
+        {
+            // Already done, the release happens in the destructor as usual.
+            _native->_state.store(state_finished);
+            return;
+        }
+
+        // The thread now owns its native data and will release it when done.
+        (void) _native.release();
+        _thread_data = thread_data{ nullptr, nullptr, nullptr };
+    }
+
+    thread::id thread::get_id() const noexcept
+    {
+        return joinable() ? _native->get_id() : id();
+    }
+
+    thread::native_handle_type thread::native_handle() const noexcept
+    {
+        return joinable() ? _native->native_handle() : nullptr;
+    }
+
+    bool thread::set_name(const char* name) noexcept
+    {
+        fst_assert(name, "thread name cannot be null");
+        return joinable() && _native->set_name(name);
+    }
+
+    bool thread::set_affinity(uint64_t cpu_mask) noexcept
+    {
+        return joinable() && _native->set_affinity(cpu_mask);
+    }
+
+    bool thread::pin_to_cpu(size_t cpu_index) noexcept
+    {
+        return joinable() && _native->pin_to_cpu(cpu_index);
+    }
+
+    unsigned int thread::hardware_concurrency() noexcept
+    {
+#if __FST_WINDOWS__
+        ::SYSTEM_INFO info;
+        ::GetSystemInfo(&info);
+        const unsigned int count = (unsigned int) info.dwNumberOfProcessors;
+#else
+        const long count = ::sysconf(_SC_NPROCESSORS_ONLN);
+#endif // __FST_WINDOWS__
+
+        return count > 0 ? (unsigned int) count : 1u;
+    }
+
+    //
+    // this_thread
+    //
+    namespace this_thread
+    {
+        __fst::async::thread::id get_id() noexcept
+        {
+#if __FST_WINDOWS__
+            return __fst::async::thread::id(::GetCurrentThreadId());
+#else
+            return __fst::async::thread::id((uint64_t)::pthread_self());
+#endif // __FST_WINDOWS__
+        }
+
+        void yield() noexcept
+        {
+#if __FST_WINDOWS__
+            ::SwitchToThread();
+#else
+            ::sched_yield();
+#endif // __FST_WINDOWS__
+        }
+
+        void sleep_for_us(uint64_t microseconds) noexcept
+        {
+#if __FST_WINDOWS__
+            ::Sleep((::DWORD) ((microseconds + 999) / 1000));
+#else
+            ::timespec ts = { (time_t) (microseconds / 1000000), (long) ((microseconds % 1000000) * 1000) };
+            while (::nanosleep(&ts, &ts) == -1 && errno == EINTR) {}
+#endif // __FST_WINDOWS__
+        }
+
+        bool set_name(FST_ATTRIBUTE_UNUSED const char* name) noexcept
+        {
+            fst_assert(name, "thread name cannot be null");
+
+#if __FST_WINDOWS__
+            return set_native_thread_name(::GetCurrentThread(), name);
+#elif __FST_LINUX__ || __FST_ANDROID__
+            char buffer[16];
+            copy_thread_name(buffer, name);
+            return ::pthread_setname_np(::pthread_self(), buffer) == 0;
+#elif __FST_MACOS__ || __FST_IOS__
+            return ::pthread_setname_np(name) == 0;
+#else
+            return false;
+#endif
+        }
+
+        bool set_affinity(uint64_t cpu_mask) noexcept
+        {
+#if __FST_WINDOWS__
+            return set_native_thread_affinity(::GetCurrentThread(), cpu_mask);
+#else
+            return set_native_thread_affinity(::pthread_self(), cpu_mask);
+#endif // __FST_WINDOWS__
+        }
+    } // namespace this_thread
+
 FST_END_SUB_NAMESPACE
@@ -0,0 +1,510 @@
+#include "fst/async/thread_pool.h"
+#include "fst/atomic.h"
+#include "fst/mutex.h"
+#include "fst/utility.h"
+
+FST_BEGIN_SUB_NAMESPACE(async)
+
+    struct thread_pool::task
+    {
+        task_data data;
+        task* next;
+        __fst::atomic<uint32_t> refcount;
+        __fst::atomic<bool> done;
+    };
+
+    namespace
+    {
+        using task = thread_pool::task;
+
+        FST_ALWAYS_INLINE task* create_task(thread_pool::task_data tdata, uint32_t refcount) noexcept
+        {
+            task* t = (task*) __fst::default_memory_zone::aligned_allocate(sizeof(task), alignof(task), __fst::async_memory_category::id());
+            fst_assert(t, "allocation failed");
+            return fst_placement_new(t) task{ tdata, nullptr, refcount, false };
+        }
+
+        FST_ALWAYS_INLINE void release_task(task* t) noexcept
+        {
+            if (--t->refcount == 0)
+            {
+                t->~task();
+                __fst::default_memory_zone::aligned_deallocate(t, __fst::async_memory_category::id());
+            }
+        }
+
+        FST_ALWAYS_INLINE void execute_task(task* t) noexcept
+        {
+            t->data.process(t->data.data);
+
+            if (t->data.release) { t->data.release(t->data.data); }
+
+            t->done.store(true);
+            release_task(t);
+        }
+
+        /// Chase-Lev work-stealing deque.
+        /// Only the owner pushes and pops at the bottom, any thread can steal from the top.
+        /// @see Dynamic Circular Work-Stealing Deque (Chase, Lev 2005)
+        /// @see Correct and Efficient Work-Stealing for Weak Memory Models (Le et al. 2013)
+        class work_stealing_deque
+        {
+          public:
+            static constexpr int64_t capacity = 4096;
+            static constexpr int64_t mask = capacity - 1;
+
+            work_stealing_deque() noexcept = default;
+            work_stealing_deque(const work_stealing_deque&) = delete;
+            work_stealing_deque& operator=(const work_stealing_deque&) = delete;
+
+            /// Owner only, returns false when the deque is full.
+            inline bool push(task* t) noexcept
+            {
+                const int64_t b = _bottom.load();
+                const int64_t top = _top.load();
+
+                if (b - top >= capacity) { return false; }
+
+                _buffer[b & mask].store(t);
+                _bottom.store(b + 1);
+                return true;
+            }
+
+            /// Owner only.
+            inline task* pop() noexcept
+            {
+                const int64_t b = _bottom.load() - 1;
+                _bottom.store(b);
+
+                int64_t top = _top.load();
+
+                if (top > b)
+                {
+                    // Empty.
+                    _bottom.store(b + 1);
+                    return nullptr;
+                }
+
+                task* t = _buffer[b & mask].load();
+
+                if (top == b)
+                {
+                    // Last element, race against the thieves.
+                    if (!_top.compare_exchange_strong(top, top + 1)) { t = nullptr; }
+                    _bottom.store(b + 1);
+                }
+
+                return t;
+            }
+
+            /// Any thread.
+            inline task* steal() noexcept
+            {
+                int64_t top = _top.load();
+                const int64_t b = _bottom.load();
+
+                if (top >= b) { return nullptr; }
+
+                task* t = _buffer[top & mask].load();
+                return _top.compare_exchange_strong(top, top + 1) ? t : nullptr;
+            }
+
+          private:
+            alignas(__fst::cache_line_size) __fst::atomic<int64_t> _top;
+            alignas(__fst::cache_line_size) __fst::atomic<int64_t> _bottom;
+            alignas(__fst::cache_line_size) __fst::atomic<task*> _buffer[capacity];
+        };
+
+        /// Fifo of the tasks submitted from outside the pool.
+        class injection_queue
+        {
+          public:
+            inline void push(task* t) noexcept
+            {
+                t->next = nullptr;
+
+                _lock.lock();
+                if (_tail) { _tail->next = t; }
+                else { _head.store(t); }
+                _tail = t;
+                _lock.unlock();
+            }
+
+            inline task* pop() noexcept
+            {
+                // Don't touch the lock when it's obviously empty.
+                if (!_head.load()) { return nullptr; }
+
+                _lock.lock();
+                task* t = _head.load();
+                if (t)
+                {
+                    _head.store(t->next);
+                    if (!t->next) { _tail = nullptr; }
+                }
+                _lock.unlock();
+                return t;
+            }
+
+          private:
+            __fst::adaptive_mutex _lock;
+            __fst::atomic<task*> _head;
+            task* _tail = nullptr;
+        };
+
+        constexpr uint32_t spin_rounds = 10;
+        constexpr uint32_t yield_rounds = 64;
+
+        /// Spin with exponential backoff, then yield and finally sleep.
+        /// Workers and wait() park on a futex instead of sleeping once they reach yield_rounds.
+        inline void idle(uint32_t round) noexcept
+        {
+            if (round < spin_rounds)
+            {
+                for (uint32_t i = 0; i < (1u << round); i++)
+                {
+                    FST_NOP();
+                }
+            }
+            else if (round < yield_rounds) { __fst::async::this_thread::yield(); }
+            else { __fst::async::this_thread::sleep_for_us(100); }
+        }
+
+        FST_ALWAYS_INLINE uint32_t xorshift(uint32_t& state) noexcept
+        {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return state;
+        }
+    } // namespace
+
+    struct thread_pool::native
+    {
+        struct worker
+        {
+            work_stealing_deque deque;
+            __fst::unique_ptr<__fst::async::thread, __fst::async_memory_category> thread;
+            native* pool;
+            size_t index;
+        };
+
+        inline native(size_t thread_count, bool pin_workers) noexcept
+            : _worker_count(thread_count ? thread_count : 1)
+        {
+            _workers = (worker*) __fst::default_memory_zone::aligned_allocate(
+                sizeof(worker) * _worker_count, __fst::maximum(alignof(worker), __fst::cache_line_size), __fst::async_memory_category::id());
+            fst_assert(_workers, "allocation failed");
+
+            // All the deques must exist before any worker starts stealing.
+            for (size_t i = 0; i < _worker_count; i++)
+            {
+                worker* w = fst_placement_new(_workers + i) worker();
+                w->pool = this;
+                w->index = i;
+            }
+
+            const size_t cpu_count = __fst::async::thread::hardware_concurrency();
+
+            for (size_t i = 0; i < _worker_count; i++)
+            {
+                worker* w = _workers + i;
+                w->thread = __fst::unique_ptr<__fst::async::thread, __fst::async_memory_category>::make([w]() { w->pool->run(*w); });
+
+                char name[16];
+                __fst::snprintf(name, sizeof(name), "fst_worker_%zu", i);
+                (void) w->thread->set_name(name);
+
+                if (pin_workers && !w->thread->pin_to_cpu(i % cpu_count))
+                {
+                    fst_warning("thread_pool worker pinning failed");
+                }
+            }
+        }
+
+        inline ~native() noexcept
+        {
+            join();
+
+            for (size_t i = 0; i < _worker_count; i++)
+            {
+                _workers[i].~worker();
+            }
+
+            __fst::default_memory_zone::aligned_deallocate(_workers, __fst::async_memory_category::id());
+        }
+
+        inline void join() noexcept
+        {
+            if (_stop.load()) { return; }
+
+            wait();
+            _stop.store(true);
+            ++_wake_epoch;
+            _wake_epoch.notify_all();
+
+            for (size_t i = 0; i < _worker_count; i++)
+            {
+                _workers[i].thread.reset();
+            }
+        }
+
+        inline void submit(task* t) noexcept
+        {
+            fst_assert(!_stop.load(), "can't submit to a joined thread_pool");
+
+            _pending.fetch_add(1);
+
+            if (const size_t index = worker_index(); index != npos)
+            {
+                // Deque is full, run it right away.
+                if (!_workers[index].deque.push(t)) { complete(t); }
+                else { wake_one(); }
+                return;
+            }
+
+            _injection.push(t);
+            wake_one();
+        }
+
+        inline void wait() noexcept
+        {
+            fst_assert(worker_index() == npos, "thread_pool::wait can't be called from one of its tasks");
+
+            uint32_t round = 0;
+            while (_pending.load() != 0)
+            {
+                if (help()) { round = 0; }
+                else if (round < yield_rounds) { idle(round++); }
+                else
+                {
+                    // Only the last completed task notifies.
+                    ++_pending_waiters;
+                    if (const size_t pending = _pending.load()) { _pending.wait(pending); }
+                    --_pending_waiters;
+                    round = 0;
+                }
+            }
+        }
+
+        inline void wait(const task* t) noexcept
+        {
+            uint32_t round = 0;
+            while (!t->done.load())
+            {
+                if (help()) { round = 0; }
+                else { idle(round++); }
+            }
+        }
+
+        FST_NODISCARD FST_ALWAYS_INLINE size_t worker_index() const noexcept { return _current_pool == this ? _current_index : npos; }
+
+        FST_NODISCARD FST_ALWAYS_INLINE size_t size() const noexcept { return _worker_count; }
+
+      private:
+        worker* _workers;
+        size_t _worker_count;
+        injection_queue _injection;
+        alignas(__fst::cache_line_size) __fst::atomic<size_t> _pending;
+        __fst::atomic<uint32_t> _pending_waiters;
+        alignas(__fst::cache_line_size) __fst::atomic<uint32_t> _wake_epoch;
+        __fst::atomic<uint32_t> _sleepers;
+        alignas(__fst::cache_line_size) __fst::atomic<bool> _stop = false;
+
+        static thread_local native* _current_pool;
+        static thread_local size_t _current_index;
+        static thread_local uint32_t _random_state;
+
+        inline void run(worker& w) noexcept
+        {
+            _current_pool = this;
+            _current_index = w.index;
+            _random_state = (uint32_t) (w.index * 2654435761u) | 1u;
+
+            uint32_t round = 0;
+            while (!_stop.load())
+            {
+                if (help()) { round = 0; }
+                else if (round < yield_rounds) { idle(round++); }
+                else
+                {
+                    park();
+                    round = 0;
+                }
+            }
+
+            _current_pool = nullptr;
+            _current_index = npos;
+        }
+
+        /// Puts an idle worker to sleep until a task is submitted or the pool is joined.
+        inline void park() noexcept
+        {
+            // Registering before looking one last time guarantees that a concurrent
+            // submit either gets seen here or sees this sleeper and bumps the epoch.
+            ++_sleepers;
+            const uint32_t epoch = _wake_epoch.load();
+
+            if (!help() && !_stop.load()) { _wake_epoch.wait(epoch); }
+
+            --_sleepers;
+        }
+
+        FST_ALWAYS_INLINE void wake_one() noexcept
+        {
+            // No syscall while every worker is busy.
+            if (_sleepers.load() == 0) { return; }
+
+            ++_wake_epoch;
+            _wake_epoch.notify_one();
+        }
+
+        /// Runs one task if one can be found.
+        inline bool help() noexcept
+        {
+            if (task* t = find_task())
+            {
+                complete(t);
+                return true;
+            }
+
+            return false;
+        }
+
+        FST_ALWAYS_INLINE void complete(task* t) noexcept
+        {
+            execute_task(t);
+
+            if (_pending.fetch_sub(1) == 1 && _pending_waiters.load() != 0) { _pending.notify_all(); }
+        }
+
+        inline task* find_task() noexcept
+        {
+            const size_t index = worker_index();
+
+            if (index != npos)
+            {
+                if (task* t = _workers[index].deque.pop()) { return t; }
+            }
+
+            if (task* t = _injection.pop()) { return t; }
+
+            // Steal from a random victim first, then from the others in order.
+            if (_random_state == 0) { _random_state = (uint32_t) (uintptr_t) &index | 1u; }
+
+            const size_t start = xorshift(_random_state) % _worker_count;
+            for (size_t i = 0; i < _worker_count; i++)
+            {
+                const size_t victim = (start + i) % _worker_count;
+                if (victim == index) { continue; }
+
+                if (task* t = _workers[victim].deque.steal()) { return t; }
+            }
+
+            return nullptr;
+        }
+    };
+
+    thread_local thread_pool::native* thread_pool::native::_current_pool = nullptr;
+    thread_local size_t thread_pool::native::_current_index = thread_pool::npos;
+    thread_local uint32_t thread_pool::native::_random_state = 0;
+
+    //
+    // thread_pool::task_handle
+    //
+    thread_pool::task_handle::task_handle(const task_handle& other) noexcept
+        : _task(other._task)
+    {
+        if (_task) { ++_task->refcount; }
+    }
+
+    thread_pool::task_handle::task_handle(task_handle && other) noexcept
+        : _task(__fst::exchange(other._task, nullptr))
+    {}
+
+    thread_pool::task_handle::~task_handle() noexcept
+    {
+        if (_task) { release_task(_task); }
+    }
+
+    thread_pool::task_handle& thread_pool::task_handle::operator=(const task_handle& other) noexcept
+    {
+        if (_task == other._task) { return *this; }
+
+        if (other._task) { ++other._task->refcount; }
+        if (_task) { release_task(_task); }
+
+        _task = other._task;
+        return *this;
+    }
+
+    thread_pool::task_handle& thread_pool::task_handle::operator=(task_handle&& other) noexcept
+    {
+        if (this == &other) { return *this; }
+
+        if (_task) { release_task(_task); }
+        _task = __fst::exchange(other._task, nullptr);
+        return *this;
+    }
+
+    bool thread_pool::task_handle::is_done() const noexcept
+    {
+        return _task && _task->done.load();
+    }
+
+    //
+    // thread_pool
+    //
+    thread_pool::thread_pool() noexcept
+        : thread_pool(__fst::async::thread::hardware_concurrency())
+    {}
+
+    thread_pool::thread_pool(size_t thread_count) noexcept
+        : _native(native_pointer::make(thread_count, false))
+    {}
+
+    thread_pool::thread_pool(size_t thread_count, bool pin_workers) noexcept
+        : _native(native_pointer::make(thread_count, pin_workers))
+    {}
+
+    thread_pool::~thread_pool() noexcept
+    {
+        join();
+    }
+
+    thread_pool::task_handle thread_pool::submit(task_data tdata) noexcept
+    {
+        fst_assert(tdata.process, "task process callback cannot be null");
+
+        // One reference for the pool and one for the handle.
+        task* t = create_task(tdata, 2);
+        _native->submit(t);
+        return task_handle(t);
+    }
+
+    void thread_pool::wait() noexcept
+    {
+        _native->wait();
+    }
+
+    void thread_pool::wait(const task_handle& handle) noexcept
+    {
+        if (handle._task) { _native->wait(handle._task); }
+    }
+
+    void thread_pool::join() noexcept
+    {
+        _native->join();
+    }
+
+    size_t thread_pool::size() const noexcept
+    {
+        return _native->size();
+    }
+
+    size_t thread_pool::current_worker_index() const noexcept
+    {
+        return _native->worker_index();
+    }
+
+FST_END_SUB_NAMESPACE
@@ -0,0 +1,244 @@
+#include "fst/atomic.h"
+
+#if __FST_WINDOWS__
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#pragma comment(lib, "Synchronization.lib")
+
+#elif __FST_LINUX__ || __FST_ANDROID__
+#define __FST_ATOMIC_FUTEX__ 1
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <errno.h>
+#include <limits.h>
+#include <time.h>
+
+#else
+#include <pthread.h>
+#include <errno.h>
+#include <time.h>
+#endif // __FST_WINDOWS__
+
+#ifndef __FST_ATOMIC_FUTEX__
+#define __FST_ATOMIC_FUTEX__ 0
+#endif
+
+FST_BEGIN_NAMESPACE
+
+    namespace
+    {
+        template <class T>
+        FST_ALWAYS_INLINE uint64_t load_as(const volatile void* address) noexcept
+        {
+#if __FST_MSVC__
+            return *(const volatile T*) address;
+#else
+            return __atomic_load_n((const volatile T*) address, __ATOMIC_SEQ_CST);
+#endif
+        }
+
+        FST_ALWAYS_INLINE uint64_t load_value(const volatile void* address, size_t size) noexcept
+        {
+            switch (size)
+            {
+            case 1: return load_as<uint8_t>(address);
+            case 2: return load_as<uint16_t>(address);
+            case 4: return load_as<uint32_t>(address);
+            default: return load_as<uint64_t>(address);
+            }
+        }
+
+        FST_ALWAYS_INLINE bool is_equal(const volatile void* address, const void* expected, size_t size) noexcept
+        {
+            return load_value(address, size) == load_value(expected, size);
+        }
+    } // namespace
+
+#if __FST_WINDOWS__
+    namespace detail
+    {
+        void atomic_wait(const volatile void* address, const void* expected, size_t size) noexcept
+        {
+            ::WaitOnAddress(const_cast<volatile void*>(address), const_cast<void*>(expected), size, INFINITE);
+        }
+
+        bool atomic_wait_for_us(const volatile void* address, const void* expected, size_t size, uint64_t timeout_us) noexcept
+        {
+            const ULONGLONG deadline = ::GetTickCount64() + (timeout_us + 999) / 1000;
+
+            for (;;)
+            {
+                if (!is_equal(address, expected, size)) { return true; }
+
+                const ULONGLONG now = ::GetTickCount64();
+                if (now >= deadline) { return false; }
+
+                ::WaitOnAddress(const_cast<volatile void*>(address), const_cast<void*>(expected), size, (DWORD) (deadline - now));
+            }
+        }
+
+        void atomic_notify_one(const volatile void* address, size_t) noexcept { ::WakeByAddressSingle(const_cast<void*>(address)); }
+
+        void atomic_notify_all(const volatile void* address, size_t) noexcept { ::WakeByAddressAll(const_cast<void*>(address)); }
+    } // namespace detail
+
+#else
+    namespace
+    {
+        constexpr size_t wait_bucket_count = 16;
+
+        // Waiters are tracked per bucket so that a notify without any waiter never makes a syscall.
+        // The futex can only wait on 32-bit words, other sizes wait on the bucket version instead.
+        // Without futex, every bucket has its own mutex and condition variable.
+        struct alignas(__fst::cache_line_size) wait_bucket
+        {
+            __fst::atomic<uint32_t> waiters;
+            __fst::atomic<uint32_t> version;
+
+#if !__FST_ATOMIC_FUTEX__
+            ::pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+            ::pthread_cond_t cond = PTHREAD_COND_INITIALIZER;
+#endif
+        };
+
+        wait_bucket wait_buckets[wait_bucket_count];
+
+        FST_ALWAYS_INLINE wait_bucket& get_wait_bucket(const volatile void* address) noexcept
+        {
+            const uintptr_t key = (uintptr_t) address >> 2;
+            return wait_buckets[(key ^ (key >> 4) ^ (key >> 8)) % wait_bucket_count];
+        }
+
+        FST_ALWAYS_INLINE ::timespec to_timespec(uint64_t us) noexcept
+        {
+            return ::timespec{ (time_t) (us / 1000000), (long) ((us % 1000000) * 1000) };
+        }
+
+        FST_ALWAYS_INLINE uint64_t monotonic_now_us() noexcept
+        {
+            ::timespec ts;
+            ::clock_gettime(CLOCK_MONOTONIC, &ts);
+            return (uint64_t) ts.tv_sec * 1000000 + (uint64_t) ts.tv_nsec / 1000;
+        }
+
+#if __FST_ATOMIC_FUTEX__
+        FST_ALWAYS_INLINE void futex_wait(const volatile void* address, uint32_t expected, const ::timespec* timeout) noexcept
+        {
+            ::syscall(SYS_futex, address, FUTEX_WAIT_PRIVATE, expected, timeout, nullptr, 0);
+        }
+
+        FST_ALWAYS_INLINE void futex_wake(const volatile void* address, int count) noexcept
+        {
+            ::syscall(SYS_futex, address, FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+        }
+
+        // Returns after a notify, a timeout, a signal or right away if the value already changed.
+        inline void wait_on_address(const volatile void* address, const void* expected, size_t size, const ::timespec* timeout) noexcept
+        {
+            wait_bucket& b = get_wait_bucket(address);
+            ++b.waiters;
+
+            if (size == sizeof(uint32_t))
+            {
+                // The kernel checks the value atomically.
+                futex_wait(address, (uint32_t) load_value(expected, size), timeout);
+            }
+            else
+            {
+                const uint32_t version = b.version.load();
+                if (is_equal(address, expected, size)) { futex_wait(&b.version, version, timeout); }
+            }
+
+            --b.waiters;
+        }
+
+        inline void notify_address(const volatile void* address, size_t size, bool all) noexcept
+        {
+            wait_bucket& b = get_wait_bucket(address);
+            if (b.waiters.load() == 0) { return; }
+
+            if (size == sizeof(uint32_t))
+            {
+                futex_wake(address, all ? INT_MAX : 1);
+                return;
+            }
+
+            // The bucket is shared, everyone has to check its own value.
+            ++b.version;
+            futex_wake(&b.version, INT_MAX);
+        }
+
+#else
+        inline void wait_on_address(const volatile void* address, const void* expected, size_t size, const ::timespec* timeout) noexcept
+        {
+            wait_bucket& b = get_wait_bucket(address);
+            ++b.waiters;
+
+            ::pthread_mutex_lock(&b.mutex);
+            if (is_equal(address, expected, size))
+            {
+                if (timeout)
+                {
+                    ::timespec abs_time;
+                    ::clock_gettime(CLOCK_REALTIME, &abs_time);
+                    abs_time.tv_sec += timeout->tv_sec;
+                    abs_time.tv_nsec += timeout->tv_nsec;
+                    if (abs_time.tv_nsec >= 1000000000)
+                    {
+                        abs_time.tv_sec++;
+                        abs_time.tv_nsec -= 1000000000;
+                    }
+
+                    ::pthread_cond_timedwait(&b.cond, &b.mutex, &abs_time);
+                }
+                else { ::pthread_cond_wait(&b.cond, &b.mutex); }
+            }
+            ::pthread_mutex_unlock(&b.mutex);
+
+            --b.waiters;
+        }
+
+        inline void notify_address(const volatile void* address, size_t, bool) noexcept
+        {
+            wait_bucket& b = get_wait_bucket(address);
+            if (b.waiters.load() == 0) { return; }
+
+            // Taking the lock guarantees that a waiter is either sleeping or will see the new value.
+            ::pthread_mutex_lock(&b.mutex);
+            ::pthread_mutex_unlock(&b.mutex);
+            ::pthread_cond_broadcast(&b.cond);
+        }
+#endif // __FST_ATOMIC_FUTEX__
+    } // namespace
+
+    namespace detail
+    {
+        void atomic_wait(const volatile void* address, const void* expected, size_t size) noexcept
+        {
+            wait_on_address(address, expected, size, nullptr);
+        }
+
+        bool atomic_wait_for_us(const volatile void* address, const void* expected, size_t size, uint64_t timeout_us) noexcept
+        {
+            const uint64_t deadline = monotonic_now_us() + timeout_us;
+
+            for (;;)
+            {
+                if (!is_equal(address, expected, size)) { return true; }
+
+                const uint64_t now = monotonic_now_us();
+                if (now >= deadline) { return false; }
+
+                const ::timespec timeout = to_timespec(deadline - now);
+                wait_on_address(address, expected, size, &timeout);
+            }
+        }
+
+        void atomic_notify_one(const volatile void* address, size_t size) noexcept { notify_address(address, size, false); }
+
+        void atomic_notify_all(const volatile void* address, size_t size) noexcept { notify_address(address, size, true); }
+    } // namespace detail
+#endif // __FST_WINDOWS__
+
+FST_END_NAMESPACE
@@ -1,10 +1,33 @@
+#if !defined(_GNU_SOURCE) && !defined(_WIN32)
+#define _GNU_SOURCE
+#endif
+
 #include "fst/memory.h"
 #include "fst/profiler.h"
 #include "fst/simd.h"
 #include "fst/memory_pool.h"
+#include "fst/atomic.h"
+#include "fst/mutex.h"
 
+#include <stddef.h>
+#include <stdlib.h>
 #include <string.h>
 
+#if __FST_WINDOWS__
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#endif // __FST_WINDOWS__
+
+#if __FST_LINUX__ || __FST_ANDROID__
+#include <malloc.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif __FST_MACOS__ || __FST_IOS__
+#include <malloc/malloc.h>
+#endif
+
 //#include "smmalloc.h"
 
 // https://developers.redhat.com/articles/2022/12/06/implementing-c20-atomic-waiting-libstdc#putting_together_the_pieces_for_a_notify_primitive
@@ -32,8 +55,9 @@ FST_BEGIN_NAMESPACE
         //
         memory_category_id category_base::restricted_base::get_next_memory_category_id() noexcept
         {
-            FST_GLOBAL_SECTION static __fst::memory_category_id __id = (__fst::memory_category_id) 0;
-            return __id++;
+            // Ids are handed out from the first call to id() of each category, which can happen on any thread.
+            FST_GLOBAL_SECTION static __fst::atomic<uint64_t> _id;
+            return (__fst::memory_category_id) _id.fetch_add(1);
         }
 
 #if FST_USE_PROFILER
@@ -48,8 +72,8 @@ FST_BEGIN_NAMESPACE
         //
         memory_zone_id zone_base::restricted_base::get_next_memory_zone_id() noexcept
         {
-            FST_GLOBAL_SECTION static __fst::memory_zone_id _id = (__fst::memory_zone_id) 0;
-            return _id++;
+            FST_GLOBAL_SECTION static __fst::atomic<uint64_t> _id;
+            return (__fst::memory_zone_id) _id.fetch_add(1);
         }
 
 #if FST_USE_PROFILER
@@ -121,6 +145,56 @@ FST_BEGIN_NAMESPACE
         __fst_aligned_dealloc(ptr);
     }
 
+    void* default_memory_zone::reallocate(
+        void* ptr, FST_ATTRIBUTE_UNUSED size_t size, size_t new_size, size_t alignment, FST_ATTRIBUTE_UNUSED __fst::memory_category_id mid) noexcept
+    {
+        // The old block has to leave the profiler before realloc releases it,
+        // another thread could get the same address back right away.
+        FST_IF_PROFILE(if (ptr) { __fst::profiler::deallocated(ptr, id(), mid); });
+
+#if __FST_WINDOWS__
+        void* new_ptr = ::_aligned_realloc(ptr, new_size, alignment);
+#else
+        void* new_ptr = nullptr;
+
+        if (alignment <= alignof(::max_align_t)) { new_ptr = ::realloc(ptr, new_size); }
+        else if ((new_ptr = __fst_aligned_alloc(new_size, alignment)) && ptr)
+        {
+            // realloc only guarantees the malloc alignment.
+            ::memcpy(new_ptr, ptr, size < new_size ? size : new_size);
+            ::free(ptr);
+        }
+#endif // __FST_WINDOWS__
+
+        if (!new_ptr)
+        {
+            FST_IF_PROFILE(if (ptr) { __fst::profiler::allocated(ptr, size, id(), mid); });
+            return nullptr;
+        }
+
+        FST_IF_PROFILE(__fst::profiler::allocated(new_ptr, new_size, id(), mid));
+        return new_ptr;
+    }
+
+    bool default_memory_zone::try_expand(FST_ATTRIBUTE_UNUSED void* ptr, FST_ATTRIBUTE_UNUSED size_t new_size, FST_ATTRIBUTE_UNUSED __fst::memory_category_id mid) noexcept
+    {
+#if __FST_LINUX__ || __FST_ANDROID__
+        const bool expanded = ptr && ::malloc_usable_size(ptr) >= new_size;
+#elif __FST_MACOS__ || __FST_IOS__
+        const bool expanded = ptr && ::malloc_size(ptr) >= new_size;
+#else
+        const bool expanded = false;
+#endif
+
+        if (expanded)
+        {
+            FST_IF_PROFILE(__fst::profiler::deallocated(ptr, id(), mid));
+            FST_IF_PROFILE(__fst::profiler::allocated(ptr, new_size, id(), mid));
+        }
+
+        return expanded;
+    }
+
     //
     // simd_memory_zone
     //
@@ -289,4 +363,672 @@ FST_BEGIN_NAMESPACE
         _pool->_allocator.aligned_deallocate(ptr);
     }
 
+    //
+    // size_class_memory_zone
+    //
+    namespace
+    {
+        constexpr size_t os_page_size = 4096;
+
+        /// Maps size bytes of zeroed memory from the os, aligned to alignment (a multiple of the page size).
+        inline void* os_map_aligned(size_t size, size_t alignment) noexcept
+        {
+#if __FST_WINDOWS__
+            // Find an aligned address in a bigger reservation and map it again,
+            // another thread can take it in between so try a few times.
+            for (int i = 0; i < 8; i++)
+            {
+                void* ptr = ::VirtualAlloc(nullptr, size + alignment, MEM_RESERVE, PAGE_NOACCESS);
+                if (!ptr) { return nullptr; }
+
+                ::VirtualFree(ptr, 0, MEM_RELEASE);
+
+                if (void* aligned_ptr = ::VirtualAlloc(__fst::align(ptr, alignment), size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE)) { return aligned_ptr; }
+            }
+
+            return nullptr;
+#else
+            const size_t total_size = size + alignment;
+            void* ptr = ::mmap(nullptr, total_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (ptr == MAP_FAILED) { return nullptr; }
+
+            // Give back the unaligned head and the unused tail.
+            uint8_t* base = (uint8_t*) ptr;
+            uint8_t* aligned_ptr = (uint8_t*) __fst::align(ptr, alignment);
+
+            if (aligned_ptr != base) { ::munmap(base, (size_t) (aligned_ptr - base)); }
+            if (const size_t tail_size = (size_t) ((base + total_size) - (aligned_ptr + size))) { ::munmap(aligned_ptr + size, tail_size); }
+
+            return aligned_ptr;
+#endif // __FST_WINDOWS__
+        }
+
+        inline void os_unmap(void* ptr, FST_ATTRIBUTE_UNUSED size_t size) noexcept
+        {
+#if __FST_WINDOWS__
+            ::VirtualFree(ptr, 0, MEM_RELEASE);
+#else
+            ::munmap(ptr, size);
+#endif // __FST_WINDOWS__
+        }
+
+        FST_ALWAYS_INLINE size_t floor_log2(size_t value) noexcept
+        {
+#if __FST_MSVC__
+            unsigned long index;
+            _BitScanReverse64(&index, (unsigned __int64) value);
+            return (size_t) index;
+#else
+            return (size_t) (63 - __builtin_clzll((unsigned long long) value));
+#endif
+        }
+
+        // 16, 32, 48, 64 and then four classes per power of two up to 64 KiB.
+        // All the sizes are multiples of 16 and powers of two are size classes.
+        FST_ALWAYS_INLINE size_t size_class_index(size_t size) noexcept
+        {
+            if (size <= 64) { return size ? (size - 1) >> 4 : 0; }
+
+            const size_t k = floor_log2(size - 1);
+            return 4 + (k - 6) * 4 + ((size - 1 - ((size_t) 1 << k)) >> (k - 2));
+        }
+
+        FST_ALWAYS_INLINE constexpr size_t size_class_size(size_t index) noexcept
+        {
+            if (index < 4) { return (index + 1) * 16; }
+
+            const size_t k = 6 + (index - 4) / 4;
+            return ((size_t) 1 << k) + ((index - 4) % 4 + 1) * ((size_t) 1 << (k - 2));
+        }
+
+        static_assert(size_class_size(__fst::size_class_memory_zone::size_class_count - 1) == __fst::size_class_memory_zone::maximum_size, "invalid size classes");
+
+        /// Lives at the beginning of every slab and of every large mapping.
+        /// Slabs are aligned on slab_size, the header of any pointer is found by masking.
+        struct slab_header
+        {
+            slab_header* next;
+            slab_header* prev;
+            void* free_list;
+            size_t map_size;
+            uint32_t class_index;
+            uint32_t used;
+            uint32_t capacity;
+            uint32_t bump;
+        };
+
+        constexpr uint32_t large_class_index = (__fst::numeric_limits<uint32_t>::max)();
+
+        // Keeps the page alignment for the power of two size classes.
+        constexpr size_t slab_data_offset = os_page_size;
+        static_assert(sizeof(slab_header) <= slab_data_offset, "slab header too big");
+
+        struct alignas(__fst::cache_line_size) size_class
+        {
+            __fst::adaptive_mutex lock;
+
+            // Slabs with at least one free slot.
+            slab_header* partial = nullptr;
+
+            // One empty slab is kept around to avoid mapping and unmapping on every round trip.
+            slab_header* empty = nullptr;
+        };
+
+        struct size_class_heap
+        {
+            size_class classes[__fst::size_class_memory_zone::size_class_count];
+            __fst::atomic<size_t> slab_count;
+        };
+
+        inline size_class_heap& get_size_class_heap() noexcept
+        {
+            static size_class_heap heap;
+            return heap;
+        }
+
+        FST_ALWAYS_INLINE slab_header* get_slab(void* ptr) noexcept
+        {
+            return (slab_header*) ((uintptr_t) ptr & ~(uintptr_t) (__fst::size_class_memory_zone::slab_size - 1));
+        }
+
+        FST_ALWAYS_INLINE void push_slab(size_class& sc, slab_header* s) noexcept
+        {
+            s->prev = nullptr;
+            s->next = sc.partial;
+            if (sc.partial) { sc.partial->prev = s; }
+            sc.partial = s;
+        }
+
+        FST_ALWAYS_INLINE void remove_slab(size_class& sc, slab_header* s) noexcept
+        {
+            if (s->prev) { s->prev->next = s->next; }
+            else { sc.partial = s->next; }
+
+            if (s->next) { s->next->prev = s->prev; }
+            s->next = s->prev = nullptr;
+        }
+
+        FST_ALWAYS_INLINE void reset_slab(slab_header* s) noexcept
+        {
+            s->free_list = nullptr;
+            s->used = 0;
+            s->bump = 0;
+        }
+
+        inline slab_header* create_slab(size_class_heap& heap, uint32_t class_index) noexcept
+        {
+            slab_header* s = (slab_header*) os_map_aligned(__fst::size_class_memory_zone::slab_size, __fst::size_class_memory_zone::slab_size);
+            if (!s) { return nullptr; }
+
+            s->next = s->prev = nullptr;
+            s->map_size = __fst::size_class_memory_zone::slab_size;
+            s->class_index = class_index;
+            s->capacity = (uint32_t) ((__fst::size_class_memory_zone::slab_size - slab_data_offset) / size_class_size(class_index));
+            reset_slab(s);
+
+            ++heap.slab_count;
+            return s;
+        }
+
+        inline void release_slab(size_class_heap& heap, slab_header* s) noexcept
+        {
+            --heap.slab_count;
+            os_unmap(s, s->map_size);
+        }
+
+        inline void* allocate_from_class(size_t class_index) noexcept
+        {
+            size_class_heap& heap = get_size_class_heap();
+            size_class& sc = heap.classes[class_index];
+
+            sc.lock.lock();
+
+            slab_header* s = sc.partial;
+            if (!s)
+            {
+                s = sc.empty ? __fst::exchange(sc.empty, nullptr) : create_slab(heap, (uint32_t) class_index);
+                if (!s)
+                {
+                    sc.lock.unlock();
+                    return nullptr;
+                }
+
+                push_slab(sc, s);
+            }
+
+            void* ptr;
+            if (s->free_list)
+            {
+                ptr = s->free_list;
+                s->free_list = *(void**) ptr;
+            }
+            else
+            {
+                // Never used slots are handed out in order, untouched pages are never committed.
+                ptr = (uint8_t*) s + slab_data_offset + (size_t) s->bump++ * size_class_size(class_index);
+            }
+
+            if (++s->used == s->capacity) { remove_slab(sc, s); }
+
+            sc.lock.unlock();
+            return ptr;
+        }
+
+        inline void deallocate_to_class(slab_header* s, void* ptr) noexcept
+        {
+            size_class_heap& heap = get_size_class_heap();
+            size_class& sc = heap.classes[s->class_index];
+            slab_header* released = nullptr;
+
+            sc.lock.lock();
+
+            *(void**) ptr = s->free_list;
+            s->free_list = ptr;
+
+            // It was full and not in the partial list anymore.
+            if (s->used-- == s->capacity) { push_slab(sc, s); }
+
+            if (s->used == 0)
+            {
+                remove_slab(sc, s);
+
+                if (sc.empty) { released = s; }
+                else
+                {
+                    reset_slab(s);
+                    sc.empty = s;
+                }
+            }
+
+            sc.lock.unlock();
+
+            if (released) { release_slab(heap, released); }
+        }
+
+        inline void* allocate_large(size_t size, size_t alignment) noexcept
+        {
+            fst_assert(alignment <= __fst::size_class_memory_zone::slab_size / 2, "alignment too big");
+
+            const size_t offset = __fst::maximum(slab_data_offset, alignment);
+            const size_t map_size = __fst::align(offset + size, os_page_size);
+
+            slab_header* s = (slab_header*) os_map_aligned(map_size, __fst::size_class_memory_zone::slab_size);
+            if (!s) { return nullptr; }
+
+            s->next = s->prev = nullptr;
+            s->free_list = nullptr;
+            s->map_size = map_size;
+            s->class_index = large_class_index;
+            s->used = 1;
+            s->capacity = 1;
+            s->bump = 0;
+
+            return (uint8_t*) s + offset;
+        }
+    } // namespace
+
+    void* size_class_memory_zone::allocate(size_t size, __fst::memory_category_id mid) noexcept
+    {
+        return size_class_memory_zone::aligned_allocate(size, minimum_size, mid);
+    }
+
+    void size_class_memory_zone::deallocate(void* ptr, __fst::memory_category_id mid) noexcept
+    {
+        size_class_memory_zone::aligned_deallocate(ptr, mid);
+    }
+
+    void* size_class_memory_zone::aligned_allocate(size_t size, size_t alignment, FST_ATTRIBUTE_UNUSED __fst::memory_category_id mid) noexcept
+    {
+        fst_assert(__fst::is_power_of_two(alignment), "alignment must be a power of two");
+
+        // Power of two size classes are aligned on their size (up to the page size).
+        size_t class_size = alignment > minimum_size ? __fst::round_to_power_of_two(__fst::maximum(size, alignment)) : size;
+
+        void* ptr = (class_size > maximum_size || alignment > os_page_size) ? allocate_large(size, alignment) : allocate_from_class(size_class_index(class_size));
+        FST_IF_PROFILE(__fst::profiler::allocated(ptr, size, id(), mid));
+        return ptr;
+    }
+
+    void size_class_memory_zone::aligned_deallocate(void* ptr, FST_ATTRIBUTE_UNUSED __fst::memory_category_id mid) noexcept
+    {
+        if (!ptr) { return; }
+
+        FST_IF_PROFILE(__fst::profiler::deallocated(ptr, id(), mid));
+
+        slab_header* s = get_slab(ptr);
+        if (s->class_index == large_class_index)
+        {
+            os_unmap(s, s->map_size);
+            return;
+        }
+
+        deallocate_to_class(s, ptr);
+    }
+
+    void* size_class_memory_zone::reallocate(void* ptr, size_t size, size_t new_size, size_t alignment, __fst::memory_category_id mid) noexcept
+    {
+        if (!ptr) { return size_class_memory_zone::aligned_allocate(new_size, alignment, mid); }
+
+        // The block was allocated with the same alignment, staying in place keeps it.
+        if (size_class_memory_zone::try_expand(ptr, new_size, mid)) { return ptr; }
+
+        void* new_ptr = size_class_memory_zone::aligned_allocate(new_size, alignment, mid);
+        if (!new_ptr) { return nullptr; }
+
+        ::memcpy(new_ptr, ptr, size < new_size ? size : new_size);
+        size_class_memory_zone::aligned_deallocate(ptr, mid);
+        return new_ptr;
+    }
+
+    bool size_class_memory_zone::try_expand(void* ptr, size_t new_size, FST_ATTRIBUTE_UNUSED __fst::memory_category_id mid) noexcept
+    {
+        if (!ptr) { return false; }
+
+        slab_header* s = get_slab(ptr);
+        if (s->class_index != large_class_index)
+        {
+            if (new_size > size_class_size(s->class_index)) { return false; }
+        }
+        else if (const size_t offset = (size_t) ((uint8_t*) ptr - (uint8_t*) s); offset + new_size > s->map_size)
+        {
+#if __FST_LINUX__ || __FST_ANDROID__
+            // Without MREMAP_MAYMOVE, the mapping only grows if the pages after it are free.
+            // Moving it could break the slab alignment used to find the header.
+            const size_t map_size = __fst::align(offset + new_size, os_page_size);
+            if (::mremap(s, s->map_size, map_size, 0) == MAP_FAILED) { return false; }
+            s->map_size = map_size;
+#else
+            return false;
+#endif
+        }
+
+        FST_IF_PROFILE(__fst::profiler::deallocated(ptr, id(), mid));
+        FST_IF_PROFILE(__fst::profiler::allocated(ptr, new_size, id(), mid));
+        return true;
+    }
+
+    size_t size_class_memory_zone::allocation_size(size_t size) noexcept
+    {
+        return size > maximum_size ? __fst::align(size, os_page_size) : size_class_size(size_class_index(size));
+    }
+
+    size_t size_class_memory_zone::slab_count() noexcept
+    {
+        return get_size_class_heap().slab_count.load();
+    }
+
+    //
+    // large_page_memory_zone
+    //
+    namespace
+    {
+        // Stored right before the pointers the large_page_memory_zone takes from the simd_memory_zone.
+        struct large_page_header
+        {
+            void* base;
+        };
+
+        thread_local int large_page_numa_node = -1;
+
+        FST_ALWAYS_INLINE large_page_header* get_large_page_header(const void* ptr) noexcept { return (large_page_header*) ptr - 1; }
+
+        // Large allocations start on their mapping and fill it, their sizes are kept here instead.
+        // Open addressing on the base address, the entries come straight from the os so the table
+        // never allocates from a memory zone and outlives every static destructor.
+        struct large_mapping
+        {
+            void* base;
+            size_t map_size;
+        };
+
+        struct large_mapping_table
+        {
+            __fst::adaptive_mutex lock;
+            large_mapping* entries = nullptr;
+            size_t capacity = 0;
+            size_t count = 0;
+        };
+
+        inline large_mapping_table& get_large_mapping_table() noexcept
+        {
+            static large_mapping_table table;
+            return table;
+        }
+
+        FST_ALWAYS_INLINE bool is_large_page_aligned(const void* ptr) noexcept
+        {
+            return ((uintptr_t) ptr & (__fst::large_page_memory_zone::large_page_size - 1)) == 0;
+        }
+
+        FST_ALWAYS_INLINE size_t large_mapping_slot(const void* base, size_t capacity) noexcept
+        {
+            // The low 21 bits are always zero.
+            return (size_t) ((((uint64_t) (uintptr_t) base >> 21) * 0x9E3779B97F4A7C15ull) >> 32) & (capacity - 1);
+        }
+
+        // The lock must be held.
+        inline size_t find_large_mapping(const large_mapping_table& t, const void* base) noexcept
+        {
+            if (!t.capacity) { return t.capacity; }
+
+            for (size_t i = large_mapping_slot(base, t.capacity); t.entries[i].base; i = (i + 1) & (t.capacity - 1))
+            {
+                if (t.entries[i].base == base) { return i; }
+            }
+
+            return t.capacity;
+        }
+
+        inline bool add_large_mapping(void* base, size_t map_size) noexcept
+        {
+            large_mapping_table& t = get_large_mapping_table();
+            t.lock.lock();
+
+            // Keeps the load under one half.
+            if (2 * (t.count + 1) > t.capacity)
+            {
+                const size_t capacity = t.capacity ? 2 * t.capacity : os_page_size / sizeof(large_mapping);
+                large_mapping* entries = (large_mapping*) os_map_aligned(capacity * sizeof(large_mapping), os_page_size);
+                if (!entries)
+                {
+                    t.lock.unlock();
+                    return false;
+                }
+
+                for (size_t i = 0; i < t.capacity; i++)
+                {
+                    if (!t.entries[i].base) { continue; }
+
+                    size_t j = large_mapping_slot(t.entries[i].base, capacity);
+                    while (entries[j].base) { j = (j + 1) & (capacity - 1); }
+                    entries[j] = t.entries[i];
+                }
+
+                if (t.entries) { os_unmap(t.entries, t.capacity * sizeof(large_mapping)); }
+                t.entries = entries;
+                t.capacity = capacity;
+            }
+
+            size_t i = large_mapping_slot(base, t.capacity);
+            while (t.entries[i].base) { i = (i + 1) & (t.capacity - 1); }
+            t.entries[i] = large_mapping{ base, map_size };
+            t.count++;
+
+            t.lock.unlock();
+            return true;
+        }
+
+        // Returns the size of the mapping at base, or zero if base isn't one.
+        inline size_t remove_large_mapping(const void* base) noexcept
+        {
+            large_mapping_table& t = get_large_mapping_table();
+            t.lock.lock();
+
+            size_t i = find_large_mapping(t, base);
+            if (i == t.capacity)
+            {
+                t.lock.unlock();
+                return 0;
+            }
+
+            const size_t map_size = t.entries[i].map_size;
+            const size_t mask = t.capacity - 1;
+
+            // Shifts the rest of the cluster back so that lookups never stop on the hole.
+            for (size_t j = (i + 1) & mask; t.entries[j].base; j = (j + 1) & mask)
+            {
+                const size_t home = large_mapping_slot(t.entries[j].base, t.capacity);
+                if (((j - home) & mask) >= ((j - i) & mask))
+                {
+                    t.entries[i] = t.entries[j];
+                    i = j;
+                }
+            }
+
+            t.entries[i] = large_mapping{ nullptr, 0 };
+            t.count--;
+
+            t.lock.unlock();
+            return map_size;
+        }
+
+        inline bool has_large_mapping(const void* base) noexcept
+        {
+            large_mapping_table& t = get_large_mapping_table();
+            t.lock.lock();
+            const bool found = find_large_mapping(t, base) != t.capacity;
+            t.lock.unlock();
+            return found;
+        }
+
+#if __FST_LINUX__ || __FST_ANDROID__
+        inline void bind_to_numa_node(void* ptr, size_t size, int node) noexcept
+        {
+            // MPOL_PREFERRED, the kernel falls back to other nodes instead of failing the page fault.
+            constexpr int mpol_preferred = 1;
+
+            if (node < 0 || node >= 64) { return; }
+
+            unsigned long mask = 1ul << node;
+
+            // Fails with ENOSYS without numa support, the memory is then left where the kernel puts it.
+            ::syscall(SYS_mbind, ptr, size, mpol_preferred, &mask, sizeof(mask) * 8 + 1, 0);
+        }
+#endif // __FST_LINUX__ || __FST_ANDROID__
+
+        inline void* map_large_pages(size_t size, FST_ATTRIBUTE_UNUSED int node) noexcept
+        {
+#if __FST_WINDOWS__
+            const DWORD type = MEM_RESERVE | MEM_COMMIT;
+            const SIZE_T large_page_minimum = ::GetLargePageMinimum();
+            void* ptr = nullptr;
+
+            // Large pages require the SeLockMemoryPrivilege, this fails without it.
+            if (large_page_minimum && size % large_page_minimum == 0)
+            {
+                ptr = node >= 0 ? ::VirtualAllocExNuma(::GetCurrentProcess(), nullptr, size, type | MEM_LARGE_PAGES, PAGE_READWRITE, (DWORD) node)
+                                : ::VirtualAlloc(nullptr, size, type | MEM_LARGE_PAGES, PAGE_READWRITE);
+            }
+
+            // Small pages, the mapping still starts on a large page boundary (see os_map_aligned).
+            for (int i = 0; !ptr && i < 8; i++)
+            {
+                void* reserved = ::VirtualAlloc(nullptr, size + __fst::large_page_memory_zone::large_page_size, MEM_RESERVE, PAGE_NOACCESS);
+                if (!reserved) { return nullptr; }
+
+                ::VirtualFree(reserved, 0, MEM_RELEASE);
+
+                void* aligned_ptr = __fst::align(reserved, __fst::large_page_memory_zone::large_page_size);
+                ptr = node >= 0 ? ::VirtualAllocExNuma(::GetCurrentProcess(), aligned_ptr, size, type, PAGE_READWRITE, (DWORD) node)
+                                : ::VirtualAlloc(aligned_ptr, size, type, PAGE_READWRITE);
+            }
+
+            return ptr;
+
+#elif __FST_LINUX__ || __FST_ANDROID__
+            void* ptr = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+            // Explicit huge pages, only available when some were reserved (vm.nr_hugepages).
+            constexpr int map_huge_2mb = 21 << 26; // MAP_HUGE_2MB
+            ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | map_huge_2mb, -1, 0);
+#endif
+
+            if (ptr == MAP_FAILED)
+            {
+                // Transparent huge pages, the mapping has to be aligned on the huge page size.
+                ptr = os_map_aligned(size, __fst::large_page_memory_zone::large_page_size);
+                if (!ptr) { return nullptr; }
+
+#ifdef MADV_HUGEPAGE
+                ::madvise(ptr, size, MADV_HUGEPAGE);
+#endif
+            }
+
+            // Pages are not touched yet, the policy applies to all of them.
+            bind_to_numa_node(ptr, size, node);
+            return ptr;
+
+#else
+            return os_map_aligned(size, __fst::large_page_memory_zone::large_page_size);
+#endif // __FST_WINDOWS__
+        }
+    } // namespace
+
+    void* large_page_memory_zone::allocate(size_t size, __fst::memory_category_id mid) noexcept
+    {
+        return large_page_memory_zone::aligned_allocate(size, __fst::simd_memory_zone::default_alignment(), mid);
+    }
+
+    void large_page_memory_zone::deallocate(void* ptr, __fst::memory_category_id mid) noexcept
+    {
+        large_page_memory_zone::aligned_deallocate(ptr, mid);
+    }
+
+    void* large_page_memory_zone::aligned_allocate(size_t size, size_t alignment, FST_ATTRIBUTE_UNUSED __fst::memory_category_id mid) noexcept
+    {
+        fst_assert(__fst::is_power_of_two(alignment), "alignment must be a power of two");
+        fst_assert(alignment <= large_page_size, "alignment too big");
+
+        if (size >= large_allocation_threshold)
+        {
+            // The data starts on the first large page and nothing else is stored in the mapping.
+            const size_t map_size = __fst::align(size, large_page_size);
+            void* ptr = map_large_pages(map_size, large_page_numa_node);
+            if (!ptr) { return nullptr; }
+
+            if (!add_large_mapping(ptr, map_size))
+            {
+                os_unmap(ptr, map_size);
+                return nullptr;
+            }
+
+            FST_IF_PROFILE(__fst::profiler::allocated(ptr, size, id(), mid));
+            return ptr;
+        }
+
+        alignment = __fst::maximum(alignment, __fst::simd_memory_zone::default_alignment(), alignof(large_page_header));
+        const size_t offset = __fst::align(sizeof(large_page_header), alignment);
+
+        uint8_t* base = (uint8_t*) __fst::simd_memory_zone::aligned_allocate(offset + size, alignment, mid);
+        if (!base) { return nullptr; }
+
+        uint8_t* ptr = base + offset;
+        get_large_page_header(ptr)->base = base;
+
+        FST_IF_PROFILE(__fst::profiler::allocated(ptr, size, id(), mid));
+        return ptr;
+    }
+
+    void large_page_memory_zone::aligned_deallocate(void* ptr, FST_ATTRIBUTE_UNUSED __fst::memory_category_id mid) noexcept
+    {
+        if (!ptr) { return; }
+
+        FST_IF_PROFILE(__fst::profiler::deallocated(ptr, id(), mid));
+
+        // A small allocation can land on a large page boundary too, the table tells them apart.
+        if (is_large_page_aligned(ptr))
+        {
+            if (const size_t map_size = remove_large_mapping(ptr))
+            {
+                os_unmap(ptr, map_size);
+                return;
+            }
+        }
+
+        __fst::simd_memory_zone::aligned_deallocate(get_large_page_header(ptr)->base, mid);
+    }
+
+    bool large_page_memory_zone::is_large_allocation(const void* ptr) noexcept
+    {
+        return ptr && is_large_page_aligned(ptr) && has_large_mapping(ptr);
+    }
+
+    void large_page_memory_zone::set_thread_numa_node(int node) noexcept
+    {
+        large_page_numa_node = node;
+    }
+
+    int large_page_memory_zone::thread_numa_node() noexcept
+    {
+        return large_page_numa_node;
+    }
+
+    int large_page_memory_zone::current_numa_node() noexcept
+    {
+#if __FST_WINDOWS__
+        ::PROCESSOR_NUMBER processor;
+        ::GetCurrentProcessorNumberEx(&processor);
+
+        USHORT node = 0;
+        return ::GetNumaProcessorNodeEx(&processor, &node) ? (int) node : 0;
+#elif (__FST_LINUX__ || __FST_ANDROID__) && defined(SYS_getcpu)
+        unsigned int cpu = 0;
+        unsigned int node = 0;
+        return ::syscall(SYS_getcpu, &cpu, &node, nullptr) == 0 ? (int) node : 0;
+#else
+        return 0;
+#endif
+    }
+
 FST_END_NAMESPACE
@@ -5,10 +5,10 @@
 #if __FST_WINDOWS__
 #define WIN32_LEAN_AND_MEAN
 #include <Windows.h>
+#else
+#include <pthread.h>
 #endif // __FST_WINDOWS__
 
-FST_TODO("mutex posix implementation")
-
 FST_BEGIN_NAMESPACE
 
 #if __FST_WINDOWS__
@@ -39,26 +39,41 @@ FST_BEGIN_NAMESPACE
 #else
     struct mutex::native
     {
-        FST_ALWAYS_INLINE native() noexcept
-        {
+        using native_type = ::pthread_mutex_t;
 
-        }
+        FST_ALWAYS_INLINE native() noexcept { ::pthread_mutex_init(&_mutex, nullptr); }
 
-        FST_ALWAYS_INLINE ~native() noexcept {  }
+        FST_ALWAYS_INLINE ~native() noexcept { ::pthread_mutex_destroy(&_mutex); }
 
-        FST_ALWAYS_INLINE void lock() noexcept {   }
+        FST_ALWAYS_INLINE void lock() noexcept { ::pthread_mutex_lock(&_mutex); }
 
-        FST_ALWAYS_INLINE bool try_lock() noexcept { return false; }
+        FST_ALWAYS_INLINE bool try_lock() noexcept { return ::pthread_mutex_trylock(&_mutex) == 0; }
 
-        FST_ALWAYS_INLINE void unlock() noexcept {   }
+        FST_ALWAYS_INLINE void unlock() noexcept { ::pthread_mutex_unlock(&_mutex); }
 
-        FST_ALWAYS_INLINE handle get_handle() const noexcept { return nullptr; }
+        FST_ALWAYS_INLINE handle get_handle() const noexcept { return (void*) &_mutex; }
 
+        native_type _mutex;
     };
 #endif // __FST_WINDOWS__
 
+    namespace
+    {
+        // 1 + 2 + ... + 128 pauses before parking.
+        constexpr uint32_t spin_rounds = 8;
+
+        FST_ALWAYS_INLINE void backoff(uint32_t round) noexcept
+        {
+            for (uint32_t i = 0; i < (1u << round); i++)
+            {
+                FST_NOP();
+            }
+        }
+    } // namespace
+
     mutex::mutex() noexcept
     {
+        static_assert(sizeof(native) <= sizeof(_storage), "mutex storage is too small");
         fst_placement_new(_storage.data()) native();
     }
 
@@ -69,7 +84,11 @@ FST_BEGIN_NAMESPACE
 
     void mutex::lock() noexcept
     {
-        _storage.data<native>()->lock();
+        native* n = _storage.data<native>();
+        if (n->try_lock()) { return; }
+
+        ++_contentions;
+        n->lock();
     }
 
     bool mutex::try_lock() noexcept
@@ -87,4 +106,98 @@ FST_BEGIN_NAMESPACE
         return _storage.data<native>()->get_handle();
     }
 
+    //
+    // adaptive_mutex
+    //
+    void adaptive_mutex::lock_contended() noexcept
+    {
+        ++_contentions;
+
+        for (uint32_t round = 0; round < spin_rounds; round++)
+        {
+            backoff(round);
+
+            if (try_lock()) { return; }
+        }
+
+        // We can't know if other threads are sleeping, so once parked the lock
+        // is always taken in the contended state and the unlock wakes someone up.
+        while (_state.exchange(locked_with_waiters) != unlocked)
+        {
+            ++_parks;
+            _state.wait(locked_with_waiters);
+        }
+    }
+
+    //
+    // shared_mutex
+    //
+    void shared_mutex::lock_contended() noexcept
+    {
+        ++_contentions;
+        ++_waiting_writers;
+
+        uint32_t round = 0;
+        for (;;)
+        {
+            uint32_t state = _state.load();
+
+            if (state == 0)
+            {
+                if (_state.compare_exchange_strong(state, writer_bit)) { break; }
+                continue;
+            }
+
+            if (round < spin_rounds)
+            {
+                backoff(round++);
+                continue;
+            }
+
+            // Registering before the last check guarantees that unlock sees us.
+            ++_waiters;
+            if (const uint32_t current = _state.load())
+            {
+                ++_parks;
+                _state.wait(current);
+            }
+            --_waiters;
+        }
+
+        --_waiting_writers;
+    }
+
+    void shared_mutex::lock_shared_contended() noexcept
+    {
+        ++_contentions;
+
+        uint32_t round = 0;
+        for (;;)
+        {
+            uint32_t state = _state.load();
+
+            if (can_read(state))
+            {
+                if (_state.compare_exchange_strong(state, state + 1)) { return; }
+                continue;
+            }
+
+            // A writer is waiting on a free lock, it's about to take it.
+            if (round < spin_rounds || state == 0)
+            {
+                backoff(round < spin_rounds ? round++ : spin_rounds);
+                continue;
+            }
+
+            ++_waiters;
+            const uint32_t current = _state.load();
+            if (current != 0 && !can_read(current))
+            {
+                ++_parks;
+                _state.wait(current);
+            }
+            --_waiters;
+        }
+    }
+
 FST_END_NAMESPACE
@@ -1,11 +1,13 @@
 #include "fst/profiler.h"
 
 #if FST_USE_PROFILER
-#include "fst/small_vector.h"
-#include "fst/string.h"
-#include "fst/unordered_map.h"
+#include "fst/atomic.h"
+#include "fst/mutex.h"
 #include "fst/time.h"
+#include "fst/async/thread.h"
 #include <stdio.h>
+#include <stdlib.h>
+#include <new>
 
 #if __FST_MSVC__
 #pragma section("fst_profiler", read, write)
@@ -14,18 +16,6 @@
 #define FST_PROFILER_SECTION
 #endif //
 
-namespace prof_detail
-{
-    template <class _Key, class _Value>
-    using unordered_map = __fst::small_unordered_map<_Key, _Value, 32, alignof(_Value), __fst::profiler_memory_zone,
-        __fst::profiler_memory_category>; //, std::hash<_Key>, std::equal_to<_Key>, map_allocator<_Key, _Value>>;
-
-    //template <class _Key, class _Value>
-    //using unordered_map = __fst::unordered_map<_Key, _Value, alignof(_Value), __fst::profiler_memory_zone,
-    //__fst::profiler_memory_category>; //, std::hash<_Key>, std::equal_to<_Key>, map_allocator<_Key, _Value>>;
-
-} // namespace prof_detail
-
 FST_BEGIN_NAMESPACE
 
 #if FST_PROFILER_WARNING_IS_ERROR
@@ -69,7 +59,9 @@ FST_BEGIN_NAMESPACE
 
     __fst::output_stream<char>& profiler::tracer(const char* section)
     {
-        static size_t count = 0;
+        // Line number, tracer() is called from any thread.
+        static __fst::atomic<size_t> count = 0;
+        const size_t line = count.fetch_add(1) + 1;
 
 #if FST_USE_PROFILER_COLOR
 
@@ -81,394 +73,791 @@ FST_BEGIN_NAMESPACE
 
         else if (__fst::strncmp(section, "section", 7) == 0) { col = __fst::term_color::magenta; }
 
-        return get_tracer()._stream << __fst::stream_detail::sep_t{} << __fst::padded_right<6>(++count) << __fst::stream_detail::sep_t{} << __fst::term_color::cyan
+        return get_tracer()._stream << __fst::stream_detail::sep_t{} << __fst::padded_right<6>(line) << __fst::stream_detail::sep_t{} << __fst::term_color::cyan
                                     << __fst::format_time_ms(std::chrono::system_clock::now()) << __fst::term_color::reset << __fst::stream_detail::sep_t{} << col
                                     << __fst::term_color::bold << __fst::padded<14>(section) << __fst::term_color::reset;
 #else
 
-        return get_tracer()._stream << __fst::separator << __fst::padded_right<6>(++count) << __fst::separator << __fst::system_clock::now() << __fst::separator
+        return get_tracer()._stream << __fst::separator << __fst::padded_right<6>(line) << __fst::separator << __fst::system_clock::now() << __fst::separator
                                     << __fst::padded<14>(section);
 #endif
     }
 
-    struct profiler_content
+    //
+    // Allocation tracking.
+    //
+    // Every allocation and deallocation of a profiled zone goes through here, from any thread.
+    // Live pointers are kept in an open-addressing index split in shards picked from the address,
+    // each shard has its own lock so threads only collide when they hit the same shard.
+    // The index isn't lock-free: a shard grows and erases with backward shift deletion, which
+    // moves entries around and can't be done with single word atomics. With 64 shards and an
+    // uncontended adaptive_mutex the lock is one atomic exchange on each side.
+    // Per zone/category counters live in per-thread blocks that are summed on read, and the
+    // optional memory events are buffered per thread, the trace file is only touched on flush.
+    //
+    // None of this state is ever destroyed and the index tables come straight from calloc,
+    // allocations made during static initialization or at exit are still tracked.
+    //
+    namespace
     {
-        using string_type = __fst::basic_string<char, __fst::allocator<char, __fst::profiler_memory_category, __fst::profiler_memory_zone>>;
-        using vector_type = __fst::small_vector<string_type, 32, alignof(string_type), __fst::profiler_memory_zone, __fst::profiler_memory_category>;
-        vector_type zones;
-        vector_type categories;
+        constexpr size_t max_zone_count = 32;
+        constexpr size_t max_category_count = 64;
+        constexpr size_t pointer_shard_count = 64;
+        constexpr size_t pointer_shard_initial_capacity = 256;
+        constexpr size_t event_buffer_capacity = 256;
+
+        /// Timeline events per thread, 1.25 MiB.
+        constexpr size_t timeline_buffer_capacity = 1 << 15;
 
-        inline const char* get_category_name(__fst::memory_category_id mid) const noexcept
+        /// Slots left for timeline_end only, an end always has room after its begin
+        /// unless the scopes are nested deeper than this.
+        constexpr size_t timeline_end_reserve = 256;
+
+        FST_ALWAYS_INLINE size_t zone_index(__fst::memory_zone_id zid) noexcept
         {
-            return categories.size() > mid ? categories[(size_t) mid].c_str() : "unknown";
+            return (size_t) zid < max_zone_count ? (size_t) zid : max_zone_count - 1;
         }
 
-        inline void add_category(__fst::memory_category_id mid, const char* name) noexcept
+        FST_ALWAYS_INLINE size_t category_index(__fst::memory_category_id mid) noexcept
         {
-            if (categories.size() <= mid) categories.resize((size_t) mid + 1);
-
-            categories[(size_t) mid] = name;
+            return (size_t) mid < max_category_count ? (size_t) mid : max_category_count - 1;
         }
 
-        inline const char* get_zone_name(__fst::memory_zone_id zid) const noexcept { return zones.size() > zid ? zones[(size_t) zid].c_str() : "unknown"; }
-
-        inline void add_zone(__fst::memory_zone_id zid, const char* name) noexcept
+        FST_ALWAYS_INLINE uint64_t pointer_hash(const void* ptr) noexcept
         {
-            if (zones.size() <= zid) zones.resize((size_t) zid + 1);
-            zones[(size_t) zid] = name;
+            // Allocations are at least 8 bytes aligned, the low bits carry no information.
+            return (uint64_t) (((uintptr_t) ptr) >> 3) * 0x9E3779B97F4A7C15ull;
         }
-    };
 
-    FST_PRAGMA_PUSH()
-    FST_PRAGMA_DISABLE_WARNING_CLANG("-Wexit-time-destructors")
-    static profiler_content& get_profiler_names() noexcept
-    {
-        FST_PROFILER_SECTION
-        static profiler_content _content;
-        return _content;
-    }
-    FST_PRAGMA_POP()
+        /// Counters of a single thread, only written by the thread that owns the block.
+        /// Values are deltas: a block freeing memory allocated by another thread goes negative,
+        /// only the sum over all blocks is meaningful. Blocks of exited threads are handed
+        /// over to the next new thread and never freed.
+        struct thread_counters
+        {
+            struct cell
+            {
+                __fst::atomic<int64_t> bytes;
+                __fst::atomic<int64_t> count;
+                __fst::atomic<int64_t> total_count;
+                __fst::atomic<int64_t> total_bytes;
+            };
 
-    struct item
-    {
-        size_t size;
-    };
+            cell cells[max_zone_count][max_category_count];
+            thread_counters* next;
+            __fst::atomic<uint32_t> in_use;
+        };
 
-    struct pointer_map : prof_detail::unordered_map<void*, item>
-    {
-        int64_t _used = 0;
+        FST_ALWAYS_INLINE void add_relaxed(__fst::atomic<int64_t>& value, int64_t delta) noexcept { value.store_relaxed(value.load_relaxed() + delta); }
+
+        struct pointer_entry
+        {
+            void* ptr;
+            size_t size;
+            uint32_t zone;
+            uint32_t category;
+        };
 
-        inline void add(void* ptr, item it)
+        /// Linear probing table with backward shift deletion, no tombstones.
+        struct alignas(__fst::cache_line_size) pointer_shard
         {
-            if (auto f = this->find(ptr); f != this->end())
+            __fst::adaptive_mutex mutex;
+            pointer_entry* entries;
+            size_t capacity;
+            size_t size;
+
+            FST_ALWAYS_INLINE size_t slot(const void* ptr) const noexcept
             {
-                fst_error("pointer reallocation");
-                f->size += it.size;
+                // The top bits pick the shard, use the ones below.
+                return (size_t) (pointer_hash(ptr) >> 20) & (capacity - 1);
             }
-            else { this->operator[](ptr) = it; }
 
-            _used += it.size;
-        }
+            inline pointer_entry* find(const void* ptr) noexcept
+            {
+                if (!capacity) { return nullptr; }
 
-        inline void remove(void* ptr)
-        {
-            if (ptr == nullptr) { return; }
+                for (size_t i = slot(ptr);; i = (i + 1) & (capacity - 1))
+                {
+                    if (entries[i].ptr == ptr) { return entries + i; }
+                    if (!entries[i].ptr) { return nullptr; }
+                }
+            }
 
-            if (auto f = this->find(ptr); f != this->end())
+            inline bool grow() noexcept
             {
-                _used -= f->size;
-                this->erase(f);
+                const size_t new_capacity = capacity ? capacity * 2 : pointer_shard_initial_capacity;
+                pointer_entry* new_entries = (pointer_entry*) ::calloc(new_capacity, sizeof(pointer_entry));
+                if (!new_entries) { return false; }
+
+                pointer_entry* old_entries = entries;
+                const size_t old_capacity = capacity;
+                entries = new_entries;
+                capacity = new_capacity;
+
+                for (size_t i = 0; i < old_capacity; i++)
+                {
+                    if (old_entries[i].ptr)
+                    {
+                        size_t j = slot(old_entries[i].ptr);
+                        while (entries[j].ptr) { j = (j + 1) & (capacity - 1); }
+                        entries[j] = old_entries[i];
+                    }
+                }
+
+                ::free(old_entries);
+                return true;
             }
-            else { fst_error("free error"); }
-        }
 
-        inline void remove(iterator it)
-        {
-            fst_assert(it != this->end());
-            _used -= it->size;
-            this->erase(it);
-        }
-    };
+            /// Returns the existing entry if ptr is already in the table.
+            inline pointer_entry* insert(const pointer_entry& e, bool& inserted) noexcept
+            {
+                inserted = false;
 
-    struct profiler_data
-    {
-        using category_vector = __fst::small_vector<pointer_map, 32, alignof(pointer_map), __fst::profiler_memory_zone, __fst::profiler_memory_category>;
-        using zone_vector = __fst::small_vector<category_vector, 32, alignof(category_vector), __fst::profiler_memory_zone, __fst::profiler_memory_category>;
+                // Keeps the load factor under 70%.
+                if ((size + 1) * 10 > capacity * 7 && !grow()) { return nullptr; }
 
-        zone_vector zones;
+                size_t i = slot(e.ptr);
+                for (; entries[i].ptr; i = (i + 1) & (capacity - 1))
+                {
+                    if (entries[i].ptr == e.ptr) { return entries + i; }
+                }
 
-        inline category_vector* get_zone(__fst::memory_zone_id zid) noexcept { return zones.size() > zid ? &zones[(size_t) zid] : nullptr; }
+                entries[i] = e;
+                size++;
+                inserted = true;
+                return entries + i;
+            }
 
-        inline category_vector& operator[](__fst::memory_zone_id zid) noexcept
-        {
-            if (zones.size() <= zid) zones.resize((size_t) zid + 1);
+            inline void erase(pointer_entry* e) noexcept
+            {
+                size_t i = (size_t) (e - entries);
+                size_t j = i;
 
-            return zones[(size_t) zid];
-        }
-    };
+                for (;;)
+                {
+                    j = (j + 1) & (capacity - 1);
+                    if (!entries[j].ptr) { break; }
 
-    FST_PRAGMA_PUSH()
-    FST_PRAGMA_DISABLE_WARNING_CLANG("-Wexit-time-destructors")
-    static profiler_data& get_profiler_zones() noexcept
-    {
-        FST_PROFILER_SECTION
-        static profiler_data _data;
-        return _data;
-    }
-    FST_PRAGMA_POP()
+                    // Moves back every entry whose probe sequence goes through the hole.
+                    const size_t k = slot(entries[j].ptr);
+                    if ((j > i && (k <= i || k > j)) || (j < i && (k <= i && k > j)))
+                    {
+                        entries[i] = entries[j];
+                        i = j;
+                    }
+                }
 
-    struct impl
-    {
-        enum class item_type {
-            alloc,
-            dealloc
+                entries[i] = pointer_entry{};
+                size--;
+            }
+        };
+
+        enum class timeline_event_type : uint8_t {
+            begin,
+            end,
+            counter
         };
 
-        struct item_content
+        struct timeline_event
         {
-            __fst::memory_category_id mid;
-            size_t size;
-            void* ptr;
-            time_point time;
-            item_type type;
+            /// steady_clock nanoseconds.
+            uint64_t time;
+            const char* name;
+
+            /// Bytes of the zone/category pair of a counter event.
+            int64_t value;
+            uint64_t thread_id;
+            timeline_event_type type;
+            uint8_t zone;
+            uint8_t category;
+        };
 
-            friend inline __fst::output_stream<char>& operator<<(__fst::output_stream<char>& stream, const item_content& it)
+        /// Written by the thread that owns it, read by write_timeline under the timeline mutex.
+        /// Like thread_counters, buffers of exited threads are handed over to new threads.
+        struct timeline_buffer
+        {
+            alignas(__fst::cache_line_size) __fst::atomic<size_t> head;
+            alignas(__fst::cache_line_size) __fst::atomic<size_t> tail;
+            timeline_buffer* next;
+            __fst::atomic<uint32_t> in_use;
+            __fst::atomic<uint32_t> dropped;
+            timeline_event events[timeline_buffer_capacity];
+
+            /// Fails when less than reserve slots would be left.
+            FST_ALWAYS_INLINE bool push(const timeline_event& e, size_t reserve) noexcept
             {
-                stream << __fst::space_padding(14, ((it.type == impl::item_type::alloc) ? "alloc   " : "dealloc ")) << __fst::space_padding(14, it.size) << " "
-                       << __fst::space_padding(14, (uintptr_t) it.ptr) << " ";
+                const size_t t = tail.load_relaxed();
+                if (t - head.load_acquire() + reserve >= timeline_buffer_capacity)
+                {
+                    dropped.fetch_add(1);
+                    return false;
+                }
+
+                events[t & (timeline_buffer_capacity - 1)] = e;
+                tail.store_release(t + 1);
+                return true;
+            }
+        };
+
+        struct profiler_state
+        {
+            __fst::atomic<const char*> zone_names[max_zone_count];
+            __fst::atomic<const char*> category_names[max_category_count];
+            pointer_shard shards[pointer_shard_count];
+            __fst::atomic<thread_counters*> thread_counters_list;
+
+            /// Used with atomic additions by threads that don't have (or no longer have) their own block.
+            thread_counters shared_counters;
+            __fst::atomic<uint32_t> log_events;
+
+            __fst::atomic<timeline_buffer*> timeline_buffers;
+            __fst::adaptive_mutex timeline_mutex;
+            __fst::atomic<uint32_t> timeline_used;
+            uint64_t timeline_origin = __fst::steady_clock::now_ns();
 
-                FST_PRAGMA_PUSH()
-                FST_PRAGMA_DISABLE_WARNING_CLANG("-Wctad-maybe-unsupported")
-                stream << it.time;
-                FST_PRAGMA_POP()
+            FST_ALWAYS_INLINE pointer_shard& shard(const void* ptr) noexcept { return shards[pointer_hash(ptr) >> 58]; }
 
-                return stream;
+            inline const char* get_zone_name(size_t zid) const noexcept
+            {
+                const char* name = zone_names[zid].load();
+                return name ? name : "unknown";
+            }
+
+            inline const char* get_category_name(size_t mid) const noexcept
+            {
+                const char* name = category_names[mid].load();
+                return name ? name : "unknown";
             }
         };
 
-        impl() {}
+        static_assert(pointer_shard_count == 64, "shard() uses the top 6 bits of the hash");
 
-        static inline void trace_event(const char* zone_name, const char* cat_name, void* ptr, size_t size, item_type type)
+        FST_ALWAYS_INLINE profiler_state& get_profiler_state() noexcept
         {
-            const char* label = type == impl::item_type::alloc ? "alloc" : "dealloc";
-            __fst::profiler::trace("memory", __fst::padded<14>(zone_name ? zone_name : "unknown"), __fst::padded<32>(label), __fst::padded_right<14>(size),
-                __fst::padded_right<14>((uintptr_t) ptr), __fst::padded<14>(cat_name ? cat_name : "unknown"));
+            // Never destroyed on purpose, deallocations can still come in after exit.
+            FST_PROFILER_SECTION
+            alignas(profiler_state) static uint8_t _storage[sizeof(profiler_state)];
+            static profiler_state* _state = new (_storage) profiler_state{};
+            return *_state;
         }
 
-        static inline void add_event(__fst::memory_zone_id zid, item_content it)
+        static thread_local thread_counters* t_counters = nullptr;
+        static thread_local bool t_counters_released = false;
+
+        struct thread_counters_owner
         {
-            const char* zone_name = get_profiler_names().get_zone_name(zid);
-            if (!zone_name) { zone_name = "unknown memory zone"; }
+            ~thread_counters_owner() noexcept
+            {
+                if (t_counters) { t_counters->in_use.store(0); }
 
-            const char* category_name = get_profiler_names().get_category_name(it.mid);
-            if (!category_name) { category_name = "unknown memory category"; }
+                // Deallocations made by the remaining thread_local destructors go to the shared counters.
+                t_counters = nullptr;
+                t_counters_released = true;
+            }
+        };
 
-            trace_event(zone_name, category_name, it.ptr, it.size, it.type);
-        }
+        FST_PRAGMA_PUSH()
+        FST_PRAGMA_DISABLE_WARNING_CLANG("-Wexit-time-destructors")
+        static thread_local thread_counters_owner t_counters_owner;
+        FST_PRAGMA_POP()
 
-        static inline void add_profiler_event(
-            FST_ATTRIBUTE_UNUSED __fst::memory_zone_id zid, FST_ATTRIBUTE_UNUSED __fst::memory_category_id mid, void* ptr, size_t size, item_type type)
+        FST_NOINLINE thread_counters* acquire_thread_counters(profiler_state& state) noexcept
         {
-            trace_event("profiler", "profiler", ptr, size, type);
-        }
+            // Registers the destructor that gives the block back.
+            __fst::unused(&t_counters_owner);
+
+            thread_counters* head = state.thread_counters_list.load();
+            for (thread_counters* c = head; c; c = c->next)
+            {
+                uint32_t expected = 0;
+                if (c->in_use.load() == 0 && c->in_use.compare_exchange_strong(expected, 1)) { return t_counters = c; }
+            }
+
+            void* data = ::malloc(sizeof(thread_counters));
+            if (!data) { return nullptr; }
 
-        static inline bool has_pointers(const pointer_map& it) { return !it.empty(); }
+            thread_counters* c = new (data) thread_counters{};
+            c->in_use.store(1);
 
-        void move_allocation(void* ptr, __fst::memory_zone_id zid, __fst::memory_category_id from_mid, FST_ATTRIBUTE_UNUSED __fst::memory_category_id to_mid)
+            do
+            {
+                c->next = head;
+            } while (!state.thread_counters_list.compare_exchange_strong(head, c));
+
+            return t_counters = c;
+        }
+
+        FST_ALWAYS_INLINE void update_counters(profiler_state& state, uint32_t zone, uint32_t category, int64_t bytes, int64_t count, bool new_allocation) noexcept
         {
-            if (auto z = get_profiler_zones().get_zone(zid))
+            thread_counters* tc = t_counters;
+            if (!tc && !t_counters_released) { tc = acquire_thread_counters(state); }
+
+            if (tc)
             {
-                if (auto c = (z->size() > from_mid ? &z->operator[]((size_t) from_mid) : nullptr))
+                // Only this thread writes to its block, no need for read-modify-write instructions.
+                thread_counters::cell& c = tc->cells[zone][category];
+                add_relaxed(c.bytes, bytes);
+                add_relaxed(c.count, count);
+
+                if (new_allocation)
                 {
-                    if (typename pointer_map::iterator ptr_it = c->find(ptr); ptr_it != c->end())
-                    {
-                        // add_event(item_content{ mid, ptr_it->second.size, ptr,
-                        // clock::now(), item_type::dealloc });
-                        //get_profiler_zones().zones
-                        //
-                        //
-                        //
-
-                        // TODO:
-                        //
-                        //z->operator[](to_mid)[ptr] = ptr_it;
-                        c->remove(ptr_it);
-                        return;
-                    }
+                    add_relaxed(c.total_count, 1);
+                    add_relaxed(c.total_bytes, bytes);
                 }
-                //if (typename profiler_data::category_map::iterator it = z->find(from_mid); it != z->second.end())
-                //    {
-                //        if (typename pointer_map::iterator ptr_it = it->second.find(ptr); ptr_it != it->second.end())
-                //        {
-                //            // add_event(item_content{ mid, ptr_it->second.size, ptr,
-                //            // clock::now(), item_type::dealloc });
-                //            z->second[to_mid][ptr] = ptr_it->second;
-                //            it->second.remove(ptr_it);
-                //            return;
-                //        }
-                //}
+
+                return;
             }
 
-            fst_error("DLKJDAKLJDA");
+            thread_counters::cell& c = state.shared_counters.cells[zone][category];
+            c.bytes.fetch_add(bytes);
+            c.count.fetch_add(count);
+
+            if (new_allocation)
+            {
+                ++c.total_count;
+                c.total_bytes.fetch_add(bytes);
+            }
         }
 
-        static void allocated(void* ptr, size_t size, __fst::memory_zone_id zid, __fst::memory_category_id mid, const char* name)
+        enum class event_type : uint32_t {
+            alloc,
+            dealloc
+        };
+
+        struct memory_event
         {
-            if (ptr == nullptr)
+            void* ptr;
+            size_t size;
+            __fst::time_point time;
+            uint32_t zone;
+            uint32_t category;
+            event_type type;
+        };
+
+        struct event_buffer
+        {
+            memory_event events[event_buffer_capacity];
+            size_t size = 0;
+
+            ~event_buffer() noexcept { flush(); }
+
+            inline void push(const memory_event& e) noexcept
             {
-                if (size)
-                {
-                    fst_error("allocating on nullptr");
-                    return;
-                }
+                events[size++] = e;
+                if (size == event_buffer_capacity) { flush(); }
+            }
 
-                if (name)
+            inline void flush() noexcept
+            {
+                if (!size) { return; }
+
+                profiler_state& state = get_profiler_state();
+                static __fst::adaptive_mutex _trace_mutex;
+                _trace_mutex.lock();
+
+                for (size_t i = 0; i < size; i++)
                 {
-                    if (zid == __fst::invalid_memory_zone) { get_profiler_names().add_category(mid, name); }
-                    else if (mid == __fst::invalid_memory_category) { get_profiler_names().add_zone(zid, name); }
-                    return;
+                    const memory_event& e = events[i];
+                    __fst::profiler::trace("memory", __fst::padded<14>(state.get_zone_name(e.zone)),
+                        __fst::padded<32>(e.type == event_type::alloc ? "alloc" : "dealloc"), __fst::padded_right<14>(e.size),
+                        __fst::padded_right<14>((uintptr_t) e.ptr), __fst::padded<14>(state.get_category_name(e.category)), e.time);
                 }
 
+                _trace_mutex.unlock();
+                size = 0;
+            }
+        };
+
+        FST_PRAGMA_PUSH()
+        FST_PRAGMA_DISABLE_WARNING_CLANG("-Wexit-time-destructors")
+        static thread_local event_buffer t_event_buffer;
+        FST_PRAGMA_POP()
+
+        FST_ALWAYS_INLINE void add_event(profiler_state& state, void* ptr, size_t size, uint32_t zone, uint32_t category, event_type type) noexcept
+        {
+            if (state.log_events.load()) { t_event_buffer.push(memory_event{ ptr, size, __fst::system_clock::now(), zone, category, type }); }
+        }
+
+        void register_names(profiler_state& state, __fst::memory_zone_id zid, __fst::memory_category_id mid, const char* name) noexcept
+        {
+            if (!name)
+            {
                 fst_error("wrong allocation");
                 return;
             }
 
-            add_event(zid, item_content{ mid, size, ptr, __fst::system_clock::now(), item_type::alloc });
+            if (zid == __fst::invalid_memory_zone) { state.category_names[category_index(mid)].store(name); }
+            else if (mid == __fst::invalid_memory_category) { state.zone_names[zone_index(zid)].store(name); }
+        }
+    } // namespace
 
-            auto& z = get_profiler_zones()[zid];
-            if (z.size() <= mid) { z.resize((size_t) mid + 1); }
+    void profiler::allocated(void* ptr, size_t size, __fst::memory_zone_id zid, __fst::memory_category_id mid, const char* name)
+    {
+        profiler_state& state = get_profiler_state();
 
-            z[(size_t) mid].add(ptr, item{ size });
+        if (ptr == nullptr)
+        {
+            if (size)
+            {
+                fst_error("allocating on nullptr");
+                return;
+            }
+
+            register_names(state, zid, mid, name);
+            return;
         }
 
-        struct pointer_result
+        const uint32_t zone = (uint32_t) zone_index(zid);
+        const uint32_t category = (uint32_t) category_index(mid);
+
+        if (name && !state.category_names[category].load()) { state.category_names[category].store(name); }
+
+        pointer_shard& shard = state.shard(ptr);
+        shard.mutex.lock();
+        bool inserted;
+        pointer_entry* e = shard.insert(pointer_entry{ ptr, size, zone, category }, inserted);
+
+        if (!inserted && e)
         {
-            __fst::memory_zone_id zid;
-            __fst::memory_category_id mid;
-            pointer_map* ptr_map;
-            typename pointer_map::iterator ptr_iterator;
+            // Should never happen, keeps the counters right if it does.
+            update_counters(state, e->zone, e->category, -(int64_t) e->size, -1, false);
+            *e = pointer_entry{ ptr, size, zone, category };
+        }
+
+        shard.mutex.unlock();
+
+        if (!e)
+        {
+            fst_error("profiler index allocation failed");
+            return;
+        }
+
+        if (!inserted) { fst_error("pointer reallocation"); }
+
+        update_counters(state, zone, category, (int64_t) size, 1, true);
+        add_event(state, ptr, size, zone, category, event_type::alloc);
+    }
+
+    void profiler::deallocated(void* ptr, __fst::memory_zone_id zid, __fst::memory_category_id mid)
+    {
+        if (ptr == nullptr) { return; }
+
+        profiler_state& state = get_profiler_state();
+        pointer_shard& shard = state.shard(ptr);
+
+        shard.mutex.lock();
+        pointer_entry* it = shard.find(ptr);
+        const pointer_entry e = it ? *it : pointer_entry{};
+        if (it) { shard.erase(it); }
+        shard.mutex.unlock();
+
+        if (!it)
+        {
+            __fst::profiler::trace("memory", " warning wrong dealloc");
+            fst_error("WRONG DEALLOC");
+            return;
+        }
+
+        update_counters(state, e.zone, e.category, -(int64_t) e.size, -1, false);
+
+        if (e.zone != zone_index(zid))
+        {
+            __fst::profiler::trace("memory", " warning wrong dealloc");
+            FST_PROFILER_WARNING("WRONG DEALLOC MEMORY ZONE");
+        }
+        else if (e.category != category_index(mid))
+        {
+            __fst::profiler::trace("memory", " warning wrong dealloc");
+            FST_PROFILER_WARNING("WRONG DEALLOC MEMORY CATEGORY");
+        }
+
+        add_event(state, ptr, e.size, e.zone, e.category, event_type::dealloc);
+    }
+
+    void profiler::move_allocation(void* ptr, __fst::memory_zone_id zid, __fst::memory_category_id from_mid, __fst::memory_category_id to_mid)
+    {
+        profiler_state& state = get_profiler_state();
+        pointer_shard& shard = state.shard(ptr);
+
+        const uint32_t zone = (uint32_t) zone_index(zid);
+        const uint32_t from = (uint32_t) category_index(from_mid);
+        const uint32_t to = (uint32_t) category_index(to_mid);
+
+        shard.mutex.lock();
+        pointer_entry* it = shard.find(ptr);
+        const bool found = it && it->zone == zone && it->category == from;
+        const size_t size = found ? it->size : 0;
+        if (found) { it->category = to; }
+        shard.mutex.unlock();
+
+        if (!found)
+        {
+            fst_error("move_allocation on an unknown pointer");
+            return;
+        }
 
-            inline explicit operator bool() const noexcept { return ptr_map != nullptr; }
+        // Not a new allocation, the totals stay where they were.
+        update_counters(state, zone, from, -(int64_t) size, -1, false);
+        update_counters(state, zone, to, (int64_t) size, 1, false);
+    }
+
+    profiler::counters profiler::get_counters(__fst::memory_zone_id zid, __fst::memory_category_id mid) noexcept
+    {
+        profiler_state& state = get_profiler_state();
+        const size_t zone = zone_index(zid);
+        const size_t category = category_index(mid);
+
+        const thread_counters::cell& shared = state.shared_counters.cells[zone][category];
+        counters result{ shared.bytes.load(), shared.count.load(), (uint64_t) shared.total_count.load(), (uint64_t) shared.total_bytes.load() };
+
+        for (thread_counters* tc = state.thread_counters_list.load(); tc; tc = tc->next)
+        {
+            const thread_counters::cell& c = tc->cells[zone][category];
+            result.bytes += c.bytes.load_relaxed();
+            result.count += c.count.load_relaxed();
+            result.total_count += (uint64_t) c.total_count.load_relaxed();
+            result.total_bytes += (uint64_t) c.total_bytes.load_relaxed();
+        }
+
+        return result;
+    }
+
+    void profiler::set_memory_event_logging(bool enabled) noexcept { get_profiler_state().log_events.store(enabled ? 1 : 0); }
+
+    bool profiler::is_memory_event_logging_enabled() noexcept { return get_profiler_state().log_events.load() != 0; }
+
+    void profiler::flush() noexcept { t_event_buffer.flush(); }
+
+    //
+    // Timeline.
+    //
+    namespace
+    {
+        static thread_local timeline_buffer* t_timeline = nullptr;
+        static thread_local uint64_t t_timeline_thread_id = 0;
+        static thread_local bool t_timeline_released = false;
+
+        struct timeline_buffer_owner
+        {
+            ~timeline_buffer_owner() noexcept
+            {
+                if (t_timeline) { t_timeline->in_use.store(0); }
+
+                // Scopes ending in the remaining thread_local destructors are dropped.
+                t_timeline = nullptr;
+                t_timeline_released = true;
+            }
         };
 
-        static pointer_result find_ptr(void* ptr)
+        FST_PRAGMA_PUSH()
+        FST_PRAGMA_DISABLE_WARNING_CLANG("-Wexit-time-destructors")
+        static thread_local timeline_buffer_owner t_timeline_owner;
+        FST_PRAGMA_POP()
+
+        FST_NOINLINE timeline_buffer* acquire_timeline_buffer(profiler_state& state) noexcept
         {
-            for (size_t i = 0; i < get_profiler_zones().zones.size(); i++)
+            // Registers the destructor that gives the buffer back.
+            __fst::unused(&t_timeline_owner);
+            t_timeline_thread_id = __fst::async::this_thread::get_id().value();
+            state.timeline_used.store(1);
+
+            timeline_buffer* head = state.timeline_buffers.load();
+            for (timeline_buffer* b = head; b; b = b->next)
             {
-                auto& z = get_profiler_zones().zones[i];
+                uint32_t expected = 0;
+                if (b->in_use.load() == 0 && b->in_use.compare_exchange_strong(expected, 1)) { return t_timeline = b; }
+            }
 
-                size_t n = 0;
-                for (auto& k : z)
-                {
-                    if (typename pointer_map::iterator pit = k.find(ptr); pit != k.end())
-                    {
-                        return pointer_result{ (__fst::memory_zone_id) i, (__fst::memory_category_id) n, &k, pit };
-                    }
+            void* data = __fst::profiler_memory_zone::aligned_allocate(sizeof(timeline_buffer), alignof(timeline_buffer), __fst::profiler_memory_category::id());
+            if (!data) { return nullptr; }
 
-                    n++;
-                }
+            timeline_buffer* b = new (data) timeline_buffer{};
+            b->in_use.store(1);
+
+            do
+            {
+                b->next = head;
+            } while (!state.timeline_buffers.compare_exchange_strong(head, b));
+
+            return t_timeline = b;
+        }
+
+        FST_ALWAYS_INLINE bool push_timeline_event(timeline_event_type type, const char* name, size_t reserve, int64_t value = 0, uint32_t zone = 0, uint32_t category = 0) noexcept
+        {
+            timeline_buffer* b = t_timeline;
+            if (FST_UNLIKELY(!b))
+            {
+                if (t_timeline_released || !(b = acquire_timeline_buffer(get_profiler_state()))) { return false; }
             }
 
-            return { __fst::invalid_memory_zone, __fst::invalid_memory_category, nullptr, {} };
+            return b->push(timeline_event{ __fst::steady_clock::now_ns(), name, value, t_timeline_thread_id, type, (uint8_t) zone, (uint8_t) category }, reserve);
         }
 
-        static pointer_result find_ptr(__fst::memory_zone_id zid, void* ptr)
+        inline void write_json_string(__fst::output_stream<char>& stream, const char* str) noexcept
         {
-            if (auto z = get_profiler_zones().get_zone(zid))
+            constexpr char hex[] = "0123456789abcdef";
+
+            stream << '"';
+
+            const char* run = str;
+            for (; *str; str++)
             {
-                size_t n = 0;
+                const unsigned char c = (unsigned char) *str;
+                if (c != '"' && c != '\\' && c >= 0x20) { continue; }
 
-                for (auto& k : *z)
-                {
-                    if (typename pointer_map::iterator pit = k.find(ptr); pit != k.end()) { return pointer_result{ zid, (__fst::memory_category_id) n, &k, pit }; }
+                stream.write(run, (size_t) (str - run));
+                run = str + 1;
 
-                    n++;
+                if (c == '"' || c == '\\')
+                {
+                    const char escaped[2] = { '\\', (char) c };
+                    stream.write(escaped, 2);
+                }
+                else
+                {
+                    const char escaped[6] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 15] };
+                    stream.write(escaped, 6);
                 }
             }
 
-            return find_ptr(ptr);
+            stream.write(run, (size_t) (str - run));
+            stream << '"';
         }
 
-        static void deallocated(void* ptr, __fst::memory_zone_id zid, __fst::memory_category_id mid)
+        inline void write_timeline_event(__fst::output_stream<char>& stream, profiler_state& state, const timeline_event& e) noexcept
         {
-            enum class state_enum {
-                searching,
-                cant_find_memory_zone,
-                cant_find_memory_category,
-                cant_find_pointer
-            };
+            // Microseconds since the profiler started.
+            const uint64_t ns = e.time > state.timeline_origin ? e.time - state.timeline_origin : 0;
 
-            state_enum state = state_enum::searching;
+            stream << "{\"ph\":\"" << (e.type == timeline_event_type::begin ? 'B' : e.type == timeline_event_type::end ? 'E' : 'C') << "\",\"ts\":" << ns / 1000
+                   << '.' << __fst::zero_padded_right<3>(ns % 1000) << ",\"pid\":0,";
 
-            if (auto z = get_profiler_zones().get_zone(zid))
+            if (e.type == timeline_event_type::counter)
             {
-                if (auto it = (z->size() > mid ? &z->operator[]((size_t) mid) : nullptr))
-                {
-                    if (typename pointer_map::iterator ptr_it = it->find(ptr); ptr_it != it->end())
-                    {
-                        add_event(zid, item_content{ mid, ptr_it->size, ptr, __fst::system_clock::now(), item_type::dealloc });
-                        it->remove(ptr_it);
-                        return;
-                    }
-                    else { state = state_enum::cant_find_pointer; }
-                }
-                else { state = state_enum::cant_find_memory_category; }
+                stream << "\"name\":\"memory " << state.get_zone_name(e.zone) << '/' << state.get_category_name(e.category) << "\",\"args\":{\"bytes\":" << e.value
+                       << "}}";
+                return;
+            }
+
+            stream << "\"tid\":" << e.thread_id << ",\"cat\":\"fst\",\"name\":";
+            write_json_string(stream, e.name);
+            stream << '}';
+        }
+
+        struct timeline_exit_writer
+        {
+            ~timeline_exit_writer() noexcept
+            {
+#ifdef FST_PROFILER_TIMELINE_PATH
+                if (get_profiler_state().timeline_used.load()) { __fst::profiler::write_timeline(FST_PROFILER_TIMELINE_PATH); }
+#endif
+            }
+        };
+
+        FST_PRAGMA_PUSH()
+        FST_PRAGMA_DISABLE_WARNING_CLANG("-Wexit-time-destructors")
+        static timeline_exit_writer _timeline_exit_writer;
+        FST_PRAGMA_POP()
+    } // namespace
 
-                __fst::unused(state);
+    bool profiler::timeline_begin(const char* name) noexcept { return push_timeline_event(timeline_event_type::begin, name, timeline_end_reserve); }
 
-                if (pointer_result sr = find_ptr(zid, ptr))
+    void profiler::timeline_end(const char* name) noexcept { push_timeline_event(timeline_event_type::end, name, 0); }
+
+    void profiler::sample_memory_counters() noexcept
+    {
+        profiler_state& state = get_profiler_state();
+
+        for (size_t z = 0; z < max_zone_count; z++)
+        {
+            int64_t bytes[max_category_count];
+            int64_t total_count[max_category_count];
+
+            for (size_t c = 0; c < max_category_count; c++)
+            {
+                const thread_counters::cell& shared = state.shared_counters.cells[z][c];
+                bytes[c] = shared.bytes.load();
+                total_count[c] = shared.total_count.load();
+            }
+
+            for (thread_counters* tc = state.thread_counters_list.load(); tc; tc = tc->next)
+            {
+                for (size_t c = 0; c < max_category_count; c++)
                 {
-                    add_event(zid, item_content{ mid, sr.ptr_iterator->size, ptr, __fst::system_clock::now(), item_type::dealloc });
-                    sr.ptr_map->remove(sr.ptr_iterator);
-                    __fst::profiler::trace("memory", " warning wrong dealloc");
-                    FST_PROFILER_WARNING("WRONG DEALLOC MEMORY CATEGORY");
-                    return;
+                    bytes[c] += tc->cells[z][c].bytes.load_relaxed();
+                    total_count[c] += tc->cells[z][c].total_count.load_relaxed();
                 }
-                else { state = state_enum::cant_find_memory_zone; }
             }
 
-            if (pointer_result sr = find_ptr(ptr))
+            for (size_t c = 0; c < max_category_count; c++)
             {
-                add_event(zid, item_content{ mid, sr.ptr_iterator->size, ptr, __fst::system_clock::now(), item_type::dealloc });
-                sr.ptr_map->remove(sr.ptr_iterator);
-                __fst::profiler::trace("memory", " warning wrong dealloc");
-
-                FST_PROFILER_WARNING("WRONG DEALLOC MEMORY ZONE");
-                return;
+                if (total_count[c]) { push_timeline_event(timeline_event_type::counter, nullptr, timeline_end_reserve, bytes[c], (uint32_t) z, (uint32_t) c); }
             }
+        }
+    }
 
-            __fst::profiler::trace("memory", " warning wrong dealloc");
+    void profiler::write_timeline(__fst::output_stream<char> & stream) noexcept
+    {
+        profiler_state& state = get_profiler_state();
+        sample_memory_counters();
 
-            fst_error("WRONG DEALLOC");
+        state.timeline_mutex.lock();
+
+        stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+        bool first = true;
+        uint64_t dropped = 0;
+
+        for (timeline_buffer* b = state.timeline_buffers.load(); b; b = b->next)
+        {
+            const size_t head = b->head.load_relaxed();
+            const size_t tail = b->tail.load_acquire();
+
+            for (size_t i = head; i != tail; i++)
+            {
+                if (!first) { stream << ",\n"; }
+                first = false;
+                write_timeline_event(stream, state, b->events[i & (timeline_buffer_capacity - 1)]);
+            }
+
+            b->head.store_release(tail);
+            dropped += b->dropped.exchange(0);
         }
-    };
 
-    FST_PRAGMA_PUSH()
-    FST_PRAGMA_DISABLE_WARNING_CLANG("-Wexit-time-destructors")
-    static inline impl& get_profiler_impl() noexcept
-    {
-        FST_PROFILER_SECTION
-        static impl _impl;
-        return _impl;
-    }
-    FST_PRAGMA_POP()
+        stream << "],\"otherData\":{\"dropped_events\":\"" << dropped << "\"}}" << __fst::endl;
 
-    void profiler::move_allocation(void* ptr, __fst::memory_zone_id zid, __fst::memory_category_id from_mid, __fst::memory_category_id to_mid)
-    {
-        get_profiler_impl().move_allocation(ptr, zid, from_mid, to_mid);
+        state.timeline_mutex.unlock();
     }
 
-    void profiler::allocated(void* ptr, size_t size, __fst::memory_zone_id zid, __fst::memory_category_id mid, const char* name)
+    bool profiler::write_timeline(const char* path) noexcept
     {
-        impl::allocated(ptr, size, zid, mid, name);
-    }
+        FILE* file = ::fopen(path, "w");
+        if (!file) { return false; }
 
-    void profiler::deallocated(void* ptr, __fst::memory_zone_id zid, __fst::memory_category_id mid)
-    {
-        impl::deallocated(ptr, zid, mid);
+        __fst::output_stream<char> stream(
+            file, [](void* data, const char* str, size_t size, stream_modifier) noexcept -> size_t { return ::fwrite(str, 1, size, (FILE*) data); });
+
+        write_timeline(stream);
+        ::fclose(file);
+        return true;
     }
 
     profiler::result_type profiler::report()
     {
         result_type results;
+        profiler_state& state = get_profiler_state();
 
-        size_t z_count = 0;
-        for (const auto& zit : get_profiler_zones().zones)
+        for (pointer_shard& shard : state.shards)
         {
-            size_t c_count = 0;
-            for (const auto& it : zit)
+            shard.mutex.lock();
+            for (size_t i = 0; i < shard.capacity; i++)
             {
-                if (!it.empty())
+                if (const pointer_entry& e = shard.entries[i]; e.ptr)
                 {
-                    for (auto ptr_it : it)
-                    {
-                        results.push_back({ (__fst::memory_zone_id) z_count, (__fst::memory_category_id) c_count, ptr_it.size });
-                    }
+                    results.push_back({ (__fst::memory_zone_id) e.zone, (__fst::memory_category_id) e.category, e.size });
                 }
-                c_count++;
             }
-
-            z_count++;
+            shard.mutex.unlock();
         }
 
         return results;
@@ -476,37 +865,41 @@ FST_BEGIN_NAMESPACE
 
     void profiler::output(__fst::output_stream<char> & stream)
     {
-        for (const auto& zit : get_profiler_zones().zones)
+        profiler_state& state = get_profiler_state();
+
+        for (size_t z = 0; z < max_zone_count; z++)
         {
-            size_t c_count = 0;
-            for (const auto& it : zit)
+            for (size_t c = 0; c < max_category_count; c++)
             {
-                if (!it.empty())
-                {
-                    stream << "Wrong deallocation" << __fst::endl;
-                    stream << get_profiler_names().get_category_name((__fst::memory_category_id) c_count) << " " << it._used << __fst::endl;
+                const counters cnt = get_counters((__fst::memory_zone_id) z, (__fst::memory_category_id) c);
+                if (!cnt.count) { continue; }
 
-                    for (size_t i = 0; i < it.size(); i++)
+                stream << "Wrong deallocation" << __fst::endl;
+                stream << state.get_zone_name(z) << " " << state.get_category_name(c) << " " << cnt.bytes << __fst::endl;
+
+                for (pointer_shard& shard : state.shards)
+                {
+                    shard.mutex.lock();
+                    for (size_t i = 0; i < shard.capacity; i++)
                     {
-                        stream << "    " << it.keys()[i] << " " << it.values()[i].size << __fst::endl;
+                        if (const pointer_entry& e = shard.entries[i]; e.ptr && e.zone == z && e.category == c)
+                        {
+                            stream << "    " << (uintptr_t) e.ptr << " " << e.size << __fst::endl;
+                        }
                     }
+                    shard.mutex.unlock();
                 }
-
-                c_count++;
             }
         }
     }
 
     void* profiler_memory_zone::allocate(size_t size, FST_ATTRIBUTE_UNUSED __fst::memory_category_id mid) noexcept
     {
-        void* ptr = ::malloc(size);
-        FST_IF_PROFILE(impl::add_profiler_event(profiler_memory_zone::id(), mid, ptr, size, impl::item_type::alloc));
-        return ptr;
+        return ::malloc(size);
     }
 
     void profiler_memory_zone::deallocate(void* ptr, FST_ATTRIBUTE_UNUSED __fst::memory_category_id mid) noexcept
     {
-        FST_IF_PROFILE(impl::add_profiler_event(profiler_memory_zone::id(), mid, ptr, 0, impl::item_type::dealloc));
         ::free(ptr);
     }
 
@@ -518,15 +911,11 @@ FST_BEGIN_NAMESPACE
         void* ptr = ::aligned_alloc(alignment, size);
 #endif // __FST_WINDOWS__
 
-        FST_IF_PROFILE(impl::add_profiler_event(profiler_memory_zone::id(), mid, ptr, size, impl::item_type::alloc));
-
         return ptr;
     }
 
     void profiler_memory_zone::aligned_deallocate(void* ptr, FST_ATTRIBUTE_UNUSED __fst::memory_category_id mid) noexcept
     {
-        FST_IF_PROFILE(impl::add_profiler_event(profiler_memory_zone::id(), mid, ptr, 0, impl::item_type::dealloc));
-
 #if __FST_WINDOWS__
         ::_aligned_free(ptr);
 #else
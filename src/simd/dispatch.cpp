@@ -0,0 +1,195 @@
+#include "fst/simd_dispatch.h"
+#include "fst/atomic.h"
+
+#if FST_SIMD_DISPATCH
+#if __FST_MSVC__
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif // FST_SIMD_DISPATCH
+
+FST_BEGIN_SUB_NAMESPACE(simd)
+
+    // Defined in dispatch_*.cpp.
+    template <isa_level _Level, class T>
+    const kernel_table<T>& get_level_kernels() noexcept;
+
+    namespace
+    {
+#if FST_SIMD_DISPATCH
+        struct cpuid_registers
+        {
+            uint32_t eax;
+            uint32_t ebx;
+            uint32_t ecx;
+            uint32_t edx;
+        };
+
+        cpuid_registers cpuid(uint32_t leaf, uint32_t subleaf) noexcept
+        {
+            cpuid_registers regs = {};
+#if __FST_MSVC__
+            int values[4];
+            __cpuidex(values, (int) leaf, (int) subleaf);
+            regs = { (uint32_t) values[0], (uint32_t) values[1], (uint32_t) values[2], (uint32_t) values[3] };
+#else
+            __cpuid_count(leaf, subleaf, regs.eax, regs.ebx, regs.ecx, regs.edx);
+#endif
+            return regs;
+        }
+
+        // Register states enabled by the os (XCR0).
+        uint64_t xgetbv() noexcept
+        {
+#if __FST_MSVC__
+            return _xgetbv(0);
+#else
+            uint32_t eax;
+            uint32_t edx;
+            __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+            return ((uint64_t) edx << 32) | eax;
+#endif
+        }
+
+        isa_level detect_isa_level() noexcept
+        {
+            const uint32_t max_leaf = cpuid(0, 0).eax;
+            if (max_leaf < 1) { return isa_level::scalar; }
+
+            const cpuid_registers leaf1 = cpuid(1, 0);
+            if (!(leaf1.ecx & (1u << 19))) { return isa_level::scalar; }
+
+            // The avx instructions also need the os to save the ymm/zmm registers.
+            constexpr uint32_t fma_bit = 1u << 12;
+            constexpr uint32_t osxsave_bit = 1u << 27;
+            constexpr uint32_t avx_bit = 1u << 28;
+            constexpr uint32_t avx_bits = fma_bit | osxsave_bit | avx_bit;
+            if ((leaf1.ecx & avx_bits) != avx_bits || max_leaf < 7) { return isa_level::sse4_1; }
+
+            constexpr uint64_t xmm_ymm_state = 0x06;
+            constexpr uint64_t zmm_state = 0xE0; // opmask, upper zmm0-15 and zmm16-31.
+            const uint64_t xcr0 = xgetbv();
+            if ((xcr0 & xmm_ymm_state) != xmm_ymm_state) { return isa_level::sse4_1; }
+
+            const cpuid_registers leaf7 = cpuid(7, 0);
+            if (!(leaf7.ebx & (1u << 5))) { return isa_level::sse4_1; }
+
+            if ((leaf7.ebx & (1u << 16)) && (xcr0 & zmm_state) == zmm_state) { return isa_level::avx512; }
+            return isa_level::avx2;
+        }
+#else
+        isa_level detect_isa_level() noexcept { return isa_level::scalar; }
+#endif // FST_SIMD_DISPATCH
+
+        __fst::atomic<const kernel_table<float>*> current_float_kernels = nullptr;
+        __fst::atomic<const kernel_table<double>*> current_double_kernels = nullptr;
+        __fst::atomic<uint8_t> current_level = (uint8_t) isa_level::scalar;
+
+        void set_isa_level(isa_level level) noexcept
+        {
+            current_level.store((uint8_t) level);
+            current_float_kernels.store(get_kernels<float>(level));
+            current_double_kernels.store(get_kernels<double>(level));
+        }
+    } // namespace
+
+    isa_level detected_isa_level() noexcept
+    {
+        static const isa_level level = detect_isa_level();
+        return level;
+    }
+
+    isa_level current_isa_level() noexcept
+    {
+        // Makes sure the level was initialized.
+        (void) get_kernels<float>();
+        return (isa_level) current_level.load();
+    }
+
+    bool force_isa_level(isa_level level) noexcept
+    {
+        if (level > detected_isa_level()) { return false; }
+
+        set_isa_level(level);
+        return true;
+    }
+
+    void reset_isa_level() noexcept { set_isa_level(detected_isa_level()); }
+
+    const char* isa_level_name(isa_level level) noexcept
+    {
+        switch (level)
+        {
+        case isa_level::scalar:
+            return "scalar";
+        case isa_level::sse4_1:
+            return "sse4.1";
+        case isa_level::avx2:
+            return "avx2";
+        case isa_level::avx512:
+            return "avx512";
+        }
+
+        return "unknown";
+    }
+
+    template <>
+    const kernel_table<float>* get_kernels<float>(isa_level level) noexcept
+    {
+        switch (level)
+        {
+        case isa_level::scalar:
+            return &get_level_kernels<isa_level::scalar, float>();
+#if FST_SIMD_DISPATCH
+        case isa_level::sse4_1:
+            return &get_level_kernels<isa_level::sse4_1, float>();
+        case isa_level::avx2:
+            return &get_level_kernels<isa_level::avx2, float>();
+        case isa_level::avx512:
+            return &get_level_kernels<isa_level::avx512, float>();
+#endif // FST_SIMD_DISPATCH
+        default:
+            return nullptr;
+        }
+    }
+
+    template <>
+    const kernel_table<double>* get_kernels<double>(isa_level level) noexcept
+    {
+        switch (level)
+        {
+        case isa_level::scalar:
+            return &get_level_kernels<isa_level::scalar, double>();
+#if FST_SIMD_DISPATCH
+        case isa_level::sse4_1:
+            return &get_level_kernels<isa_level::sse4_1, double>();
+        case isa_level::avx2:
+            return &get_level_kernels<isa_level::avx2, double>();
+        case isa_level::avx512:
+            return &get_level_kernels<isa_level::avx512, double>();
+#endif // FST_SIMD_DISPATCH
+        default:
+            return nullptr;
+        }
+    }
+
+    template <>
+    const kernel_table<float>& get_kernels<float>() noexcept
+    {
+        if (const kernel_table<float>* kernels = current_float_kernels.load()) { return *kernels; }
+
+        reset_isa_level();
+        return *current_float_kernels.load();
+    }
+
+    template <>
+    const kernel_table<double>& get_kernels<double>() noexcept
+    {
+        if (const kernel_table<double>* kernels = current_double_kernels.load()) { return *kernels; }
+
+        reset_isa_level();
+        return *current_double_kernels.load();
+    }
+
+FST_END_SUB_NAMESPACE
@@ -0,0 +1,9 @@
+// SSE4.1 kernels, the instruction set is enabled in dispatch_kernels.h.
+#define FST_SIMD_DISPATCH_TARGET 128
+#include "fst/common.h"
+
+#if FST_SIMD_DISPATCH
+#include "dispatch_kernels.h"
+
+FST_SIMD_DISPATCH_DEFINE_KERNELS(isa_level::sse4_1)
+#endif // FST_SIMD_DISPATCH
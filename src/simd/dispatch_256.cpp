@@ -0,0 +1,9 @@
+// AVX2 kernels, the instruction set is enabled in dispatch_kernels.h.
+#define FST_SIMD_DISPATCH_TARGET 256
+#include "fst/common.h"
+
+#if FST_SIMD_DISPATCH
+#include "dispatch_kernels.h"
+
+FST_SIMD_DISPATCH_DEFINE_KERNELS(isa_level::avx2)
+#endif // FST_SIMD_DISPATCH
@@ -0,0 +1,9 @@
+// AVX-512 kernels, the instruction set is enabled in dispatch_kernels.h.
+#define FST_SIMD_DISPATCH_TARGET 512
+#include "fst/common.h"
+
+#if FST_SIMD_DISPATCH
+#include "dispatch_kernels.h"
+
+FST_SIMD_DISPATCH_DEFINE_KERNELS(isa_level::avx512)
+#endif // FST_SIMD_DISPATCH
@@ -0,0 +1,131 @@
+#pragma once
+
+//
+// Kernels of fst/simd_dispatch.h for one instruction set level.
+//
+// Included once by each src/simd/dispatch_*.cpp after defining FST_SIMD_DISPATCH_TARGET
+// (0, 128, 256 or 512). Those files are compiled with the baseline flags of the library,
+// the instruction set of the level is only enabled with a target pragma around the simd
+// containers and the kernels. The simd containers end up in their own inline namespace
+// (FST_BEGIN_SIMD_NAMESPACE) so that no instantiation is shared with the rest of the program.
+//
+// Everything else (math.h, utility.h, ...) is included before the pragma: those inline
+// functions can be emitted by this file and kept by the linker for the whole program,
+// they have to be compiled for the baseline instruction set.
+//
+
+#if !defined(FST_SIMD_DISPATCH_TARGET)
+#error "FST_SIMD_DISPATCH_TARGET must be defined before including dispatch_kernels.h"
+#endif
+
+#include "fst/common.h"
+#include "fst/math.h"
+#include "fst/array.h"
+#include "fst/memory.h"
+#include "fst/simd_dispatch.h"
+
+#if FST_PLATFORM_HAS_IMMINTRIN_H
+#include <immintrin.h>
+#endif
+
+#if FST_SIMD_DISPATCH_TARGET == 128
+#define FST_SIMD_DISPATCH_ISA "sse4.1"
+#elif FST_SIMD_DISPATCH_TARGET == 256
+#define FST_SIMD_DISPATCH_ISA "avx2,fma"
+#elif FST_SIMD_DISPATCH_TARGET == 512
+#define FST_SIMD_DISPATCH_ISA "avx512f,avx2,fma"
+#endif
+
+// msvc doesn't need a target to use the intrinsics.
+#if defined(FST_SIMD_DISPATCH_ISA) && __FST_CLANG__
+FST_PRAGMA(clang attribute push(__attribute__((target(FST_SIMD_DISPATCH_ISA))), apply_to = function))
+#elif defined(FST_SIMD_DISPATCH_ISA) && __FST_GCC__
+FST_PRAGMA(GCC push_options)
+FST_PRAGMA(GCC target(FST_SIMD_DISPATCH_ISA))
+#endif
+
+#include "fst/simd.h"
+
+FST_BEGIN_SUB_NAMESPACE(simd)
+
+    template <isa_level _Level, class T>
+    const kernel_table<T>& get_level_kernels() noexcept;
+
+FST_END_SUB_NAMESPACE
+
+namespace
+{
+    template <class T>
+    struct dispatch_kernels
+    {
+        using range_type = __fst::simd::range<T>;
+        using const_range_type = __fst::simd::range<const T>;
+
+        static void fill(T* dst, T value, size_t size) noexcept { range_type(dst, size).fill(value); }
+
+        static void assign(T* dst, const T* a, size_t size) noexcept { range_type(dst, size).assign(const_range_type(a, size)); }
+
+        static void add(T* dst, const T* a, size_t size) noexcept { range_type(dst, size).add(const_range_type(a, size)); }
+
+        static void add_value(T* dst, T a, size_t size) noexcept { range_type(dst, size).add(a); }
+
+        static void sub(T* dst, const T* a, size_t size) noexcept { range_type(dst, size).sub(const_range_type(a, size)); }
+
+        static void sub_value(T* dst, T a, size_t size) noexcept { range_type(dst, size).sub(a); }
+
+        static void mul(T* dst, const T* a, size_t size) noexcept { range_type(dst, size).mul(const_range_type(a, size)); }
+
+        static void mul_value(T* dst, T a, size_t size) noexcept { range_type(dst, size).mul(a); }
+
+        static void div(T* dst, const T* a, size_t size) noexcept { range_type(dst, size).div(const_range_type(a, size)); }
+
+        static void div_value(T* dst, T a, size_t size) noexcept { range_type(dst, size).div(a); }
+
+        static void add_mul(T* dst, const T* a, const T* b, size_t size) noexcept
+        {
+            range_type(dst, size).add_mul(const_range_type(a, size), const_range_type(b, size));
+        }
+
+        static void add_mul_value(T* dst, const T* a, T b, size_t size) noexcept { range_type(dst, size).add_mul(const_range_type(a, size), b); }
+
+        static void mul_then_sum(T* dst, T a, T b, size_t size) noexcept { range_type(dst, size).mul_then_sum(a, b); }
+
+        static void min(T* dst, const T* a, size_t size) noexcept { range_type(dst, size).min(const_range_type(a, size)); }
+
+        static void max(T* dst, const T* a, size_t size) noexcept { range_type(dst, size).max(const_range_type(a, size)); }
+
+        static void sin(T* dst, const T* a, size_t size) noexcept { range_type(dst, size).sin(const_range_type(a, size)); }
+
+        static void cos(T* dst, size_t size) noexcept { range_type(dst, size).cos(); }
+
+        static void tan(T* dst, size_t size) noexcept { range_type(dst, size).tan(); }
+
+        static constexpr __fst::simd::kernel_table<T> table = { &fill, &assign, &add, &add_value, &sub, &sub_value, &mul, &mul_value, &div, &div_value,
+            &add_mul, &add_mul_value, &mul_then_sum, &min, &max, &sin, &cos, &tan };
+    };
+
+    // Instantiated before the end of the target pragma.
+    template struct dispatch_kernels<float>;
+    template struct dispatch_kernels<double>;
+} // namespace
+
+#if defined(FST_SIMD_DISPATCH_ISA) && __FST_CLANG__
+FST_PRAGMA(clang attribute pop)
+#elif defined(FST_SIMD_DISPATCH_ISA) && __FST_GCC__
+FST_PRAGMA(GCC pop_options)
+#endif
+
+#define FST_SIMD_DISPATCH_DEFINE_KERNELS(LEVEL)                                                                                                 \
+    FST_BEGIN_SUB_NAMESPACE(simd)                                                                                                           \
+        template <>                                                                                                                         \
+        const kernel_table<float>& get_level_kernels<LEVEL, float>() noexcept                                                               \
+        {                                                                                                                                   \
+            return dispatch_kernels<float>::table;                                                                                          \
+        }                                                                                                                                   \
+                                                                                                                                            \
+        template <>                                                                                                                         \
+        const kernel_table<double>& get_level_kernels<LEVEL, double>() noexcept                                                             \
+        {                                                                                                                                   \
+            return dispatch_kernels<double>::table;                                                                                         \
+        }                                                                                                                                   \
+    FST_END_SUB_NAMESPACE
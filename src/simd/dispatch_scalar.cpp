@@ -0,0 +1,5 @@
+// Scalar kernels, always built.
+#define FST_SIMD_DISPATCH_TARGET 0
+#include "dispatch_kernels.h"
+
+FST_SIMD_DISPATCH_DEFINE_KERNELS(isa_level::scalar)
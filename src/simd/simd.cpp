@@ -1,19 +1,19 @@
-//#include "fst/simd.h"
-//#include <stdio.h>
-//
-//FST_BEGIN_SUB_NAMESPACE(simd)
-//
-//    void print_version()
-//    {
-//#if FST_SIMD_512
-//        printf("fst simd 512\n");
-//#elif FST_SIMD_256
-//        printf("fst simd 256\n");
-//#elif FST_SIMD_128
-//        printf("fst simd 128\n");
-//#else
-//        printf("fst no simd\n");
-//#endif
-//    }
-//
-//FST_END_SUB_NAMESPACE
+#include "fst/simd.h"
+#include <stdio.h>
+
+FST_BEGIN_SUB_NAMESPACE(simd)
+
+    void print_version()
+    {
+#if FST_SIMD_512
+        printf("fst simd 512\n");
+#elif FST_SIMD_256
+        printf("fst simd 256\n");
+#elif FST_SIMD_128
+        printf("fst simd 128\n");
+#else
+        printf("fst no simd\n");
+#endif
+    }
+
+FST_END_SUB_NAMESPACE
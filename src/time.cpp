@@ -4,6 +4,11 @@
 #include <stdio.h>
 #include <inttypes.h>
 
+#if __FST_WINDOWS__
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#endif // __FST_WINDOWS__
+
 FST_BEGIN_NAMESPACE
 
     time_point system_clock::now() noexcept
@@ -12,7 +17,7 @@ FST_BEGIN_NAMESPACE
 
 #if __FST_GCC__
 
-        if (clock_gettime(CLOCK_REALTIME, &ts) == 0) { return time_point(); }
+        if (clock_gettime(CLOCK_REALTIME, &ts) != 0) { return time_point(); }
         return time_point(ts.tv_sec, ts.tv_nsec);
 #else
 
@@ -23,6 +28,27 @@ FST_BEGIN_NAMESPACE
         //return time_point(::time(0));
     }
 
+    uint64_t steady_clock::now_ns() noexcept
+    {
+#if __FST_WINDOWS__
+        static const uint64_t frequency = []()
+        {
+            LARGE_INTEGER f;
+            ::QueryPerformanceFrequency(&f);
+            return (uint64_t) f.QuadPart;
+        }();
+
+        LARGE_INTEGER counter;
+        ::QueryPerformanceCounter(&counter);
+        const uint64_t ticks = (uint64_t) counter.QuadPart;
+        return (ticks / frequency) * 1000000000ull + ((ticks % frequency) * 1000000000ull) / frequency;
+#else
+        struct timespec ts;
+        if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0) { return 0; }
+        return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+#endif // __FST_WINDOWS__
+    }
+
     __fst::output_stream<char>& operator<<(__fst::output_stream<char>& stream, time_point now)
     {
         // https://stackoverflow.com/a/35157784
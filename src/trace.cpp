@@ -1,10 +1,787 @@
 #include "fst/trace.h"
 #include "fst/time.h"
 #include "fst/string.h"
+#include "fst/atomic.h"
+#include "fst/mutex.h"
+#include "fst/vector.h"
+#include "fst/hash.h"
+#include "fst/unordered_map.h"
+#include "fst/parallel.h"
+#include "fst/async/ring_buffer.h"
+#include "fst/async/thread.h"
 #include <stdio.h>
 
 FST_BEGIN_NAMESPACE
 
+    namespace
+    {
+        //
+        // File format.
+        //
+        // file_header followed by chunks, each chunk starts with a chunk_header.
+        // Locations and sections are always written before the first record using them.
+        //
+
+        constexpr char trace_magic[8] = { 'F', 'S', 'T', 'T', 'R', 'A', 'C', 'E' };
+        constexpr uint32_t trace_version = 1;
+
+        enum class chunk_type : uint32_t {
+            calibration,
+            location,
+            section,
+            records,
+            dropped
+        };
+
+        struct file_header
+        {
+            char magic[8];
+            uint32_t version;
+            uint32_t record_size;
+        };
+
+        struct chunk_header
+        {
+            uint32_t type;
+            uint32_t size;
+        };
+
+        /// Time stamp counter and wall clock read at the same time, the decoder
+        /// interpolates between the first and the last one.
+        struct calibration_chunk
+        {
+            uint64_t timestamp;
+            int64_t seconds;
+            int64_t nanoseconds;
+        };
+
+        /// Followed by the file name and the function name.
+        struct location_chunk
+        {
+            uint32_t id;
+            uint32_t line;
+            uint32_t file_size;
+            uint32_t function_size;
+        };
+
+        /// Followed by the name.
+        struct section_chunk
+        {
+            uint32_t id;
+            uint32_t name_size;
+        };
+
+        /// Followed by count records of the same thread buffer.
+        struct records_chunk
+        {
+            uint32_t buffer_id;
+            uint32_t count;
+        };
+
+        struct dropped_chunk
+        {
+            uint32_t buffer_id;
+            uint32_t count;
+        };
+
+        //
+        // Writer.
+        //
+
+        /// Records per thread, 256 KiB.
+        constexpr size_t trace_buffer_capacity = 4096;
+
+        /// Records moved out of a thread buffer at once by the flusher.
+        constexpr size_t trace_drain_size = 256;
+
+        constexpr uint64_t trace_flush_interval_us = 1000;
+
+        struct trace_thread_buffer
+        {
+            inline trace_thread_buffer(uint32_t index) noexcept
+                : records(trace_buffer_capacity)
+                , id(index)
+            {}
+
+            __fst::async::spsc_ring_buffer<trace_record> records;
+            __fst::atomic<uint32_t> dropped = 0;
+            __fst::atomic<uint32_t> in_use = 1;
+            uint32_t id;
+            trace_thread_buffer* next = nullptr;
+        };
+
+        struct location_entry
+        {
+            const char* file;
+            const char* function;
+            uint32_t line;
+
+            FST_NODISCARD inline bool operator==(const location_entry& e) const noexcept { return file == e.file && function == e.function && line == e.line; }
+        };
+
+        FST_NODISCARD inline uint64_t location_hash(const location_entry& e) noexcept
+        {
+            return __fst::hash_combine(__fst::hash_combine(__fst::hash_int((uint64_t) (uintptr_t) e.file), __fst::hash_int((uint64_t) (uintptr_t) e.function)), e.line);
+        }
+
+        FST_NODISCARD inline calibration_chunk read_calibration() noexcept
+        {
+            const uint64_t timestamp = __fst::detail::trace_timestamp();
+            const __fst::time_point now = __fst::system_clock::now();
+            return calibration_chunk{ timestamp, now.time_since_epoch(), now.nanoseconds() };
+        }
+
+        class trace_state
+        {
+          public:
+            inline trace_state() noexcept
+                : _flusher(
+                    [this]()
+                    {
+                        __fst::async::this_thread::set_name("fst_trace");
+
+                        while (!_stop.load())
+                        {
+                            if (!flush()) { __fst::async::this_thread::sleep_for_us(trace_flush_interval_us); }
+                        }
+                    })
+            {}
+
+            inline void open() noexcept
+            {
+                char path[] = FST_TRACE_DIRECTORY "/trace_HH_MM_SS_MMM.fsttrace";
+                time_to_string2(__fst::memory_range<char, 12>(path + sizeof(path) - 22), __fst::system_clock::now(), '_');
+
+                _file_mutex.lock();
+
+                _file = ::fopen(path, "wb");
+                if (!_file)
+                {
+                    _file_mutex.unlock();
+                    return;
+                }
+
+                __fst::memcpy(_path, path, sizeof(path));
+
+                file_header header;
+                __fst::memcpy(header.magic, trace_magic, sizeof(trace_magic));
+                header.version = trace_version;
+                header.record_size = (uint32_t) sizeof(trace_record);
+                write(&header, sizeof(header));
+
+                const calibration_chunk calibration = read_calibration();
+                write_chunk(chunk_type::calibration, &calibration, sizeof(calibration));
+
+                _file_mutex.unlock();
+            }
+
+            /// Stops the flusher and writes what's left.
+            inline void close() noexcept
+            {
+                _stop.store(true);
+                _flusher.join();
+
+                flush();
+
+                _file_mutex.lock();
+                if (_file)
+                {
+                    const calibration_chunk calibration = read_calibration();
+                    write_chunk(chunk_type::calibration, &calibration, sizeof(calibration));
+                    ::fclose(_file);
+                    _file = nullptr;
+                }
+                _file_mutex.unlock();
+            }
+
+            FST_NODISCARD inline const char* path() const noexcept { return _path; }
+
+            FST_NODISCARD inline trace_site register_site(const __fst::source_location& loc, const char* section) noexcept
+            {
+                const location_entry entry{ loc.file_name(), loc.function_name(), loc.line() };
+                const uint64_t hash = location_hash(entry);
+
+                trace_site site;
+
+                _registry_mutex.lock();
+
+                auto it = _location_index.find(hash);
+                if (it != _location_index.end() && _locations[*it] == entry) { site.location_id = *it; }
+                else
+                {
+                    site.location_id = (uint32_t) _locations.size();
+                    _locations.push_back(entry);
+
+                    // Two locations with the same hash, the second one is never looked up.
+                    if (it == _location_index.end()) { _location_index.insert(hash, site.location_id); }
+                }
+
+                site.section_id = (uint16_t) _sections.size();
+                for (size_t i = 0; i < _sections.size(); i++)
+                {
+                    if (_sections[i] == section)
+                    {
+                        site.section_id = (uint16_t) i;
+                        break;
+                    }
+                }
+
+                if (site.section_id == _sections.size()) { _sections.push_back(section); }
+
+                _registry_mutex.unlock();
+                return site;
+            }
+
+            FST_NODISCARD inline trace_thread_buffer* acquire_buffer() noexcept
+            {
+                trace_thread_buffer* head = _buffers.load();
+                for (trace_thread_buffer* b = head; b; b = b->next)
+                {
+                    uint32_t expected = 0;
+                    if (b->in_use.load() == 0 && b->in_use.compare_exchange_strong(expected, 1)) { return b; }
+                }
+
+                void* data = __fst::aligned_allocate<__fst::async_memory_category>(sizeof(trace_thread_buffer), alignof(trace_thread_buffer));
+                if (!data) { return nullptr; }
+
+                trace_thread_buffer* b = fst_placement_new(data) trace_thread_buffer(_buffer_count.fetch_add(1));
+
+                do
+                {
+                    b->next = head;
+                } while (!_buffers.compare_exchange_strong(head, b));
+
+                return b;
+            }
+
+            /// Drains every thread buffer.
+            /// @returns true if any record was written.
+            inline bool flush() noexcept
+            {
+                bool written = false;
+
+                _file_mutex.lock();
+
+                if (_file)
+                {
+                    for (trace_thread_buffer* b = _buffers.load(); b; b = b->next)
+                    {
+                        if (const uint32_t dropped = b->dropped.exchange(0))
+                        {
+                            const dropped_chunk chunk{ b->id, dropped };
+                            write_chunk(chunk_type::dropped, &chunk, sizeof(chunk));
+                        }
+
+                        while (const size_t count = b->records.pop_n(_drain, trace_drain_size))
+                        {
+                            // After the drain, every location used by these records is registered.
+                            write_definitions();
+
+                            const records_chunk chunk{ b->id, (uint32_t) count };
+                            write_chunk(chunk_type::records, &chunk, sizeof(chunk), _drain, count * sizeof(trace_record));
+                            written = true;
+                        }
+                    }
+
+                    if (written)
+                    {
+                        const calibration_chunk calibration = read_calibration();
+                        write_chunk(chunk_type::calibration, &calibration, sizeof(calibration));
+                    }
+
+                    ::fflush(_file);
+                }
+
+                _file_mutex.unlock();
+                return written;
+            }
+
+          private:
+            __fst::mutex _registry_mutex;
+            __fst::vector<location_entry> _locations;
+            __fst::unordered_map<uint64_t, uint32_t> _location_index;
+            __fst::vector<const char*> _sections;
+
+            __fst::atomic<trace_thread_buffer*> _buffers = nullptr;
+            __fst::atomic<uint32_t> _buffer_count = 0;
+
+            __fst::mutex _file_mutex;
+            FILE* _file = nullptr;
+            char _path[sizeof(FST_TRACE_DIRECTORY "/trace_HH_MM_SS_MMM.fsttrace")] = {};
+            size_t _written_locations = 0;
+            size_t _written_sections = 0;
+            trace_record _drain[trace_drain_size];
+
+            __fst::atomic<bool> _stop = false;
+
+            // Last, starts running once everything else is initialized.
+            __fst::async::thread _flusher;
+
+            inline void write(const void* data, size_t size) noexcept { ::fwrite(data, 1, size, _file); }
+
+            inline void write_chunk(chunk_type type, const void* header, size_t header_size, const void* data = nullptr, size_t data_size = 0) noexcept
+            {
+                const chunk_header chunk{ (uint32_t) type, (uint32_t) (header_size + data_size) };
+                write(&chunk, sizeof(chunk));
+                write(header, header_size);
+                if (data_size) { write(data, data_size); }
+            }
+
+            inline void write_definitions() noexcept
+            {
+                _registry_mutex.lock();
+
+                for (; _written_locations < _locations.size(); _written_locations++)
+                {
+                    const location_entry& e = _locations[_written_locations];
+                    const location_chunk chunk{ (uint32_t) _written_locations, e.line, (uint32_t) __fst::strlen(e.file), (uint32_t) __fst::strlen(e.function) };
+
+                    const chunk_header header{ (uint32_t) chunk_type::location, (uint32_t) (sizeof(chunk) + chunk.file_size + chunk.function_size) };
+                    write(&header, sizeof(header));
+                    write(&chunk, sizeof(chunk));
+                    write(e.file, chunk.file_size);
+                    write(e.function, chunk.function_size);
+                }
+
+                for (; _written_sections < _sections.size(); _written_sections++)
+                {
+                    const section_chunk chunk{ (uint32_t) _written_sections, (uint32_t) __fst::strlen(_sections[_written_sections]) };
+                    write_chunk(chunk_type::section, &chunk, sizeof(chunk), _sections[_written_sections], chunk.name_size);
+                }
+
+                _registry_mutex.unlock();
+            }
+        };
+
+        struct trace_state_owner
+        {
+            inline trace_state_owner(trace_state& s) noexcept
+                : state(s)
+            {}
+
+            ~trace_state_owner() noexcept { state.close(); }
+
+            trace_state& state;
+        };
+
+        FST_PRAGMA_PUSH()
+        FST_PRAGMA_DISABLE_WARNING_CLANG("-Wexit-time-destructors")
+        inline trace_state& get_trace_state() noexcept
+        {
+            // Never destroyed on purpose, threads can still trace after exit. The
+            // owner only stops the flusher and closes the file.
+            alignas(trace_state) static uint8_t _storage[sizeof(trace_state)];
+            static trace_state* _state = []()
+            {
+                trace_state* s = fst_placement_new(_storage) trace_state{};
+                s->open();
+                return s;
+            }();
+
+            static trace_state_owner _owner(*_state);
+            return *_state;
+        }
+
+        static thread_local trace_thread_buffer* t_buffer = nullptr;
+        static thread_local bool t_buffer_released = false;
+
+        struct trace_buffer_owner
+        {
+            ~trace_buffer_owner() noexcept
+            {
+                if (t_buffer) { t_buffer->in_use.store(0); }
+
+                // Traces from the remaining thread_local destructors are dropped.
+                t_buffer = nullptr;
+                t_buffer_released = true;
+            }
+        };
+
+        static thread_local trace_buffer_owner t_buffer_owner;
+        FST_PRAGMA_POP()
+
+        FST_NOINLINE trace_thread_buffer* acquire_thread_buffer() noexcept
+        {
+            // Registers the destructor that gives the buffer back.
+            __fst::unused(&t_buffer_owner);
+            return t_buffer = get_trace_state().acquire_buffer();
+        }
+    } // namespace
+
+    trace_site register_trace_site(const __fst::source_location& loc, const char* section) noexcept { return get_trace_state().register_site(loc, section); }
+
+    void trace_flush() noexcept { get_trace_state().flush(); }
+
+    const char* trace_file_path() noexcept { return get_trace_state().path(); }
+
+    namespace detail
+    {
+        uint64_t trace_fallback_timestamp() noexcept { return __fst::steady_clock::now_ns(); }
+
+        void trace_push(trace_site site, size_t level, bool has_message, uint64_t timestamp, const uint8_t* payload, size_t size) noexcept
+        {
+            trace_thread_buffer* b = t_buffer;
+            if (FST_UNLIKELY(!b))
+            {
+                if (t_buffer_released || !(b = acquire_thread_buffer())) { return; }
+            }
+
+            const size_t count = size ? (size + trace_record::payload_size - 1) / trace_record::payload_size : 1;
+
+            // Only the flusher can free space, the check holds until the push.
+            if (b->records.capacity() - b->records.size() < count)
+            {
+                b->dropped.fetch_add(1);
+                return;
+            }
+
+            trace_record records[trace_max_records_per_message];
+            for (size_t i = 0; i < count; i++)
+            {
+                trace_record& r = records[i];
+                r.timestamp = timestamp;
+                r.location_id = site.location_id;
+                r.section_id = site.section_id;
+                r.level = (uint8_t) level;
+                r.flags = (uint8_t) ((has_message ? trace_record::has_message : 0) | (i ? trace_record::continued : 0));
+
+                const size_t offset = i * trace_record::payload_size;
+                const size_t payload_size = __fst::minimum(size - offset, trace_record::payload_size);
+                if (payload_size) { __fst::memcpy(r.payload, payload + offset, payload_size); }
+                __fst::memset(r.payload + payload_size, 0, trace_record::payload_size - payload_size);
+            }
+
+            b->records.push_n(records, count);
+        }
+    } // namespace detail
+
+    namespace
+    {
+        inline __fst::output_stream<char>& print_trace_label(__fst::output_stream<char>& stream, const char* label) noexcept
+        {
+            return stream << "\n    " << __fst::padded<8>(label) << ": ";
+        }
+
+        inline __fst::output_stream<char>& write_trace_item(__fst::output_stream<char>& stream, size_t id, __fst::time_point time, size_t level, const char* section,
+            const char* file, const char* function, size_t line, bool has_msg) noexcept
+        {
+            stream << "- item :";
+            print_trace_label(stream, "id") << __fst::zero_padded_right<4>(id);
+            print_trace_label(stream, "time") << "'" << time << "'";
+            print_trace_label(stream, "level") << __fst::zero_padded_right<2>(level);
+            print_trace_label(stream, "section") << section;
+            print_trace_label(stream, "file") << "'" << file << "'";
+            print_trace_label(stream, "function") << "'" << function << "'";
+            print_trace_label(stream, "line") << line;
+
+            if (has_msg) { print_trace_label(stream, "message"); }
+            return stream;
+        }
+
+        //
+        // Decoder.
+        //
+
+        struct decoded_location
+        {
+            const char* file = "";
+            size_t file_size = 0;
+            const char* function = "";
+            size_t function_size = 0;
+            uint32_t line = 0;
+        };
+
+        struct decoded_message
+        {
+            static constexpr size_t capacity = trace_max_records_per_message * trace_record::payload_size;
+
+            uint64_t timestamp;
+            uint32_t location_id;
+            uint16_t section_id;
+            uint8_t level;
+            uint8_t flags;
+            size_t size;
+            uint8_t payload[capacity];
+        };
+
+        struct decoded_order
+        {
+            uint64_t timestamp;
+            size_t index;
+        };
+
+        struct trace_reader
+        {
+            const uint8_t* data;
+            const uint8_t* end;
+
+            template <class _T>
+            FST_NODISCARD inline bool read(_T& value) noexcept
+            {
+                if ((size_t) (end - data) < sizeof(_T)) { return false; }
+                __fst::memcpy(&value, data, sizeof(_T));
+                data += sizeof(_T);
+                return true;
+            }
+        };
+
+        FST_NODISCARD inline __fst::string_view to_string_view(const char* str, size_t size) noexcept { return __fst::string_view(str, size); }
+
+        // Same output as basic_print with a space separator and an endl.
+        inline void print_trace_payload(__fst::output_stream<char>& stream, const uint8_t* payload, size_t size) noexcept
+        {
+            using detail::trace_arg;
+
+            const uint8_t* it = payload;
+            const uint8_t* end = payload + size;
+
+            while (it < end)
+            {
+                const trace_arg type = (trace_arg) *it++;
+                const size_t remaining = (size_t) (end - it);
+
+                switch (type)
+                {
+                case trace_arg::boolean:
+                    if (remaining < 1) { return; }
+                    stream << (*it++ != 0) << __fst::space;
+                    break;
+
+                case trace_arg::character:
+                    if (remaining < 1) { return; }
+                    stream << (char) *it++ << __fst::space;
+                    break;
+
+                case trace_arg::int64: {
+                    int64_t value;
+                    if (remaining < sizeof(value)) { return; }
+                    __fst::memcpy(&value, it, sizeof(value));
+                    it += sizeof(value);
+                    stream << value << __fst::space;
+                    break;
+                }
+
+                case trace_arg::uint64: {
+                    uint64_t value;
+                    if (remaining < sizeof(value)) { return; }
+                    __fst::memcpy(&value, it, sizeof(value));
+                    it += sizeof(value);
+                    stream << value << __fst::space;
+                    break;
+                }
+
+                case trace_arg::float64: {
+                    double value;
+                    if (remaining < sizeof(value)) { return; }
+                    __fst::memcpy(&value, it, sizeof(value));
+                    it += sizeof(value);
+                    stream << value << __fst::space;
+                    break;
+                }
+
+                case trace_arg::string:
+                case trace_arg::raw: {
+                    if (remaining < 1) { return; }
+                    const size_t str_size = __fst::minimum((size_t) *it++, remaining - 1);
+                    stream.write((const char*) it, str_size);
+                    it += str_size;
+                    if (type == trace_arg::string) { stream << __fst::space; }
+                    break;
+                }
+
+                case trace_arg::truncated: stream << "..." << __fst::space; break;
+
+                case trace_arg::end:
+                default: return;
+                }
+            }
+        }
+    } // namespace
+
+    bool decode_trace(const void* data, size_t size, __fst::output_stream<char>& stream) noexcept
+    {
+        trace_reader reader{ (const uint8_t*) data, (const uint8_t*) data + size };
+
+        file_header header;
+        if (!reader.read(header) || __fst::memcmp(header.magic, trace_magic, sizeof(trace_magic)) != 0 || header.version != trace_version
+            || header.record_size != sizeof(trace_record))
+        {
+            return false;
+        }
+
+        __fst::vector<decoded_location> locations;
+        __fst::vector<const char*> section_names;
+        __fst::vector<size_t> section_sizes;
+        __fst::vector<decoded_message> messages;
+
+        // Last message + 1 of each thread buffer, continued records are appended to it.
+        // Buffer ids come from the file, a map doesn't grow with their value.
+        __fst::unordered_map<uint32_t, size_t> last_messages;
+
+        // Every location and section has its own chunk, larger ids can only come from a corrupted file.
+        const size_t max_definition_id = size / (sizeof(chunk_header) + sizeof(section_chunk));
+
+        calibration_chunk first_calibration = {};
+        calibration_chunk last_calibration = {};
+        bool has_calibration = false;
+        uint64_t dropped = 0;
+
+        while (reader.data < reader.end)
+        {
+            chunk_header chunk;
+            if (!reader.read(chunk) || (size_t) (reader.end - reader.data) < chunk.size) { return false; }
+
+            trace_reader content{ reader.data, reader.data + chunk.size };
+            reader.data += chunk.size;
+
+            switch ((chunk_type) chunk.type)
+            {
+            case chunk_type::calibration: {
+                calibration_chunk c;
+                if (!content.read(c)) { return false; }
+                if (!has_calibration) { first_calibration = c; }
+                last_calibration = c;
+                has_calibration = true;
+                break;
+            }
+
+            case chunk_type::location: {
+                location_chunk c;
+                if (!content.read(c) || (size_t) (content.end - content.data) < (size_t) c.file_size + c.function_size || c.id >= max_definition_id)
+                {
+                    return false;
+                }
+
+                if (c.id >= locations.size()) { locations.resize(c.id + 1); }
+
+                decoded_location& loc = locations[c.id];
+                loc.file = (const char*) content.data;
+                loc.file_size = c.file_size;
+                loc.function = (const char*) content.data + c.file_size;
+                loc.function_size = c.function_size;
+                loc.line = c.line;
+                break;
+            }
+
+            case chunk_type::section: {
+                section_chunk c;
+                if (!content.read(c) || (size_t) (content.end - content.data) < c.name_size || c.id >= max_definition_id) { return false; }
+                if (c.id >= section_names.size())
+                {
+                    section_names.resize(c.id + 1, "");
+                    section_sizes.resize(c.id + 1, (size_t) 0);
+                }
+
+                section_names[c.id] = (const char*) content.data;
+                section_sizes[c.id] = c.name_size;
+                break;
+            }
+
+            case chunk_type::records: {
+                records_chunk c;
+                if (!content.read(c) || (size_t) (content.end - content.data) / sizeof(trace_record) < c.count) { return false; }
+                size_t& last = last_messages[c.buffer_id];
+
+                for (uint32_t i = 0; i < c.count; i++)
+                {
+                    trace_record r;
+                    if (!content.read(r)) { return false; }
+
+                    if ((r.flags & trace_record::continued) && last && messages[last - 1].size + trace_record::payload_size <= decoded_message::capacity)
+                    {
+                        decoded_message& m = messages[last - 1];
+                        __fst::memcpy(m.payload + m.size, r.payload, trace_record::payload_size);
+                        m.size += trace_record::payload_size;
+                        continue;
+                    }
+
+                    messages.resize(messages.size() + 1);
+                    last = messages.size();
+
+                    decoded_message& m = messages.back();
+                    m.timestamp = r.timestamp;
+                    m.location_id = r.location_id;
+                    m.section_id = r.section_id;
+                    m.level = r.level;
+                    m.flags = r.flags;
+                    m.size = trace_record::payload_size;
+                    __fst::memcpy(m.payload, r.payload, trace_record::payload_size);
+                }
+                break;
+            }
+
+            case chunk_type::dropped: {
+                dropped_chunk c;
+                if (!content.read(c)) { return false; }
+                dropped += c.count;
+                break;
+            }
+
+            // Unknown chunks are skipped.
+            default: break;
+            }
+        }
+
+        // Records of different threads are only ordered within a chunk.
+        __fst::vector<decoded_order> order;
+        order.resize(messages.size());
+        for (size_t i = 0; i < messages.size(); i++)
+        {
+            order[i] = decoded_order{ messages[i].timestamp, i };
+        }
+
+        // Serial, decoding shouldn't start the parallel thread pool.
+        __fst::vector<decoded_order> order_tmp;
+        order_tmp.resize(order.size());
+        __fst::detail::parallel_sort_grain(
+            order.data(), order_tmp.data(), order.size(), [](const decoded_order& a, const decoded_order& b) { return a.timestamp < b.timestamp; });
+
+        const uint64_t calibration_ticks = last_calibration.timestamp - first_calibration.timestamp;
+        const int64_t calibration_ns
+            = (last_calibration.seconds - first_calibration.seconds) * 1000000000ll + (last_calibration.nanoseconds - first_calibration.nanoseconds);
+        const double ns_per_tick = calibration_ticks ? (double) calibration_ns / (double) calibration_ticks : 0.0;
+
+        for (size_t i = 0; i < order.size(); i++)
+        {
+            const decoded_message& m = messages[order[i].index];
+
+            int64_t ns = first_calibration.nanoseconds + (int64_t) ((double) (int64_t) (m.timestamp - first_calibration.timestamp) * ns_per_tick);
+            int64_t seconds = first_calibration.seconds + ns / 1000000000ll;
+            ns %= 1000000000ll;
+            if (ns < 0)
+            {
+                ns += 1000000000ll;
+                seconds--;
+            }
+
+            const decoded_location loc = m.location_id < locations.size() ? locations[m.location_id] : decoded_location{};
+            const bool has_section = m.section_id < section_names.size();
+
+            char file[512];
+            char function[512];
+            char section[128];
+            const size_t file_size = __fst::minimum(loc.file_size, sizeof(file) - 1);
+            const size_t function_size = __fst::minimum(loc.function_size, sizeof(function) - 1);
+            const size_t section_size = has_section ? __fst::minimum(section_sizes[m.section_id], sizeof(section) - 1) : 0;
+            __fst::memcpy(file, loc.file, file_size);
+            __fst::memcpy(function, loc.function, function_size);
+            if (section_size) { __fst::memcpy(section, section_names[m.section_id], section_size); }
+            file[file_size] = 0;
+            function[function_size] = 0;
+            section[section_size] = 0;
+
+            const bool has_msg = (m.flags & trace_record::has_message) != 0;
+            write_trace_item(stream, i + 1, __fst::time_point(seconds, ns), m.level, section, file, function, loc.line, has_msg);
+
+            if (has_msg) { print_trace_payload(stream, m.payload, m.size); }
+            stream << __fst::endl << __fst::endl;
+        }
+
+        if (dropped) { stream << "# " << dropped << " dropped messages" << __fst::endl; }
+
+        return true;
+    }
+
     FST_PRAGMA_PUSH()
     FST_PRAGMA_DISABLE_WARNING_CLANG("-Wexit-time-destructors")
     __fst::output_stream<char>& trace_stream(size_t level, const char* section, const __fst::source_location& loc, size_t has_msg) noexcept
@@ -31,27 +808,9 @@ FST_BEGIN_NAMESPACE
             __fst::output_stream<char> _stream;
         };
         static file_tracer _tracer;
+        static __fst::atomic<size_t> count = 0;
 
-        static size_t count = 0;
-        __fst::output_stream<char>& stream = _tracer._stream << "- item :";
-
-        constexpr auto print_label = [](__fst::output_stream<char>& stream, const char* label) -> __fst::output_stream<char>&
-        {
-            return stream << "\n    " << __fst::padded<8>(label) << ": ";
-        };
-        //<< " - time    : " << __fst::system_clock::now();
-
-        print_label(stream, "id") << __fst::zero_padded_right<4>(++count);
-        print_label(stream, "time") << "'" << __fst::system_clock::now() << "'";
-
-        print_label(stream, "level") << __fst::zero_padded_right<2>(level);
-        print_label(stream, "section") << section;
-        print_label(stream, "file") << "'" << loc.file_name() << "'";
-        print_label(stream, "function") << "'" << loc.function_name() << "'";
-        print_label(stream, "line") << loc.line();
-
-        if (has_msg) { print_label(stream, "message"); }
-        return stream;
+        return write_trace_item(_tracer._stream, ++count, __fst::system_clock::now(), level, section, loc.file_name(), loc.function_name(), loc.line(), has_msg);
     }
     FST_PRAGMA_POP()
 
@@ -0,0 +1,9 @@
+#include "fst/function.h"
+
+int main(int argc, char* argv[])
+{
+    fst::unused(argc, argv);
+    char data[64] = {};
+    fst::inplace_function<int(), 32> f = [data]() { return (int) data[0]; };
+    return f();
+}
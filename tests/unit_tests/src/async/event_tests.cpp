@@ -0,0 +1,86 @@
+#include "utest.h"
+#include "fst/async/event.h"
+#include "fst/async/thread.h"
+
+namespace
+{
+    TEST_CASE("fst::async::event", "[async]")
+    {
+        TEST_SECTION("auto reset")
+        {
+            fst::async::event e;
+            REQUIRE_FALSE(e.is_set());
+            REQUIRE_FALSE(e.try_wait());
+
+            e.set();
+            REQUIRE(e.is_set());
+            REQUIRE(e.try_wait());
+            REQUIRE_FALSE(e.is_set());
+
+            e.set();
+            e.wait();
+            REQUIRE_FALSE(e.is_set());
+            REQUIRE_FALSE(e.wait_for_us(1000));
+        }
+
+        TEST_SECTION("manual reset")
+        {
+            fst::async::event e(fst::async::event::reset_mode::manual, true);
+            REQUIRE(e.try_wait());
+            REQUIRE(e.try_wait());
+            e.wait();
+            REQUIRE(e.wait_for_us(1000));
+
+            e.reset();
+            REQUIRE_FALSE(e.is_set());
+            REQUIRE_FALSE(e.wait_for_us(1000));
+        }
+
+        TEST_SECTION("producer consumer")
+        {
+            fst::async::event ready;
+            fst::async::event done;
+            uint32_t value = 0;
+            uint32_t sum = 0;
+
+            fst::async::thread consumer(
+                [&]()
+                {
+                    for (uint32_t i = 0; i < 100; i++)
+                    {
+                        ready.wait();
+                        sum += value;
+                        done.set();
+                    }
+                });
+
+            for (uint32_t i = 1; i <= 100; i++)
+            {
+                value = i;
+                ready.set();
+                done.wait();
+            }
+
+            consumer.join();
+            REQUIRE_EQ(sum, 5050);
+        }
+
+        TEST_SECTION("wake all")
+        {
+            fst::async::event e(fst::async::event::reset_mode::manual);
+            fst::atomic<uint32_t> count = 0;
+
+            fst::async::thread t1([&]() { e.wait(), ++count; });
+            fst::async::thread t2([&]() { e.wait(), ++count; });
+            fst::async::thread t3([&]() { e.wait(), ++count; });
+
+            fst::async::this_thread::sleep_for_us(1000);
+            e.set();
+
+            t1.join();
+            t2.join();
+            t3.join();
+            REQUIRE_EQ(count.load(), 3);
+        }
+    }
+} // namespace
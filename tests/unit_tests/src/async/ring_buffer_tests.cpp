@@ -0,0 +1,354 @@
+#include "utest.h"
+#include "fst/async/ring_buffer.h"
+#include "fst/async/thread.h"
+#include "fst/media/audio_bus.h"
+#include "fst/string.h"
+#include "fst/vector.h"
+
+namespace
+{
+    // Lets the other side run when the buffer is full or empty, the tests also run on single core machines.
+    inline size_t or_yield(size_t count) noexcept
+    {
+        if (count == 0) { fst::async::this_thread::yield(); }
+        return count;
+    }
+
+    TEST_CASE("fst::async::spsc_ring_buffer", "[async]")
+    {
+        TEST_SECTION("push and pop")
+        {
+            fst::async::spsc_ring_buffer<int> rb(5);
+            REQUIRE_EQ(rb.capacity(), 8);
+            REQUIRE(rb.empty());
+            REQUIRE_EQ(rb.front(), nullptr);
+
+            // Go around the ring a few times.
+            for (int lap = 0; lap < 5; lap++)
+            {
+                for (int i = 0; i < 8; i++)
+                {
+                    REQUIRE(rb.push(lap * 8 + i));
+                }
+
+                REQUIRE_FALSE(rb.push(-1));
+                REQUIRE_EQ(rb.size(), 8);
+
+                for (int i = 0; i < 8; i++)
+                {
+                    int value = -1;
+                    REQUIRE(rb.pop(value));
+                    REQUIRE_EQ(value, lap * 8 + i);
+                }
+
+                int value;
+                REQUIRE_FALSE(rb.pop(value));
+            }
+        }
+
+        TEST_SECTION("push_n and pop_n")
+        {
+            fst::async::spsc_ring_buffer<uint32_t> rb(16);
+            uint32_t values[20];
+            for (uint32_t i = 0; i < 20; i++)
+            {
+                values[i] = i;
+            }
+
+            REQUIRE_EQ(rb.push_n(values, 10), 10);
+            uint32_t out[20] = {};
+            REQUIRE_EQ(rb.pop_n(out, 6), 6);
+            REQUIRE_EQ(out[5], 5);
+
+            // Wraps around the end of the buffer, only 12 slots are free.
+            REQUIRE_EQ(rb.push_n(values, 20), 12);
+            REQUIRE_EQ(rb.size(), 16);
+            REQUIRE_EQ(rb.push_n(values, 1), 0);
+
+            REQUIRE_EQ(rb.pop_n(out, 20), 16);
+            REQUIRE_EQ(out[0], 6);
+            REQUIRE_EQ(out[3], 9);
+            REQUIRE_EQ(out[4], 0);
+            REQUIRE_EQ(out[15], 11);
+            REQUIRE_EQ(rb.pop_n(out, 1), 0);
+        }
+
+        TEST_SECTION("non trivial")
+        {
+            fst::async::spsc_ring_buffer<fst::string> rb(4);
+            REQUIRE(rb.emplace("a long string that doesn't fit the small buffer"));
+            REQUIRE(rb.push(fst::string("b")));
+
+            REQUIRE_EQ(*rb.front(), "a long string that doesn't fit the small buffer");
+            rb.pop();
+
+            const fst::string values[3] = { "c", "d", "e" };
+            REQUIRE_EQ(rb.push_n(values, 3), 3);
+
+            fst::string out[4];
+            REQUIRE_EQ(rb.pop_n(out, 4), 4);
+            REQUIRE_EQ(out[0], "b");
+            REQUIRE_EQ(out[3], "e");
+
+            // Values left in the buffer are destroyed with it.
+            REQUIRE(rb.emplace("a long string that is never popped out of the buffer"));
+        }
+
+        TEST_SECTION("threads")
+        {
+            constexpr uint32_t count = 1 << 18;
+            fst::async::spsc_ring_buffer<uint32_t> rb(256);
+            uint64_t sum = 0;
+            bool ordered = true;
+
+            fst::async::thread consumer(
+                [&]()
+                {
+                    uint32_t expected = 0;
+                    uint32_t buffer[64];
+                    while (expected < count)
+                    {
+                        const size_t n = or_yield(rb.pop_n(buffer, 64));
+                        for (size_t i = 0; i < n; i++)
+                        {
+                            ordered = ordered && buffer[i] == expected;
+                            sum += buffer[i];
+                            expected++;
+                        }
+                    }
+                });
+
+            uint32_t buffer[37];
+            for (uint32_t i = 0; i < count;)
+            {
+                const uint32_t n = fst::minimum<uint32_t>(37, count - i);
+                for (uint32_t j = 0; j < n; j++)
+                {
+                    buffer[j] = i + j;
+                }
+
+                i += (uint32_t) or_yield(rb.push_n(buffer, n));
+            }
+
+            consumer.join();
+            REQUIRE(ordered);
+            REQUIRE_EQ(sum, (uint64_t) count * (count - 1) / 2);
+            REQUIRE(rb.empty());
+        }
+
+        TEST_SECTION("audio_bus")
+        {
+            // The bus only points to the channels, the samples are never copied.
+            constexpr uint32_t block_count = 64;
+            constexpr uint32_t block_size = 128;
+            fst::vector<float> samples;
+            samples.resize(block_count * block_size * 2);
+
+            fst::vector<float*> channels;
+            for (uint32_t i = 0; i < block_count * 2; i++)
+            {
+                channels.push_back(samples.data() + i * block_size);
+            }
+
+            fst::async::spsc_ring_buffer<fst::audio_bus<float>> rb(8);
+            double total = 0;
+
+            fst::async::thread worker(
+                [&]()
+                {
+                    fst::audio_bus<float> buses[4];
+                    for (uint32_t received = 0; received < block_count;)
+                    {
+                        const size_t n = or_yield(rb.pop_n(buses, 4));
+                        for (size_t i = 0; i < n; i++)
+                        {
+                            for (uint32_t c = 0; c < buses[i].channel_size(); c++)
+                            {
+                                for (uint32_t s = 0; s < buses[i].buffer_size(); s++)
+                                {
+                                    total += buses[i][c][s];
+                                }
+                            }
+                        }
+
+                        received += (uint32_t) n;
+                    }
+                });
+
+            for (uint32_t b = 0; b < block_count; b++)
+            {
+                float* const* bus_channels = channels.data() + b * 2;
+                for (uint32_t s = 0; s < block_size; s++)
+                {
+                    bus_channels[0][s] = 1.0f;
+                    bus_channels[1][s] = 2.0f;
+                }
+
+                const fst::audio_bus<float> bus(bus_channels, 2, block_size);
+                while (!or_yield(rb.push(bus))) {}
+            }
+
+            worker.join();
+            REQUIRE_EQ(total, 3.0 * block_count * block_size);
+        }
+    }
+
+    TEST_CASE("fst::async::mpmc_ring_buffer", "[async]")
+    {
+        TEST_SECTION("push and pop")
+        {
+            fst::async::mpmc_ring_buffer<int> rb(4);
+            REQUIRE_EQ(rb.capacity(), 4);
+
+            for (int lap = 0; lap < 3; lap++)
+            {
+                for (int i = 0; i < 4; i++)
+                {
+                    REQUIRE(rb.push(i));
+                }
+
+                REQUIRE_FALSE(rb.push(4));
+                REQUIRE_EQ(rb.size(), 4);
+
+                for (int i = 0; i < 4; i++)
+                {
+                    int value = -1;
+                    REQUIRE(rb.pop(value));
+                    REQUIRE_EQ(value, i);
+                }
+
+                int value;
+                REQUIRE_FALSE(rb.pop(value));
+            }
+        }
+
+        TEST_SECTION("push_n and pop_n")
+        {
+            fst::async::mpmc_ring_buffer<fst::string> rb(8);
+            const fst::string values[5] = { "a", "b", "c", "d", "e" };
+
+            REQUIRE_EQ(rb.push_n(values, 5), 5);
+            REQUIRE_EQ(rb.push_n(values, 5), 3);
+            REQUIRE_EQ(rb.push_n(values, 5), 0);
+
+            fst::string out[8];
+            REQUIRE_EQ(rb.pop_n(out, 6), 6);
+            REQUIRE_EQ(out[0], "a");
+            REQUIRE_EQ(out[5], "a");
+            REQUIRE_EQ(rb.pop_n(out, 6), 2);
+            REQUIRE_EQ(out[1], "c");
+            REQUIRE_EQ(rb.pop_n(out, 6), 0);
+
+            REQUIRE(rb.emplace("a long string that is never popped out of the buffer"));
+        }
+
+        TEST_SECTION("threads")
+        {
+            constexpr uint32_t thread_count = 4;
+            constexpr uint32_t count_per_thread = 1 << 16;
+            fst::async::mpmc_ring_buffer<uint32_t> rb(128);
+            fst::atomic<uint64_t> sum = 0;
+            fst::atomic<uint32_t> received = 0;
+
+            auto producer = [&rb](uint32_t t)
+            {
+                return [&rb, t]()
+                {
+                    uint32_t buffer[8];
+                    for (uint32_t i = 0; i < count_per_thread;)
+                    {
+                        const uint32_t n = fst::minimum<uint32_t>(1 + (i % 8), count_per_thread - i);
+                        for (uint32_t j = 0; j < n; j++)
+                        {
+                            buffer[j] = t * count_per_thread + i + j;
+                        }
+
+                        i += (uint32_t) or_yield(rb.push_n(buffer, n));
+                    }
+                };
+            };
+
+            auto consumer = [&rb, &sum, &received](bool batch)
+            {
+                return [&rb, &sum, &received, batch]()
+                {
+                    uint32_t buffer[8];
+                    uint64_t local = 0;
+                    while (received.load() < thread_count * count_per_thread)
+                    {
+                        const size_t n = or_yield(batch ? rb.pop_n(buffer, 8) : rb.pop(buffer[0]));
+                        for (size_t i = 0; i < n; i++)
+                        {
+                            local += buffer[i];
+                        }
+                        received.fetch_add((uint32_t) n);
+                    }
+
+                    sum.fetch_add(local);
+                };
+            };
+
+            {
+                fst::async::thread p0(producer(0));
+                fst::async::thread p1(producer(1));
+                fst::async::thread p2(producer(2));
+                fst::async::thread p3(producer(3));
+                fst::async::thread c0(consumer(false));
+                fst::async::thread c1(consumer(true));
+                fst::async::thread c2(consumer(false));
+                fst::async::thread c3(consumer(true));
+            }
+
+            const uint64_t total = (uint64_t) thread_count * count_per_thread;
+            REQUIRE_EQ(received.load(), total);
+            REQUIRE_EQ(sum.load(), total * (total - 1) / 2);
+            REQUIRE(rb.empty());
+        }
+    }
+
+    BENCH_CASE("fst::async::ring_buffer", "[async][bench]")
+    {
+        constexpr uint32_t count = 1 << 18;
+
+        auto transfer = [](auto& rb, size_t batch)
+        {
+            uint64_t sum = 0;
+            fst::async::thread consumer(
+                [&]()
+                {
+                    uint32_t buffer[64];
+                    for (uint32_t received = 0; received < count;)
+                    {
+                        const size_t n = or_yield(rb.pop_n(buffer, batch));
+                        for (size_t i = 0; i < n; i++)
+                        {
+                            sum += buffer[i];
+                        }
+                        received += (uint32_t) n;
+                    }
+                });
+
+            uint32_t buffer[64];
+            for (uint32_t i = 0; i < count;)
+            {
+                const uint32_t n = fst::minimum<uint32_t>((uint32_t) batch, count - i);
+                for (uint32_t j = 0; j < n; j++)
+                {
+                    buffer[j] = i + j;
+                }
+                i += (uint32_t) or_yield(rb.push_n(buffer, n));
+            }
+
+            consumer.join();
+            return sum;
+        };
+
+        fst::async::spsc_ring_buffer<uint32_t> spsc(1024);
+        fst::async::mpmc_ring_buffer<uint32_t> mpmc(1024);
+
+        CATCH_BENCHMARK("spsc 1") { return transfer(spsc, 1); };
+        CATCH_BENCHMARK("spsc 64") { return transfer(spsc, 64); };
+        CATCH_BENCHMARK("mpmc 1") { return transfer(mpmc, 1); };
+        CATCH_BENCHMARK("mpmc 64") { return transfer(mpmc, 64); };
+    }
+} // namespace
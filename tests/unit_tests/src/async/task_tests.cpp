@@ -0,0 +1,263 @@
+#include "utest.h"
+#include "fst/async/io_reactor.h"
+#include "fst/async/task.h"
+#include "fst/async/thread_pool.h"
+#include "fst/memory_pool.h"
+#include "fst/string.h"
+#include "fst/vector.h"
+
+#if !__FST_WINDOWS__
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // Forwards to a forward_memory_pool and counts the frames.
+    struct counting_pool
+    {
+        fst::forward_memory_pool<> pool;
+        size_t allocated = 0;
+        size_t deallocated = 0;
+
+        void* aligned_allocate(size_t size, size_t alignment) noexcept
+        {
+            allocated++;
+            return pool.aligned_allocate(size, alignment);
+        }
+
+        void aligned_deallocate(void* ptr) noexcept
+        {
+            deallocated++;
+            pool.aligned_deallocate(ptr);
+        }
+    };
+
+    fst::async::task<int> add(int a, int b)
+    {
+        co_return a + b;
+    }
+
+    fst::async::task<int> sum_to(int n)
+    {
+        int total = 0;
+        for (int i = 1; i <= n; i++)
+        {
+            total = co_await add(total, i);
+        }
+        co_return total;
+    }
+
+    fst::async::task<fst::string> concat(fst::async::frame_allocator_arg_t, [[maybe_unused]] counting_pool& pool, fst::string a, fst::string b)
+    {
+        co_return a + b;
+    }
+
+    fst::async::task<> increment(fst::async::frame_allocator_arg_t, [[maybe_unused]] fst::forward_memory_pool<>& pool, int& value)
+    {
+        value++;
+        co_return;
+    }
+
+    fst::async::task<size_t> on_worker(fst::async::thread_pool& pool)
+    {
+        co_await fst::async::schedule_on(pool);
+        co_return pool.current_worker_index();
+    }
+
+    fst::async::generator<int> iota(int count)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            co_yield i;
+        }
+    }
+
+    fst::async::generator<float> squares(fst::async::frame_allocator_arg_t, [[maybe_unused]] counting_pool& pool, fst::async::generator<int>& values)
+    {
+        for (int v : values)
+        {
+            co_yield (float) (v * v);
+        }
+    }
+
+    struct accumulator
+    {
+        int total = 0;
+
+        fst::async::task<int> add(fst::async::frame_allocator_arg_t, [[maybe_unused]] counting_pool& pool, int v)
+        {
+            total += v;
+            co_return total;
+        }
+    };
+
+    TEST_CASE("fst::async::task", "[async]")
+    {
+        TEST_SECTION("values")
+        {
+            REQUIRE_EQ(fst::async::sync_wait(add(2, 3)), 5);
+            REQUIRE_EQ(fst::async::sync_wait(sum_to(100)), 5050);
+
+            fst::async::task<int> t = add(1, 1);
+            REQUIRE(t.is_valid());
+            REQUIRE_FALSE(t.is_done());
+
+            fst::async::task<int> moved = static_cast<fst::async::task<int>&&>(t);
+            REQUIRE_FALSE(t.is_valid());
+            REQUIRE_EQ(fst::async::sync_wait(static_cast<fst::async::task<int>&&>(moved)), 2);
+
+            // Never started, the frame is destroyed with the task.
+            fst::async::task<int> unused = add(1, 2);
+        }
+
+        TEST_SECTION("frame allocator")
+        {
+            counting_pool pool;
+            {
+                fst::async::task<fst::string> t = concat(fst::async::frame_allocator_arg, pool, "a long string that doesn't fit the small buffer", "!");
+                REQUIRE_EQ(pool.allocated, 1);
+                REQUIRE_EQ(fst::async::sync_wait(static_cast<fst::async::task<fst::string>&&>(t)), "a long string that doesn't fit the small buffer!");
+            }
+            REQUIRE_EQ(pool.deallocated, 1);
+
+            accumulator acc;
+            REQUIRE_EQ(fst::async::sync_wait(acc.add(fst::async::frame_allocator_arg, pool, 3)), 3);
+            REQUIRE_EQ(fst::async::sync_wait(acc.add(fst::async::frame_allocator_arg, pool, 4)), 7);
+            REQUIRE_EQ(pool.allocated, 3);
+            REQUIRE_EQ(pool.deallocated, 3);
+
+            fst::forward_memory_pool<> fpool;
+            int value = 0;
+            for (int i = 0; i < 10; i++)
+            {
+                fst::async::sync_wait(increment(fst::async::frame_allocator_arg, fpool, value));
+            }
+            REQUIRE_EQ(value, 10);
+        }
+
+        TEST_SECTION("thread pool")
+        {
+            fst::async::thread_pool pool(2);
+            REQUIRE_EQ(pool.current_worker_index(), fst::async::thread_pool::npos);
+
+            const size_t index = fst::async::sync_wait(on_worker(pool));
+            REQUIRE(index < pool.size());
+        }
+    }
+
+    TEST_CASE("fst::async::generator", "[async]")
+    {
+        TEST_SECTION("sequence")
+        {
+            int expected = 0;
+            for (int v : iota(10))
+            {
+                REQUIRE_EQ(v, expected++);
+            }
+            REQUIRE_EQ(expected, 10);
+
+            // Stops early, the suspended frame is destroyed with the generator.
+            fst::async::generator<int> gen = iota(1000);
+            for (int v : gen)
+            {
+                if (v == 5) { break; }
+            }
+
+            for (int v : iota(0))
+            {
+                REQUIRE(false);
+                (void) v;
+            }
+        }
+
+        TEST_SECTION("pipeline")
+        {
+            counting_pool pool;
+            fst::async::generator<int> values = iota(5);
+            float total = 0;
+            for (float v : squares(fst::async::frame_allocator_arg, pool, values))
+            {
+                total += v;
+            }
+
+            REQUIRE_EQ(total, 30.0f);
+            REQUIRE_EQ(pool.allocated, 1);
+            REQUIRE_EQ(pool.deallocated, 1);
+        }
+    }
+
+#if !__FST_WINDOWS__
+    fst::async::task<size_t> read_when_ready(fst::async::io_reactor& reactor, int fd, char* buffer, size_t size)
+    {
+        co_await reactor.readable(fd);
+        co_return (size_t) ::read(fd, buffer, size);
+    }
+
+    TEST_CASE("fst::async::io_reactor", "[async]")
+    {
+        fst::async::io_reactor reactor;
+        REQUIRE_EQ(reactor.pending(), 0);
+
+        int fds[2];
+        REQUIRE_EQ(::pipe(fds), 0);
+
+        REQUIRE_FALSE(fst::async::io_reactor::is_ready(fds[0], fst::async::io_reactor::io_event::readable));
+        REQUIRE(fst::async::io_reactor::is_ready(fds[1], fst::async::io_reactor::io_event::writable));
+
+        char buffer[16] = {};
+        fst::async::thread writer(
+            [&]()
+            {
+                while (reactor.pending() == 0)
+                {
+                    fst::async::this_thread::yield();
+                }
+
+                REQUIRE_EQ(::write(fds[1], "ready", 5), 5);
+            });
+
+        REQUIRE_EQ(fst::async::sync_wait(read_when_ready(reactor, fds[0], buffer, sizeof(buffer))), 5);
+        writer.join();
+        REQUIRE_EQ(fst::string_view(buffer, 5), "ready");
+        REQUIRE_EQ(reactor.pending(), 0);
+
+        // Already readable, doesn't go through the reactor thread.
+        REQUIRE_EQ(::write(fds[1], "again", 5), 5);
+        REQUIRE_EQ(fst::async::sync_wait(read_when_ready(reactor, fds[0], buffer, sizeof(buffer))), 5);
+
+        ::close(fds[0]);
+        ::close(fds[1]);
+    }
+#endif // !__FST_WINDOWS__
+
+    fst::async::task<int> leaf() { co_return 1; }
+
+    fst::async::task<int> leaf_pool(fst::async::frame_allocator_arg_t, [[maybe_unused]] fst::forward_memory_pool<>& pool) { co_return 1; }
+
+    BENCH_CASE("fst::async::task frame allocation", "[async][bench]")
+    {
+        constexpr int count = 1 << 14;
+        fst::forward_memory_pool<> pool;
+
+        CATCH_BENCHMARK("async_memory_category")
+        {
+            int total = 0;
+            for (int i = 0; i < count; i++)
+            {
+                total += fst::async::sync_wait(leaf());
+            }
+            return total;
+        };
+
+        CATCH_BENCHMARK("forward_memory_pool")
+        {
+            int total = 0;
+            fst::scoped_arena<fst::forward_memory_pool<>> arena(pool);
+            for (int i = 0; i < count; i++)
+            {
+                total += fst::async::sync_wait(leaf_pool(fst::async::frame_allocator_arg, pool));
+            }
+            return total;
+        };
+    }
+} // namespace
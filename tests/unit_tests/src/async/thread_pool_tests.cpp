@@ -0,0 +1,147 @@
+#include "utest.h"
+#include "fst/async/thread_pool.h"
+#include "fst/atomic.h"
+#include "fst/vector.h"
+
+namespace
+{
+    inline uint64_t fib(uint64_t n)
+    {
+        return n < 2 ? n : fib(n - 1) + fib(n - 2);
+    }
+
+    // Recursively splits the work, every split is pushed in the worker's own deque and can be stolen.
+    inline void parallel_count(fst::async::thread_pool& pool, fst::atomic<uint32_t>& counter, uint32_t depth)
+    {
+        if (depth == 0)
+        {
+            ++counter;
+            return;
+        }
+
+        fst::async::thread_pool::task_handle left = pool.submit([&pool, &counter, depth]() { parallel_count(pool, counter, depth - 1); });
+        parallel_count(pool, counter, depth - 1);
+        pool.wait(left);
+    }
+
+    TEST_CASE("fst::async::thread_pool", "[async]")
+    {
+        TEST_SECTION("submit and wait")
+        {
+            fst::async::thread_pool pool(4);
+            REQUIRE_EQ(pool.size(), 4);
+            REQUIRE_EQ(pool.current_worker_index(), fst::async::thread_pool::npos);
+
+            fst::atomic<uint32_t> counter = 0;
+            for (size_t i = 0; i < 1000; i++)
+            {
+                pool.submit([&counter]() { ++counter; });
+            }
+
+            pool.wait();
+            REQUIRE_EQ(counter.load(), 1000);
+        }
+
+        TEST_SECTION("task handle")
+        {
+            fst::async::thread_pool pool(2);
+
+            uint64_t result = 0;
+            fst::async::thread_pool::task_handle handle = pool.submit([&result]() { result = fib(20); });
+            REQUIRE(handle.is_valid());
+
+            pool.wait(handle);
+            REQUIRE(handle.is_done());
+            REQUIRE_EQ(result, 6765);
+        }
+
+        TEST_SECTION("nested submit")
+        {
+            fst::async::thread_pool pool(4);
+            fst::atomic<uint32_t> counter = 0;
+
+            pool.submit([&pool, &counter]() { parallel_count(pool, counter, 10); });
+            pool.wait();
+            REQUIRE_EQ(counter.load(), 1024);
+        }
+
+        TEST_SECTION("worker index")
+        {
+            fst::async::thread_pool pool(3);
+            fst::atomic<uint32_t> valid = 0;
+
+            for (size_t i = 0; i < 64; i++)
+            {
+                pool.submit(
+                    [&pool, &valid]()
+                    {
+                        // The waiting thread also runs tasks.
+                        const size_t index = pool.current_worker_index();
+                        if (index < pool.size() || index == fst::async::thread_pool::npos) { ++valid; }
+                    });
+            }
+
+            pool.wait();
+            REQUIRE_EQ(valid.load(), 64);
+        }
+
+        TEST_SECTION("release captures")
+        {
+            fst::atomic<uint32_t> released = 0;
+
+            struct capture
+            {
+                fst::atomic<uint32_t>* released;
+                capture(fst::atomic<uint32_t>* r) noexcept
+                    : released(r)
+                {}
+                capture(capture&& c) noexcept
+                    : released(fst::exchange(c.released, nullptr))
+                {}
+                ~capture() noexcept
+                {
+                    if (released) { ++*released; }
+                }
+                void operator()() const noexcept {}
+            };
+
+            {
+                fst::async::thread_pool pool(2);
+                for (size_t i = 0; i < 16; i++)
+                {
+                    pool.submit(capture(&released));
+                }
+                pool.join();
+                REQUIRE_EQ(released.load(), 16);
+            }
+        }
+    }
+
+    BENCH_CASE("fst::async::thread_pool scaling", "[async][bench]")
+    {
+        constexpr size_t task_count = 256;
+        const unsigned int max_threads = fst::async::thread::hardware_concurrency();
+
+        // 1, 2, 4, ... up to every hardware thread.
+        for (unsigned int thread_count = 1;; thread_count = fst::minimum(thread_count * 2, max_threads))
+        {
+            fst::async::thread_pool pool(thread_count);
+            fst::vector<uint64_t> results;
+            results.resize(task_count, 0);
+
+            CATCH_BENCHMARK(("fib(24) x 256 - " + std::to_string(thread_count) + " threads").c_str())
+            {
+                for (size_t i = 0; i < task_count; i++)
+                {
+                    uint64_t* r = results.data() + i;
+                    pool.submit([r]() { *r = fib(24); });
+                }
+
+                pool.wait();
+                return results[0];
+            };
+
+            if (thread_count == max_threads) { break; }
+        }
+    }
+} // namespace
@@ -1,5 +1,6 @@
 #include "utest.h"
 #include "fst/async/thread.h"
+#include "fst/atomic.h"
 #include "fst/string.h"
 #include "fst/unicode.h"
 namespace
@@ -76,4 +77,131 @@ namespace
 
         fst::async::thread t3(&callback);
     }
+
+    TEST_CASE("fst::async::thread", "[async]")
+    {
+        TEST_SECTION("join")
+        {
+            fst::atomic<uint32_t> value = 0;
+            fst::async::thread t([&value]() { value.store(32); });
+            REQUIRE(t.joinable());
+
+            t.join();
+            REQUIRE_FALSE(t.joinable());
+            REQUIRE_EQ(value.load(), 32);
+
+            // Joining twice is a no-op.
+            t.join();
+        }
+
+        TEST_SECTION("default")
+        {
+            fst::async::thread t;
+            REQUIRE_FALSE(t.joinable());
+            REQUIRE(t.get_id() == fst::async::thread::id());
+            REQUIRE_EQ(t.native_handle(), nullptr);
+        }
+
+        TEST_SECTION("id")
+        {
+            fst::async::thread::id inner_id;
+            fst::async::thread t([&inner_id]() { inner_id = fst::async::this_thread::get_id(); });
+            const fst::async::thread::id outer_id = t.get_id();
+            t.join();
+
+            REQUIRE(outer_id == inner_id);
+            REQUIRE(inner_id != fst::async::this_thread::get_id());
+        }
+
+        TEST_SECTION("move")
+        {
+            fst::atomic<uint32_t> count = 0;
+            fst::async::thread a([&count]() { ++count; });
+            fst::async::thread b(fst::move(a));
+            REQUIRE_FALSE(a.joinable());
+            REQUIRE(b.joinable());
+
+            // Joins b before taking the new thread.
+            b = fst::async::thread([&count]() { ++count; });
+            REQUIRE(b.joinable());
+
+            fst::async::thread c;
+            c.swap(b);
+            REQUIRE_FALSE(b.joinable());
+            REQUIRE(c.joinable());
+
+            c.join();
+            REQUIRE_EQ(count.load(), 2);
+        }
+
+        TEST_SECTION("detach")
+        {
+            fst::atomic<uint32_t> released = 0;
+            fst::atomic<bool> done = false;
+
+            struct capture
+            {
+                fst::atomic<uint32_t>* released;
+                fst::atomic<bool>* done;
+
+                capture(fst::atomic<uint32_t>* r, fst::atomic<bool>* d) noexcept
+                    : released(r)
+                    , done(d)
+                {}
+
+                capture(capture&& c) noexcept
+                    : released(fst::exchange(c.released, nullptr))
+                    , done(c.done)
+                {}
+
+                ~capture() noexcept
+                {
+                    if (released) { ++*released; }
+                }
+
+                void operator()() const noexcept { done->store(true); }
+            };
+
+            {
+                fst::async::thread t(capture(&released, &done));
+                t.detach();
+                REQUIRE_FALSE(t.joinable());
+            }
+
+            while (released.load() == 0)
+            {
+                fst::async::this_thread::sleep_for_us(100);
+            }
+
+            REQUIRE(done.load());
+            REQUIRE_EQ(released.load(), 1);
+        }
+
+        TEST_SECTION("name and affinity")
+        {
+            fst::atomic<bool> stop = false;
+            fst::async::thread t(
+                [&stop]()
+                {
+                    while (!stop.load())
+                    {
+                        fst::async::this_thread::yield();
+                    }
+                });
+
+            // Not supported everywhere, it only has to be safe to call.
+            (void) t.set_name("fst_thread_with_a_long_name");
+            (void) t.pin_to_cpu(0);
+
+            // Past 64 cpus doesn't assert, cpus that don't exist fail.
+            REQUIRE_FALSE(t.pin_to_cpu(4096));
+            (void) fst::async::this_thread::set_name("fst_test");
+
+            stop.store(true);
+            t.join();
+
+            REQUIRE_FALSE(t.set_name("fst_joined"));
+            REQUIRE(fst::async::thread::hardware_concurrency() >= 1);
+        }
+    }
 } // namespace
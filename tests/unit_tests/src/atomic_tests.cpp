@@ -1,5 +1,6 @@
 #include "utest.h"
 #include "fst/atomic.h"
+#include "fst/async/thread.h"
 
 
 namespace
@@ -11,4 +12,57 @@ namespace
         a = 78;
 
     }
+
+    TEST_CASE("fst::atomic wait", "[core]")
+    {
+        TEST_SECTION("changed value returns")
+        {
+            fst::atomic<uint32_t> a = 2;
+            a.wait(1);
+            REQUIRE_FALSE(a.wait_for_us(2, 1000));
+            REQUIRE(a.wait_for_us(1, 1000));
+        }
+
+        TEST_SECTION("notify one")
+        {
+            fst::atomic<uint32_t> a = 0;
+            fst::atomic<uint32_t> result = 0;
+
+            fst::async::thread t(
+                [&]()
+                {
+                    a.wait(0);
+                    result.store(a.load());
+                });
+
+            fst::async::this_thread::sleep_for_us(1000);
+            a.store(5);
+            a.notify_one();
+            t.join();
+            REQUIRE_EQ(result.load(), 5);
+        }
+
+        TEST_SECTION("notify all")
+        {
+            // Sizes other than 4 bytes go through the shared wait buckets.
+            fst::atomic<uint64_t> a = 0;
+            fst::atomic<uint8_t> b = 0;
+            fst::atomic<uint32_t> count = 0;
+
+            fst::async::thread t1([&]() { a.wait(0), ++count; });
+            fst::async::thread t2([&]() { a.wait(0), ++count; });
+            fst::async::thread t3([&]() { b.wait(0), ++count; });
+
+            fst::async::this_thread::sleep_for_us(1000);
+            a.store(1);
+            a.notify_all();
+            b.store(1);
+            b.notify_one();
+
+            t1.join();
+            t2.join();
+            t3.join();
+            REQUIRE_EQ(count.load(), 3);
+        }
+    }
 } // namespace
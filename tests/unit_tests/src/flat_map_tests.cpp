@@ -0,0 +1,219 @@
+#include "utest.h"
+#include "fst/flat_map.h"
+#include "fst/flat_set.h"
+#include "fst/string.h"
+#include <map>
+
+namespace
+{
+    TEST_CASE("fst::flat_map", "[core]")
+    {
+        TEST_SECTION("insert and find")
+        {
+            fst::flat_map<int, int> map;
+            for (int i = 0; i < 200; i++)
+            {
+                const int key = (i * 37) % 200;
+                REQUIRE(map.insert(key, key * 2));
+            }
+
+            REQUIRE_EQ(map.size(), 200);
+            REQUIRE_FALSE(map.insert(10, 0));
+            REQUIRE_EQ(*map.find(10), 20);
+
+            for (int i = 0; i < 200; i++)
+            {
+                REQUIRE_EQ(map.keys()[(size_t) i], i);
+                REQUIRE_EQ(map.values()[(size_t) i], i * 2);
+                REQUIRE_EQ(map.key(map.find(i)), i);
+            }
+
+            REQUIRE_EQ(map.find(200), map.end());
+            REQUIRE_EQ(map.find(-1), map.end());
+            REQUIRE_FALSE(map.contains(1000));
+        }
+
+        TEST_SECTION("bounds")
+        {
+            fst::flat_map<int, int> map;
+            REQUIRE_EQ(map.lower_bound(5), map.end());
+            REQUIRE_EQ(map.upper_bound(5), map.end());
+
+            for (int i = 0; i < 100; i += 10)
+            {
+                map[i] = i;
+            }
+
+            REQUIRE_EQ(map.key(map.lower_bound(20)), 20);
+            REQUIRE_EQ(map.key(map.lower_bound(21)), 30);
+            REQUIRE_EQ(map.key(map.upper_bound(20)), 30);
+            REQUIRE_EQ(map.lower_bound(-5), map.begin());
+            REQUIRE_EQ(map.upper_bound(90), map.end());
+        }
+
+        TEST_SECTION("operator[] and erase")
+        {
+            fst::flat_map<int, int> map;
+            for (int i = 0; i < 100; i++)
+            {
+                map[i % 10] += 1;
+            }
+
+            REQUIRE_EQ(map.size(), 10);
+            REQUIRE_EQ(map[3], 10);
+
+            REQUIRE_EQ(map.erase(3), 1);
+            REQUIRE_EQ(map.erase(3), 0);
+            REQUIRE_EQ(map.erase(map.find(9)), 1);
+            REQUIRE_EQ(map.erase(map.find(0)), 1);
+            REQUIRE_EQ(map.size(), 7);
+            REQUIRE_EQ(map.keys().front(), 1);
+            REQUIRE_EQ(map.keys().back(), 8);
+        }
+
+        TEST_SECTION("insert_range")
+        {
+            fst::flat_map<int, int> map;
+            map[5] = -5;
+            map[100] = -100;
+
+            // Unsorted, with repeated keys and a key that is already in the map.
+            fst::vector<int> keys;
+            fst::vector<int> values;
+            for (int i = 0; i < 1000; i++)
+            {
+                const int key = (i * 7919) % 500;
+                keys.push_back(key);
+                values.push_back(i);
+            }
+
+            map.insert_range(keys.data(), values.data(), keys.size());
+            REQUIRE_EQ(map.size(), 500);
+            REQUIRE_EQ(*map.find(5), -5);
+            REQUIRE_EQ(*map.find(100), -100);
+
+            std::map<int, int> expected;
+            expected[5] = -5;
+            expected[100] = -100;
+            for (size_t i = 0; i < keys.size(); i++)
+            {
+                expected.emplace(keys[i], values[i]);
+            }
+
+            size_t index = 0;
+            for (const auto& it : expected)
+            {
+                REQUIRE_EQ(map.keys()[index], it.first);
+                REQUIRE_EQ(map.values()[index], it.second);
+                index++;
+            }
+
+            map.insert_range(keys.data(), values.data(), 0);
+            REQUIRE_EQ(map.size(), 500);
+        }
+
+        TEST_SECTION("string keys")
+        {
+            fst::flat_map<fst::string, int, alignof(int), fst::default_memory_zone, fst::default_memory_category, fst::less<>> map;
+            map.insert(fst::string("banana"), 2);
+            map.insert(fst::string("apple"), 1);
+            map.insert(fst::string("cherry"), 3);
+
+            REQUIRE_EQ(map.keys().front(), "apple");
+            REQUIRE_EQ(*map.find(fst::string_view("banana")), 2);
+            REQUIRE(map.contains(fst::string_view("cherry")));
+            REQUIRE_EQ(map.erase(fst::string_view("apple")), 1);
+            REQUIRE_EQ(map.keys().front(), "banana");
+        }
+    }
+
+    TEST_CASE("fst::flat_set", "[core]")
+    {
+        fst::flat_set<int> set;
+        REQUIRE(set.insert(3));
+        REQUIRE(set.insert(1));
+        REQUIRE(set.insert(2));
+        REQUIRE_FALSE(set.insert(2));
+        REQUIRE_EQ(set.size(), 3);
+        REQUIRE_EQ(set[0], 1);
+        REQUIRE_EQ(set[2], 3);
+
+        const int keys[] = { 9, 4, 4, 2, 7, 0, 9 };
+        set.insert_range(keys, 7);
+        REQUIRE_EQ(set.size(), 7);
+
+        const int expected[] = { 0, 1, 2, 3, 4, 7, 9 };
+        for (size_t i = 0; i < 7; i++)
+        {
+            REQUIRE_EQ(set[i], expected[i]);
+        }
+
+        REQUIRE(set.contains(7));
+        REQUIRE_FALSE(set.contains(8));
+        REQUIRE_EQ(*set.lower_bound(5), 7);
+        REQUIRE_EQ(*set.upper_bound(7), 9);
+        REQUIRE_EQ(set.erase(4), 1);
+        REQUIRE_EQ(set.erase(set.find(0)), 1);
+        REQUIRE_EQ(set.front(), 1);
+        REQUIRE_EQ(set.size(), 5);
+    }
+
+    BENCH_CASE("fst::flat_map lookup", "[core][bench]")
+    {
+        constexpr uint32_t count = 4096;
+
+        fst::vector<uint32_t> keys;
+        fst::vector<uint32_t> values;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            keys.push_back(i * 2654435761u);
+            values.push_back(i);
+        }
+
+        fst::flat_map<uint32_t, uint32_t> map;
+        map.insert_range(keys.data(), values.data(), count);
+
+        std::map<uint32_t, uint32_t> std_map;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            std_map[keys[i]] = i;
+        }
+
+        CATCH_BENCHMARK("fst::flat_map")
+        {
+            uint64_t sum = 0;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                sum += *map.find(keys[i]);
+            }
+            return sum;
+        };
+
+        CATCH_BENCHMARK("std::map")
+        {
+            uint64_t sum = 0;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                sum += std_map.find(keys[i])->second;
+            }
+            return sum;
+        };
+
+        CATCH_BENCHMARK("fst::flat_map insert")
+        {
+            fst::flat_map<uint32_t, uint32_t> m;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                m.insert(keys[i], i);
+            }
+            return m.size();
+        };
+
+        CATCH_BENCHMARK("fst::flat_map insert_range")
+        {
+            fst::flat_map<uint32_t, uint32_t> m;
+            m.insert_range(keys.data(), values.data(), count);
+            return m.size();
+        };
+    }
+} // namespace
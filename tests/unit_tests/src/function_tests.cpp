@@ -84,4 +84,187 @@ namespace
         //fst::array_range<float> rrarray(array);
         //REQUIRE(rrarray.size() == 8);
     }
+    TEST_CASE("fst::inplace_function", "[core]")
+    {
+        TEST_SECTION("call")
+        {
+            fst::inplace_function<int(int)> empty;
+            REQUIRE_FALSE(empty);
+
+            int offset = 10;
+            fst::inplace_function<int(int)> f = [offset](int a) { return a + offset; };
+            REQUIRE(f);
+            REQUIRE_EQ(f(5), 15);
+
+            fst::inplace_function<void(int)> p = &call_fct;
+            p(3);
+
+            f = nullptr;
+            REQUIRE_FALSE(f);
+
+            int calls = 0;
+            fst::inplace_function<void()> discard = [&calls]() { return ++calls; };
+            discard();
+            REQUIRE_EQ(calls, 1);
+        }
+
+        TEST_SECTION("move only")
+        {
+            static int alive = 0;
+
+            struct counted
+            {
+                fst::unique_ptr<int> value;
+
+                counted(int v) noexcept
+                    : value(fst::make_unique<int>(v))
+                {
+                    alive++;
+                }
+
+                counted(counted&& other) noexcept
+                    : value(static_cast<fst::unique_ptr<int>&&>(other.value))
+                {
+                    alive++;
+                }
+
+                ~counted() noexcept { alive--; }
+
+                int operator()() const noexcept { return *value; }
+            };
+
+            {
+                fst::inplace_function<int(), 16> f = counted(42);
+                REQUIRE_EQ(alive, 1);
+                REQUIRE_EQ(f(), 42);
+
+                fst::inplace_function<int(), 16> g = static_cast<fst::inplace_function<int(), 16>&&>(f);
+                REQUIRE_FALSE(f);
+                REQUIRE_EQ(alive, 1);
+                REQUIRE_EQ(g(), 42);
+
+                f = static_cast<fst::inplace_function<int(), 16>&&>(g);
+                REQUIRE_EQ(f(), 42);
+                REQUIRE_EQ(alive, 1);
+
+                g = counted(7);
+                REQUIRE_EQ(alive, 2);
+                g.reset();
+                REQUIRE_EQ(alive, 1);
+            }
+
+            REQUIRE_EQ(alive, 0);
+        }
+
+        TEST_SECTION("reference return")
+        {
+            struct no_default
+            {
+                no_default(int v) noexcept
+                    : value(v)
+                {}
+
+                int value;
+            };
+
+            int value = 4;
+            fst::inplace_function<int&()> f = [&value]() -> int& { return value; };
+            f() = 8;
+            REQUIRE_EQ(value, 8);
+
+            fst::inplace_function<no_default(int)> g = [](int v) { return no_default(v); };
+            REQUIRE_EQ(g(5).value, 5);
+
+            g.reset();
+            REQUIRE_FALSE(g);
+        }
+
+        TEST_SECTION("capacity")
+        {
+            char data[60] = {};
+            data[59] = 3;
+            fst::inplace_function<int(), 64> f = [data]() { return (int) data[59]; };
+            REQUIRE_EQ(f(), 3);
+            REQUIRE_EQ(sizeof(f), 64 + 2 * sizeof(void*));
+        }
+    }
+
+    TEST_CASE("fst::function_ref", "[core]")
+    {
+        auto apply = [](fst::function_ref<int(int)> fct, int value) { return fct(value); };
+
+        int factor = 3;
+        REQUIRE_EQ(apply([&](int a) { return a * factor; }, 5), 15);
+
+        auto add = [](int a) { return a + 1; };
+        REQUIRE_EQ(apply(add, 5), 6);
+
+        int (*pointer)(int) = [](int a) { return a - 1; };
+        REQUIRE_EQ(apply(pointer, 5), 4);
+
+        struct accumulator
+        {
+            int total = 0;
+            int operator()(int a) noexcept { return total += a; }
+        };
+
+        accumulator acc;
+        fst::function_ref<int(int)> ref = acc;
+        ref(2);
+        ref(3);
+        REQUIRE_EQ(acc.total, 5);
+
+        fst::function_ref<int(int)> copy = ref;
+        copy(1);
+        REQUIRE_EQ(acc.total, 6);
+
+        fst::function_ref<void(int)> fref = call_fct;
+        fref(1);
+
+        auto counter = [&acc](int a) { return acc(a); };
+        fst::function_ref<void(int)> discard = counter;
+        discard(4);
+        REQUIRE_EQ(acc.total, 10);
+    }
+
+    BENCH_CASE("fst::function call", "[core][bench]")
+    {
+        constexpr int count = 1 << 16;
+        int offset = 1;
+
+        auto lambda = [&offset](int a) noexcept { return a + offset; };
+        fst::function<int(int)> function([&offset](int a) noexcept { return a + offset; });
+        fst::inplace_function<int(int)> inplace = lambda;
+        fst::function_ref<int(int)> ref = lambda;
+
+        CATCH_BENCHMARK("fst::function")
+        {
+            int sum = 0;
+            for (int i = 0; i < count; i++)
+            {
+                sum = function(sum);
+            }
+            return sum;
+        };
+
+        CATCH_BENCHMARK("fst::inplace_function")
+        {
+            int sum = 0;
+            for (int i = 0; i < count; i++)
+            {
+                sum = inplace(sum);
+            }
+            return sum;
+        };
+
+        CATCH_BENCHMARK("fst::function_ref")
+        {
+            int sum = 0;
+            for (int i = 0; i < count; i++)
+            {
+                sum = ref(sum);
+            }
+            return sum;
+        };
+    }
 } // namespace
@@ -0,0 +1,207 @@
+#include "utest.h"
+#include "fst/hash.h"
+#include "fst/memory_range.h"
+#include "fst/stack_string.h"
+#include "fst/string.h"
+#include "fst/unordered_map.h"
+
+namespace
+{
+    template <size_t _Size>
+    constexpr uint64_t pattern_hash(uint64_t seed) noexcept
+    {
+        char buffer[_Size + 1] = {};
+        for (size_t i = 0; i < _Size; i++)
+        {
+            buffer[i] = (char) (i * 131 + 7);
+        }
+
+        return fst::hash_string(buffer, _Size, seed);
+    }
+
+    template <size_t _Size>
+    void check_pattern_hash() noexcept
+    {
+        // Compile time values go through the scalar path, runtime values through the simd one.
+        constexpr uint64_t expected = pattern_hash<_Size>(0);
+        constexpr uint64_t expected_seeded = pattern_hash<_Size>(42);
+
+        char buffer[_Size + 1] = {};
+        for (size_t i = 0; i < _Size; i++)
+        {
+            buffer[i] = (char) (i * 131 + 7);
+        }
+
+        REQUIRE_EQ(fst::hash_bytes(buffer, _Size), expected);
+        REQUIRE_EQ(fst::hash_bytes(buffer, _Size, 42), expected_seeded);
+        REQUIRE_NE(expected, expected_seeded);
+    }
+
+    size_t popcount(uint64_t v) noexcept
+    {
+        size_t count = 0;
+        for (; v; v &= v - 1)
+        {
+            count++;
+        }
+        return count;
+    }
+
+    TEST_CASE("fst::hash", "[core]")
+    {
+        TEST_SECTION("constexpr")
+        {
+            static_assert(fst::hash_string("abc") != fst::hash_string("abd"));
+            static_assert(fst::hash_string("abc") == fst::hash_string("abc", 3));
+            static_assert(fst::hash_string(u"abc") != fst::hash_string("abc"));
+
+            const char* str = "ok";
+            switch (fst::hash_string(str, 2))
+            {
+            case fst::hash_string("ko"): REQUIRE(false); break;
+            case fst::hash_string("ok"): REQUIRE(true); break;
+            default: REQUIRE(false); break;
+            }
+
+            // Every path: short, medium, three lanes, accumulator with and without a scramble.
+            check_pattern_hash<0>();
+            check_pattern_hash<1>();
+            check_pattern_hash<3>();
+            check_pattern_hash<4>();
+            check_pattern_hash<8>();
+            check_pattern_hash<16>();
+            check_pattern_hash<17>();
+            check_pattern_hash<48>();
+            check_pattern_hash<49>();
+            check_pattern_hash<200>();
+            check_pattern_hash<256>();
+            check_pattern_hash<257>();
+            check_pattern_hash<320>();
+            check_pattern_hash<1024>();
+            check_pattern_hash<1025>();
+            check_pattern_hash<2100>();
+        }
+
+        TEST_SECTION("wide characters")
+        {
+            const char16_t str[] = u"hash me";
+            REQUIRE_EQ(fst::hash_string(str, 7), fst::hash_bytes(str, 7 * sizeof(char16_t)));
+
+            constexpr uint64_t h = fst::hash_string(U"hash me");
+            const char32_t wstr[] = U"hash me";
+            REQUIRE_EQ(fst::hash_string(wstr, 7), h);
+        }
+
+        TEST_SECTION("lengths")
+        {
+            // Same bytes with different lengths, every prefix hashes differently.
+            uint8_t buffer[600] = {};
+            fst::unordered_map<uint64_t, size_t> seen;
+            for (size_t i = 0; i <= sizeof(buffer); i++)
+            {
+                REQUIRE(seen.insert(fst::hash_bytes(buffer, i), i));
+            }
+        }
+
+        TEST_SECTION("avalanche")
+        {
+            for (size_t size : { 8, 24, 64, 300, 2048 })
+            {
+                uint8_t buffer[2048];
+                for (size_t i = 0; i < size; i++)
+                {
+                    buffer[i] = (uint8_t) (i * 17);
+                }
+
+                const uint64_t h = fst::hash_bytes(buffer, size);
+                size_t total = 0;
+                size_t count = 0;
+
+                for (size_t i = 0; i < size * 8; i += 3)
+                {
+                    buffer[i / 8] ^= (uint8_t) (1u << (i % 8));
+                    const size_t flipped = popcount(h ^ fst::hash_bytes(buffer, size));
+                    buffer[i / 8] ^= (uint8_t) (1u << (i % 8));
+
+                    REQUIRE(flipped >= 8);
+                    total += flipped;
+                    count++;
+                }
+
+                // About half of the bits change.
+                const size_t average = total / count;
+                REQUIRE((average >= 28 && average <= 36));
+            }
+        }
+
+        TEST_SECTION("integers")
+        {
+            fst::unordered_map<uint64_t, int> seen;
+            for (int i = 0; i < 1000; i++)
+            {
+                REQUIRE(seen.insert(fst::hash<int>{}(i), i));
+            }
+
+            REQUIRE_EQ(fst::hash<float>{}(0.0f), fst::hash<float>{}(-0.0f));
+            REQUIRE_NE(fst::hash<uint64_t>{}(1), fst::hash<uint64_t>{}(2));
+            REQUIRE_NE(fst::hash_int(1), fst::hash_int(1, 1));
+            REQUIRE_NE(fst::hash_combine(1, 2), fst::hash_combine(2, 1));
+        }
+
+        TEST_SECTION("strings")
+        {
+            const fst::string str = "banana";
+            const fst::stack_string<16> sstr = "banana";
+            const size_t h = fst::hash<fst::string_view>{}("banana");
+
+            REQUIRE_EQ(fst::hash<fst::string>{}(str), h);
+            REQUIRE_EQ(fst::hash<fst::stack_string<16>>{}(sstr), h);
+            REQUIRE_EQ(fst::hash<fst::string>{}(fst::string_view("banana")), h);
+            REQUIRE_EQ(h, (size_t) fst::hash_string("banana"));
+            REQUIRE_NE(fst::hash<fst::string_view>{}("bananas"), h);
+
+            constexpr size_t ch = fst::hash<fst::string_view>{}(fst::string_view("banana"));
+            REQUIRE_EQ(ch, h);
+        }
+
+        TEST_SECTION("memory_range")
+        {
+            int values[4] = { 1, 2, 3, 4 };
+            const fst::memory_range<int> range(values, 4);
+            REQUIRE_EQ(fst::hash<fst::memory_range<int>>{}(range), (size_t) fst::hash_bytes(values, sizeof(values)));
+
+            const fst::memory_range<int> half(values, 2);
+            REQUIRE_NE(fst::hash<fst::memory_range<int>>{}(half), fst::hash<fst::memory_range<int>>{}(range));
+        }
+    }
+
+    BENCH_CASE("fst::hash", "[core][bench]")
+    {
+        // The previous byte at a time fst::hash.
+        auto fnv1a = [](const uint8_t* data, size_t size)
+        {
+            uint64_t h = 14695981039346656037ULL;
+            for (size_t i = 0; i < size; i++)
+            {
+                h ^= data[i];
+                h *= 1099511628211ULL;
+            }
+            return h;
+        };
+
+        static uint8_t buffer[4096];
+        for (size_t i = 0; i < sizeof(buffer); i++)
+        {
+            buffer[i] = (uint8_t) (i * 31);
+        }
+
+        CATCH_BENCHMARK("fnv1a 16") { return fnv1a(buffer, 16); };
+        CATCH_BENCHMARK("hash_bytes 16") { return fst::hash_bytes(buffer, 16); };
+        CATCH_BENCHMARK("fnv1a 64") { return fnv1a(buffer, 64); };
+        CATCH_BENCHMARK("hash_bytes 64") { return fst::hash_bytes(buffer, 64); };
+        CATCH_BENCHMARK("fnv1a 256") { return fnv1a(buffer, 256); };
+        CATCH_BENCHMARK("hash_bytes 256") { return fst::hash_bytes(buffer, 256); };
+        CATCH_BENCHMARK("fnv1a 4096") { return fnv1a(buffer, 4096); };
+        CATCH_BENCHMARK("hash_bytes 4096") { return fst::hash_bytes(buffer, 4096); };
+    }
+} // namespace
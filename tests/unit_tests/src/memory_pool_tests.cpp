@@ -3,6 +3,7 @@
 #include "fst/memory.h"
 #include "fst/vector.h"
 #include "fst/memory_pool.h"
+#include "fst/async/thread.h"
 
 namespace
 {
@@ -112,4 +113,257 @@ namespace
         REQUIRE_EQ(pool.capacity(), memory_pool_type::default_chunk_capacity + buffer.size() - memory_pool_type::total_reserved_size);
     }
 
+    TEST_CASE("fst::memory_pool mark", "[core]")
+    {
+        using memory_pool_type = fst::forward_memory_pool<fst::default_memory_category, fst::default_memory_zone>;
+
+        TEST_SECTION("rewind")
+        {
+            memory_pool_type pool(1024, true);
+            REQUIRE(pool.aligned_allocate(32));
+
+            const memory_pool_type::marker m = pool.mark();
+            void* ptr = pool.aligned_allocate(64);
+            REQUIRE(ptr);
+            REQUIRE_EQ(pool.size(), 96);
+
+            pool.rewind(m);
+            REQUIRE_EQ(pool.size(), 32);
+            REQUIRE_EQ(pool.aligned_allocate(64), ptr);
+        }
+
+        TEST_SECTION("chunks are reused")
+        {
+            memory_pool_type pool(1024, true);
+            const memory_pool_type::marker m = pool.mark();
+
+            void* ptr = pool.aligned_allocate(4096);
+            REQUIRE(ptr);
+            REQUIRE_EQ(pool.capacity(), 1024 + 4096);
+
+            pool.rewind(m);
+            REQUIRE_EQ(pool.size(), 0);
+            REQUIRE_EQ(pool.capacity(), 1024);
+
+            REQUIRE_EQ(pool.aligned_allocate(4096), ptr);
+            REQUIRE_EQ(pool.capacity(), 1024 + 4096);
+
+            pool.rewind(m);
+            pool.release_spare_chunks();
+            REQUIRE_EQ(pool.capacity(), 1024);
+        }
+
+        TEST_SECTION("scoped_arena")
+        {
+            memory_pool_type pool;
+
+            {
+                fst::scoped_arena arena(pool);
+                REQUIRE(arena.aligned_allocate(128));
+
+                {
+                    fst::scoped_arena inner(pool);
+                    REQUIRE(inner.aligned_allocate(256));
+                    REQUIRE_EQ(pool.size(), 384);
+                }
+
+                REQUIRE_EQ(pool.size(), 128);
+            }
+
+            REQUIRE_EQ(pool.size(), 0);
+        }
+
+        TEST_SECTION("frame_memory_pool")
+        {
+            fst::frame_memory_pool<> frames(1024);
+
+            int* a = (int*) frames.aligned_allocate(sizeof(int));
+            *a = 1;
+
+            frames.next_frame();
+            int* b = (int*) frames.aligned_allocate(sizeof(int));
+            *b = 2;
+
+            // The previous frame is still alive.
+            REQUIRE_EQ(*a, 1);
+            REQUIRE_NE(frames.previous().size(), 0);
+            REQUIRE_NE(frames.current().size(), 0);
+
+            frames.next_frame();
+            REQUIRE_EQ(frames.frame(), 2);
+            REQUIRE_EQ(frames.current().size(), 0);
+            REQUIRE_EQ(frames.aligned_allocate(sizeof(int)), a);
+            REQUIRE_EQ(*b, 2);
+        }
+    }
+
+    BENCH_CASE("fst::memory_pool rewind", "[core][bench]")
+    {
+        using memory_pool_type = fst::forward_memory_pool<fst::default_memory_category, fst::default_memory_zone>;
+        constexpr size_t request_count = 1000;
+
+        CATCH_BENCHMARK("new pool per request")
+        {
+            size_t count = 0;
+            for (size_t i = 0; i < request_count; i++)
+            {
+                memory_pool_type pool;
+                count += pool.aligned_allocate(256) != nullptr;
+            }
+            return count;
+        };
+
+        CATCH_BENCHMARK("scoped_arena per request")
+        {
+            memory_pool_type pool;
+            size_t count = 0;
+            for (size_t i = 0; i < request_count; i++)
+            {
+                fst::scoped_arena arena(pool);
+                count += arena.aligned_allocate(256) != nullptr;
+            }
+            return count;
+        };
+    }
+
+    TEST_CASE("fst::small_memory_pool thread_cache", "[core]")
+    {
+        using pool_type = fst::small_memory_pool<fst::default_memory_category, fst::default_memory_zone>;
+
+        TEST_SECTION("flush on destruction")
+        {
+            // 64 slots of 16 bytes in the first bucket.
+            pool_type pool(2, 1024);
+            fst::vector<void*> ptrs;
+
+            {
+                pool_type::thread_cache cache(pool);
+
+                for (size_t i = 0; i < 64; i++)
+                {
+                    void* ptr = pool.aligned_allocate(16, 16);
+                    REQUIRE(pool.owns(ptr));
+                    ptrs.push_back(ptr);
+                }
+
+                for (size_t i = 0; i < ptrs.size(); i++)
+                {
+                    for (size_t j = i + 1; j < ptrs.size(); j++)
+                    {
+                        REQUIRE_NE(ptrs[i], ptrs[j]);
+                    }
+                }
+
+                for (void* ptr : ptrs)
+                {
+                    pool.aligned_deallocate(ptr);
+                }
+            }
+
+            // Every slot went back to the shared buckets.
+            for (size_t i = 0; i < 64; i++)
+            {
+                REQUIRE(pool.owns(pool.aligned_allocate(16, 16)));
+            }
+        }
+
+        TEST_SECTION("multiple threads")
+        {
+            pool_type pool(4, 16 * 1024);
+            fst::atomic<uint32_t> errors = 0;
+            fst::vector<fst::async::thread> threads;
+
+            for (uint32_t t = 0; t < 4; t++)
+            {
+                threads.push_back(fst::async::thread(
+                    [&pool, &errors, t]()
+                    {
+                        pool_type::thread_cache cache(pool);
+                        uint32_t* ptrs[48];
+
+                        for (uint32_t n = 0; n < 200; n++)
+                        {
+                            for (uint32_t i = 0; i < 48; i++)
+                            {
+                                ptrs[i] = (uint32_t*) pool.aligned_allocate(16 + (i % 4) * 16, 16);
+                                *ptrs[i] = t * 1000 + i;
+                            }
+
+                            for (uint32_t i = 0; i < 48; i++)
+                            {
+                                if (*ptrs[i] != t * 1000 + i) { ++errors; }
+                                pool.aligned_deallocate(ptrs[i]);
+                            }
+                        }
+                    }));
+            }
+
+            for (fst::async::thread& t : threads)
+            {
+                t.join();
+            }
+
+            REQUIRE_EQ(errors.load(), 0);
+        }
+    }
+
+    template <bool _UseCache>
+    inline void small_pool_alloc_free(fst::small_memory_pool<>& pool, size_t thread_count)
+    {
+        fst::vector<fst::async::thread> threads;
+
+        for (size_t t = 0; t < thread_count; t++)
+        {
+            threads.push_back(fst::async::thread(
+                [&pool]()
+                {
+                    auto run = [&pool]()
+                    {
+                        void* ptrs[16];
+                        for (size_t n = 0; n < 2000; n++)
+                        {
+                            for (size_t i = 0; i < 16; i++)
+                            {
+                                ptrs[i] = pool.aligned_allocate(16 + (i % 8) * 16, 16);
+                            }
+
+                            for (size_t i = 0; i < 16; i++)
+                            {
+                                pool.aligned_deallocate(ptrs[i]);
+                            }
+                        }
+                    };
+
+                    if constexpr (_UseCache)
+                    {
+                        fst::small_memory_pool<>::thread_cache cache(pool);
+                        run();
+                    }
+                    else { run(); }
+                }));
+        }
+
+        for (fst::async::thread& t : threads)
+        {
+            t.join();
+        }
+    }
+
+    BENCH_CASE("fst::small_memory_pool multi-thread alloc/free", "[core][bench]")
+    {
+        const size_t thread_count = fst::maximum(fst::async::thread::hardware_concurrency(), 2u);
+        fst::small_memory_pool<> pool(8, 64 * 1024);
+
+        CATCH_BENCHMARK("shared buckets")
+        {
+            small_pool_alloc_free<false>(pool, thread_count);
+            return thread_count;
+        };
+
+        CATCH_BENCHMARK("thread_cache")
+        {
+            small_pool_alloc_free<true>(pool, thread_count);
+            return thread_count;
+        };
+    }
 } // namespace
@@ -2,9 +2,30 @@
 #include "fst/memory.h"
 #include "fst/vector.h"
 #include "fst/memory_pool.h"
+#include "fst/string.h"
 
 namespace
 {
+    // reallocate always moves the block and scrambles the old one, reading it afterward shows up in the content.
+    template <class T>
+    struct moving_allocator
+    {
+        using value_type = T;
+
+        FST_NODISCARD T* allocate(size_t count) noexcept { return (T*) fst::default_memory_zone::allocate(count * sizeof(T), fst::default_memory_category::id()); }
+
+        void deallocate(T* ptr) noexcept { fst::default_memory_zone::deallocate(ptr, fst::default_memory_category::id()); }
+
+        FST_NODISCARD T* reallocate(T* ptr, size_t count, size_t new_count) noexcept
+        {
+            T* new_ptr = allocate(new_count);
+            fst::memcpy(new_ptr, ptr, count * sizeof(T));
+            fst::memset(ptr, 0xFF, count * sizeof(T));
+            deallocate(ptr);
+            return new_ptr;
+        }
+    };
+
     TEST_CASE("fst::memory", "[core]")
     {
         {
@@ -40,4 +61,334 @@ namespace
             fst::sm_memory_zone::release();
         }*/
     }
+
+    TEST_CASE("fst::size_class_memory_zone", "[core]")
+    {
+        using zone = fst::size_class_memory_zone;
+        const fst::memory_category_id mid = fst::default_memory_category::id();
+
+        TEST_SECTION("size classes")
+        {
+            REQUIRE_EQ(zone::allocation_size(1), 16);
+            REQUIRE_EQ(zone::allocation_size(16), 16);
+            REQUIRE_EQ(zone::allocation_size(17), 32);
+            REQUIRE_EQ(zone::allocation_size(65), 80);
+            REQUIRE_EQ(zone::allocation_size(129), 160);
+            REQUIRE_EQ(zone::allocation_size(1000), 1024);
+            REQUIRE_EQ(zone::allocation_size(zone::maximum_size), zone::maximum_size);
+
+            // At most 25% waste above 64 bytes.
+            for (size_t size = 64; size <= zone::maximum_size; size += 7)
+            {
+                const size_t class_size = zone::allocation_size(size);
+                REQUIRE(class_size >= size);
+                REQUIRE(class_size - size <= size / 4);
+            }
+        }
+
+        TEST_SECTION("allocate")
+        {
+            for (size_t size = 1; size <= zone::maximum_size * 2; size = size * 3 / 2 + 1)
+            {
+                uint8_t* ptr = (uint8_t*) zone::allocate(size, mid);
+                REQUIRE(ptr);
+                REQUIRE(fst::is_aligned(ptr, zone::minimum_size));
+
+                ptr[0] = 1;
+                ptr[size - 1] = 2;
+                zone::deallocate(ptr, mid);
+            }
+        }
+
+        TEST_SECTION("alignment")
+        {
+            for (size_t alignment = 16; alignment <= 16 * 1024; alignment *= 2)
+            {
+                void* ptr = zone::aligned_allocate(100, alignment, mid);
+                REQUIRE(fst::is_aligned(ptr, alignment));
+                zone::aligned_deallocate(ptr, mid);
+            }
+        }
+
+        TEST_SECTION("slabs go back to the os")
+        {
+            const size_t slab_count = zone::slab_count();
+            fst::vector<void*> ptrs;
+
+            // More than two slabs of the 4096 bytes class.
+            for (size_t i = 0; i < 2 * zone::slab_size / 4096 + 1; i++)
+            {
+                ptrs.push_back(zone::allocate(4096, mid));
+            }
+
+            // The cached empty slab of this class may already exist.
+            REQUIRE(zone::slab_count() >= slab_count + 2);
+
+            for (void* ptr : ptrs)
+            {
+                zone::deallocate(ptr, mid);
+            }
+
+            // One empty slab is kept.
+            REQUIRE(zone::slab_count() <= slab_count + 1);
+        }
+
+        TEST_SECTION("containers")
+        {
+            using vector_type = fst::vector<int, alignof(int), fst::default_memory_category, zone>;
+            vector_type vec;
+            for (int i = 0; i < 10000; i++)
+            {
+                vec.push_back(i);
+            }
+            REQUIRE_EQ(vec[9999], 9999);
+
+            using proxy_vector_type = fst::vector<int, alignof(int), fst::default_memory_category, fst::memory_zone_proxy>;
+            proxy_vector_type pvec(zone::proxy());
+            pvec.resize(1000, 5);
+            REQUIRE_EQ(pvec[999], 5);
+
+            using string_type = fst::basic_string<char, fst::memory_zone_allocator<char, fst::default_memory_category, zone>>;
+            string_type str = "a string long enough to go on the heap of the size class zone";
+            str += str;
+            REQUIRE_EQ(str.size(), 122);
+        }
+    }
+
+    TEST_CASE("fst::memory_zone reallocate", "[core]")
+    {
+        const fst::memory_category_id mid = fst::default_memory_category::id();
+
+        TEST_SECTION("traits")
+        {
+            REQUIRE(fst::memory_zone_has_reallocate<fst::default_memory_zone>::value);
+            REQUIRE(fst::memory_zone_has_try_expand<fst::default_memory_zone>::value);
+            REQUIRE(fst::memory_zone_has_reallocate<fst::size_class_memory_zone>::value);
+            REQUIRE(fst::memory_zone_has_reallocate<fst::memory_zone_proxy>::value);
+            REQUIRE_FALSE(fst::memory_zone_has_reallocate<fst::simd_memory_zone>::value);
+            REQUIRE_FALSE(fst::memory_zone_has_try_expand<fst::simd_memory_zone>::value);
+        }
+
+        TEST_SECTION("content is preserved")
+        {
+            auto check = [&](auto&& zone, size_t alignment)
+            {
+                uint8_t* ptr = (uint8_t*) zone.aligned_allocate(100, alignment, mid);
+                for (size_t i = 0; i < 100; i++)
+                {
+                    ptr[i] = (uint8_t) i;
+                }
+
+                ptr = (uint8_t*) fst::memory_zone_reallocate(zone, ptr, 100, 256 * 1024, alignment, mid);
+                REQUIRE(ptr);
+                REQUIRE(fst::is_aligned(ptr, alignment));
+
+                bool same = true;
+                for (size_t i = 0; i < 100; i++)
+                {
+                    same = same && ptr[i] == (uint8_t) i;
+                }
+
+                REQUIRE(same);
+                zone.aligned_deallocate(ptr, mid);
+            };
+
+            check(fst::default_memory_zone{}, 16);
+            check(fst::default_memory_zone{}, 64);
+            check(fst::simd_memory_zone{}, 32);
+            check(fst::size_class_memory_zone{}, 16);
+            check(fst::size_class_memory_zone::proxy(), 16);
+            check(fst::simd_memory_zone::proxy(), 32);
+        }
+
+        TEST_SECTION("size class grows in place")
+        {
+            using zone = fst::size_class_memory_zone;
+
+            void* ptr = zone::aligned_allocate(65, 16, mid);
+            REQUIRE(zone::try_expand(ptr, 80, mid));
+            REQUIRE_FALSE(zone::try_expand(ptr, 81, mid));
+            REQUIRE_EQ(zone::reallocate(ptr, 65, 70, 16, mid), ptr);
+
+            void* large = zone::reallocate(ptr, 70, 100000, 16, mid);
+            REQUIRE(large);
+            REQUIRE(zone::try_expand(large, 100000 + 100, mid));
+            zone::aligned_deallocate(large, mid);
+        }
+
+        TEST_SECTION("containers")
+        {
+            using vector_type = fst::vector<int, alignof(int), fst::default_memory_category, fst::size_class_memory_zone>;
+            vector_type vec;
+            vec.reserve(17);
+            const int* data = vec.data();
+
+            // 17 and 20 ints are both in the 80 bytes class.
+            vec.reserve(20);
+            REQUIRE_EQ(vec.data(), data);
+
+            using string_type = fst::basic_string<char, fst::memory_zone_allocator<char, fst::default_memory_category, fst::size_class_memory_zone>>;
+            string_type str = "a string long enough to go on the heap";
+            for (int i = 0; i < 6; i++)
+            {
+                str.append(str.c_str(), str.size());
+            }
+            REQUIRE_EQ(str.size(), 38 * 64);
+            REQUIRE_EQ(str.view().substr(38 * 63), "a string long enough to go on the heap");
+        }
+
+        TEST_SECTION("string insert grows the buffer")
+        {
+            // Inserting a sub-range has to move the tail of the string from the new block.
+            auto check = [](auto str, auto source)
+            {
+                using char_type = typename decltype(str)::value_type;
+                for (size_t i = 0; i < 100; i++)
+                {
+                    str.push_back((char_type) ('a' + i % 26));
+                }
+
+                size_t inserted = 0;
+                for (int pass = 0; pass < 4; pass++)
+                {
+                    // One more than the remaining capacity.
+                    const size_t count = str.capacity() - str.size() + 1;
+                    str.insert(10, source.view(), 1, count);
+                    inserted += count;
+                    REQUIRE_EQ(str.size(), 100 + inserted);
+
+                    bool same = true;
+                    for (size_t i = 0; i < str.size(); i++)
+                    {
+                        const char_type expected
+                            = i < 10 ? (char_type) ('a' + i) : i < 10 + inserted ? (char_type) 'x' : (char_type) ('a' + (i - inserted) % 26);
+                        same = same && str[i] == expected;
+                    }
+                    REQUIRE(same);
+                }
+            };
+
+            check(fst::basic_string<char, moving_allocator<char>>(), fst::string(4096, 'x'));
+            check(fst::basic_string<char16_t, moving_allocator<char16_t>>(), fst::u16string(4096, u'x'));
+        }
+    }
+
+    TEST_CASE("fst::large_page_memory_zone", "[core]")
+    {
+        using zone = fst::large_page_memory_zone;
+        const fst::memory_category_id mid = fst::simd_memory_category::id();
+
+        TEST_SECTION("small allocations")
+        {
+            void* ptr = zone::aligned_allocate(1024, 64, mid);
+            REQUIRE(ptr);
+            REQUIRE(fst::is_aligned(ptr, 64));
+            REQUIRE_FALSE(zone::is_large_allocation(ptr));
+            zone::aligned_deallocate(ptr, mid);
+        }
+
+        TEST_SECTION("large allocations")
+        {
+            const size_t size = 3 * zone::large_page_size;
+            float* ptr = (float*) zone::aligned_allocate(size, 64, mid);
+            REQUIRE(ptr);
+            REQUIRE(fst::is_aligned(ptr, zone::large_page_size));
+            REQUIRE(zone::is_large_allocation(ptr));
+
+            for (size_t i = 0; i < size / sizeof(float); i++)
+            {
+                ptr[i] = (float) i;
+            }
+
+            REQUIRE_EQ(ptr[size / sizeof(float) - 1], (float) (size / sizeof(float) - 1));
+            zone::aligned_deallocate(ptr, mid);
+        }
+
+        TEST_SECTION("many large allocations")
+        {
+            // Enough live mappings to grow the table, freed out of order.
+            constexpr size_t count = 300;
+            fst::vector<void*> ptrs;
+
+            for (size_t i = 0; i < count; i++)
+            {
+                void* ptr = zone::allocate(zone::large_page_size, mid);
+                REQUIRE(ptr);
+                REQUIRE(fst::is_aligned(ptr, zone::large_page_size));
+                ptrs.push_back(ptr);
+            }
+
+            for (size_t i = 0; i < count; i += 2)
+            {
+                zone::deallocate(ptrs[i], mid);
+            }
+
+            for (size_t i = 1; i < count; i += 2)
+            {
+                REQUIRE(zone::is_large_allocation(ptrs[i]));
+                zone::deallocate(ptrs[i], mid);
+            }
+        }
+
+        TEST_SECTION("numa node")
+        {
+            REQUIRE_EQ(zone::thread_numa_node(), -1);
+            REQUIRE(zone::current_numa_node() >= 0);
+
+            zone::set_thread_numa_node(zone::current_numa_node());
+            void* ptr = zone::allocate(zone::large_page_size, mid);
+            REQUIRE(ptr);
+            fst::memset(ptr, 1, zone::large_page_size);
+            zone::deallocate(ptr, mid);
+
+            // A node that doesn't exist is ignored.
+            zone::set_thread_numa_node(63);
+            ptr = zone::allocate(zone::large_page_size, mid);
+            REQUIRE(ptr);
+            fst::memset(ptr, 1, zone::large_page_size);
+            zone::deallocate(ptr, mid);
+
+            zone::set_thread_numa_node(-1);
+        }
+
+        TEST_SECTION("containers")
+        {
+            using vector_type = fst::vector<float, 32, fst::simd_memory_category, zone>;
+            vector_type vec;
+            vec.resize(1024 * 1024, 1.0f);
+            REQUIRE(zone::is_large_allocation(vec.data()));
+            REQUIRE_EQ(vec[1024 * 1024 - 1], 1.0f);
+        }
+    }
+
+    BENCH_CASE("fst::large_page_memory_zone random access", "[core][bench]")
+    {
+        constexpr size_t size = 256 * 1024 * 1024;
+        constexpr size_t count = size / sizeof(uint32_t);
+        const fst::memory_category_id mid = fst::simd_memory_category::id();
+
+        auto run = [&](uint32_t* data)
+        {
+            // Strided walk that touches a new 4 KiB page on every access.
+            uint64_t sum = 0;
+            uint32_t index = 0;
+            for (size_t i = 0; i < 1024 * 1024; i++)
+            {
+                index = (index + 1031 * 1024 + 7) % count;
+                sum += data[index];
+            }
+            return sum;
+        };
+
+        uint32_t* simd_data = (uint32_t*) fst::simd_memory_zone::aligned_allocate(size, 64, mid);
+        uint32_t* large_data = (uint32_t*) fst::large_page_memory_zone::aligned_allocate(size, 64, mid);
+        fst::memset(simd_data, 1, size);
+        fst::memset(large_data, 1, size);
+
+        CATCH_BENCHMARK("simd_memory_zone") { return run(simd_data); };
+        CATCH_BENCHMARK("large_page_memory_zone") { return run(large_data); };
+
+        fst::simd_memory_zone::aligned_deallocate(simd_data, mid);
+        fst::large_page_memory_zone::aligned_deallocate(large_data, mid);
+    }
 } // namespace
@@ -1,9 +1,8 @@
 #include "utest.h"
 #include "fst/mutex.h"
 #include "fst/atomic.h"
-
-// TODO: switch to fst::thread when implemented.
-#include <thread>
+#include "fst/async/thread.h"
+#include "fst/vector.h"
 
 namespace
 {
@@ -15,7 +14,7 @@ namespace
             fst::mutex m;
             m.lock();
 
-            std::thread t(
+            fst::async::thread t(
                 [&]()
                 {
                     REQUIRE_FALSE(m.try_lock());
@@ -33,66 +32,249 @@ namespace
 
         TEST_BLOCK("mutex in other thread")
         {
-            //fst::atomic<bool> did_try = false;
-            //fst::atomic<bool> did_lock = false;
-            //fst::mutex m;
+            fst::atomic<bool> did_try = false;
+            fst::atomic<bool> did_lock = false;
+            fst::mutex m;
 
-            //std::thread t(
-            //    [&]()
-            //    {
-            //        m.lock();
-            //        did_lock.store(true);
-            //        while (!did_try.load()) {}
-            //        m.unlock();
-            //    });
+            fst::async::thread t(
+                [&]()
+                {
+                    m.lock();
+                    did_lock.store(true);
+                    while (!did_try.load()) {}
+                    m.unlock();
+                });
 
-            //// Wait for thread to lock the mutex.
-            //while (!did_lock.load()) {}
+            // Wait for thread to lock the mutex.
+            while (!did_lock.load()) {}
 
-            //// Try to lock it.
-            //REQUIRE_FALSE(m.try_lock());
+            // Try to lock it.
+            REQUIRE_FALSE(m.try_lock());
 
-            //// Notify the thread.
-            //did_try.store(true);
+            // Notify the thread.
+            did_try.store(true);
 
-            //// This should work in almost no time.
-            //m.lock();
+            // This should work in almost no time.
+            m.lock();
 
-            //t.join();
+            t.join();
 
-            //m.unlock();
+            m.unlock();
         }
 
         TEST_BLOCK("mutex in other thread with try_lock loop")
         {
-            //fst::atomic<bool> did_try = false;
-            //fst::atomic<bool> did_lock = false;
-            //fst::mutex m;
+            fst::atomic<bool> did_try = false;
+            fst::atomic<bool> did_lock = false;
+            fst::mutex m;
+
+            fst::async::thread t(
+                [&]()
+                {
+                    m.lock();
+                    did_lock.store(true);
+                    while (!did_try.load()) {}
+                    m.unlock();
+                });
+
+            // Wait for thread to lock the mutex.
+            while (!did_lock.load()) {}
+
+            // Try to lock it.
+            REQUIRE_FALSE(m.try_lock());
+
+            // Notify the thread.
+            did_try.store(true);
+
+            // This should work in almost no time.
+            while (!m.try_lock()) {}
+
+            t.join();
+
+            m.unlock();
+        }
+    }
+
+    template <class _Mutex>
+    inline uint32_t concurrent_increment(_Mutex& m, size_t thread_count, uint32_t iterations)
+    {
+        uint32_t value = 0;
+        fst::vector<fst::async::thread> threads;
+
+        for (size_t i = 0; i < thread_count; i++)
+        {
+            threads.push_back(fst::async::thread(
+                [&m, &value, iterations]()
+                {
+                    for (uint32_t j = 0; j < iterations; j++)
+                    {
+                        m.lock();
+                        value = value + 1;
+                        m.unlock();
+                    }
+                }));
+        }
+
+        for (fst::async::thread& t : threads)
+        {
+            t.join();
+        }
+
+        return value;
+    }
+
+    TEST_CASE("fst::adaptive_mutex", "[core]")
+    {
+        TEST_BLOCK("try_lock")
+        {
+            fst::adaptive_mutex m;
+            REQUIRE(m.try_lock());
+            REQUIRE_FALSE(m.try_lock());
+            m.unlock();
+            REQUIRE(m.try_lock());
+            m.unlock();
+
+            REQUIRE_EQ(m.stats().contentions, 0);
+        }
+
+        TEST_BLOCK("mutual exclusion")
+        {
+            fst::adaptive_mutex m;
+            REQUIRE_EQ(concurrent_increment(m, 4, 10000), 40000);
+        }
+
+        TEST_BLOCK("parks when held")
+        {
+            fst::adaptive_mutex m;
+            fst::atomic<bool> did_lock = false;
+            m.lock();
 
-            //std::thread t(
-            //    [&]()
-            //    {
-            //        m.lock();
-            //        did_lock.store(true);
-            //        while (!did_try.load()) {}
-            //        m.unlock();
-            //    });
+            fst::async::thread t(
+                [&]()
+                {
+                    m.lock();
+                    did_lock.store(true);
+                    m.unlock();
+                });
 
-            //// Wait for thread to lock the mutex.
-            //while (!did_lock.load()) {}
+            fst::async::this_thread::sleep_for_us(5000);
+            REQUIRE_FALSE(did_lock.load());
+            m.unlock();
+            t.join();
 
-            //// Try to lock it.
-            //REQUIRE_FALSE(m.try_lock());
+            REQUIRE(did_lock.load());
+            REQUIRE_EQ(m.stats().contentions, 1);
+            REQUIRE(m.stats().parks >= 1);
 
-            //// Notify the thread.
-            //did_try.store(true);
+            m.reset_stats();
+            REQUIRE_EQ(m.stats().parks, 0);
+        }
+    }
 
-            //// This should work in almost no time.
-            //while(!m.try_lock()){}
+    TEST_CASE("fst::shared_mutex", "[core]")
+    {
+        TEST_BLOCK("shared")
+        {
+            fst::shared_mutex m;
+            REQUIRE(m.try_lock_shared());
+            REQUIRE(m.try_lock_shared());
+            REQUIRE_FALSE(m.try_lock());
+            m.unlock_shared();
+            m.unlock_shared();
 
-            //t.join();
+            REQUIRE(m.try_lock());
+            REQUIRE_FALSE(m.try_lock_shared());
+            m.unlock();
+        }
 
-            //m.unlock();
+        TEST_BLOCK("mutual exclusion")
+        {
+            fst::shared_mutex m(fst::shared_mutex::policy::reader_biased);
+            REQUIRE_EQ(concurrent_increment(m, 4, 10000), 40000);
         }
+
+        TEST_BLOCK("writer preferring")
+        {
+            fst::shared_mutex m(fst::shared_mutex::policy::writer_preferring);
+            fst::atomic<bool> did_write = false;
+            m.lock_shared();
+
+            fst::async::thread writer(
+                [&]()
+                {
+                    m.lock();
+                    did_write.store(true);
+                    m.unlock();
+                });
+
+            // Wait for the writer to queue up.
+            while (m.stats().contentions == 0)
+            {
+                fst::async::this_thread::yield();
+            }
+
+            // New readers have to wait for the writer.
+            REQUIRE_FALSE(m.try_lock_shared());
+
+            m.unlock_shared();
+            writer.join();
+            REQUIRE(did_write.load());
+            REQUIRE(m.try_lock_shared());
+            m.unlock_shared();
+        }
+
+        TEST_BLOCK("reader biased")
+        {
+            fst::shared_mutex m(fst::shared_mutex::policy::reader_biased);
+            m.lock_shared();
+
+            fst::async::thread writer(
+                [&]()
+                {
+                    m.lock();
+                    m.unlock();
+                });
+
+            while (m.stats().contentions == 0)
+            {
+                fst::async::this_thread::yield();
+            }
+
+            // Readers still get in.
+            REQUIRE(m.try_lock_shared());
+            m.unlock_shared();
+
+            m.unlock_shared();
+            writer.join();
+        }
+    }
+
+    BENCH_CASE("fst::mutex contention", "[core][bench]")
+    {
+        const size_t thread_count = fst::async::thread::hardware_concurrency() * 2;
+
+        CATCH_BENCHMARK("fst::spin_lock")
+        {
+            fst::spin_lock m;
+            return concurrent_increment(m, thread_count, 10000);
+        };
+
+        CATCH_BENCHMARK("fst::adaptive_mutex")
+        {
+            fst::adaptive_mutex m;
+            return concurrent_increment(m, thread_count, 10000);
+        };
+
+        CATCH_BENCHMARK("fst::shared_mutex")
+        {
+            fst::shared_mutex m;
+            return concurrent_increment(m, thread_count, 10000);
+        };
+
+        CATCH_BENCHMARK("fst::mutex")
+        {
+            fst::mutex m;
+            return concurrent_increment(m, thread_count, 10000);
+        };
     }
 } // namespace
@@ -0,0 +1,352 @@
+#include "utest.h"
+#include "fst/parallel.h"
+#include "fst/memory_range.h"
+#include "fst/simd.h"
+#include "fst/vector.h"
+
+namespace
+{
+    struct keyed
+    {
+        uint32_t key;
+        uint32_t index;
+    };
+
+    template <class _T>
+    inline fst::vector<_T> make_vector(size_t size, const _T& value = _T{})
+    {
+        fst::vector<_T> v;
+        v.resize(size, value);
+        return v;
+    }
+
+    inline uint32_t next_random(uint32_t& state)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    inline bool is_stable_sorted(const fst::vector<keyed>& v)
+    {
+        for (size_t i = 1; i < v.size(); i++)
+        {
+            if (v[i - 1].key > v[i].key) { return false; }
+            if (v[i - 1].key == v[i].key && v[i - 1].index > v[i].index) { return false; }
+        }
+
+        return true;
+    }
+
+    TEST_CASE("fst::parallel_for", "[core]")
+    {
+        fst::async::thread_pool pool(4);
+
+        TEST_SECTION("index")
+        {
+            fst::vector<uint32_t> v = make_vector<uint32_t>(10000, 0u);
+            fst::parallel_for(pool, v.size(), [&v](size_t i) { v[i] += (uint32_t) i; });
+
+            for (size_t i = 0; i < v.size(); i++)
+            {
+                REQUIRE_EQ(v[i], (uint32_t) i);
+            }
+        }
+
+        TEST_SECTION("range")
+        {
+            fst::atomic<size_t> total = 0;
+            fst::parallel_for(pool, 12345, [&total](size_t first, size_t last) { total.fetch_add(last - first); }, 100);
+            REQUIRE_EQ(total.load(), 12345);
+        }
+
+        TEST_SECTION("empty")
+        {
+            bool called = false;
+            fst::parallel_for(pool, 0, [&called](size_t) { called = true; });
+            REQUIRE_FALSE(called);
+        }
+    }
+
+    TEST_CASE("fst::parallel_for_each", "[core]")
+    {
+        fst::async::thread_pool pool(4);
+
+        TEST_SECTION("vector")
+        {
+            fst::vector<float> v = make_vector<float>(50000, 1.0f);
+            fst::parallel_for_each(pool, v, [](float& s) { s *= 0.5f; }, 1000);
+
+            for (float s : v)
+            {
+                REQUIRE_EQ(s, 0.5f);
+            }
+        }
+
+        TEST_SECTION("memory_range")
+        {
+            // Two channels of a planar buffer, only the second one is processed.
+            constexpr size_t frame_count = 4096;
+            fst::vector<float> buffer = make_vector<float>(2 * frame_count, 1.0f);
+
+            fst::parallel_for_each(pool, fst::memory_range<float>(buffer.data() + frame_count, frame_count), [](float& s) { s = -s; }, 256);
+
+            for (size_t i = 0; i < frame_count; i++)
+            {
+                REQUIRE_EQ(buffer[i], 1.0f);
+                REQUIRE_EQ(buffer[frame_count + i], -1.0f);
+            }
+        }
+
+        TEST_SECTION("default pool")
+        {
+            fst::vector<int> v = make_vector<int>(1000, 2);
+            fst::parallel_for_each(v, [](int& i) { i *= i; });
+
+            for (int i : v)
+            {
+                REQUIRE_EQ(i, 4);
+            }
+        }
+    }
+
+    TEST_CASE("fst::parallel_transform", "[core]")
+    {
+        fst::async::thread_pool pool(4);
+
+        fst::vector<int> in = make_vector<int>(30000);
+        for (size_t i = 0; i < in.size(); i++)
+        {
+            in[i] = (int) i;
+        }
+
+        TEST_SECTION("out of place")
+        {
+            fst::vector<int64_t> out = make_vector<int64_t>(in.size(), (int64_t) 0);
+            fst::parallel_transform(pool, in, out, [](int i) { return (int64_t) i * 3; }, 512);
+
+            for (size_t i = 0; i < in.size(); i++)
+            {
+                REQUIRE_EQ(out[i], (int64_t) i * 3);
+            }
+        }
+
+        TEST_SECTION("in place")
+        {
+            fst::parallel_transform(pool, in, in, [](int i) { return -i; });
+
+            for (size_t i = 0; i < in.size(); i++)
+            {
+                REQUIRE_EQ(in[i], -(int) i);
+            }
+        }
+    }
+
+    TEST_CASE("fst::parallel_reduce", "[core]")
+    {
+        fst::async::thread_pool pool(4);
+
+        TEST_SECTION("sum")
+        {
+            fst::vector<uint64_t> v = make_vector<uint64_t>(100000);
+            uint64_t expected = 0;
+            for (size_t i = 0; i < v.size(); i++)
+            {
+                v[i] = i;
+                expected += i;
+            }
+
+            REQUIRE_EQ(fst::parallel_reduce(pool, v, (uint64_t) 0, [](uint64_t a, uint64_t b) { return a + b; }, 1000), expected);
+            REQUIRE_EQ(fst::parallel_reduce(pool, v, (uint64_t) 5, [](uint64_t a, uint64_t b) { return a + b; }), expected + 5);
+        }
+
+        TEST_SECTION("empty")
+        {
+            fst::vector<int> v;
+            REQUIRE_EQ(fst::parallel_reduce(pool, v, 7, [](int a, int b) { return a + b; }), 7);
+        }
+
+        TEST_SECTION("reproducible")
+        {
+            fst::vector<float> v = make_vector<float>(20000);
+            uint32_t state = 1234;
+            for (float& s : v)
+            {
+                s = (float) (next_random(state) % 1000) * 0.001f;
+            }
+
+            auto sum = [](float a, float b) { return a + b; };
+
+            fst::async::thread_pool single(1);
+            const float a = fst::parallel_reduce(pool, v, 0.0f, sum, 256);
+            const float b = fst::parallel_reduce(single, v, 0.0f, sum, 256);
+            REQUIRE_EQ(a, b);
+        }
+    }
+
+    TEST_CASE("fst::parallel_sort", "[core]")
+    {
+        fst::async::thread_pool pool(4);
+
+        TEST_SECTION("sizes")
+        {
+            const size_t sizes[] = { 0, 1, 2, 15, 16, 17, 255, 1000, 4097, 33333 };
+            uint32_t state = 42;
+
+            for (size_t size : sizes)
+            {
+                fst::vector<int> v = make_vector<int>(size);
+                for (int& i : v)
+                {
+                    i = (int) (next_random(state) % 100000) - 50000;
+                }
+
+                fst::parallel_sort(pool, v, fst::less<>{}, 64);
+
+                for (size_t i = 1; i < v.size(); i++)
+                {
+                    REQUIRE(v[i - 1] <= v[i]);
+                }
+            }
+        }
+
+        TEST_SECTION("stable")
+        {
+            fst::vector<keyed> v = make_vector<keyed>(20000);
+            uint32_t state = 7;
+            for (size_t i = 0; i < v.size(); i++)
+            {
+                v[i] = keyed{ next_random(state) % 64, (uint32_t) i };
+            }
+
+            fst::parallel_sort(pool, v, [](const keyed& a, const keyed& b) { return a.key < b.key; }, 100);
+            REQUIRE(is_stable_sorted(v));
+        }
+
+        TEST_SECTION("descending")
+        {
+            fst::vector<int> v = make_vector<int>(10000);
+            for (size_t i = 0; i < v.size(); i++)
+            {
+                v[i] = (int) i;
+            }
+
+            fst::parallel_sort(v, [](int a, int b) { return a > b; });
+
+            for (size_t i = 0; i < v.size(); i++)
+            {
+                REQUIRE_EQ(v[i], (int) (v.size() - 1 - i));
+            }
+        }
+    }
+
+    TEST_CASE("fst::parallel simd containers", "[core]")
+    {
+        fst::async::thread_pool pool(4);
+
+        TEST_SECTION("buffer")
+        {
+            fst::simd::buffer<float> b(10000);
+            b.fill(1.0f);
+
+            fst::parallel_for_each(pool, b, [](float& s) { s *= 0.5f; }, 256);
+            REQUIRE_EQ(fst::parallel_reduce(pool, b, 0.0f, [](float a, float c) { return a + c; }, 256), 5000.0f);
+
+            fst::simd::buffer<float> out(b.size());
+            fst::parallel_transform(pool, b, out, [](float s) { return s * 4.0f; }, 256);
+
+            for (float s : out)
+            {
+                REQUIRE_EQ(s, 2.0f);
+            }
+        }
+
+        TEST_SECTION("array")
+        {
+            fst::simd::array<double, 4096> a;
+            a.fill_increment(1.0);
+
+            const double total = fst::parallel_reduce(pool, a, 0.0, [](double x, double y) { return x + y; }, 128);
+            REQUIRE_EQ(total, 4095.0 * 4096.0 / 2.0);
+        }
+
+        TEST_SECTION("vector kernels per grain")
+        {
+            // Grains that are a multiple of the vector size keep every range aligned.
+            constexpr size_t grain = 1024;
+            fst::simd::buffer<float> b(16 * grain);
+            b.fill(3.0f);
+
+            fst::parallel_for(pool, b.size(), [&b](size_t first, size_t last)
+                {
+                    fst::simd::range<float> r(b.data() + first, last - first);
+                    r *= 2.0f;
+                }, grain);
+
+            for (float s : b)
+            {
+                REQUIRE_EQ(s, 6.0f);
+            }
+        }
+    }
+
+    BENCH_CASE("fst::parallel", "[core][bench]")
+    {
+        constexpr size_t count = 1 << 18;
+        fst::vector<float> v = make_vector<float>(count);
+        fst::vector<int> keys = make_vector<int>(count);
+        uint32_t state = 99;
+        for (size_t i = 0; i < count; i++)
+        {
+            v[i] = (float) (next_random(state) % 1000) * 0.001f;
+            keys[i] = (int) next_random(state);
+        }
+
+        auto sum = [](float a, float b) { return a + b; };
+
+        CATCH_BENCHMARK("serial reduce")
+        {
+            float total = 0.0f;
+            for (float s : v)
+            {
+                total += s;
+            }
+            return total;
+        };
+
+        CATCH_BENCHMARK("parallel reduce")
+        {
+            return fst::parallel_reduce(v, 0.0f, sum);
+        };
+
+        CATCH_BENCHMARK("serial for_each")
+        {
+            for (float& s : v)
+            {
+                s = s * 0.999f + 0.001f;
+            }
+            return v[0];
+        };
+
+        CATCH_BENCHMARK("parallel for_each")
+        {
+            fst::parallel_for_each(v, [](float& s) { s = s * 0.999f + 0.001f; });
+            return v[0];
+        };
+
+        CATCH_BENCHMARK("serial sort")
+        {
+            fst::vector<int> copy = keys;
+            fst::parallel_sort(copy, fst::less<>{}, count);
+            return copy[0];
+        };
+
+        CATCH_BENCHMARK("parallel sort")
+        {
+            fst::vector<int> copy = keys;
+            fst::parallel_sort(copy);
+            return copy[0];
+        };
+    }
+} // namespace
@@ -0,0 +1,203 @@
+#include "utest.h"
+#include "fst/profiler.h"
+#include "fst/memory.h"
+#include "fst/async/thread.h"
+#include "fst/string.h"
+
+#if FST_USE_PROFILER
+namespace
+{
+    inline fst::string write_timeline()
+    {
+        fst::string str;
+        fst::output_stream<char> stream(&str,
+            [](void* data, const char* s, size_t size, fst::stream_modifier) noexcept -> size_t
+            {
+                ((fst::string*) data)->append(s, size);
+                return size;
+            });
+
+        fst::profiler::write_timeline(stream);
+        return str;
+    }
+
+    inline bool contains(const fst::string& str, const char* s) { return str.find(s) != fst::string::npos; }
+
+    TEST_CASE("fst::profiler counters", "[core]")
+    {
+        using zone = fst::default_memory_zone;
+        const fst::memory_category_id mid = fst::dsp_memory_category::id();
+
+        TEST_SECTION("allocate and deallocate")
+        {
+            const fst::profiler::counters before = fst::profiler::get_counters(zone::id(), mid);
+
+            void* ptr = zone::allocate(48, mid);
+            fst::profiler::counters c = fst::profiler::get_counters(zone::id(), mid);
+            REQUIRE_EQ(c.bytes, before.bytes + 48);
+            REQUIRE_EQ(c.count, before.count + 1);
+            REQUIRE_EQ(c.total_count, before.total_count + 1);
+
+            zone::deallocate(ptr, mid);
+            c = fst::profiler::get_counters(zone::id(), mid);
+            REQUIRE_EQ(c.bytes, before.bytes);
+            REQUIRE_EQ(c.count, before.count);
+            REQUIRE_EQ(c.total_count, before.total_count + 1);
+        }
+
+        TEST_SECTION("move allocation")
+        {
+            const fst::memory_category_id to_mid = fst::simd_memory_category::id();
+            const fst::profiler::counters from_before = fst::profiler::get_counters(zone::id(), mid);
+            const fst::profiler::counters to_before = fst::profiler::get_counters(zone::id(), to_mid);
+
+            void* ptr = zone::allocate(64, mid);
+            fst::profiler::move_allocation(ptr, zone::id(), mid, to_mid);
+            REQUIRE_EQ(fst::profiler::get_counters(zone::id(), mid).bytes, from_before.bytes);
+            REQUIRE_EQ(fst::profiler::get_counters(zone::id(), to_mid).bytes, to_before.bytes + 64);
+
+            zone::deallocate(ptr, to_mid);
+            REQUIRE_EQ(fst::profiler::get_counters(zone::id(), to_mid).bytes, to_before.bytes);
+        }
+
+        TEST_SECTION("threads")
+        {
+            // Every thread keeps its blocks alive for a while so that the shards grow and shrink concurrently.
+            constexpr size_t thread_count = 4;
+            constexpr size_t block_count = 2048;
+            const fst::profiler::counters before = fst::profiler::get_counters(zone::id(), mid);
+
+            auto run = [mid]()
+            {
+                void* ptrs[block_count];
+                for (size_t n = 0; n < 8; n++)
+                {
+                    for (size_t i = 0; i < block_count; i++)
+                    {
+                        ptrs[i] = zone::allocate(16 + (i & 63), mid);
+                    }
+
+                    for (size_t i = 0; i < block_count; i++)
+                    {
+                        zone::deallocate(ptrs[i], mid);
+                    }
+                }
+            };
+
+            fst::async::thread threads[thread_count];
+            for (size_t i = 0; i < thread_count; i++)
+            {
+                threads[i] = fst::async::thread(run);
+            }
+
+            for (size_t i = 0; i < thread_count; i++)
+            {
+                threads[i].join();
+            }
+
+            const fst::profiler::counters c = fst::profiler::get_counters(zone::id(), mid);
+            REQUIRE_EQ(c.bytes, before.bytes);
+            REQUIRE_EQ(c.count, before.count);
+            REQUIRE_EQ(c.total_count, before.total_count + thread_count * block_count * 8);
+        }
+    }
+
+    TEST_CASE("fst::profiler timeline", "[core]")
+    {
+        TEST_SECTION("scopes")
+        {
+            // Starts from an empty timeline.
+            (void) write_timeline();
+
+            {
+                FST_STRACE("timeline_outer");
+                FST_STRACE("timeline \"inner\"");
+            }
+
+            const fst::string json = write_timeline();
+            REQUIRE(contains(json, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+            REQUIRE(contains(json, "\"ph\":\"B\""));
+            REQUIRE(contains(json, "\"ph\":\"E\""));
+            REQUIRE(contains(json, "\"name\":\"timeline_outer\""));
+            REQUIRE(contains(json, "\"name\":\"timeline \\\"inner\\\"\""));
+            REQUIRE(json.find("timeline_outer") < json.find("timeline \\\"inner"));
+
+            // Already exported.
+            REQUIRE_FALSE(contains(write_timeline(), "timeline_outer"));
+        }
+
+        TEST_SECTION("threads")
+        {
+            (void) write_timeline();
+
+            fst::async::thread t0([]() { FST_STRACE("timeline_thread"); });
+            fst::async::thread t1([]() { FST_STRACE("timeline_thread"); });
+            t0.join();
+            t1.join();
+
+            const fst::string json = write_timeline();
+            const size_t first = json.find("\"name\":\"timeline_thread\"");
+            REQUIRE_NE(first, fst::string::npos);
+            REQUIRE_NE(json.substr(first + 1).find("\"name\":\"timeline_thread\""), fst::string::npos);
+        }
+
+        TEST_SECTION("memory counters")
+        {
+            using zone = fst::default_memory_zone;
+            void* ptr = zone::allocate(128, fst::dsp_memory_category::id());
+
+            const fst::string json = write_timeline();
+            REQUIRE(contains(json, "\"ph\":\"C\""));
+            REQUIRE(contains(json, "\"name\":\"memory "));
+            REQUIRE(contains(json, "\"args\":{\"bytes\":"));
+
+            zone::deallocate(ptr, fst::dsp_memory_category::id());
+        }
+    }
+
+    BENCH_CASE("fst::profiler allocation", "[core][bench]")
+    {
+        constexpr size_t block_count = 1024;
+        const fst::memory_category_id mid = fst::dsp_memory_category::id();
+        void* ptrs[block_count];
+
+        CATCH_BENCHMARK("default_memory_zone")
+        {
+            for (size_t i = 0; i < block_count; i++)
+            {
+                ptrs[i] = fst::default_memory_zone::allocate(32, mid);
+            }
+
+            for (size_t i = 0; i < block_count; i++)
+            {
+                fst::default_memory_zone::deallocate(ptrs[i], mid);
+            }
+
+            return ptrs[0];
+        };
+    }
+
+    BENCH_CASE("fst::profiler timeline", "[core][bench]")
+    {
+        size_t written = 0;
+        fst::output_stream<char> stream(&written,
+            [](void* data, const char*, size_t size, fst::stream_modifier) noexcept -> size_t
+            {
+                *(size_t*) data += size;
+                return size;
+            });
+
+        CATCH_BENCHMARK("FST_STRACE")
+        {
+            for (size_t i = 0; i < 1000; i++)
+            {
+                FST_STRACE("bench");
+            }
+
+            // Keeps the thread buffer from filling up between samples.
+            fst::profiler::write_timeline(stream);
+            return written;
+        };
+    }
+} // namespace
+#endif // FST_USE_PROFILER
@@ -0,0 +1,174 @@
+#include "utest.h"
+#include "fst/segmented_vector.h"
+#include "fst/string.h"
+
+namespace
+{
+    TEST_CASE("fst::segmented_vector", "[core]")
+    {
+        TEST_SECTION("push_back")
+        {
+            fst::segmented_vector<int, 16> vec;
+            REQUIRE(vec.empty());
+            REQUIRE_EQ(vec.chunk_count(), 0);
+
+            vec.push_back(0);
+            const int* first = &vec[0];
+
+            for (int i = 1; i < 1000; i++)
+            {
+                vec.push_back(i);
+            }
+
+            // Elements never move.
+            REQUIRE_EQ(first, &vec[0]);
+            REQUIRE_EQ(vec.size(), 1000);
+            REQUIRE_EQ(vec.chunk_count(), 63);
+            REQUIRE_EQ(vec.capacity(), 1008);
+            REQUIRE_EQ(vec.front(), 0);
+            REQUIRE_EQ(vec.back(), 999);
+
+            for (int i = 0; i < 1000; i++)
+            {
+                REQUIRE_EQ(vec[(size_t) i], i);
+            }
+
+            int expected = 0;
+            for (int v : vec)
+            {
+                REQUIRE_EQ(v, expected++);
+            }
+
+            REQUIRE_EQ(vec.end() - vec.begin(), 1000);
+            REQUIRE_EQ(*(vec.begin() + 500), 500);
+
+            vec.pop_back();
+            REQUIRE_EQ(vec.back(), 998);
+        }
+
+        TEST_SECTION("chunks")
+        {
+            fst::segmented_vector<uint32_t, 64> vec;
+            for (uint32_t i = 0; i < 200; i++)
+            {
+                vec.push_back(i);
+            }
+
+            REQUIRE_EQ(vec.chunk_count(), 4);
+            REQUIRE_EQ(vec.chunk(0).size(), 64);
+            REQUIRE_EQ(vec.chunk(3).size(), 8);
+            REQUIRE_EQ(vec.chunk(1)[0], 64);
+
+            size_t count = 0;
+            uint64_t sum = 0;
+            vec.for_each_chunk(
+                [&](fst::memory_range<uint32_t> range, size_t first_index)
+                {
+                    REQUIRE_EQ(range[0], first_index);
+                    for (uint32_t v : range)
+                    {
+                        sum += v;
+                    }
+                    count++;
+                });
+
+            REQUIRE_EQ(count, 4);
+            REQUIRE_EQ(sum, 199 * 200 / 2);
+        }
+
+        TEST_SECTION("resize and shrink")
+        {
+            fst::segmented_vector<int, 32> vec;
+            vec.reserve(100);
+            REQUIRE_EQ(vec.capacity(), 128);
+            REQUIRE(vec.empty());
+
+            vec.resize(70, 7);
+            REQUIRE_EQ(vec.size(), 70);
+            REQUIRE_EQ(vec[69], 7);
+
+            vec.resize(10);
+            REQUIRE_EQ(vec.size(), 10);
+            REQUIRE_EQ(vec.capacity(), 128);
+
+            vec.shrink_to_fit();
+            REQUIRE_EQ(vec.capacity(), 32);
+
+            vec.reset();
+            REQUIRE(vec.empty());
+            REQUIRE_EQ(vec.capacity(), 0);
+        }
+
+        TEST_SECTION("non trivial")
+        {
+            fst::segmented_vector<fst::string, 4> vec;
+            for (int i = 0; i < 20; i++)
+            {
+                vec.emplace_back("a long string that doesn't fit the small buffer");
+                vec.back().push_back((char) ('a' + i));
+            }
+
+            fst::segmented_vector<fst::string, 4> copy = vec;
+            vec.clear();
+            REQUIRE(vec.empty());
+            REQUIRE_EQ(copy.size(), 20);
+            REQUIRE_EQ(copy[19].back(), 't');
+
+            fst::segmented_vector<fst::string, 4> moved = static_cast<fst::segmented_vector<fst::string, 4>&&>(copy);
+            REQUIRE(copy.empty());
+            REQUIRE_EQ(moved.size(), 20);
+            REQUIRE_EQ(moved[0].back(), 'a');
+
+            moved.resize(2);
+            REQUIRE_EQ(moved.size(), 2);
+        }
+
+        TEST_SECTION("non trivial pop_back")
+        {
+            fst::segmented_vector<fst::string, 4> vec;
+            for (int i = 0; i < 9; i++)
+            {
+                vec.emplace_back("a long string that doesn't fit the small buffer");
+                vec.back().push_back((char) ('a' + i));
+            }
+
+            // Across a chunk boundary.
+            for (int i = 8; i > 2; i--)
+            {
+                REQUIRE_EQ(vec.back().back(), (char) ('a' + i));
+                vec.pop_back();
+            }
+
+            REQUIRE_EQ(vec.size(), 3);
+            REQUIRE_EQ(vec.back().back(), 'c');
+
+            vec.push_back("reused slot");
+            REQUIRE_EQ(vec[3], "reused slot");
+        }
+    }
+
+    BENCH_CASE("fst::segmented_vector push_back", "[core][bench]")
+    {
+        constexpr size_t count = 1 << 20;
+
+        CATCH_BENCHMARK("fst::vector")
+        {
+            fst::vector<uint64_t> vec;
+            for (size_t i = 0; i < count; i++)
+            {
+                vec.push_back(i);
+            }
+            return vec.size();
+        };
+
+        CATCH_BENCHMARK("fst::segmented_vector")
+        {
+            fst::segmented_vector<uint64_t> vec;
+            for (size_t i = 0; i < count; i++)
+            {
+                vec.push_back(i);
+            }
+            return vec.size();
+        };
+    }
+} // namespace
@@ -0,0 +1,136 @@
+#include "utest.h"
+#include "fst/simd_dispatch.h"
+#include "fst/math.h"
+
+namespace
+{
+    template <class T>
+    void test_kernels(T epsilon)
+    {
+        constexpr size_t capacity = 80;
+        alignas(fst::simd::dispatch_alignment) T dst[capacity];
+        alignas(fst::simd::dispatch_alignment) T expected[capacity];
+        alignas(fst::simd::dispatch_alignment) T a[capacity];
+        alignas(fst::simd::dispatch_alignment) T b[capacity];
+
+        for (size_t i = 0; i < capacity; i++)
+        {
+            a[i] = (T) (i + 1) * (T) 0.125;
+            b[i] = (T) 2 - (T) i * (T) 0.0625;
+        }
+
+        // Sizes around every vector size to go through the tails.
+        for (size_t size = 1; size < 70; size++)
+        {
+            const auto check = [&](auto&& kernel, auto&& reference) {
+                for (size_t i = 0; i < capacity; i++)
+                {
+                    dst[i] = expected[i] = b[i];
+                }
+
+                kernel();
+
+                for (size_t i = 0; i < size; i++)
+                {
+                    expected[i] = reference(i);
+                }
+
+                for (size_t i = 0; i < capacity; i++)
+                {
+                    REQUIRE_FLOAT_APPROX(dst[i], expected[i], epsilon * fst::maximum((T) 1, fst::fabs(expected[i])));
+                }
+            };
+
+            check([&] { fst::simd::dispatch::fill(dst, (T) 3, size); }, [&](size_t) { return (T) 3; });
+            check([&] { fst::simd::dispatch::assign(dst, a, size); }, [&](size_t i) { return a[i]; });
+            check([&] { fst::simd::dispatch::add(dst, a, size); }, [&](size_t i) { return b[i] + a[i]; });
+            check([&] { fst::simd::dispatch::add(dst, (T) 2, size); }, [&](size_t i) { return b[i] + (T) 2; });
+            check([&] { fst::simd::dispatch::sub(dst, a, size); }, [&](size_t i) { return b[i] - a[i]; });
+            check([&] { fst::simd::dispatch::sub(dst, (T) 2, size); }, [&](size_t i) { return b[i] - (T) 2; });
+            check([&] { fst::simd::dispatch::mul(dst, a, size); }, [&](size_t i) { return b[i] * a[i]; });
+            check([&] { fst::simd::dispatch::mul(dst, (T) 2, size); }, [&](size_t i) { return b[i] * (T) 2; });
+            check([&] { fst::simd::dispatch::div(dst, a, size); }, [&](size_t i) { return b[i] / a[i]; });
+            check([&] { fst::simd::dispatch::div(dst, (T) 2, size); }, [&](size_t i) { return b[i] / (T) 2; });
+            check([&] { fst::simd::dispatch::add_mul(dst, a, a, size); }, [&](size_t i) { return b[i] + a[i] * a[i]; });
+            check([&] { fst::simd::dispatch::add_mul(dst, a, (T) 0.5, size); }, [&](size_t i) { return b[i] + a[i] * (T) 0.5; });
+            check([&] { fst::simd::dispatch::mul_then_sum(dst, (T) 3, (T) 0.25, size); }, [&](size_t i) { return b[i] * (T) 3 + (T) 0.25; });
+            check([&] { fst::simd::dispatch::min(dst, a, size); }, [&](size_t i) { return fst::minimum(b[i], a[i]); });
+            check([&] { fst::simd::dispatch::max(dst, a, size); }, [&](size_t i) { return fst::maximum(b[i], a[i]); });
+            check([&] { fst::simd::dispatch::sin(dst, a, size); }, [&](size_t i) { return fst::sin(a[i]); });
+            check([&] { fst::simd::dispatch::cos(dst, size); }, [&](size_t i) { return fst::cos(b[i]); });
+            check([&] { fst::simd::dispatch::tan(dst, size); }, [&](size_t i) { return fst::tan(b[i]); });
+        }
+    }
+
+    TEST_CASE("fst::simd::dispatch", "[simd]")
+    {
+        const fst::simd::isa_level detected = fst::simd::detected_isa_level();
+        REQUIRE(detected <= fst::simd::isa_level::avx512);
+        REQUIRE_EQ(fst::simd::current_isa_level(), detected);
+
+        TEST_SECTION("levels")
+        {
+            // Every level up to the detected one can be forced.
+            for (uint8_t level = 0; level <= (uint8_t) fst::simd::isa_level::avx512; level++)
+            {
+                const fst::simd::isa_level isa = (fst::simd::isa_level) level;
+                const bool supported = isa <= detected;
+                REQUIRE_EQ(fst::simd::force_isa_level(isa), supported);
+                REQUIRE_EQ(fst::simd::current_isa_level(), supported ? isa : detected);
+                REQUIRE(fst::simd::isa_level_name(isa) != nullptr);
+
+                if (!supported)
+                {
+                    continue;
+                }
+
+                REQUIRE(fst::simd::get_kernels<float>(isa) != nullptr);
+                REQUIRE(fst::simd::get_kernels<double>(isa) != nullptr);
+                REQUIRE_EQ(&fst::simd::get_kernels<float>(), fst::simd::get_kernels<float>(isa));
+
+                test_kernels<float>(1e-5f);
+                test_kernels<double>(1e-12);
+
+                fst::simd::reset_isa_level();
+            }
+
+            REQUIRE_EQ(fst::simd::current_isa_level(), detected);
+        }
+    }
+
+    BENCH_CASE("fst::simd::dispatch", "[simd][bench]")
+    {
+        constexpr size_t count = 4099;
+        alignas(fst::simd::dispatch_alignment) static float a[count];
+        alignas(fst::simd::dispatch_alignment) static float b[count];
+
+        for (size_t i = 0; i < count; i++)
+        {
+            a[i] = (float) i * 0.001f;
+            b[i] = 0.5f;
+        }
+
+        constexpr const char* mul_add_names[] = { "mul add scalar", "mul add sse4.1", "mul add avx2", "mul add avx512" };
+        constexpr const char* sin_names[] = { "sin scalar", "sin sse4.1", "sin avx2", "sin avx512" };
+
+        for (uint8_t level = 0; level <= (uint8_t) fst::simd::detected_isa_level(); level++)
+        {
+            fst::simd::force_isa_level((fst::simd::isa_level) level);
+
+            CATCH_BENCHMARK(mul_add_names[level])
+            {
+                fst::simd::dispatch::mul(a, b, count);
+                fst::simd::dispatch::add(a, 0.25f, count);
+                return a[count - 1];
+            };
+
+            CATCH_BENCHMARK(sin_names[level])
+            {
+                fst::simd::dispatch::sin(b, a, count);
+                return b[count - 1];
+            };
+        }
+
+        fst::simd::reset_isa_level();
+    }
+} // namespace
@@ -0,0 +1,180 @@
+#include "utest.h"
+#include "fst/simd.h"
+
+namespace
+{
+    template <class T>
+    void test_expressions(T epsilon)
+    {
+        constexpr size_t capacity = 80;
+        constexpr size_t alignment = fst::simd::vector_type_alignment_v<T>;
+        alignas(alignment) T dst[capacity];
+        alignas(alignment) T a[capacity];
+        alignas(alignment) T b[capacity];
+        alignas(alignment) T c[capacity];
+
+        for (size_t i = 0; i < capacity; i++)
+        {
+            a[i] = (T) (i + 1) * (T) 0.125;
+            b[i] = (T) 2 - (T) i * (T) 0.0625;
+            c[i] = (T) ((i * 7) % 13) * (T) 0.25 - (T) 1.5;
+        }
+
+        const T gain = (T) 0.75;
+
+        // Sizes around every vector size to go through the tails.
+        for (size_t size = 1; size < 70; size++)
+        {
+            fst::simd::range<T> rdst(dst, size);
+            const fst::simd::range<const T> ra(a, size);
+            const fst::simd::range<const T> rb(b, size);
+            const fst::simd::range<const T> rc(c, size);
+
+            const auto check = [&](auto&& assign, auto&& reference) {
+                for (size_t i = 0; i < capacity; i++)
+                {
+                    dst[i] = (T) -1;
+                }
+
+                assign();
+
+                for (size_t i = 0; i < size; i++)
+                {
+                    const T expected = reference(i);
+                    REQUIRE_FLOAT_APPROX(dst[i], expected, epsilon * fst::maximum((T) 1, fst::fabs(expected)));
+                }
+
+                // Nothing written past the end.
+                for (size_t i = size; i < capacity; i++)
+                {
+                    REQUIRE_EQ(dst[i], (T) -1);
+                }
+            };
+
+            check([&] { rdst = fst::simd::expr(ra) * rb + fst::simd::expr(rc) * gain; }, [&](size_t i) { return a[i] * b[i] + c[i] * gain; });
+            check([&] { rdst = rc + fst::simd::expr(ra) * rb; }, [&](size_t i) { return c[i] + a[i] * b[i]; });
+            check([&] { rdst = (fst::simd::expr(ra) - rb) / (T) 2 + 1; }, [&](size_t i) { return (a[i] - b[i]) / (T) 2 + (T) 1; });
+            check([&] { rdst = (T) 1 - fst::simd::expr(ra) * (T) 2; }, [&](size_t i) { return (T) 1 - a[i] * (T) 2; });
+            check([&] { rdst = -fst::simd::expr(rc); }, [&](size_t i) { return -c[i]; });
+            check([&] { rdst = fst::simd::abs(fst::simd::expr(rc)); }, [&](size_t i) { return fst::fabs(c[i]); });
+            check([&] { rdst = fst::simd::sqrt(fst::simd::expr(ra)); }, [&](size_t i) { return fst::sqrt(a[i]); });
+            check([&] { rdst = fst::simd::sin(fst::simd::expr(ra) * gain); }, [&](size_t i) { return fst::sin(a[i] * gain); });
+            check([&] { rdst = fst::simd::min(fst::simd::expr(ra), rb); }, [&](size_t i) { return fst::minimum(a[i], b[i]); });
+            check([&] { rdst = fst::simd::max(rb, fst::simd::expr(ra) + rc); }, [&](size_t i) { return fst::maximum(b[i], a[i] + c[i]); });
+
+            check(
+                [&] {
+                    rdst.assign(rb);
+                    rdst += fst::simd::expr(ra) * rc;
+                },
+                [&](size_t i) { return b[i] + a[i] * c[i]; });
+
+            check(
+                [&] {
+                    rdst.assign(rb);
+                    rdst *= fst::simd::expr(ra) + gain;
+                },
+                [&](size_t i) { return b[i] * (a[i] + gain); });
+
+            // The destination can be used in the expression.
+            check(
+                [&] {
+                    rdst.assign(rb);
+                    rdst = fst::simd::expr(rdst) * rdst - ra;
+                },
+                [&](size_t i) { return b[i] * b[i] - a[i]; });
+        }
+    }
+
+    TEST_CASE("fst::simd::expression", "[simd]")
+    {
+        TEST_SECTION("fusion")
+        {
+            using range_type = fst::simd::range<float>;
+            using node_type = decltype(fst::simd::expr(fst::declval<const range_type&>()));
+            using scalar_type = fst::simd::expression::scalar_node<float>;
+            using mul_type = fst::simd::expression::binary_node<fst::simd::expression::mul_fct, node_type, node_type>;
+
+            static_assert(fst::simd::is_expression<node_type>::value, "");
+            static_assert(!fst::simd::is_expression<range_type>::value, "");
+            static_assert(fst::simd::is_container<range_type>::value, "");
+            static_assert(fst::simd::is_container<fst::simd::array<float, 4>>::value, "");
+            static_assert(!fst::simd::is_container<float>::value, "");
+
+            const range_type r;
+            static_assert(fst::is_same_v<decltype(fst::simd::expr(r) * r), mul_type>, "");
+            static_assert(fst::is_same_v<decltype(fst::simd::expr(r) * r + r), fst::simd::expression::mul_add_node<node_type, node_type, node_type>>, "");
+            static_assert(fst::is_same_v<decltype(1.0f + fst::simd::expr(r) * 2.0), fst::simd::expression::mul_add_node<node_type, scalar_type, scalar_type>>, "");
+            static_assert(fst::is_same_v<decltype(fst::simd::expr(r) * r + fst::simd::expr(r) * r), fst::simd::expression::mul_add_node<node_type, node_type, mul_type>>,
+                "");
+        }
+
+        TEST_SECTION("float")
+        {
+            test_expressions<float>(1e-5f);
+        }
+
+        TEST_SECTION("double")
+        {
+            test_expressions<double>(1e-12);
+        }
+
+        TEST_SECTION("fixed")
+        {
+            fst::simd::array<float, 19> a;
+            fst::simd::array<float, 19> b;
+            fst::simd::array<float, 19> out;
+            a.fill_increment(1.0f);
+            b.fill(0.5f);
+
+            out = fst::simd::expr(a) * b + 2.0f;
+            for (size_t i = 0; i < out.size(); i++)
+            {
+                REQUIRE_FLOAT_APPROX(out[i], (float) i * 0.5f + 2.0f, 1e-5f);
+            }
+
+            out -= fst::simd::expr(a) / 2.0f;
+            for (size_t i = 0; i < out.size(); i++)
+            {
+                REQUIRE_FLOAT_APPROX(out[i], 2.0f, 1e-5f);
+            }
+
+            fst::simd::buffer<float> buffer(19);
+            buffer = fst::simd::expr(a) + out;
+            for (size_t i = 0; i < buffer.size(); i++)
+            {
+                REQUIRE_FLOAT_APPROX(buffer[i], (float) i + 2.0f, 1e-5f);
+            }
+        }
+    }
+
+    BENCH_CASE("fst::simd::expression", "[simd][bench]")
+    {
+        // Large enough to stream through the cache.
+        constexpr size_t count = 1 << 18;
+        fst::simd::buffer<float> a(count);
+        fst::simd::buffer<float> b(count);
+        fst::simd::buffer<float> c(count);
+        fst::simd::buffer<float> dst(count);
+        a.fill_increment(0.001f);
+        b.fill(0.5f);
+        c.fill(0.25f);
+        const float gain = 0.75f;
+
+        CATCH_BENCHMARK("one pass per operation")
+        {
+            dst.assign(a);
+            dst.mul(b);
+            dst.add_mul(c, gain);
+            dst.mul(gain);
+            dst.add(1.0f);
+            return dst[count - 1];
+        };
+
+        CATCH_BENCHMARK("expression")
+        {
+            dst = (fst::simd::expr(a) * b + fst::simd::expr(c) * gain) * gain + 1.0f;
+            return dst[count - 1];
+        };
+    }
+} // namespace
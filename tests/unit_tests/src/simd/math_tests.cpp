@@ -0,0 +1,459 @@
+#include "utest.h"
+#include "fst/simd_math.h"
+
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    using fst::simd::math::precision;
+
+    // Error of r in units in the last place of T, against a long double reference.
+    template <class T>
+    long double ulp_error(T r, long double expected)
+    {
+        if (std::isnan(expected))
+        {
+            return std::isnan(r) ? 0 : std::numeric_limits<long double>::infinity();
+        }
+
+        if (std::isinf(expected) || std::isinf(r))
+        {
+            return (long double) r == expected ? 0 : std::numeric_limits<long double>::infinity();
+        }
+
+        const int exponent = expected == 0 ? std::numeric_limits<T>::min_exponent - 1
+                                           : fst::maximum(std::ilogb(expected), std::numeric_limits<T>::min_exponent - 1);
+        const long double ulp = std::ldexp(1.0L, exponent - std::numeric_limits<T>::digits + 1);
+        return std::fabs((long double) r - expected) / ulp;
+    }
+
+    // Max ulp error of a kernel on count points, a and b come from input(i, count, a, b).
+    template <class T, precision P, class Kernel, class Input, class Reference>
+    long double max_ulp_error(size_t count, Kernel&& kernel, Input&& input, Reference&& reference)
+    {
+        using vmath = fst::simd::math::vector_math_t<T, P>;
+        using op = typename vmath::op;
+        constexpr size_t size = op::size;
+
+        alignas(64) T a[size];
+        alignas(64) T b[size];
+        alignas(64) T out[size];
+
+        long double error = 0;
+        for (size_t i = 0; i < count; i += size)
+        {
+            for (size_t k = 0; k < size; k++)
+            {
+                input(i + k, count, a[k], b[k]);
+            }
+
+            op::store(out, kernel(op::load(a), op::load(b)));
+
+            for (size_t k = 0; k < size; k++)
+            {
+                error = fst::maximum(error, ulp_error(out[k], reference((long double) a[k], (long double) b[k])));
+            }
+        }
+
+        return error;
+    }
+
+    template <class T>
+    auto linear(long double first, long double last)
+    {
+        return [=](size_t i, size_t count, T& a, T& b) {
+            a = (T) (first + (last - first) * (long double) i / (long double) count);
+            b = 0;
+        };
+    }
+
+    // Mantissas in [1, 2) spread over binary exponents in [first, last).
+    template <class T>
+    auto exponents(int first, int last)
+    {
+        return [=](size_t i, size_t count, T& a, T& b) {
+            const long double t = (long double) i / (long double) count;
+            const long double e = first + (last - first) * t;
+            const long double f = (long double) (i * 7919 % count) / (long double) count;
+            a = (T) std::ldexp(1 + f, (int) std::floor(e));
+            b = 0;
+        };
+    }
+
+    // Expected max ulp error per function, a bit above what the sweeps measure.
+    struct bounds
+    {
+        long double exp;
+        long double log;
+        long double sin_cos;
+        long double tanh;
+        long double atan2;
+        long double pow;
+    };
+
+    template <class T, precision P>
+    void test_accuracy(const bounds& max_error)
+    {
+        using vmath = fst::simd::math::vector_math_t<T, P>;
+        constexpr bool is_float = std::is_same_v<T, float>;
+        constexpr bool is_precise = P == precision::precise;
+        constexpr size_t count = 20000;
+
+        // Inside the range where the fast exp does not saturate.
+        const long double exp_limit = is_float ? 87 : 708;
+        const long double sin_cos_limit = is_float ? 8000 : 1e6;
+
+        const auto exp_kernel = [](auto a, auto) { return vmath::exp(a); };
+        const auto log_kernel = [](auto a, auto) { return vmath::log(a); };
+        const auto sin_kernel = [](auto a, auto) { return vmath::sin(a); };
+        const auto cos_kernel = [](auto a, auto) { return vmath::cos(a); };
+        const auto pow_kernel = [](auto a, auto b) { return vmath::pow(a, b); };
+
+        const auto exp_ref = [](long double a, long double) { return std::exp(a); };
+        const auto log_ref = [](long double a, long double) { return std::log(a); };
+        const auto sin_ref = [](long double a, long double) { return std::sin(a); };
+        const auto cos_ref = [](long double a, long double) { return std::cos(a); };
+        const auto pow_ref = [](long double a, long double b) { return std::pow(a, b); };
+
+        TEST_SECTION("exp")
+        {
+            REQUIRE(max_ulp_error<T, P>(count, exp_kernel, linear<T>(-exp_limit, exp_limit), exp_ref) <= max_error.exp);
+
+            if constexpr (is_precise)
+            {
+                // Subnormal results.
+                const long double first = is_float ? -103 : -744;
+                REQUIRE(max_ulp_error<T, P>(count, exp_kernel, linear<T>(first, -exp_limit), exp_ref) <= max_error.exp);
+            }
+        }
+
+        TEST_SECTION("log")
+        {
+            const int limit = is_float ? 120 : 1000;
+            REQUIRE(max_ulp_error<T, P>(count, log_kernel, exponents<T>(-limit, limit), log_ref) <= max_error.log);
+            REQUIRE(max_ulp_error<T, P>(count, log_kernel, linear<T>(0.5, 2), log_ref) <= max_error.log);
+
+            if constexpr (is_precise)
+            {
+                const int first = std::numeric_limits<T>::min_exponent - std::numeric_limits<T>::digits;
+                REQUIRE(max_ulp_error<T, P>(count, log_kernel, exponents<T>(first, std::numeric_limits<T>::min_exponent - 1), log_ref)
+                        <= max_error.log);
+            }
+        }
+
+        TEST_SECTION("sin cos")
+        {
+            REQUIRE(max_ulp_error<T, P>(count, sin_kernel, linear<T>(-100, 100), sin_ref) <= max_error.sin_cos);
+            REQUIRE(max_ulp_error<T, P>(count, cos_kernel, linear<T>(-100, 100), cos_ref) <= max_error.sin_cos);
+            REQUIRE(max_ulp_error<T, P>(count, sin_kernel, linear<T>(-sin_cos_limit, sin_cos_limit), sin_ref) <= max_error.sin_cos);
+            REQUIRE(max_ulp_error<T, P>(count, cos_kernel, linear<T>(-sin_cos_limit, sin_cos_limit), cos_ref) <= max_error.sin_cos);
+        }
+
+        TEST_SECTION("tanh")
+        {
+            const auto kernel = [](auto a, auto) { return vmath::tanh(a); };
+            const auto reference = [](long double a, long double) { return std::tanh(a); };
+            REQUIRE(max_ulp_error<T, P>(count, kernel, linear<T>(-12, 12), reference) <= max_error.tanh);
+            REQUIRE(max_ulp_error<T, P>(count, kernel, linear<T>(-1, 1), reference) <= max_error.tanh);
+        }
+
+        TEST_SECTION("atan2")
+        {
+            const auto kernel = [](auto a, auto b) { return vmath::atan2(a, b); };
+            const auto reference = [](long double a, long double b) { return std::atan2(a, b); };
+
+            // Points on circles of radius 1 to 7.
+            const auto input = [](size_t i, size_t count, T& a, T& b) {
+                const long double t = 6.283185307179586477L * (long double) i / (long double) count;
+                const long double r = (long double) (1 + i % 7);
+                a = (T) (r * std::sin(t));
+                b = (T) (r * std::cos(t));
+            };
+
+            REQUIRE(max_ulp_error<T, P>(count, kernel, input, reference) <= max_error.atan2);
+        }
+
+        TEST_SECTION("pow")
+        {
+            const auto input = [](size_t i, size_t count, T& a, T& b) {
+                a = (T) (0.01L + 10.0L * (long double) (i * 7919 % count) / (long double) count);
+                b = (T) (-8.0L + 16.0L * (long double) i / (long double) count);
+            };
+
+            REQUIRE(max_ulp_error<T, P>(count, pow_kernel, input, pow_ref) <= max_error.pow);
+
+            if constexpr (is_precise)
+            {
+                // y * log(x) from first * log_limit to log_limit, the error of the double word log(x) grows with it.
+                const auto results_up_to = [](long double log_limit, long double first) {
+                    return [=](size_t i, size_t count, T& a, T& b) {
+                        const long double x = 1.5L + 100.0L * (long double) (i * 7919 % count) / (long double) count;
+                        a = (T) x;
+                        b = (T) (log_limit / std::log(x) * (first + (1 - first) * (long double) i / (long double) count));
+                    };
+                };
+
+                // Up to overflow and down to the smallest normal result.
+                const long double log_max = std::log((long double) std::numeric_limits<T>::max());
+                const long double log_min = std::log((long double) std::numeric_limits<T>::min());
+                REQUIRE(max_ulp_error<T, P>(count, pow_kernel, results_up_to(log_max, 0), pow_ref) <= max_error.pow);
+                REQUIRE(max_ulp_error<T, P>(count, pow_kernel, results_up_to(log_max, 0.99L), pow_ref) <= max_error.pow);
+                REQUIRE(max_ulp_error<T, P>(count, pow_kernel, results_up_to(log_min, 0), pow_ref) <= max_error.pow);
+                REQUIRE(max_ulp_error<T, P>(count, pow_kernel, results_up_to(log_min, 0.99L), pow_ref) <= max_error.pow);
+            }
+        }
+
+        TEST_SECTION("sqrt")
+        {
+            const auto kernel = [](auto a, auto) { return vmath::sqrt(a); };
+            const auto reference = [](long double a, long double) { return std::sqrt(a); };
+            REQUIRE(max_ulp_error<T, P>(count, kernel, exponents<T>(-100, 100), reference) <= 0.5L);
+        }
+    }
+
+    template <class T>
+    void test_special_values()
+    {
+        using vmath = fst::simd::math::vector_math_t<T, precision::precise>;
+        using op = typename vmath::op;
+
+        constexpr T inf = std::numeric_limits<T>::infinity();
+        constexpr T nan = std::numeric_limits<T>::quiet_NaN();
+        constexpr T pi = (T) 3.14159265358979323846;
+
+        const auto unary = [](auto kernel, T a) {
+            alignas(64) T out[op::size];
+            op::store(out, kernel(op::load(a)));
+            return out[0];
+        };
+
+        const auto binary = [](auto kernel, T a, T b) {
+            alignas(64) T out[op::size];
+            op::store(out, kernel(op::load(a), op::load(b)));
+            return out[0];
+        };
+
+        const auto exp = [](auto a) { return vmath::exp(a); };
+        const auto log = [](auto a) { return vmath::log(a); };
+        const auto sin = [](auto a) { return vmath::sin(a); };
+        const auto cos = [](auto a) { return vmath::cos(a); };
+        const auto tanh = [](auto a) { return vmath::tanh(a); };
+        const auto sqrt = [](auto a) { return vmath::sqrt(a); };
+        const auto pow = [](auto a, auto b) { return vmath::pow(a, b); };
+        const auto atan2 = [](auto a, auto b) { return vmath::atan2(a, b); };
+
+        TEST_SECTION("exp")
+        {
+            REQUIRE_EQ(unary(exp, (T) 0), (T) 1);
+            REQUIRE_EQ(unary(exp, inf), inf);
+            REQUIRE_EQ(unary(exp, -inf), (T) 0);
+            REQUIRE_EQ(unary(exp, (T) 1000), inf);
+            REQUIRE_EQ(unary(exp, (T) -1000), (T) 0);
+            REQUIRE(std::isnan(unary(exp, nan)));
+        }
+
+        TEST_SECTION("log")
+        {
+            REQUIRE_EQ(unary(log, (T) 1), (T) 0);
+            REQUIRE_EQ(unary(log, (T) 0), -inf);
+            REQUIRE_EQ(unary(log, (T) -0.0), -inf);
+            REQUIRE_EQ(unary(log, inf), inf);
+            REQUIRE(std::isnan(unary(log, (T) -1)));
+            REQUIRE(std::isnan(unary(log, -inf)));
+            REQUIRE(std::isnan(unary(log, nan)));
+        }
+
+        TEST_SECTION("pow")
+        {
+            REQUIRE_EQ(binary(pow, (T) 2, (T) 10), (T) 1024);
+            REQUIRE_EQ(binary(pow, (T) -2, (T) 3), (T) -8);
+            REQUIRE_EQ(binary(pow, (T) -2, (T) 2), (T) 4);
+            REQUIRE_EQ(binary(pow, nan, (T) 0), (T) 1);
+            REQUIRE_EQ(binary(pow, (T) 1, nan), (T) 1);
+            REQUIRE_EQ(binary(pow, (T) -1, inf), (T) 1);
+            REQUIRE_EQ(binary(pow, (T) 0, (T) -1), inf);
+            REQUIRE_EQ(binary(pow, (T) 0, (T) 2), (T) 0);
+            REQUIRE_EQ(binary(pow, (T) 10, (T) 1000), inf);
+            REQUIRE_EQ(binary(pow, (T) 10, (T) -1000), (T) 0);
+            REQUIRE(std::isnan(binary(pow, (T) -2, (T) 0.5)));
+            REQUIRE(std::isnan(binary(pow, nan, (T) 1)));
+        }
+
+        TEST_SECTION("sin cos")
+        {
+            REQUIRE_EQ(unary(sin, (T) 0), (T) 0);
+            REQUIRE(std::signbit(unary(sin, (T) -0.0)));
+            REQUIRE_EQ(unary(cos, (T) 0), (T) 1);
+            REQUIRE(std::isnan(unary(sin, inf)));
+            REQUIRE(std::isnan(unary(cos, -inf)));
+            REQUIRE(std::isnan(unary(sin, nan)));
+        }
+
+        TEST_SECTION("tanh")
+        {
+            REQUIRE_EQ(unary(tanh, (T) 0), (T) 0);
+            REQUIRE(std::signbit(unary(tanh, (T) -0.0)));
+            REQUIRE_EQ(unary(tanh, inf), (T) 1);
+            REQUIRE_EQ(unary(tanh, -inf), (T) -1);
+            REQUIRE_EQ(unary(tanh, (T) 100), (T) 1);
+            REQUIRE(std::isnan(unary(tanh, nan)));
+        }
+
+        TEST_SECTION("atan2")
+        {
+            REQUIRE_EQ(binary(atan2, (T) 0, (T) 1), (T) 0);
+            REQUIRE_EQ(binary(atan2, (T) 0, (T) -1), pi);
+            REQUIRE_EQ(binary(atan2, (T) -0.0, (T) -1), -pi);
+            REQUIRE_EQ(binary(atan2, (T) 1, (T) 0), pi / 2);
+            REQUIRE_EQ(binary(atan2, (T) -1, (T) 0), -pi / 2);
+            REQUIRE(std::isnan(binary(atan2, nan, (T) 1)));
+            REQUIRE(std::isnan(binary(atan2, (T) 1, nan)));
+        }
+
+        TEST_SECTION("sqrt")
+        {
+            REQUIRE_EQ(unary(sqrt, (T) 4), (T) 2);
+            REQUIRE_EQ(unary(sqrt, inf), inf);
+            REQUIRE(std::isnan(unary(sqrt, (T) -1)));
+        }
+    }
+
+    template <class T>
+    void test_expressions(T epsilon)
+    {
+        // Not a multiple of any vector size to go through the tail.
+        constexpr size_t size = 37;
+        fst::simd::buffer<T> a(size);
+        fst::simd::buffer<T> b(size);
+        fst::simd::buffer<T> dst(size);
+
+        for (size_t i = 0; i < size; i++)
+        {
+            a[i] = (T) (i + 1) * (T) 0.125;
+            b[i] = (T) 2 - (T) i * (T) 0.0625;
+        }
+
+        const auto check = [&](auto&& reference) {
+            for (size_t i = 0; i < size; i++)
+            {
+                const T expected = reference(i);
+                REQUIRE_FLOAT_APPROX(dst[i], expected, epsilon * fst::maximum((T) 1, fst::fabs(expected)));
+            }
+        };
+
+        using fst::simd::expr;
+        namespace math = fst::simd::math;
+
+        dst = math::exp(expr(a) * (T) -0.5);
+        check([&](size_t i) { return (T) std::exp((long double) a[i] * -0.5L); });
+
+        dst = math::log(expr(a) + b);
+        check([&](size_t i) { return (T) std::log((long double) (a[i] + b[i])); });
+
+        dst = math::sin(expr(a)) * math::cos(expr(b));
+        check([&](size_t i) { return (T) (std::sin((long double) a[i]) * std::cos((long double) b[i])); });
+
+        dst = math::tanh<precision::fast>(expr(b) * (T) 3);
+        check([&](size_t i) { return (T) std::tanh((long double) (b[i] * (T) 3)); });
+
+        dst = math::pow(expr(a), b);
+        check([&](size_t i) { return (T) std::pow((long double) a[i], (long double) b[i]); });
+
+        dst = math::atan2(expr(b), a) + math::sqrt(expr(a));
+        check([&](size_t i) { return (T) (std::atan2((long double) b[i], (long double) a[i]) + std::sqrt((long double) a[i])); });
+    }
+
+    TEST_CASE("fst::simd::math accuracy", "[simd]")
+    {
+        TEST_SECTION("float precise")
+        {
+            test_accuracy<float, precision::precise>({ 1, 1, 1, 1, 1, 1 });
+        }
+
+        TEST_SECTION("double precise")
+        {
+            test_accuracy<double, precision::precise>({ 1, 1, 1, 1, 1, 1 });
+        }
+
+        TEST_SECTION("float fast")
+        {
+            test_accuracy<float, precision::fast>({ 1.5, 1, 2.5, 1.5, 3, 2 });
+        }
+
+        TEST_SECTION("double fast")
+        {
+            test_accuracy<double, precision::fast>({ 1.5, 1, 2.5, 1.5, 3, 2 });
+        }
+    }
+
+    TEST_CASE("fst::simd::math special values", "[simd]")
+    {
+        TEST_SECTION("float")
+        {
+            test_special_values<float>();
+        }
+
+        TEST_SECTION("double")
+        {
+            test_special_values<double>();
+        }
+    }
+
+    TEST_CASE("fst::simd::math expressions", "[simd]")
+    {
+        TEST_SECTION("float")
+        {
+            test_expressions<float>(1e-5f);
+        }
+
+        TEST_SECTION("double")
+        {
+            test_expressions<double>(1e-12);
+        }
+    }
+
+    BENCH_CASE("fst::simd::math", "[simd][bench]")
+    {
+        constexpr size_t count = 4099;
+        fst::simd::buffer<float> a(count);
+        fst::simd::buffer<float> b(count);
+        a.fill_increment(0.001f);
+
+        CATCH_BENCHMARK("scalar exp")
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                b[i] = fst::exp(a[i]);
+            }
+            return b[count - 1];
+        };
+
+        CATCH_BENCHMARK("simd exp precise")
+        {
+            b = fst::simd::math::exp(fst::simd::expr(a));
+            return b[count - 1];
+        };
+
+        CATCH_BENCHMARK("simd exp fast")
+        {
+            b = fst::simd::math::exp<fst::simd::math::precision::fast>(fst::simd::expr(a));
+            return b[count - 1];
+        };
+
+        CATCH_BENCHMARK("scalar tanh")
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                b[i] = fst::tanh(a[i]);
+            }
+            return b[count - 1];
+        };
+
+        CATCH_BENCHMARK("simd tanh fast")
+        {
+            b = fst::simd::math::tanh<fst::simd::math::precision::fast>(fst::simd::expr(a));
+            return b[count - 1];
+        };
+    }
+} // namespace
@@ -0,0 +1,214 @@
+#include "utest.h"
+#include "fst/simd.h"
+#include <limits>
+
+namespace
+{
+    template <class T>
+    void test_reductions(T epsilon)
+    {
+        constexpr size_t capacity = 80;
+        constexpr size_t alignment = fst::simd::vector_type_alignment_v<T>;
+        alignas(alignment) T a[capacity];
+        alignas(alignment) T b[capacity];
+
+        // Garbage past the end must never show up in the results.
+        for (size_t i = 0; i < capacity; i++)
+        {
+            a[i] = (T) 1000;
+            b[i] = (T) 1000;
+        }
+
+        // Sizes around every vector size to go through the tails.
+        for (size_t size = 1; size < 70; size++)
+        {
+            for (size_t i = 0; i < size; i++)
+            {
+                a[i] = (T) ((i * 7) % 13) * (T) 0.25 - (T) 1.5;
+                b[i] = (T) 2 - (T) i * (T) 0.0625;
+            }
+
+            const fst::simd::range<const T> ra(a, size);
+            const fst::simd::range<const T> rb(b, size);
+
+            double sum = 0;
+            double dot = 0;
+            double sumsq = 0;
+            T min_value = a[0];
+            T max_value = a[0];
+            T peak = fst::fabs(a[0]);
+            size_t argmin = 0;
+            size_t argmax = 0;
+
+            for (size_t i = 0; i < size; i++)
+            {
+                sum += (double) a[i];
+                dot += (double) a[i] * (double) b[i];
+                sumsq += (double) a[i] * (double) a[i];
+                peak = fst::maximum(peak, fst::fabs(a[i]));
+
+                if (a[i] < min_value)
+                {
+                    min_value = a[i];
+                    argmin = i;
+                }
+
+                if (a[i] > max_value)
+                {
+                    max_value = a[i];
+                    argmax = i;
+                }
+            }
+
+            const double mean = sum / (double) size;
+            double variance = 0;
+            for (size_t i = 0; i < size; i++)
+            {
+                variance += ((double) a[i] - mean) * ((double) a[i] - mean);
+            }
+            variance /= (double) size;
+
+            const T scale = (T) size;
+            REQUIRE_FLOAT_APPROX(ra.sum(), (T) sum, epsilon * scale);
+            REQUIRE_FLOAT_APPROX(ra.horizontal_sum(), (T) sum, epsilon * scale);
+            REQUIRE_FLOAT_APPROX(ra.dot(rb), (T) dot, epsilon * scale);
+            REQUIRE_FLOAT_APPROX(ra.sum_of_squares(), (T) sumsq, epsilon * scale);
+            REQUIRE_FLOAT_APPROX(ra.norm(), (T) fst::sqrt(sumsq), epsilon * scale);
+            REQUIRE_FLOAT_APPROX(ra.rms(), (T) fst::sqrt(sumsq / (double) size), epsilon * scale);
+            REQUIRE_FLOAT_APPROX(ra.mean(), (T) mean, epsilon * scale);
+            REQUIRE_EQ(ra.minimum(), min_value);
+            REQUIRE_EQ(ra.maximum(), max_value);
+            REQUIRE_EQ(ra.peak(), peak);
+            REQUIRE_EQ(ra.argmin(), argmin);
+            REQUIRE_EQ(ra.argmax(), argmax);
+
+            const fst::simd::mean_variance_result<T> mv = ra.mean_variance();
+            REQUIRE_FLOAT_APPROX(mv.mean, (T) mean, epsilon * scale);
+            REQUIRE_FLOAT_APPROX(mv.variance, (T) variance, epsilon * scale);
+            REQUIRE_FLOAT_APPROX(ra.variance(), (T) variance, epsilon * scale);
+        }
+    }
+
+    TEST_CASE("fst::simd::reductions", "[simd]")
+    {
+        TEST_SECTION("float")
+        {
+            test_reductions<float>(1e-5f);
+        }
+
+        TEST_SECTION("double")
+        {
+            test_reductions<double>(1e-12);
+        }
+
+        TEST_SECTION("fixed")
+        {
+            fst::simd::array<float, 19> arr;
+            arr.fill_increment(1.0f);
+
+            // 0, 1, ..., 18
+            REQUIRE_FLOAT_APPROX(arr.sum(), 171.0f, 1e-4f);
+            REQUIRE_FLOAT_APPROX(arr.mean(), 9.0f, 1e-5f);
+            REQUIRE_FLOAT_APPROX(arr.variance(), 30.0f, 1e-4f);
+            REQUIRE_FLOAT_APPROX(arr.dot(arr), 2109.0f, 1e-3f);
+            REQUIRE_EQ(arr.minimum(), 0.0f);
+            REQUIRE_EQ(arr.maximum(), 18.0f);
+            REQUIRE_EQ(arr.argmin(), (size_t) 0);
+            REQUIRE_EQ(arr.argmax(), (size_t) 18);
+
+            arr[7] = -20.0f;
+            REQUIRE_EQ(arr.peak(), 20.0f);
+            REQUIRE_EQ(arr.argmin(), (size_t) 7);
+        }
+
+        TEST_SECTION("first index")
+        {
+            fst::simd::buffer<double> buffer(37);
+            buffer.fill(1.0);
+            buffer[5] = 4.0;
+            buffer[30] = 4.0;
+            buffer[9] = -2.0;
+            buffer[33] = -2.0;
+
+            REQUIRE_EQ(buffer.argmax(), (size_t) 5);
+            REQUIRE_EQ(buffer.argmin(), (size_t) 9);
+        }
+
+        TEST_SECTION("nan")
+        {
+            const float nan = std::numeric_limits<float>::quiet_NaN();
+
+            fst::simd::buffer<float> buffer(37);
+            buffer.fill(1.0f);
+            buffer[0] = nan;
+            buffer[3] = nan;
+            buffer[12] = 4.0f;
+            buffer[20] = -2.0f;
+            buffer[36] = nan;
+
+            REQUIRE_EQ(buffer.argmax(), (size_t) 12);
+            REQUIRE_EQ(buffer.argmin(), (size_t) 20);
+
+            buffer[12] = nan;
+            buffer[20] = nan;
+            REQUIRE_EQ(buffer.argmax(), (size_t) 1);
+            REQUIRE_EQ(buffer.argmin(), (size_t) 1);
+
+            buffer.fill(nan);
+            REQUIRE_EQ(buffer.argmax(), (size_t) 0);
+            REQUIRE_EQ(buffer.argmin(), (size_t) 0);
+
+            // The last element always goes through the scalar loop.
+            fst::simd::array<double, 3> arr;
+            arr.fill((double) nan);
+            arr[1] = 2.0;
+            REQUIRE_EQ(arr.argmax(), (size_t) 1);
+            REQUIRE_EQ(arr.argmin(), (size_t) 1);
+        }
+    }
+
+    BENCH_CASE("fst::simd::reductions", "[simd][bench]")
+    {
+        // Not a multiple of any vector size to go through the tail.
+        constexpr size_t count = 4099;
+        fst::simd::buffer<float> a(count);
+        fst::simd::buffer<float> b(count);
+        a.fill_increment(0.001f);
+        b.fill(0.5f);
+
+        CATCH_BENCHMARK("scalar dot")
+        {
+            float sum = 0;
+            for (size_t i = 0; i < count; i++)
+            {
+                sum += a[i] * b[i];
+            }
+            return sum;
+        };
+
+        CATCH_BENCHMARK("simd dot")
+        {
+            return a.dot(b);
+        };
+
+        CATCH_BENCHMARK("scalar peak")
+        {
+            float peak = 0;
+            for (size_t i = 0; i < count; i++)
+            {
+                peak = fst::maximum(peak, fst::fabs(a[i]));
+            }
+            return peak;
+        };
+
+        CATCH_BENCHMARK("simd peak")
+        {
+            return a.peak();
+        };
+
+        CATCH_BENCHMARK("simd mean variance")
+        {
+            return a.mean_variance().variance;
+        };
+    }
+} // namespace
@@ -0,0 +1,276 @@
+#include "utest.h"
+#include "fst/simd.h"
+
+namespace
+{
+    template <class T>
+    void test_vector_op(T epsilon)
+    {
+        using op = fst::simd::vector_op<fst::simd::vector_type_t<T>, T>;
+        using vec_type = typename op::vec_type;
+        constexpr size_t size = op::size;
+
+        alignas(64) T a[size];
+        alignas(64) T b[size];
+        alignas(64) T out[size];
+
+        for (size_t i = 0; i < size; i++)
+        {
+            a[i] = (T) (i + 1) * (T) 0.25;
+            b[i] = (T) (size - i) * (T) 0.5;
+        }
+
+        const vec_type va = op::load(a);
+        const vec_type vb = op::load(b);
+
+        op::store(out, op::add(va, vb));
+        for (size_t i = 0; i < size; i++)
+        {
+            REQUIRE_EQ(out[i], a[i] + b[i]);
+        }
+
+        op::store(out, op::sub(va, vb));
+        for (size_t i = 0; i < size; i++)
+        {
+            REQUIRE_EQ(out[i], a[i] - b[i]);
+        }
+
+        op::store(out, op::mul(va, vb));
+        for (size_t i = 0; i < size; i++)
+        {
+            REQUIRE_EQ(out[i], a[i] * b[i]);
+        }
+
+        op::store(out, op::div(va, vb));
+        for (size_t i = 0; i < size; i++)
+        {
+            REQUIRE_FLOAT_APPROX(out[i], a[i] / b[i], epsilon);
+        }
+
+        op::store(out, op::mul_add(va, vb, va));
+        for (size_t i = 0; i < size; i++)
+        {
+            REQUIRE_FLOAT_APPROX(out[i], a[i] * b[i] + a[i], epsilon);
+        }
+
+        op::store(out, op::min(va, vb));
+        for (size_t i = 0; i < size; i++)
+        {
+            REQUIRE_EQ(out[i], fst::minimum(a[i], b[i]));
+        }
+
+        op::store(out, op::max(va, vb));
+        for (size_t i = 0; i < size; i++)
+        {
+            REQUIRE_EQ(out[i], fst::maximum(a[i], b[i]));
+        }
+
+        op::store(out, op::sqrt(va));
+        for (size_t i = 0; i < size; i++)
+        {
+            REQUIRE_FLOAT_APPROX(out[i], fst::sqrt(a[i]), epsilon);
+        }
+
+        op::store(out, op::sin(va));
+        for (size_t i = 0; i < size; i++)
+        {
+            REQUIRE_FLOAT_APPROX(out[i], fst::sin(a[i]), epsilon);
+        }
+
+        op::store(out, op::cos(op::sub(va, vb)));
+        for (size_t i = 0; i < size; i++)
+        {
+            REQUIRE_FLOAT_APPROX(out[i], fst::cos(a[i] - b[i]), epsilon);
+        }
+
+        op::store(out, op::tan(va));
+        for (size_t i = 0; i < size; i++)
+        {
+            REQUIRE_FLOAT_APPROX(out[i], fst::tan(a[i]), epsilon * fst::maximum((T) 1, fst::fabs(fst::tan(a[i]))));
+        }
+
+        op::store(out, op::log(va));
+        for (size_t i = 0; i < size; i++)
+        {
+            REQUIRE_FLOAT_APPROX(out[i], fst::log(a[i]), epsilon);
+        }
+
+        op::store(out, op::exp2(va));
+        for (size_t i = 0; i < size; i++)
+        {
+            REQUIRE_FLOAT_APPROX(out[i], fst::exp2(a[i]), epsilon * fst::exp2(a[i]));
+        }
+
+        op::store(out, op::exp10(va));
+        for (size_t i = 0; i < size; i++)
+        {
+            REQUIRE_FLOAT_APPROX(out[i], fst::exp10(a[i]), epsilon * fst::exp10(a[i]));
+        }
+
+        op::store(out, op::pow(va, vb));
+        for (size_t i = 0; i < size; i++)
+        {
+            REQUIRE_FLOAT_APPROX(out[i], fst::pow(a[i], b[i]), epsilon * fst::pow(a[i], b[i]));
+        }
+
+        T sum = 0;
+        for (size_t i = 0; i < size; i++)
+        {
+            sum += a[i];
+        }
+        REQUIRE_FLOAT_APPROX(op::hsum(va), sum, epsilon);
+
+        // Partial load and store.
+        for (size_t count = 1; count < size; count++)
+        {
+            op::store(out, op::load_partial(a, count));
+            for (size_t i = 0; i < size; i++)
+            {
+                REQUIRE_EQ(out[i], i < count ? a[i] : (T) 0);
+            }
+
+            for (size_t i = 0; i < size; i++)
+            {
+                out[i] = (T) -1;
+            }
+
+            op::store_partial(out, vb, count);
+            for (size_t i = 0; i < size; i++)
+            {
+                REQUIRE_EQ(out[i], i < count ? b[i] : (T) -1);
+            }
+        }
+    }
+
+    template <class T>
+    void test_tail()
+    {
+        constexpr size_t capacity = 64;
+        constexpr size_t alignment = fst::simd::vector_type_alignment_v<T>;
+        alignas(alignment) T data[capacity];
+        alignas(alignment) T input[capacity];
+
+        for (size_t i = 0; i < capacity; i++)
+        {
+            input[i] = (T) i;
+        }
+
+        for (size_t size = 1; size < 40; size++)
+        {
+            for (size_t i = 0; i < capacity; i++)
+            {
+                data[i] = (T) -1;
+            }
+
+            fst::simd::range<T> r(data, size);
+            fst::simd::range<const T> in(input, size);
+            r.fill((T) 2);
+            r.add((T) 1);
+            r.mul(in);
+
+            for (size_t i = 0; i < size; i++)
+            {
+                REQUIRE_EQ(data[i], (T) 3 * (T) i);
+            }
+
+            // Nothing written past the end.
+            for (size_t i = size; i < capacity; i++)
+            {
+                REQUIRE_EQ(data[i], (T) -1);
+            }
+        }
+    }
+
+    TEST_CASE("fst::simd::vector_op", "[simd]")
+    {
+        TEST_SECTION("float")
+        {
+            test_vector_op<float>(1e-5f);
+        }
+
+        TEST_SECTION("double")
+        {
+            test_vector_op<double>(1e-12);
+        }
+    }
+
+    TEST_CASE("fst::simd::range tail", "[simd]")
+    {
+        TEST_SECTION("float")
+        {
+            test_tail<float>();
+        }
+
+        TEST_SECTION("double")
+        {
+            test_tail<double>();
+        }
+
+        TEST_SECTION("fixed")
+        {
+            alignas(64) float data[24] = {};
+            fst::simd::array<float, 19> arr;
+            arr.fill(4.0f);
+            arr.sin();
+
+            for (size_t i = 0; i < arr.size(); i++)
+            {
+                REQUIRE_FLOAT_APPROX(arr[i], fst::sin(4.0f), 1e-5f);
+            }
+
+            fst::simd::fixed_range<float, 19> r = { data };
+            r.fill(1.0f);
+            r += arr;
+
+            for (size_t i = 0; i < 19; i++)
+            {
+                REQUIRE_FLOAT_APPROX(data[i], 1.0f + fst::sin(4.0f), 1e-5f);
+            }
+
+            for (size_t i = 19; i < 24; i++)
+            {
+                REQUIRE_EQ(data[i], 0.0f);
+            }
+        }
+    }
+
+    BENCH_CASE("fst::simd::vector_op", "[simd][bench]")
+    {
+        // Not a multiple of any vector size to go through the tail.
+        constexpr size_t count = 4099;
+        fst::simd::buffer<float> a(count);
+        fst::simd::buffer<float> b(count);
+        a.fill_increment(0.001f);
+        b.fill(0.5f);
+
+        CATCH_BENCHMARK("scalar mul add")
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                a[i] = a[i] * b[i] + 0.25f;
+            }
+            return a[count - 1];
+        };
+
+        CATCH_BENCHMARK("simd mul add")
+        {
+            a.mul(b).add(0.25f);
+            return a[count - 1];
+        };
+
+        CATCH_BENCHMARK("scalar sin")
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                b[i] = fst::sin(a[i]);
+            }
+            return b[count - 1];
+        };
+
+        CATCH_BENCHMARK("simd sin")
+        {
+            b.sin(a);
+            return b[count - 1];
+        };
+    }
+} // namespace
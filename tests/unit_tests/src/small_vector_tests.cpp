@@ -3,6 +3,56 @@
 
 namespace
 {
+    // Counts the live objects and the destructor calls on slots that don't hold one.
+    struct tracked
+    {
+        static constexpr uint32_t live_tag = 0x7ACCED00;
+        static inline int alive = 0;
+        static inline int bad_destructions = 0;
+
+        tracked(int v = 0) noexcept
+            : tag(live_tag)
+            , value(v)
+        {
+            alive++;
+        }
+
+        tracked(const tracked& other) noexcept
+            : tracked(other.value)
+        {}
+
+        tracked(tracked&& other) noexcept
+            : tracked(other.value)
+        {}
+
+        tracked& operator=(const tracked& other) noexcept
+        {
+            value = other.value;
+            return *this;
+        }
+
+        tracked& operator=(tracked&& other) noexcept
+        {
+            value = other.value;
+            return *this;
+        }
+
+        ~tracked() noexcept
+        {
+            if (tag != live_tag)
+            {
+                bad_destructions++;
+                return;
+            }
+
+            tag = 0;
+            alive--;
+        }
+
+        uint32_t tag;
+        int value;
+    };
+
     TEST_CASE_T("fst::small_vector", "[vector]", //
         (fst::small_vector<int, 4>), //
         (fst::relocatable_small_vector<int, 4>) )
@@ -60,4 +110,50 @@ namespace
         REQUIRE(vec.has_allocated_data());
         REQUIRE_EQ(vec.capacity(), 8);
     }
+
+    TEST_CASE_T("fst::small_vector::erase()", "[vector]", //
+        (fst::small_vector<tracked, 16>), //
+        (fst::small_vector<tracked, 4>), //
+        (fst::relocatable_small_vector<tracked, 16>))
+    {
+        using vector_type = TestType;
+
+        tracked::alive = 0;
+        tracked::bad_destructions = 0;
+
+        {
+            vector_type vec;
+
+            for (int i = 0; i < 8; i++)
+            {
+                vec.push_back(tracked(i));
+            }
+
+            REQUIRE_EQ(tracked::alive, 8);
+
+            vec.pop_back();
+            REQUIRE_EQ(tracked::alive, 7);
+            REQUIRE_EQ(vec.back().value, 6);
+
+            // 0 1 2 3 4 5 6 -> 0 2 3 4 5 6
+            vec.erase_at(1);
+            REQUIRE_EQ(tracked::alive, 6);
+            REQUIRE_EQ(vec[1].value, 2);
+            REQUIRE_EQ(vec.back().value, 6);
+
+            // 0 2 3 4 5 6 -> 6 2 3 4 5
+            vec.unordered_erase(0);
+            REQUIRE_EQ(tracked::alive, 5);
+            REQUIRE_EQ(vec[0].value, 6);
+            REQUIRE_EQ(vec.back().value, 5);
+
+            vec.erase_at(vec.size() - 1);
+            vec.unordered_erase(vec.size() - 1);
+            REQUIRE_EQ(tracked::alive, 3);
+            REQUIRE_EQ(vec.size(), 3);
+        }
+
+        REQUIRE_EQ(tracked::alive, 0);
+        REQUIRE_EQ(tracked::bad_destructions, 0);
+    }
 } // namespace
@@ -0,0 +1,160 @@
+#include "utest.h"
+#include "fst/trace.h"
+#include "fst/async/thread.h"
+#include "fst/file_view.h"
+#include "fst/string.h"
+
+namespace
+{
+    struct trace_tests_section
+    {
+        static constexpr const char* name = "trace_tests";
+    };
+
+    struct string_stream
+    {
+        fst::string str;
+
+        inline fst::output_stream<char> stream() noexcept
+        {
+            return fst::output_stream<char>(
+                this, [](void* data, const char* s, size_t size, fst::stream_modifier) noexcept -> size_t
+                {
+                    ((string_stream*) data)->str.append(s, size);
+                    return size;
+                });
+        }
+    };
+
+    inline fst::string decode_current_trace()
+    {
+        fst::trace_flush();
+
+        fst::file_view view;
+        if (!view.open(fst::trace_file_path())) { return fst::string(); }
+
+        string_stream out;
+        fst::output_stream<char> stream = out.stream();
+        if (!fst::decode_trace(view.data(), view.size(), stream)) { return fst::string(); }
+        return out.str;
+    }
+
+    inline bool contains(const fst::string& str, const char* s) { return str.find(s) != fst::string::npos; }
+
+    TEST_CASE("fst::trace", "[core]")
+    {
+        TEST_SECTION("decode")
+        {
+            fst_trace(2, trace_tests_section, "decode", 12, -3, 2.5f, true, 'c');
+            fst_trace(3, trace_tests_section);
+
+            const fst::string text = decode_current_trace();
+            REQUIRE(contains(text, "section : trace_tests"));
+            REQUIRE(contains(text, "level   : 02"));
+            REQUIRE(contains(text, "message : decode 12 -3 2.5 true c \n\n"));
+            REQUIRE(contains(text, "level   : 03"));
+            REQUIRE(contains(text, "trace_tests.cpp'"));
+        }
+
+        TEST_SECTION("long message")
+        {
+            fst::string long_text;
+            for (size_t i = 0; i < 100; i++)
+            {
+                long_text.append("0123456789");
+            }
+
+            fst_trace(1, trace_tests_section, "begin_long", "abcdefghijklmnopqrstuvwxyz", "ABCDEFGHIJKLMNOPQRSTUVWXYZ", "end_long");
+            fst_trace(1, trace_tests_section, "truncated", long_text.c_str());
+
+            const fst::string text = decode_current_trace();
+            REQUIRE(contains(text, "message : begin_long abcdefghijklmnopqrstuvwxyz ABCDEFGHIJKLMNOPQRSTUVWXYZ end_long \n\n"));
+            REQUIRE(contains(text, "message : truncated 0123456789"));
+            REQUIRE(contains(text, "... \n\n"));
+        }
+
+        TEST_SECTION("threads")
+        {
+            fst::async::thread t0([]() { fst_trace(1, trace_tests_section, "thread", 0); });
+            fst::async::thread t1([]() { fst_trace(1, trace_tests_section, "thread", 1); });
+            fst::async::thread t2([]() { fst_trace(1, trace_tests_section, "thread", 2); });
+            t0.join();
+            t1.join();
+            t2.join();
+
+            const fst::string text = decode_current_trace();
+            REQUIRE(contains(text, "message : thread 0 "));
+            REQUIRE(contains(text, "message : thread 1 "));
+            REQUIRE(contains(text, "message : thread 2 "));
+        }
+
+        TEST_SECTION("null string")
+        {
+            const char* str = nullptr;
+            fst_trace(1, trace_tests_section, "null", str);
+
+            const fst::string text = decode_current_trace();
+            REQUIRE(contains(text, "message : null (null) \n\n"));
+        }
+
+        TEST_SECTION("invalid")
+        {
+            const char data[] = "not a trace file";
+            string_stream out;
+            fst::output_stream<char> stream = out.stream();
+            REQUIRE_FALSE(fst::decode_trace(data, sizeof(data), stream));
+            REQUIRE(out.str.empty());
+        }
+
+        TEST_SECTION("corrupted")
+        {
+            fst_trace(1, trace_tests_section, "corrupted");
+            fst::trace_flush();
+
+            fst::file_view view;
+            REQUIRE(view.open(fst::trace_file_path()));
+
+            // Ids and sizes set to 0xFFFFFFFF must be rejected or ignored, never allocated for.
+            fst::string data((const char*) view.data(), view.size());
+            const size_t size = fst::minimum(data.size(), (size_t) 4096) & ~(size_t) 3;
+            for (size_t i = 0; i < size; i += 4)
+            {
+                fst::string corrupted = data;
+                fst::memset(corrupted.data() + i, 0xFF, 4);
+
+                string_stream out;
+                fst::output_stream<char> stream = out.stream();
+                (void) fst::decode_trace(corrupted.data(), corrupted.size(), stream);
+            }
+        }
+    }
+
+    BENCH_CASE("fst::trace", "[core][bench]")
+    {
+        int value = 0;
+
+        CATCH_BENCHMARK("fst_trace")
+        {
+            for (int i = 0; i < 1000; i++)
+            {
+                fst_trace(5, trace_tests_section, "bench", i, 0.5f);
+            }
+
+            // Keeps the ring buffer from filling up between samples.
+            fst::trace_flush();
+            return ++value;
+        };
+
+        CATCH_BENCHMARK("trace_stream")
+        {
+            const fst::source_location loc = fst::source_location::current();
+            for (int i = 0; i < 1000; i++)
+            {
+                fst::basic_print<fst::output_stream<char>, fst::stream_detail::stream_space_t, fst::stream_detail::stream_endl_t>(
+                    fst::trace_stream(5, trace_tests_section::name, loc, 2), "bench", i, 0.5f, fst::endl);
+            }
+
+            return ++value;
+        };
+    }
+} // namespace
@@ -0,0 +1,325 @@
+#include "utest.h"
+#include "fst/unordered_map.h"
+#include "fst/string.h"
+#include <unordered_map>
+
+namespace
+{
+    struct counted_value
+    {
+        static inline int constructed = 0;
+
+        counted_value(int a, int b) noexcept
+            : value(a + b)
+        {
+            constructed++;
+        }
+
+        counted_value(const counted_value& other) noexcept
+            : value(other.value)
+        {
+            constructed++;
+        }
+
+        counted_value(counted_value&& other) noexcept
+            : value(other.value)
+        {
+            constructed++;
+        }
+
+        counted_value& operator=(const counted_value&) noexcept = default;
+        counted_value& operator=(counted_value&&) noexcept = default;
+
+        int value;
+    };
+
+    TEST_CASE("fst::unordered_map", "[core]")
+    {
+        TEST_SECTION("insert and find")
+        {
+            fst::unordered_map<int, int> map;
+            for (int i = 0; i < 1000; i++)
+            {
+                REQUIRE(map.insert(i, i * 2));
+            }
+
+            REQUIRE_EQ(map.size(), 1000);
+            REQUIRE_FALSE(map.insert(10, 0));
+            REQUIRE_NE(map.bucket_count(), 0);
+
+            for (int i = 0; i < 1000; i++)
+            {
+                auto it = map.find(i);
+                REQUIRE_NE(it, map.end());
+                REQUIRE_EQ(*it, i * 2);
+                REQUIRE_EQ(map.keys()[(size_t) (it - map.begin())], i);
+            }
+
+            REQUIRE_EQ(map.find(1000), map.end());
+            REQUIRE_FALSE(map.contains(-1));
+        }
+
+        TEST_SECTION("operator[]")
+        {
+            fst::unordered_map<int, int> map;
+            for (int i = 0; i < 100; i++)
+            {
+                map[i % 10] += 1;
+            }
+
+            REQUIRE_EQ(map.size(), 10);
+            // The smallest index is one control group (32 slots with AVX2).
+            REQUIRE_EQ(map.bucket_count(), fst::detail::hash_table_group::width);
+            REQUIRE_EQ(map[3], 10);
+        }
+
+        TEST_SECTION("erase")
+        {
+            fst::unordered_map<int, int> map;
+            for (int i = 0; i < 500; i++)
+            {
+                map[i] = i;
+            }
+
+            for (int i = 0; i < 500; i += 2)
+            {
+                REQUIRE_EQ(map.erase(i), 1);
+            }
+
+            REQUIRE_EQ(map.erase(0), 0);
+            REQUIRE_EQ(map.size(), 250);
+
+            for (int i = 0; i < 500; i++)
+            {
+                REQUIRE_EQ(map.contains(i), (i % 2) == 1);
+            }
+
+            // Values follow their key when the last entry is moved into the hole.
+            for (const int& v : map)
+            {
+                REQUIRE_EQ(map.keys()[(size_t) (&v - map.begin())], v);
+            }
+
+            REQUIRE_EQ(map.erase(map.find(1)), 1);
+            REQUIRE_FALSE(map.contains(1));
+        }
+
+        TEST_SECTION("emplace")
+        {
+            fst::unordered_map<int, counted_value> map;
+            map.reserve(100);
+            counted_value::constructed = 0;
+
+            for (int i = 0; i < 100; i++)
+            {
+                REQUIRE(map.emplace(i, i, 1));
+            }
+
+            // Built in place, and never when the key is already there.
+            REQUIRE_EQ(counted_value::constructed, 100);
+            REQUIRE_FALSE(map.emplace(5, 0, 0));
+            REQUIRE_EQ(counted_value::constructed, 100);
+            REQUIRE_EQ(map.find(5)->value, 6);
+        }
+
+        TEST_SECTION("churn")
+        {
+            // Lots of insert/erase cycles on a small key range leave tombstones behind.
+            fst::unordered_map<uint32_t, uint32_t> map;
+            for (uint32_t i = 0; i < 100000; i++)
+            {
+                map[i] = i;
+                if (i >= 64) { REQUIRE_EQ(map.erase(i - 64), 1); }
+            }
+
+            REQUIRE_EQ(map.size(), 64);
+            REQUIRE(map.bucket_count() <= 128);
+
+            for (uint32_t i = 100000 - 64; i < 100000; i++)
+            {
+                REQUIRE_EQ(*map.find(i), i);
+            }
+        }
+
+        TEST_SECTION("reserve and rehash")
+        {
+            fst::unordered_map<int, int> map;
+            map.reserve(1000);
+            const size_t buckets = map.bucket_count();
+            REQUIRE(buckets * 7 / 8 >= 1000);
+
+            for (int i = 0; i < 1000; i++)
+            {
+                map[i] = i;
+            }
+
+            REQUIRE_EQ(map.bucket_count(), buckets);
+
+            map.rehash(buckets * 4);
+            REQUIRE_EQ(map.bucket_count(), buckets * 4);
+            REQUIRE_EQ(*map.find(999), 999);
+
+            for (int i = 8; i < 1000; i++)
+            {
+                map.erase(i);
+            }
+
+            map.rehash(0);
+            REQUIRE_EQ(map.bucket_count(), 0);
+            REQUIRE_EQ(*map.find(7), 7);
+        }
+
+        TEST_SECTION("string keys")
+        {
+            fst::unordered_map<fst::string, int> map;
+            for (int i = 0; i < 200; i++)
+            {
+                fst::string key = "key";
+                key.push_back((char) ('a' + i % 26));
+                key.push_back((char) ('a' + i / 26));
+                map[key] = i;
+            }
+
+            REQUIRE_EQ(map.size(), 200);
+
+            // Heterogeneous lookups don't build a string.
+            REQUIRE(map.contains(fst::string_view("keyaa")));
+            REQUIRE(map.contains("keyzg"));
+            REQUIRE_EQ(*map.find(fst::string_view("keyba")), 1);
+            REQUIRE_EQ(map.find("nope"), map.end());
+            REQUIRE_EQ(map.erase(fst::string_view("keyba")), 1);
+            REQUIRE_FALSE(map.contains("keyba"));
+        }
+
+        TEST_SECTION("copy and move")
+        {
+            fst::unordered_map<int, int> map;
+            for (int i = 0; i < 100; i++)
+            {
+                map[i] = i;
+            }
+
+            fst::unordered_map<int, int> copy = map;
+            map.clear();
+            REQUIRE(map.empty());
+            REQUIRE_FALSE(map.contains(5));
+            REQUIRE_EQ(*copy.find(5), 5);
+
+            fst::unordered_map<int, int> moved = static_cast<fst::unordered_map<int, int>&&>(copy);
+            REQUIRE_EQ(moved.size(), 100);
+            REQUIRE_EQ(*moved.find(99), 99);
+        }
+    }
+
+    TEST_CASE("fst::small_unordered_map", "[core]")
+    {
+        fst::small_unordered_map<int, float, 8> map;
+        for (int i = 0; i < 8; i++)
+        {
+            map[i] = (float) i;
+        }
+
+        // Small maps are searched linearly, no index is allocated.
+        REQUIRE_EQ(map.bucket_count(), 0);
+        REQUIRE_EQ(*map.find(7), 7.0f);
+
+        for (int i = 8; i < 100; i++)
+        {
+            REQUIRE(map.emplace(i, (float) i));
+        }
+
+        REQUIRE_NE(map.bucket_count(), 0);
+        REQUIRE_EQ(*map.find(99), 99.0f);
+        REQUIRE_EQ(map.erase(50), 1);
+        REQUIRE_EQ(map.find(50), map.end());
+    }
+
+    BENCH_CASE("fst::unordered_map lookup", "[core][bench]")
+    {
+        constexpr uint32_t count = 4096;
+
+        // The previous fst::unordered_map, keys are scanned linearly.
+        struct linear_map
+        {
+            fst::vector<uint32_t> keys;
+            fst::vector<uint32_t> values;
+
+            uint32_t* find(uint32_t key) noexcept
+            {
+                for (size_t i = 0; i < keys.size(); i++)
+                {
+                    if (keys[i] == key) { return values.data() + i; }
+                }
+                return nullptr;
+            }
+        };
+
+        fst::unordered_map<uint32_t, uint32_t> map;
+        std::unordered_map<uint32_t, uint32_t> std_map;
+        linear_map lmap;
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            const uint32_t key = i * 2654435761u;
+            map[key] = i;
+            std_map[key] = i;
+            lmap.keys.push_back(key);
+            lmap.values.push_back(i);
+        }
+
+        CATCH_BENCHMARK("linear")
+        {
+            uint64_t sum = 0;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                sum += *lmap.find(i * 2654435761u);
+            }
+            return sum;
+        };
+
+        CATCH_BENCHMARK("fst::unordered_map")
+        {
+            uint64_t sum = 0;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                sum += *map.find(i * 2654435761u);
+            }
+            return sum;
+        };
+
+        CATCH_BENCHMARK("std::unordered_map")
+        {
+            uint64_t sum = 0;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                sum += std_map.find(i * 2654435761u)->second;
+            }
+            return sum;
+        };
+    }
+
+    BENCH_CASE("fst::unordered_map insert", "[core][bench]")
+    {
+        constexpr uint32_t count = 4096;
+
+        CATCH_BENCHMARK("fst::unordered_map")
+        {
+            fst::unordered_map<uint32_t, uint32_t> map;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                map[i * 2654435761u] = i;
+            }
+            return map.size();
+        };
+
+        CATCH_BENCHMARK("std::unordered_map")
+        {
+            std::unordered_map<uint32_t, uint32_t> map;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                map[i * 2654435761u] = i;
+            }
+            return map.size();
+        };
+    }
+} // namespace
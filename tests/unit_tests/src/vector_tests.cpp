@@ -3,6 +3,7 @@
 #include "fst/array.h"
 #include "fst/small_vector.h"
 #include "fst/stack_vector.h"
+#include "fst/string.h"
 
 // clang-format off
 #define FST_VECTOR_TEST_TYPE_LIST(TYPE, SIZE)      \
@@ -32,6 +33,56 @@ namespace
         //}
     }
 
+    // Counts the live objects and the destructor calls on slots that don't hold one.
+    struct tracked
+    {
+        static constexpr uint32_t live_tag = 0x7ACCED00;
+        static inline int alive = 0;
+        static inline int bad_destructions = 0;
+
+        tracked(int v = 0) noexcept
+            : tag(live_tag)
+            , value(v)
+        {
+            alive++;
+        }
+
+        tracked(const tracked& other) noexcept
+            : tracked(other.value)
+        {}
+
+        tracked(tracked&& other) noexcept
+            : tracked(other.value)
+        {}
+
+        tracked& operator=(const tracked& other) noexcept
+        {
+            value = other.value;
+            return *this;
+        }
+
+        tracked& operator=(tracked&& other) noexcept
+        {
+            value = other.value;
+            return *this;
+        }
+
+        ~tracked() noexcept
+        {
+            if (tag != live_tag)
+            {
+                bad_destructions++;
+                return;
+            }
+
+            tag = 0;
+            alive--;
+        }
+
+        uint32_t tag;
+        int value;
+    };
+
     TEST_CASE_T("fst::vector::push_back()", "[vector]", FST_VECTOR_PUSH_BACK_TEST_TYPE_LIST)
     {
         using vector_type = TestType;
@@ -106,4 +157,62 @@ namespace
             // REQUIRE(last == vec.back());
         }
     }
+
+    TEST_CASE("fst::vector::erase()", "[vector]")
+    {
+        tracked::alive = 0;
+        tracked::bad_destructions = 0;
+
+        {
+            fst::vector<tracked> vec;
+            // Spare capacity, destroying past the end would hit a slot that was never constructed.
+            vec.reserve(16);
+
+            for (int i = 0; i < 8; i++)
+            {
+                vec.push_back(tracked(i));
+            }
+
+            REQUIRE_EQ(tracked::alive, 8);
+
+            vec.pop_back();
+            REQUIRE_EQ(tracked::alive, 7);
+            REQUIRE_EQ(vec.back().value, 6);
+
+            // 0 1 2 3 4 5 6 -> 0 2 3 4 5 6
+            vec.erase_at(1);
+            REQUIRE_EQ(tracked::alive, 6);
+            REQUIRE_EQ(vec[1].value, 2);
+            REQUIRE_EQ(vec.back().value, 6);
+
+            // 0 2 3 4 5 6 -> 6 2 3 4 5
+            vec.unordered_erase(0);
+            REQUIRE_EQ(tracked::alive, 5);
+            REQUIRE_EQ(vec[0].value, 6);
+            REQUIRE_EQ(vec.back().value, 5);
+
+            vec.erase_at(vec.size() - 1);
+            vec.unordered_erase(vec.size() - 1);
+            REQUIRE_EQ(tracked::alive, 3);
+            REQUIRE_EQ(vec.size(), 3);
+        }
+
+        REQUIRE_EQ(tracked::alive, 0);
+        REQUIRE_EQ(tracked::bad_destructions, 0);
+
+        {
+            fst::vector<fst::string> strings;
+            for (int i = 0; i < 8; i++)
+            {
+                strings.push_back(fst::string(64, (char) ('a' + i)));
+            }
+
+            strings.pop_back();
+            strings.erase_at(0);
+            strings.unordered_erase(0);
+            REQUIRE_EQ(strings.size(), 5);
+            REQUIRE(strings[0] == fst::string(64, 'g'));
+            REQUIRE(strings.back() == fst::string(64, 'f'));
+        }
+    }
 } // namespace
@@ -187,5 +187,8 @@ macro(fst_link_dependencies TARGET_NAME)
 
     if(WIN32)
         target_link_libraries(${TARGET_NAME} PUBLIC winhttp)
+    else()
+        find_package(Threads REQUIRED)
+        target_link_libraries(${TARGET_NAME} PUBLIC Threads::Threads)
     endif()
 endmacro()
@@ -13,7 +13,35 @@ macro(fst_platform_info)
         check_include_file(sys/types.h FST_PLATFORM_HAS_SYS_TYPES_H)
     endif()
 
-    if(FST_USE_SIMD_128 OR FST_USE_SIMD_256 OR FST_USE_SIMD_512)
+    if(FST_USE_SIMD_128 OR FST_USE_SIMD_256 OR FST_USE_SIMD_512 OR FST_USE_SIMD_DISPATCH)
+        # Instruction set flags for each simd width (the dispatch kernels use target pragmas instead).
+        if(MSVC)
+            set(FST_SIMD_DISPATCH_OPTIONS_128 "")
+            set(FST_SIMD_DISPATCH_OPTIONS_256 /arch:AVX2)
+            set(FST_SIMD_DISPATCH_OPTIONS_512 /arch:AVX512)
+        else()
+            set(FST_SIMD_DISPATCH_OPTIONS_128 -msse4.1)
+            set(FST_SIMD_DISPATCH_OPTIONS_256 -mavx2 -mfma)
+            set(FST_SIMD_DISPATCH_OPTIONS_512 -mavx512f -mavx2 -mfma)
+        endif()
+
+        # Flags of the widest enabled simd width, exposed by the fst target.
+        if(FST_USE_SIMD_512)
+            set(FST_SIMD_COMPILE_OPTIONS ${FST_SIMD_DISPATCH_OPTIONS_512})
+        elseif(FST_USE_SIMD_256)
+            set(FST_SIMD_COMPILE_OPTIONS ${FST_SIMD_DISPATCH_OPTIONS_256})
+        elseif(FST_USE_SIMD_128)
+            set(FST_SIMD_COMPILE_OPTIONS ${FST_SIMD_DISPATCH_OPTIONS_128})
+        endif()
+
+        # The checks below run with the widest instruction set that is going to be compiled,
+        # the runtime dispatch kernels (src/simd/dispatch_*.cpp) go up to AVX-512.
+        if(FST_USE_SIMD_DISPATCH)
+            string(REPLACE ";" " " CMAKE_REQUIRED_FLAGS "${FST_SIMD_DISPATCH_OPTIONS_512}")
+        else()
+            string(REPLACE ";" " " CMAKE_REQUIRED_FLAGS "${FST_SIMD_COMPILE_OPTIONS}")
+        endif()
+
         # SSE
         check_include_file(immintrin.h FST_PLATFORM_HAS_IMMINTRIN_H)
         if(FST_PLATFORM_HAS_IMMINTRIN_H)
@@ -87,8 +115,13 @@ macro(fst_platform_info)
             check_source_compiles(CXX "${__FST_SIMD_MAIN_BLOCK} { __m256 a = _mm256_setzero_ps(); }" FST_PLATFORM_HAS_AVX)
             check_source_compiles(CXX "${__FST_SIMD_MAIN_BLOCK} { __m256i i;  __m256i a = _mm256_abs_epi16(i); }" FST_PLATFORM_HAS_AVX2)
             check_source_compiles(CXX "${__FST_SIMD_MAIN_BLOCK} { __m512 a = _mm512_setzero_ps(); }" FST_PLATFORM_HAS_AVX_512)
+
+            # Short Vector Math Library (msvc and icc), replaces the math fallbacks of avx.h and avx512.h.
+            check_source_compiles(CXX "${__FST_SIMD_MAIN_BLOCK} { __m256 a = _mm256_setzero_ps(); a = _mm256_sin_ps(a); }" FST_PLATFORM_HAS_SVML)
             # cmake-format: on
         endif()
+
+        unset(CMAKE_REQUIRED_FLAGS)
     endif()
 
     # Neon